@@ -97,6 +97,13 @@ float3 UnpackNormal(float3 normal)
 	return normal * 2.0f - 1.0f;
 }
 
+// Normal maps can be stored as X and Y only (BC5), Z is reconstructed
+float3 UnpackNormalMap(float2 normal)
+{
+	float2 xy = normal * 2.0f - 1.0f;
+	return float3(xy, sqrt(saturate(1.0f - dot(xy, xy))));
+}
+
 float3 PackNormal(float3 normal)
 {
 	return normal * 0.5f + 0.5f;
@@ -143,7 +143,7 @@ PixelOutputType mainPS(PixelInputType input)
 	
 	//= NORMAL ==================================================================================
 #if NORMAL_MAP
-		float3 normalSample = normalize(UnpackNormal(texNormal.Sample(samplerAniso, texCoords).rgb));
+		float3 normalSample = normalize(UnpackNormalMap(texNormal.Sample(samplerAniso, texCoords).rg));
 		normal = TangentToWorld(normalSample, input.normal.xyz, input.tangent.xyz, input.bitangent.xyz, materialNormalStrength);
 #endif
 	//============================================================================================
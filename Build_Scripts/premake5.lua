@@ -2,8 +2,10 @@ WIN_SDK_VERSION 	= "10.0.17134.0"
 SOLUTION_NAME 		= "Directus"
 EDITOR_NAME 		= "Editor"
 RUNTIME_NAME 		= "Runtime"
+PACKER_NAME 		= "Packer"
 EDITOR_DIR			= "../" .. EDITOR_NAME
 RUNTIME_DIR			= "../" .. RUNTIME_NAME
+PACKER_DIR			= "../Tools/" .. PACKER_NAME
 TARGET_DIR_RELEASE 	= "../Binaries/Release"
 TARGET_DIR_DEBUG 	= "../Binaries/Debug"
 OBJ_DIR 			= "../Binaries/Obj"
@@ -113,4 +115,41 @@ CPP_VERSION 		= "C++17"
 	configuration "Release"
 		targetdir (TARGET_DIR_RELEASE)
 		objdir (OBJ_DIR)
-		debugdir (TARGET_DIR_RELEASE)
\ No newline at end of file
+		debugdir (TARGET_DIR_RELEASE)
+
+ -- Packer --------------------------------------------------------------------------------------------------
+	project (PACKER_NAME)
+		location (PACKER_DIR)
+		kind "ConsoleApp"	
+		language "C++"
+		files { "../Tools/Packer/**.h", "../Tools/Packer/**.cpp" }
+		links { RUNTIME_NAME }
+		dependson { RUNTIME_NAME }
+		systemversion(WIN_SDK_VERSION)
+		cppdialect (CPP_VERSION)
+
+-- Includes
+	includedirs { "../Runtime" }
+	
+-- Debug configuration
+	filter "configurations:Debug"
+		defines { "DEBUG" }
+		symbols "On"
+		flags { "MultiProcessorCompile" }
+
+-- Release configuration
+	filter "configurations:Release"
+		defines { "NDEBUG" }
+		optimize "Full"
+		flags { "MultiProcessorCompile", "LinkTimeOptimization" }
+		
+-- Output directories	
+	configuration "Debug"
+		targetdir (TARGET_DIR_DEBUG)
+		objdir (OBJ_DIR)
+		debugdir (TARGET_DIR_DEBUG)
+
+	configuration "Release"
+		targetdir (TARGET_DIR_RELEASE)
+		objdir (OBJ_DIR)
+		debugdir (TARGET_DIR_RELEASE)
@@ -24,8 +24,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= RENDERING ======
 #define API_D3D11
 //#define API_VULKAN
+//#define API_NULL // Headless, replaces API_D3D11
 //==================
 
+// The null backend is the only one compiled when it's defined, here or by the build (the headless tests)
+#ifdef API_NULL
+#undef API_D3D11
+#undef API_VULKAN
+#endif
+
 //= INPUT ========
 #define API_DInput
 //================
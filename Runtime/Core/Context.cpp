@@ -33,8 +33,8 @@ namespace Directus
 
 	Context::~Context()
 	{
-		for (auto i = m_subsystems.size() - 1; i > 0; i--)
-			delete m_subsystems[i];
+		for (auto i = m_subsystems.size(); i > 1; i--)
+			delete m_subsystems[i - 1];
 
 		// Index 0 is the actual Engine instance, which is the instance
 		// that called this deconstructor in the first place. A deletion
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==========
 #include <vector>
+#include <typeinfo>
 #include "EngineDefs.h"
 //=====================
 
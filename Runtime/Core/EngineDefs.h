@@ -25,16 +25,20 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define WIN32_LEAN_AND_MEAN
 
 //= DISABLED WARNINGS ===========================================================================
+#ifdef _MSC_VER
 // identifier' : class 'type' needs to have dll-interface to be used by clients of class 'type2'
 #pragma warning(disable: 4251) // https://msdn.microsoft.com/en-us/library/esew7y1w.aspx
 // non  DLL-interface classkey 'identifier' used as base for DLL-interface classkey 'identifier'
 #pragma warning(disable: 4275) // https://msdn.microsoft.com/en-us/library/3tdb471s.aspx
+#endif
 //===============================================================================================
 
-#ifdef COMPILING_LIB
+#if defined(COMPILING_LIB) && defined(_WIN32)
 #define ENGINE_CLASS __declspec(dllexport)
-#else
+#elif defined(_WIN32)
 #define ENGINE_CLASS __declspec(dllimport)
+#else
+#define ENGINE_CLASS
 #endif
 
 namespace Directus
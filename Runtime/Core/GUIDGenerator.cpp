@@ -23,9 +23,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "GUIDGenerator.h"
 #include <iomanip>
 #include <sstream> 
+#ifdef _WIN32
 #include <guiddef.h>
 #include "objbase.h"
 #include <winerror.h>
+#else
+#include <random>
+#include <mutex>
+#endif
 //========================
 
 //= NAMESPACES =====
@@ -43,6 +48,7 @@ namespace Directus
 	string GUIDGenerator::GenerateAsStr()
 	{
 		string guidString = "N/A";
+		#ifdef _WIN32
 		GUID guid;
 		HRESULT hr = CoCreateGuid(&guid);
 		if (SUCCEEDED(hr))
@@ -62,6 +68,26 @@ namespace Directus
 			}
 			guidString = stream.str();
 		}
+		#else
+		// A random (version 4) GUID, in the same format
+		static mt19937_64 generator(random_device{}());
+		static mutex generatorMutex;
+		uint64_t high, low;
+		{
+			lock_guard<mutex> guard(generatorMutex);
+			high	= (generator() & 0xFFFFFFFFFFFF0FFFull) | 0x0000000000004000ull;
+			low		= (generator() & 0x3FFFFFFFFFFFFFFFull) | 0x8000000000000000ull;
+		}
+
+		stringstream stream;
+		stream << hex << uppercase << setfill('0')
+			<< setw(8) << (high >> 32)
+			<< "-" << setw(4) << ((high >> 16) & 0xFFFF)
+			<< "-" << setw(4) << (high & 0xFFFF)
+			<< "-" << setw(4) << (low >> 48)
+			<< "-" << setw(12) << (low & 0xFFFFFFFFFFFFull);
+		guidString = stream.str();
+		#endif
 
 		return guidString;
 	}
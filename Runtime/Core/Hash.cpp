@@ -0,0 +1,159 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======
+#include "Hash.h"
+#include <cstring>
+//=================
+
+namespace Directus
+{
+	namespace _Hash
+	{
+		static const uint64_t prime1 = 11400714785074694791ULL;
+		static const uint64_t prime2 = 14029467366897019727ULL;
+		static const uint64_t prime3 = 1609587929392839161ULL;
+		static const uint64_t prime4 = 9650029242287828579ULL;
+		static const uint64_t prime5 = 2870177450012600261ULL;
+
+		inline uint64_t RotateLeft(uint64_t value, int bits)	{ return (value << bits) | (value >> (64 - bits)); }
+		inline uint64_t Read64(const unsigned char* p)			{ uint64_t value; memcpy(&value, p, 8); return value; }
+		inline uint32_t Read32(const unsigned char* p)			{ uint32_t value; memcpy(&value, p, 4); return value; }
+
+		inline uint64_t Round(uint64_t accumulator, uint64_t input)
+		{
+			accumulator += input * prime2;
+			accumulator = RotateLeft(accumulator, 31);
+			return accumulator * prime1;
+		}
+
+		inline uint64_t Merge(uint64_t hash, uint64_t accumulator)
+		{
+			hash ^= Round(0, accumulator);
+			return hash * prime1 + prime4;
+		}
+	}
+
+	Hash::Hash(uint64_t seed)
+	{
+		m_seed				= seed;
+		m_accumulators[0]	= seed + _Hash::prime1 + _Hash::prime2;
+		m_accumulators[1]	= seed + _Hash::prime2;
+		m_accumulators[2]	= seed;
+		m_accumulators[3]	= seed - _Hash::prime1;
+		m_bufferSize		= 0;
+		m_length			= 0;
+	}
+
+	void Hash::Update(const void* data, size_t size)
+	{
+		auto p		= static_cast<const unsigned char*>(data);
+		auto end	= p + size;
+		m_length	+= size;
+
+		// Complete a pending stripe
+		if (m_bufferSize != 0)
+		{
+			size_t count = 32 - m_bufferSize < size ? 32 - m_bufferSize : size;
+			memcpy(m_buffer + m_bufferSize, p, count);
+			m_bufferSize	+= (unsigned int)count;
+			p				+= count;
+			if (m_bufferSize < 32)
+				return;
+
+			for (int i = 0; i < 4; i++)
+			{
+				m_accumulators[i] = _Hash::Round(m_accumulators[i], _Hash::Read64(m_buffer + i * 8));
+			}
+			m_bufferSize = 0;
+		}
+
+		// Full stripes
+		uint64_t v0 = m_accumulators[0], v1 = m_accumulators[1], v2 = m_accumulators[2], v3 = m_accumulators[3];
+		for (; end - p >= 32; p += 32)
+		{
+			v0 = _Hash::Round(v0, _Hash::Read64(p));
+			v1 = _Hash::Round(v1, _Hash::Read64(p + 8));
+			v2 = _Hash::Round(v2, _Hash::Read64(p + 16));
+			v3 = _Hash::Round(v3, _Hash::Read64(p + 24));
+		}
+		m_accumulators[0] = v0; m_accumulators[1] = v1; m_accumulators[2] = v2; m_accumulators[3] = v3;
+
+		// Keep the remainder for the next update
+		m_bufferSize = (unsigned int)(end - p);
+		memcpy(m_buffer, p, m_bufferSize);
+	}
+
+	uint64_t Hash::Digest() const
+	{
+		uint64_t hash;
+		if (m_length >= 32)
+		{
+			const uint64_t* v = m_accumulators;
+			hash = _Hash::RotateLeft(v[0], 1) + _Hash::RotateLeft(v[1], 7) + _Hash::RotateLeft(v[2], 12) + _Hash::RotateLeft(v[3], 18);
+			for (int i = 0; i < 4; i++)
+			{
+				hash = _Hash::Merge(hash, v[i]);
+			}
+		}
+		else
+		{
+			hash = m_seed + _Hash::prime5;
+		}
+		hash += m_length;
+
+		// Tail
+		const unsigned char* p		= m_buffer;
+		const unsigned char* end	= m_buffer + m_bufferSize;
+		for (; end - p >= 8; p += 8)
+		{
+			hash ^= _Hash::Round(0, _Hash::Read64(p));
+			hash = _Hash::RotateLeft(hash, 27) * _Hash::prime1 + _Hash::prime4;
+		}
+		if (end - p >= 4)
+		{
+			hash ^= (uint64_t)_Hash::Read32(p) * _Hash::prime1;
+			hash = _Hash::RotateLeft(hash, 23) * _Hash::prime2 + _Hash::prime3;
+			p += 4;
+		}
+		for (; p < end; p++)
+		{
+			hash ^= (*p) * _Hash::prime5;
+			hash = _Hash::RotateLeft(hash, 11) * _Hash::prime1;
+		}
+
+		// Avalanche
+		hash ^= hash >> 33;
+		hash *= _Hash::prime2;
+		hash ^= hash >> 29;
+		hash *= _Hash::prime3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+
+	uint64_t Hash::Compute(const void* data, size_t size, uint64_t seed)
+	{
+		Hash hash(seed);
+		hash.Update(data, size);
+		return hash.Digest();
+	}
+}
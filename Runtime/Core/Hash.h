@@ -0,0 +1,51 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ======
+#include <cstdint>
+#include <cstddef>
+#include "EngineDefs.h"
+//=================
+
+namespace Directus
+{
+	// 64-bit xxHash, fast enough to verify or fingerprint large blobs of data.
+	// Can be fed incrementally, the digest is the same as hashing all the data at once.
+	class ENGINE_CLASS Hash
+	{
+	public:
+		Hash(uint64_t seed = 0);
+
+		void Update(const void* data, size_t size);
+		uint64_t Digest() const;
+
+		static uint64_t Compute(const void* data, size_t size, uint64_t seed = 0);
+
+	private:
+		uint64_t m_accumulators[4];
+		unsigned char m_buffer[32];
+		unsigned int m_bufferSize;
+		uint64_t m_length;
+		uint64_t m_seed;
+	};
+}
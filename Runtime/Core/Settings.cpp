@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <string>
 #include <fstream>
 #include <algorithm>
+#include <thread>
 #include "../FileSystem/FileSystem.h"
 #include "../Logging/Log.h"
 //===================================
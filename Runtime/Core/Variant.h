@@ -29,6 +29,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Math/Matrix.h"
 #include "EngineDefs.h"
 #include <variant>
+#include <memory>
 //=============================
 
 //= FORWARD DECLARATIONS =
@@ -19,14 +19,17 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ==============
+//= INCLUDES =================
 #include "FileSystem.h"
 #include <filesystem>
 #include <regex>
+#include "VirtualFileSystem.h"
 #include "../Logging/Log.h"
+#ifdef _WIN32
 #include <Windows.h>
 #include <shellapi.h>
-//=========================
+#endif
+//============================
 
 //= NAMESPACES =================
 using namespace std;
@@ -235,11 +238,18 @@ namespace Directus
 
 	void FileSystem::OpenDirectoryWindow(const std::string& directory)
 	{
+		#ifdef _WIN32
 		ShellExecute(nullptr, nullptr, StringToWString(directory).c_str(), nullptr, nullptr, SW_SHOW);
+		#else
+		LOGF_WARNING("FileSystem::OpenDirectoryWindow: Not supported on this platform, can't open %s", directory.c_str());
+		#endif
 	}
 
 	bool FileSystem::FileExists(const string& filePath)
 	{
+		if (VirtualFileSystem::Exists(filePath))
+			return true;
+
 		bool result;
 		try
 		{
@@ -651,6 +661,22 @@ namespace Directus
 		return result.generic_string();
 	}
 
+	string FileSystem::NormalizePath(const string& path)
+	{
+		string normalized;
+		normalized.reserve(path.size());
+		for (char c : path)
+		{
+			c = (c == '\\') ? '/' : c;
+			if (c == '/' && !normalized.empty() && normalized.back() == '/')
+				continue;
+
+			normalized.push_back(c);
+		}
+
+		return normalized;
+	}
+
 	// Returns a file path which is where the engine's executable is located
 	string FileSystem::GetWorkingDirectory()
 	{
@@ -725,6 +751,7 @@ namespace Directus
 
 	wstring FileSystem::StringToWString(const string& str)
 	{
+		#ifdef _WIN32
 		auto slength	= int(str.length()) + 1;
 		auto len		= MultiByteToWideChar(CP_ACP, 0, str.c_str(), slength, nullptr, 0);
 		auto buf		= new wchar_t[len];
@@ -732,5 +759,8 @@ namespace Directus
 		wstring result(buf);
 		delete[] buf;
 		return result;
+		#else
+		return wstring(str.begin(), str.end());
+		#endif
 	}
 }
\ No newline at end of file
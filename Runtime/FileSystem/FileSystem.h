@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include <vector>
+#include <string>
 #include "../Core/EngineDefs.h"
 //=============================
 
@@ -71,6 +72,8 @@ namespace Directus
 		static std::string GetFilePathWithoutExtension(const std::string& filePath);
 		static std::string GetExtensionFromFilePath(const std::string& filePath);
 		static std::string GetRelativeFilePath(const std::string& absoluteFilePath);
+		// Converts backslashes to slashes and collapses repeated slashes, so equivalent paths compare equal
+		static std::string NormalizePath(const std::string& path);
 		static std::string GetWorkingDirectory();
 		static std::string GetParentDirectory(const std::string& directory);
 		static std::vector<std::string> GetDirectoriesInDirectory(const std::string& directory);
@@ -0,0 +1,307 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================
+#include "PackFile.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include "FileSystem.h"
+#include "../Core/Hash.h"
+#include "../IO/Compression.h"
+#include "../Logging/Log.h"
+//============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _PackFile
+	{
+		static const uint32_t magic		= 0x4B415044; // "DPAK"
+		static const uint32_t version	= 1;
+		static const uint64_t align		= 16;
+		static const double minSaving	= 0.1; // Entries that don't shrink by at least this much are stored as they are
+
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t entryCount;
+			uint32_t padding;
+			uint64_t tocOffset;
+			uint64_t stringsOffset;
+			uint64_t stringsSize;
+			uint64_t tocHash; // Covers the entries and the string table
+		};
+
+		inline uint64_t Align(uint64_t value) { return (value + align - 1) & ~(align - 1); }
+	}
+
+	bool PackFile::Open(const string& filePath)
+	{
+		if (!m_file.Open(filePath))
+		{
+			LOGF_ERROR("PackFile::Open: Failed to open \"%s\"", filePath.c_str());
+			return false;
+		}
+
+		_PackFile::Header header = {};
+		const std::byte* data	= m_file.GetData();
+		size_t size				= m_file.GetSize();
+		if (size >= sizeof(header))
+		{
+			memcpy(&header, data, sizeof(header));
+		}
+
+		if (header.magic != _PackFile::magic || header.version != _PackFile::version)
+		{
+			LOGF_ERROR("PackFile::Open: \"%s\" is not a supported pack file", filePath.c_str());
+			m_file.Close();
+			return false;
+		}
+
+		uint64_t tocSize	= header.entryCount * (uint64_t)sizeof(Entry);
+		bool inBounds		= header.tocOffset <= size && tocSize <= size - header.tocOffset && header.stringsOffset <= size && header.stringsSize <= size - header.stringsOffset;
+		if (!inBounds || header.tocOffset % alignof(Entry) != 0)
+		{
+			LOGF_ERROR("PackFile::Open: \"%s\" is truncated", filePath.c_str());
+			m_file.Close();
+			return false;
+		}
+
+		Hash hash;
+		hash.Update(data + header.tocOffset, (size_t)tocSize);
+		hash.Update(data + header.stringsOffset, (size_t)header.stringsSize);
+		if (hash.Digest() != header.tocHash)
+		{
+			LOGF_ERROR("PackFile::Open: \"%s\" has a corrupted table of contents", filePath.c_str());
+			m_file.Close();
+			return false;
+		}
+
+		m_filePath		= filePath;
+		m_entries		= reinterpret_cast<const Entry*>(data + header.tocOffset);
+		m_entryCount	= header.entryCount;
+		m_strings		= reinterpret_cast<const char*>(data + header.stringsOffset);
+
+		// Everything an entry points to has to be in the file
+		for (unsigned int i = 0; i < m_entryCount; i++)
+		{
+			const Entry& entry = m_entries[i];
+			if (entry.offset > size || entry.size > size - entry.offset || (uint64_t)entry.pathOffset + entry.pathLength > header.stringsSize)
+			{
+				LOGF_ERROR("PackFile::Open: \"%s\" has an entry out of bounds", filePath.c_str());
+				m_file.Close();
+				m_entries		= nullptr;
+				m_entryCount	= 0;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool PackFile::Read(const string& path, const std::byte** data, size_t* size, vector<std::byte>* storage) const
+	{
+		const Entry* entry = Find(path);
+		if (!entry || !data || !size)
+			return false;
+
+		const std::byte* stored = m_file.GetData() + entry->offset;
+		if (entry->compression == PackCompression_LZ4)
+		{
+			if (!storage)
+				return false;
+
+			storage->resize((size_t)entry->sizeUncompressed);
+			if (!Compression::LZ4_Decompress(stored, (size_t)entry->size, storage->data(), storage->size()))
+			{
+				LOGF_ERROR("PackFile::Read: Failed to decompress \"%s\"", path.c_str());
+				return false;
+			}
+			*data = storage->data();
+			*size = storage->size();
+		}
+		else
+		{
+			*data = stored;
+			*size = (size_t)entry->size;
+		}
+
+		if (Hash::Compute(*data, *size) != entry->contentHash)
+		{
+			LOGF_ERROR("PackFile::Read: \"%s\" is corrupted", path.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	const PackFile::Entry* PackFile::Find(const string& path) const
+	{
+		if (!m_entries)
+			return nullptr;
+
+		string key		= GetKey(path);
+		uint64_t hash	= Hash::Compute(key.data(), key.size());
+
+		auto it = lower_bound(m_entries, m_entries + m_entryCount, hash, [](const Entry& entry, uint64_t value) { return entry.pathHash < value; });
+
+		// Hashes can collide, the path decides
+		for (; it != m_entries + m_entryCount && it->pathHash == hash; ++it)
+		{
+			if (GetKey(string(m_strings + it->pathOffset, it->pathLength)) == key)
+				return it;
+		}
+
+		return nullptr;
+	}
+
+	bool PackFile::Create(const string& directory, const string& filePath, bool compress)
+	{
+		vector<string> paths;
+		try
+		{
+			for (const auto& file : filesystem::recursive_directory_iterator(directory))
+			{
+				if (!file.is_regular_file())
+					continue;
+
+				string path = FileSystem::NormalizePath(file.path().generic_string());
+				if (GetKey(path) != GetKey(filePath))
+				{
+					paths.emplace_back(path);
+				}
+			}
+		}
+		catch (filesystem::filesystem_error& e)
+		{
+			LOGF_ERROR("PackFile::Create: %s, %s", e.what(), directory.c_str());
+			return false;
+		}
+
+		ofstream out(filePath, ios::out | ios::binary | ios::trunc);
+		if (out.fail())
+		{
+			LOGF_ERROR("PackFile::Create: Failed to open \"%s\" for writing", filePath.c_str());
+			return false;
+		}
+
+		_PackFile::Header header = {};
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		uint64_t offset = sizeof(header);
+
+		// Data is written in directory order, so files that sit together on disk stay together in the pack
+		vector<Entry> entries;
+		string strings;
+		vector<char> data;
+		vector<char> compressed;
+		const char zeros[_PackFile::align] = {};
+		for (const auto& path : paths)
+		{
+			ifstream in(path, ios::in | ios::binary | ios::ate);
+			if (in.fail())
+			{
+				LOGF_ERROR("PackFile::Create: Failed to read \"%s\"", path.c_str());
+				return false;
+			}
+			data.resize((size_t)in.tellg());
+			in.seekg(0, ios::beg);
+			in.read(data.data(), data.size());
+
+			Entry entry				= {};
+			string key				= GetKey(path);
+			entry.pathHash			= Hash::Compute(key.data(), key.size());
+			entry.sizeUncompressed	= data.size();
+			entry.contentHash		= Hash::Compute(data.data(), data.size());
+			entry.pathOffset		= (uint32_t)strings.size();
+			entry.pathLength		= (uint32_t)path.size();
+			strings					+= path;
+
+			const char* stored	= data.data();
+			entry.size			= data.size();
+			entry.compression	= PackCompression_None;
+			if (compress && !data.empty())
+			{
+				compressed.resize(Compression::LZ4_CompressBound(data.size()));
+				size_t size = Compression::LZ4_Compress(data.data(), data.size(), compressed.data(), compressed.size());
+				if (size != 0 && size < data.size() * (1.0 - _PackFile::minSaving))
+				{
+					stored				= compressed.data();
+					entry.size			= size;
+					entry.compression	= PackCompression_LZ4;
+				}
+			}
+
+			entry.offset = offset;
+			out.write(stored, entry.size);
+			uint64_t aligned = _PackFile::Align(offset + entry.size);
+			out.write(zeros, aligned - (offset + entry.size));
+			offset = aligned;
+
+			entries.emplace_back(entry);
+		}
+
+		sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.pathHash < b.pathHash; });
+
+		header.magic			= _PackFile::magic;
+		header.version			= _PackFile::version;
+		header.entryCount		= (uint32_t)entries.size();
+		header.tocOffset		= offset;
+		header.stringsOffset	= offset + entries.size() * sizeof(Entry);
+		header.stringsSize		= strings.size();
+
+		Hash hash;
+		hash.Update(entries.data(), entries.size() * sizeof(Entry));
+		hash.Update(strings.data(), strings.size());
+		header.tocHash = hash.Digest();
+
+		out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+		out.write(strings.data(), strings.size());
+		out.seekp(0, ios::beg);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.close();
+
+		if (out.fail())
+		{
+			LOGF_ERROR("PackFile::Create: Failed to write \"%s\"", filePath.c_str());
+			return false;
+		}
+
+		LOGF_INFO("PackFile::Create: Packed %d files into \"%s\"", (int)entries.size(), filePath.c_str());
+		return true;
+	}
+
+	string PackFile::GetKey(const string& path)
+	{
+		string key = FileSystem::NormalizePath(path);
+		if (key.compare(0, 2, "./") == 0)
+		{
+			key.erase(0, 2);
+		}
+		transform(key.begin(), key.end(), key.begin(), [](char c) { return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c; });
+		return key;
+	}
+}
@@ -0,0 +1,79 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ================
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../IO/MappedFile.h"
+//===========================
+
+namespace Directus
+{
+	enum PackCompression : uint32_t
+	{
+		PackCompression_None,
+		PackCompression_LZ4
+	};
+
+	// Read-only archive of many files, memory mapped as a whole.
+	// The table of contents is sorted by path hash, so a lookup is a binary search and one string compare.
+	// Entry data is 16 byte aligned and individually (optionally) LZ4 compressed.
+	class ENGINE_CLASS PackFile
+	{
+	public:
+		bool Open(const std::string& filePath);
+		bool Exists(const std::string& path) const { return Find(path) != nullptr; }
+		// Points data at the entry, compressed entries are decompressed into storage first
+		bool Read(const std::string& path, const std::byte** data, size_t* size, std::vector<std::byte>* storage) const;
+		unsigned int GetEntryCount() const				{ return m_entryCount; }
+		const std::string& GetFilePath() const			{ return m_filePath; }
+
+		// Packs every file under a directory, entries are named by their path as seen from the working directory
+		static bool Create(const std::string& directory, const std::string& filePath, bool compress);
+		// Lowercase and normalized, paths are matched the same way Windows matches them
+		static std::string GetKey(const std::string& path);
+
+	private:
+		struct Entry
+		{
+			uint64_t pathHash;
+			uint64_t offset;
+			uint64_t size; // Stored size
+			uint64_t sizeUncompressed;
+			uint64_t contentHash; // Of the uncompressed data
+			uint32_t pathOffset; // Into the string table
+			uint32_t pathLength;
+			uint32_t compression;
+			uint32_t padding;
+		};
+
+		const Entry* Find(const std::string& path) const;
+
+		std::string m_filePath;
+		MappedFile m_file;
+		const Entry* m_entries		= nullptr;
+		unsigned int m_entryCount	= 0;
+		const char* m_strings		= nullptr;
+	};
+}
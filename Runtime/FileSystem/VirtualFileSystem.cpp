@@ -0,0 +1,166 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================
+#include "VirtualFileSystem.h"
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <filesystem>
+#include "PackFile.h"
+#include "FileSystem.h"
+#include "../Logging/Log.h"
+//============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _VirtualFileSystem
+	{
+		static mutex mountMutex;
+		static vector<shared_ptr<PackFile>> packs;
+		static atomic<bool> hasPacks			= false; // Avoids locking when nothing is mounted
+		static atomic<bool> looseFilesOverride	= true;
+		static const char* extension			= ".pak";
+	}
+
+	bool VirtualFileSystem::Mount(const string& packFilePath)
+	{
+		auto pack = make_shared<PackFile>();
+		if (!pack->Open(packFilePath))
+			return false;
+
+		lock_guard<mutex> guard(_VirtualFileSystem::mountMutex);
+		_VirtualFileSystem::packs.emplace_back(pack);
+		_VirtualFileSystem::hasPacks = true;
+
+		LOGF_INFO("VirtualFileSystem::Mount: Mounted \"%s\" (%d files)", packFilePath.c_str(), (int)pack->GetEntryCount());
+		return true;
+	}
+
+	void VirtualFileSystem::MountDirectory(const string& directory)
+	{
+		vector<string> packs;
+		for (const auto& filePath : FileSystem::GetFilesInDirectory(directory))
+		{
+			if (FileSystem::GetExtensionFromFilePath(filePath) == _VirtualFileSystem::extension)
+			{
+				packs.emplace_back(filePath);
+			}
+		}
+
+		sort(packs.begin(), packs.end());
+		for (const auto& pack : packs)
+		{
+			Mount(pack);
+		}
+	}
+
+	void VirtualFileSystem::UnmountAll()
+	{
+		// Open virtual files keep their pack alive
+		lock_guard<mutex> guard(_VirtualFileSystem::mountMutex);
+		_VirtualFileSystem::packs.clear();
+		_VirtualFileSystem::hasPacks = false;
+	}
+
+	void VirtualFileSystem::SetLooseFilesOverride(bool enabled)
+	{
+		_VirtualFileSystem::looseFilesOverride = enabled;
+	}
+
+	bool VirtualFileSystem::GetLooseFilesOverride()
+	{
+		return _VirtualFileSystem::looseFilesOverride;
+	}
+
+	bool VirtualFileSystem::Exists(const string& path)
+	{
+		return Resolve(path) != nullptr;
+	}
+
+	bool VirtualFileSystem::Open(const string& path, VirtualFile* file)
+	{
+		if (!file)
+			return false;
+
+		auto pack = Resolve(path);
+		if (!pack)
+			return false;
+
+		if (!pack->Read(path, &file->data, &file->size, &file->storage))
+			return false;
+
+		file->pack = pack;
+		return true;
+	}
+
+	bool VirtualFileSystem::Read(const string& path, vector<std::byte>* data)
+	{
+		VirtualFile file;
+		if (!data || !Open(path, &file))
+			return false;
+
+		if (file.storage.empty())
+		{
+			data->assign(file.data, file.data + file.size);
+		}
+		else
+		{
+			*data = move(file.storage);
+		}
+
+		return true;
+	}
+
+	shared_ptr<PackFile> VirtualFileSystem::Resolve(const string& path)
+	{
+		if (!_VirtualFileSystem::hasPacks || path.empty())
+			return nullptr;
+
+		shared_ptr<PackFile> pack;
+		{
+			lock_guard<mutex> guard(_VirtualFileSystem::mountMutex);
+			auto& packs = _VirtualFileSystem::packs;
+			for (auto it = packs.rbegin(); it != packs.rend(); ++it)
+			{
+				if ((*it)->Exists(path))
+				{
+					pack = *it;
+					break;
+				}
+			}
+		}
+
+		// A loose file shadows the packed one
+		if (pack && _VirtualFileSystem::looseFilesOverride)
+		{
+			error_code error;
+			if (filesystem::is_regular_file(path, error))
+				return nullptr;
+		}
+
+		return pack;
+	}
+}
@@ -0,0 +1,66 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <string>
+#include <vector>
+#include <memory>
+#include "../Core/EngineDefs.h"
+//=============================
+
+namespace Directus
+{
+	class PackFile;
+
+	// The contents of a file that lives in a pack, valid for as long as this is alive
+	struct VirtualFile
+	{
+		const std::byte* data = nullptr;
+		size_t size = 0;
+		std::vector<std::byte> storage; // Decompressed data
+		std::shared_ptr<PackFile> pack;	// Keeps the mapping alive
+	};
+
+	// Resolves paths to mounted pack files. Packs mounted later take precedence over earlier ones.
+	// With loose file overrides enabled, a file on disk always wins over a packed one (useful during development).
+	class ENGINE_CLASS VirtualFileSystem
+	{
+	public:
+		static bool Mount(const std::string& packFilePath);
+		// Mounts every pack file in a directory, in alphabetical order
+		static void MountDirectory(const std::string& directory);
+		static void UnmountAll();
+		static void SetLooseFilesOverride(bool enabled);
+		static bool GetLooseFilesOverride();
+
+		// True if the path resolves to a packed file (that isn't overridden by a loose one)
+		static bool Exists(const std::string& path);
+		// Fails if the path doesn't resolve to a packed file, the caller should then read it from disk
+		static bool Open(const std::string& path, VirtualFile* file);
+		// Open() and copy, for consumers that need to own the data
+		static bool Read(const std::string& path, std::vector<std::byte>* data);
+
+	private:
+		static std::shared_ptr<PackFile> Resolve(const std::string& path);
+	};
+}
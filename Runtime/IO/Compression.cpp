@@ -0,0 +1,224 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========
+#include "Compression.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+//======================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _Compression
+	{
+		static const size_t minMatch		= 4;
+		static const size_t lastLiterals	= 5;	// The last 5 bytes are always literals
+		static const size_t matchFindLimit	= 12;	// The last match must start at least 12 bytes before the end
+		static const size_t maxOffset		= 65535;
+		static const int hashLog			= 16;
+
+		inline uint32_t Read32(const uint8_t* p)	{ uint32_t value; memcpy(&value, p, 4); return value; }
+		inline uint32_t Hash(uint32_t sequence)		{ return (sequence * 2654435761U) >> (32 - hashLog); }
+
+		inline uint8_t* WriteLength(uint8_t* op, size_t length)
+		{
+			for (; length >= 255; length -= 255)
+			{
+				*op++ = 255;
+			}
+			*op++ = (uint8_t)length;
+			return op;
+		}
+
+		inline bool ReadLength(const uint8_t*& ip, const uint8_t* ipEnd, size_t& length)
+		{
+			uint8_t byte;
+			do
+			{
+				if (ip >= ipEnd)
+					return false;
+
+				byte	= *ip++;
+				length	+= byte;
+			} while (byte == 255);
+
+			return true;
+		}
+
+		inline uint8_t* WriteSequence(uint8_t* op, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength, bool last)
+		{
+			uint8_t* token	= op++;
+			*token			= (uint8_t)((literalLength >= 15 ? 15 : literalLength) << 4);
+			if (literalLength >= 15)
+			{
+				op = WriteLength(op, literalLength - 15);
+			}
+			memcpy(op, literals, literalLength);
+			op += literalLength;
+
+			if (last)
+				return op;
+
+			*op++	= (uint8_t)(offset & 0xFF);
+			*op++	= (uint8_t)(offset >> 8);
+			*token	|= (uint8_t)(matchLength >= 15 ? 15 : matchLength);
+			if (matchLength >= 15)
+			{
+				op = WriteLength(op, matchLength - 15);
+			}
+
+			return op;
+		}
+	}
+
+	size_t Compression::LZ4_CompressBound(size_t size)
+	{
+		return size + size / 255 + 16;
+	}
+
+	size_t Compression::LZ4_Compress(const void* source, size_t sourceSize, void* destination, size_t destinationCapacity)
+	{
+		if (!source || !destination || destinationCapacity < LZ4_CompressBound(sourceSize))
+			return 0;
+
+		const uint8_t* src		= static_cast<const uint8_t*>(source);
+		const uint8_t* end		= src + sourceSize;
+		const uint8_t* ip		= src;
+		const uint8_t* anchor	= src;
+		uint8_t* op				= static_cast<uint8_t*>(destination);
+
+		if (sourceSize > _Compression::matchFindLimit)
+		{
+			// Last position each 4 byte sequence was seen at
+			vector<uint32_t> table((size_t)1 << _Compression::hashLog, 0);
+			const uint8_t* matchLimit	= end - _Compression::lastLiterals;
+			const uint8_t* searchLimit	= end - _Compression::matchFindLimit;
+
+			while (ip <= searchLimit)
+			{
+				uint32_t sequence	= _Compression::Read32(ip);
+				uint32_t& slot		= table[_Compression::Hash(sequence)];
+				const uint8_t* match	= src + slot;
+				slot = (uint32_t)(ip - src);
+
+				if (match >= ip || (size_t)(ip - match) > _Compression::maxOffset || _Compression::Read32(match) != sequence)
+				{
+					// Skip faster through data that doesn't compress
+					ip += 1 + ((ip - anchor) >> 7);
+					continue;
+				}
+
+				// Extend the match backwards into the pending literals, then forwards
+				while (ip > anchor && match > src && ip[-1] == match[-1])
+				{
+					ip--;
+					match--;
+				}
+				const uint8_t* matchEnd = ip + _Compression::minMatch;
+				const uint8_t* matchRef = match + _Compression::minMatch;
+				while (matchEnd < matchLimit && *matchEnd == *matchRef)
+				{
+					matchEnd++;
+					matchRef++;
+				}
+
+				op		= _Compression::WriteSequence(op, anchor, ip - anchor, ip - match, matchEnd - ip - _Compression::minMatch, false);
+				ip		= matchEnd;
+				anchor	= ip;
+			}
+		}
+
+		op = _Compression::WriteSequence(op, anchor, end - anchor, 0, 0, true);
+		return op - static_cast<uint8_t*>(destination);
+	}
+
+	bool Compression::LZ4_Decompress(const void* source, size_t sourceSize, void* destination, size_t destinationSize)
+	{
+		if (!source || (!destination && destinationSize != 0))
+			return false;
+
+		const uint8_t* ip		= static_cast<const uint8_t*>(source);
+		const uint8_t* ipEnd	= ip + sourceSize;
+		uint8_t* dst			= static_cast<uint8_t*>(destination);
+		uint8_t* op				= dst;
+		uint8_t* opEnd			= dst + destinationSize;
+
+		while (ip < ipEnd)
+		{
+			unsigned int token = *ip++;
+
+			// Literals
+			size_t literalLength = token >> 4;
+			if (literalLength == 15 && !_Compression::ReadLength(ip, ipEnd, literalLength))
+				return false;
+
+			if (literalLength > (size_t)(ipEnd - ip) || literalLength > (size_t)(opEnd - op))
+				return false;
+
+			memcpy(op, ip, literalLength);
+			op += literalLength;
+			ip += literalLength;
+
+			// The last sequence has no match
+			if (ip == ipEnd)
+				break;
+
+			// Match
+			if (ipEnd - ip < 2)
+				return false;
+
+			size_t offset = ip[0] | (ip[1] << 8);
+			ip += 2;
+			if (offset == 0 || offset > (size_t)(op - dst))
+				return false;
+
+			size_t matchLength = token & 15;
+			if (matchLength == 15 && !_Compression::ReadLength(ip, ipEnd, matchLength))
+				return false;
+
+			matchLength += _Compression::minMatch;
+			if (matchLength > (size_t)(opEnd - op))
+				return false;
+
+			// Overlapping matches repeat the bytes they just wrote, so those are copied one by one
+			const uint8_t* match = op - offset;
+			if (offset >= matchLength)
+			{
+				memcpy(op, match, matchLength);
+			}
+			else
+			{
+				for (size_t i = 0; i < matchLength; i++)
+				{
+					op[i] = match[i];
+				}
+			}
+			op += matchLength;
+		}
+
+		return op == opEnd;
+	}
+}
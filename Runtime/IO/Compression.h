@@ -0,0 +1,42 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <cstddef>
+#include "../Core/EngineDefs.h"
+//=============================
+
+namespace Directus
+{
+	// LZ4 block format (no frame), fast enough to decompress while loading
+	class ENGINE_CLASS Compression
+	{
+	public:
+		// Worst case compressed size
+		static size_t LZ4_CompressBound(size_t size);
+		// Returns the compressed size, 0 on failure (the destination must hold LZ4_CompressBound() bytes)
+		static size_t LZ4_Compress(const void* source, size_t sourceSize, void* destination, size_t destinationCapacity);
+		// The destination size must be exactly the decompressed size, fails on malformed input
+		static bool LZ4_Decompress(const void* source, size_t sourceSize, void* destination, size_t destinationSize);
+	};
+}
@@ -39,10 +39,31 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace _FileStream
+	{
+		static const uint32_t magic		= 0x54435244; // "DRCT"
+		static const uint32_t version	= 1;
+		static const size_t bufferSize	= 64 * 1024;
+		static const size_t arrayAlign	= 16; // Arrays are aligned in the file, so mapped spans are aligned in memory
+
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t sectionCount;
+			uint32_t padding;
+			uint64_t sectionTableOffset;
+			uint64_t sectionTableHash;
+		};
+
+		inline uint32_t SectionID(const string& name) { return (uint32_t)Hash::Compute(name.data(), name.size()); }
+	}
+
 	FileStream::FileStream(const string& path, FileStreamMode mode)
 	{
-		m_isOpen = false;
-		m_mode = mode;
+		m_isOpen	= false;
+		m_mode		= mode;
+		m_version	= _FileStream::version;
 
 		if (mode == FileStreamMode_Write)
 		{
@@ -52,40 +73,165 @@ namespace Directus
 				LOGF_ERROR("StreamIO: Failed to open \"%s\" for writing", path.c_str());
 				return;
 			}
+
+			// The header is written last, once the section table is known
+			_FileStream::Header header = {};
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			m_flushed = sizeof(header);
+			m_buffer.reserve(_FileStream::bufferSize);
+			m_sections.push_back({ 0, 0, m_flushed, 0, 0 });
+		}
+		else if (mode == FileStreamMode_Append)
+		{
+			// Only the header and the section table are checked, the existing sections are left untouched
+			if (!m_file.Open(path))
+			{
+				LOGF_ERROR("StreamIO: Failed to open \"%s\" for appending", path.c_str());
+				return;
+			}
+			m_data = m_file.GetData();
+			m_size = m_file.GetSize();
+			uint64_t fileSize = m_size;
+			bool valid = Verify(path, false) && m_version != 0;
+			Unmap();
+			if (!valid)
+			{
+				LOGF_ERROR("StreamIO: Can't append to \"%s\", it has no section table", path.c_str());
+				return;
+			}
+
+			// New sections go after the old table, which stays valid until the header is patched
+			out.open(path, ios::in | ios::out | ios::binary);
+			if (out.fail())
+			{
+				LOGF_ERROR("StreamIO: Failed to open \"%s\" for appending", path.c_str());
+				return;
+			}
+			out.seekp(fileSize);
+
+			m_mode		= FileStreamMode_Write;
+			m_version	= _FileStream::version;
+			m_flushed	= fileSize;
+			m_buffer.reserve(_FileStream::bufferSize);
+			m_sections.push_back({ 0, 0, m_flushed, 0, 0 });
 		}
 		else if (mode == FileStreamMode_Read)
 		{
-			in.open(path, ios::in | ios::binary);
-			if(in.fail())
+			if (!Map(path))
 			{
 				LOGF_ERROR("StreamIO: Failed to open \"%s\" for reading", path.c_str());
 				return;
 			}
+
+			if (!Verify(path))
+				return;
 		}
 
 		m_isOpen = true;
 	}
 
+	FileStream::FileStream(vector<std::byte>* memory)
+	{
+		m_mode		= FileStreamMode_Write;
+		m_version	= _FileStream::version;
+		m_memory	= memory;
+		m_flushed	= memory->size(); // No buffer, writes go straight to memory
+		m_isOpen	= true;
+	}
+
+	FileStream::FileStream(const std::byte* data, size_t size)
+	{
+		m_mode		= FileStreamMode_Read;
+		m_version	= _FileStream::version;
+		m_data		= data;
+		m_size		= size;
+		m_isOpen	= true;
+	}
+
 	FileStream::~FileStream()
 	{
-		if (m_mode == FileStreamMode_Write)
+		Close();
+	}
+
+	bool FileStream::Close()
+	{
+		bool wasOpen	= m_isOpen;
+		m_isOpen		= false;
+
+		if (m_mode == FileStreamMode_Read)
+		{
+			Unmap();
+			return wasOpen;
+		}
+
+		if (wasOpen)
 		{
-			out.flush();
-			out.close();
+			Finalize();
 		}
-		else if (m_mode == FileStreamMode_Read)
+
+		if (m_memory || !out.is_open())
+			return wasOpen;
+
+		bool written = wasOpen && !out.fail();
+		out.close();
+		return written && !out.fail();
+	}
+
+	void FileStream::Section_Begin(const string& name)
+	{
+		if (m_mode != FileStreamMode_Write || m_memory)
+			return;
+
+		Flush();
+
+		// Close the current section, an empty unnamed one can just be dropped
+		auto& section	= m_sections.back();
+		section.size	= m_flushed - section.offset;
+		section.hash	= m_sectionHash.Digest();
+		if (section.id == 0 && section.size == 0)
 		{
-			in.clear();
-			in.close();
+			m_sections.pop_back();
 		}
+
+		m_sections.push_back({ _FileStream::SectionID(name), 0, m_flushed, 0, 0 });
+		m_sectionHash = Hash();
+	}
+
+	bool FileStream::Section_Seek(const string& name, unsigned int index)
+	{
+		if (m_mode != FileStreamMode_Read)
+			return false;
+
+		uint32_t id = _FileStream::SectionID(name);
+		for (const auto& section : m_sections)
+		{
+			if (section.id == id && index-- == 0)
+			{
+				m_position = (size_t)section.offset;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	unsigned int FileStream::Section_Count(const string& name)
+	{
+		uint32_t id			= _FileStream::SectionID(name);
+		unsigned int count	= 0;
+		for (const auto& section : m_sections)
+		{
+			count += section.id == id ? 1 : 0;
+		}
+
+		return count;
 	}
 
 	void FileStream::Write(const string& value)
 	{
 		auto length = (unsigned int)value.length();
 		Write(length);
-
-		out.write(const_cast<char*>(value.c_str()), length);
+		WriteBytes(value.data(), length);
 	}
 
 	void FileStream::Write(const vector<string>& value)
@@ -101,89 +247,105 @@ namespace Directus
 
 	void FileStream::Write(const Vector2& value)
 	{
-		out.write(reinterpret_cast<const char*>(&value), sizeof(Vector2));
+		WriteBytes(&value, sizeof(Vector2));
 	}
 
 	void FileStream::Write(const Vector3& value)
 	{
-		out.write(reinterpret_cast<const char*>(&value), sizeof(Vector3));
+		WriteBytes(&value, sizeof(Vector3));
 	}
 
 	void FileStream::Write(const Vector4& value)
 	{
-		out.write(reinterpret_cast<const char*>(&value), sizeof(Vector4));
+		WriteBytes(&value, sizeof(Vector4));
 	}
 
 	void FileStream::Write(const Quaternion& value)
 	{
-		out.write(reinterpret_cast<const char*>(&value), sizeof(Quaternion));
+		WriteBytes(&value, sizeof(Quaternion));
 	}
 
 	void FileStream::Write(const BoundingBox& value)
 	{
-		out.write(reinterpret_cast<const char*>(&value), sizeof(BoundingBox));
+		WriteBytes(&value, sizeof(BoundingBox));
 	}
 
 	void FileStream::Write(const vector<RHI_Vertex_PosUVTBN>& value)
 	{
 		auto length = (unsigned int)value.size();
 		Write(length);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(RHI_Vertex_PosUVTBN) * length);
+		WriteArray(value.data(), sizeof(RHI_Vertex_PosUVTBN) * length);
 	}
 
 	void FileStream::Write(const vector<unsigned int>& value)
 	{
 		auto length = (unsigned int)value.size();
 		Write(length);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(unsigned int) * length);
+		WriteArray(value.data(), sizeof(unsigned int) * length);
 	}
 
 	void FileStream::Write(const vector<unsigned char>& value)
 	{
 		auto size = (unsigned int)value.size();
 		Write(size);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(unsigned char) * size);
+		WriteArray(value.data(), sizeof(unsigned char) * size);
 	}
 
 	void FileStream::Write(const vector<std::byte>& value)
 	{
 		auto size = (unsigned int)value.size();
 		Write(size);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(std::byte) * size);
+		WriteArray(value.data(), sizeof(std::byte) * size);
+	}
+
+	void FileStream::Write(const FileStreamSpan<std::byte>& value)
+	{
+		Write(value.size);
+		WriteArray(value.data, sizeof(std::byte) * value.size);
+	}
+
+	void FileStream::Align()
+	{
+		WriteArray(nullptr, 0);
 	}
 
 	void FileStream::Read(string* value)
 	{
-		unsigned int length = 0;
-		Read(&length);
+		unsigned int length = ReadUInt();
+		if (m_position + length > m_size)
+		{
+			ReadPastEnd(nullptr, 0);
+			value->clear();
+			return;
+		}
 
-		value->resize(length);
-		in.read(const_cast<char*>(value->c_str()), length);
+		value->assign(reinterpret_cast<const char*>(m_data + m_position), length);
+		m_position += length;
 	}
 
 	void FileStream::Read(Vector2* value)
 	{
-		in.read(reinterpret_cast<char*>(value), sizeof(Vector2));
+		ReadBytes(value, sizeof(Vector2));
 	}
 
 	void FileStream::Read(Vector3* value)
 	{
-		in.read(reinterpret_cast<char*>(value), sizeof(Vector3));
+		ReadBytes(value, sizeof(Vector3));
 	}
 
 	void FileStream::Read(Vector4* value)
 	{
-		in.read(reinterpret_cast<char*>(value), sizeof(Vector4));
+		ReadBytes(value, sizeof(Vector4));
 	}
 
 	void FileStream::Read(Quaternion* value)
 	{
-		in.read(reinterpret_cast<char*>(value), sizeof(Quaternion));
+		ReadBytes(value, sizeof(Quaternion));
 	}
 
 	void FileStream::Read(BoundingBox* value)
 	{
-		in.read(reinterpret_cast<char*>(value), sizeof(BoundingBox));
+		ReadBytes(value, sizeof(BoundingBox));
 	}
 
 	void FileStream::Read(vector<string>* vec)
@@ -192,16 +354,12 @@ namespace Directus
 			return;
 
 		vec->clear();
-		vec->shrink_to_fit();
-
-		unsigned int size = 0;
-		Read(&size);
 
-		string str;
-		for (unsigned int i = 0; i < size; i++)
+		unsigned int size = ReadUInt();
+		for (unsigned int i = 0; i < size && !m_readPastEnd; i++)
 		{
-			Read(&str);
-			vec->emplace_back(str);
+			vec->emplace_back();
+			Read(&vec->back());
 		}
 	}
 
@@ -210,62 +368,248 @@ namespace Directus
 		if (!vec)
 			return;
 
-		vec->clear();
-		vec->shrink_to_fit();
+		ReadVector(vec);
+	}
 
-		unsigned int length = ReadUInt();
+	void FileStream::Read(vector<unsigned int>* vec)
+	{
+		if (!vec)
+			return;
 
-		vec->reserve(length);
-		vec->resize(length);
+		ReadVector(vec);
+	}
+
+	void FileStream::Read(vector<unsigned char>* vec)
+	{
+		if (!vec)
+			return;
 
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(RHI_Vertex_PosUVTBN) * length);
+		ReadVector(vec);
 	}
 
-	void FileStream::Read(vector<unsigned int>* vec)
+	void FileStream::Read(vector<std::byte>* vec)
 	{
 		if (!vec)
 			return;
 
+		ReadVector(vec);
+	}
+
+	template <class T>
+	void FileStream::ReadVector(vector<T>* vec)
+	{
+		auto span = ReadSpan<T>();
 		vec->clear();
-		vec->shrink_to_fit();
+		vec->reserve(span.size);
 
-		unsigned int length = ReadUInt();
+		// Copy in chunks, releasing what was copied, so the file and the copy are never both resident
+		const unsigned int chunk = (unsigned int)(1024 * 1024 / sizeof(T)) + 1;
+		for (unsigned int i = 0; i < span.size; i += chunk)
+		{
+			unsigned int count = span.size - i < chunk ? span.size - i : chunk;
+			vec->insert(vec->end(), span.data + i, span.data + i + count);
+			Release(reinterpret_cast<const std::byte*>(span.data + i), sizeof(T) * count);
+		}
+	}
+
+	void FileStream::WriteLarge(const void* data, size_t size)
+	{
+		Flush();
 
-		vec->reserve(length);
-		vec->resize(length);
+		// Small enough to start a new batch
+		if (size < m_buffer.capacity())
+		{
+			m_buffer.insert(m_buffer.end(), static_cast<const std::byte*>(data), static_cast<const std::byte*>(data) + size);
+			return;
+		}
 
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(unsigned int) * length);
+		// Large blocks go straight to the file
+		if (m_memory)
+		{
+			m_memory->insert(m_memory->end(), static_cast<const std::byte*>(data), static_cast<const std::byte*>(data) + size);
+		}
+		else
+		{
+			m_sectionHash.Update(data, size);
+			out.write(static_cast<const char*>(data), size);
+		}
+		m_flushed += size;
 	}
 
-	void FileStream::Read(vector<unsigned char>* vec)
+	void FileStream::WriteArray(const void* data, size_t size)
 	{
-		if (!vec)
+		static const std::byte zeros[_FileStream::arrayAlign] = {};
+		size_t misalignment = (size_t)(GetPosition() % _FileStream::arrayAlign);
+		if (misalignment != 0)
+		{
+			WriteBytes(zeros, _FileStream::arrayAlign - misalignment);
+		}
+
+		WriteBytes(data, size);
+	}
+
+	void FileStream::Flush()
+	{
+		if (m_buffer.empty())
 			return;
 
-		vec->clear();
-		vec->shrink_to_fit();
+		if (m_memory)
+		{
+			m_memory->insert(m_memory->end(), m_buffer.begin(), m_buffer.end());
+		}
+		else
+		{
+			m_sectionHash.Update(m_buffer.data(), m_buffer.size());
+			out.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+		}
+		m_flushed += m_buffer.size();
+		m_buffer.clear();
+	}
 
-		unsigned int length = ReadUInt();
+	void FileStream::Finalize()
+	{
+		Flush();
+		if (m_memory)
+			return;
 
-		vec->reserve(length);
-		vec->resize(length);
+		auto& section	= m_sections.back();
+		section.size	= m_flushed - section.offset;
+		section.hash	= m_sectionHash.Digest();
+
+		// Section table at the end, then patch the header at the beginning
+		_FileStream::Header header		= {};
+		header.magic					= _FileStream::magic;
+		header.version					= _FileStream::version;
+		header.sectionCount				= (uint32_t)m_sections.size();
+		header.sectionTableOffset		= m_flushed;
+		header.sectionTableHash			= Hash::Compute(m_sections.data(), m_sections.size() * sizeof(Section));
+		out.write(reinterpret_cast<const char*>(m_sections.data()), m_sections.size() * sizeof(Section));
+		out.seekp(0);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.flush();
+	}
+
+	const std::byte* FileStream::ReadArray(size_t size)
+	{
+		if (m_version != 0)
+		{
+			m_position = (m_position + _FileStream::arrayAlign - 1) & ~(_FileStream::arrayAlign - 1);
+		}
 
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(unsigned char) * length);
+		if (m_position + size > m_size)
+		{
+			ReadPastEnd(nullptr, 0);
+			return nullptr;
+		}
+
+		const std::byte* data = m_data + m_position;
+		m_position += size;
+		return data;
 	}
 
-	void FileStream::Read(vector<std::byte>* vec)
+	void FileStream::ReadPastEnd(void* data, size_t size)
 	{
-		if (!vec)
-			return;
+		if (!m_readPastEnd)
+		{
+			LOG_ERROR("StreamIO: Attempted to read past the end of the file");
+			m_readPastEnd = true;
+		}
 
-		vec->clear();
-		vec->shrink_to_fit();
+		if (data)
+		{
+			memset(data, 0, size);
+		}
+		m_position = m_size;
+	}
 
-		unsigned int length = ReadUInt();
+	void FileStream::Release(const std::byte* data, size_t size)
+	{
+		// Copied out, so drop the pages from the working set (they are file backed, nothing is lost)
+		m_file.Release(data, size);
+	}
+
+	bool FileStream::Map(const string& path)
+	{
+		// Packed files take precedence, unless there is a loose one
+		if (VirtualFileSystem::Open(path, &m_packedFile))
+		{
+			m_data = m_packedFile.data;
+			m_size = m_packedFile.size;
+			return true;
+		}
+
+		if (!m_file.Open(path))
+			return false;
+
+		m_data = m_file.GetData();
+		m_size = m_file.GetSize();
+		return true;
+	}
 
-		vec->reserve(length);
-		vec->resize(length);
+	void FileStream::Unmap()
+	{
+		m_file.Close();
+		m_packedFile = VirtualFile();
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	bool FileStream::Verify(const string& path, bool verifySections)
+	{
+		// Files that predate the header are read as they are
+		_FileStream::Header header = {};
+		if (m_size >= sizeof(header))
+		{
+			memcpy(&header, m_data, sizeof(header));
+		}
+
+		if (header.magic != _FileStream::magic)
+		{
+			m_version	= 0;
+			m_position	= 0;
+			return true;
+		}
+
+		if (header.version > _FileStream::version)
+		{
+			LOGF_ERROR("StreamIO: \"%s\" has version %d, only up to %d is supported", path.c_str(), header.version, _FileStream::version);
+			return false;
+		}
+		m_version = header.version;
+
+		uint64_t tableSize = (uint64_t)header.sectionCount * sizeof(Section);
+		if (header.sectionTableOffset > m_size || tableSize > m_size - header.sectionTableOffset)
+		{
+			LOGF_ERROR("StreamIO: \"%s\" is corrupted, the section table is out of bounds", path.c_str());
+			return false;
+		}
+
+		const std::byte* table = m_data + header.sectionTableOffset;
+		if (Hash::Compute(table, (size_t)tableSize) != header.sectionTableHash)
+		{
+			LOGF_ERROR("StreamIO: \"%s\" is corrupted, the section table failed its integrity check", path.c_str());
+			return false;
+		}
+
+		m_sections.resize(header.sectionCount);
+		memcpy(m_sections.data(), table, (size_t)tableSize);
+		for (const auto& section : m_sections)
+		{
+			bool inBounds = section.offset <= header.sectionTableOffset && section.size <= header.sectionTableOffset - section.offset;
+			if (!inBounds || (verifySections && Hash::Compute(m_data + section.offset, (size_t)section.size) != section.hash))
+			{
+				LOGF_ERROR("StreamIO: \"%s\" is corrupted, a section failed its integrity check", path.c_str());
+				return false;
+			}
+
+			if (verifySections)
+			{
+				Release(m_data + section.offset, (size_t)section.size);
+			}
+		}
 
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(std::byte) * length);
+		m_position	= sizeof(header);
+		m_size		= (size_t)header.sectionTableOffset; // Reads can't run into the section table
+		return true;
 	}
 }
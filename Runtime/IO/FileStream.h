@@ -21,10 +21,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES =====
+//= INCLUDES ===============================
 #include <vector>
+#include <string>
 #include <fstream>
-//================
+#include <cstring>
+#include "MappedFile.h"
+#include "../Core/Hash.h"
+#include "../FileSystem/VirtualFileSystem.h"
+//==========================================
 
 namespace Directus
 {
@@ -42,16 +47,51 @@ namespace Directus
 	enum FileStreamMode
 	{
 		FileStreamMode_Read,
-		FileStreamMode_Write
+		FileStreamMode_Write,
+		FileStreamMode_Append // Keeps the sections of an existing file and adds new ones after them
 	};
 
+	// A view into the memory of a stream that is being read, valid for as long as the stream is
+	template <class T>
+	struct FileStreamSpan
+	{
+		const T* begin() const	{ return data; }
+		const T* end() const	{ return data + size; }
+
+		const T* data		= nullptr;
+		unsigned int size	= 0;
+	};
+
+	// Binary file with a header (magic, version and section table), every section carries a hash of its data.
+	// Reading maps the file (or its entry in a pack) into memory and verifies it up front, writing coalesces small writes into a buffer.
+	// Files written before the header existed are still readable (as a single, unverified, section).
 	class FileStream
 	{
 	public:
 		FileStream(const std::string& path, FileStreamMode mode);
+		// Writes into memory, without a header or sections (e.g. a snapshot that ends up in a file later)
+		FileStream(std::vector<std::byte>* memory);
+		// Reads memory written by the above, which has to outlive the stream
+		FileStream(const std::byte* data, size_t size);
 		~FileStream();
 
 		bool IsOpen() { return m_isOpen; }
+		// Finishes the file (writing its section table and header) and closes it, false if any of it failed to be written.
+		// The destructor closes the stream as well, but can't report a failure.
+		bool Close();
+		// 0 for files that predate the header
+		unsigned int GetVersion() { return m_version; }
+		// Offset into the file (or memory) that is read or written next
+		uint64_t GetPosition() { return m_mode == FileStreamMode_Write ? m_flushed + m_buffer.size() : m_position; }
+
+		//= SECTIONS ==============================================================================
+		// Everything written until the next section belongs to this one, data written before any
+		// section goes into an unnamed one. Reading can jump to a section by name.
+		void Section_Begin(const std::string& name);
+		// Sections can share a name, index picks one of them (in the order they were written)
+		bool Section_Seek(const std::string& name, unsigned int index = 0);
+		unsigned int Section_Count(const std::string& name);
+		//=========================================================================================
 
 		//= WRITING ==================================================
 		template <class T, class = typename std::enable_if<
@@ -66,7 +106,7 @@ namespace Directus
 		>::type>
 		void Write(T value)
 		{
-			out.write(reinterpret_cast<char*>(&value), sizeof(value));
+			WriteBytes(&value, sizeof(value));
 		}
 
 		void Write(const std::string& value);
@@ -80,6 +120,9 @@ namespace Directus
 		void Write(const std::vector<unsigned int>& value);
 		void Write(const std::vector<unsigned char>& value);
 		void Write(const std::vector<std::byte>& value);
+		void Write(const FileStreamSpan<std::byte>& value);
+		// Pads up to the alignment of arrays, whatever is written next can be read back on its own (as if it started the stream)
+		void Align();
 		//===========================================================
 		
 		//= READING ================================================
@@ -95,7 +138,7 @@ namespace Directus
 		>::type>
 			void Read(T* value)
 		{
-			in.read(reinterpret_cast<char*>(value), sizeof(T));
+			ReadBytes(value, sizeof(T));
 		}
 
 		void Read(std::string* value);	
@@ -110,6 +153,18 @@ namespace Directus
 		void Read(std::vector<unsigned char>* vec);
 		void Read(std::vector<std::byte>* vec);
 
+		// Reads an array written by one of the vector writes without copying it.
+		// The span points into the mapped file, so it can only be used while the stream is alive.
+		template <class T>
+		FileStreamSpan<T> ReadSpan()
+		{
+			FileStreamSpan<T> span;
+			unsigned int size	= ReadUInt();
+			span.data			= reinterpret_cast<const T*>(ReadArray(sizeof(T) * (size_t)size));
+			span.size			= span.data ? size : 0;
+			return span;
+		}
+
 		// Helps when reading enums
 		int ReadInt()
 		{
@@ -127,9 +182,68 @@ namespace Directus
 		//==========================================================
 
 	private:
-		std::ofstream out;
-		std::ifstream in;
+		struct Section
+		{
+			uint32_t id;
+			uint32_t padding;
+			uint64_t offset;
+			uint64_t size;
+			uint64_t hash;
+		};
+
+		void WriteBytes(const void* data, size_t size)
+		{
+			if (m_buffer.size() + size > m_buffer.capacity())
+			{
+				WriteLarge(data, size);
+				return;
+			}
+
+			m_buffer.insert(m_buffer.end(), static_cast<const std::byte*>(data), static_cast<const std::byte*>(data) + size);
+		}
+
+		void ReadBytes(void* data, size_t size)
+		{
+			if (m_position + size > m_size)
+			{
+				ReadPastEnd(data, size);
+				return;
+			}
+
+			memcpy(data, m_data + m_position, size);
+			m_position += size;
+		}
+
+		void WriteLarge(const void* data, size_t size);
+		void WriteArray(const void* data, size_t size);
+		void Flush();
+		void Finalize();
+		const std::byte* ReadArray(size_t size);
+		void ReadPastEnd(void* data, size_t size);
+		void Release(const std::byte* data, size_t size);
+		template <class T> void ReadVector(std::vector<T>* vec);
+		bool Map(const std::string& path);
+		void Unmap();
+		bool Verify(const std::string& path, bool verifySections = true);
+
 		FileStreamMode m_mode;
 		bool m_isOpen;
+		unsigned int m_version;
+		std::vector<Section> m_sections;
+
+		// Writing
+		std::ofstream out;
+		std::vector<std::byte>* m_memory = nullptr;
+		std::vector<std::byte> m_buffer;
+		uint64_t m_flushed	= 0; // Bytes already written to the file
+		Hash m_sectionHash;
+
+		// Reading
+		const std::byte* m_data	= nullptr;
+		size_t m_size			= 0; // Readable bytes
+		size_t m_position		= 0;
+		bool m_readPastEnd		= false;
+		MappedFile m_file;
+		VirtualFile m_packedFile;
 	};
 }
@@ -0,0 +1,148 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========
+#include "MappedFile.h"
+#include <fstream>
+#include <cstdint>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+//=====================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	bool MappedFile::Open(const string& path)
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		m_fileHandle = file;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			Close();
+			return false;
+		}
+
+		m_size = (size_t)size.QuadPart;
+		if (m_size == 0)
+			return true;
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			m_mappingHandle = mapping;
+			m_data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+#else
+		int file = open(path.c_str(), O_RDONLY);
+		if (file == -1)
+			return false;
+		m_fileHandle = reinterpret_cast<void*>((intptr_t)file + 1); // Offset by one so descriptor 0 isn't null
+
+		struct stat info;
+		if (fstat(file, &info) != 0)
+		{
+			Close();
+			return false;
+		}
+
+		m_size = (size_t)info.st_size;
+		if (m_size == 0)
+			return true;
+
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data != MAP_FAILED)
+		{
+			madvise(data, m_size, MADV_SEQUENTIAL);
+			m_data = static_cast<const std::byte*>(data);
+		}
+#endif
+
+		// Mapping can fail (e.g. out of address space), fall back to reading the whole file
+		if (!m_data)
+		{
+			ifstream in(path, ios::in | ios::binary);
+			if (in.fail())
+			{
+				Close();
+				return false;
+			}
+
+			m_fileData.resize(m_size);
+			in.read(reinterpret_cast<char*>(m_fileData.data()), m_size);
+			m_data = m_fileData.data();
+		}
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+#ifdef _WIN32
+		if (IsMapped())			UnmapViewOfFile(m_data);
+		if (m_mappingHandle)	CloseHandle(m_mappingHandle);
+		if (m_fileHandle)		CloseHandle(m_fileHandle);
+#else
+		if (IsMapped())			munmap(const_cast<std::byte*>(m_data), m_size);
+		if (m_fileHandle)		close((int)(reinterpret_cast<intptr_t>(m_fileHandle) - 1));
+#endif
+		m_data			= nullptr;
+		m_size			= 0;
+		m_mappingHandle	= nullptr;
+		m_fileHandle	= nullptr;
+		m_fileData.clear();
+		m_fileData.shrink_to_fit();
+	}
+
+	void MappedFile::Release(const std::byte* data, size_t size)
+	{
+		// Only mapped pages can be dropped, and only whole pages inside the mapping
+		if (!IsMapped() || !data || data < m_data || data + size > m_data + m_size)
+			return;
+
+		const uintptr_t page	= 4096;
+		uintptr_t begin			= ((uintptr_t)data + page - 1) & ~(page - 1);
+		uintptr_t end			= ((uintptr_t)data + size) & ~(page - 1);
+		if (end <= begin)
+			return;
+
+#ifdef _WIN32
+		VirtualUnlock(reinterpret_cast<void*>(begin), end - begin); // Unlocked pages are removed from the working set
+#else
+		madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+#endif
+	}
+}
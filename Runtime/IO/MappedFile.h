@@ -0,0 +1,60 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "../Core/EngineDefs.h"
+//=============================
+
+namespace Directus
+{
+	// A read-only view of a whole file, memory mapped when possible and read into memory otherwise
+	class ENGINE_CLASS MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile() { Close(); }
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const std::string& path);
+		void Close();
+
+		const std::byte* GetData() const	{ return m_data; }
+		size_t GetSize() const				{ return m_size; }
+
+		// Drops mapped pages from the working set, they are read back from the file if touched again
+		void Release(const std::byte* data, size_t size);
+
+	private:
+		bool IsMapped() const { return m_data && m_data != m_fileData.data(); }
+
+		const std::byte* m_data	= nullptr;
+		size_t m_size			= 0;
+		void* m_fileHandle		= nullptr;
+		void* m_mappingHandle	= nullptr;
+		std::vector<std::byte> m_fileData; // When the file can't be mapped
+	};
+}
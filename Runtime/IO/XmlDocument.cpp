@@ -19,7 +19,7 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ========================
+//= INCLUDES ===============================
 #include "XmlDocument.h"
 #include "pugixml.hpp"
 #include "../Logging/Log.h"
@@ -27,7 +27,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Math/Vector3.h"
 #include "../Math/Vector4.h"
 #include "../FileSystem/FileSystem.h"
-//===================================
+#include "../FileSystem/VirtualFileSystem.h"
+//==========================================
 
 //= NAMESPACES ================
 using namespace std;
@@ -257,7 +258,8 @@ namespace Directus
 	bool XmlDocument::Load(const string& filePath)
 	{
 		m_document = make_unique<xml_document>();
-		xml_parse_result result = m_document->load_file(filePath.c_str());
+		VirtualFile packedFile;
+		xml_parse_result result = VirtualFileSystem::Open(filePath, &packedFile) ? m_document->load_buffer(packedFile.data, packedFile.size) : m_document->load_file(filePath.c_str());
 
 		if (result.status != status_ok)
 		{
@@ -39,6 +39,7 @@ namespace Directus
 	#define LOGF_ERROR(text, ...)		Directus::Log::WriteFError(text,	__VA_ARGS__)
 
 	class Actor;
+	class ILogger;
 
 	namespace Math
 	{
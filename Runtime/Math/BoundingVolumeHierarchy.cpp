@@ -0,0 +1,606 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =======================
+#include "BoundingVolumeHierarchy.h"
+#include <algorithm>
+#include "Frustum.h"
+#include "Ray.h"
+//==================================
+
+//= NAMESPACES ========================
+using namespace std;
+using namespace Directus::Math::Helper;
+//=====================================
+
+namespace Directus::Math
+{
+	static const unsigned int g_sahBinCount = 12;
+
+	static BoundingBox Merged(const BoundingBox& a, const BoundingBox& b)
+	{
+		return BoundingBox(
+			Vector3(Min(a.GetMin().x, b.GetMin().x), Min(a.GetMin().y, b.GetMin().y), Min(a.GetMin().z, b.GetMin().z)),
+			Vector3(Max(a.GetMax().x, b.GetMax().x), Max(a.GetMax().y, b.GetMax().y), Max(a.GetMax().z, b.GetMax().z))
+		);
+	}
+
+	static float SurfaceArea(const BoundingBox& box)
+	{
+		Vector3 size = box.GetSize();
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	static float Component(const Vector3& vector, unsigned int axis)
+	{
+		return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+	}
+
+	// Slab test, returns the distance at which the ray enters the box (0 if the origin is inside)
+	static bool RayIntersectsBox(const Vector3& origin, const Vector3& direction, const BoundingBox& box, float maxDistance, float* enter)
+	{
+		float tMin = 0.0f;
+		float tMax = maxDistance;
+		for (unsigned int axis = 0; axis < 3; axis++)
+		{
+			float o		= Component(origin, axis);
+			float d		= Component(direction, axis);
+			float min	= Component(box.GetMin(), axis);
+			float max	= Component(box.GetMax(), axis);
+
+			if (Abs(d) < M_EPSILON)
+			{
+				if (o < min || o > max)
+					return false;
+				continue;
+			}
+
+			float inv	= 1.0f / d;
+			float t0	= (min - o) * inv;
+			float t1	= (max - o) * inv;
+			if (t0 > t1) swap(t0, t1);
+
+			tMin = Max(tMin, t0);
+			tMax = Min(tMax, t1);
+			if (tMin > tMax)
+				return false;
+		}
+
+		*enter = tMin;
+		return true;
+	}
+
+	BoundingVolumeHierarchy::BoundingVolumeHierarchy(float margin /*= 0.1f*/)
+	{
+		m_root			= Null;
+		m_freeList		= Null;
+		m_objectCount	= 0;
+		m_margin		= margin;
+	}
+
+	//= OBJECTS ====================================================================================
+	unsigned int BoundingVolumeHierarchy::Insert(const BoundingBox& box, void* userData)
+	{
+		int leaf = AllocateNode();
+		m_nodes[leaf].box		= Fatten(box);
+		m_nodes[leaf].tightBox	= box;
+		m_nodes[leaf].userData	= userData;
+		InsertLeaf(leaf);
+		m_objectCount++;
+
+		return (unsigned int)leaf;
+	}
+
+	void BoundingVolumeHierarchy::Remove(unsigned int id)
+	{
+		if (id >= m_nodes.size() || !m_nodes[id].IsObject())
+			return;
+
+		RemoveLeaf((int)id);
+		FreeNode((int)id);
+		m_objectCount--;
+	}
+
+	bool BoundingVolumeHierarchy::Update(unsigned int id, const BoundingBox& box)
+	{
+		if (id >= m_nodes.size() || !m_nodes[id].IsObject())
+			return false;
+
+		Node& node		= m_nodes[id];
+		node.tightBox	= box;
+
+		// Still within the fattened box, the tree doesn't have to change
+		if (node.box.IsInside(box) == Inside)
+			return false;
+
+		RemoveLeaf((int)id);
+		m_nodes[id].box = Fatten(box);
+		InsertLeaf((int)id);
+
+		return true;
+	}
+
+	void BoundingVolumeHierarchy::Rebuild()
+	{
+		if (m_root == Null)
+			return;
+
+		// Collect the leaves and release every internal node
+		vector<int> leaves;
+		leaves.reserve(m_objectCount);
+		vector<int> stack = { m_root };
+		while (!stack.empty())
+		{
+			int index = stack.back();
+			stack.pop_back();
+
+			if (m_nodes[index].IsLeaf())
+			{
+				leaves.emplace_back(index);
+				continue;
+			}
+
+			stack.emplace_back(m_nodes[index].left);
+			stack.emplace_back(m_nodes[index].right);
+			FreeNode(index);
+		}
+
+		m_root					= BuildRecursive(leaves, 0, (unsigned int)leaves.size());
+		m_nodes[m_root].parent	= Null;
+	}
+
+	void BoundingVolumeHierarchy::Clear()
+	{
+		m_nodes.clear();
+		m_root			= Null;
+		m_freeList		= Null;
+		m_objectCount	= 0;
+	}
+	//==============================================================================================
+
+	//= QUERIES ====================================================================================
+	void BoundingVolumeHierarchy::Query(const Frustum& frustum, vector<void*>& results) const
+	{
+		if (m_root == Null)
+			return;
+
+		// Leaves that need an exact test are gathered as a structure of arrays and culled in batches
+		vector<float> soa[6];
+		vector<void*> candidates;
+		auto addCandidate = [&soa, &candidates](const Node& leaf)
+		{
+			Vector3 center	= leaf.tightBox.GetCenter();
+			Vector3 extents	= leaf.tightBox.GetExtents();
+			soa[0].emplace_back(center.x);
+			soa[1].emplace_back(center.y);
+			soa[2].emplace_back(center.z);
+			soa[3].emplace_back(extents.x);
+			soa[4].emplace_back(extents.y);
+			soa[5].emplace_back(extents.z);
+			candidates.emplace_back(leaf.userData);
+		};
+
+		vector<int> stack = { m_root };
+		vector<int> subtree;
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			if (node.IsLeaf())
+			{
+				addCandidate(node);
+				continue;
+			}
+
+			Intersection intersection = frustum.CheckCube(node.box.GetCenter(), node.box.GetExtents());
+			if (intersection == Outside)
+				continue;
+
+			if (intersection == Inside)
+			{
+				// Everything below is visible, no need for any further tests
+				subtree.emplace_back(node.left);
+				subtree.emplace_back(node.right);
+				while (!subtree.empty())
+				{
+					const Node& child = m_nodes[subtree.back()];
+					subtree.pop_back();
+
+					if (child.IsLeaf())
+					{
+						results.emplace_back(child.userData);
+						continue;
+					}
+					subtree.emplace_back(child.left);
+					subtree.emplace_back(child.right);
+				}
+				continue;
+			}
+
+			stack.emplace_back(node.left);
+			stack.emplace_back(node.right);
+		}
+
+		if (candidates.empty())
+			return;
+
+		unsigned int count = (unsigned int)candidates.size();
+		vector<uint32_t> visibility((count + 31) / 32);
+		frustum.CheckCubes(soa[0].data(), soa[1].data(), soa[2].data(), soa[3].data(), soa[4].data(), soa[5].data(), count, visibility.data());
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (visibility[i / 32] & (1u << (i % 32)))
+			{
+				results.emplace_back(candidates[i]);
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::Query(const Vector3& center, float radius, vector<void*>& results) const
+	{
+		if (m_root == Null)
+			return;
+
+		float radiusSquared = radius * radius;
+		auto overlaps = [&center, radiusSquared](const BoundingBox& box)
+		{
+			float distanceSquared = 0.0f;
+			for (unsigned int axis = 0; axis < 3; axis++)
+			{
+				float c		= Component(center, axis);
+				float min	= Component(box.GetMin(), axis);
+				float max	= Component(box.GetMax(), axis);
+				if (c < min) distanceSquared += (min - c) * (min - c);
+				if (c > max) distanceSquared += (c - max) * (c - max);
+			}
+			return distanceSquared <= radiusSquared;
+		};
+
+		vector<int> stack = { m_root };
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			if (node.IsLeaf())
+			{
+				if (overlaps(node.tightBox))
+				{
+					results.emplace_back(node.userData);
+				}
+				continue;
+			}
+
+			if (!overlaps(node.box))
+				continue;
+
+			stack.emplace_back(node.left);
+			stack.emplace_back(node.right);
+		}
+	}
+
+	void* BoundingVolumeHierarchy::RayCast(const Ray& ray, float* distance, const function<bool(void*)>& filter) const
+	{
+		if (m_root == Null)
+			return nullptr;
+
+		const Vector3& origin		= ray.GetOrigin();
+		const Vector3& direction	= ray.GetDirection();
+		float closestDistance		= INFINITY;
+		void* closest				= nullptr;
+
+		vector<int> stack = { m_root };
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			float enter = 0.0f;
+			if (!RayIntersectsBox(origin, direction, node.box, closestDistance, &enter))
+				continue;
+
+			if (node.IsLeaf())
+			{
+				// Same rules as a linear test, hits from within a box (0) don't count
+				float hitDistance = ray.HitDistance(node.tightBox);
+				if (hitDistance == 0.0f || hitDistance == INFINITY || hitDistance >= closestDistance)
+					continue;
+
+				if (filter && !filter(node.userData))
+					continue;
+
+				closestDistance	= hitDistance;
+				closest			= node.userData;
+				continue;
+			}
+
+			// Visit the nearest child first so that the closest distance shrinks early
+			float enterLeft		= INFINITY;
+			float enterRight	= INFINITY;
+			bool hitLeft		= RayIntersectsBox(origin, direction, m_nodes[node.left].box, closestDistance, &enterLeft);
+			bool hitRight		= RayIntersectsBox(origin, direction, m_nodes[node.right].box, closestDistance, &enterRight);
+			int left			= node.left;
+			int right			= node.right;
+			if (hitLeft && hitRight)
+			{
+				if (enterLeft < enterRight) swap(left, right);
+				stack.emplace_back(left);
+				stack.emplace_back(right);
+			}
+			else if (hitLeft)
+			{
+				stack.emplace_back(left);
+			}
+			else if (hitRight)
+			{
+				stack.emplace_back(right);
+			}
+		}
+
+		if (distance)
+		{
+			*distance = closestDistance;
+		}
+
+		return closest;
+	}
+	//==============================================================================================
+
+	//= TREE =======================================================================================
+	int BoundingVolumeHierarchy::AllocateNode()
+	{
+		if (m_freeList == Null)
+		{
+			m_nodes.emplace_back();
+			return (int)m_nodes.size() - 1;
+		}
+
+		// The free list is threaded through the parent indices
+		int index		= m_freeList;
+		m_freeList		= m_nodes[index].parent;
+		m_nodes[index]	= Node();
+		return index;
+	}
+
+	void BoundingVolumeHierarchy::FreeNode(int index)
+	{
+		m_nodes[index]			= Node();
+		m_nodes[index].parent	= m_freeList;
+		m_nodes[index].isFree	= true;
+		m_freeList				= index;
+	}
+
+	void BoundingVolumeHierarchy::InsertLeaf(int leaf)
+	{
+		if (m_root == Null)
+		{
+			m_root					= leaf;
+			m_nodes[leaf].parent	= Null;
+			return;
+		}
+
+		// Descend towards the sibling that results in the smallest surface area increase
+		BoundingBox leafBox	= m_nodes[leaf].box;
+		int index			= m_root;
+		while (!m_nodes[index].IsLeaf())
+		{
+			const Node& node	= m_nodes[index];
+			float area			= SurfaceArea(node.box);
+			float combinedArea	= SurfaceArea(Merged(node.box, leafBox));
+
+			// Cost of creating a new parent for this node and the leaf
+			float cost = 2.0f * combinedArea;
+			// Minimum cost of pushing the leaf further down the tree
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto descendCost = [this, &leafBox, inheritanceCost](int child)
+			{
+				const Node& childNode	= m_nodes[child];
+				float mergedArea		= SurfaceArea(Merged(childNode.box, leafBox));
+				return childNode.IsLeaf() ? mergedArea + inheritanceCost : mergedArea - SurfaceArea(childNode.box) + inheritanceCost;
+			};
+			float costLeft	= descendCost(node.left);
+			float costRight	= descendCost(node.right);
+
+			if (cost < costLeft && cost < costRight)
+				break;
+
+			index = costLeft < costRight ? node.left : node.right;
+		}
+
+		// Create a new parent for the sibling and the leaf
+		int sibling		= index;
+		int oldParent	= m_nodes[sibling].parent;
+		int newParent	= AllocateNode();
+		m_nodes[newParent].parent	= oldParent;
+		m_nodes[newParent].box		= Merged(leafBox, m_nodes[sibling].box);
+		m_nodes[newParent].left		= sibling;
+		m_nodes[newParent].right	= leaf;
+		m_nodes[sibling].parent		= newParent;
+		m_nodes[leaf].parent		= newParent;
+
+		if (oldParent == Null)
+		{
+			m_root = newParent;
+		}
+		else
+		{
+			if (m_nodes[oldParent].left == sibling)
+			{
+				m_nodes[oldParent].left = newParent;
+			}
+			else
+			{
+				m_nodes[oldParent].right = newParent;
+			}
+			RefitAncestors(oldParent);
+		}
+	}
+
+	void BoundingVolumeHierarchy::RemoveLeaf(int leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = Null;
+			return;
+		}
+
+		// The sibling takes the place of the parent
+		int parent		= m_nodes[leaf].parent;
+		int grandParent	= m_nodes[parent].parent;
+		int sibling		= m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+		if (grandParent == Null)
+		{
+			m_root					= sibling;
+			m_nodes[sibling].parent	= Null;
+			FreeNode(parent);
+		}
+		else
+		{
+			if (m_nodes[grandParent].left == parent)
+			{
+				m_nodes[grandParent].left = sibling;
+			}
+			else
+			{
+				m_nodes[grandParent].right = sibling;
+			}
+			m_nodes[sibling].parent = grandParent;
+			FreeNode(parent);
+			RefitAncestors(grandParent);
+		}
+
+		m_nodes[leaf].parent = Null;
+	}
+
+	void BoundingVolumeHierarchy::RefitAncestors(int index)
+	{
+		while (index != Null)
+		{
+			Node& node	= m_nodes[index];
+			node.box	= Merged(m_nodes[node.left].box, m_nodes[node.right].box);
+			index		= node.parent;
+		}
+	}
+
+	int BoundingVolumeHierarchy::BuildRecursive(vector<int>& leaves, unsigned int begin, unsigned int end)
+	{
+		if (end - begin == 1)
+			return leaves[begin];
+
+		// Split along the axis where the centroids are spread the most
+		BoundingBox centroidBounds;
+		for (unsigned int i = begin; i < end; i++)
+		{
+			Vector3 centroid = m_nodes[leaves[i]].box.GetCenter();
+			centroidBounds = Merged(centroidBounds, BoundingBox(centroid, centroid));
+		}
+		Vector3 spread		= centroidBounds.GetSize();
+		unsigned int axis	= (spread.x > spread.y && spread.x > spread.z) ? 0 : (spread.y > spread.z ? 1 : 2);
+		float axisMin		= Component(centroidBounds.GetMin(), axis);
+		float axisExtent	= Component(spread, axis);
+
+		unsigned int mid = begin + (end - begin) / 2;
+		if (axisExtent > M_EPSILON)
+		{
+			// Bin the centroids and evaluate the surface area heuristic at every bin boundary
+			struct Bin
+			{
+				BoundingBox box;
+				unsigned int count = 0;
+			};
+			Bin bins[g_sahBinCount];
+			auto binIndex = [&](int leaf)
+			{
+				float offset = (Component(m_nodes[leaf].box.GetCenter(), axis) - axisMin) / axisExtent;
+				return Min((unsigned int)(offset * g_sahBinCount), g_sahBinCount - 1);
+			};
+			for (unsigned int i = begin; i < end; i++)
+			{
+				Bin& bin	= bins[binIndex(leaves[i])];
+				bin.box		= Merged(bin.box, m_nodes[leaves[i]].box);
+				bin.count++;
+			}
+
+			float areaBelow[g_sahBinCount - 1];
+			unsigned int countBelow[g_sahBinCount - 1];
+			BoundingBox box;
+			unsigned int count = 0;
+			for (unsigned int i = 0; i < g_sahBinCount - 1; i++)
+			{
+				box				= Merged(box, bins[i].box);
+				count			+= bins[i].count;
+				areaBelow[i]	= count ? SurfaceArea(box) : 0.0f;
+				countBelow[i]	= count;
+			}
+
+			float bestCost			= INFINITY;
+			unsigned int bestSplit	= 0;
+			box		= BoundingBox();
+			count	= 0;
+			for (unsigned int i = g_sahBinCount - 1; i > 0; i--)
+			{
+				box		= Merged(box, bins[i].box);
+				count	+= bins[i].count;
+
+				float cost = countBelow[i - 1] * areaBelow[i - 1] + count * (count ? SurfaceArea(box) : 0.0f);
+				if (cost < bestCost)
+				{
+					bestCost	= cost;
+					bestSplit	= i;
+				}
+			}
+
+			auto it	= partition(leaves.begin() + begin, leaves.begin() + end, [&](int leaf) { return binIndex(leaf) < bestSplit; });
+			mid		= (unsigned int)(it - leaves.begin());
+		}
+
+		// Degenerate split, fall back to a median split
+		if (mid == begin || mid == end)
+		{
+			mid = begin + (end - begin) / 2;
+			nth_element(leaves.begin() + begin, leaves.begin() + mid, leaves.begin() + end, [this, axis](int a, int b)
+			{
+				return Component(m_nodes[a].box.GetCenter(), axis) < Component(m_nodes[b].box.GetCenter(), axis);
+			});
+		}
+
+		int left	= BuildRecursive(leaves, begin, mid);
+		int right	= BuildRecursive(leaves, mid, end);
+		int node	= AllocateNode();
+		m_nodes[node].left		= left;
+		m_nodes[node].right		= right;
+		m_nodes[node].box		= Merged(m_nodes[left].box, m_nodes[right].box);
+		m_nodes[left].parent	= node;
+		m_nodes[right].parent	= node;
+
+		return node;
+	}
+
+	BoundingBox BoundingVolumeHierarchy::Fatten(const BoundingBox& box) const
+	{
+		Vector3 margin = box.GetExtents() * m_margin;
+		return BoundingBox(box.GetMin() - margin, box.GetMax() + margin);
+	}
+	//==============================================================================================
+}
@@ -0,0 +1,100 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =================
+#include <vector>
+#include <functional>
+#include "BoundingBox.h"
+//============================
+
+namespace Directus::Math
+{
+	class Ray;
+	class Frustum;
+
+	// A dynamic bounding volume hierarchy. Objects are inserted incrementally (choosing the sibling that
+	// least increases the surface area) and moved by refitting, they are only reinserted once they leave
+	// their fattened box. Rebuild() constructs the whole tree top-down using a binned surface area heuristic.
+	// The id returned by Insert() stays valid until Remove(), Rebuild() included. Removing or updating an id that
+	// was already removed is ignored (until the id gets reused by another Insert()).
+	class ENGINE_CLASS BoundingVolumeHierarchy
+	{
+	public:
+		BoundingVolumeHierarchy(float margin = 0.1f);
+		~BoundingVolumeHierarchy() {}
+
+		//= OBJECTS ======================================================
+		unsigned int Insert(const BoundingBox& box, void* userData);
+		void Remove(unsigned int id);
+		// Returns true if the object had to be reinserted
+		bool Update(unsigned int id, const BoundingBox& box);
+		void Rebuild();
+		void Clear();
+		void* GetUserData(unsigned int id) const	{ return m_nodes[id].userData; }
+		const BoundingBox& GetBox(unsigned int id)	{ return m_nodes[id].tightBox; }
+		unsigned int GetObjectCount() const			{ return m_objectCount; }
+		//================================================================
+
+		//= QUERIES ==========================================================================================
+		// Collects the user data of every object that isn't outside the frustum
+		void Query(const Frustum& frustum, std::vector<void*>& results) const;
+		// Collects the user data of every object whose box overlaps the sphere
+		void Query(const Vector3& center, float radius, std::vector<void*>& results) const;
+		// Returns the closest object hit by the ray (ignoring boxes that contain the ray's origin) or nullptr
+		void* RayCast(const Ray& ray, float* distance = nullptr, const std::function<bool(void*)>& filter = nullptr) const;
+		//====================================================================================================
+
+	private:
+		static const int Null = -1;
+
+		struct Node
+		{
+			bool IsLeaf() const		{ return left == Null; }
+			bool IsObject() const	{ return left == Null && !isFree; }
+
+			// Fattened for leaves, so that small movements don't require a reinsertion
+			BoundingBox box;
+			BoundingBox tightBox;
+			int parent		= Null;
+			int left		= Null;
+			int right		= Null;
+			void* userData	= nullptr;
+			// On the free list, threaded through parent
+			bool isFree		= false;
+		};
+
+		int AllocateNode();
+		void FreeNode(int index);
+		void InsertLeaf(int leaf);
+		void RemoveLeaf(int leaf);
+		void RefitAncestors(int index);
+		int BuildRecursive(std::vector<int>& leaves, unsigned int begin, unsigned int end);
+		BoundingBox Fatten(const BoundingBox& box) const;
+
+		std::vector<Node> m_nodes;
+		int m_root;
+		int m_freeList;
+		unsigned int m_objectCount;
+		float m_margin;
+	};
+}
@@ -24,6 +24,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Plane.h"
 //==================
 
+#if defined(__AVX__)
+	#define FRUSTUM_AVX
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define FRUSTUM_SSE
+	#include <emmintrin.h>
+#endif
+
 //= NAMESPACES ========================
 using namespace Directus::Math::Helper;
 //=====================================
@@ -85,7 +93,7 @@ namespace Directus::Math
 		m_planes[5].Normalize();
 	}
 
-	Intersection Frustum::CheckCube(const Vector3& center, const Vector3& extent)
+	Intersection Frustum::CheckCube(const Vector3& center, const Vector3& extent) const
 	{
 		// Check if any one point of the cube is in the view frustum.
 		Intersection result = Inside;
@@ -114,9 +122,10 @@ namespace Directus::Math
 		return result;
 	}
 
-	Intersection Frustum::CheckSphere(const Vector3& center, float radius)
+	Intersection Frustum::CheckSphere(const Vector3& center, float radius) const
 	{
 		// calculate our distances to each of the planes
+		bool intersects = false;
 		for (const auto& plane : m_planes)
 		{
 			// find the distance to this plane
@@ -128,14 +137,107 @@ namespace Directus::Math
 				return Outside;
 			}
 
-			// else if the distance is between +- radius, then we intersect
-			if ((float)fabs(fDistance) < radius)
+			// else if the distance is between +- radius, then we intersect (unless another plane has us outside)
+			intersects = intersects || (float)fabs(fDistance) < radius;
+		}
+
+		// otherwise we are fully in view
+		return intersects ? Intersects : Inside;
+	}
+
+	void Frustum::CheckCubes(
+		const float* centerX, const float* centerY, const float* centerZ,
+		const float* extentX, const float* extentY, const float* extentZ,
+		unsigned int count,
+		uint32_t* visibility
+	) const
+	{
+		for (unsigned int i = 0; i < (count + 31) / 32; i++)
+		{
+			visibility[i] = 0;
+		}
+
+		unsigned int i = 0;
+
+#if defined(FRUSTUM_AVX)
+		// 8 boxes per iteration
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 cx = _mm256_loadu_ps(centerX + i);
+			__m256 cy = _mm256_loadu_ps(centerY + i);
+			__m256 cz = _mm256_loadu_ps(centerZ + i);
+			__m256 ex = _mm256_loadu_ps(extentX + i);
+			__m256 ey = _mm256_loadu_ps(extentY + i);
+			__m256 ez = _mm256_loadu_ps(extentZ + i);
+			__m256 outside = _mm256_setzero_ps();
+
+			for (const auto& plane : m_planes)
+			{
+				__m256 d = _mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(cx, _mm256_set1_ps(plane.normal.x)),
+					_mm256_mul_ps(cy, _mm256_set1_ps(plane.normal.y))),
+					_mm256_mul_ps(cz, _mm256_set1_ps(plane.normal.z)));
+				__m256 r = _mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(ex, _mm256_set1_ps(Abs(plane.normal.x))),
+					_mm256_mul_ps(ey, _mm256_set1_ps(Abs(plane.normal.y)))),
+					_mm256_mul_ps(ez, _mm256_set1_ps(Abs(plane.normal.z))));
+
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(d, r), _mm256_set1_ps(-plane.d), _CMP_LT_OQ));
+			}
+
+			uint32_t visible = ~(uint32_t)_mm256_movemask_ps(outside) & 0xFF;
+			visibility[i / 32] |= visible << (i % 32);
+		}
+#elif defined(FRUSTUM_SSE)
+		// 4 boxes per iteration
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 cx = _mm_loadu_ps(centerX + i);
+			__m128 cy = _mm_loadu_ps(centerY + i);
+			__m128 cz = _mm_loadu_ps(centerZ + i);
+			__m128 ex = _mm_loadu_ps(extentX + i);
+			__m128 ey = _mm_loadu_ps(extentY + i);
+			__m128 ez = _mm_loadu_ps(extentZ + i);
+			__m128 outside = _mm_setzero_ps();
+
+			for (const auto& plane : m_planes)
 			{
-				return Intersects;
+				__m128 d = _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(cx, _mm_set1_ps(plane.normal.x)),
+					_mm_mul_ps(cy, _mm_set1_ps(plane.normal.y))),
+					_mm_mul_ps(cz, _mm_set1_ps(plane.normal.z)));
+				__m128 r = _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(ex, _mm_set1_ps(Abs(plane.normal.x))),
+					_mm_mul_ps(ey, _mm_set1_ps(Abs(plane.normal.y)))),
+					_mm_mul_ps(ez, _mm_set1_ps(Abs(plane.normal.z))));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), _mm_set1_ps(-plane.d)));
 			}
+
+			uint32_t visible = ~(uint32_t)_mm_movemask_ps(outside) & 0xF;
+			visibility[i / 32] |= visible << (i % 32);
 		}
+#endif
 
-		// otherwise we are fully in view
-		return Inside;
+		// Remainder (or everything, when SIMD is not available)
+		for (; i < count; i++)
+		{
+			bool outside = false;
+			for (const auto& plane : m_planes)
+			{
+				float d = centerX[i] * plane.normal.x + centerY[i] * plane.normal.y + centerZ[i] * plane.normal.z;
+				float r = extentX[i] * Abs(plane.normal.x) + extentY[i] * Abs(plane.normal.y) + extentZ[i] * Abs(plane.normal.z);
+				if (d + r < -plane.d)
+				{
+					outside = true;
+					break;
+				}
+			}
+
+			if (!outside)
+			{
+				visibility[i / 32] |= 1u << (i % 32);
+			}
+		}
 	}
 }
\ No newline at end of file
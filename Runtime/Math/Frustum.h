@@ -22,6 +22,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES =============
+#include <cstdint>
 #include "../Math/Plane.h"
 #include "Matrix.h"
 #include "Vector3.h"
@@ -36,8 +37,17 @@ namespace Directus::Math
 		~Frustum() {}
 
 		void Construct(const Matrix& mView, const Matrix&  mProjection, float screenDepth);
-		Intersection CheckCube(const Vector3& center, const Vector3& extent);
-		Intersection CheckSphere(const Vector3& center, float radius);
+		Intersection CheckCube(const Vector3& center, const Vector3& extent) const;
+		Intersection CheckSphere(const Vector3& center, float radius) const;
+
+		// Tests count boxes, given as a structure of arrays, 4 or 8 at a time (SSE/AVX) with a scalar fallback.
+		// Bit i of visibility (an array of (count + 31) / 32 words) is set if box i is not outside.
+		void CheckCubes(
+			const float* centerX, const float* centerY, const float* centerZ,
+			const float* extentX, const float* extentY, const float* extentZ,
+			unsigned int count,
+			uint32_t* visibility
+		) const;
 
 	private:
 		Plane m_planes[6];
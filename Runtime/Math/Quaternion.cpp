@@ -54,7 +54,7 @@ namespace Directus::Math
 	string Quaternion::ToString() const
 	{
 		char tempBuffer[200];
-		sprintf_s(tempBuffer, "X:%f, Y:%f, Z:%f, W:%f", x, y, z, w);
+		snprintf(tempBuffer, sizeof(tempBuffer), "X:%f, Y:%f, Z:%f, W:%f", x, y, z, w);
 		return string(tempBuffer);
 	}
 }
\ No newline at end of file
@@ -40,7 +40,7 @@ namespace Directus::Math
 		m_direction = (end - origin).Normalized();
 	}
 
-	float Ray::HitDistance(const BoundingBox& box)
+	float Ray::HitDistance(const BoundingBox& box) const
 	{
 		// If undefined, no hit (infinite distance)
 		if (!box.Defined())
@@ -42,7 +42,7 @@ namespace Directus::Math
 		~Ray() {}
 
 		// Returns hit distance to a bounding box, or infinity if there is no hit.
-		float HitDistance(const BoundingBox& box);
+		float HitDistance(const BoundingBox& box) const;
 
 		const Vector3& GetOrigin() const	{ return m_origin; }
 		const Vector3& GetEnd()	const		{ return m_end; }
@@ -35,7 +35,7 @@ namespace Directus::Math
 	string Vector2::ToString() const
 	{
 		char tempBuffer[200];
-		sprintf_s(tempBuffer, "X:%f, Y:%f", x, y);
+		snprintf(tempBuffer, sizeof(tempBuffer), "X:%f, Y:%f", x, y);
 		return string(tempBuffer);
 	}
 }
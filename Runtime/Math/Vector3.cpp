@@ -43,7 +43,7 @@ namespace Directus::Math
 	string Vector3::ToString() const
 	{
 		char tempBuffer[200];
-		sprintf_s(tempBuffer, "X:%f, Y:%f, Z:%f", x, y, z);
+		snprintf(tempBuffer, sizeof(tempBuffer), "X:%f, Y:%f, Z:%f", x, y, z);
 		return string(tempBuffer);
 	}
 }
@@ -19,19 +19,20 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ===========================
+//= INCLUDES =============================================
 #include "Profiler.h"
 #include "../Core/Timer.h"
 #include "../Core/Settings.h"
 #include "../Core/EventSystem.h"
 #include "../World/World.h"
 #include "../Rendering/Renderer.h"
+#include "../Rendering/Deferred/ShaderVariationRegistry.h"
 #include <iomanip>
 #include <sstream>
 #include "../RHI/RHI_Device.h"
 #include "../Core/Variant.h"
 #include "../Resource/ResourceManager.h"
-//======================================
+//========================================================
 
 //= NAMESPACES =============
 using namespace std;
@@ -46,6 +47,7 @@ namespace Directus
 		m_scene						= nullptr;
 		m_timer						= nullptr;
 		m_resourceManager			= nullptr;
+		m_renderer					= nullptr;
 		m_gpuProfiling				= true;	// expensive
 		m_cpuProfiling				= true;	// cheap
 		m_profilingFrequencySec		= 0.0f;
@@ -60,7 +62,8 @@ namespace Directus
 		m_scene						= context->GetSubsystem<World>();
 		m_timer						= context->GetSubsystem<Timer>();
 		m_resourceManager			= context->GetSubsystem<ResourceManager>();
-		m_rhiDevice					= context->GetSubsystem<Renderer>()->GetRHIDevice();
+		m_renderer					= context->GetSubsystem<Renderer>();
+		m_rhiDevice					= m_renderer->GetRHIDevice();
 		m_profilingFrequencySec		= 0.35f;
 		m_profilingLastUpdateTime	= m_profilingFrequencySec;
 
@@ -74,7 +77,7 @@ namespace Directus
 		if (!m_cpuProfiling || !m_shouldUpdate)
 			return;
 
-		m_timeBlocks_cpu[funcName].start = high_resolution_clock::now();
+		m_timeBlocks_cpu[funcName].start = steady_clock::now();
 	}
 
 	void Profiler::TimeBlockEnd_CPU(const char* funcName)
@@ -84,7 +87,7 @@ namespace Directus
 
 		auto timeBlock = &m_timeBlocks_cpu[funcName];
 
-		timeBlock->end				= high_resolution_clock::now();
+		timeBlock->end				= steady_clock::now();
 		duration<double, milli> ms	= timeBlock->end - timeBlock->start;
 		timeBlock->duration			= (float)ms.count();
 	}
@@ -178,7 +181,8 @@ namespace Directus
 	{
 		int textures	= m_resourceManager->GetResourceCountByType(Resource_Texture);
 		int materials	= m_resourceManager->GetResourceCountByType(Resource_Material);
-		int shaders		= m_resourceManager->GetResourceCountByType(Resource_Shader);
+		// The G-Buffer variations (what used to be cached as shader resources), the renderer's own shaders aren't counted
+		int variations	= (int)m_renderer->GetShaderVariations()->GetStats().permutationCount;
 
 		m_metrics =
 			// Performance
@@ -194,7 +198,7 @@ namespace Directus
 			"Meshes rendered:\t\t\t\t"			+ to_string(m_rendererMeshesRendered) + "\n"
 			"Textures:\t\t\t\t\t\t"				+ to_string(textures) + "\n"
 			"Materials:\t\t\t\t\t\t"			+ to_string(materials) + "\n"
-			"Shaders:\t\t\t\t\t\t"				+ to_string(shaders) + "\n"
+			"Shader variations:\t\t\t\t"		+ to_string(variations) + "\n"
 
 			// RHI
 			"RHI Draw calls:\t\t\t\t\t"			+ to_string(m_rhiDrawCalls) + "\n"
@@ -45,6 +45,7 @@ namespace Directus
 	class World;
 	class Timer;
 	class ResourceManager;
+	class Renderer;
 	class RHI_Device;
 	class Variant;
 
@@ -167,6 +168,7 @@ namespace Directus
 		World* m_scene;
 		Timer* m_timer;
 		ResourceManager* m_resourceManager;
+		Renderer* m_renderer;
 		std::shared_ptr<RHI_Device> m_rhiDevice;
 	};
 }
@@ -19,6 +19,11 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifndef API_NULL
+//================================
+
 //= INCLUDES =====================
 #include "../RHI_ConstantBuffer.h"
 #include <d3d11.h>
@@ -120,4 +125,5 @@ namespace Directus
 
 		return true;
 	}
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
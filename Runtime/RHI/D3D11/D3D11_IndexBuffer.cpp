@@ -19,8 +19,12 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ========================
+//= IMPLEMENTATION ===============
 #include "../RHI_Implementation.h"
+#ifndef API_NULL
+//================================
+
+//= INCLUDES ========================
 #include "../RHI_Device.h"
 #include "../RHI_IndexBuffer.h"
 #include "../../Logging/Log.h"
@@ -181,4 +185,5 @@ namespace Directus
 		m_rhiDevice->GetDeviceContext<ID3D11DeviceContext>()->IASetIndexBuffer((ID3D11Buffer*)m_buffer, DXGI_FORMAT_R32_UINT, 0);
 		return true;
 	}
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
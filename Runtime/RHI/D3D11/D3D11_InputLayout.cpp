@@ -19,8 +19,12 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =====================
+//= IMPLEMENTATION ===============
 #include "../RHI_Implementation.h"
+#ifndef API_NULL
+//================================
+
+//= INCLUDES =====================
 #include "../RHI_InputLayout.h"
 #include "../RHI_Device.h"
 #include "../../Logging/Log.h"
@@ -216,4 +220,5 @@ namespace Directus
 			(unsigned int)m_layoutDesc.size()
 		);
 	}
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
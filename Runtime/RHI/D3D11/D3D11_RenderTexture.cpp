@@ -19,8 +19,12 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ========================
+//= IMPLEMENTATION ===============
 #include "../RHI_Implementation.h"
+#ifndef API_NULL
+//================================
+
+//= INCLUDES ========================
 #include "../RHI_RenderTexture.h"
 #include "../RHI_Device.h"
 #include "../../Core/GUIDGenerator.h"
@@ -211,4 +215,5 @@ namespace Directus
 	{
 		return m_depthStencilView;
 	}
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
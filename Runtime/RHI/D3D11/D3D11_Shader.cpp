@@ -19,10 +19,15 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ===========================
+//= IMPLEMENTATION ===============
 #include "../RHI_Implementation.h"
+#ifndef API_NULL
+//================================
+
+//= INCLUDES ===========================
 #include "../RHI_Device.h"
 #include "../RHI_Shader.h"
+#include "../RHI_ShaderCache.h"
 #include "../RHI_InputLayout.h"
 #include <d3dcompiler.h>
 #include <sstream> 
@@ -59,19 +64,49 @@ namespace Directus
 			}
 		}
 
-		inline bool CompileShader(const string& filePath, D3D_SHADER_MACRO* macros, const char* entryPoint, const char* shaderModel, ID3DBlob** shaderBlobOut)
+		inline vector<D3D_SHADER_MACRO> GetD3DMacros(const map<string, string>& macros)
+		{
+			vector<D3D_SHADER_MACRO> d3dMacros;	
+			for (const auto& macro : macros)
+			{
+				D3D_SHADER_MACRO d3dMacro;
+				d3dMacro.Name		= macro.first.c_str();
+				d3dMacro.Definition = macro.second.c_str();
+				d3dMacros.emplace_back(d3dMacro);
+			}
+			d3dMacros.push_back(D3D_SHADER_MACRO{ nullptr, nullptr });
+			return d3dMacros;
+		}
+
+		inline bool CompileShader(RHI_ShaderCache* cache, const string& filePath, const map<string, string>& macros, const char* entryPoint, const char* shaderModel, ID3DBlob** shaderBlobOut, uint64_t* cachedKeyOut)
 		{
 			unsigned compileFlags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_OPTIMIZATION_LEVEL3;
 			#ifdef DEBUG
 			compileFlags |= D3DCOMPILE_DEBUG | D3DCOMPILE_PREFER_FLOW_CONTROL;
 			#endif
 
+			// A binary compiled (with the same source, macros, flags and compiler) in this or an earlier session
+			*cachedKeyOut = 0;
+			uint64_t key = cache ? cache->ComputeKey(filePath, macros, entryPoint, shaderModel, compileFlags, D3D_COMPILER_VERSION) : 0;
+			if (auto binary = cache ? cache->Load(key) : nullptr)
+			{
+				ID3DBlob* shaderBlob = nullptr;
+				if (SUCCEEDED(D3DCreateBlob(binary->size(), &shaderBlob)))
+				{
+					memcpy(shaderBlob->GetBufferPointer(), binary->data(), binary->size());
+					*shaderBlobOut	= shaderBlob;
+					*cachedKeyOut	= key;
+					return true;
+				}
+			}
+
 			// Load and compile from file
+			vector<D3D_SHADER_MACRO> d3dMacros = GetD3DMacros(macros);
 			ID3DBlob* errorBlob		= nullptr;
 			ID3DBlob* shaderBlob	= nullptr;
 			auto result = D3DCompileFromFile(
 				FileSystem::StringToWString(filePath).c_str(),
-				macros,
+				&d3dMacros.front(),
 				D3D_COMPILE_STANDARD_FILE_INCLUDE,
 				entryPoint,
 				shaderModel,
@@ -102,13 +137,18 @@ namespace Directus
 				}
 			}
 
+			if (SUCCEEDED(result) && cache)
+			{
+				cache->Store(key, shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize());
+			}
+
 			// Write to blob out
 			*shaderBlobOut = shaderBlob;
 
 			return SUCCEEDED(result);
 		}
 
-		inline bool CompileVertexShader(ID3D11Device* device, ID3D10Blob** vsBlob, ID3D11VertexShader** vertexShader, const string& path, const char* entrypoint, const char* shaderModel, D3D_SHADER_MACRO* macros)
+		inline bool CompileVertexShader(ID3D11Device* device, RHI_ShaderCache* cache, ID3D10Blob** vsBlob, ID3D11VertexShader** vertexShader, const string& path, const char* entrypoint, const char* shaderModel, const map<string, string>& macros)
 		{
 			if (!device)
 			{
@@ -116,12 +156,28 @@ namespace Directus
 				return false;
 			}
 			// Compile shader
-			if (!CompileShader(path, macros, entrypoint, shaderModel, vsBlob))
+			uint64_t cachedKey = 0;
+			if (!CompileShader(cache, path, macros, entrypoint, shaderModel, vsBlob, &cachedKey))
 				return false;
 
 			// Create the shader from the buffer.
-			ID3D10Blob* vsb = *vsBlob;
-			if (FAILED(device->CreateVertexShader(vsb->GetBufferPointer(), vsb->GetBufferSize(), nullptr, vertexShader)))
+			ID3D10Blob* vsb	= *vsBlob;
+			HRESULT result	= device->CreateVertexShader(vsb->GetBufferPointer(), vsb->GetBufferSize(), nullptr, vertexShader);
+
+			// A cached binary the driver rejects is dropped from the cache and compiled again
+			if (FAILED(result) && cachedKey != 0)
+			{
+				LOGF_WARNING("D3D11_Shader::CompileVertexShader: The cached binary of \"%s\" was rejected, recompiling.", FileSystem::GetFileNameFromFilePath(path).c_str());
+				cache->Remove(cachedKey);
+				SafeRelease(*vsBlob);
+				if (!CompileShader(cache, path, macros, entrypoint, shaderModel, vsBlob, &cachedKey))
+					return false;
+
+				vsb		= *vsBlob;
+				result	= device->CreateVertexShader(vsb->GetBufferPointer(), vsb->GetBufferSize(), nullptr, vertexShader);
+			}
+
+			if (FAILED(result))
 			{
 				LOG_ERROR("D3D11_Shader::CompileVertexShader: Failed to create vertex shader.");
 				return false;
@@ -130,7 +186,7 @@ namespace Directus
 			return true;
 		}
 
-		inline bool CompilePixelShader(ID3D11Device* device, ID3D10Blob** psBlob, ID3D11PixelShader** pixelShader, const string& path, const char* entrypoint, const char* shaderModel, D3D_SHADER_MACRO* macros)
+		inline bool CompilePixelShader(ID3D11Device* device, RHI_ShaderCache* cache, ID3D10Blob** psBlob, ID3D11PixelShader** pixelShader, const string& path, const char* entrypoint, const char* shaderModel, const map<string, string>& macros)
 		{
 			if (!device)
 			{
@@ -139,12 +195,28 @@ namespace Directus
 			}
 
 			// Compile the shader
-			if (!CompileShader(path, macros, entrypoint, shaderModel, psBlob))
+			uint64_t cachedKey = 0;
+			if (!CompileShader(cache, path, macros, entrypoint, shaderModel, psBlob, &cachedKey))
 				return false;
 
 			// Create the shader from the buffer.
-			ID3D10Blob* psb = *psBlob;
-			if (FAILED(device->CreatePixelShader(psb->GetBufferPointer(), psb->GetBufferSize(), nullptr, pixelShader)))
+			ID3D10Blob* psb	= *psBlob;
+			HRESULT result	= device->CreatePixelShader(psb->GetBufferPointer(), psb->GetBufferSize(), nullptr, pixelShader);
+
+			// A cached binary the driver rejects is dropped from the cache and compiled again
+			if (FAILED(result) && cachedKey != 0)
+			{
+				LOGF_WARNING("D3D11_Shader::CompilePixelShader: The cached binary of \"%s\" was rejected, recompiling.", FileSystem::GetFileNameFromFilePath(path).c_str());
+				cache->Remove(cachedKey);
+				SafeRelease(*psBlob);
+				if (!CompileShader(cache, path, macros, entrypoint, shaderModel, psBlob, &cachedKey))
+					return false;
+
+				psb		= *psBlob;
+				result	= device->CreatePixelShader(psb->GetBufferPointer(), psb->GetBufferSize(), nullptr, pixelShader);
+			}
+
+			if (FAILED(result))
 			{
 				LOG_ERROR("D3D11_Shader::CompilePixelShader: Failed to create pixel shader.");
 				return false;
@@ -152,19 +224,6 @@ namespace Directus
 
 			return true;
 		}
-
-		inline vector<D3D_SHADER_MACRO> GetD3DMacros(const map<string, string>& macros)
-		{
-			vector<D3D_SHADER_MACRO> d3dMacros;	
-			for (const auto& macro : macros)
-			{
-				D3D_SHADER_MACRO d3dMacro;
-				d3dMacro.Name		= macro.first.c_str();
-				d3dMacro.Definition = macro.second.c_str();
-				d3dMacros.emplace_back(d3dMacro);
-			}
-			return d3dMacros;
-		}
 	}
 
 	RHI_Shader::RHI_Shader(shared_ptr<RHI_Device> rhiDevice)
@@ -183,10 +242,9 @@ namespace Directus
 	{
 		m_filePath = filePath;
 
-		vector<D3D_SHADER_MACRO> vsMacros = D3D11_Shader::GetD3DMacros(m_macros);
-		vsMacros.push_back(D3D_SHADER_MACRO{ "COMPILE_VS", "1" });
-		vsMacros.push_back(D3D_SHADER_MACRO{ "COMPILE_PS", "0" });
-		vsMacros.push_back(D3D_SHADER_MACRO{ nullptr, nullptr });
+		auto vsMacros			= m_macros;
+		vsMacros["COMPILE_VS"]	= "1";
+		vsMacros["COMPILE_PS"]	= "0";
 
 		ID3D10Blob* blobVS	= nullptr;
 		auto shaderPtr		= (ID3D11VertexShader**)&m_vertexShader;
@@ -194,12 +252,13 @@ namespace Directus
 		// Compile the shader
 		if (D3D11_Shader::CompileVertexShader(
 			m_rhiDevice->GetDevice<ID3D11Device>(),
+			m_rhiDevice->GetShaderCache(),
 			&blobVS,
 			shaderPtr,
 			m_filePath,
 			VERTEX_SHADER_ENTRYPOINT,
 			VERTEX_SHADER_MODEL,
-			&vsMacros.front()))
+			vsMacros))
 		{
 			// Create input layout
 			if (!m_inputLayout->Create(blobVS, inputLayout))
@@ -222,22 +281,22 @@ namespace Directus
 	{
 		m_filePath = filePath;
 
-		vector<D3D_SHADER_MACRO> psMacros = D3D11_Shader::GetD3DMacros(m_macros);
-		psMacros.push_back(D3D_SHADER_MACRO{ "COMPILE_VS", "0" });
-		psMacros.push_back(D3D_SHADER_MACRO{ "COMPILE_PS", "1" });
-		psMacros.push_back(D3D_SHADER_MACRO{ nullptr, nullptr });
+		auto psMacros			= m_macros;
+		psMacros["COMPILE_VS"]	= "0";
+		psMacros["COMPILE_PS"]	= "1";
 
 		ID3D10Blob* blobPS	= nullptr;
 		auto shaderPtr		= (ID3D11PixelShader**)&m_pixelShader;	
 
 		if (D3D11_Shader::CompilePixelShader(
 			m_rhiDevice->GetDevice<ID3D11Device>(),
+			m_rhiDevice->GetShaderCache(),
 			&blobPS,
 			shaderPtr,
 			m_filePath,
 			PIXEL_SHADER_ENTRYPOINT,
 			PIXEL_SHADER_MODEL,
-			&psMacros.front()
+			psMacros
 		))
 		{
 			SafeRelease(blobPS);
@@ -250,4 +309,5 @@ namespace Directus
 
 		return m_hasPixelShader;
 	}
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
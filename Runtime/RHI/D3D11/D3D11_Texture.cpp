@@ -19,8 +19,12 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =====================
+//= IMPLEMENTATION ===============
 #include "../RHI_Implementation.h"
+#ifndef API_NULL
+//================================
+
+//= INCLUDES =====================
 #include "../RHI_Device.h"
 #include "../RHI_Texture.h"
 #include "../../Math/MathHelper.h"
@@ -47,6 +51,13 @@ namespace Directus
 			return false;
 		}
 
+		// The GPU can't render into block compressed textures, so it can't generate their mips either
+		if (generateMimaps && GetBlockSize(format) != 0)
+		{
+			LOG_ERROR("RHI_Texture::ShaderResource_Create2D: Mip-maps can't be generated for block compressed textures.");
+			return false;
+		}
+
 		ID3D11Texture2D* texture						= nullptr;
 		ID3D11ShaderResourceView* shaderResourceView	= nullptr;
 
@@ -76,6 +87,7 @@ namespace Directus
 		vector<D3D11_SUBRESOURCE_DATA> vec_subresourceData;
 		unsigned int mipWidth	= width;
 		unsigned int mipHeight	= height;
+		unsigned int blockSize	= GetBlockSize(format);
 		for (unsigned int i = 0; i < (generateMimaps ? 1 : (unsigned int)data.size()); i++)
 		{
 			if (data[i].empty())
@@ -86,7 +98,7 @@ namespace Directus
 
 			vec_subresourceData.emplace_back(D3D11_SUBRESOURCE_DATA{});
 			vec_subresourceData.back().pSysMem			= data[i].data();
-			vec_subresourceData.back().SysMemPitch		= (mipWidth * channels) * sizeof(std::byte);
+			vec_subresourceData.back().SysMemPitch		= blockSize ? Max((mipWidth + 3) / 4, (unsigned int)1) * blockSize : (mipWidth * channels) * sizeof(std::byte); // Block compressed rows are rows of blocks
 			vec_subresourceData.back().SysMemSlicePitch = 0;
 
 			// Compute size of next mip-map
@@ -226,4 +238,5 @@ namespace Directus
 	{
 		SafeRelease((ID3D11ShaderResourceView*)m_shaderResource);
 	}
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -19,8 +19,12 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =====================
+//= IMPLEMENTATION ===============
 #include "../RHI_Implementation.h"
+#ifndef API_NULL
+//================================
+
+//= INCLUDES =====================
 #include "../RHI_Device.h"
 #include "../RHI_VertexBuffer.h"
 #include "../RHI_Vertex.h"
@@ -278,4 +282,5 @@ namespace Directus
 		m_rhiDevice->GetDeviceContext<ID3D11DeviceContext>()->IASetVertexBuffers(0, 1, ptr, &m_stride, &offset);
 		return true;
 	}
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
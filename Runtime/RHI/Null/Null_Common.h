@@ -0,0 +1,161 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "../../Core/EngineDefs.h"
+//================================
+
+// System memory stand-ins for the GPU objects of the null backend.
+// The device hands out a Null_CommandList through RHI_Device::GetDeviceContext<Null_CommandList>(),
+// which can be inspected to see exactly what the renderer submitted.
+namespace Directus
+{
+	enum Null_Command_Type
+	{
+		Null_Command_Draw,
+		Null_Command_DrawIndexed,
+		Null_Command_ClearBackBuffer,
+		Null_Command_ClearRenderTarget,
+		Null_Command_ClearDepthStencil,
+		Null_Command_Present,
+		Null_Command_SetBackBufferAsRenderTarget,
+		Null_Command_SetVertexShader,
+		Null_Command_SetPixelShader,
+		Null_Command_SetConstantBuffers,
+		Null_Command_SetSamplers,
+		Null_Command_SetRenderTargets,
+		Null_Command_SetTextures,
+		Null_Command_SetViewport,
+		Null_Command_SetDepthEnabled,
+		Null_Command_SetAlphaBlendingEnabled,
+		Null_Command_SetCullMode,
+		Null_Command_SetPrimitiveTopology,
+		Null_Command_SetFillMode,
+		Null_Command_SetInputLayout,
+		Null_Command_SetVertexBuffer,
+		Null_Command_SetIndexBuffer,
+		Null_Command_UpdateBuffer,
+		Null_Command_EventBegin,
+		Null_Command_EventEnd
+	};
+
+	struct Null_Command
+	{
+		Null_Command_Type type;
+		// Meaning depends on the type (counts, offsets, slots, enum values or sizes)
+		unsigned int args[3];
+		// The first resource involved, if any
+		const void* resource;
+	};
+
+	struct Null_Resource
+	{
+		Null_Resource(unsigned int size = 0, unsigned int stride = 0)
+		{
+			data.resize(size);
+			this->stride = stride;
+		}
+
+		std::vector<std::byte> data;
+		unsigned int stride;
+	};
+
+	class ENGINE_CLASS Null_CommandList
+	{
+	public:
+		struct Stats
+		{
+			uint64_t draws					= 0;
+			uint64_t stateChanges			= 0;
+			uint64_t constantBufferUpdates	= 0;
+			uint64_t bytesUploaded			= 0;
+		};
+
+		void Record(Null_Command_Type type, const void* resource = nullptr, unsigned int arg0 = 0, unsigned int arg1 = 0, unsigned int arg2 = 0)
+		{
+			m_commands.emplace_back(Null_Command{ type, { arg0, arg1, arg2 }, resource });
+
+			if (type == Null_Command_Draw || type == Null_Command_DrawIndexed)
+			{
+				m_stats.draws++;
+			}
+			else if (type >= Null_Command_SetBackBufferAsRenderTarget && type <= Null_Command_SetIndexBuffer)
+			{
+				m_stats.stateChanges++;
+			}
+		}
+
+		// Constant buffer updates happen on the rendering thread and are recorded
+		void RecordUpdate(const void* resource, unsigned int size, bool constantBuffer)
+		{
+			Record(Null_Command_UpdateBuffer, resource, size, constantBuffer);
+			m_stats.constantBufferUpdates += constantBuffer ? 1 : 0;
+			m_bytesUploaded += size;
+		}
+
+		// Resources can be created by any thread, so creation only counts the bytes
+		void AddUpload(unsigned int size) { m_bytesUploaded += size; }
+
+		// Closes the current frame, it then becomes available through GetLastFrame*()
+		void EndFrame()
+		{
+			m_stats.bytesUploaded	= m_bytesUploaded.exchange(0);
+			m_lastFrameStats		= m_stats;
+			m_lastFrame.swap(m_commands);
+			m_commands.clear();
+			m_stats = Stats();
+		}
+
+		const std::vector<Null_Command>& GetCommands()	{ return m_commands; }
+		const std::vector<Null_Command>& GetLastFrame()	{ return m_lastFrame; }
+		const Stats& GetLastFrameStats()				{ return m_lastFrameStats; }
+		const std::string& GetEventName(unsigned int index) { return m_eventNames[index]; }
+
+		// Event names are interned, commands only carry their index
+		unsigned int GetEventIndex(const std::string& name)
+		{
+			auto it = m_eventIndices.find(name);
+			if (it != m_eventIndices.end())
+				return it->second;
+
+			m_eventNames.emplace_back(name);
+			return m_eventIndices[name] = (unsigned int)m_eventNames.size() - 1;
+		}
+
+	private:
+		std::vector<Null_Command> m_commands;
+		std::vector<Null_Command> m_lastFrame;
+		std::vector<std::string> m_eventNames;
+		std::unordered_map<std::string, unsigned int> m_eventIndices;
+		Stats m_stats;
+		Stats m_lastFrameStats;
+		std::atomic<uint64_t> m_bytesUploaded{ 0 };
+	};
+}
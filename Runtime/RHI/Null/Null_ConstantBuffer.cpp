@@ -0,0 +1,99 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifdef API_NULL
+//================================
+
+//= INCLUDES =====================
+#include "Null_Common.h"
+#include "../RHI_ConstantBuffer.h"
+#include "../RHI_Device.h"
+#include "../../Logging/Log.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	RHI_ConstantBuffer::RHI_ConstantBuffer(shared_ptr<RHI_Device> rhiDevice)
+	{
+		m_rhiDevice = rhiDevice;
+		m_buffer	= nullptr;
+	}
+
+	RHI_ConstantBuffer::~RHI_ConstantBuffer()
+	{
+		delete (Null_Resource*)m_buffer;
+		m_buffer = nullptr;
+	}
+
+	bool RHI_ConstantBuffer::Create(unsigned int size, unsigned int slot, Buffer_Scope scope)
+	{
+		if (!m_rhiDevice || !m_rhiDevice->GetDevice<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_ConstantBuffer::Create: Invalid RHI device");
+			return false;
+		}
+
+		m_slot		= slot;
+		m_scope		= scope;
+		m_buffer	= new Null_Resource(size);
+
+		return true;
+	}
+
+	void* RHI_ConstantBuffer::Map()
+	{
+		if (!m_buffer)
+		{
+			LOG_ERROR("RHI_ConstantBuffer::Map: Invalid buffer");
+			return nullptr;
+		}
+
+		return ((Null_Resource*)m_buffer)->data.data();
+	}
+
+	bool RHI_ConstantBuffer::Unmap()
+	{
+		if (!m_rhiDevice || !m_rhiDevice->GetDeviceContext<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_ConstantBuffer::Unmap: Invalid RHI device");
+			return false;
+		}
+
+		if (!m_buffer)
+		{
+			LOG_ERROR("RHI_ConstantBuffer::Unmap: Invalid buffer");
+			return false;
+		}
+
+		// Mapping discards, so every unmap uploads the whole buffer
+		m_rhiDevice->GetDeviceContext<Null_CommandList>()->RecordUpdate(m_buffer, (unsigned int)((Null_Resource*)m_buffer)->data.size(), true);
+
+		return true;
+	}
+}
+#endif
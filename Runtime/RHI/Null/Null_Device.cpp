@@ -0,0 +1,242 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifdef API_NULL
+//================================
+
+//= INCLUDES ======================
+#include "Null_Common.h"
+#include "../RHI_Device.h"
+#include "../../Logging/Log.h"
+#include "../../Profiling/Profiler.h"
+//=================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus::Math;
+//=============================
+
+namespace Directus
+{
+	namespace _Null_Device
+	{
+		// Stand-ins for the swap chain's views and for timestamp queries
+		Null_Resource backBuffer;
+		Null_Resource depthStencil;
+		Null_Resource query;
+	}
+
+	RHI_Device::RHI_Device(void* drawHandle)
+	{
+		m_format				= Texture_Format_R8G8B8A8_UNORM;
+		m_depthEnabled			= true;
+		m_alphaBlendingEnabled	= false;
+
+		// There is no window to present to, so the draw handle is ignored and a single command list acts as both device and context
+		m_device		= new Null_CommandList();
+		m_deviceContext	= m_device;
+		m_initialized	= true;
+
+		Settings::Get().DisplayMode_Add(Settings::Get().Resolution_GetWidth(), Settings::Get().Resolution_GetHeight(), 60, 1);
+		LOG_INFO("RHI_Device::RHI_Device: Null backend, commands are recorded but never executed");
+	}
+
+	RHI_Device::~RHI_Device()
+	{
+		delete GetDevice<Null_CommandList>();
+		m_device		= nullptr;
+		m_deviceContext	= nullptr;
+	}
+
+	void RHI_Device::Draw(unsigned int vertexCount)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_Draw, nullptr, vertexCount);
+		Profiler::Get().m_rhiDrawCalls++;
+	}
+
+	void RHI_Device::DrawIndexed(unsigned int indexCount, unsigned int indexOffset, unsigned int vertexOffset)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_DrawIndexed, nullptr, indexCount, indexOffset, vertexOffset);
+		Profiler::Get().m_rhiDrawCalls++;
+	}
+
+	void RHI_Device::ClearBackBuffer(const Vector4& color)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_ClearBackBuffer, &_Null_Device::backBuffer);
+		if (m_depthEnabled)
+		{
+			GetDeviceContext<Null_CommandList>()->Record(Null_Command_ClearDepthStencil, &_Null_Device::depthStencil, Clear_Depth | Clear_Stencil);
+		}
+	}
+
+	void RHI_Device::ClearRenderTarget(void* renderTarget, const Math::Vector4& color)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_ClearRenderTarget, renderTarget);
+	}
+
+	void RHI_Device::ClearDepthStencil(void* depthStencil, unsigned int flags, float depth, uint8_t stencil)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_ClearDepthStencil, depthStencil, flags, stencil);
+	}
+
+	void RHI_Device::Present()
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_Present, &_Null_Device::backBuffer);
+		GetDeviceContext<Null_CommandList>()->EndFrame();
+	}
+
+	void RHI_Device::Set_BackBufferAsRenderTarget()
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetBackBufferAsRenderTarget, &_Null_Device::backBuffer, m_depthEnabled);
+	}
+
+	void RHI_Device::Set_VertexShader(void* buffer)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetVertexShader, buffer);
+	}
+
+	void RHI_Device::Set_PixelShader(void* buffer)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetPixelShader, buffer);
+	}
+
+	void RHI_Device::Set_ConstantBuffers(unsigned int startSlot, unsigned int bufferCount, Buffer_Scope scope, void* const* buffer)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetConstantBuffers, buffer ? buffer[0] : nullptr, startSlot, bufferCount, scope);
+	}
+
+	void RHI_Device::Set_Samplers(unsigned int startSlot, unsigned int samplerCount, void* const* samplers)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetSamplers, samplers ? samplers[0] : nullptr, startSlot, samplerCount);
+	}
+
+	void RHI_Device::Set_RenderTargets(unsigned int renderTargetCount, void* const* renderTargets, void* depthStencil)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetRenderTargets, renderTargets ? renderTargets[0] : nullptr, renderTargetCount, depthStencil ? 1 : 0);
+	}
+
+	void RHI_Device::Set_Textures(unsigned int startSlot, unsigned int resourceCount, void* const* shaderResources)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetTextures, shaderResources ? shaderResources[0] : nullptr, startSlot, resourceCount);
+	}
+
+	bool RHI_Device::Set_Resolution(unsigned int width, unsigned int height)
+	{
+		if (width == 0 || height == 0)
+		{
+			LOGF_ERROR("RHI_Device::SetResolution: Resolution %dx%d is invalid", width, height);
+			return false;
+		}
+
+		return true;
+	}
+
+	void RHI_Device::Set_Viewport(const RHI_Viewport& viewport)
+	{
+		m_viewport = viewport;
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetViewport, nullptr, (unsigned int)viewport.GetWidth(), (unsigned int)viewport.GetHeight());
+	}
+
+	bool RHI_Device::Set_DepthEnabled(bool enable)
+	{
+		if (m_depthEnabled == enable)
+			return true;
+
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetDepthEnabled, nullptr, enable);
+		m_depthEnabled = enable;
+
+		return true;
+	}
+
+	bool RHI_Device::Set_AlphaBlendingEnabled(bool enable)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetAlphaBlendingEnabled, nullptr, enable);
+		m_alphaBlendingEnabled = enable;
+
+		return true;
+	}
+
+	void RHI_Device::EventBegin(const std::string& name)
+	{
+		auto commandList = GetDeviceContext<Null_CommandList>();
+		commandList->Record(Null_Command_EventBegin, nullptr, commandList->GetEventIndex(name));
+	}
+
+	void RHI_Device::EventEnd()
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_EventEnd);
+	}
+
+	bool RHI_Device::Profiling_CreateQuery(void** query, Query_Type type)
+	{
+		*query = &_Null_Device::query;
+		return true;
+	}
+
+	void RHI_Device::Profiling_QueryStart(void* queryObject)
+	{
+
+	}
+
+	void RHI_Device::Profiling_QueryEnd(void* queryObject)
+	{
+
+	}
+
+	void RHI_Device::Profiling_GetTimeStamp(void* queryObject)
+	{
+
+	}
+
+	float RHI_Device::Profiling_GetDuration(void* queryDisjoint, void* queryStart, void* queryEnd)
+	{
+		// Nothing executes, so there is no GPU time to report
+		return 0.0f;
+	}
+
+	bool RHI_Device::Set_PrimitiveTopology(PrimitiveTopology_Mode primitiveTopology)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetPrimitiveTopology, nullptr, primitiveTopology);
+		return true;
+	}
+
+	bool RHI_Device::Set_FillMode(Fill_Mode fillMode)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetFillMode, nullptr, fillMode);
+		return true;
+	}
+
+	bool RHI_Device::Set_InputLayout(void* inputLayout)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetInputLayout, inputLayout);
+		return true;
+	}
+
+	bool RHI_Device::Set_CullMode(Cull_Mode cullMode)
+	{
+		GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetCullMode, nullptr, cullMode);
+		return true;
+	}
+}
+#endif
@@ -0,0 +1,141 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifdef API_NULL
+//================================
+
+//= INCLUDES =====================
+#include "Null_Common.h"
+#include "../RHI_Device.h"
+#include "../RHI_IndexBuffer.h"
+#include "../../Logging/Log.h"
+#include <cstring>
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	RHI_IndexBuffer::RHI_IndexBuffer(std::shared_ptr<RHI_Device> rhiDevice)
+	{
+		m_rhiDevice		= rhiDevice;
+		m_buffer		= nullptr;
+		m_memoryUsage	= 0;
+	}
+
+	RHI_IndexBuffer::~RHI_IndexBuffer()
+	{
+		delete (Null_Resource*)m_buffer;
+		m_buffer = nullptr;
+	}
+
+	bool RHI_IndexBuffer::Create(const vector<unsigned int>& indices)
+	{
+		if (!m_rhiDevice || !m_rhiDevice->GetDevice<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_IndexBuffer::Create: Invalid RHI device");
+			return false;
+		}
+
+		if (indices.empty())
+		{
+			LOG_ERROR("RHI_IndexBuffer::Create: Invalid parameter");
+			return false;
+		}
+
+		delete (Null_Resource*)m_buffer;
+
+		m_memoryUsage	= (unsigned int)(sizeof(unsigned int) * indices.size());
+		auto resource	= new Null_Resource(m_memoryUsage, sizeof(unsigned int));
+		memcpy(resource->data.data(), indices.data(), m_memoryUsage);
+		m_buffer		= resource;
+
+		m_rhiDevice->GetDevice<Null_CommandList>()->AddUpload(m_memoryUsage);
+		return true;
+	}
+
+	bool RHI_IndexBuffer::CreateDynamic(unsigned int initialSize)
+	{
+		if (!m_rhiDevice || !m_rhiDevice->GetDevice<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_IndexBuffer::CreateDynamic: Invalid RHI device");
+			return false;
+		}
+
+		delete (Null_Resource*)m_buffer;
+		m_buffer = new Null_Resource(sizeof(unsigned int) * initialSize, sizeof(unsigned int));
+
+		return true;
+	}
+
+	void* RHI_IndexBuffer::Map()
+	{
+		if (!m_buffer)
+		{
+			LOG_ERROR("RHI_IndexBuffer::Map: Invalid buffer");
+			return nullptr;
+		}
+
+		return ((Null_Resource*)m_buffer)->data.data();
+	}
+
+	bool RHI_IndexBuffer::Unmap()
+	{
+		if (!m_rhiDevice || !m_rhiDevice->GetDeviceContext<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_IndexBuffer::Unmap: Invalid RHI device");
+			return false;
+		}
+
+		if (!m_buffer)
+		{
+			LOG_ERROR("RHI_IndexBuffer::Unmap: Invalid buffer");
+			return false;
+		}
+
+		m_rhiDevice->GetDeviceContext<Null_CommandList>()->RecordUpdate(m_buffer, (unsigned int)((Null_Resource*)m_buffer)->data.size(), false);
+		return true;
+	}
+
+	bool RHI_IndexBuffer::Bind()
+	{
+		if (!m_rhiDevice || !m_rhiDevice->GetDeviceContext<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_IndexBuffer::Bind: Invalid RHI device");
+			return false;
+		}
+
+		if (!m_buffer)
+		{
+			LOG_ERROR("RHI_IndexBuffer::Bind: Invalid buffer");
+			return false;
+		}
+
+		m_rhiDevice->GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetIndexBuffer, m_buffer);
+		return true;
+	}
+}
+#endif
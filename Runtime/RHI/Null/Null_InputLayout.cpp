@@ -0,0 +1,69 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifdef API_NULL
+//================================
+
+//= INCLUDES =====================
+#include "Null_Common.h"
+#include "../RHI_InputLayout.h"
+#include "../RHI_Device.h"
+#include "../../Logging/Log.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	RHI_InputLayout::RHI_InputLayout(shared_ptr<RHI_Device> rhiDevice)
+	{
+		m_rhiDevice		= rhiDevice;
+		m_buffer		= nullptr;
+		m_inputLayout	= Input_PositionTextureTBN;
+	}
+
+	RHI_InputLayout::~RHI_InputLayout()
+	{
+		delete (Null_Resource*)m_buffer;
+		m_buffer = nullptr;
+	}
+
+	bool RHI_InputLayout::Create(void* vsBlob, Input_Layout layout)
+	{
+		if (!vsBlob || layout == Input_NotAssigned)
+		{
+			LOG_ERROR("RHI_InputLayout::Create: Invalid parameters");
+			return false;
+		}
+
+		delete (Null_Resource*)m_buffer;
+		m_inputLayout	= layout;
+		m_buffer		= new Null_Resource();
+
+		return true;
+	}
+}
+#endif
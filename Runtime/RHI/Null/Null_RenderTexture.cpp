@@ -0,0 +1,132 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifdef API_NULL
+//================================
+
+//= INCLUDES ========================
+#include "Null_Common.h"
+#include "../RHI_RenderTexture.h"
+#include "../RHI_Device.h"
+#include "../../Logging/Log.h"
+//===================================
+
+//= NAMESPACES ================
+using namespace Directus::Math;
+using namespace std;
+//=============================
+
+namespace Directus
+{
+	RHI_RenderTexture::RHI_RenderTexture(shared_ptr<RHI_Device> rhiDevice, int width, int height, Texture_Format textureFormat, bool depth, Texture_Format depthFormat)
+	{
+		m_renderTargetTexture	= nullptr;
+		m_renderTargetView		= nullptr;
+		m_shaderResourceView	= nullptr;
+		m_depthStencilBuffer	= nullptr;
+		m_depthStencilView		= nullptr;
+		m_rhiDevice				= rhiDevice;
+		m_depthEnabled			= depth;
+		m_nearPlane				= 0.0f;
+		m_farPlane				= 0.0f;
+		m_format				= textureFormat;
+		m_viewport				= RHI_Viewport((float)width, (float)height, m_rhiDevice->Get_Viewport().GetMaxDepth());
+		m_width					= width;
+		m_height				= height;
+
+		if (!m_rhiDevice || !m_rhiDevice->GetDevice<Null_CommandList>())
+		{
+			LOG_ERROR("Null_RenderTexture::RHI_RenderTexture: Invalid device.");
+			return;
+		}
+
+		// Nothing is ever rasterized, so the views are distinct handles without any pixel storage
+		m_renderTargetTexture	= new Null_Resource();
+		m_renderTargetView		= new Null_Resource();
+		m_shaderResourceView	= new Null_Resource();
+		if (m_depthEnabled)
+		{
+			m_depthStencilBuffer	= new Null_Resource();
+			m_depthStencilView		= new Null_Resource();
+		}
+	}
+
+	RHI_RenderTexture::~RHI_RenderTexture()
+	{
+		delete (Null_Resource*)m_renderTargetTexture;
+		delete (Null_Resource*)m_renderTargetView;
+		delete (Null_Resource*)m_shaderResourceView;
+		delete (Null_Resource*)m_depthStencilBuffer;
+		delete (Null_Resource*)m_depthStencilView;
+	}
+
+	bool RHI_RenderTexture::Clear(const Vector4& clearColor)
+	{
+		if (!m_rhiDevice)
+			return false;
+
+		// Clear back buffer
+		m_rhiDevice->ClearRenderTarget(m_renderTargetView, clearColor); 
+
+		// Clear depth buffer.
+		if (m_depthEnabled)
+		{
+			float maxDepth = m_rhiDevice->Get_Viewport().GetMaxDepth();
+			m_rhiDevice->ClearDepthStencil(m_depthStencilView, Clear_Depth, maxDepth, 0); 
+		}
+
+		return true;
+	}
+
+	bool RHI_RenderTexture::Clear(float red, float green, float blue, float alpha)
+	{
+		return Clear(Vector4(red, green, blue, alpha));
+	}
+
+	void RHI_RenderTexture::ComputeOrthographicProjectionMatrix(float nearPlane, float farPlane)
+	{
+		if (m_nearPlane == nearPlane && m_farPlane == farPlane)
+			return;
+
+		m_nearPlane						= nearPlane;
+		m_farPlane						= farPlane;
+		m_orthographicProjectionMatrix	= Matrix::CreateOrthographicLH(m_viewport.GetWidth(), m_viewport.GetHeight(), nearPlane, farPlane);
+	}
+
+	void* RHI_RenderTexture::GetRenderTargetView()
+	{
+		return m_renderTargetView;
+	}
+
+	void* RHI_RenderTexture::GetShaderResource()
+	{
+		return m_shaderResourceView;
+	}
+
+	void* RHI_RenderTexture::GetDepthStencilView()
+	{
+		return m_depthStencilView;
+	}
+}
+#endif
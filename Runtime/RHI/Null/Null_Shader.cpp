@@ -0,0 +1,120 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifdef API_NULL
+//================================
+
+//= INCLUDES ===========================
+#include "Null_Common.h"
+#include "../RHI_Device.h"
+#include "../RHI_Shader.h"
+#include "../RHI_ShaderCache.h"
+#include "../RHI_InputLayout.h"
+#include "../../Logging/Log.h"
+#include "../../FileSystem/FileSystem.h"
+//======================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace Null_Shader
+	{
+		// There is no compiler, the cache still sees the same lookups (and stores) a real backend would make
+		inline void Compile(RHI_ShaderCache* cache, const string& filePath, map<string, string> macros, bool vertex, const char* entryPoint, const char* shaderModel)
+		{
+			if (!cache)
+				return;
+
+			macros["COMPILE_VS"] = vertex ? "1" : "0";
+			macros["COMPILE_PS"] = vertex ? "0" : "1";
+
+			uint64_t key = cache->ComputeKey(filePath, macros, entryPoint, shaderModel, 0, 0);
+			if (!cache->Load(key))
+			{
+				cache->Store(key, &key, sizeof(key));
+			}
+		}
+	}
+
+	RHI_Shader::RHI_Shader(shared_ptr<RHI_Device> rhiDevice)
+	{
+		m_rhiDevice			= rhiDevice;
+		m_inputLayout		= make_shared<RHI_InputLayout>(m_rhiDevice);
+	}
+
+	RHI_Shader::~RHI_Shader()
+	{
+		delete (Null_Resource*)m_vertexShader;
+		delete (Null_Resource*)m_pixelShader;
+	}
+
+	bool RHI_Shader::Compile_Vertex(const string& filePath, Input_Layout inputLayout)
+	{
+		m_filePath = filePath;
+
+		// There is no compiler, but a missing source file should still fail like it would on a real backend
+		if (!FileSystem::FileExists(m_filePath))
+		{
+			LOGF_ERROR("Null_Shader::Compile_Vertex: Shader \"%s\" doesn't exist", m_filePath.c_str());
+			m_hasVertexShader = false;
+			return false;
+		}
+
+		Null_Shader::Compile(m_rhiDevice->GetShaderCache(), m_filePath, m_macros, true, VERTEX_SHADER_ENTRYPOINT, VERTEX_SHADER_MODEL);
+		delete (Null_Resource*)m_vertexShader;
+		m_vertexShader = new Null_Resource();
+
+		// Create input layout
+		if (!m_inputLayout->Create(m_vertexShader, inputLayout))
+		{
+			LOGF_ERROR("Null_Shader::Compile_Vertex: Failed to create vertex input layout for %s", FileSystem::GetFileNameFromFilePath(m_filePath).data());
+		}
+
+		m_hasVertexShader = true;
+		return m_hasVertexShader;
+	}
+
+	bool RHI_Shader::Compile_Pixel(const string& filePath)
+	{
+		m_filePath = filePath;
+
+		if (!FileSystem::FileExists(m_filePath))
+		{
+			LOGF_ERROR("Null_Shader::Compile_Pixel: Shader \"%s\" doesn't exist", m_filePath.c_str());
+			m_hasPixelShader = false;
+			return false;
+		}
+
+		Null_Shader::Compile(m_rhiDevice->GetShaderCache(), m_filePath, m_macros, false, PIXEL_SHADER_ENTRYPOINT, PIXEL_SHADER_MODEL);
+		delete (Null_Resource*)m_pixelShader;
+		m_pixelShader		= new Null_Resource();
+		m_hasPixelShader	= true;
+
+		return m_hasPixelShader;
+	}
+}
+#endif
@@ -0,0 +1,127 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifdef API_NULL
+//================================
+
+//= INCLUDES =====================
+#include "Null_Common.h"
+#include "../RHI_Device.h"
+#include "../RHI_Texture.h"
+#include "../../Logging/Log.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	bool RHI_Texture::ShaderResource_Create2D(unsigned int width, unsigned int height, unsigned int channels, Texture_Format format, const vector<vector<std::byte>>& data, bool generateMimaps /*= false*/)
+	{
+		if (!m_rhiDevice->GetDevice<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_Texture::ShaderResource_Create: Invalid device.");
+			return false;
+		}
+
+		if (data.empty())
+		{
+			LOG_ERROR("RHI_Texture::ShaderResource_Create2D: Invalid data.");
+			return false;
+		}
+
+		// Mips are laid out back to back, only the top one is uploaded when they are to be generated
+		auto resource = new Null_Resource();
+		for (unsigned int i = 0; i < (generateMimaps ? 1 : (unsigned int)data.size()); i++)
+		{
+			if (data[i].empty())
+			{
+				LOGF_ERROR("RHI_Texture::ShaderResource_Create2D: Mip level %d has invalid data.", i);
+				continue;
+			}
+
+			resource->data.insert(resource->data.end(), data[i].begin(), data[i].end());
+
+			// Compute memory usage (rough estimation)
+			m_memoryUsage += (unsigned int)(sizeof(std::byte) * data[i].size());
+		}
+		m_rhiDevice->GetDevice<Null_CommandList>()->AddUpload((unsigned int)resource->data.size());
+
+		ShaderResource_Release();
+		m_shaderResource = resource;
+		return true;
+	}
+
+	bool RHI_Texture::ShaderResource_CreateCubemap(unsigned int width, unsigned int height, unsigned int channels, Texture_Format format, const vector<vector<vector<std::byte>>>& data)
+	{
+		if (!m_rhiDevice->GetDevice<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_Texture::ShaderResource_CreateCubemap: Invalid device.");
+			return false;
+		}
+
+		if (data.empty())
+		{
+			LOG_ERROR("RHI_Texture::ShaderResource_CreateCubemap: Invalid data.");
+			return false;
+		}
+
+		auto resource = new Null_Resource();
+		for (const auto& side : data)
+		{
+			if (side.empty())
+			{
+				LOG_ERROR("RHI_Texture::ShaderResource_CreateCubemap: A side containts invalid data.");
+				continue;
+			}
+
+			for (const auto& mip : side)
+			{
+				if (mip.empty())
+				{
+					LOG_ERROR("RHI_Texture::ShaderResource_CreateCubemap: A mip-map containts invalid data.");
+					continue;
+				}
+
+				resource->data.insert(resource->data.end(), mip.begin(), mip.end());
+
+				// Compute memory usage (rough estimation)
+				m_memoryUsage += (unsigned int)(sizeof(std::byte) * mip.size());
+			}
+		}
+		m_rhiDevice->GetDevice<Null_CommandList>()->AddUpload((unsigned int)resource->data.size());
+
+		ShaderResource_Release();
+		m_shaderResource = resource;
+		return true;
+	}
+
+	void RHI_Texture::ShaderResource_Release()
+	{
+		delete (Null_Resource*)m_shaderResource;
+		m_shaderResource = nullptr;
+	}
+}
+#endif
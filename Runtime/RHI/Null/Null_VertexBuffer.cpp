@@ -0,0 +1,164 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifdef API_NULL
+//================================
+
+//= INCLUDES =====================
+#include "Null_Common.h"
+#include "../RHI_Device.h"
+#include "../RHI_VertexBuffer.h"
+#include "../RHI_Vertex.h"
+#include "../../Logging/Log.h"
+#include <cstring>
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace Null_VertexBuffer
+	{
+		template <typename T>
+		inline bool Create(const shared_ptr<RHI_Device>& rhiDevice, const vector<T>& vertices, void** buffer, unsigned int* stride, unsigned int* memoryUsage)
+		{
+			if (!rhiDevice || !rhiDevice->GetDevice<Null_CommandList>())
+			{
+				LOG_ERROR("RHI_VertexBuffer::Create: Invalid RHI device");
+				return false;
+			}
+
+			if (vertices.empty())
+			{
+				LOG_ERROR("RHI_VertexBuffer::Create: Invalid parameter");
+				return false;
+			}
+
+			delete (Null_Resource*)*buffer;
+
+			*stride			= sizeof(T);
+			*memoryUsage	= (unsigned int)(sizeof(T) * vertices.size());
+			auto resource	= new Null_Resource(*memoryUsage, *stride);
+			memcpy(resource->data.data(), vertices.data(), *memoryUsage);
+			*buffer			= resource;
+
+			rhiDevice->GetDevice<Null_CommandList>()->AddUpload(*memoryUsage);
+			return true;
+		}
+	}
+
+	RHI_VertexBuffer::RHI_VertexBuffer(std::shared_ptr<RHI_Device> rhiDevice)
+	{
+		m_rhiDevice		= rhiDevice;
+		m_buffer		= nullptr;
+		m_stride		= 0;
+		m_memoryUsage	= 0;
+	}
+
+	RHI_VertexBuffer::~RHI_VertexBuffer()
+	{
+		delete (Null_Resource*)m_buffer;
+		m_buffer = nullptr;
+	}
+
+	bool RHI_VertexBuffer::Create(const vector<RHI_Vertex_PosCol>& vertices)
+	{
+		return Null_VertexBuffer::Create(m_rhiDevice, vertices, &m_buffer, &m_stride, &m_memoryUsage);
+	}
+
+	bool RHI_VertexBuffer::Create(const vector<RHI_Vertex_PosUV>& vertices)
+	{
+		return Null_VertexBuffer::Create(m_rhiDevice, vertices, &m_buffer, &m_stride, &m_memoryUsage);
+	}
+
+	bool RHI_VertexBuffer::Create(const vector<RHI_Vertex_PosUVTBN>& vertices)
+	{
+		return Null_VertexBuffer::Create(m_rhiDevice, vertices, &m_buffer, &m_stride, &m_memoryUsage);
+	}
+
+	bool RHI_VertexBuffer::CreateDynamic(unsigned int stride, unsigned int initialSize)
+	{
+		if (!m_rhiDevice || !m_rhiDevice->GetDevice<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_VertexBuffer::CreateDynamic: Invalid RHI device");
+			return false;
+		}
+
+		delete (Null_Resource*)m_buffer;
+		m_stride	= stride;
+		m_buffer	= new Null_Resource(m_stride * initialSize, m_stride);
+
+		return true;
+	}
+
+	void* RHI_VertexBuffer::Map()
+	{
+		if (!m_buffer)
+		{
+			LOG_ERROR("RHI_VertexBuffer::Map: Invalid buffer");
+			return nullptr;
+		}
+
+		return ((Null_Resource*)m_buffer)->data.data();
+	}
+
+	bool RHI_VertexBuffer::Unmap()
+	{
+		if (!m_rhiDevice || !m_rhiDevice->GetDeviceContext<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_VertexBuffer::Unmap: Invalid RHI device");
+			return false;
+		}
+
+		if (!m_buffer)
+		{
+			LOG_ERROR("RHI_VertexBuffer::Unmap: Invalid buffer");
+			return false;
+		}
+
+		m_rhiDevice->GetDeviceContext<Null_CommandList>()->RecordUpdate(m_buffer, (unsigned int)((Null_Resource*)m_buffer)->data.size(), false);
+		return true;
+	}
+
+	bool RHI_VertexBuffer::Bind()
+	{
+		if (!m_rhiDevice || !m_rhiDevice->GetDeviceContext<Null_CommandList>())
+		{
+			LOG_ERROR("RHI_VertexBuffer::Bind: Invalid RHI device");
+			return false;
+		}
+
+		if (!m_buffer)
+		{
+			LOG_ERROR("RHI_VertexBuffer::Bind: Invalid buffer");
+			return false;
+		}
+
+		m_rhiDevice->GetDeviceContext<Null_CommandList>()->Record(Null_Command_SetVertexBuffer, m_buffer, m_stride);
+		return true;
+	}
+}
+#endif
@@ -25,7 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RHI_Object.h"
 #include "RHI_Definition.h"
 #include <memory>
-#include "..\Core\EngineDefs.h"
+#include "../Core/EngineDefs.h"
 //=============================
 
 namespace Directus
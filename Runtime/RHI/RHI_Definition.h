@@ -147,6 +147,12 @@ namespace Directus
 		Texture_Format_R32G32B32_FLOAT,
 		Texture_Format_R16G16B16A16_FLOAT,
 		Texture_Format_R32G32B32A32_FLOAT,
-		Texture_Format_D32_FLOAT
+		Texture_Format_D32_FLOAT,
+		// Block compressed, 4x4 texels per block
+		Texture_Format_BC1_UNORM,	// RGB, 8 bytes per block
+		Texture_Format_BC3_UNORM,	// RGBA, 16 bytes per block
+		Texture_Format_BC4_UNORM,	// R, 8 bytes per block
+		Texture_Format_BC5_UNORM,	// RG, 16 bytes per block
+		Texture_Format_BC7_UNORM	// RGBA, 16 bytes per block
 	};
 }
\ No newline at end of file
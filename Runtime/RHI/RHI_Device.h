@@ -22,12 +22,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ==============
+#include <memory>
 #include "RHI_Definition.h"
 #include "RHI_Viewport.h"
 //=========================
 
 namespace Directus
 {
+	class RHI_ShaderCache;
+
 	class ENGINE_CLASS RHI_Device
 	{
 	public:
@@ -84,6 +87,12 @@ namespace Directus
 		float Profiling_GetDuration(void* queryDisjoint, void* queryStart, void* queryEnd);
 		//=================================================================================
 
+		//= SHADER CACHE ===========================================================================
+		// Shaders look compiled binaries up in it (and store new ones), nullptr compiles everything
+		void SetShaderCache(const std::shared_ptr<RHI_ShaderCache>& cache)	{ m_shaderCache = cache; }
+		RHI_ShaderCache* GetShaderCache()									{ return m_shaderCache.get(); }
+		//=========================================================================================
+
 		bool IsInitialized()	{ return m_initialized; }
 
 		template <typename T>
@@ -99,5 +108,6 @@ namespace Directus
 		bool m_initialized		= false;
 		void* m_device			= nullptr;
 		void* m_deviceContext	= nullptr;
+		std::shared_ptr<RHI_ShaderCache> m_shaderCache;
 	};
 }
\ No newline at end of file
@@ -27,7 +27,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #ifdef COMPILING_LIB // Only compile this for the engine
 
-//#ifdef API_D3D11 // Deactivate this for now as Vulkan is not ready
+// D3D11 stays active for Vulkan as well (for now), as Vulkan is not ready
+#ifndef API_NULL
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
@@ -63,7 +64,12 @@ static const DXGI_FORMAT d3d11_dxgi_format[]
 	DXGI_FORMAT_R32G32B32_FLOAT,
 	DXGI_FORMAT_R16G16B16A16_FLOAT,
 	DXGI_FORMAT_R32G32B32A32_FLOAT,
-	DXGI_FORMAT_D32_FLOAT
+	DXGI_FORMAT_D32_FLOAT,
+	DXGI_FORMAT_BC1_UNORM,
+	DXGI_FORMAT_BC3_UNORM,
+	DXGI_FORMAT_BC4_UNORM,
+	DXGI_FORMAT_BC5_UNORM,
+	DXGI_FORMAT_BC7_UNORM
 };
 
 static const D3D11_TEXTURE_ADDRESS_MODE d3d11_texture_address_mode[]
@@ -94,7 +100,7 @@ static const D3D11_FILTER d3d11_filter[] =
 	D3D11_FILTER_MIN_MAG_MIP_LINEAR,
 	D3D11_FILTER_ANISOTROPIC
 };
-//#endif
+#endif
 
 #ifdef API_VULKAN
 #pragma comment(lib, "vulkan-1.lib")
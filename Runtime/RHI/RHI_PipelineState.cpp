@@ -31,7 +31,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RHI_Shader.h"
 #include "RHI_ConstantBuffer.h"
 #include "RHI_InputLayout.h"
-#include "..\Logging\Log.h"
+#include "../Logging/Log.h"
 #include "../Profiling/Profiler.h"
 //================================
 
@@ -64,13 +64,13 @@ namespace Directus
 		m_viewportDirty			= false;
 	}
 
-	void RHI_PipelineState::SetShader(shared_ptr<RHI_Shader>& shader)
+	void RHI_PipelineState::SetShader(const shared_ptr<RHI_Shader>& shader)
 	{
 		SetVertexShader(shader);
 		SetPixelShader(shader);	
 	}
 
-	bool RHI_PipelineState::SetVertexShader(shared_ptr<RHI_Shader>& shader)
+	bool RHI_PipelineState::SetVertexShader(const shared_ptr<RHI_Shader>& shader)
 	{
 		if (!shader)
 		{
@@ -89,7 +89,7 @@ namespace Directus
 		return true;
 	}
 
-	bool RHI_PipelineState::SetPixelShader(shared_ptr<RHI_Shader>& shader)
+	bool RHI_PipelineState::SetPixelShader(const shared_ptr<RHI_Shader>& shader)
 	{
 		if (!shader)
 		{
@@ -24,7 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ==================
 #include <memory>
 #include <vector>
-#include "..\Core\EngineDefs.h"
+#include "../Core/EngineDefs.h"
 #include "RHI_Definition.h"
 #include "RHI_Viewport.h"
 //=============================
@@ -52,9 +52,9 @@ namespace Directus
 		~RHI_PipelineState(){}
 
 		// Shader
-		void SetShader(std::shared_ptr<RHI_Shader>& shader);
-		bool SetVertexShader(std::shared_ptr<RHI_Shader>& shader);
-		bool SetPixelShader(std::shared_ptr<RHI_Shader>& shader);
+		void SetShader(const std::shared_ptr<RHI_Shader>& shader);
+		bool SetVertexShader(const std::shared_ptr<RHI_Shader>& shader);
+		bool SetPixelShader(const std::shared_ptr<RHI_Shader>& shader);
 
 		// Texture
 		bool SetTexture(const std::shared_ptr<RHI_RenderTexture>& texture);
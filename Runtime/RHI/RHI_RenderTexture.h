@@ -22,10 +22,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ==============
+#include <memory>
 #include "RHI_Definition.h"
 #include "RHI_Viewport.h"
 #include "RHI_Object.h"
-#include "..\Math\Matrix.h"
+#include "../Math/Matrix.h"
 //=========================
 
 namespace Directus
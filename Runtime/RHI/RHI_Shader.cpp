@@ -21,8 +21,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include "RHI_Shader.h"
+#include <cstring>
 #include "RHI_ConstantBuffer.h"
-#include "..\Logging\Log.h"
+#include "../Logging/Log.h"
 //=============================
 
 //= NAMESPACES =====
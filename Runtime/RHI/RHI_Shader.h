@@ -27,10 +27,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <map>
 #include "RHI_Definition.h"
 #include "RHI_Object.h"
-#include "..\Core\EngineDefs.h"
-#include "..\Core\Context.h"
-#include "..\Threading\Threading.h"
-#include "..\Logging\Log.h"
+#include "../Core/EngineDefs.h"
+#include "../Core/Context.h"
+#include "../Threading/Threading.h"
+#include "../Logging/Log.h"
 //=================================
 
 namespace Directus
@@ -0,0 +1,368 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "RHI_ShaderCache.h"
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include "../Core/Hash.h"
+#include "../IO/FileStream.h"
+#include "../IO/MappedFile.h"
+#include "../FileSystem/FileSystem.h"
+#include "../Logging/Log.h"
+//===================================
+
+//= NAMESPACES ==================
+using namespace std;
+using namespace std::filesystem;
+//===============================
+
+namespace Directus
+{
+	namespace _RHI_ShaderCache
+	{
+		// Bump whenever the file layout or the way keys are computed changes
+		static const unsigned int version = 2;
+
+		static const char* sectionIndex		= "index";
+		static const char* sectionBinaries	= "binaries";
+		static const char* extensionWriting	= ".writing";
+
+		// Returns the file names of #include directives (quoted or angled)
+		inline vector<string> GetIncludes(const char* source, size_t size)
+		{
+			vector<string> includes;
+			const char* end = source + size;
+			for (const char* line = source; line < end;)
+			{
+				const char* lineEnd = find(line, end, '\n');
+
+				const char* c = line;
+				while (c < lineEnd && (*c == ' ' || *c == '\t')) c++;
+				if (c < lineEnd && *c == '#')
+				{
+					c++;
+					while (c < lineEnd && (*c == ' ' || *c == '\t')) c++;
+					if (lineEnd - c > 7 && strncmp(c, "include", 7) == 0)
+					{
+						const char* open = find_if(c + 7, lineEnd, [](char x) { return x == '"' || x == '<'; });
+						if (open != lineEnd)
+						{
+							const char* close = find(open + 1, lineEnd, *open == '"' ? '"' : '>');
+							if (close != lineEnd)
+							{
+								includes.emplace_back(open + 1, close);
+							}
+						}
+					}
+				}
+
+				line = lineEnd + 1;
+			}
+			return includes;
+		}
+	}
+
+	RHI_ShaderCache::RHI_ShaderCache(const string& filePath, uint64_t budget)
+	{
+		m_filePath		= filePath;
+		m_stats.budget	= budget;
+
+		if (!FileSystem::FileExists(m_filePath))
+			return;
+
+		auto file = make_unique<FileStream>(m_filePath, FileStreamMode_Read);
+		if (!file->IsOpen() || !file->Section_Seek(_RHI_ShaderCache::sectionIndex) || file->ReadUInt() != _RHI_ShaderCache::version)
+		{
+			LOG_WARNING("RHI_ShaderCache::RHI_ShaderCache: The cache is outdated or damaged, shaders will be recompiled.");
+			m_dirty = true;
+			return;
+		}
+
+		// The index lists the binaries in the order they follow it
+		m_session			= file->ReadUInt() + 1;
+		unsigned int count	= file->ReadUInt();
+		vector<pair<uint64_t, unsigned int>> index(count);
+		for (auto& entry : index)
+		{
+			uint64_t low	= file->ReadUInt();
+			uint64_t high	= file->ReadUInt();
+			entry.first		= low | (high << 32);
+			entry.second	= file->ReadUInt();
+		}
+
+		if (!file->Section_Seek(_RHI_ShaderCache::sectionBinaries))
+			return;
+
+		for (const auto& entry : index)
+		{
+			auto binary = make_shared<vector<std::byte>>();
+			file->Read(binary.get());
+			if (binary->empty())
+				continue;
+
+			m_stats.size				+= binary->size();
+			m_entries[entry.first]		= Entry{ binary, entry.second };
+		}
+	}
+
+	RHI_ShaderCache::~RHI_ShaderCache()
+	{
+		Save();
+	}
+
+	uint64_t RHI_ShaderCache::ComputeKey(const string& filePath, const map<string, string>& defines, const string& entryPoint, const string& profile, unsigned int flags, unsigned int compilerVersion)
+	{
+		uint64_t source = GetSourceHash(filePath);
+		if (source == 0)
+			return 0;
+
+		// Strings are hashed with their terminator, so that adjacent ones can't run into each other
+		Hash hash(_RHI_ShaderCache::version);
+		hash.Update(&source, sizeof(source));
+		for (const auto& define : defines)
+		{
+			hash.Update(define.first.c_str(), define.first.size() + 1);
+			hash.Update(define.second.c_str(), define.second.size() + 1);
+		}
+		hash.Update(entryPoint.c_str(), entryPoint.size() + 1);
+		hash.Update(profile.c_str(), profile.size() + 1);
+		hash.Update(&flags, sizeof(flags));
+		hash.Update(&compilerVersion, sizeof(compilerVersion));
+
+		// 0 is reserved for "no key"
+		uint64_t key = hash.Digest();
+		return key != 0 ? key : 1;
+	}
+
+	shared_ptr<const vector<std::byte>> RHI_ShaderCache::Load(uint64_t key)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		auto entry = key != 0 ? m_entries.find(key) : m_entries.end();
+		if (entry == m_entries.end())
+		{
+			m_stats.misses++;
+			return nullptr;
+		}
+
+		entry->second.session = m_session;
+		m_stats.hits++;
+		return entry->second.binary;
+	}
+
+	void RHI_ShaderCache::Store(uint64_t key, const void* binary, size_t size)
+	{
+		if (key == 0 || !binary || size == 0)
+			return;
+
+		auto data = make_shared<vector<std::byte>>(static_cast<const std::byte*>(binary), static_cast<const std::byte*>(binary) + size);
+
+		lock_guard<mutex> guard(m_mutex);
+		auto& entry		= m_entries[key];
+		m_stats.size	-= entry.binary ? entry.binary->size() : 0;
+		entry.binary	= data;
+		entry.session	= m_session;
+		m_stats.size	+= size;
+		m_stats.stores++;
+		m_lastStore		= chrono::steady_clock::now();
+		m_dirty			= true;
+	}
+
+	void RHI_ShaderCache::Remove(uint64_t key)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		auto entry = m_entries.find(key);
+		if (entry == m_entries.end())
+			return;
+
+		m_stats.size -= entry->second.binary->size();
+		m_entries.erase(entry);
+		m_stats.evictions++;
+		m_dirty = true;
+	}
+
+	bool RHI_ShaderCache::Save()
+	{
+		lock_guard<mutex> guard(m_mutex);
+		Collect();
+		if (!m_dirty)
+			return true;
+
+		// Written under another name and then renamed, so that a session that ends while writing doesn't leave a damaged cache behind
+		string path = m_filePath + _RHI_ShaderCache::extensionWriting;
+		bool written = false;
+		{
+			auto file = make_unique<FileStream>(path, FileStreamMode_Write);
+			if (file->IsOpen())
+			{
+				file->Section_Begin(_RHI_ShaderCache::sectionIndex);
+				file->Write(_RHI_ShaderCache::version);
+				file->Write(m_session);
+				file->Write((unsigned int)m_entries.size());
+				for (const auto& entry : m_entries)
+				{
+					file->Write((unsigned int)(entry.first & 0xFFFFFFFF));
+					file->Write((unsigned int)(entry.first >> 32));
+					file->Write(entry.second.session);
+				}
+
+				file->Section_Begin(_RHI_ShaderCache::sectionBinaries);
+				for (const auto& entry : m_entries)
+				{
+					file->Write(*entry.second.binary);
+				}
+				written = true;
+			}
+		}
+
+		error_code error;
+		if (written)
+		{
+			rename(path, m_filePath, error);
+		}
+
+		if (!written || error)
+		{
+			remove(path, error);
+			LOGF_WARNING("RHI_ShaderCache::Save: Failed to write \"%s\"", m_filePath.c_str());
+			return false;
+		}
+
+		m_dirty = false;
+		return true;
+	}
+
+	bool RHI_ShaderCache::Save_Idle(double seconds)
+	{
+		{
+			lock_guard<mutex> guard(m_mutex);
+			auto now = chrono::steady_clock::now();
+			if (!m_dirty || chrono::duration<double>(now - m_lastStore).count() < seconds)
+				return true;
+
+			// A save that fails is retried after the same time, not every frame
+			m_lastStore = now;
+		}
+
+		return Save();
+	}
+
+	void RHI_ShaderCache::SetBudget(uint64_t budget)
+	{
+		lock_guard<mutex> guard(m_mutex);
+		m_stats.budget = budget;
+		Collect();
+	}
+
+	RHI_ShaderCacheStats RHI_ShaderCache::GetStats()
+	{
+		lock_guard<mutex> guard(m_mutex);
+		RHI_ShaderCacheStats stats	= m_stats;
+		stats.entryCount			= (unsigned int)m_entries.size();
+		return stats;
+	}
+
+	void RHI_ShaderCache::Clear()
+	{
+		lock_guard<mutex> guard(m_mutex);
+		m_entries.clear();
+		m_sourceHashes.clear();
+		m_stats.size	= 0;
+		m_dirty			= false;
+
+		error_code error;
+		remove(m_filePath, error);
+	}
+
+	uint64_t RHI_ShaderCache::GetSourceHash(const string& filePath)
+	{
+		{
+			lock_guard<mutex> guard(m_mutex);
+			auto it = m_sourceHashes.find(filePath);
+			if (it != m_sourceHashes.end())
+				return it->second;
+		}
+
+		if (!FileSystem::FileExists(filePath))
+			return 0;
+
+		Hash hash;
+		set<string> visited;
+		HashSource(filePath, visited, &hash);
+		uint64_t digest = hash.Digest();
+
+		lock_guard<mutex> guard(m_mutex);
+		m_sourceHashes[filePath] = digest;
+		return digest;
+	}
+
+	void RHI_ShaderCache::HashSource(const string& filePath, set<string>& visited, Hash* hash)
+	{
+		if (!visited.insert(filePath).second)
+			return;
+
+		MappedFile file;
+		if (!file.Open(filePath))
+			return;
+
+		// The name too, an include that moves changes the key
+		hash->Update(filePath.c_str(), filePath.size() + 1);
+		hash->Update(file.GetData(), file.GetSize());
+
+		// Includes are resolved relative to the file that includes them, like the compiler does
+		string directory = FileSystem::GetDirectoryFromFilePath(filePath);
+		for (const auto& include : _RHI_ShaderCache::GetIncludes(reinterpret_cast<const char*>(file.GetData()), file.GetSize()))
+		{
+			HashSource(directory + include, visited, hash);
+		}
+	}
+
+	void RHI_ShaderCache::Collect()
+	{
+		// Expects m_mutex to be locked
+		if (m_stats.budget == 0 || m_stats.size <= m_stats.budget)
+			return;
+
+		// The binaries that went unused for the most sessions go first
+		vector<pair<unsigned int, uint64_t>> entries;
+		entries.reserve(m_entries.size());
+		for (const auto& entry : m_entries)
+		{
+			entries.emplace_back(entry.second.session, entry.first);
+		}
+		sort(entries.begin(), entries.end());
+
+		for (const auto& entry : entries)
+		{
+			if (m_stats.size <= m_stats.budget)
+				break;
+
+			auto it = m_entries.find(entry.second);
+			m_stats.size -= it->second.binary->size();
+			m_entries.erase(it);
+			m_stats.evictions++;
+			m_dirty = true;
+		}
+	}
+}
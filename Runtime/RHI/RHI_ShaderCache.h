@@ -0,0 +1,103 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <cstddef>
+#include "../Core/EngineDefs.h"
+//=============================
+
+namespace Directus
+{
+	class Hash;
+
+	struct RHI_ShaderCacheStats
+	{
+		uint64_t size				= 0; // Bytes of binaries
+		uint64_t budget				= 0;
+		unsigned int entryCount		= 0;
+		unsigned int hits			= 0; // Counts are since the cache was created
+		unsigned int misses			= 0;
+		unsigned int stores			= 0;
+		unsigned int evictions		= 0;
+	};
+
+	// Compiled shader binaries, kept in memory and persisted in a single file (an index of keys followed by the binaries).
+	// Entries are keyed by the source and every file it includes, the defines, the entry point, the profile, the
+	// compiler flags and the compiler version, so editing a shader (or anything it includes) or updating the compiler
+	// invalidates what was compiled from it. When saving over budget, the binaries that went unused for the most sessions are dropped.
+	class ENGINE_CLASS RHI_ShaderCache
+	{
+	public:
+		// Loads the file, if there is one
+		RHI_ShaderCache(const std::string& filePath, uint64_t budget);
+		// Saves the file, if anything changed
+		~RHI_ShaderCache();
+
+		// 0 when the source can't be read
+		uint64_t ComputeKey(const std::string& filePath, const std::map<std::string, std::string>& defines, const std::string& entryPoint, const std::string& profile, unsigned int flags, unsigned int compilerVersion);
+
+		// Returns nullptr if there is no binary for the key
+		std::shared_ptr<const std::vector<std::byte>> Load(uint64_t key);
+		void Store(uint64_t key, const void* binary, size_t size);
+		// Drops a binary that turned out to be unusable (e.g. the driver rejects it), so that it gets compiled again
+		void Remove(uint64_t key);
+
+		bool Save();
+		// Saves once nothing was stored for the given time, compiles run asynchronously so this writes a batch of them together
+		bool Save_Idle(double seconds);
+		// 0 means unlimited
+		void SetBudget(uint64_t budget);
+		RHI_ShaderCacheStats GetStats();
+		// Drops every binary, the file included
+		void Clear();
+
+	private:
+		struct Entry
+		{
+			std::shared_ptr<const std::vector<std::byte>> binary;
+			unsigned int session; // The last one that used it
+		};
+
+		uint64_t GetSourceHash(const std::string& filePath);
+		void HashSource(const std::string& filePath, std::set<std::string>& visited, Hash* hash);
+		void Collect();
+
+		std::string m_filePath;
+		std::unordered_map<uint64_t, Entry> m_entries;
+		// Of every source file and what it includes, computed once per session (shaders aren't reloaded)
+		std::unordered_map<std::string, uint64_t> m_sourceHashes;
+		RHI_ShaderCacheStats m_stats;
+		std::chrono::steady_clock::time_point m_lastStore;
+		unsigned int m_session	= 0;
+		bool m_dirty			= false;
+		std::mutex m_mutex;
+	};
+}
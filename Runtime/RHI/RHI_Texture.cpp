@@ -33,6 +33,12 @@ using namespace std;
 
 namespace Directus
 {
+	namespace _RHI_Texture
+	{
+		// Block compressed mips, with their format
+		static const char* sectionCompressed = "compressed";
+	}
+
 	static const char* textureTypeChar[] =
 	{
 		"Unknown",
@@ -163,7 +169,17 @@ namespace Directus
 		for (unsigned int i = 0; i < mipCount; i++)
 		{
 			textureBytes->emplace_back(vector<std::byte>());
-			file->Read(&m_dataRGBA[i]);
+			file->Read(&textureBytes->back());
+		}
+
+		if (file->Section_Seek(_RHI_Texture::sectionCompressed))
+		{
+			file->ReadUInt(); // Format
+			textureBytes->resize(file->ReadUInt());
+			for (auto& mip : *textureBytes)
+			{
+				file->Read(&mip);
+			}
 		}
 	}
 	//================================================================================
@@ -217,11 +233,16 @@ namespace Directus
 		if (!file->IsOpen())
 			return false;
 
-		// Write texture bits
-		file->Write((unsigned int)m_dataRGBA.size());
-		for (auto& mip : m_dataRGBA)
+		// Write texture bits, block compressed mips go into their own section
+		// so that older versions read a texture without data rather than garbage
+		bool compressed = GetBlockSize(m_format) != 0;
+		file->Write(compressed ? 0u : (unsigned int)m_dataRGBA.size());
+		if (!compressed)
 		{
-			file->Write(mip);
+			for (auto& mip : m_dataRGBA)
+			{
+				file->Write(mip);
+			}
 		}
 
 		// Write properties
@@ -237,6 +258,17 @@ namespace Directus
 		file->Write(m_resourceName);
 		file->Write(m_resourceFilePath);
 
+		if (compressed)
+		{
+			file->Section_Begin(_RHI_Texture::sectionCompressed);
+			file->Write((unsigned int)m_format);
+			file->Write((unsigned int)m_dataRGBA.size());
+			for (auto& mip : m_dataRGBA)
+			{
+				file->Write(mip);
+			}
+		}
+
 		ClearTextureBytes();
 
 		return true;
@@ -270,6 +302,18 @@ namespace Directus
 		file->Read(&m_resourceName);
 		file->Read(&m_resourceFilePath);
 
+		m_format = Texture_Format_R8G8B8A8_UNORM;
+		if (file->Section_Seek(_RHI_Texture::sectionCompressed))
+		{
+			m_format	= (Texture_Format)file->ReadUInt();
+			mipCount	= file->ReadUInt();
+			m_dataRGBA.resize(mipCount);
+			for (auto& mip : m_dataRGBA)
+			{
+				file->Read(&mip);
+			}
+		}
+
 		return true;
 	}
 }
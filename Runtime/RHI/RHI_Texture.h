@@ -84,6 +84,19 @@ namespace Directus
 		bool IsUsingMimmaps()								{ return m_isUsingMipmaps; }
 
 		Texture_Format GetFormat()							{ return m_format; }
+		// The data has to be in this format already
+		void SetFormat(Texture_Format format)				{ m_format = format; }
+		// Bytes per 4x4 block of the block compressed formats, 0 for the rest
+		static unsigned int GetBlockSize(Texture_Format format)
+		{
+			if (format == Texture_Format_BC1_UNORM || format == Texture_Format_BC4_UNORM)
+				return 8;
+
+			if (format == Texture_Format_BC3_UNORM || format == Texture_Format_BC5_UNORM || format == Texture_Format_BC7_UNORM)
+				return 16;
+
+			return 0;
+		}
 
 		std::vector<mipmap>& GetData()						{ return m_dataRGBA; }
 		void SetData(const std::vector<mipmap>& dataRGBA)	{ m_dataRGBA = dataRGBA; }
@@ -62,6 +62,12 @@ namespace Directus
 		m_perObjectBuffer->Create(sizeof(PerObjectBufferType), 1, Buffer_VertexShader);
 	}
 
+	unsigned int ShaderVariation::GetMemoryUsage()
+	{
+		// The compiled shaders live in the driver, what's known here are the constant buffers (and their CPU copies)
+		return sizeof(ShaderVariation) + sizeof(PerMaterialBufferType) + sizeof(PerObjectBufferType);
+	}
+
 	void ShaderVariation::UpdatePerMaterialBuffer(Camera* camera, Material* material)
 	{
 		if (!camera || !material)
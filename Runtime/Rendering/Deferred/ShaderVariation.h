@@ -57,6 +57,10 @@ namespace Directus
 
 		void Compile(const std::string& filePath, unsigned long shaderFlags);
 
+		//= IResource ===================================
+		unsigned int GetMemoryUsage() override;
+		//===============================================
+
 		void UpdatePerMaterialBuffer(Camera* camera, Material* material);
 		void UpdatePerObjectBuffer(const Math::Matrix& mWorld, const Math::Matrix& mView, const Math::Matrix& mProjection);
 
@@ -0,0 +1,154 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==============================
+#include "ShaderVariationRegistry.h"
+#include "ShaderVariation.h"
+#include "../../Resource/ResourceManager.h"
+//=========================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _ShaderVariationRegistry
+	{
+		// Enough for every combination of the current flags without growing
+		static const unsigned int initialCapacity = 1024;
+
+		inline unsigned int Slot(unsigned long key, unsigned int capacity)
+		{
+			// Fibonacci hashing, the flags are small and clustered
+			return (unsigned int)(((uint64_t)key * 0x9E3779B97F4A7C15ull) >> 32) & (capacity - 1);
+		}
+	}
+
+	ShaderVariationRegistry::Table::Table(unsigned int capacity)
+	{
+		this->capacity	= capacity;
+		slots			= make_unique<atomic<Entry*>[]>(capacity);
+		for (unsigned int i = 0; i < capacity; i++)
+		{
+			slots[i].store(nullptr, memory_order_relaxed);
+		}
+	}
+
+	ShaderVariationRegistry::ShaderVariationRegistry(Context* context, const shared_ptr<RHI_Device>& rhiDevice)
+	{
+		m_context	= context;
+		m_rhiDevice	= rhiDevice;
+		m_tables.emplace_back(make_unique<Table>(_ShaderVariationRegistry::initialCapacity));
+		m_table		= m_tables.back().get();
+	}
+
+	shared_ptr<ShaderVariation> ShaderVariationRegistry::Acquire(unsigned long shaderFlags)
+	{
+		m_lookups.fetch_add(1, memory_order_relaxed);
+		if (Entry* entry = FindEntry(shaderFlags))
+			return entry->shader;
+
+		// Whoever gets here first compiles, the rest find the entry once they get the lock
+		lock_guard<mutex> guard(m_mutex);
+		if (Entry* entry = FindEntry(shaderFlags))
+			return entry->shader;
+
+		// Compilation is asynchronous, so holding the lock here doesn't hold up requests for long
+		auto shader = make_shared<ShaderVariation>(m_rhiDevice, m_context);
+		shader->Compile(m_context->GetSubsystem<ResourceManager>()->GetStandardResourceDirectory(Resource_Shader) + "GBuffer.hlsl", shaderFlags);
+		shader->SetResourceName("ShaderVariation_" + to_string(shader->Resource_GetID()));
+
+		m_entries.emplace_back(make_unique<Entry>());
+		Entry* entry	= m_entries.back().get();
+		entry->key		= shaderFlags;
+		entry->shader	= shader;
+
+		// Grow into a new table, readers keep using the old one until it's published
+		Table* table = m_table.load(memory_order_relaxed);
+		if (m_entries.size() * 2 > table->capacity)
+		{
+			m_tables.emplace_back(make_unique<Table>(table->capacity * 2));
+			Table* grown = m_tables.back().get();
+			for (const auto& existing : m_entries)
+			{
+				Insert(grown, existing.get());
+			}
+			m_table.store(grown, memory_order_release);
+		}
+		else
+		{
+			Insert(table, entry);
+		}
+
+		return shader;
+	}
+
+	shared_ptr<ShaderVariation> ShaderVariationRegistry::Find(unsigned long shaderFlags)
+	{
+		m_lookups.fetch_add(1, memory_order_relaxed);
+		Entry* entry = FindEntry(shaderFlags);
+		return entry ? entry->shader : nullptr;
+	}
+
+	ShaderVariationStats ShaderVariationRegistry::GetStats()
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		ShaderVariationStats stats;
+		stats.permutationCount	= (unsigned int)m_entries.size();
+		stats.lookups			= m_lookups;
+		stats.memoryUsage		= sizeof(*this) + m_entries.size() * sizeof(Entry);
+		for (const auto& table : m_tables)
+		{
+			stats.memoryUsage += sizeof(Table) + table->capacity * sizeof(atomic<Entry*>);
+		}
+		for (const auto& entry : m_entries)
+		{
+			stats.memoryUsage += entry->shader->GetMemoryUsage();
+		}
+
+		return stats;
+	}
+
+	ShaderVariationRegistry::Entry* ShaderVariationRegistry::FindEntry(unsigned long key)
+	{
+		// Slots are only ever filled (and never emptied), so probing can stop at the first empty one
+		Table* table = m_table.load(memory_order_acquire);
+		for (unsigned int i = _ShaderVariationRegistry::Slot(key, table->capacity);; i = (i + 1) & (table->capacity - 1))
+		{
+			Entry* entry = table->slots[i].load(memory_order_acquire);
+			if (!entry || entry->key == key)
+				return entry;
+		}
+	}
+
+	void ShaderVariationRegistry::Insert(Table* table, Entry* entry)
+	{
+		// Expects m_mutex to be locked
+		unsigned int i = _ShaderVariationRegistry::Slot(entry->key, table->capacity);
+		while (table->slots[i].load(memory_order_relaxed))
+		{
+			i = (i + 1) & (table->capacity - 1);
+		}
+		table->slots[i].store(entry, memory_order_release);
+	}
+}
@@ -0,0 +1,90 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include "../../Core/EngineDefs.h"
+//================================
+
+namespace Directus
+{
+	class Context;
+	class RHI_Device;
+	class ShaderVariation;
+
+	struct ShaderVariationStats
+	{
+		unsigned int permutationCount	= 0;
+		uint64_t memoryUsage			= 0; // The variations (CPU and constant buffers) and the registry itself
+		uint64_t lookups				= 0; // Since the registry was created
+	};
+
+	// The G-Buffer shader variations, one per combination of shader flags (the packed key).
+	// Lookups are lock free (an open addressing table that is replaced, never modified in place, when it grows),
+	// the first request for a key compiles its variation while any concurrent requests for it wait and share it.
+	// The registry owns the variations, they aren't cached in the ResourceManager (which drops its cache on scene unload,
+	// while the variations stay registered for as long as the renderer lives).
+	class ENGINE_CLASS ShaderVariationRegistry
+	{
+	public:
+		ShaderVariationRegistry(Context* context, const std::shared_ptr<RHI_Device>& rhiDevice);
+		~ShaderVariationRegistry() {}
+
+		// Returns the variation for the flags, compiling it on the first request
+		std::shared_ptr<ShaderVariation> Acquire(unsigned long shaderFlags);
+		// Returns nullptr if the variation was never requested
+		std::shared_ptr<ShaderVariation> Find(unsigned long shaderFlags);
+
+		ShaderVariationStats GetStats();
+
+	private:
+		struct Entry
+		{
+			unsigned long key;
+			std::shared_ptr<ShaderVariation> shader;
+		};
+
+		struct Table
+		{
+			Table(unsigned int capacity);
+
+			unsigned int capacity; // A power of two, at most half full
+			std::unique_ptr<std::atomic<Entry*>[]> slots;
+		};
+
+		Entry* FindEntry(unsigned long key);
+		void Insert(Table* table, Entry* entry);
+
+		Context* m_context;
+		std::shared_ptr<RHI_Device> m_rhiDevice;
+		std::atomic<Table*> m_table;
+		// Readers may still be looking at a replaced table, so tables (and entries) live as long as the registry
+		std::vector<std::unique_ptr<Table>> m_tables;
+		std::vector<std::unique_ptr<Entry>> m_entries;
+		std::atomic<uint64_t> m_lookups	= 0;
+		std::mutex m_mutex;
+	};
+}
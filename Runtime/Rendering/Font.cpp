@@ -21,6 +21,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===========================
 #include "Font.h"
+#include <cstring>
 #include "Renderer.h"
 #include "../Core/Stopwatch.h"
 #include "../RHI/RHI_Implementation.h"
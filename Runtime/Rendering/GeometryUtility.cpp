@@ -21,7 +21,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =================
 #include "GeometryUtility.h"
-#include "..\RHI\RHI_Vertex.h"
+#include "../RHI/RHI_Vertex.h"
 //============================
 
 //= NAMESPACES ========================
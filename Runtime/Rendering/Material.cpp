@@ -19,15 +19,16 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ===========================
+//= INCLUDES ================================
 #include "Material.h"
 #include "Renderer.h"
 #include "Deferred/ShaderVariation.h"
+#include "Deferred/ShaderVariationRegistry.h"
 #include "../RHI/RHI_Implementation.h"
 #include "../Resource/ResourceManager.h"
 #include "../IO/XmlDocument.h"
 #include "../RHI/RHI_Texture.h"
-//======================================
+//===========================================
 
 //= NAMESPACES ================
 using namespace std;
@@ -57,6 +58,13 @@ namespace Directus
 
 	Material::~Material()
 	{
+		for (const auto& textureSlot : m_textureSlots)
+		{
+			if (auto texture = textureSlot.ptr_weak.lock())
+			{
+				texture->UseCount_Decrement();
+			}
+		}
 		m_textureSlots.clear();
 		m_textureSlots.shrink_to_fit();
 	}
@@ -124,8 +132,8 @@ namespace Directus
 		xml->AddAttribute("Material", "Name",					GetResourceName());
 		xml->AddAttribute("Material", "Path",					GetResourceFilePath());
 		xml->AddAttribute("Material", "Model_ID",				m_modelID);
-		xml->AddAttribute("Material", "Cull_Mode",				unsigned int(m_cullMode));	
-		xml->AddAttribute("Material", "Shading_Mode",			unsigned int(m_shadingMode));
+		xml->AddAttribute("Material", "Cull_Mode",				(unsigned int)m_cullMode);	
+		xml->AddAttribute("Material", "Shading_Mode",			(unsigned int)m_shadingMode);
 		xml->AddAttribute("Material", "Color",					m_colorAlbedo);
 		xml->AddAttribute("Material", "Roughness_Multiplier",	m_roughnessMultiplier);
 		xml->AddAttribute("Material", "Metallic_Multiplier",	m_metallicMultiplier);
@@ -189,12 +197,22 @@ namespace Directus
 		// Cache it or use the provided reference as is
 		auto texRef = autoCache ? textureWeak.lock()->Cache<RHI_Texture>() : textureWeak;
 
+		// Textures are only referenced weakly, count the material as a user so they are never evicted
+		if (auto texture = texRef.lock())
+		{
+			texture->UseCount_Increment();
+		}
+
 		// Assign - As a replacement (if there is a previous one)
 		bool replaced = false;
 		for (auto& textureSlot : m_textureSlots)
 		{
 			if (textureSlot.type == type)
 			{
+				if (auto texture = textureSlot.ptr_weak.lock())
+				{
+					texture->UseCount_Decrement();
+				}
 				textureSlot.ptr_weak	= texRef;
 				textureSlot.ptr_raw		= texRef.lock().get();
 				replaced = true;
@@ -259,8 +277,8 @@ namespace Directus
 			return;
 		}
 
-		// Add a shader to the pool based on this material, if a 
-		// matching shader already exists, it will be returned.
+		// The registry compiles a variation for these flags the first time they are requested,
+		// every other material with the same flags shares it.
 		unsigned long shaderFlags = 0;
 
 		if (HasTexture(TextureType_Albedo))		shaderFlags	|= Variaton_Albedo;
@@ -273,40 +291,7 @@ namespace Directus
 		if (HasTexture(TextureType_Mask))		shaderFlags	|= Variaton_Mask;
 		if (HasTexture(TextureType_CubeMap))	shaderFlags	|= Variaton_Cubemap;
 
-		m_shader = GetOrCreateShader(shaderFlags);
-	}
-
-	weak_ptr<ShaderVariation> Material::FindMatchingShader(unsigned long shaderFlags)
-	{
-		auto shaders = m_context->GetSubsystem<ResourceManager>()->GetResourcesByType<ShaderVariation>();
-		for (const auto& shader : shaders)
-		{
-			if (shader.lock()->GetShaderFlags() == shaderFlags)
-				return shader;
-		}
-		return weak_ptr<ShaderVariation>();
-	}
-
-	weak_ptr<ShaderVariation> Material::GetOrCreateShader(unsigned long shaderFlags)
-	{
-		if (!m_context)
-		{
-			LOG_ERROR("Material::GetOrCreateShader(): Context is null, can't execute function");
-			return weak_ptr<ShaderVariation>();
-		}
-
-		// If an appropriate shader already exists, return it's ID
-		auto existingShader = FindMatchingShader(shaderFlags);
-		if (!existingShader.expired())
-			return existingShader;
-
-		// Create and initialize shader
-		auto shader = make_shared<ShaderVariation>(m_rhiDevice, m_context);
-		shader->Compile(m_context->GetSubsystem<ResourceManager>()->GetStandardResourceDirectory(Resource_Shader) + "GBuffer.hlsl", shaderFlags);
-		shader->SetResourceName("ShaderVariation_" + to_string(shader->Resource_GetID())); // set a different name for it's shader the cache doesn't thing they are the same
-
-		// Add the shader to the pool and return it
-		return shader->Cache<ShaderVariation>();
+		m_shader = m_context->GetSubsystem<Renderer>()->GetShaderVariations()->Acquire(shaderFlags);
 	}
 
 	void Material::SetMultiplier(TextureType type, float value)
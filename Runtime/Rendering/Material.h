@@ -85,9 +85,8 @@ namespace Directus
 		//==========================================================================================================
 
 		//= SHADER ==================================================================
+		// Gets the shader variation that matches the texture slots (from the Renderer's registry)
 		void AcquireShader();
-		std::weak_ptr<ShaderVariation> FindMatchingShader(unsigned long shaderFlags);
-		std::weak_ptr<ShaderVariation> GetOrCreateShader(unsigned long shaderFlags);
 		std::weak_ptr<ShaderVariation> GetShader() { return m_shader; }
 		bool HasShader() { return GetShader().expired() ? false : true; }
 		void SetMultiplier(TextureType type, float value);
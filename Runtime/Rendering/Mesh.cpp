@@ -34,17 +34,26 @@ namespace Directus
 {
 	void Mesh::Geometry_Clear()
 	{
-		m_vertices.clear();
-		m_vertices.shrink_to_fit();
+		Geometry_ClearVertices();
 		m_indices.clear();
 		m_indices.shrink_to_fit();
 	}
 
+	void Mesh::Geometry_ClearVertices()
+	{
+		m_vertices.clear();
+		m_vertices.shrink_to_fit();
+		m_verticesPacked.clear();
+		m_verticesPacked.shrink_to_fit();
+		m_packing = Vertex_Packing_None;
+	}
+
 	unsigned int Mesh::Geometry_MemoryUsage()
 	{
 		unsigned int size = 0;
-		size += unsigned int(m_vertices.size()	* sizeof(RHI_Vertex_PosUVTBN));
-		size += unsigned int(m_indices.size()	* sizeof(unsigned int));
+		size += (unsigned int)(m_vertices.size()	* sizeof(RHI_Vertex_PosUVTBN));
+		size += (unsigned int)(m_indices.size()	* sizeof(unsigned int));
+		size += (unsigned int)(m_verticesPacked.size());
 
 		return size;
 	}
@@ -63,6 +72,13 @@ namespace Directus
 		*indices		= vector<unsigned int>(indexFirst, indexLast);
 
 		// Vertices
+		if (m_packing != Vertex_Packing_None)
+		{
+			vertices->resize(vertexCount);
+			const std::byte* packed = m_verticesPacked.data() + (size_t)vertexOffset * VertexPacking::GetStride(m_packing);
+			VertexPacking::Unpack(packed, vertexCount, m_packing, m_packingBounds, vertices->data());
+			return;
+		}
 		auto vertexFirst	= m_vertices.begin() + vertexOffset;
 		auto vertexLast		= m_vertices.begin() + vertexOffset + vertexCount;
 		*vertices			= vector<RHI_Vertex_PosUVTBN>(vertexFirst, vertexLast);
@@ -72,22 +88,77 @@ namespace Directus
 	{
 		if (vertexOffset)
 		{
-			*vertexOffset = (unsigned int)m_vertices.size();
+			*vertexOffset = Vertices_Count();
 		}
 
+		Vertices_Pack(Vertex_Packing_None);
 		m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
 	}
 
 	unsigned int Mesh::Vertices_Count() const
 	{
+		if (m_packing != Vertex_Packing_None)
+			return (unsigned int)(m_verticesPacked.size() / VertexPacking::GetStride(m_packing));
+
 		return (unsigned int)m_vertices.size();
 	}
 
 	void Mesh::Vertex_Add(const RHI_Vertex_PosUVTBN& vertex)
 	{
+		Vertices_Pack(Vertex_Packing_None);
 		m_vertices.emplace_back(vertex);
 	}
 
+	void Mesh::Vertices_Copy(vector<RHI_Vertex_PosUVTBN>* vertices)
+	{
+		if (m_packing == Vertex_Packing_None)
+		{
+			*vertices = m_vertices;
+			return;
+		}
+
+		vertices->resize(Vertices_Count());
+		VertexPacking::Unpack(m_verticesPacked.data(), (unsigned int)vertices->size(), m_packing, m_packingBounds, vertices->data());
+	}
+
+	BoundingBox Mesh::Vertices_GetAABB()
+	{
+		// Packed positions are quantized within the bounds, unpacked they can only fall within them
+		return m_packing != Vertex_Packing_None ? m_packingBounds : BoundingBox(m_vertices);
+	}
+
+	void Mesh::Vertices_Pack(Vertex_Packing packing)
+	{
+		if (packing == m_packing)
+			return;
+
+		if (m_packing != Vertex_Packing_None)
+		{
+			vector<RHI_Vertex_PosUVTBN> vertices;
+			Vertices_Copy(&vertices);
+			Geometry_ClearVertices();
+			m_vertices = move(vertices);
+		}
+
+		if (packing == Vertex_Packing_None || m_vertices.empty())
+			return;
+
+		m_packingBounds = BoundingBox(m_vertices);
+		m_verticesPacked.resize(m_vertices.size() * VertexPacking::GetStride(packing));
+		VertexPacking::Pack(m_vertices.data(), (unsigned int)m_vertices.size(), packing, m_packingBounds, m_verticesPacked.data());
+		m_vertices.clear();
+		m_vertices.shrink_to_fit();
+		m_packing = packing;
+	}
+
+	void Mesh::Vertices_SetPacked(Vertex_Packing packing, const BoundingBox& bounds, vector<std::byte>&& packed)
+	{
+		Geometry_ClearVertices();
+		m_packing			= packing;
+		m_packingBounds		= bounds;
+		m_verticesPacked	= move(packed);
+	}
+
 	void Mesh::Indices_Append(const vector<unsigned int>& indices, unsigned int* indexOffset)
 	{
 		if (indexOffset)
@@ -23,7 +23,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include <vector>
+#include "VertexPacking.h"
 #include "../RHI/RHI_Definition.h"
+#include "../Math/BoundingBox.h"
 //=============================
 
 namespace Directus
@@ -50,8 +52,19 @@ namespace Directus
 		void Vertex_Add(const RHI_Vertex_PosUVTBN& vertex);
 		void Vertices_Append(const std::vector<RHI_Vertex_PosUVTBN>& vertices, unsigned int* vertexOffset);	
 		unsigned int Vertices_Count() const;
-		std::vector<RHI_Vertex_PosUVTBN>& Vertices_Get()						{ return m_vertices; }
-		void Vertices_Set(const std::vector<RHI_Vertex_PosUVTBN>& vertices)	{ m_vertices = vertices; }
+		// Unpacks the vertices if they are packed
+		std::vector<RHI_Vertex_PosUVTBN>& Vertices_Get()						{ Vertices_Pack(Vertex_Packing_None); return m_vertices; }
+		void Vertices_Set(const std::vector<RHI_Vertex_PosUVTBN>& vertices)	{ Geometry_ClearVertices(); m_vertices = vertices; }
+		// Unpacked copy, the vertices stay as they are
+		void Vertices_Copy(std::vector<RHI_Vertex_PosUVTBN>* vertices);
+		Math::BoundingBox Vertices_GetAABB();
+
+		// Packing, the vertices stay packed until something needs them unpacked
+		void Vertices_Pack(Vertex_Packing packing);
+		void Vertices_SetPacked(Vertex_Packing packing, const Math::BoundingBox& bounds, std::vector<std::byte>&& packed);
+		Vertex_Packing Vertices_GetPacking() const					{ return m_packing; }
+		const std::vector<std::byte>& Vertices_GetPacked() const	{ return m_verticesPacked; }
+		const Math::BoundingBox& Vertices_GetPackingBounds() const	{ return m_packingBounds; }
 
 		// Indices
 		void Index_Add(unsigned int index)							{ m_indices.emplace_back(index); }
@@ -64,7 +77,12 @@ namespace Directus
 		unsigned int GetTriangleCount() const { return Indices_Count() / 3; }	
 		
 	private:
+		void Geometry_ClearVertices();
+
 		std::vector<RHI_Vertex_PosUVTBN> m_vertices;
 		std::vector<unsigned int> m_indices;
+		std::vector<std::byte> m_verticesPacked; // Replaces the vertices when they are packed
+		Vertex_Packing m_packing = Vertex_Packing_None;
+		Math::BoundingBox m_packingBounds;
 	};
 }
\ No newline at end of file
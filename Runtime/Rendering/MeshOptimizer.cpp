@@ -0,0 +1,425 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ====================
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "../RHI/RHI_Vertex.h"
+#include "../Core/Hash.h"
+//===============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _MeshOptimizer
+	{
+		static const unsigned int invalid		= 0xffffffff;
+		static const unsigned int fetchLineSize	= 64;	// Bytes
+		static const unsigned int fetchLines	= 64;	// Cache lines the fetch simulation keeps
+
+		// Post-transform cache, FIFO. Timestamps make a reset free: moving time forward by more than the cache size evicts everything.
+		struct VertexCache
+		{
+			VertexCache(unsigned int vertexCount, unsigned int size) : timestamps(vertexCount, 0), size(size), time(size + 1) {}
+
+			// Returns true on a miss
+			bool Access(unsigned int vertex)
+			{
+				if (time - timestamps[vertex] <= size)
+					return false;
+
+				timestamps[vertex] = time++;
+				return true;
+			}
+
+			void Reset() { time += size + 1; }
+
+			vector<unsigned int> timestamps;
+			unsigned int size;
+			unsigned int time;
+		};
+
+		// The triangles that use each vertex, as one array with offsets into it
+		struct Adjacency
+		{
+			Adjacency(const vector<unsigned int>& indices, unsigned int vertexCount)
+			{
+				counts.resize(vertexCount, 0);
+				offsets.resize(vertexCount + 1, 0);
+				for (unsigned int index : indices)
+				{
+					counts[index]++;
+				}
+				for (unsigned int i = 0; i < vertexCount; i++)
+				{
+					offsets[i + 1] = offsets[i] + counts[i];
+				}
+
+				triangles.resize(indices.size());
+				vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+				for (unsigned int i = 0; i < (unsigned int)indices.size(); i++)
+				{
+					triangles[cursor[indices[i]]++] = i / 3;
+				}
+			}
+
+			vector<unsigned int> counts;
+			vector<unsigned int> offsets;
+			vector<unsigned int> triangles;
+		};
+	}
+
+	void MeshOptimizer::Optimize(vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices, unsigned int cacheSize)
+	{
+		if (!vertices || !indices || indices->size() < 3)
+			return;
+
+		vector<unsigned int> clusters;
+		Vertices_Deduplicate(vertices, indices);
+		Indices_OptimizeCache(indices, (unsigned int)vertices->size(), cacheSize, &clusters);
+		Indices_OptimizeOverdraw(indices, *vertices, clusters, cacheSize);
+		Vertices_OptimizeFetch(vertices, indices);
+	}
+
+	void MeshOptimizer::Vertices_Deduplicate(vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices)
+	{
+		// Open addressing, at most half full
+		unsigned int tableSize = 1;
+		while (tableSize < vertices->size() * 2)
+		{
+			tableSize *= 2;
+		}
+		vector<unsigned int> table(tableSize, _MeshOptimizer::invalid);
+		vector<unsigned int> remap(vertices->size());
+
+		unsigned int unique = 0;
+		for (unsigned int i = 0; i < (unsigned int)vertices->size(); i++)
+		{
+			const RHI_Vertex_PosUVTBN& vertex = (*vertices)[i];
+			unsigned int slot = (unsigned int)Hash::Compute(&vertex, sizeof(vertex)) & (tableSize - 1);
+			while (table[slot] != _MeshOptimizer::invalid && memcmp(&(*vertices)[table[slot]], &vertex, sizeof(vertex)) != 0)
+			{
+				slot = (slot + 1) & (tableSize - 1);
+			}
+
+			if (table[slot] == _MeshOptimizer::invalid)
+			{
+				// Unique vertices are compacted to the front as they are found
+				(*vertices)[unique]	= vertex;
+				table[slot]			= unique++;
+			}
+			remap[i] = table[slot];
+		}
+
+		for (auto& index : *indices)
+		{
+			index = remap[index];
+		}
+		vertices->resize(unique);
+	}
+
+	void MeshOptimizer::Indices_OptimizeCache(vector<unsigned int>* indices, unsigned int vertexCount, unsigned int cacheSize, vector<unsigned int>* clusters)
+	{
+		// Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (2007).
+		// Fans around one vertex at a time, the next one being whichever recent vertex will still be in the cache once its triangles are emitted.
+		unsigned int triangleCount = (unsigned int)indices->size() / 3;
+		_MeshOptimizer::Adjacency adjacency(*indices, vertexCount);
+		vector<unsigned int>& live = adjacency.counts; // Triangles left to emit per vertex
+		vector<unsigned int> timestamps(vertexCount, 0);
+		vector<bool> emitted(triangleCount, false);
+		vector<unsigned int> deadEnds;
+		vector<unsigned int> candidates;
+		vector<unsigned int> output;
+		output.reserve(indices->size());
+		if (clusters)
+		{
+			clusters->clear();
+		}
+
+		unsigned int time	= cacheSize + 1;
+		unsigned int cursor	= 0;
+		unsigned int fan	= 0;
+		while (fan != _MeshOptimizer::invalid)
+		{
+			candidates.clear();
+			for (unsigned int i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1]; i++)
+			{
+				unsigned int triangle = adjacency.triangles[i];
+				if (emitted[triangle])
+					continue;
+
+				for (unsigned int j = 0; j < 3; j++)
+				{
+					unsigned int vertex = (*indices)[triangle * 3 + j];
+					output.emplace_back(vertex);
+					deadEnds.emplace_back(vertex);
+					candidates.emplace_back(vertex);
+					live[vertex]--;
+					if (time - timestamps[vertex] > cacheSize)
+					{
+						timestamps[vertex] = time++;
+					}
+				}
+				emitted[triangle] = true;
+			}
+
+			// The candidate that stays in the cache and has the oldest entry in it
+			unsigned int next	= _MeshOptimizer::invalid;
+			int best			= -1;
+			for (unsigned int vertex : candidates)
+			{
+				if (live[vertex] == 0)
+					continue;
+
+				int priority = 0;
+				if (time - timestamps[vertex] + 2 * live[vertex] <= cacheSize)
+				{
+					priority = (int)(time - timestamps[vertex]);
+				}
+				if (priority > best)
+				{
+					best = priority;
+					next = vertex;
+				}
+			}
+
+			// Dead end, continue from a recently used vertex if there is one, or from the next vertex with triangles left
+			if (next == _MeshOptimizer::invalid)
+			{
+				bool cold = false;
+				while (!deadEnds.empty() && next == _MeshOptimizer::invalid)
+				{
+					unsigned int vertex = deadEnds.back();
+					deadEnds.pop_back();
+					next = live[vertex] > 0 ? vertex : _MeshOptimizer::invalid;
+				}
+
+				while (next == _MeshOptimizer::invalid && cursor < vertexCount)
+				{
+					next = live[cursor] > 0 ? cursor : _MeshOptimizer::invalid;
+					cold = true;
+					cursor++;
+				}
+
+				// Whatever follows starts with a cold cache
+				if (clusters && next != _MeshOptimizer::invalid && cold)
+				{
+					clusters->emplace_back((unsigned int)output.size() / 3);
+				}
+			}
+
+			fan = next;
+		}
+
+		if (clusters && (clusters->empty() || clusters->front() != 0))
+		{
+			clusters->insert(clusters->begin(), 0);
+		}
+		indices->swap(output);
+	}
+
+	void MeshOptimizer::Indices_OptimizeOverdraw(vector<unsigned int>* indices, const vector<RHI_Vertex_PosUVTBN>& vertices, const vector<unsigned int>& hardClusters, unsigned int cacheSize, float threshold)
+	{
+		unsigned int triangleCount = (unsigned int)indices->size() / 3;
+		if (triangleCount == 0 || hardClusters.empty())
+			return;
+
+		// Split the clusters further wherever the cache has done well enough so far, so a connected mesh
+		// (which Tipsify emits as a single cluster) can be sorted too, at the cost of a cold cache per split.
+		vector<unsigned int> clusters;
+		_MeshOptimizer::VertexCache cache((unsigned int)vertices.size(), cacheSize);
+		for (unsigned int c = 0; c < (unsigned int)hardClusters.size(); c++)
+		{
+			unsigned int begin	= hardClusters[c];
+			unsigned int end	= c + 1 < (unsigned int)hardClusters.size() ? hardClusters[c + 1] : triangleCount;
+
+			unsigned int misses = 0;
+			cache.Reset();
+			for (unsigned int i = begin * 3; i < end * 3; i++)
+			{
+				misses += cache.Access((*indices)[i]) ? 1 : 0;
+			}
+			float acmr = (float)misses / (float)(end - begin);
+
+			cache.Reset();
+			clusters.emplace_back(begin);
+			unsigned int start	= begin;
+			misses				= 0;
+			for (unsigned int t = begin; t < end; t++)
+			{
+				for (unsigned int i = 0; i < 3; i++)
+				{
+					misses += cache.Access((*indices)[t * 3 + i]) ? 1 : 0;
+				}
+
+				if (t + 1 < end && (float)misses / (float)(t + 1 - start) <= threshold * acmr)
+				{
+					clusters.emplace_back(t + 1);
+					start	= t + 1;
+					misses	= 0;
+					cache.Reset();
+				}
+			}
+		}
+		if (clusters.size() < 2)
+			return;
+
+		// Area weighted centroid and normal of the mesh and of every cluster
+		struct Cluster
+		{
+			unsigned int begin;
+			unsigned int end;
+			float centroid[3]	= { 0.0f, 0.0f, 0.0f };
+			float normal[3]		= { 0.0f, 0.0f, 0.0f };
+			float area			= 0.0f;
+			float sortKey		= 0.0f;
+		};
+		vector<Cluster> sorted(clusters.size());
+		float meshCentroid[3]	= { 0.0f, 0.0f, 0.0f };
+		float meshArea			= 0.0f;
+		for (unsigned int c = 0; c < (unsigned int)clusters.size(); c++)
+		{
+			Cluster& cluster	= sorted[c];
+			cluster.begin		= clusters[c];
+			cluster.end			= c + 1 < (unsigned int)clusters.size() ? clusters[c + 1] : triangleCount;
+
+			for (unsigned int t = cluster.begin; t < cluster.end; t++)
+			{
+				const float* p0 = vertices[(*indices)[t * 3 + 0]].pos;
+				const float* p1 = vertices[(*indices)[t * 3 + 1]].pos;
+				const float* p2 = vertices[(*indices)[t * 3 + 2]].pos;
+				float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+				// The cross product's length is twice the area, which is fine as a weight
+				float n[3]	= { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+				float area	= sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+				for (unsigned int k = 0; k < 3; k++)
+				{
+					cluster.normal[k]	+= n[k];
+					cluster.centroid[k]	+= (p0[k] + p1[k] + p2[k]) / 3.0f * area;
+				}
+				cluster.area += area;
+			}
+
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				meshCentroid[k] += cluster.centroid[k];
+			}
+			meshArea += cluster.area;
+		}
+
+		for (auto& cluster : sorted)
+		{
+			float length = sqrtf(cluster.normal[0] * cluster.normal[0] + cluster.normal[1] * cluster.normal[1] + cluster.normal[2] * cluster.normal[2]);
+			if (cluster.area <= 0.0f || length <= 0.0f || meshArea <= 0.0f)
+				continue;
+
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				cluster.sortKey += (cluster.centroid[k] / cluster.area - meshCentroid[k] / meshArea) * cluster.normal[k] / length;
+			}
+		}
+
+		// Outward facing clusters first
+		stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+		vector<unsigned int> output;
+		output.reserve(indices->size());
+		for (const auto& cluster : sorted)
+		{
+			output.insert(output.end(), indices->begin() + cluster.begin * 3, indices->begin() + cluster.end * 3);
+		}
+		indices->swap(output);
+	}
+
+	void MeshOptimizer::Vertices_OptimizeFetch(vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices)
+	{
+		vector<unsigned int> remap(vertices->size(), _MeshOptimizer::invalid);
+		vector<RHI_Vertex_PosUVTBN> output;
+		output.reserve(vertices->size());
+
+		for (auto& index : *indices)
+		{
+			if (remap[index] == _MeshOptimizer::invalid)
+			{
+				remap[index] = (unsigned int)output.size();
+				output.emplace_back((*vertices)[index]);
+			}
+			index = remap[index];
+		}
+
+		// Unreferenced vertices are dropped
+		vertices->swap(output);
+	}
+
+	MeshOptimizerStats MeshOptimizer::Analyze(const vector<unsigned int>& indices, unsigned int vertexCount, unsigned int vertexSize, unsigned int cacheSize)
+	{
+		MeshOptimizerStats stats;
+		if (indices.size() < 3 || vertexCount == 0)
+			return stats;
+
+		_MeshOptimizer::VertexCache cache(vertexCount, cacheSize);
+		vector<bool> used(vertexCount, false);
+		unsigned int transforms	= 0;
+		unsigned int usedCount	= 0;
+
+		// Fetch cache, FIFO of cache lines
+		unsigned int lineCount = (unsigned int)(((uint64_t)vertexCount * vertexSize + _MeshOptimizer::fetchLineSize - 1) / _MeshOptimizer::fetchLineSize);
+		vector<unsigned int> lineTimestamps(lineCount, 0);
+		unsigned int lineTime	= _MeshOptimizer::fetchLines + 1;
+		uint64_t fetched		= 0;
+
+		for (unsigned int index : indices)
+		{
+			if (!cache.Access(index))
+				continue;
+
+			transforms++;
+			if (!used[index])
+			{
+				used[index] = true;
+				usedCount++;
+			}
+
+			uint64_t first	= (uint64_t)index * vertexSize / _MeshOptimizer::fetchLineSize;
+			uint64_t last	= ((uint64_t)index * vertexSize + vertexSize - 1) / _MeshOptimizer::fetchLineSize;
+			for (uint64_t line = first; line <= last; line++)
+			{
+				if (lineTime - lineTimestamps[line] > _MeshOptimizer::fetchLines)
+				{
+					lineTimestamps[line] = lineTime++;
+					fetched += _MeshOptimizer::fetchLineSize;
+				}
+			}
+		}
+
+		stats.acmr		= (float)transforms / (float)(indices.size() / 3);
+		stats.atvr		= (float)transforms / (float)usedCount;
+		stats.overfetch	= (float)fetched / (float)((uint64_t)usedCount * vertexSize);
+		return stats;
+	}
+}
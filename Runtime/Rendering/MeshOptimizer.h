@@ -0,0 +1,59 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <vector>
+#include "../Core/EngineDefs.h"
+#include "../RHI/RHI_Definition.h"
+//=============================
+
+namespace Directus
+{
+	// How well an index buffer uses the post-transform vertex cache (simulated as FIFO) and the vertex fetch cache
+	struct MeshOptimizerStats
+	{
+		float acmr		= 0.0f; // Average cache miss ratio, transformed vertices per triangle (0.5 at best, 3 at worst)
+		float atvr		= 0.0f; // Average transformed to vertex ratio, transformed vertices per vertex (1 at best)
+		float overfetch	= 0.0f; // Bytes fetched (in cache lines) per byte of vertex data used (1 at best)
+	};
+
+	// Reorders the geometry of a mesh for the GPU, the result renders the same
+	class ENGINE_CLASS MeshOptimizer
+	{
+	public:
+		// Everything below, in order
+		static void Optimize(std::vector<RHI_Vertex_PosUVTBN>* vertices, std::vector<unsigned int>* indices, unsigned int cacheSize = 16);
+
+		// Merges identical vertices
+		static void Vertices_Deduplicate(std::vector<RHI_Vertex_PosUVTBN>* vertices, std::vector<unsigned int>* indices);
+		// Tipsify: reorders the triangles for the vertex cache. Clusters (optional) receives the first triangle of every run that starts with a cold cache.
+		static void Indices_OptimizeCache(std::vector<unsigned int>* indices, unsigned int vertexCount, unsigned int cacheSize, std::vector<unsigned int>* clusters = nullptr);
+		// Draws the clusters that face outwards first, so they occlude the rest, without touching the order within a cluster.
+		// The clusters from above are split further as long as that keeps the cache misses within threshold times what they were.
+		static void Indices_OptimizeOverdraw(std::vector<unsigned int>* indices, const std::vector<RHI_Vertex_PosUVTBN>& vertices, const std::vector<unsigned int>& clusters, unsigned int cacheSize, float threshold = 1.05f);
+		// Reorders the vertices in the order they are first used
+		static void Vertices_OptimizeFetch(std::vector<RHI_Vertex_PosUVTBN>* vertices, std::vector<unsigned int>* indices);
+
+		static MeshOptimizerStats Analyze(const std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int vertexSize, unsigned int cacheSize = 16);
+	};
+}
@@ -0,0 +1,473 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include "../RHI/RHI_Vertex.h"
+#include "../Core/Hash.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _MeshSimplifier
+	{
+		static const unsigned int invalid	= 0xffffffff;
+		static const float borderWeight		= 10.0f; // How much more moving a border costs than moving a surface
+
+		enum Vertex_Kind
+		{
+			Vertex_Manifold,	// Can collapse onto any neighbour
+			Vertex_Border,		// Can collapse onto a neighbour along the border
+			Vertex_Locked		// Seams, corners and non-manifold geometry, never collapses
+		};
+
+		// Symmetric 4x4 matrix of a sum of squared plane distances, plus the total weight (area) of those planes
+		struct Quadric
+		{
+			Quadric() = default;
+			Quadric(const float* n, float d, float weight)
+			{
+				a00 = n[0] * n[0] * weight; a11 = n[1] * n[1] * weight; a22 = n[2] * n[2] * weight;
+				a10 = n[1] * n[0] * weight; a20 = n[2] * n[0] * weight; a21 = n[2] * n[1] * weight;
+				b0	= n[0] * d * weight; b1 = n[1] * d * weight; b2 = n[2] * d * weight;
+				c	= d * d * weight;
+				w	= weight;
+			}
+
+			void operator+=(const Quadric& q)
+			{
+				a00 += q.a00; a11 += q.a11; a22 += q.a22;
+				a10 += q.a10; a20 += q.a20; a21 += q.a21;
+				b0	+= q.b0; b1 += q.b1; b2 += q.b2;
+				c	+= q.c;
+				w	+= q.w;
+			}
+
+			// Weighted sum of squared distances of p to the planes
+			float Evaluate(const float* p) const
+			{
+				float x = p[0], y = p[1], z = p[2];
+				float rx = a00 * x + a10 * y + a20 * z + b0 * 2.0f;
+				float ry = a10 * x + a11 * y + a21 * z + b1 * 2.0f;
+				float rz = a20 * x + a21 * y + a22 * z + b2 * 2.0f;
+				return fabsf(rx * x + ry * y + rz * z + c);
+			}
+
+			float a00 = 0, a11 = 0, a22 = 0, a10 = 0, a20 = 0, a21 = 0;
+			float b0 = 0, b1 = 0, b2 = 0;
+			float c = 0;
+			float w = 0;
+		};
+
+		struct Collapse
+		{
+			unsigned int from;
+			unsigned int to;
+			float error;
+		};
+
+		inline void Cross(const float* a, const float* b, float* result)
+		{
+			result[0] = a[1] * b[2] - a[2] * b[1];
+			result[1] = a[2] * b[0] - a[0] * b[2];
+			result[2] = a[0] * b[1] - a[1] * b[0];
+		}
+
+		inline float Normalize(float* v)
+		{
+			float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+			if (length > 0.0f)
+			{
+				v[0] /= length; v[1] /= length; v[2] /= length;
+			}
+			return length;
+		}
+
+		inline void TriangleNormal(const float* p0, const float* p1, const float* p2, float* normal)
+		{
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			Cross(e1, e2, normal);
+		}
+	}
+
+	float MeshSimplifier::Simplify(const vector<RHI_Vertex_PosUVTBN>& vertices, const vector<unsigned int>& indices, unsigned int targetIndexCount, float targetError, vector<unsigned int>* result)
+	{
+		using namespace _MeshSimplifier;
+
+		*result = indices;
+		if (indices.size() < 3 || indices.size() <= targetIndexCount)
+			return 0.0f;
+
+		unsigned int vertexCount = (unsigned int)vertices.size();
+
+		// Positions, centered and scaled to the unit sphere so errors don't depend on the scale of the mesh
+		vector<float> positions(vertexCount * 3);
+		{
+			float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+			float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			for (unsigned int index : indices)
+			{
+				for (unsigned int k = 0; k < 3; k++)
+				{
+					min[k] = std::min(min[k], vertices[index].pos[k]);
+					max[k] = std::max(max[k], vertices[index].pos[k]);
+				}
+			}
+
+			float center[3] = { (min[0] + max[0]) * 0.5f, (min[1] + max[1]) * 0.5f, (min[2] + max[2]) * 0.5f };
+			float extents[3] = { max[0] - center[0], max[1] - center[1], max[2] - center[2] };
+			float radius	= sqrtf(extents[0] * extents[0] + extents[1] * extents[1] + extents[2] * extents[2]);
+			float scale		= radius > 0.0f ? 1.0f / radius : 0.0f;
+			for (unsigned int i = 0; i < vertexCount; i++)
+			{
+				for (unsigned int k = 0; k < 3; k++)
+				{
+					positions[i * 3 + k] = (vertices[i].pos[k] - center[k]) * scale;
+				}
+			}
+		}
+
+		// Vertices that share a position (differing in other attributes) map to the first of them
+		vector<unsigned int> remap(vertexCount, invalid);
+		vector<unsigned int> wedges(vertexCount, 0);
+		{
+			unsigned int tableSize = 1;
+			while (tableSize < vertexCount * 2)
+			{
+				tableSize *= 2;
+			}
+			vector<unsigned int> table(tableSize, invalid);
+			for (unsigned int index : indices)
+			{
+				if (remap[index] != invalid)
+					continue;
+
+				const float* position	= vertices[index].pos;
+				unsigned int slot		= (unsigned int)Hash::Compute(position, sizeof(float) * 3) & (tableSize - 1);
+				while (table[slot] != invalid && memcmp(vertices[table[slot]].pos, position, sizeof(float) * 3) != 0)
+				{
+					slot = (slot + 1) & (tableSize - 1);
+				}
+
+				if (table[slot] == invalid)
+				{
+					table[slot] = index;
+				}
+				remap[index] = table[slot];
+				wedges[table[slot]]++;
+			}
+		}
+
+		// Directed edges (between positions) leaving every position
+		unsigned int cornerCount = (unsigned int)indices.size();
+		vector<unsigned int> edgeOffsets(vertexCount + 1, 0);
+		vector<unsigned int> edges(cornerCount);
+		{
+			for (unsigned int i = 0; i < cornerCount; i++)
+			{
+				edgeOffsets[remap[indices[i]] + 1]++;
+			}
+			for (unsigned int i = 0; i < vertexCount; i++)
+			{
+				edgeOffsets[i + 1] += edgeOffsets[i];
+			}
+			vector<unsigned int> cursor(edgeOffsets.begin(), edgeOffsets.end() - 1);
+			for (unsigned int i = 0; i < cornerCount; i++)
+			{
+				unsigned int next = i % 3 == 2 ? i - 2 : i + 1;
+				edges[cursor[remap[indices[i]]]++] = remap[indices[next]];
+			}
+		}
+
+		// Classify the positions. An edge without a twin going the other way is a border, one that appears twice is non-manifold.
+		vector<unsigned char> kinds(vertexCount, Vertex_Manifold);
+		vector<bool> borderCorners(cornerCount, false);
+		{
+			vector<unsigned char> borderOut(vertexCount, 0);
+			vector<unsigned char> borderIn(vertexCount, 0);
+			for (unsigned int i = 0; i < cornerCount; i++)
+			{
+				unsigned int a = remap[indices[i]];
+				unsigned int b = remap[indices[i % 3 == 2 ? i - 2 : i + 1]];
+
+				unsigned int count = 0;
+				for (unsigned int e = edgeOffsets[a]; e < edgeOffsets[a + 1]; e++)
+				{
+					count += edges[e] == b ? 1 : 0;
+				}
+
+				bool twin = false;
+				for (unsigned int e = edgeOffsets[b]; e < edgeOffsets[b + 1] && !twin; e++)
+				{
+					twin = edges[e] == a;
+				}
+
+				if (count > 1)
+				{
+					kinds[a] = kinds[b] = Vertex_Locked;
+				}
+				else if (!twin)
+				{
+					borderCorners[i] = true;
+					borderOut[a] = (unsigned char)std::min(borderOut[a] + 1, 255);
+					borderIn[b] = (unsigned char)std::min(borderIn[b] + 1, 255);
+				}
+			}
+
+			for (unsigned int i = 0; i < vertexCount; i++)
+			{
+				if (remap[i] != i)
+					continue;
+
+				if (wedges[i] > 1 || borderOut[i] > 1 || borderOut[i] != borderIn[i])
+				{
+					kinds[i] = Vertex_Locked;
+				}
+				else if (borderOut[i] == 1 && kinds[i] != Vertex_Locked)
+				{
+					kinds[i] = Vertex_Border;
+				}
+			}
+		}
+
+		// Quadrics of the triangle planes, and of planes perpendicular to the borders so they keep their shape
+		vector<Quadric> quadrics(vertexCount);
+		for (unsigned int i = 0; i < cornerCount; i += 3)
+		{
+			const float* p[3] = { &positions[remap[indices[i]] * 3], &positions[remap[indices[i + 1]] * 3], &positions[remap[indices[i + 2]] * 3] };
+
+			float normal[3];
+			TriangleNormal(p[0], p[1], p[2], normal);
+			float area = Normalize(normal) * 0.5f;
+			Quadric plane(normal, -(normal[0] * p[0][0] + normal[1] * p[0][1] + normal[2] * p[0][2]), area);
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				quadrics[remap[indices[i + k]]] += plane;
+			}
+
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				if (!borderCorners[i + k])
+					continue;
+
+				const float* a	= p[k];
+				const float* b	= p[(k + 1) % 3];
+				float edge[3]	= { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+				float length	= sqrtf(edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2]);
+				float perpendicular[3];
+				Cross(edge, normal, perpendicular);
+				Normalize(perpendicular);
+
+				Quadric border(perpendicular, -(perpendicular[0] * a[0] + perpendicular[1] * a[1] + perpendicular[2] * a[2]), length * length * borderWeight);
+				quadrics[remap[indices[i + k]]]				+= border;
+				quadrics[remap[indices[i + (k + 1) % 3]]]	+= border;
+			}
+		}
+
+		// Collapse in passes. Every pass collapses the cheapest edges whose ends haven't moved yet in that pass, then removes what degenerated.
+		float errorLimit	= targetError * targetError;
+		float errorMax		= 0.0f;
+		vector<unsigned int> triangleOffsets(vertexCount + 1);
+		vector<unsigned int> triangles;
+		vector<Collapse> collapses;
+		vector<unsigned int> collapseRemap(vertexCount);
+		vector<bool> moved(vertexCount);
+		while (result->size() > targetIndexCount)
+		{
+			const vector<unsigned int>& current = *result;
+			unsigned int currentCorners = (unsigned int)current.size();
+
+			// The triangles around every vertex
+			fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+			for (unsigned int index : current)
+			{
+				triangleOffsets[index + 1]++;
+			}
+			for (unsigned int i = 0; i < vertexCount; i++)
+			{
+				triangleOffsets[i + 1] += triangleOffsets[i];
+			}
+			triangles.resize(currentCorners);
+			{
+				vector<unsigned int> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+				for (unsigned int i = 0; i < currentCorners; i++)
+				{
+					triangles[cursor[current[i]]++] = i / 3;
+				}
+			}
+
+			// Triangles around a vertex that also touch a position, 1 along a border and 2 elsewhere
+			auto sharedTriangles = [&](unsigned int vertex, unsigned int position)
+			{
+				unsigned int count = 0;
+				for (unsigned int t = triangleOffsets[vertex]; t < triangleOffsets[vertex + 1]; t++)
+				{
+					unsigned int triangle = triangles[t];
+					for (unsigned int k = 0; k < 3; k++)
+					{
+						if (remap[current[triangle * 3 + k]] == position)
+						{
+							count++;
+							break;
+						}
+					}
+				}
+				return count;
+			};
+
+			auto canCollapse = [&](unsigned int from, unsigned int to)
+			{
+				unsigned char kind = kinds[remap[from]];
+				return kind == Vertex_Manifold || (kind == Vertex_Border && kinds[remap[to]] != Vertex_Manifold && sharedTriangles(from, remap[to]) == 1);
+			};
+
+			auto collapseError = [&](unsigned int from, unsigned int to)
+			{
+				const Quadric& a	= quadrics[remap[from]];
+				const Quadric& b	= quadrics[remap[to]];
+				const float* p		= &positions[remap[to] * 3];
+				float weight		= a.w + b.w;
+				return weight > 0.0f ? (a.Evaluate(p) + b.Evaluate(p)) / weight : 0.0f;
+			};
+
+			// Every edge once (twins are skipped), in its cheaper direction
+			collapses.clear();
+			for (unsigned int i = 0; i < currentCorners; i++)
+			{
+				unsigned int a = current[i];
+				unsigned int b = current[i % 3 == 2 ? i - 2 : i + 1];
+				if (remap[a] == remap[b] || (remap[a] > remap[b] && sharedTriangles(a, remap[b]) > 1))
+					continue;
+
+				Collapse collapse = { invalid, invalid, FLT_MAX };
+				if (canCollapse(a, b))
+				{
+					collapse = { a, b, collapseError(a, b) };
+				}
+				if (canCollapse(b, a))
+				{
+					float error = collapseError(b, a);
+					if (error < collapse.error)
+					{
+						collapse = { b, a, error };
+					}
+				}
+
+				if (collapse.from != invalid && collapse.error <= errorLimit)
+				{
+					collapses.emplace_back(collapse);
+				}
+			}
+
+			if (collapses.empty())
+				break;
+
+			sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+			// Collapse until enough triangles are gone
+			unsigned int trianglesToRemove	= (currentCorners - targetIndexCount) / 3;
+			unsigned int trianglesRemoved	= 0;
+			unsigned int collapseCount		= 0;
+			for (unsigned int i = 0; i < vertexCount; i++)
+			{
+				collapseRemap[i] = i;
+			}
+			fill(moved.begin(), moved.end(), false);
+			for (const auto& collapse : collapses)
+			{
+				if (trianglesRemoved >= trianglesToRemove)
+					break;
+
+				unsigned int from	= collapse.from;
+				unsigned int to		= collapse.to;
+				if (moved[remap[from]] || moved[remap[to]])
+					continue;
+
+				// Reject collapses that would flip a triangle that survives them
+				const float* target = &positions[remap[to] * 3];
+				bool flips = false;
+				for (unsigned int t = triangleOffsets[from]; t < triangleOffsets[from + 1] && !flips; t++)
+				{
+					unsigned int triangle	= triangles[t];
+					const float* p[3];
+					bool degenerates		= false;
+					unsigned int corner		= 0;
+					for (unsigned int k = 0; k < 3; k++)
+					{
+						unsigned int index	= current[triangle * 3 + k];
+						p[k]				= &positions[remap[index] * 3];
+						degenerates			|= remap[index] == remap[to];
+						corner				= index == from ? k : corner;
+					}
+					if (degenerates)
+						continue;
+
+					float before[3], after[3];
+					TriangleNormal(p[0], p[1], p[2], before);
+					p[corner] = target;
+					TriangleNormal(p[0], p[1], p[2], after);
+					flips = before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0f;
+				}
+				if (flips)
+					continue;
+
+				collapseRemap[from]			= to;
+				quadrics[remap[to]]			+= quadrics[remap[from]];
+				moved[remap[from]]			= true;
+				moved[remap[to]]			= true;
+				trianglesRemoved			+= sharedTriangles(from, remap[to]);
+				errorMax					= std::max(errorMax, collapse.error);
+				collapseCount++;
+			}
+
+			if (collapseCount == 0)
+				break;
+
+			// Apply and drop the triangles that lost an edge
+			vector<unsigned int>& output	= *result;
+			unsigned int outputCorners		= 0;
+			for (unsigned int i = 0; i < currentCorners; i += 3)
+			{
+				unsigned int i0 = collapseRemap[current[i]];
+				unsigned int i1 = collapseRemap[current[i + 1]];
+				unsigned int i2 = collapseRemap[current[i + 2]];
+				if (remap[i0] == remap[i1] || remap[i1] == remap[i2] || remap[i0] == remap[i2])
+					continue;
+
+				output[outputCorners++] = i0;
+				output[outputCorners++] = i1;
+				output[outputCorners++] = i2;
+			}
+			output.resize(outputCorners);
+		}
+
+		return sqrtf(errorMax);
+	}
+}
@@ -0,0 +1,48 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <vector>
+#include "../Core/EngineDefs.h"
+#include "../RHI/RHI_Definition.h"
+//=============================
+
+namespace Directus
+{
+	// Quadric error metric simplification (Garland and Heckbert) by edge collapse, for generating levels of detail.
+	// Vertices never move, a collapse snaps one vertex onto a neighbour, so every level indexes into the same vertices.
+	// Borders only collapse along themselves and vertices on attribute seams (UV, normal) are kept, so both survive intact.
+	class ENGINE_CLASS MeshSimplifier
+	{
+	public:
+		// Collapses edges, cheapest first, until the index count reaches target or the next collapse would exceed targetError.
+		// Errors are distances relative to the radius of the mesh's bounding box, the return value is the largest one that was accepted.
+		static float Simplify(
+			const std::vector<RHI_Vertex_PosUVTBN>& vertices,
+			const std::vector<unsigned int>& indices,
+			unsigned int targetIndexCount,
+			float targetError,
+			std::vector<unsigned int>* result
+		);
+	};
+}
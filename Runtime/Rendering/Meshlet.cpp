@@ -0,0 +1,296 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==================
+#include "Meshlet.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include "../RHI/RHI_Vertex.h"
+//=============================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus::Math;
+//=============================
+
+namespace Directus
+{
+	namespace _Meshlet
+	{
+		// Cones narrower than this (the smallest dot product of a normal with the axis) aren't worth testing
+		static const float minConeDot		= 0.1f;
+		static const unsigned int invalid	= 0xffffffff;
+
+		// Interleaves the low 10 bits of each coordinate
+		inline uint32_t Morton(uint32_t x, uint32_t y, uint32_t z)
+		{
+			auto spread = [](uint32_t v)
+			{
+				v = (v | (v << 16)) & 0x030000ff;
+				v = (v | (v << 8)) & 0x0300f00f;
+				v = (v | (v << 4)) & 0x030c30c3;
+				v = (v | (v << 2)) & 0x09249249;
+				return v;
+			};
+			return spread(x & 1023) | (spread(y & 1023) << 1) | (spread(z & 1023) << 2);
+		}
+
+		inline Vector3 Position(const RHI_Vertex_PosUVTBN& vertex) { return Vector3(vertex.pos[0], vertex.pos[1], vertex.pos[2]); }
+
+		void ComputeBounds(const vector<RHI_Vertex_PosUVTBN>& vertices, const vector<unsigned int>& indices, Meshlet* meshlet)
+		{
+			unsigned int begin	= meshlet->indexOffset;
+			unsigned int end	= meshlet->indexOffset + meshlet->indexCount;
+
+			// Sphere around the center of the box
+			Vector3 min = Vector3::Infinity;
+			Vector3 max = Vector3::InfinityNeg;
+			for (unsigned int i = begin; i < end; i++)
+			{
+				Vector3 position = Position(vertices[indices[i]]);
+				min = Vector3(std::min(min.x, position.x), std::min(min.y, position.y), std::min(min.z, position.z));
+				max = Vector3(std::max(max.x, position.x), std::max(max.y, position.y), std::max(max.z, position.z));
+			}
+			meshlet->center = (min + max) * 0.5f;
+			meshlet->radius = 0.0f;
+			for (unsigned int i = begin; i < end; i++)
+			{
+				meshlet->radius = std::max(meshlet->radius, Vector3::Length(meshlet->center, Position(vertices[indices[i]])));
+			}
+
+			// Cone around the average normal
+			vector<Vector3> normals;
+			normals.reserve(meshlet->indexCount / 3);
+			Vector3 axis = Vector3::Zero;
+			for (unsigned int i = begin; i < end; i += 3)
+			{
+				Vector3 p0		= Position(vertices[indices[i]]);
+				Vector3 normal	= Vector3::Cross(Position(vertices[indices[i + 1]]) - p0, Position(vertices[indices[i + 2]]) - p0);
+				float length	= normal.Length();
+				if (length <= 0.0f)
+					continue;
+
+				normals.emplace_back(normal / length);
+				axis += normals.back();
+			}
+
+			meshlet->coneCutoff = 1.0f;
+			if (axis.Length() <= 0.0f)
+				return;
+
+			axis.Normalize();
+			float minDot = 1.0f;
+			for (const auto& normal : normals)
+			{
+				minDot = std::min(minDot, Vector3::Dot(axis, normal));
+			}
+
+			meshlet->coneAxis = axis;
+			if (minDot >= minConeDot)
+			{
+				meshlet->coneCutoff = sqrtf(1.0f - minDot * minDot);
+			}
+		}
+	}
+
+	void MeshletBuilder::Build(const vector<RHI_Vertex_PosUVTBN>& vertices, vector<unsigned int>* indices, vector<Meshlet>* meshlets, unsigned int maxVertices, unsigned int maxTriangles)
+	{
+		meshlets->clear();
+		unsigned int triangleCount = (unsigned int)indices->size() / 3;
+		if (triangleCount == 0)
+			return;
+
+		// The triangles around every vertex
+		unsigned int vertexCount = (unsigned int)vertices.size();
+		vector<unsigned int> offsets(vertexCount + 1, 0);
+		vector<unsigned int> adjacency(triangleCount * 3);
+		{
+			for (unsigned int i = 0; i < triangleCount * 3; i++)
+			{
+				offsets[(*indices)[i] + 1]++;
+			}
+			for (unsigned int i = 0; i < vertexCount; i++)
+			{
+				offsets[i + 1] += offsets[i];
+			}
+			vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+			for (unsigned int i = 0; i < triangleCount * 3; i++)
+			{
+				adjacency[cursor[(*indices)[i]]++] = i / 3;
+			}
+		}
+
+		// Grow every meshlet from a seed triangle (the first one left, which keeps the vertex cache order roughly intact)
+		// by the neighbouring triangle that adds the fewest vertices, so meshlets come out compact and their bounds tight.
+		vector<unsigned int> output;
+		output.reserve(indices->size());
+		vector<bool> emitted(triangleCount, false);
+		vector<unsigned int> owners(vertexCount, _Meshlet::invalid); // The meshlet every vertex was last added to
+		vector<unsigned int> meshletVertices;
+		unsigned int seed = 0;
+		while (true)
+		{
+			while (seed < triangleCount && emitted[seed])
+			{
+				seed++;
+			}
+			if (seed == triangleCount)
+				break;
+
+			unsigned int current	= (unsigned int)meshlets->size();
+			Meshlet meshlet;
+			meshlet.indexOffset		= (unsigned int)output.size();
+			meshletVertices.clear();
+
+			unsigned int triangle = seed;
+			while (triangle != _Meshlet::invalid)
+			{
+				for (unsigned int k = 0; k < 3; k++)
+				{
+					unsigned int vertex = (*indices)[triangle * 3 + k];
+					output.emplace_back(vertex);
+					if (owners[vertex] != current)
+					{
+						owners[vertex] = current;
+						meshletVertices.emplace_back(vertex);
+					}
+				}
+				emitted[triangle]	= true;
+				meshlet.indexCount	+= 3;
+				if (meshlet.indexCount / 3 == maxTriangles)
+					break;
+
+				// Candidates around the last triangle first, around the whole meshlet if those are used up
+				unsigned int best		= _Meshlet::invalid;
+				unsigned int bestCost	= 4;
+				auto consider = [&](unsigned int vertex)
+				{
+					for (unsigned int i = offsets[vertex]; i < offsets[vertex + 1]; i++)
+					{
+						unsigned int candidate = adjacency[i];
+						if (emitted[candidate])
+							continue;
+
+						unsigned int cost = 0;
+						for (unsigned int k = 0; k < 3; k++)
+						{
+							cost += owners[(*indices)[candidate * 3 + k]] != current ? 1 : 0;
+						}
+						if (cost < bestCost && meshletVertices.size() + cost <= maxVertices)
+						{
+							best		= candidate;
+							bestCost	= cost;
+						}
+					}
+				};
+
+				unsigned int last = triangle;
+				for (unsigned int k = 0; k < 3; k++)
+				{
+					consider((*indices)[last * 3 + k]);
+				}
+				if (best == _Meshlet::invalid)
+				{
+					for (unsigned int vertex : meshletVertices)
+					{
+						consider(vertex);
+					}
+				}
+				triangle = best;
+			}
+
+			meshlets->emplace_back(meshlet);
+		}
+
+		for (auto& meshlet : *meshlets)
+		{
+			_Meshlet::ComputeBounds(vertices, output, &meshlet);
+		}
+
+		// Order the meshlets along a Morton curve, so the ones that survive culling together tend to be neighbours in the
+		// index buffer as well, and merge into fewer draws
+		Vector3 min = Vector3::Infinity;
+		Vector3 max = Vector3::InfinityNeg;
+		for (const auto& meshlet : *meshlets)
+		{
+			min = Vector3(std::min(min.x, meshlet.center.x), std::min(min.y, meshlet.center.y), std::min(min.z, meshlet.center.z));
+			max = Vector3(std::max(max.x, meshlet.center.x), std::max(max.y, meshlet.center.y), std::max(max.z, meshlet.center.z));
+		}
+		Vector3 size = max - min;
+		float scale = 1023.0f / std::max(std::max(std::max(size.x, size.y), size.z), FLT_MIN);
+		vector<pair<uint32_t, unsigned int>> keys(meshlets->size());
+		for (unsigned int i = 0; i < (unsigned int)meshlets->size(); i++)
+		{
+			Vector3 cell	= ((*meshlets)[i].center - min) * scale;
+			keys[i]			= { _Meshlet::Morton((uint32_t)cell.x, (uint32_t)cell.y, (uint32_t)cell.z), i };
+		}
+		sort(keys.begin(), keys.end());
+
+		vector<Meshlet> sorted;
+		sorted.reserve(meshlets->size());
+		indices->clear();
+		for (const auto& key : keys)
+		{
+			Meshlet meshlet		= (*meshlets)[key.second];
+			unsigned int begin	= meshlet.indexOffset;
+			meshlet.indexOffset	= (unsigned int)indices->size();
+			indices->insert(indices->end(), output.begin() + begin, output.begin() + begin + meshlet.indexCount);
+			sorted.emplace_back(meshlet);
+		}
+		meshlets->swap(sorted);
+	}
+
+	void MeshletBuilder::BuildGroups(const vector<Meshlet>& meshlets, vector<MeshletGroup>* groups, unsigned int groupSize)
+	{
+		groups->clear();
+		for (unsigned int first = 0; first < (unsigned int)meshlets.size(); first += groupSize)
+		{
+			MeshletGroup group;
+			group.first = first;
+			group.count = std::min(groupSize, (unsigned int)meshlets.size() - first);
+
+			// Sphere around the box of the member spheres
+			Vector3 min = Vector3::Infinity;
+			Vector3 max = Vector3::InfinityNeg;
+			for (unsigned int i = first; i < first + group.count; i++)
+			{
+				const Vector3& center	= meshlets[i].center;
+				float radius			= meshlets[i].radius;
+				min = Vector3(std::min(min.x, center.x - radius), std::min(min.y, center.y - radius), std::min(min.z, center.z - radius));
+				max = Vector3(std::max(max.x, center.x + radius), std::max(max.y, center.y + radius), std::max(max.z, center.z + radius));
+			}
+			group.center = (min + max) * 0.5f;
+			for (unsigned int i = first; i < first + group.count; i++)
+			{
+				group.radius = std::max(group.radius, Vector3::Length(group.center, meshlets[i].center) + meshlets[i].radius);
+			}
+
+			groups->emplace_back(group);
+		}
+	}
+
+	bool MeshletBuilder::IsBackFacing(const Meshlet& meshlet, const Vector3& cameraPosition)
+	{
+		Vector3 direction = meshlet.center - cameraPosition;
+		return Vector3::Dot(direction, meshlet.coneAxis) >= meshlet.coneCutoff * direction.Length() + meshlet.radius;
+	}
+}
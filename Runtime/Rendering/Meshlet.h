@@ -0,0 +1,80 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <vector>
+#include "../Core/EngineDefs.h"
+#include "../RHI/RHI_Definition.h"
+#include "../Math/Vector3.h"
+//=============================
+
+namespace Directus
+{
+	// A run of consecutive, neighbouring, triangles with a bounded number of vertices, small enough to be culled on its own
+	struct Meshlet
+	{
+		unsigned int indexOffset	= 0; // Relative to the geometry the meshlet belongs to
+		unsigned int indexCount		= 0;
+		Math::Vector3 center;
+		float radius				= 0.0f;
+		// The normals lie within a cone around the axis. The cutoff is the cosine of the widest angle between the axis and
+		// a view direction from which every triangle faces away, 1 when the cone is too wide for there to be one.
+		Math::Vector3 coneAxis;
+		float coneCutoff			= 1.0f;
+	};
+
+	// Bounds of consecutive meshlets, so culling can accept or reject them together
+	struct MeshletGroup
+	{
+		unsigned int first	= 0;
+		unsigned int count	= 0;
+		Math::Vector3 center;
+		float radius		= 0.0f;
+	};
+
+	// Meshlets of one geometry (full detail or a level of detail)
+	struct GeometryMeshlets
+	{
+		std::vector<Meshlet> meshlets;
+		std::vector<MeshletGroup> groups;
+	};
+
+	class ENGINE_CLASS MeshletBuilder
+	{
+	public:
+		// Groups the triangles into meshlets and reorders them so every meshlet is a contiguous run
+		static void Build(
+			const std::vector<RHI_Vertex_PosUVTBN>& vertices,
+			std::vector<unsigned int>* indices,
+			std::vector<Meshlet>* meshlets,
+			unsigned int maxVertices	= 64,
+			unsigned int maxTriangles	= 124
+		);
+
+		// Groups consecutive meshlets (which Build orders along a space filling curve, so they are close to each other)
+		static void BuildGroups(const std::vector<Meshlet>& meshlets, std::vector<MeshletGroup>* groups, unsigned int groupSize = 32);
+
+		// Every triangle of the meshlet faces away from a camera at cameraPosition (in the same space as the meshlet)
+		static bool IsBackFacing(const Meshlet& meshlet, const Math::Vector3& cameraPosition);
+	};
+}
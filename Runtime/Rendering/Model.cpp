@@ -44,6 +44,13 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace _Model
+	{
+		static const char* sectionVerticesPacked	= "vertices_packed";
+		static const char* sectionLods				= "lods";
+		static const char* sectionMeshlets			= "meshlets";
+	}
+
 	Model::Model(Context* context) : IResource(context, Resource_Model)
 	{
 		m_normalizedScale	= 1.0f;
@@ -104,7 +111,57 @@ namespace Directus
 		file->Write(GetResourceFilePath());
 		file->Write(m_normalizedScale);
 		file->Write(m_mesh->Indices_Get());
-		file->Write(m_mesh->Vertices_Get());	
+		if (m_mesh->Vertices_GetPacking() == Vertex_Packing_None)
+		{
+			file->Write(m_mesh->Vertices_Get());
+		}
+		else
+		{
+			// No unpacked vertices, so older versions read an empty model rather than garbage
+			file->Write(vector<RHI_Vertex_PosUVTBN>());
+			file->Section_Begin(_Model::sectionVerticesPacked);
+			file->Write((unsigned int)m_mesh->Vertices_GetPacking());
+			file->Write(m_mesh->Vertices_GetPackingBounds());
+			file->Write(m_mesh->Vertices_GetPacked());
+		}
+
+		// The levels of detail are part of the indices already, this is where to find them
+		if (!m_lods.empty())
+		{
+			file->Section_Begin(_Model::sectionLods);
+			file->Write((unsigned int)m_lods.size());
+			for (const auto& chain : m_lods)
+			{
+				file->Write(chain.first);
+				file->Write((unsigned int)chain.second.size());
+				for (const auto& lod : chain.second)
+				{
+					file->Write(lod.indexOffset);
+					file->Write(lod.indexCount);
+					file->Write(lod.error);
+				}
+			}
+		}
+
+		if (!m_meshlets.empty())
+		{
+			file->Section_Begin(_Model::sectionMeshlets);
+			file->Write((unsigned int)m_meshlets.size());
+			for (const auto& geometry : m_meshlets)
+			{
+				file->Write(geometry.first);
+				file->Write((unsigned int)geometry.second.meshlets.size());
+				for (const auto& meshlet : geometry.second.meshlets)
+				{
+					file->Write(meshlet.indexOffset);
+					file->Write(meshlet.indexCount);
+					file->Write(meshlet.center);
+					file->Write(meshlet.radius);
+					file->Write(meshlet.coneAxis);
+					file->Write(meshlet.coneCutoff);
+				}
+			}
+		}
 
 		return true;
 	}
@@ -117,6 +174,34 @@ namespace Directus
 		m_mesh->Vertices_Append(vertices, vertexOffset);
 	}
 
+	void Model::Geometry_AppendLod(unsigned int indexOffset, const vector<unsigned int>& indices, float error)
+	{
+		GeometryLod lod;
+		m_mesh->Indices_Append(indices, &lod.indexOffset);
+		lod.indexCount	= (unsigned int)indices.size();
+		lod.error		= error;
+		m_lods[indexOffset].emplace_back(lod);
+	}
+
+	const vector<GeometryLod>* Model::Geometry_GetLods(unsigned int indexOffset)
+	{
+		auto it = m_lods.find(indexOffset);
+		return it != m_lods.end() ? &it->second : nullptr;
+	}
+
+	void Model::Geometry_SetMeshlets(unsigned int indexOffset, vector<Meshlet>&& meshlets)
+	{
+		auto& geometry		= m_meshlets[indexOffset];
+		geometry.meshlets	= move(meshlets);
+		MeshletBuilder::BuildGroups(geometry.meshlets, &geometry.groups);
+	}
+
+	const GeometryMeshlets* Model::Geometry_GetMeshlets(unsigned int indexOffset)
+	{
+		auto it = m_meshlets.find(indexOffset);
+		return it != m_meshlets.end() ? &it->second : nullptr;
+	}
+
 	void Model::Geometry_Get(unsigned int indexOffset, unsigned int indexCount, unsigned int vertexOffset, unsigned int vertexCount, vector<unsigned int>* indices, vector<RHI_Vertex_PosUVTBN>* vertices)
 	{
 		m_mesh->Geometry_Get(indexOffset, indexCount, vertexOffset, vertexCount, indices, vertices);
@@ -125,17 +210,18 @@ namespace Directus
 	void Model::Geometry_Update()
 	{
 		Geometry_CreateBuffers();
+		m_mesh->Vertices_Pack(m_vertexPacking);
 		m_normalizedScale	= Geometry_ComputeNormalizedScale();
 		m_memoryUsage		= Geometry_ComputeMemoryUsage();
-		m_aabb				= BoundingBox(m_mesh->Vertices_Get());
+		m_aabb				= m_mesh->Vertices_GetAABB();
 	}
 
-	void Model::AddMaterial(const weak_ptr<Material>& material, const weak_ptr<Actor>& actor, bool autoCache /* true */)
+	weak_ptr<Material> Model::AddMaterial(const weak_ptr<Material>& material, const weak_ptr<Actor>& actor, bool autoCache /* true */)
 	{
 		if (material.expired())
 		{
 			LOG_WARNING("Model::AddMaterial: Invalid parameters");
-			return;
+			return material;
 		}
 
 		// Create a file path for this material
@@ -156,6 +242,8 @@ namespace Directus
 			auto renderable = actor.lock()->AddComponent<Renderable>().lock();
 			renderable->Material_Set(matRef, false);
 		}
+
+		return matRef;
 	}
 
 	weak_ptr<Animation> Model::AddAnimation(weak_ptr<Animation> animation)
@@ -181,41 +269,61 @@ namespace Directus
 		if (material.expired())
 			return;
 
+		auto texture = ImportTexture(textureType, filePath);
+		if (!texture.expired())
+		{
+			material.lock()->SetTextureSlot(textureType, texture, false);
+		}
+	}
+
+	weak_ptr<RHI_Texture> Model::ImportTexture(TextureType textureType, const string& filePath)
+	{
 		// Validate texture file path
 		if (filePath == NOT_ASSIGNED)
 		{
-			LOG_WARNING("Model::AddTexture(): Provided texture file path hasn't been provided. Can't execute function");
-			return;
+			LOG_WARNING("Model::ImportTexture: Provided texture file path hasn't been provided. Can't execute function");
+			return weak_ptr<RHI_Texture>();
 		}
 
+		auto texName				= FileSystem::GetFileNameNoExtensionFromFilePath(filePath);
+		string modelRelativeTexPath	= m_modelDirectoryTextures + texName + EXTENSION_TEXTURE;
+
+		// Textures with the same file name end up in the same file, so the lookup and the caching must be one step for them
+		shared_ptr<mutex> importMutex;
+		{
+			lock_guard<mutex> lock(m_textureImportsMutex);
+			auto& entry = m_textureImports[modelRelativeTexPath];
+			if (!entry)
+			{
+				entry = make_shared<mutex>();
+			}
+			importMutex = entry;
+		}
+		lock_guard<mutex> importLock(*importMutex);
+
 		// Try to get the texture
-		auto texName = FileSystem::GetFileNameNoExtensionFromFilePath(filePath);
 		auto texture = m_context->GetSubsystem<ResourceManager>()->GetResourceByName<RHI_Texture>(texName).lock();
 		if (texture)
 		{
 			texture->SetTextureType(textureType); // if this texture was cached from the editor, it has no type, we have to set it
-			material.lock()->SetTextureSlot(textureType, texture, false);
+			return texture;
 		}
+
 		// If we didn't get a texture, it's not cached, hence we have to load it and cache it now
-		else if (!texture)
-		{
-			// Load texture
-			texture = make_shared<RHI_Texture>(m_context);
-			texture->LoadFromFile(filePath);
-			texture->SetTextureType(textureType);
-
-			// Update the texture with Model directory relative file path. Then save it to this directory
-			string modelRelativeTexPath = m_modelDirectoryTextures + texName + EXTENSION_TEXTURE;
-			texture->SetResourceFilePath(modelRelativeTexPath);
-			texture->SetResourceName(FileSystem::GetFileNameNoExtensionFromFilePath(modelRelativeTexPath));
-			texture->SaveToFile(modelRelativeTexPath);
-			// Now that the texture is saved, free up it's memory since we already have a shader resource
-			texture->ClearTextureBytes();
-
-			// Set the texture to the provided material
-			auto texWeak = texture->Cache<RHI_Texture>();
-			material.lock()->SetTextureSlot(textureType, texWeak, false);
-		}
+		// The type decides how the mips are filtered, it's set again once the texture knows whether it's grayscale
+		texture = make_shared<RHI_Texture>(m_context);
+		texture->SetTextureType(textureType);
+		texture->LoadFromFile(filePath);
+		texture->SetTextureType(textureType);
+
+		// Update the texture with Model directory relative file path. Then save it to this directory
+		texture->SetResourceFilePath(modelRelativeTexPath);
+		texture->SetResourceName(FileSystem::GetFileNameNoExtensionFromFilePath(modelRelativeTexPath));
+		texture->SaveToFile(modelRelativeTexPath);
+		// Now that the texture is saved, free up it's memory since we already have a shader resource
+		texture->ClearTextureBytes();
+
+		return texture->Cache<RHI_Texture>();
 	}
 
 	void Model::SetWorkingDirectory(const string& directory)
@@ -245,6 +353,53 @@ namespace Directus
 		file->Read(&m_normalizedScale);
 		file->Read(&m_mesh->Indices_Get());
 		file->Read(&m_mesh->Vertices_Get());
+		if (file->Section_Seek(_Model::sectionVerticesPacked))
+		{
+			BoundingBox bounds;
+			vector<std::byte> packed;
+			m_vertexPacking = (Vertex_Packing)file->ReadUInt();
+			file->Read(&bounds);
+			file->Read(&packed);
+			m_mesh->Vertices_SetPacked(m_vertexPacking, bounds, move(packed));
+		}
+
+		m_lods.clear();
+		if (file->Section_Seek(_Model::sectionLods))
+		{
+			unsigned int chainCount = file->ReadUInt();
+			for (unsigned int i = 0; i < chainCount; i++)
+			{
+				auto& chain = m_lods[file->ReadUInt()];
+				chain.resize(file->ReadUInt());
+				for (auto& lod : chain)
+				{
+					file->Read(&lod.indexOffset);
+					file->Read(&lod.indexCount);
+					file->Read(&lod.error);
+				}
+			}
+		}
+
+		m_meshlets.clear();
+		if (file->Section_Seek(_Model::sectionMeshlets))
+		{
+			unsigned int geometryCount = file->ReadUInt();
+			for (unsigned int i = 0; i < geometryCount; i++)
+			{
+				unsigned int indexOffset = file->ReadUInt();
+				vector<Meshlet> meshlets(file->ReadUInt());
+				for (auto& meshlet : meshlets)
+				{
+					file->Read(&meshlet.indexOffset);
+					file->Read(&meshlet.indexCount);
+					file->Read(&meshlet.center);
+					file->Read(&meshlet.radius);
+					file->Read(&meshlet.coneAxis);
+					file->Read(&meshlet.coneCutoff);
+				}
+				Geometry_SetMeshlets(indexOffset, move(meshlets));
+			}
+		}
 
 		Geometry_Update();
 
@@ -261,10 +416,12 @@ namespace Directus
 		// Load the model
 		if (m_resourceManager->GetModelImporter().lock()->Load(this, filePath))
 		{
-			// Set the normalized scale to the root actor's transform
+			// Set the normalized scale to the root actor's transform, like the rest of the world it's only modified on the main thread
 			m_normalizedScale = Geometry_ComputeNormalizedScale();
-			m_rootactor.lock()->GetComponent<Transform>().lock()->SetScale(m_normalizedScale);
-			m_rootactor.lock()->GetComponent<Transform>().lock()->UpdateTransform();
+			m_context->GetSubsystem<World>()->MainThread_Run([this]()
+			{
+				m_rootactor.lock()->GetComponent<Transform>().lock()->SetScale(m_normalizedScale);
+			});
 
 			// Save the model in our custom format.
 			SaveToFile(GetResourceFilePath());
@@ -280,8 +437,9 @@ namespace Directus
 		bool success = true;
 
 		// Get geometry
-		vector<unsigned int> indices			= m_mesh->Indices_Get();
-		vector<RHI_Vertex_PosUVTBN> vertices	= m_mesh->Vertices_Get();
+		vector<unsigned int> indices = m_mesh->Indices_Get();
+		vector<RHI_Vertex_PosUVTBN> vertices;
+		m_mesh->Vertices_Copy(&vertices);
 
 		if (!indices.empty())
 		{
@@ -24,9 +24,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <memory>
 #include <vector>
+#include <unordered_map>
+#include <mutex>
 #include "../RHI/RHI_Definition.h"
 #include "../Resource/IResource.h"
 #include "../Math/BoundingBox.h"
+#include "VertexPacking.h"
+#include "Meshlet.h"
 //================================
 
 namespace Directus
@@ -42,6 +46,14 @@ namespace Directus
 		class BoundingBox;
 	}
 
+	// A simplified version of a mesh, it indexes into the same vertices
+	struct GeometryLod
+	{
+		unsigned int indexOffset	= 0;
+		unsigned int indexCount		= 0;
+		float error					= 0.0f; // Relative to the radius of the mesh's bounding box
+	};
+
 	class ENGINE_CLASS Model : public IResource
 	{
 	public:
@@ -74,10 +86,34 @@ namespace Directus
 		);
 		void Geometry_Update();
 		const Math::BoundingBox& Geometry_AABB() { return m_aabb; }
+		// How the vertices are kept in memory and in the model file, takes effect on the next geometry update.
+		// Imported models get the ModelImporter's packing. The GPU always gets them unpacked.
+		void SetVertexPacking(Vertex_Packing packing)	{ m_vertexPacking = packing; }
+		Vertex_Packing GetVertexPacking()				{ return m_vertexPacking; }
 		//=========================================================
 
-		// Adds a new material
-		void AddMaterial(const std::weak_ptr<Material>& material, const std::weak_ptr<Actor>& actor, bool autoCache = true);
+		//= LEVEL OF DETAIL =======================================================================================
+		// Adds a level to the chain of the mesh whose full detail geometry starts at indexOffset (coarser levels last)
+		void Geometry_AppendLod(unsigned int indexOffset, const std::vector<unsigned int>& indices, float error);
+		// The levels after the full detail one, nullptr if the mesh has none
+		const std::vector<GeometryLod>* Geometry_GetLods(unsigned int indexOffset);
+		// How many levels (including the full detail one) and how many of the triangles each level keeps from the previous one.
+		// Takes effect when importing, set it before loading a foreign model.
+		void SetLodCount(unsigned int count)	{ m_lodCount = count; }
+		unsigned int GetLodCount()				{ return m_lodCount; }
+		void SetLodReduction(float reduction)	{ m_lodReduction = reduction; }
+		float GetLodReduction()					{ return m_lodReduction; }
+		//=========================================================================================================
+
+		//= MESHLETS ==============================================================================================
+		// The meshlets of the geometry (full detail or a level of detail) that starts at indexOffset, groups them as well
+		void Geometry_SetMeshlets(unsigned int indexOffset, std::vector<Meshlet>&& meshlets);
+		// nullptr if the geometry is too small to be split into meshlets
+		const GeometryMeshlets* Geometry_GetMeshlets(unsigned int indexOffset);
+		//=========================================================================================================
+
+		// Adds a new material (saved to the model directory) and returns the reference the actor (if any) uses
+		std::weak_ptr<Material> AddMaterial(const std::weak_ptr<Material>& material, const std::weak_ptr<Actor>& actor, bool autoCache = true);
 
 		// Adds a new animation
 		std::weak_ptr<Animation> AddAnimation(std::weak_ptr<Animation> animation);
@@ -85,6 +121,10 @@ namespace Directus
 		// Adds a texture (the material that uses this texture must be passed as well)
 		void AddTexture(const std::weak_ptr<Material>& material, TextureType textureType, const std::string& filePath);
 
+		// Loads a texture into the model directory and caches it, or returns the cached one. Safe to call from several threads,
+		// textures that end up in the same file (same file name) are imported once, the other callers get the cached one.
+		std::weak_ptr<RHI_Texture> ImportTexture(TextureType textureType, const std::string& filePath);
+
 		bool IsAnimated() { return m_isAnimated; }
 		void SetAnimated(bool isAnimated) { m_isAnimated = isAnimated; }
 
@@ -111,6 +151,11 @@ namespace Directus
 		std::shared_ptr<RHI_IndexBuffer> m_indexBuffer;
 		std::shared_ptr<Mesh> m_mesh;
 		Math::BoundingBox m_aabb;
+		Vertex_Packing m_vertexPacking = Vertex_Packing_None;
+		std::unordered_map<unsigned int, std::vector<GeometryLod>> m_lods; // By the index offset of the full detail geometry
+		std::unordered_map<unsigned int, GeometryMeshlets> m_meshlets; // By index offset, like the levels of detail
+		unsigned int m_lodCount	= 4;
+		float m_lodReduction	= 0.5f;
 		unsigned int meshCount;
 
 		// Material
@@ -124,6 +169,10 @@ namespace Directus
 		std::string m_modelDirectoryMaterials;
 		std::string m_modelDirectoryTextures;
 
+		// One lock per texture that ImportTexture() writes, by its file path
+		std::unordered_map<std::string, std::shared_ptr<std::mutex>> m_textureImports;
+		std::mutex m_textureImportsMutex;
+
 		// Misc
 		float m_normalizedScale;
 		unsigned int m_memoryUsage;		
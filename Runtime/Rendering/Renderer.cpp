@@ -19,12 +19,14 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ==============================
+//= INCLUDES ================================
 #include "Renderer.h"
+#include <cstring>
 #include "Rectangle.h"
 #include "Grid.h"
 #include "Font.h"
 #include "Deferred/ShaderVariation.h"
+#include "Deferred/ShaderVariationRegistry.h"
 #include "Deferred/LightShader.h"
 #include "Deferred/GBuffer.h"
 #include "../RHI/RHI_Device.h"
@@ -34,6 +36,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_PipelineState.h"
 #include "../RHI/RHI_RenderTexture.h"
 #include "../RHI/RHI_Shader.h"
+#include "../RHI/RHI_ShaderCache.h"
+#include "../World/World.h"
 #include "../World/Actor.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
@@ -43,7 +47,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Profiling/Profiler.h"
 #include "../Core/Context.h"
 #include "../Math/BoundingBox.h"
-//=========================================
+//===========================================
 
 //= NAMESPACES ================
 using namespace std;
@@ -56,7 +60,10 @@ using namespace Helper;
 
 namespace Directus
 {
-	static ResourceManager* g_resourceMng	= nullptr;
+	static ResourceManager* g_resourceMng		= nullptr;
+	static const uint64_t g_shaderCacheBudget	= 64 * 1024 * 1024;
+	// Seconds without a new compile before the shader cache is written
+	static const double g_shaderCacheSaveDelay	= 2.0;
 	unsigned long Renderer::m_flags;
 	bool Renderer::m_isRendering			= false;
 	uint64_t Renderer::m_frame				= 0;
@@ -81,6 +88,7 @@ namespace Directus
 		// Create RHI device
 		m_rhiDevice			= make_shared<RHI_Device>(drawHandle);
 		m_rhiPipelineState	= make_shared<RHI_PipelineState>(m_rhiDevice);
+		m_shaderVariations	= make_unique<ShaderVariationRegistry>(m_context, m_rhiDevice);
 
 		// Subscribe to events
 		SUBSCRIBE_TO_EVENT(EVENT_RENDER, EVENT_HANDLER(Render));
@@ -103,6 +111,9 @@ namespace Directus
 		string shaderDirectory	= g_resourceMng->GetStandardResourceDirectory(Resource_Shader);
 		string textureDirectory = g_resourceMng->GetStandardResourceDirectory(Resource_Texture);
 
+		// Compiled shaders persist between sessions, only new or changed ones are compiled
+		m_rhiDevice->SetShaderCache(make_shared<RHI_ShaderCache>(g_resourceMng->GetProjectDirectory() + "Shader_Cache.bin", g_shaderCacheBudget));
+
 		// Load a font (used for performance metrics)
 		m_font = make_unique<Font>(m_context, fontDir + "CalibriBold.ttf", 12, Vector4(0.7f, 0.7f, 0.7f, 1.0f));
 		// Make a grid (used in editor)
@@ -276,6 +287,12 @@ namespace Directus
 		Profiler::Get().Reset();
 		m_frame++;
 
+		// Written while running (not only on shutdown), so that a session that doesn't end cleanly keeps what it compiled
+		if (auto shaderCache = m_rhiDevice->GetShaderCache())
+		{
+			shaderCache->Save_Idle(g_shaderCacheSaveDelay);
+		}
+
 		// If there is a camera, render the scene
 		if (m_camera)
 		{
@@ -297,6 +314,10 @@ namespace Directus
 				return;
 			}
 
+			Renderables_Cull();
+			Renderables_Sort(Renderable_ObjectOpaque);
+			Renderables_Sort(Renderable_ObjectTransparent);
+
 			Pass_DepthDirectionalLight(GetLightDirectional());
 		
 			Pass_GBuffer();
@@ -479,70 +500,139 @@ namespace Directus
 			}
 		}
 
-		Renderables_Sort(&m_actors[Renderable_ObjectOpaque]);
-		Renderables_Sort(&m_actors[Renderable_ObjectTransparent]);
-
 		TIME_BLOCK_END_CPU();
 	}
 
-	void Renderer::Renderables_Sort(vector<Actor*>* renderables)
+	void Renderer::Renderables_Cull()
 	{
-		if (renderables->size() <= 2)
-			return;
+		TIME_BLOCK_START_CPU();
 
-		sort(renderables->begin(), renderables->end(),[](Actor* a, Actor* b)
+		// Query the world's bounding volume hierarchy instead of testing every renderable against the frustum
+		m_visibleRenderables.clear();
+		m_context->GetSubsystem<World>()->GetRenderablesBVH()->Query(m_camera->GetFrustum(), m_visibleRenderables);
+		// Pick a level of detail for whatever is visible, from the radius of its bounds on screen, then cull its meshlets
+		bool perspective		= m_camera->GetProjection() == Projection_Perspective;
+		float pixelsPerUnit		= m_camera->GetProjectionMatrix().m11 * Settings::Get().Resolution_GetHeight() * 0.5f; // At a distance of 1 for perspective
+		Vector3 cameraPosition	= m_camera->GetTransform()->GetPosition();
+		for (const auto& visible : m_visibleRenderables)
 		{
-			// Get renderable component
-			auto a_renderable = a->GetRenderable_PtrRaw();
-			auto b_renderable = b->GetRenderable_PtrRaw();
-
-			// Validate renderable components
-			if (!a_renderable || !b_renderable)
-				return false;
-
-			// Get geometry parents
-			auto a_geometryModel = a_renderable->Geometry_Model();
-			auto b_geometryModel = b_renderable->Geometry_Model();
-
-			// Validate geometry parents
-			if (!a_geometryModel || !b_geometryModel)
-				return false;
-
-			// Get materials
-			auto a_material = a_renderable->Material_PtrRaw();
-			auto b_material = b_renderable->Material_PtrRaw();
-
-			if (!a_material || !b_material)
-				return false;
-
-			// Get key for models
-			auto a_keyModel = a_geometryModel->Resource_GetID();
-			auto b_keyModel = b_geometryModel->Resource_GetID();
-
-			// Get key for shaders
-			auto a_keyShader = a_material->GetShader().lock()->Resource_GetID();
-			auto b_keyShader = b_material->GetShader().lock()->Resource_GetID();
-
-			// Get key for materials
-			auto a_keyMaterial = a_material->Resource_GetID();
-			auto b_keyMaterial = b_material->Resource_GetID();
-
-			auto a_key = 
-				(((unsigned long long)a_keyModel)		<< 48u)	| 
-				(((unsigned long long)a_keyShader)		<< 32u)	|
-				(((unsigned long long)a_keyMaterial)	<< 16u);
-
-			auto b_key = 
-				(((unsigned long long)b_keyModel)		<< 48u)	|
-				(((unsigned long long)b_keyShader)		<< 32u)	|
-				(((unsigned long long)b_keyMaterial)	<< 16u);
-	
-			return a_key < b_key;
-		});
+			auto renderable = static_cast<Renderable*>(visible);
+
+			const BoundingBox& box	= renderable->Geometry_BB();
+			float radius			= box.GetExtents().Length();
+			float distance			= perspective ? Max(Vector3::Length(cameraPosition, box.GetCenter()) - radius, m_nearPlane) : 1.0f;
+			renderable->Geometry_SelectLod(radius / distance * pixelsPerUnit);
+
+			if (renderable->Geometry_CullMeshlets(m_camera->GetFrustum(), cameraPosition))
+			{
+				renderable->SetVisibleFrame(m_frame);
+			}
+		}
+
+		TIME_BLOCK_END_CPU();
 	}
 	//==========================================================================================================
 
 	//= PASSES =================================================================================================
+	void Renderer::Renderables_Sort(RenderableType type)
+	{
+		TIME_BLOCK_START_CPU();
+
+		auto& actors = m_actors[type];
+		if (actors.size() <= 2)
+		{
+			TIME_BLOCK_END_CPU();
+			return;
+		}
+
+		// Key layout (most significant first)
+		// | pass: 3 | culled: 1 | depth: 12 | shader: 16 | material: 16 | model: 16 |
+		// Opaque objects sort front to back (early z), transparent objects back to front (blending)
+		bool backToFront		= type == Renderable_ObjectTransparent;
+		uint64_t pass			= (uint64_t)type & 0x7;
+		Vector3 cameraPosition	= m_camera->GetTransform()->GetPosition();
+		float depthScale		= m_farPlane > 0.0f ? 4095.0f / m_farPlane : 0.0f;
+
+		// Resource IDs don't fit in 16 bits, truncating them could put two different resources in the same group.
+		// Their indices are used instead, which are dense among the live resources of a type, so only the ones past
+		// 65535 live resources of one kind share the last index.
+		auto Index = [](IResource* resource) { return (uint64_t)Min(resource->Resource_GetIndex(), 0xFFFFu); };
+
+		// Compute every key once
+		m_drawItems.resize(actors.size());
+		for (unsigned int i = 0; i < (unsigned int)actors.size(); i++)
+		{
+			Actor* actor			= actors[i];
+			Renderable* renderable	= actor->GetRenderable_PtrRaw();
+			Material* material		= renderable ? renderable->Material_PtrRaw() : nullptr;
+			Model* model			= renderable ? renderable->Geometry_Model() : nullptr;
+			auto shader				= material ? material->GetShader().lock() : nullptr;
+
+			m_drawItems[i].actor = actor;
+
+			// Anything that can't be drawn goes to the end
+			if (!renderable || !material || !model || !shader)
+			{
+				m_drawItems[i].key = ~0ull;
+				continue;
+			}
+
+			uint64_t culled	= renderable->IsVisible(m_frame) ? 0 : 1;
+			float distance	= Clamp(Vector3::Length(cameraPosition, renderable->Geometry_BB().GetCenter()) * depthScale, 0.0f, 4095.0f);
+			uint64_t depth	= (uint64_t)distance;
+			if (backToFront)
+			{
+				depth = 4095 - depth;
+			}
+
+			m_drawItems[i].key =
+				(pass											<< 61u)	|
+				(culled											<< 60u)	|
+				(depth											<< 48u)	|
+				(Index(shader.get())							<< 32u)	|
+				(Index(material)								<< 16u)	|
+				(Index(model));
+		}
+
+		// LSD radix sort, one byte per pass, skipping bytes that are the same for every key
+		m_drawItemsScratch.resize(m_drawItems.size());
+		DrawItem* src = m_drawItems.data();
+		DrawItem* dst = m_drawItemsScratch.data();
+		unsigned int count = (unsigned int)m_drawItems.size();
+		for (unsigned int shift = 0; shift < 64; shift += 8)
+		{
+			unsigned int offsets[256] = { 0 };
+			for (unsigned int i = 0; i < count; i++)
+			{
+				offsets[(src[i].key >> shift) & 0xFF]++;
+			}
+
+			if (offsets[(src[0].key >> shift) & 0xFF] == count)
+				continue;
+
+			unsigned int sum = 0;
+			for (auto& offset : offsets)
+			{
+				unsigned int bucketCount = offset;
+				offset = sum;
+				sum += bucketCount;
+			}
+
+			for (unsigned int i = 0; i < count; i++)
+			{
+				dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+			}
+			swap(src, dst);
+		}
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			actors[i] = src[i].actor;
+		}
+
+		TIME_BLOCK_END_CPU();
+	}
+
 	void Renderer::Pass_DepthDirectionalLight(Light* light)
 	{
 		if (!light || !light->GetCastShadows())
@@ -665,7 +755,7 @@ namespace Directus
 				continue;
 
 			// Skip objects outside of the view frustum
-			if (!m_camera->IsInViewFrustrum(obj_renderable))
+			if (!obj_renderable->IsVisible(m_frame))
 				continue;
 
 			// set face culling (changes only if required)
@@ -721,7 +811,10 @@ namespace Directus
 			m_rhiPipelineState->Bind();
 
 			// Render	
-			m_rhiDevice->DrawIndexed(obj_renderable->Geometry_IndexCount(), obj_renderable->Geometry_IndexOffset(), obj_renderable->Geometry_VertexOffset());
+			for (const auto& range : obj_renderable->Geometry_Ranges())
+			{
+				m_rhiDevice->DrawIndexed(range.indexCount, range.indexOffset, obj_renderable->Geometry_VertexOffset());
+			}
 			Profiler::Get().m_rendererMeshesRendered++;
 
 		} // Actor/MESH ITERATION
@@ -882,7 +975,7 @@ namespace Directus
 				continue;
 
 			// Skip objects outside of the view frustum
-			if (!m_camera->IsInViewFrustrum(obj_renderable))
+			if (!obj_renderable->IsVisible(m_frame))
 				continue;
 
 			// Set face culling (changes only if required)
@@ -908,7 +1001,10 @@ namespace Directus
 			m_rhiPipelineState->Bind();
 
 			// Render	
-			m_rhiDevice->DrawIndexed(obj_renderable->Geometry_IndexCount(), obj_renderable->Geometry_IndexOffset(), obj_renderable->Geometry_VertexOffset());
+			for (const auto& range : obj_renderable->Geometry_Ranges())
+			{
+				m_rhiDevice->DrawIndexed(range.indexCount, range.indexOffset, obj_renderable->Geometry_VertexOffset());
+			}
 			Profiler::Get().m_rendererMeshesRendered++;
 
 		} // Actor/MESH ITERATION
@@ -39,6 +39,7 @@ namespace Directus
 	class GBuffer;
 	class Rectangle;
 	class LightShader;
+	class ShaderVariationRegistry;
 	class ResourceManager;
 	class Font;
 	class Variant;
@@ -120,6 +121,7 @@ namespace Directus
 
 		void Clear();
 		const std::shared_ptr<RHI_Device>& GetRHIDevice() { return m_rhiDevice; }
+		ShaderVariationRegistry* GetShaderVariations() { return m_shaderVariations.get(); }
 
 		static bool IsRendering()	{ return m_isRendering; }
 		static uint64_t GetFrame()	{ return m_frame; }
@@ -128,7 +130,8 @@ namespace Directus
 		void RenderTargets_Create(int width, int height);
 
 		void Renderables_Acquire(const Variant& renderables);
-		void Renderables_Sort(std::vector<Actor*>* renderables);
+		void Renderables_Cull();
+		void Renderables_Sort(RenderableType type);
 
 		void Pass_DepthDirectionalLight(Light* directionalLight);
 		void Pass_GBuffer();
@@ -190,6 +193,14 @@ namespace Directus
 
 		// RENDERABLES ==================================================
 		std::unordered_map<RenderableType, std::vector<Actor*>> m_actors;
+		std::vector<void*> m_visibleRenderables;
+		struct DrawItem
+		{
+			uint64_t key;
+			Actor* actor;
+		};
+		std::vector<DrawItem> m_drawItems;
+		std::vector<DrawItem> m_drawItemsScratch;
 		Math::Matrix m_mV;
 		Math::Matrix m_mP_perspective;
 		Math::Matrix m_mP_orthographic;
@@ -223,6 +234,7 @@ namespace Directus
 		//========================================================
 
 		//= SHADERS ============================================
+		std::unique_ptr<ShaderVariationRegistry> m_shaderVariations;
 		std::shared_ptr<LightShader> m_shaderLight;
 		std::shared_ptr<RHI_Shader> m_shaderLightDepth;
 		std::shared_ptr<RHI_Shader> m_shaderLine;
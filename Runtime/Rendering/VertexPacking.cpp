@@ -0,0 +1,375 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ====================
+#include "VertexPacking.h"
+#include <cmath>
+#include <cstring>
+#include "../RHI/RHI_Vertex.h"
+#include "../Math/BoundingBox.h"
+//===============================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus::Math;
+//=============================
+
+namespace Directus
+{
+	namespace _VertexPacking
+	{
+		static const float sqrt2 = 1.41421356f;
+
+		inline float Dot(const float* a, const float* b)				{ return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+		inline void Cross(const float* a, const float* b, float* out)	{ out[0] = a[1] * b[2] - a[2] * b[1]; out[1] = a[2] * b[0] - a[0] * b[2]; out[2] = a[0] * b[1] - a[1] * b[0]; }
+		inline bool Normalize(float* v)
+		{
+			float length = sqrtf(Dot(v, v));
+			if (length < 1e-12f)
+				return false;
+
+			v[0] /= length; v[1] /= length; v[2] /= length;
+			return true;
+		}
+
+		inline uint16_t ToUNorm16(float value, float scale)	{ float q = roundf(value * scale); return (uint16_t)(q < 0.0f ? 0.0f : (q > 65535.0f ? 65535.0f : q)); }
+		inline int16_t ToSNorm16(float value)				{ float q = roundf(value * 32767.0f); return (int16_t)(q < -32767.0f ? -32767.0f : (q > 32767.0f ? 32767.0f : q)); }
+
+		// An orthonormal tangent frame (the tangent is made perpendicular to the normal), and the handedness of the bitangent
+		inline float Frame(const RHI_Vertex_PosUVTBN& vertex, float* normal, float* tangent)
+		{
+			memcpy(normal, vertex.normal, sizeof(float) * 3);
+			memcpy(tangent, vertex.tangent, sizeof(float) * 3);
+			if (!Normalize(normal))
+			{
+				normal[0] = 0.0f; normal[1] = 0.0f; normal[2] = 1.0f;
+			}
+
+			float d = Dot(normal, tangent);
+			tangent[0] -= normal[0] * d; tangent[1] -= normal[1] * d; tangent[2] -= normal[2] * d;
+			if (!Normalize(tangent))
+			{
+				// Anything perpendicular to the normal will do
+				float axis[3] = { fabsf(normal[0]) < 0.9f ? 1.0f : 0.0f, fabsf(normal[0]) < 0.9f ? 0.0f : 1.0f, 0.0f };
+				Cross(axis, normal, tangent);
+				Normalize(tangent);
+			}
+
+			float bitangent[3];
+			Cross(normal, tangent, bitangent);
+			return Dot(bitangent, vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+		}
+
+		inline void PackPosition(const RHI_Vertex_PosUVTBN& vertex, const float* min, const float* scale, float sign, uint16_t* pos)
+		{
+			pos[0] = ToUNorm16(vertex.pos[0] - min[0], scale[0]);
+			pos[1] = ToUNorm16(vertex.pos[1] - min[1], scale[1]);
+			pos[2] = ToUNorm16(vertex.pos[2] - min[2], scale[2]);
+			pos[3] = sign < 0.0f ? 0 : 65535;
+		}
+
+		inline float UnpackPosition(const uint16_t* pos, const float* min, const float* step, RHI_Vertex_PosUVTBN* vertex)
+		{
+			vertex->pos[0] = min[0] + pos[0] * step[0];
+			vertex->pos[1] = min[1] + pos[1] * step[1];
+			vertex->pos[2] = min[2] + pos[2] * step[2];
+			return pos[3] == 0 ? -1.0f : 1.0f;
+		}
+
+		inline void UnpackBitangent(float sign, RHI_Vertex_PosUVTBN* vertex)
+		{
+			Cross(vertex->normal, vertex->tangent, vertex->bitangent);
+			vertex->bitangent[0] *= sign; vertex->bitangent[1] *= sign; vertex->bitangent[2] *= sign;
+		}
+
+		// The rotation from tangent space (tangent, bitangent, normal) as a quaternion, largest component dropped,
+		// the other three in 10 bits each and the index of the dropped one in the top 2 bits.
+		inline uint32_t QuaternionEncode(const float* tangent, const float* normal)
+		{
+			float bitangent[3];
+			Cross(normal, tangent, bitangent);
+
+			// Columns are the tangent, the bitangent and the normal
+			float m00 = tangent[0], m01 = bitangent[0], m02 = normal[0];
+			float m10 = tangent[1], m11 = bitangent[1], m12 = normal[1];
+			float m20 = tangent[2], m21 = bitangent[2], m22 = normal[2];
+
+			float q[4]; // x, y, z, w
+			float trace = m00 + m11 + m22;
+			if (trace > 0.0f)
+			{
+				float s = sqrtf(trace + 1.0f) * 2.0f;
+				q[3] = 0.25f * s; q[0] = (m21 - m12) / s; q[1] = (m02 - m20) / s; q[2] = (m10 - m01) / s;
+			}
+			else if (m00 > m11 && m00 > m22)
+			{
+				float s = sqrtf(1.0f + m00 - m11 - m22) * 2.0f;
+				q[3] = (m21 - m12) / s; q[0] = 0.25f * s; q[1] = (m01 + m10) / s; q[2] = (m02 + m20) / s;
+			}
+			else if (m11 > m22)
+			{
+				float s = sqrtf(1.0f + m11 - m00 - m22) * 2.0f;
+				q[3] = (m02 - m20) / s; q[0] = (m01 + m10) / s; q[1] = 0.25f * s; q[2] = (m12 + m21) / s;
+			}
+			else
+			{
+				float s = sqrtf(1.0f + m22 - m00 - m11) * 2.0f;
+				q[3] = (m10 - m01) / s; q[0] = (m02 + m20) / s; q[1] = (m12 + m21) / s; q[2] = 0.25f * s;
+			}
+
+			unsigned int largest = 0;
+			for (unsigned int i = 1; i < 4; i++)
+			{
+				largest = fabsf(q[i]) > fabsf(q[largest]) ? i : largest;
+			}
+			float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+			uint32_t encoded	= largest << 30;
+			unsigned int shift	= 20;
+			for (unsigned int i = 0; i < 4; i++)
+			{
+				if (i == largest)
+					continue;
+
+				// The other components are within +-1/sqrt(2)
+				float value		= (q[i] * sign * sqrt2) * 0.5f + 0.5f;
+				float quantized	= roundf(value * 1023.0f);
+				encoded			|= (uint32_t)(quantized < 0.0f ? 0.0f : (quantized > 1023.0f ? 1023.0f : quantized)) << shift;
+				shift			-= 10;
+			}
+
+			return encoded;
+		}
+
+		inline void QuaternionDecode(uint32_t encoded, float* tangent, float* normal)
+		{
+			unsigned int largest	= encoded >> 30;
+			unsigned int shift		= 20;
+			float q[4];
+			float sum = 0.0f;
+			for (unsigned int i = 0; i < 4; i++)
+			{
+				if (i == largest)
+					continue;
+
+				q[i]	= (((encoded >> shift) & 1023) / 1023.0f * 2.0f - 1.0f) / sqrt2;
+				sum		+= q[i] * q[i];
+				shift	-= 10;
+			}
+			q[largest] = sqrtf(sum < 1.0f ? 1.0f - sum : 0.0f);
+
+			float x = q[0], y = q[1], z = q[2], w = q[3];
+			tangent[0]	= 1.0f - 2.0f * (y * y + z * z);
+			tangent[1]	= 2.0f * (x * y + w * z);
+			tangent[2]	= 2.0f * (x * z - w * y);
+			normal[0]	= 2.0f * (x * z + w * y);
+			normal[1]	= 2.0f * (y * z - w * x);
+			normal[2]	= 1.0f - 2.0f * (x * x + y * y);
+		}
+	}
+
+	unsigned int VertexPacking::GetStride(Vertex_Packing packing)
+	{
+		if (packing == Vertex_Packing_Compact)	return sizeof(RHI_Vertex_Compact);
+		if (packing == Vertex_Packing_Small)	return sizeof(RHI_Vertex_Small);
+		return sizeof(RHI_Vertex_PosUVTBN);
+	}
+
+	void VertexPacking::Pack(const RHI_Vertex_PosUVTBN* vertices, unsigned int count, Vertex_Packing packing, const BoundingBox& bounds, std::byte* packed)
+	{
+		if (packing == Vertex_Packing_None)
+		{
+			memcpy(packed, vertices, sizeof(RHI_Vertex_PosUVTBN) * count);
+			return;
+		}
+
+		// A flat axis quantizes to 0
+		float min[3]	= { bounds.GetMin().x, bounds.GetMin().y, bounds.GetMin().z };
+		float extent[3]	= { bounds.GetMax().x - min[0], bounds.GetMax().y - min[1], bounds.GetMax().z - min[2] };
+		float scale[3];
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			scale[i] = extent[i] > 0.0f ? 65535.0f / extent[i] : 0.0f;
+		}
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			const RHI_Vertex_PosUVTBN& vertex = vertices[i];
+			float normal[3], tangent[3];
+			float sign = _VertexPacking::Frame(vertex, normal, tangent);
+
+			if (packing == Vertex_Packing_Compact)
+			{
+				auto& out = reinterpret_cast<RHI_Vertex_Compact*>(packed)[i];
+				_VertexPacking::PackPosition(vertex, min, scale, sign, out.pos);
+				out.uv[0] = FloatToHalf(vertex.uv[0]);
+				out.uv[1] = FloatToHalf(vertex.uv[1]);
+				OctahedralEncode(normal, out.normal);
+				OctahedralEncode(tangent, out.tangent);
+			}
+			else
+			{
+				auto& out = reinterpret_cast<RHI_Vertex_Small*>(packed)[i];
+				_VertexPacking::PackPosition(vertex, min, scale, sign, out.pos);
+				out.uv[0]	= FloatToHalf(vertex.uv[0]);
+				out.uv[1]	= FloatToHalf(vertex.uv[1]);
+				out.frame	= _VertexPacking::QuaternionEncode(tangent, normal);
+			}
+		}
+	}
+
+	void VertexPacking::Unpack(const std::byte* packed, unsigned int count, Vertex_Packing packing, const BoundingBox& bounds, RHI_Vertex_PosUVTBN* vertices)
+	{
+		if (packing == Vertex_Packing_None)
+		{
+			memcpy(vertices, packed, sizeof(RHI_Vertex_PosUVTBN) * count);
+			return;
+		}
+
+		float min[3]	= { bounds.GetMin().x, bounds.GetMin().y, bounds.GetMin().z };
+		float step[3]	= { (bounds.GetMax().x - min[0]) / 65535.0f, (bounds.GetMax().y - min[1]) / 65535.0f, (bounds.GetMax().z - min[2]) / 65535.0f };
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			RHI_Vertex_PosUVTBN& vertex = vertices[i];
+			float sign;
+
+			if (packing == Vertex_Packing_Compact)
+			{
+				const auto& in = reinterpret_cast<const RHI_Vertex_Compact*>(packed)[i];
+				sign			= _VertexPacking::UnpackPosition(in.pos, min, step, &vertex);
+				vertex.uv[0]	= HalfToFloat(in.uv[0]);
+				vertex.uv[1]	= HalfToFloat(in.uv[1]);
+				OctahedralDecode(in.normal, vertex.normal);
+				OctahedralDecode(in.tangent, vertex.tangent);
+			}
+			else
+			{
+				const auto& in = reinterpret_cast<const RHI_Vertex_Small*>(packed)[i];
+				sign			= _VertexPacking::UnpackPosition(in.pos, min, step, &vertex);
+				vertex.uv[0]	= HalfToFloat(in.uv[0]);
+				vertex.uv[1]	= HalfToFloat(in.uv[1]);
+				_VertexPacking::QuaternionDecode(in.frame, vertex.tangent, vertex.normal);
+			}
+
+			_VertexPacking::UnpackBitangent(sign, &vertex);
+		}
+	}
+
+	uint16_t VertexPacking::FloatToHalf(float value)
+	{
+		// Rounds to nearest even, overflows to infinity, keeps denormals
+		static const uint32_t infinity32	= 255 << 23;
+		static const uint32_t max16			= (127 + 16) << 23;
+		static const uint32_t denormalMagic	= ((127 - 15) + (23 - 10) + 1) << 23;
+
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		uint32_t sign = bits & 0x80000000u;
+		bits ^= sign;
+
+		uint16_t half;
+		if (bits >= max16)
+		{
+			half = bits > infinity32 ? 0x7e00 : 0x7c00;
+		}
+		else if (bits < (113 << 23))
+		{
+			// Let the FPU do the rounding of the denormal
+			float magic, shifted;
+			memcpy(&magic, &denormalMagic, sizeof(magic));
+			memcpy(&shifted, &bits, sizeof(shifted));
+			shifted += magic;
+			memcpy(&bits, &shifted, sizeof(bits));
+			half = (uint16_t)(bits - denormalMagic);
+		}
+		else
+		{
+			uint32_t mantissaOdd = (bits >> 13) & 1;
+			bits += ((uint32_t)(15 - 127) << 23) + 0xfff;
+			bits += mantissaOdd;
+			half = (uint16_t)(bits >> 13);
+		}
+
+		return half | (uint16_t)(sign >> 16);
+	}
+
+	float VertexPacking::HalfToFloat(uint16_t value)
+	{
+		static const uint32_t shiftedExponent	= 0x7c00 << 13;
+		static const uint32_t denormalMagic		= 113 << 23;
+
+		uint32_t bits		= (uint32_t)(value & 0x7fff) << 13;
+		uint32_t exponent	= shiftedExponent & bits;
+		bits += (127 - 15) << 23;
+
+		if (exponent == shiftedExponent)
+		{
+			// Infinity or NaN
+			bits += (128 - 16) << 23;
+		}
+		else if (exponent == 0)
+		{
+			// Zero or denormal, renormalize
+			bits += 1 << 23;
+			float magic, result;
+			memcpy(&magic, &denormalMagic, sizeof(magic));
+			memcpy(&result, &bits, sizeof(result));
+			result -= magic;
+			memcpy(&bits, &result, sizeof(bits));
+		}
+
+		bits |= (uint32_t)(value & 0x8000) << 16;
+		float result;
+		memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	void VertexPacking::OctahedralEncode(const float* vector, int16_t* encoded)
+	{
+		// Project onto the octahedron, then fold the lower half over the upper one
+		float length	= fabsf(vector[0]) + fabsf(vector[1]) + fabsf(vector[2]);
+		float x			= length > 0.0f ? vector[0] / length : 0.0f;
+		float y			= length > 0.0f ? vector[1] / length : 0.0f;
+		if (vector[2] < 0.0f)
+		{
+			float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		encoded[0] = _VertexPacking::ToSNorm16(x);
+		encoded[1] = _VertexPacking::ToSNorm16(y);
+	}
+
+	void VertexPacking::OctahedralDecode(const int16_t* encoded, float* vector)
+	{
+		float x = encoded[0] / 32767.0f;
+		float y = encoded[1] / 32767.0f;
+		float z = 1.0f - fabsf(x) - fabsf(y);
+		float t = z < 0.0f ? -z : 0.0f;
+		vector[0] = x + (x >= 0.0f ? -t : t);
+		vector[1] = y + (y >= 0.0f ? -t : t);
+		vector[2] = z;
+		_VertexPacking::Normalize(vector);
+	}
+}
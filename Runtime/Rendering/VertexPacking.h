@@ -0,0 +1,81 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <cstdint>
+#include <cstddef>
+#include "../Core/EngineDefs.h"
+#include "../RHI/RHI_Definition.h"
+//=============================
+
+namespace Directus
+{
+	namespace Math { class BoundingBox; }
+
+	// How the vertices of a model are kept on the CPU and on disk, they are always unpacked to RHI_Vertex_PosUVTBN for the GPU
+	enum Vertex_Packing
+	{
+		Vertex_Packing_None,	// 56 bytes, as is
+		Vertex_Packing_Compact,	// 20 bytes, see RHI_Vertex_Compact
+		Vertex_Packing_Small	// 16 bytes, see RHI_Vertex_Small
+	};
+
+	// Position in 16-bit fixed point relative to the mesh bounds (w is the handedness of the tangent frame),
+	// UV in half floats, normal and tangent octahedral encoded in 16-bit snorm. The bitangent is reconstructed.
+	struct RHI_Vertex_Compact
+	{
+		uint16_t pos[4];
+		uint16_t uv[2];
+		int16_t normal[2];
+		int16_t tangent[2];
+	};
+
+	// Like the compact vertex, but the tangent frame is a quaternion (smallest three, 10 bits per component)
+	struct RHI_Vertex_Small
+	{
+		uint16_t pos[4];
+		uint16_t uv[2];
+		uint32_t frame;
+	};
+
+	static_assert(sizeof(RHI_Vertex_Compact) == 20,	"RHI_Vertex_Compact is not tightly packed");
+	static_assert(sizeof(RHI_Vertex_Small) == 16,	"RHI_Vertex_Small is not tightly packed");
+
+	class ENGINE_CLASS VertexPacking
+	{
+	public:
+		static unsigned int GetStride(Vertex_Packing packing);
+
+		// Positions are quantized within the bounds, which have to contain them (and are needed to unpack them)
+		static void Pack(const RHI_Vertex_PosUVTBN* vertices, unsigned int count, Vertex_Packing packing, const Math::BoundingBox& bounds, std::byte* packed);
+		static void Unpack(const std::byte* packed, unsigned int count, Vertex_Packing packing, const Math::BoundingBox& bounds, RHI_Vertex_PosUVTBN* vertices);
+
+		//= ENCODING ==============================================================================
+		static uint16_t FloatToHalf(float value);
+		static float HalfToFloat(uint16_t value);
+		// Unit vector to two snorm16 components, and back (normalized)
+		static void OctahedralEncode(const float* vector, int16_t* encoded);
+		static void OctahedralDecode(const int16_t* encoded, float* vector);
+		//=========================================================================================
+	};
+}
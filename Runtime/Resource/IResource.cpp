@@ -21,7 +21,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =====================================
 #include "IResource.h"
-#include "ResourceManager.h"
+#include <mutex>
+#include <vector>
+#include "ResourceCache.h"
+#include "../RHI/RHI_Texture.h"
+#include "../Audio/AudioClip.h"
+#include "../Rendering/Material.h"
+#include "../Rendering/Mesh.h"
+#include "../Rendering/Model.h"
 #include "../Rendering/Font.h"
 #include "../Rendering/Deferred/ShaderVariation.h"
 #include "../Rendering/Animation.h"
@@ -45,28 +52,110 @@ INSTANTIATE_ToResourceType(Model,			Resource_Model)
 INSTANTIATE_ToResourceType(Animation,		Resource_Animation)
 INSTANTIATE_ToResourceType(Font,			Resource_Font)
 
+namespace _IResource
+{
+	// Per resource type, the indices handed out so far and the ones destroyed resources gave back.
+	// Never destroyed, as resources can outlive any static.
+	struct IndexPool
+	{
+		mutex lock;
+		unsigned int count[Resource_Font + 1]	= {};
+		vector<unsigned int> free[Resource_Font + 1];
+	};
+
+	IndexPool* GetIndexPool()
+	{
+		static IndexPool* pool = new IndexPool();
+		return pool;
+	}
+
+	unsigned int Index_Acquire(Resource_Type type)
+	{
+		auto pool = GetIndexPool();
+		lock_guard<mutex> lock(pool->lock);
+		auto& free = pool->free[type];
+		if (free.empty())
+			return pool->count[type]++;
+
+		unsigned int index = free.back();
+		free.pop_back();
+		return index;
+	}
+
+	void Index_Release(Resource_Type type, unsigned int index)
+	{
+		auto pool = GetIndexPool();
+		lock_guard<mutex> lock(pool->lock);
+		pool->free[type].emplace_back(index);
+	}
+}
+
 IResource::IResource(Context* context, Resource_Type type)
 {
-	m_context			= context;
-	m_resourceManager	= m_context->GetSubsystem<ResourceManager>();
-	m_resourceType		= type;
-	m_resourceID		= GENERATE_GUID;
-	m_loadState			= LoadState_Idle;
+	m_context		= context;
+	m_resourceType	= type;
+	m_resourceID	= GENERATE_GUID;
+	m_resourceIndex	= _IResource::Index_Acquire(type);
+	m_loadState		= LoadState_Idle;
+}
+
+IResource::~IResource()
+{
+	_IResource::Index_Release(m_resourceType, m_resourceIndex);
+}
+
+void IResource::SetResourceType(Resource_Type type)
+{
+	if (m_resourceType == type)
+		return;
+
+	// The index is only dense among resources of the same type
+	_IResource::Index_Release(m_resourceType, m_resourceIndex);
+	m_resourceType	= type;
+	m_resourceIndex	= _IResource::Index_Acquire(type);
+}
+
+void IResource::SetResourceName(const string& name)
+{
+	if (m_resourceName == name)
+		return;
+
+	m_resourceName = name;
+	if (m_resourceCache)
+	{
+		m_resourceCache->Reindex(this);
+	}
+}
+
+void IResource::SetResourceFilePath(const string& filePath)
+{
+	if (m_resourceFilePath == filePath)
+		return;
+
+	m_resourceFilePath = filePath;
+	if (m_resourceCache)
+	{
+		m_resourceCache->Reindex(this);
+	}
 }
 
-weak_ptr<IResource> IResource::_Cache()
+void IResource::UseCount_Decrement()
 {
-	auto resource = m_resourceManager->GetResourceByName(GetResourceName(), m_resourceType);
-	if (resource.expired())
+	if (m_useCount == 0)
 	{
-		m_resourceManager->Add(GetSharedPtr());
-		resource = m_resourceManager->GetResourceByName(GetResourceName(), m_resourceType);
+		LOGF_WARNING("IResource::UseCount_Decrement: Resource \"%s\" has no users", m_resourceName.c_str());
+		return;
 	}
 
-	return resource;
+	// The most recently released resources are the last to be evicted
+	m_useCount--;
+	MarkUsed();
 }
 
-bool IResource::_IsCached()
+void IResource::MarkUsed()
 {
-	return m_resourceManager->ExistsByName(GetResourceName(), m_resourceType);
-}
\ No newline at end of file
+	if (m_resourceCache)
+	{
+		m_lastUsedFrame = m_resourceCache->GetFrame();
+	}
+}
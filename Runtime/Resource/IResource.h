@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ========================
 #include <memory>
+#include <atomic>
 #include "../Core/Context.h"
 #include "../Core/GUIDGenerator.h"
 #include "../FileSystem/FileSystem.h"
@@ -31,7 +32,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace Directus
 {
-	class ResourceManager;
+	class ResourceCache;
 	
 	enum Resource_Type
 	{
@@ -53,28 +54,31 @@ namespace Directus
 		LoadState_Idle,
 		LoadState_Started,
 		LoadState_Completed,
-		LoadState_Failed
+		LoadState_Failed,
+		LoadState_Cancelled
 	};
 
 	class ENGINE_CLASS IResource : public std::enable_shared_from_this<IResource>
 	{
 	public:
 		IResource(Context* context, Resource_Type type);
-		virtual ~IResource() {}
+		virtual ~IResource();
 
 		//= PROPERTIES ===================================================================================================
 		unsigned int Resource_GetID() { return m_resourceID; }
+		// Small and dense among the live resources of the same type (it's reused once a resource is destroyed), for sort keys
+		unsigned int Resource_GetIndex() { return m_resourceIndex; }
 
 		Resource_Type GetResourceType()				{ return m_resourceType; }
-		void SetResourceType(Resource_Type type)		{ m_resourceType = type; }
+		void SetResourceType(Resource_Type type);
 
 		const char* GetResourceType_cstr() { return typeid(*this).name(); }
 
 		const std::string& GetResourceName()			{ return m_resourceName; }
-		void SetResourceName(const std::string& name)	{ m_resourceName = name; }
+		void SetResourceName(const std::string& name);
 
 		const std::string& GetResourceFilePath()				{ return m_resourceFilePath; }
-		void SetResourceFilePath(const std::string& filePath)	{ m_resourceFilePath = filePath; }
+		void SetResourceFilePath(const std::string& filePath);
 
 		bool HasFilePath() { return m_resourceFilePath != NOT_ASSIGNED; }
 
@@ -131,16 +135,31 @@ namespace Directus
 		LoadState GetLoadState()			{ return m_loadState; }
 		void SetLoadState(LoadState state)	{ m_loadState = state; }
 
+		//= USAGE ==========================================================================================
+		// Holders that only keep a weak or raw pointer to this resource must count themselves as users,
+		// the cache never evicts a resource that is in use (or strongly referenced by anything but itself)
+		void UseCount_Increment()			{ m_useCount++; }
+		void UseCount_Decrement();
+		unsigned int UseCount_Get()			{ return m_useCount; }
+		// Stamps the resource with the current frame, least recently used resources are evicted first
+		void MarkUsed();
+		uint64_t GetLastUsedFrame()			{ return m_lastUsedFrame; }
+		//==================================================================================================
+
 	protected:
+		friend class ResourceCache;
 		std::weak_ptr<IResource> _Cache();
 		bool _IsCached();
 
 		unsigned int m_resourceID			= NOT_ASSIGNED_HASH;
+		unsigned int m_resourceIndex		= 0;
 		std::string m_resourceName			= NOT_ASSIGNED;
 		std::string m_resourceFilePath		= NOT_ASSIGNED;
 		Resource_Type m_resourceType			= Resource_Unknown;
-		LoadState m_loadState				= LoadState_Idle;
+		std::atomic<LoadState> m_loadState	= LoadState_Idle;
 		Context* m_context					= nullptr;
-		ResourceManager* m_resourceManager	= nullptr;
+		ResourceCache* m_resourceCache		= nullptr; // Set while cached, so renames keep the cache indices valid
+		std::atomic<unsigned int> m_useCount	= 0;
+		std::atomic<uint64_t> m_lastUsedFrame	= 0;
 	};
 }
@@ -19,14 +19,15 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =====================
+//= INCLUDES ==================================
 #include "FontImporter.h"
 #include "ft2build.h"
 #include FT_FREETYPE_H 
 #include "../../Logging/Log.h"
 #include "../../Math/MathHelper.h"
 #include "../../Core/Settings.h"
-//================================
+#include "../../FileSystem/VirtualFileSystem.h"
+//=============================================
 
 //= NAMESPACES ========================
 using namespace std;
@@ -104,8 +105,11 @@ namespace Directus
 	{
 		FT_Face face;
 
-		// Load font
-		if (HandleError(FT_New_Face(m_library, filePath.c_str(), 0, &face)))
+		// Load font, a packed font has to stay in memory until the face is done
+		VirtualFile packedFile;
+		bool packed = VirtualFileSystem::Open(filePath, &packedFile);
+		FT_Error error = packed ? FT_New_Memory_Face(m_library, reinterpret_cast<const FT_Byte*>(packedFile.data), (FT_Long)packedFile.size, 0, &face) : FT_New_Face(m_library, filePath.c_str(), 0, &face);
+		if (HandleError(error))
 		{
 			FT_Done_Face(face);
 			return false;
@@ -19,13 +19,20 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =========================
+//= INCLUDES ==================================
 #include "ImageImporter.h"
 #include "FreeImagePlus.h"
+#include "MipmapGenerator.h"
+#include "PixelConverter.h"
 #include "../../Threading/Threading.h"
 #include "../../Core/Settings.h"
 #include "../../RHI/RHI_Texture.h"
-//====================================
+#include "../../FileSystem/VirtualFileSystem.h"
+#include "../../Core/Hash.h"
+#include "../../IO/FileStream.h"
+#include "../../IO/MappedFile.h"
+#include "../ResourceManager.h"
+//=============================================
 
 //= NAMESPACES ================
 using namespace std;
@@ -34,6 +41,74 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace _ImageImporter
+	{
+		// Bump whenever the output changes, so that the import cache doesn't serve results of older versions
+		static const unsigned int version = 1;
+
+		// Describes the pixels of a bitmap to the PixelConverter, palettes are expanded to RGBA8 into the given storage
+		inline PixelSource GetPixelSource(FIBITMAP* bitmap, bool flip, uint32_t palette[256])
+		{
+			PixelSource source;
+			source.width	= FreeImage_GetWidth(bitmap);
+			source.height	= FreeImage_GetHeight(bitmap);
+			source.data		= reinterpret_cast<const std::byte*>(FreeImage_GetScanLine(bitmap, flip ? source.height - 1 : 0));
+			source.pitch	= flip ? -(ptrdiff_t)FreeImage_GetPitch(bitmap) : (ptrdiff_t)FreeImage_GetPitch(bitmap);
+
+			unsigned int bpp = FreeImage_GetBPP(bitmap);
+			switch (FreeImage_GetImageType(bitmap))
+			{
+				case FIT_BITMAP:
+					if (bpp <= 8)
+					{
+						source.format	= bpp == 1 ? PixelFormat_Palette1 : bpp == 4 ? PixelFormat_Palette4 : bpp == 8 ? PixelFormat_Palette8 : PixelFormat_Unknown;
+						source.palette	= palette;
+
+						const RGBQUAD* colors			= FreeImage_GetPalette(bitmap);
+						unsigned int colorCount			= colors ? FreeImage_GetColorsUsed(bitmap) : 0;
+						const BYTE* alphas				= FreeImage_IsTransparent(bitmap) ? FreeImage_GetTransparencyTable(bitmap) : nullptr;
+						unsigned int alphaCount			= alphas ? FreeImage_GetTransparencyCount(bitmap) : 0;
+						for (unsigned int i = 0; i < 256; i++)
+						{
+							// Without a palette the indices are shades of gray
+							uint8_t gray		= uint8_t(i * 255 / ((1u << bpp) - 1));
+							uint8_t color[4]	=
+							{
+								i < colorCount ? colors[i].rgbRed	: gray,
+								i < colorCount ? colors[i].rgbGreen	: gray,
+								i < colorCount ? colors[i].rgbBlue	: gray,
+								i < alphaCount ? alphas[i]			: uint8_t(255)
+							};
+							memcpy(&palette[i], color, 4);
+						}
+					}
+					else if (bpp == 16)
+					{
+						bool is565		= FreeImage_GetRedMask(bitmap) == FI16_565_RED_MASK && FreeImage_GetGreenMask(bitmap) == FI16_565_GREEN_MASK;
+						source.format	= is565 ? PixelFormat_BGR565 : PixelFormat_BGR555;
+					}
+					else if (bpp == 24)
+					{
+						source.format = FREEIMAGE_COLORORDER == FREEIMAGE_COLORORDER_BGR ? PixelFormat_BGR8 : PixelFormat_RGB8;
+					}
+					else if (bpp == 32)
+					{
+						source.format = FREEIMAGE_COLORORDER == FREEIMAGE_COLORORDER_BGR ? PixelFormat_BGRA8 : PixelFormat_RGBA8;
+					}
+					break;
+				case FIT_UINT16:	source.format = PixelFormat_R16;		break;
+				case FIT_RGB16:		source.format = PixelFormat_RGB16;		break;
+				case FIT_RGBA16:	source.format = PixelFormat_RGBA16;		break;
+				case FIT_FLOAT:		source.format = PixelFormat_R32F;		break;
+				case FIT_RGBF:		source.format = PixelFormat_RGB32F;		break;
+				case FIT_RGBAF:		source.format = PixelFormat_RGBA32F;	break;
+				default:			source.format = PixelFormat_Unknown;	break;
+			}
+
+			return source;
+		}
+	}
+
 	ImageImporter::ImageImporter(Context* context)
 	{
 		m_context = context;
@@ -65,8 +140,37 @@ namespace Directus
 			return false;
 		}
 
+		// Images are decoded from memory (a pack's or the mapped file), the same bytes key the import cache
+		VirtualFile packedFile;
+		MappedFile mappedFile;
+		const std::byte* data	= nullptr;
+		size_t size				= 0;
+		if (VirtualFileSystem::Open(filePath, &packedFile))
+		{
+			data = packedFile.data;
+			size = packedFile.size;
+		}
+		else if (mappedFile.Open(filePath))
+		{
+			data = mappedFile.GetData();
+			size = mappedFile.GetSize();
+		}
+		else
+		{
+			LOG_WARNING("ImageImporter::Load: Failed to read \"" + filePath + "\".");
+			return false;
+		}
+
+		// Unchanged images (imported with the same settings) come straight from the cache
+		auto cache		= m_context->GetSubsystem<ResourceManager>()->GetImportCache();
+		uint64_t key	= cache ? ImportCache::ComputeKey(data, size, ComputeSettingsHash(texture)) : 0;
+		if (cache && cache->Load(key, [texture](FileStream* file) { return ReadCached(file, texture); }))
+			return true;
+
+		unique_ptr<FIMEMORY, decltype(&FreeImage_CloseMemory)> memory(FreeImage_OpenMemory(reinterpret_cast<BYTE*>(const_cast<std::byte*>(data)), (DWORD)size), &FreeImage_CloseMemory);
+
 		// Get image format
-		FREE_IMAGE_FORMAT format = FreeImage_GetFileType(filePath.c_str(), 0);
+		FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(memory.get(), 0);
 
 		// If the format is unknown
 		if (format == FIF_UNKNOWN)
@@ -91,10 +195,12 @@ namespace Directus
 			return false;
 
 		// Load the image as a FIBITMAP*
-		FIBITMAP* bitmapOriginal = FreeImage_Load(format, filePath.c_str());
-
-		// Flip it vertically
-		FreeImage_FlipVertical(bitmapOriginal);
+		FIBITMAP* bitmapOriginal = FreeImage_LoadFromMemory(format, memory.get());
+		if (!bitmapOriginal)
+		{
+			LOG_WARNING("ImageImporter::Load: Failed to decode \"" + filePath + "\".");
+			return false;
+		}
 
 		// Perform any scaling (if necessary)
 		bool userDefineDimensions = (texture->GetWidth() != 0 && texture->GetHeight() != 0);
@@ -102,44 +208,106 @@ namespace Directus
 		bool scale = userDefineDimensions && dimensionMismatch;
 		FIBITMAP* bitmapScaled = scale ? FreeImage_Rescale(bitmapOriginal, texture->GetWidth(), texture->GetHeight(), FILTER_LANCZOS3) : bitmapOriginal;
 
-		// Convert it to 32 bits (if necessary)
-		FIBITMAP* bitmap32 = FreeImage_GetBPP(bitmapOriginal) != 32 ? FreeImage_ConvertTo32Bits(bitmapScaled) : bitmapScaled;
+		// Store some useful data, whatever the source format is the texture gets RGBA8
 		texture->SetBPP(32);
+		texture->SetWidth(FreeImage_GetWidth(bitmapScaled));
+		texture->SetHeight(FreeImage_GetHeight(bitmapScaled));
+		texture->SetChannels(4);
 
-		// Store some useful data	
-		texture->SetTransparency(bool(FreeImage_IsTransparent(bitmap32)));
-		texture->SetWidth(FreeImage_GetWidth(bitmap32));
-		texture->SetHeight(FreeImage_GetHeight(bitmap32));
-		texture->SetChannels(ComputeChannelCount(bitmap32, texture->GetBPP()));
-
-		// Fill RGBA vector with the data from the FIBITMAP
+		// Convert the pixels straight into the texture, top row first
+		bool transparent = false;
 		texture->GetData().emplace_back(vector<std::byte>());
-		GetBitsFromFIBITMAP(&texture->GetData()[0], bitmap32);
+		bool converted = GetBitsFromFIBITMAP(&texture->GetData()[0], bitmapScaled, true, &transparent);
+		texture->SetTransparency(transparent);
+
+		//= Free memory ===================
+		if (scale)
+		{
+			FreeImage_Unload(bitmapScaled);
+		}
+		FreeImage_Unload(bitmapOriginal);
+		//=================================
+
+		if (!converted)
+		{
+			LOG_WARNING("ImageImporter::Load: Failed to convert the pixels of \"" + filePath + "\".");
+			texture->GetData().clear();
+			return false;
+		}
 
 		// Check if the image is grayscale
 		texture->SetGrayscale(GrayscaleCheck(texture->GetData()[0], texture->GetWidth(), texture->GetHeight()));
 
+		// Now that it's known whether the image is grayscale, normal and height maps can be told apart
+		texture->SetTextureType(texture->GetTextureType());
+
 		if (texture->IsUsingMimmaps())
 		{
-			GenerateMipmapsFromFIBITMAP(bitmap32, texture);
+			GenerateMipmaps(texture);
+			Compress(texture);
+		}
+
+		if (cache)
+		{
+			cache->Store(key, [texture](FileStream* file) { return WriteCached(file, texture); });
 		}
 
-		//= Free memory =====================================
-		// unload the 32-bit bitmap
-		FreeImage_Unload(bitmap32);
+		return true;
+	}
 
-		// unload the scaled bitmap only if it was converted
-		if (texture->GetBPP() != 32)
+	uint64_t ImageImporter::ComputeSettingsHash(RHI_Texture* texture)
+	{
+		// Everything (other than the image) that the result depends on
+		Hash hash;
+		unsigned int settings[] =
 		{
-			FreeImage_Unload(bitmapScaled);
+			_ImageImporter::version,
+			(unsigned int)texture->GetTextureType(),
+			(unsigned int)texture->IsUsingMimmaps(),
+			texture->GetWidth(),
+			texture->GetHeight(),
+			(unsigned int)m_compression
+		};
+		hash.Update(settings, sizeof(settings));
+		return hash.Digest();
+	}
+
+	bool ImageImporter::ReadCached(FileStream* file, RHI_Texture* texture)
+	{
+		texture->SetBPP(file->ReadUInt());
+		texture->SetWidth(file->ReadUInt());
+		texture->SetHeight(file->ReadUInt());
+		texture->SetChannels(file->ReadUInt());
+		texture->SetGrayscale(file->ReadUInt() != 0);
+		texture->SetTransparency(file->ReadUInt() != 0);
+		texture->SetTextureType((TextureType)file->ReadUInt());
+		texture->SetFormat((Texture_Format)file->ReadUInt());
+
+		auto& mips = texture->GetData();
+		mips.resize(file->ReadUInt());
+		for (auto& mip : mips)
+		{
+			file->Read(&mip);
 		}
 
-		// unload the non 32-bit bitmap only if it was scaled
-		if (scale)
+		return !mips.empty() && !mips[0].empty();
+	}
+
+	bool ImageImporter::WriteCached(FileStream* file, RHI_Texture* texture)
+	{
+		file->Write(texture->GetBPP());
+		file->Write(texture->GetWidth());
+		file->Write(texture->GetHeight());
+		file->Write(texture->GetChannels());
+		file->Write((unsigned int)texture->GetGrayscale());
+		file->Write((unsigned int)texture->GetTransparency());
+		file->Write((unsigned int)texture->GetTextureType());
+		file->Write((unsigned int)texture->GetFormat());
+		file->Write((unsigned int)texture->GetData().size());
+		for (const auto& mip : texture->GetData())
 		{
-			FreeImage_Unload(bitmapOriginal);
+			file->Write(mip);
 		}
-		//====================================================
 
 		return true;
 	}
@@ -158,52 +326,37 @@ namespace Directus
 		return result;
 	}
 
-	unsigned int ImageImporter::ComputeChannelCount(FIBITMAP* bitmap, unsigned int bpp)
-	{
-		FREE_IMAGE_TYPE imageType = FreeImage_GetImageType(bitmap);
-		if (imageType != FIT_BITMAP)
-			return 0;
-
-		if (bpp == 8)
-			return 1;
-
-		if (bpp == 24)
-			return 3;
-
-		if (bpp == 32)
-			return 4;
-
-		return 0;
-	}
-
-	bool ImageImporter::GetBitsFromFIBITMAP(vector<std::byte>* data, FIBITMAP* bitmap)
+	bool ImageImporter::GetBitsFromFIBITMAP(vector<std::byte>* data, FIBITMAP* bitmap, bool flip, bool* transparent)
 	{
-		unsigned int width	= FreeImage_GetWidth(bitmap);
-		unsigned int height = FreeImage_GetHeight(bitmap);
-
-		if (width == 0 || height == 0)
+		if (!bitmap || FreeImage_GetWidth(bitmap) == 0 || FreeImage_GetHeight(bitmap) == 0)
 			return false;
 
-		unsigned int bytesPerPixel = FreeImage_GetLine(bitmap) / width;
-		data->reserve(4 * width * height);
+		uint32_t palette[256];
+		PixelSource source			= _ImageImporter::GetPixelSource(bitmap, flip, palette);
+		FIBITMAP* bitmapStandard	= nullptr;
 
-		// Construct an RGBA array
-		for (unsigned int y = 0; y < height; y++)
+		// Types the converter doesn't read (signed, 32-bit integer, double and complex) are scaled to 8 bits by FreeImage
+		if (source.format == PixelFormat_Unknown)
 		{
-			auto bytes = (std::byte*)FreeImage_GetScanLine(bitmap, y);
-			for (unsigned int x = 0; x < width; x++)
+			bitmapStandard = FreeImage_GetImageType(bitmap) == FIT_BITMAP ? FreeImage_ConvertTo32Bits(bitmap) : FreeImage_ConvertToStandardType(bitmap, TRUE);
+			if (!bitmapStandard)
 			{
-				data->emplace_back(bytes[FI_RGBA_RED]);
-				data->emplace_back(bytes[FI_RGBA_GREEN]);
-				data->emplace_back(bytes[FI_RGBA_BLUE]);
-				data->emplace_back(bytes[FI_RGBA_ALPHA]);
-
-				// jump to next pixel
-				bytes += bytesPerPixel;
+				LOG_WARNING("ImageImporter::GetBitsFromFIBITMAP: Unsupported pixel format.");
+				return false;
 			}
+			source = _ImageImporter::GetPixelSource(bitmapStandard, flip, palette);
 		}
 
-		return true;
+		// Every pixel is written once, straight into its place
+		data->resize((size_t)source.width * source.height * 4);
+		bool result = PixelConverter::Convert(source, data->data(), transparent, m_context->GetSubsystem<Threading>());
+
+		if (bitmapStandard)
+		{
+			FreeImage_Unload(bitmapStandard);
+		}
+
+		return result;
 	}
 
 	bool ImageImporter::GetRescaledBitsFromBitmap(vector<std::byte>* dataOut, int width, int height, FIBITMAP* bitmap)
@@ -218,7 +371,7 @@ namespace Directus
 		FIBITMAP* bitmapScaled = FreeImage_Rescale(bitmap, width, height, FILTER_LANCZOS3);
 
 		// Extract RGBA data from the FIBITMAP
-		bool result = GetBitsFromFIBITMAP(dataOut, bitmapScaled);
+		bool result = GetBitsFromFIBITMAP(dataOut, bitmapScaled, false);
 
 		// Unload the FIBITMAP
 		FreeImage_Unload(bitmapScaled);
@@ -226,76 +379,54 @@ namespace Directus
 		return result;
 	}
 
-	void ImageImporter::GenerateMipmapsFromFIBITMAP(FIBITMAP* bitmap, RHI_Texture* texture)
+	void ImageImporter::GenerateMipmaps(RHI_Texture* texture)
 	{
-		if (!texture)
+		if (!texture || texture->GetData().empty())
 			return;
 
-		// First mip is full size, we won't do anything special for it
-		unsigned int width	= texture->GetWidth();
-		unsigned int height	= texture->GetHeight();
-
-		// Define a struct that the threads will work with
-		struct RescaleJob
+		// The type (when known before loading) decides how the texels are filtered
+		MipmapSettings settings;
+		if (texture->GetTextureType() == TextureType_Albedo)
+		{
+			// Albedo is sRGB, the shaders linearize it
+			settings.srgb = true;
+		}
+		else if (texture->GetTextureType() == TextureType_Mask)
 		{
-			unsigned int width		= 0;
-			unsigned int height		= 0;
-			bool complete			= false;
-			vector<std::byte> data;
+			// The G-Buffer shader discards where none of the mask's color channels is above 0.6
+			settings.preserveCoverage		= true;
+			settings.coverageChannels[0]	= true;
+			settings.coverageChannels[1]	= true;
+			settings.coverageChannels[2]	= true;
+			settings.coverageChannels[3]	= false;
+			settings.coverageThreshold		= 0.6f;
+		}
 
-			RescaleJob(unsigned int width, unsigned int height, bool scaled)
-			{
-				this->width		= width;
-				this->height	= height;
-				this->complete	= scaled;
-			}
-		};
-		vector<RescaleJob> rescaleJobs;
+		// Every level is downsampled from the previous one, in parallel bands of rows
+		MipmapGenerator::Generate(&texture->GetData(), texture->GetWidth(), texture->GetHeight(), settings, m_context->GetSubsystem<Threading>());
+	}
 
-		// For each mip level that we need, add a job
-		while (width > 1 && height > 1)
-		{
-			width = max(width / 2, 1);
-			height = max(height / 2, 1);
+	void ImageImporter::Compress(RHI_Texture* texture)
+	{
+		if (!texture || texture->GetData().empty())
+			return;
 
-			rescaleJobs.emplace_back(width, height, false);
-		}
+		// The type (when known before loading) decides the format
+		bool opaque				= TextureCompressor::IsOpaque(texture->GetData()[0]);
+		Texture_Format format	= TextureCompressor::ChooseFormat(texture->GetTextureType(), texture->GetGrayscale(), opaque, m_compression);
+		if (RHI_Texture::GetBlockSize(format) == 0)
+			return;
 
-		// Parallelize mipmap generation using multiple
-		// threads as FreeImage_Rescale() using FILTER_LANCZOS3 can take a while.
-		auto threading = m_context->GetSubsystem<Threading>();
-		for (auto& job : rescaleJobs)
-		{
-			threading->AddTask([this, &job, &bitmap]()
-			{
-				if (!GetRescaledBitsFromBitmap(&job.data, job.width, job.height, bitmap))
-				{
-					string mipSize = "(" + to_string(job.width) + "x" + to_string(job.height) + ")";
-					LOG_INFO("ImageImporter: Failed to create mip level " + mipSize + ".");
-				}
-				job.complete = true;
-			});
-		}
+		// The first mip of a block compressed texture has to be made of whole blocks
+		if (texture->GetWidth() % 4 != 0 || texture->GetHeight() % 4 != 0)
+			return;
 
-		// Wait until all mipmaps have been generated
-		bool ready = false;
-		while (!ready)
-		{
-			ready = true;
-			for (const auto& job : rescaleJobs)
-			{
-				if (!job.complete)
-				{
-					ready = false;
-				}
-			}
-		}
+		vector<mipmap> blocks;
+		if (!TextureCompressor::Compress(texture->GetData(), texture->GetWidth(), texture->GetHeight(), format, m_compression, &blocks, m_context->GetSubsystem<Threading>()))
+			return;
 
-		// Now move the mip map data into the texture
-		for (const auto& job : rescaleJobs)
-		{
-			texture->GetData().emplace_back(move(job.data));
-		}
+		texture->GetData().swap(blocks);
+		texture->SetFormat(format);
 	}
 
 	bool ImageImporter::GrayscaleCheck(const vector<std::byte>& data, int width, int height)
@@ -64,6 +64,7 @@ XPM files[reading, writing]
 #include <vector>
 #include "../../Core/EngineDefs.h"
 #include "../../RHI/RHI_Definition.h"
+#include "TextureCompressor.h"
 //===================================
 
 struct FIBITMAP;
@@ -71,6 +72,7 @@ struct FIBITMAP;
 namespace Directus
 {
 	class Context;
+	class FileStream;
 
 	class ENGINE_CLASS ImageImporter
 	{
@@ -81,13 +83,24 @@ namespace Directus
 		bool Load(const std::string& filePath, RHI_Texture* texInfo);
 		bool RescaleBits(std::vector<std::byte>* rgba, unsigned int fromWidth, unsigned int fromHeight, unsigned int toWidth, unsigned int toHeight);
 
+		// Textures of a known type (and with mip-maps) are block compressed when loaded
+		void SetCompression(TextureCompression compression)	{ m_compression = compression; }
+		TextureCompression GetCompression()					{ return m_compression; }
+
 	private:
-		unsigned int ComputeChannelCount(FIBITMAP* bitmap, unsigned int bpp);
-		bool GetBitsFromFIBITMAP(std::vector<std::byte>* rgba, FIBITMAP* bitmap);
+		// Converts the pixels to RGBA8, flip reads the rows from the top of the image (FreeImage stores them bottom-up)
+		bool GetBitsFromFIBITMAP(std::vector<std::byte>* rgba, FIBITMAP* bitmap, bool flip, bool* transparent = nullptr);
 		bool GetRescaledBitsFromBitmap(std::vector<std::byte>* rgbaOut, int width, int height, FIBITMAP* bitmap);
-		void GenerateMipmapsFromFIBITMAP(FIBITMAP* bitmap, RHI_Texture* imageData);	
+		void GenerateMipmaps(RHI_Texture* texture);
+		void Compress(RHI_Texture* texture);
 		bool GrayscaleCheck(const std::vector<std::byte>& dataRGBA, int width, int height);
 
+		// IMPORT CACHE
+		uint64_t ComputeSettingsHash(RHI_Texture* texture);
+		static bool ReadCached(FileStream* file, RHI_Texture* texture);
+		static bool WriteCached(FileStream* file, RHI_Texture* texture);
+
 		Context* m_context;
+		TextureCompression m_compression = TextureCompression_Normal;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,284 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ==================================
+#include "ImportCache.h"
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include "../../Core/Hash.h"
+#include "../../IO/FileStream.h"
+#include "../../IO/MappedFile.h"
+#include "../../FileSystem/FileSystem.h"
+#include "../../FileSystem/VirtualFileSystem.h"
+#include "../../Logging/Log.h"
+//=============================================
+
+//= NAMESPACES ==================
+using namespace std;
+using namespace std::filesystem;
+//===============================
+
+namespace Directus
+{
+	namespace _ImportCache
+	{
+		static const char* extension		= ".import";
+		static const char* extensionWriting	= ".writing";
+
+		// Collecting stops this far under the budget, so that every store past it doesn't collect again
+		static const float collectTarget = 0.9f;
+	}
+
+	ImportCache::ImportCache(const string& directory, uint64_t budget)
+	{
+		m_directory		= directory;
+		m_stats.budget	= budget;
+
+		if (!FileSystem::DirectoryExists(m_directory))
+		{
+			FileSystem::CreateDirectory_(m_directory);
+		}
+
+		error_code error;
+		for (directory_iterator it(m_directory, error), end; !error && it != end; it.increment(error))
+		{
+			if (!it->is_regular_file(error))
+				continue;
+
+			// Left behind by a session that ended while writing
+			string extension = it->path().extension().string();
+			if (extension == _ImportCache::extensionWriting)
+			{
+				remove(it->path(), error);
+				continue;
+			}
+
+			if (extension != _ImportCache::extension)
+				continue;
+
+			uint64_t key = strtoull(it->path().stem().string().c_str(), nullptr, 16);
+			if (key == 0)
+				continue;
+
+			Entry entry;
+			entry.size		= it->file_size(error);
+			entry.lastUsed	= it->last_write_time(error).time_since_epoch().count();
+			m_entries[key]	= entry;
+			m_stats.size	+= entry.size;
+		}
+
+		lock_guard<mutex> guard(m_mutex);
+		Collect();
+	}
+
+	uint64_t ImportCache::ComputeKey(const string& filePath, uint64_t settings)
+	{
+		VirtualFile packedFile;
+		if (VirtualFileSystem::Open(filePath, &packedFile))
+			return ComputeKey(packedFile.data, packedFile.size, settings);
+
+		MappedFile file;
+		if (!file.Open(filePath))
+			return 0;
+
+		return ComputeKey(file.GetData(), file.GetSize(), settings);
+	}
+
+	uint64_t ImportCache::ComputeKey(const std::byte* data, size_t size, uint64_t settings)
+	{
+		if (!data)
+			return 0;
+
+		// 0 is reserved for "no key"
+		uint64_t key = Hash::Compute(data, size, settings);
+		return key != 0 ? key : 1;
+	}
+
+	bool ImportCache::Load(uint64_t key, const function<bool(FileStream*)>& read)
+	{
+		if (key == 0)
+			return false;
+
+		{
+			lock_guard<mutex> guard(m_mutex);
+			if (m_entries.find(key) == m_entries.end())
+			{
+				m_stats.misses++;
+				return false;
+			}
+		}
+
+		// The stream verifies the entry's hashes, so a damaged entry fails to open
+		string path = GetEntryPath(key);
+		bool loaded = false;
+		{
+			auto file	= make_unique<FileStream>(path, FileStreamMode_Read);
+			loaded		= file->IsOpen() && read(file.get());
+		}
+
+		lock_guard<mutex> guard(m_mutex);
+		if (!loaded)
+		{
+			Remove(key);
+			m_stats.misses++;
+			return false;
+		}
+
+		// Persist the use, so the next session knows what was used recently
+		error_code error;
+		auto now = file_time_type::clock::now();
+		last_write_time(path, now, error);
+
+		auto entry = m_entries.find(key);
+		if (entry != m_entries.end())
+		{
+			entry->second.lastUsed = now.time_since_epoch().count();
+		}
+		m_stats.hits++;
+
+		return true;
+	}
+
+	bool ImportCache::Store(uint64_t key, const function<bool(FileStream*)>& write)
+	{
+		if (key == 0)
+			return false;
+
+		// Written under a unique name and then renamed, so that readers (and other writers of the same key) never see it partially written
+		string path;
+		{
+			lock_guard<mutex> guard(m_mutex);
+			path = GetEntryPath(key) + "." + to_string(m_writeCount++) + _ImportCache::extensionWriting;
+		}
+
+		bool written = false;
+		{
+			auto file	= make_unique<FileStream>(path, FileStreamMode_Write);
+			written		= file->IsOpen() && write(file.get());
+		}
+
+		error_code error;
+		if (written)
+		{
+			rename(path, GetEntryPath(key), error);
+		}
+
+		if (!written || error)
+		{
+			remove(path, error);
+			LOGF_WARNING("ImportCache::Store: Failed to write entry %016llx", (unsigned long long)key);
+			return false;
+		}
+
+		// The file system keeps coarser modification times than the clock (which loads set), so set it
+		// explicitly, otherwise the next session can see an entry stored after a load as the older one
+		auto now = file_time_type::clock::now();
+		last_write_time(GetEntryPath(key), now, error);
+
+		lock_guard<mutex> guard(m_mutex);
+		auto& entry		= m_entries[key];
+		m_stats.size	-= entry.size;
+		entry.size		= file_size(GetEntryPath(key), error);
+		entry.lastUsed	= now.time_since_epoch().count();
+		m_stats.size	+= entry.size;
+		m_stats.stores++;
+		Collect();
+
+		return true;
+	}
+
+	void ImportCache::SetBudget(uint64_t budget)
+	{
+		lock_guard<mutex> guard(m_mutex);
+		m_stats.budget = budget;
+		Collect();
+	}
+
+	ImportCacheStats ImportCache::GetStats()
+	{
+		lock_guard<mutex> guard(m_mutex);
+		ImportCacheStats stats	= m_stats;
+		stats.entryCount		= (unsigned int)m_entries.size();
+		return stats;
+	}
+
+	void ImportCache::Clear()
+	{
+		lock_guard<mutex> guard(m_mutex);
+		while (!m_entries.empty())
+		{
+			Remove(m_entries.begin()->first);
+		}
+	}
+
+	string ImportCache::GetEntryPath(uint64_t key)
+	{
+		char name[17];
+		snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+		return m_directory + name + _ImportCache::extension;
+	}
+
+	void ImportCache::Remove(uint64_t key)
+	{
+		// Expects m_mutex to be locked
+		auto entry = m_entries.find(key);
+		if (entry == m_entries.end())
+			return;
+
+		error_code error;
+		remove(GetEntryPath(key), error);
+		m_stats.size -= entry->second.size;
+		m_entries.erase(entry);
+	}
+
+	void ImportCache::Collect()
+	{
+		// Expects m_mutex to be locked
+		if (m_stats.budget == 0 || m_stats.size <= m_stats.budget)
+			return;
+
+		vector<pair<int64_t, uint64_t>> entries;
+		entries.reserve(m_entries.size());
+		for (const auto& entry : m_entries)
+		{
+			entries.emplace_back(entry.second.lastUsed, entry.first);
+		}
+		sort(entries.begin(), entries.end());
+
+		uint64_t target		= (uint64_t)(m_stats.budget * _ImportCache::collectTarget);
+		uint64_t sizeBefore	= m_stats.size;
+		unsigned int count	= 0;
+		for (const auto& entry : entries)
+		{
+			if (m_stats.size <= target)
+				break;
+
+			Remove(entry.second);
+			count++;
+		}
+		m_stats.evictions += count;
+
+		LOGF_INFO("ImportCache::Collect: Deleted %d entries, %.2f MB", (int)count, (sizeBefore - m_stats.size) / 1000.0f / 1000.0f);
+	}
+}
@@ -0,0 +1,91 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include <string>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <cstddef>
+#include "../../Core/EngineDefs.h"
+//================================
+
+namespace Directus
+{
+	class FileStream;
+
+	struct ImportCacheStats
+	{
+		uint64_t size				= 0; // Bytes on disk
+		uint64_t budget				= 0;
+		unsigned int entryCount		= 0;
+		unsigned int hits			= 0; // Counts are since the cache was created
+		unsigned int misses			= 0;
+		unsigned int stores			= 0;
+		unsigned int evictions		= 0;
+	};
+
+	// Persistent derived data of imported files (decoded and processed, ready to be used), one file per entry.
+	// Entries are keyed by a hash of the source bytes and of the import settings, the settings should include
+	// a version of the importer so that changing an importer invalidates what it produced before.
+	// When the directory exceeds its budget, the least recently used entries (across sessions) are deleted.
+	class ENGINE_CLASS ImportCache
+	{
+	public:
+		// Creates the directory if needed and indexes the entries already in it
+		ImportCache(const std::string& directory, uint64_t budget);
+
+		// 0 when the file can't be read
+		static uint64_t ComputeKey(const std::string& filePath, uint64_t settings);
+		static uint64_t ComputeKey(const std::byte* data, size_t size, uint64_t settings);
+
+		// Reads an entry with read (which can reject it, e.g. when a file it depends on changed). Returns false if there is no usable entry.
+		bool Load(uint64_t key, const std::function<bool(FileStream*)>& read);
+		// Writes an entry with write, then collects the least recently used entries if over budget
+		bool Store(uint64_t key, const std::function<bool(FileStream*)>& write);
+
+		// 0 means unlimited
+		void SetBudget(uint64_t budget);
+		ImportCacheStats GetStats();
+		// Deletes every entry
+		void Clear();
+
+	private:
+		struct Entry
+		{
+			uint64_t size;
+			int64_t lastUsed; // File time, kept in the file's modification time between sessions
+		};
+
+		std::string GetEntryPath(uint64_t key);
+		void Remove(uint64_t key);
+		void Collect();
+
+		std::string m_directory;
+		std::unordered_map<uint64_t, Entry> m_entries;
+		ImportCacheStats m_stats;
+		unsigned int m_writeCount = 0; // Makes the names of files being written unique
+		std::mutex m_mutex;
+	};
+}
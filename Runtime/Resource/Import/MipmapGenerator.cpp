@@ -0,0 +1,462 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ====================
+#include "MipmapGenerator.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "../../Threading/Threading.h"
+//===============================
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MIPMAP_SSE
+	#include <emmintrin.h>
+#endif
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _MipmapGenerator
+	{
+		static const float pi = 3.14159265358979f;
+
+		// Destination texels per job, a band also filters the source rows its neighbours need so it can't be too thin
+		static const unsigned int bandTexels = 128 * 1024;
+
+		inline float Sinc(float x)
+		{
+			x *= pi;
+			return x == 0.0f ? 1.0f : sin(x) / x;
+		}
+
+		// Modified Bessel function of the first kind, order 0
+		inline float Bessel0(float x)
+		{
+			float sum	= 1.0f;
+			float term	= 1.0f;
+			float halfX	= x * 0.5f;
+			for (unsigned int k = 1; k < 32 && term > sum * 1e-8f; k++)
+			{
+				term *= (halfX / k) * (halfX / k);
+				sum += term;
+			}
+			return sum;
+		}
+
+		// In destination texels
+		inline float FilterRadius(MipmapFilter filter)
+		{
+			return filter == MipmapFilter_Box ? 0.5f : 3.0f;
+		}
+
+		inline float FilterWeight(MipmapFilter filter, float x)
+		{
+			x = fabs(x);
+			if (filter == MipmapFilter_Box)
+				return x < 0.5f ? 1.0f : x == 0.5f ? 0.5f : 0.0f;
+
+			if (x >= 3.0f)
+				return 0.0f;
+
+			if (filter == MipmapFilter_Lanczos)
+				return Sinc(x) * Sinc(x / 3.0f);
+
+			// Kaiser window with a width of 3 and an alpha of 4
+			float t = x / 3.0f;
+			return Sinc(x) * Bessel0(4.0f * sqrt(1.0f - t * t)) / Bessel0(4.0f);
+		}
+
+		// The source texels (clamped to the edge) and the weights that make up every destination texel along one axis
+		struct Taps
+		{
+			unsigned int count = 0;
+			vector<unsigned int> indices;	// count per destination texel
+			vector<float> weights;
+		};
+
+		inline void ComputeTaps(unsigned int srcSize, unsigned int dstSize, MipmapFilter filter, Taps* taps)
+		{
+			// Texel s is centered at s + 0.5, upsampling filters in source texels
+			float scale		= (float)srcSize / dstSize;
+			float support	= max(scale, 1.0f);
+			float radius	= FilterRadius(filter) * support;
+			taps->count		= (unsigned int)ceil(radius * 2.0f) + 1;
+			taps->indices.resize(dstSize * taps->count);
+			taps->weights.resize(dstSize * taps->count);
+
+			for (unsigned int d = 0; d < dstSize; d++)
+			{
+				float center	= (d + 0.5f) * scale;
+				int first		= (int)floor(center - radius);
+				float sum		= 0.0f;
+				for (unsigned int k = 0; k < taps->count; k++)
+				{
+					int s	= first + (int)k;
+					float w	= FilterWeight(filter, (s + 0.5f - center) / support);
+					taps->indices[d * taps->count + k]	= (unsigned int)min(max(s, 0), (int)srcSize - 1);
+					taps->weights[d * taps->count + k]	= w;
+					sum += w;
+				}
+
+				for (unsigned int k = 0; k < taps->count; k++)
+				{
+					taps->weights[d * taps->count + k] /= sum;
+				}
+			}
+		}
+
+		inline float SrgbToLinear(float value)
+		{
+			return value <= 0.04045f ? value / 12.92f : pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		// Bytes to floats, per channel, and back
+		struct Transfer
+		{
+			float decode[4][256];
+			// The linear value from which an sRGB byte rounds up to the next one
+			float thresholds[255];
+			// A first guess of the sRGB byte of a linear value, never too high, the thresholds settle the rest
+			unsigned char guess[4096];
+			bool srgb;
+
+			Transfer(bool srgb)
+			{
+				this->srgb = srgb;
+				for (unsigned int i = 0; i < 256; i++)
+				{
+					float value	= i / 255.0f;
+					float color	= srgb ? SrgbToLinear(value) : value;
+					decode[0][i] = decode[1][i] = decode[2][i] = color;
+					decode[3][i] = value;
+				}
+
+				if (!srgb)
+					return;
+
+				for (unsigned int i = 0; i < 255; i++)
+				{
+					thresholds[i] = SrgbToLinear((i + 0.5f) / 255.0f);
+				}
+				unsigned int value = 0;
+				for (unsigned int i = 0; i < 4096; i++)
+				{
+					while (value < 255 && i / 4095.0f >= thresholds[value])
+					{
+						value++;
+					}
+					guess[i] = (unsigned char)value;
+				}
+			}
+
+			unsigned char EncodeLinear(float value) const
+			{
+				return (unsigned char)(min(max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+			}
+
+			unsigned char EncodeSrgb(float value) const
+			{
+				if (value <= 0.0f)
+					return 0;
+				if (value >= 1.0f)
+					return 255;
+
+				unsigned int result = guess[(unsigned int)(value * 4095.0f)];
+				while (result < 255 && value >= thresholds[result])
+				{
+					result++;
+				}
+				return (unsigned char)result;
+			}
+
+			void DecodeRow(const std::byte* src, unsigned int width, float* dst) const
+			{
+				auto bytes = reinterpret_cast<const unsigned char*>(src);
+				for (unsigned int i = 0; i < width * 4; i += 4)
+				{
+					dst[i + 0] = decode[0][bytes[i + 0]];
+					dst[i + 1] = decode[1][bytes[i + 1]];
+					dst[i + 2] = decode[2][bytes[i + 2]];
+					dst[i + 3] = decode[3][bytes[i + 3]];
+				}
+			}
+
+			void EncodeRow(const float* src, unsigned int width, std::byte* dst) const
+			{
+				auto bytes = reinterpret_cast<unsigned char*>(dst);
+				if (srgb)
+				{
+					for (unsigned int i = 0; i < width * 4; i += 4)
+					{
+						bytes[i + 0] = EncodeSrgb(src[i + 0]);
+						bytes[i + 1] = EncodeSrgb(src[i + 1]);
+						bytes[i + 2] = EncodeSrgb(src[i + 2]);
+						bytes[i + 3] = EncodeLinear(src[i + 3]);
+					}
+					return;
+				}
+
+#if defined(MIPMAP_SSE)
+				const __m128 scale	= _mm_set1_ps(255.0f);
+				const __m128 half	= _mm_set1_ps(0.5f);
+				const __m128 zero	= _mm_setzero_ps();
+				const __m128 one	= _mm_set1_ps(1.0f);
+				for (unsigned int i = 0; i < width * 4; i += 4)
+				{
+					__m128 value	= _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), zero), one);
+					__m128i texel	= _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+					texel			= _mm_packs_epi32(texel, texel);
+					texel			= _mm_packus_epi16(texel, texel);
+					int packed		= _mm_cvtsi128_si32(texel);
+					memcpy(bytes + i, &packed, 4);
+				}
+#else
+				for (unsigned int i = 0; i < width * 4; i++)
+				{
+					bytes[i] = EncodeLinear(src[i]);
+				}
+#endif
+			}
+		};
+
+		// dst[x] = sum of the weighted src texels, 4 channels per texel
+		inline void FilterRow(const float* src, const Taps& taps, unsigned int dstWidth, float* dst)
+		{
+			const unsigned int* indices	= taps.indices.data();
+			const float* weights		= taps.weights.data();
+			for (unsigned int x = 0; x < dstWidth; x++, indices += taps.count, weights += taps.count)
+			{
+#if defined(MIPMAP_SSE)
+				__m128 sum = _mm_setzero_ps();
+				for (unsigned int k = 0; k < taps.count; k++)
+				{
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(src + indices[k] * 4)));
+				}
+				_mm_storeu_ps(dst + x * 4, sum);
+#else
+				float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (unsigned int k = 0; k < taps.count; k++)
+				{
+					const float* texel = src + indices[k] * 4;
+					for (unsigned int c = 0; c < 4; c++)
+					{
+						sum[c] += weights[k] * texel[c];
+					}
+				}
+				memcpy(dst + x * 4, sum, sizeof(sum));
+#endif
+			}
+		}
+
+		// dst += weight * src, over count floats
+		inline void AccumulateRow(const float* src, float weight, unsigned int count, float* dst)
+		{
+			unsigned int i = 0;
+#if defined(MIPMAP_SSE)
+			__m128 w = _mm_set1_ps(weight);
+			for (; i + 4 <= count; i += 4)
+			{
+				_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(w, _mm_loadu_ps(src + i))));
+			}
+#endif
+			for (; i < count; i++)
+			{
+				dst[i] += weight * src[i];
+			}
+		}
+
+		// Texels whose largest coverage channel (as a byte) is above the threshold once scaled, as a fraction
+		inline float Coverage(const unsigned int histogram[256], unsigned int texelCount, float scale, float threshold)
+		{
+			unsigned int passed = 0;
+			for (unsigned int value = 0; value < 256; value++)
+			{
+				if (value * scale > threshold * 255.0f)
+				{
+					passed += histogram[value];
+				}
+			}
+			return (float)passed / texelCount;
+		}
+
+		inline void Histogram(const vector<std::byte>& texels, const MipmapSettings& settings, unsigned int histogram[256])
+		{
+			memset(histogram, 0, sizeof(unsigned int) * 256);
+			auto bytes = reinterpret_cast<const unsigned char*>(texels.data());
+			for (size_t i = 0; i < texels.size(); i += 4)
+			{
+				unsigned char value = 0;
+				for (unsigned int c = 0; c < 4; c++)
+				{
+					if (settings.coverageChannels[c])
+					{
+						value = max(value, bytes[i + c]);
+					}
+				}
+				histogram[value]++;
+			}
+		}
+
+		// Scales the coverage channels until the coverage matches (Castano, "Computing Alpha Mipmaps")
+		inline void PreserveCoverage(vector<std::byte>* texels, float coverage, const MipmapSettings& settings)
+		{
+			unsigned int histogram[256];
+			Histogram(*texels, settings, histogram);
+			unsigned int texelCount = (unsigned int)(texels->size() / 4);
+
+			float low	= 0.0f;
+			float high	= 4.0f;
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				float scale = (low + high) * 0.5f;
+				if (Coverage(histogram, texelCount, scale, settings.coverageThreshold) < coverage)
+				{
+					low = scale;
+				}
+				else
+				{
+					high = scale;
+				}
+			}
+
+			float scale = (low + high) * 0.5f;
+			auto bytes	= reinterpret_cast<unsigned char*>(texels->data());
+			for (size_t i = 0; i < texels->size(); i += 4)
+			{
+				for (unsigned int c = 0; c < 4; c++)
+				{
+					if (settings.coverageChannels[c])
+					{
+						bytes[i + c] = (unsigned char)min(bytes[i + c] * scale + 0.5f, 255.0f);
+					}
+				}
+			}
+		}
+	}
+
+	void MipmapGenerator::Generate(vector<vector<std::byte>>* mips, unsigned int width, unsigned int height, const MipmapSettings& settings, Threading* threading)
+	{
+		if (!mips || mips->empty() || (*mips)[0].size() < (size_t)width * height * 4)
+			return;
+
+		float coverage = 0.0f;
+		if (settings.preserveCoverage)
+		{
+			unsigned int histogram[256];
+			_MipmapGenerator::Histogram((*mips)[0], settings, histogram);
+			coverage = _MipmapGenerator::Coverage(histogram, width * height, 1.0f, settings.coverageThreshold);
+		}
+
+		unsigned int levels = 1;
+		for (unsigned int size = max(width, height); size > 1; size /= 2)
+		{
+			levels++;
+		}
+		mips->resize(1);
+		mips->reserve(levels);
+
+		// Every level from the one before it
+		while (width > 1 || height > 1)
+		{
+			unsigned int mipWidth	= max(width / 2, 1u);
+			unsigned int mipHeight	= max(height / 2, 1u);
+			mips->emplace_back((size_t)mipWidth * mipHeight * 4);
+
+			const auto& src	= (*mips)[mips->size() - 2];
+			auto& dst		= mips->back();
+			Resample(src.data(), width, height, dst.data(), mipWidth, mipHeight, settings, threading);
+			if (settings.preserveCoverage)
+			{
+				_MipmapGenerator::PreserveCoverage(&dst, coverage, settings);
+			}
+
+			width	= mipWidth;
+			height	= mipHeight;
+		}
+	}
+
+	void MipmapGenerator::Resample(const std::byte* src, unsigned int srcWidth, unsigned int srcHeight, std::byte* dst, unsigned int dstWidth, unsigned int dstHeight, const MipmapSettings& settings, Threading* threading)
+	{
+		if (!src || !dst || srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0)
+			return;
+
+		_MipmapGenerator::Taps horizontal;
+		_MipmapGenerator::Taps vertical;
+		_MipmapGenerator::ComputeTaps(srcWidth, dstWidth, settings.filter, &horizontal);
+		_MipmapGenerator::ComputeTaps(srcHeight, dstHeight, settings.filter, &vertical);
+		const _MipmapGenerator::Transfer transfer(settings.srgb);
+
+		unsigned int bandRows	= max(_MipmapGenerator::bandTexels / dstWidth, 1u);
+		unsigned int bandCount	= (dstHeight + bandRows - 1) / bandRows;
+		auto band = [&](unsigned int index)
+		{
+			unsigned int rowBegin	= index * bandRows;
+			unsigned int rowEnd		= min(rowBegin + bandRows, dstHeight);
+
+			// The source rows the band needs, filtered horizontally
+			auto first	= min_element(vertical.indices.begin() + rowBegin * vertical.count, vertical.indices.begin() + rowEnd * vertical.count);
+			auto last	= max_element(vertical.indices.begin() + rowBegin * vertical.count, vertical.indices.begin() + rowEnd * vertical.count);
+			unsigned int srcBegin	= *first;
+			unsigned int srcEnd		= *last + 1;
+
+			vector<float> decoded((size_t)srcWidth * 4);
+			vector<float> filtered((size_t)(srcEnd - srcBegin) * dstWidth * 4);
+			for (unsigned int y = srcBegin; y < srcEnd; y++)
+			{
+				transfer.DecodeRow(src + (size_t)y * srcWidth * 4, srcWidth, decoded.data());
+				_MipmapGenerator::FilterRow(decoded.data(), horizontal, dstWidth, filtered.data() + (size_t)(y - srcBegin) * dstWidth * 4);
+			}
+
+			// Then vertically, a row at a time
+			vector<float> row((size_t)dstWidth * 4);
+			for (unsigned int y = rowBegin; y < rowEnd; y++)
+			{
+				fill(row.begin(), row.end(), 0.0f);
+				for (unsigned int k = 0; k < vertical.count; k++)
+				{
+					float weight = vertical.weights[y * vertical.count + k];
+					if (weight == 0.0f)
+						continue;
+
+					const float* srcRow = filtered.data() + (size_t)(vertical.indices[y * vertical.count + k] - srcBegin) * dstWidth * 4;
+					_MipmapGenerator::AccumulateRow(srcRow, weight, dstWidth * 4, row.data());
+				}
+				transfer.EncodeRow(row.data(), dstWidth, dst + (size_t)y * dstWidth * 4);
+			}
+		};
+
+		if (threading && bandCount > 1)
+		{
+			threading->ParallelFor(0, bandCount, band, 1);
+		}
+		else
+		{
+			for (unsigned int i = 0; i < bandCount; i++)
+			{
+				band(i);
+			}
+		}
+	}
+}
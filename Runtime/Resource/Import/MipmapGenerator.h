@@ -0,0 +1,64 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <cstddef>
+#include "../../Core/EngineDefs.h"
+//================================
+
+namespace Directus
+{
+	class Threading;
+
+	enum MipmapFilter
+	{
+		MipmapFilter_Box,		// 2x2 average, the softest
+		MipmapFilter_Kaiser,	// Kaiser windowed sinc, sharp with little ringing
+		MipmapFilter_Lanczos	// Lanczos3, the sharpest, rings around hard edges
+	};
+
+	struct MipmapSettings
+	{
+		MipmapFilter filter			= MipmapFilter_Kaiser;
+		// The color channels are sRGB encoded, they are filtered in linear space (alpha always is linear)
+		bool srgb					= false;
+		// For cutout textures: every mip keeps the fraction of texels that pass the test (any of the
+		// coverage channels above the threshold) of the first one, otherwise cutouts thin out with distance.
+		bool preserveCoverage		= false;
+		bool coverageChannels[4]	= { false, false, false, true };
+		float coverageThreshold		= 0.5f;
+	};
+
+	// Generates the mip chain of an RGBA8 image. Every level is downsampled from the previous
+	// one with a separable filter (SSE when available), in bands of rows that run in parallel.
+	class ENGINE_CLASS MipmapGenerator
+	{
+	public:
+		// mips[0] is the image, the levels down to 1x1 are appended to it
+		static void Generate(std::vector<std::vector<std::byte>>* mips, unsigned int width, unsigned int height, const MipmapSettings& settings, Threading* threading = nullptr);
+
+		// Downsamples (or upsamples) one level, each row band of the destination is a job
+		static void Resample(const std::byte* src, unsigned int srcWidth, unsigned int srcHeight, std::byte* dst, unsigned int dstWidth, unsigned int dstHeight, const MipmapSettings& settings, Threading* threading = nullptr);
+	};
+}
@@ -21,17 +21,27 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =================================
 #include "ModelImporter.h"
+#include <unordered_map>
+#include <algorithm>
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/version.h"
 #include "assimp/ProgressHandler.hpp"
+#include "assimp/DefaultIOSystem.h"
 #include "AssimpHelper.h"
 #include "../../Core/Settings.h"
 #include "../../Rendering/Model.h"
 #include "../../Rendering/Animation.h"
 #include "../../Rendering/Material.h"
+#include "../../Rendering/MeshOptimizer.h"
+#include "../../Rendering/MeshSimplifier.h"
+#include "../../Threading/Threading.h"
+#include "../../World/World.h"
 #include "../../World/Components/Renderable.h"
+#include "../../Core/Hash.h"
+#include "../../IO/FileStream.h"
 #include "../ProgressReport.h"
+#include "../ResourceManager.h"
 //============================================
 
 //= NAMESPACES ================
@@ -83,16 +93,41 @@ private:
 	string m_fileName;
 };
 
+// Records the files Assimp opens besides the model (e.g. material libraries), the import cache checks them too
+class _IOSystem : public DefaultIOSystem
+{
+public:
+	_IOSystem(const string& filePath) { m_filePath = filePath; }
+
+	IOStream* Open(const char* filePath, const char* mode = "rb") override
+	{
+		if (filePath && m_filePath != filePath && find(m_dependencies.begin(), m_dependencies.end(), filePath) == m_dependencies.end())
+		{
+			m_dependencies.emplace_back(filePath);
+		}
+
+		return DefaultIOSystem::Open(filePath, mode);
+	}
+
+	const vector<string>& GetDependencies() { return m_dependencies; }
+
+private:
+	string m_filePath;
+	vector<string> m_dependencies;
+};
+
 namespace Directus
 {
 	namespace _ModelImporter
 	{
+		// Bump whenever the output changes, so that the import cache doesn't serve results of older versions
+		static const unsigned int version = 1;
+
 		// Things for Assimp to do
 		static auto g_postProcessSteps =
 			aiProcess_CalcTangentSpace |
 			aiProcess_GenSmoothNormals |
 			aiProcess_JoinIdenticalVertices |
-			aiProcess_ImproveCacheLocality |
 			aiProcess_LimitBoneWeights |
 			aiProcess_SplitLargeMeshes |
 			aiProcess_Triangulate |
@@ -107,6 +142,120 @@ namespace Directus
 			aiProcess_ConvertToLeftHanded;
 
 		static int g_normalSmoothAngle = 45; // Default is 45, max is 175
+
+		// Levels of detail stop once the error reaches this (relative to the radius of the mesh) or once a level barely simplifies
+		static const float g_lodMaxError			= 0.05f;
+		static const float g_lodMinReduction		= 0.9f;
+
+		// Smaller geometry is culled as a whole, meshlets would only add draw calls
+		static const unsigned int g_meshletMinTriangles = 4096;
+
+		// Reorders the indices so every meshlet is contiguous, the meshlets are for the model once the indices are in it
+		inline vector<Meshlet> BuildMeshlets(const vector<RHI_Vertex_PosUVTBN>& vertices, vector<unsigned int>* indices)
+		{
+			vector<Meshlet> meshlets;
+			if (indices->size() / 3 >= g_meshletMinTriangles)
+			{
+				MeshletBuilder::Build(vertices, indices, &meshlets);
+			}
+			return meshlets;
+		}
+
+		// A node of the staged actor hierarchy, parents come before their children
+		struct Node
+		{
+			string name;
+			int parent;			// Index into the nodes, -1 for the root
+			int mesh;			// Index into the scene meshes, -1 for none
+			bool hasTransform;	// False for the actors that split up a node with several meshes
+			Vector3 position;
+			Quaternion rotation;
+			Vector3 scale;
+		};
+
+		struct MeshLod
+		{
+			vector<unsigned int> indices;
+			vector<Meshlet> meshlets;
+			float error;
+		};
+
+		// A processed mesh, waiting to be appended to the model (which is not thread safe)
+		struct MeshData
+		{
+			vector<RHI_Vertex_PosUVTBN> vertices;
+			vector<unsigned int> indices;
+			vector<Meshlet> meshlets;
+			vector<MeshLod> lods;
+			BoundingBox boundingBox;
+			int material	= -1; // Index into the scene materials
+			bool used		= false;
+
+			// Where the geometry ended up in the model
+			unsigned int indexOffset	= 0;
+			unsigned int indexCount		= 0;
+			unsigned int vertexOffset	= 0;
+			unsigned int vertexCount	= 0;
+		};
+
+		struct MaterialTexture
+		{
+			TextureType type;
+			string pathOriginal;			// As the model refers to it
+			string path;					// NOT_ASSIGNED when no file could be found
+			weak_ptr<RHI_Texture> texture;	// Once imported
+		};
+
+		// A material as the model describes it, waiting for its textures
+		struct MaterialData
+		{
+			string name;
+			bool twoSided	= false;
+			Vector4 color	= Vector4::One;
+			vector<MaterialTexture> textures;
+			bool used		= false;
+		};
+
+		inline void WriteMeshlets(FileStream* file, const vector<Meshlet>& meshlets)
+		{
+			file->Write((unsigned int)meshlets.size());
+			for (const auto& meshlet : meshlets)
+			{
+				file->Write(meshlet.indexOffset);
+				file->Write(meshlet.indexCount);
+				file->Write(meshlet.center);
+				file->Write(meshlet.radius);
+				file->Write(meshlet.coneAxis);
+				file->Write(meshlet.coneCutoff);
+			}
+		}
+
+		inline void ReadMeshlets(FileStream* file, vector<Meshlet>* meshlets)
+		{
+			meshlets->resize(file->ReadUInt());
+			for (auto& meshlet : *meshlets)
+			{
+				file->Read(&meshlet.indexOffset);
+				file->Read(&meshlet.indexCount);
+				file->Read(&meshlet.center);
+				file->Read(&meshlet.radius);
+				file->Read(&meshlet.coneAxis);
+				file->Read(&meshlet.coneCutoff);
+			}
+		}
+
+		// FileStream has no 64-bit integers
+		inline void WriteHash(FileStream* file, uint64_t hash)
+		{
+			file->Write((unsigned int)(hash >> 32));
+			file->Write((unsigned int)hash);
+		}
+
+		inline uint64_t ReadHash(FileStream* file)
+		{
+			uint64_t high = file->ReadUInt();
+			return (high << 32) | file->ReadUInt();
+		}
 	}
 
 	ModelImporter::ModelImporter(Context* context)
@@ -131,104 +280,454 @@ namespace Directus
 
 		m_model		= model;
 		m_modelPath = filePath;
+		// The model packs its geometry once it has been appended, so the packing has no effect on what gets cached
+		model->SetVertexPacking(m_vertexPacking);
+
+		auto threading				= m_context->GetSubsystem<Threading>();
+		ProgressReport& progress	= ProgressReport::Get();
+
+		// Progress is reported from here until the end of the load, whether the model comes from the cache or not.
+		// On a cache miss it's handed to Assimp, which owns it from then on (the importer is destroyed before it would be).
+		auto progressHandler = make_unique<_ProgressHandler>(filePath);
+
+		// 1st - Stage the actor hierarchy, the meshes and the materials, nothing is added to the world until the end.
+		// Unchanged models (imported with the same settings) come from the cache, with their meshes already processed.
+		vector<_ModelImporter::Node> nodes;
+		vector<_ModelImporter::MeshData> meshes;
+		vector<_ModelImporter::MaterialData> materials;
+		auto cache		= m_context->GetSubsystem<ResourceManager>()->GetImportCache();
+		uint64_t key	= cache ? ImportCache::ComputeKey(filePath, ComputeSettingsHash(model)) : 0;
+		progress.SetStatus(g_progress_ModelImporter, "Loading \"" + FileSystem::GetFileNameFromFilePath(filePath) + "\" from the import cache...");
+		bool cached		= cache && cache->Load(key, [this, &nodes, &meshes, &materials](FileStream* file) { return ReadCached(file, &nodes, &meshes, &materials); });
+
+		unique_ptr<Importer> importer;
+		const aiScene* scene	= nullptr;
+		_IOSystem* ioSystem		= nullptr;
+		if (!cached)
+		{
+			nodes.clear();
+			meshes.clear();
+			materials.clear();
+
+			// Set up an Assimp importer
+			importer = make_unique<Importer>();
+			importer->SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_LINE | aiPrimitiveType_POINT);		// Remove points and lines.
+			importer->SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, aiComponent_CAMERAS | aiComponent_LIGHTS);			// Remove cameras and lights
+			importer->SetPropertyInteger(AI_CONFIG_PP_CT_MAX_SMOOTHING_ANGLE, _ModelImporter::g_normalSmoothAngle);	// Normal smoothing angle
+			importer->SetProgressHandler(progressHandler.release());												// Progress tracking
+			ioSystem = new _IOSystem(filePath);
+			importer->SetIOHandler(ioSystem);																		// Dependency tracking
+
+			// Read the 3D model file from disk
+			scene = importer->ReadFile(m_modelPath, _ModelImporter::g_postProcessSteps);
+			if (!scene)
+			{
+				LOGF_ERROR("ModelImporter::Load: %s", importer->GetErrorString());
+				return false;
+			}
 
-		// Set up an Assimp importer
-		Importer importer;
-		importer.SetPropertyInteger(AI_CONFIG_PP_ICL_PTCACHE_SIZE, 64);											// Optimize mesh
-		importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_LINE | aiPrimitiveType_POINT);		// Remove points and lines.
-		importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, aiComponent_CAMERAS | aiComponent_LIGHTS);			// Remove cameras and lights
-		importer.SetPropertyInteger(AI_CONFIG_PP_CT_MAX_SMOOTHING_ANGLE, _ModelImporter::g_normalSmoothAngle);	// Normal smoothing angle
-		importer.SetProgressHandler(new _ProgressHandler(filePath));											// Progress tracking
+			ReadNodeHierarchy(scene, scene->mRootNode, -1, &nodes);
 
-		// Read the 3D model file from disk
-		if (const aiScene* scene = importer.ReadFile(m_modelPath, _ModelImporter::g_postProcessSteps))
-		{
-			ReadNodeHierarchy(model, scene, scene->mRootNode);
-			ReadAnimations(model, scene);
-			model->Geometry_Update();
-			FIRE_EVENT(EVENT_MODEL_LOADED);
+			meshes.resize(scene->mNumMeshes);
+			materials.resize(scene->mNumMaterials);
+			for (const auto& node : nodes)
+			{
+				if (node.mesh == -1 || meshes[node.mesh].used)
+					continue;
+
+				// Nodes can share a mesh, it's only processed (and added to the model) once
+				auto& mesh	= meshes[node.mesh];
+				mesh.used	= true;
+				if (scene->HasMaterials())
+				{
+					mesh.material = (int)scene->mMeshes[node.mesh]->mMaterialIndex;
+					materials[mesh.material].used = true;
+				}
+			}
+
+			for (unsigned int i = 0; i < scene->mNumMaterials; i++)
+			{
+				if (materials[i].used)
+				{
+					ReadMaterial(scene->mMaterials[i], &materials[i]);
+				}
+			}
 		}
 		else
 		{
-			LOGF_ERROR("ModelImporter::Load: %s", importer.GetErrorString());
+			// The model may have been renamed or moved
+			nodes.front().name = FileSystem::GetFileNameNoExtensionFromFilePath(m_modelPath);
+			for (auto& material : materials)
+			{
+				for (auto& texture : material.textures)
+				{
+					texture.path = ValidateTexturePath(texture.pathOriginal);
+				}
+			}
+		}
+
+		unsigned int meshCount = (unsigned int)count_if(meshes.begin(), meshes.end(), [](const _ModelImporter::MeshData& mesh) { return mesh.used; });
+		progress.SetJobCount(g_progress_ModelImporter, (int)(meshCount + nodes.size()));
+		progress.SetJobsDone(g_progress_ModelImporter, 0);
+
+		// 2nd - Meshes, textures and materials, in parallel jobs. A material only starts once its textures are imported.
+		progress.SetStatus(g_progress_ModelImporter, "Processing meshes and materials...");
+		vector<JobHandle> jobs;
+		if (!cached)
+		{
+			// The largest meshes go first, so that a big one doesn't start last and leave the other threads idle
+			vector<unsigned int> meshOrder;
+			for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+			{
+				if (meshes[i].used)
+				{
+					meshOrder.emplace_back(i);
+				}
+			}
+			stable_sort(meshOrder.begin(), meshOrder.end(), [scene](unsigned int a, unsigned int b) { return scene->mMeshes[a]->mNumFaces > scene->mMeshes[b]->mNumFaces; });
+
+			for (unsigned int i : meshOrder)
+			{
+				jobs.emplace_back(threading->AddTask([this, model, scene, &meshes, i]() { LoadMesh(model, scene->mMeshes[i], &meshes[i]); }));
+			}
+		}
+
+		vector<shared_ptr<Material>> materialsCreated(materials.size());
+		// Textures can be shared by materials, they are imported once. The map is filled
+		// before any job runs, the jobs only write (or read) the entries in place.
+		unordered_map<string, weak_ptr<RHI_Texture>> textures;
+		for (const auto& material : materials)
+		{
+			for (const auto& texture : material.textures)
+			{
+				if (material.used && FileSystem::IsSupportedImageFile(texture.path))
+				{
+					textures.emplace(texture.path, weak_ptr<RHI_Texture>());
+				}
+			}
+		}
+
+		unordered_map<string, JobHandle> textureJobs;
+		for (unsigned int i = 0; i < (unsigned int)materials.size(); i++)
+		{
+			if (!materials[i].used)
+				continue;
+
+			vector<JobHandle> dependencies;
+			for (const auto& texture : materials[i].textures)
+			{
+				auto imported = textures.find(texture.path);
+				if (imported == textures.end())
+					continue;
+
+				auto job = textureJobs.find(texture.path);
+				if (job == textureJobs.end())
+				{
+					auto& result	= imported->second;
+					job				= textureJobs.emplace(texture.path, threading->AddTask([model, &result, texture]() { result = model->ImportTexture(texture.type, texture.path); })).first;
+					jobs.emplace_back(job->second);
+				}
+				dependencies.emplace_back(job->second);
+			}
+
+			jobs.emplace_back(threading->AddTask([this, model, &materials, &materialsCreated, &textures, i]()
+			{
+				for (auto& texture : materials[i].textures)
+				{
+					auto imported = textures.find(texture.path);
+					if (imported != textures.end())
+					{
+						texture.texture = imported->second;
+					}
+				}
+				materialsCreated[i] = CreateMaterial(model, materials[i]);
+			}, dependencies));
+		}
+		threading->Wait(jobs);
+		progress.SetJobsDone(g_progress_ModelImporter, (int)meshCount);
+
+		// The geometry is still staged, cache it. Animations are read from the scene, so models that have any aren't cached.
+		if (!cached && cache && scene->mNumAnimations == 0)
+		{
+			cache->Store(key, [this, ioSystem, &nodes, &meshes, &materials](FileStream* file) { return WriteCached(file, ioSystem->GetDependencies(), nodes, meshes, materials); });
+		}
+
+		// 3rd - Add the geometry to the model, in mesh order so that the result doesn't depend on the threads
+		for (auto& mesh : meshes)
+		{
+			if (!mesh.used)
+				continue;
+
+			model->Geometry_Append(mesh.indices, mesh.vertices, &mesh.indexOffset, &mesh.vertexOffset);
+			if (!mesh.meshlets.empty())
+			{
+				model->Geometry_SetMeshlets(mesh.indexOffset, move(mesh.meshlets));
+			}
+
+			for (auto& lod : mesh.lods)
+			{
+				model->Geometry_AppendLod(mesh.indexOffset, lod.indices, lod.error);
+				if (!lod.meshlets.empty())
+				{
+					model->Geometry_SetMeshlets(model->Geometry_GetLods(mesh.indexOffset)->back().indexOffset, move(lod.meshlets));
+				}
+			}
+
+			// The model has its own copy now
+			mesh.indexCount		= (unsigned int)mesh.indices.size();
+			mesh.vertexCount	= (unsigned int)mesh.vertices.size();
+			vector<unsigned int>().swap(mesh.indices);
+			vector<RHI_Vertex_PosUVTBN>().swap(mesh.vertices);
+			vector<_ModelImporter::MeshLod>().swap(mesh.lods);
+		}
+
+		// Every material is saved and cached once, no matter how many meshes use it
+		vector<weak_ptr<Material>> materialRefs(materialsCreated.size());
+		for (unsigned int i = 0; i < (unsigned int)materialsCreated.size(); i++)
+		{
+			if (materialsCreated[i])
+			{
+				materialRefs[i] = model->AddMaterial(materialsCreated[i], weak_ptr<Actor>());
+			}
+		}
+
+		// 4th - Commit, the actors are created in one go on the main thread
+		progress.SetStatus(g_progress_ModelImporter, "Creating actors...");
+		if (!Commit(model, nodes, meshes, materialRefs))
+		{
+			LOG_ERROR("ModelImporter::Load: The world went away before the model could be added to it");
 			return false;
 		}
 
+		if (scene)
+		{
+			ReadAnimations(model, scene);
+		}
+		model->Geometry_Update();
+		FIRE_EVENT(EVENT_MODEL_LOADED);
+
 		return true;
 	}
 
-	//= PROCESSING ===============================================================================
-	void ModelImporter::ReadNodeHierarchy(Model* model, const aiScene* assimpScene, aiNode* assimpNode, const weak_ptr<Actor> parentNode, weak_ptr<Actor> newNode)
+	//= IMPORT CACHE =============================================================================
+	uint64_t ModelImporter::ComputeSettingsHash(Model* model)
 	{
-		auto scene = m_context->GetSubsystem<World>();
+		// Everything (other than the model) that the result depends on
+		Hash hash;
+		unsigned int settings[] =
+		{
+			_ModelImporter::version,
+			(unsigned int)_ModelImporter::g_postProcessSteps,
+			(unsigned int)_ModelImporter::g_normalSmoothAngle,
+			_ModelImporter::g_meshletMinTriangles,
+			model->GetLodCount()
+		};
+		float lodSettings[] =
+		{
+			model->GetLodReduction(),
+			_ModelImporter::g_lodMaxError,
+			_ModelImporter::g_lodMinReduction
+		};
+		hash.Update(settings, sizeof(settings));
+		hash.Update(lodSettings, sizeof(lodSettings));
+		return hash.Digest();
+	}
 
-		// Is this the root node?
-		if (!assimpNode->mParent || newNode.expired())
+	bool ModelImporter::ReadCached(FileStream* file, vector<_ModelImporter::Node>* nodes, vector<_ModelImporter::MeshData>* meshes, vector<_ModelImporter::MaterialData>* materials)
+	{
+		// The files Assimp read besides the model have to be unchanged too
+		unsigned int dependencyCount = file->ReadUInt();
+		for (unsigned int i = 0; i < dependencyCount; i++)
 		{
-			newNode = scene->Actor_CreateAdd();
-			model->SetRootactor(newNode.lock());
+			string path;
+			file->Read(&path);
+			if (ImportCache::ComputeKey(path, 0) != _ModelImporter::ReadHash(file))
+				return false;
+		}
 
-			int jobCount;
-			ComputeNodeCount(assimpNode, &jobCount);
-			ProgressReport::Get().SetJobCount(g_progress_ModelImporter, jobCount);
+		nodes->resize(file->ReadUInt());
+		for (auto& node : *nodes)
+		{
+			file->Read(&node.name);
+			node.parent = file->ReadInt();
+			node.mesh	= file->ReadInt();
+			file->Read(&node.hasTransform);
+			file->Read(&node.position);
+			file->Read(&node.rotation);
+			file->Read(&node.scale);
 		}
 
-		//= GET NODE NAME ============================================================
-		// Note: In case this is the root node, aiNode.mName will be "RootNode". 
-		// To get a more descriptive name we instead get the name from the file path.
-		if (assimpNode->mParent)
+		meshes->resize(file->ReadUInt());
+		for (auto& mesh : *meshes)
 		{
-			string name = assimpNode->mName.C_Str();
-			newNode.lock()->SetName(name);
+			file->Read(&mesh.used);
+			mesh.material = file->ReadInt();
+			file->Read(&mesh.boundingBox);
+			file->Read(&mesh.vertices);
+			file->Read(&mesh.indices);
+			_ModelImporter::ReadMeshlets(file, &mesh.meshlets);
+			mesh.lods.resize(file->ReadUInt());
+			for (auto& lod : mesh.lods)
+			{
+				file->Read(&lod.indices);
+				file->Read(&lod.error);
+				_ModelImporter::ReadMeshlets(file, &lod.meshlets);
+			}
+		}
 
-			ProgressReport::Get().SetStatus(g_progress_ModelImporter, "Creating actor for: " + name);
+		materials->resize(file->ReadUInt());
+		for (auto& material : *materials)
+		{
+			file->Read(&material.used);
+			file->Read(&material.name);
+			file->Read(&material.twoSided);
+			file->Read(&material.color);
+			material.textures.resize(file->ReadUInt());
+			for (auto& texture : material.textures)
+			{
+				texture.type = (TextureType)file->ReadUInt();
+				file->Read(&texture.pathOriginal);
+			}
 		}
-		else
+
+		return !nodes->empty();
+	}
+
+	bool ModelImporter::WriteCached(FileStream* file, const vector<string>& dependencies, const vector<_ModelImporter::Node>& nodes, const vector<_ModelImporter::MeshData>& meshes, const vector<_ModelImporter::MaterialData>& materials)
+	{
+		file->Write((unsigned int)dependencies.size());
+		for (const auto& dependency : dependencies)
 		{
-			string name = FileSystem::GetFileNameNoExtensionFromFilePath(m_modelPath);
-			newNode.lock()->SetName(name);
+			uint64_t hash = ImportCache::ComputeKey(dependency, 0);
+			if (hash == 0)
+				return false;
 
-			ProgressReport::Get().SetStatus(g_progress_ModelImporter, "Creating actor for: " + name);
+			file->Write(dependency);
+			_ModelImporter::WriteHash(file, hash);
 		}
-		//============================================================================
-
-		// Set the transform of parentNode as the parent of the newNode's transform
-		Transform* parentTrans = !parentNode.expired() ? parentNode.lock()->GetTransform_PtrRaw() : nullptr;
-		newNode.lock()->GetTransform_PtrRaw()->SetParent(parentTrans);
 
-		// Set the transformation matrix of the Assimp node to the new node
-		AssimpHelper::SetActorTransform(newNode, assimpNode);
+		file->Write((unsigned int)nodes.size());
+		for (const auto& node : nodes)
+		{
+			file->Write(node.name);
+			file->Write(node.parent);
+			file->Write(node.mesh);
+			file->Write(node.hasTransform);
+			file->Write(node.position);
+			file->Write(node.rotation);
+			file->Write(node.scale);
+		}
 
-		// Process all the node's meshes
-		for (unsigned int i = 0; i < assimpNode->mNumMeshes; i++)
+		file->Write((unsigned int)meshes.size());
+		for (const auto& mesh : meshes)
 		{
-			weak_ptr<Actor> actor = newNode; // set the current actor
-			aiMesh* mesh = assimpScene->mMeshes[assimpNode->mMeshes[i]]; // get mesh
-			string name = assimpNode->mName.C_Str(); // get name
+			file->Write(mesh.used);
+			file->Write(mesh.material);
+			file->Write(mesh.boundingBox);
+			file->Write(mesh.vertices);
+			file->Write(mesh.indices);
+			_ModelImporter::WriteMeshlets(file, mesh.meshlets);
+			file->Write((unsigned int)mesh.lods.size());
+			for (const auto& lod : mesh.lods)
+			{
+				file->Write(lod.indices);
+				file->Write(lod.error);
+				_ModelImporter::WriteMeshlets(file, lod.meshlets);
+			}
+		}
 
-			// if this node has many meshes, then assign a new actor for each one of them
-			if (assimpNode->mNumMeshes > 1)
+		file->Write((unsigned int)materials.size());
+		for (const auto& material : materials)
+		{
+			file->Write(material.used);
+			file->Write(material.name);
+			file->Write(material.twoSided);
+			file->Write(material.color);
+			file->Write((unsigned int)material.textures.size());
+			for (const auto& texture : material.textures)
 			{
-				actor = scene->Actor_CreateAdd(); // create
-				actor.lock()->GetTransform_PtrRaw()->SetParent(newNode.lock()->GetTransform_PtrRaw()); // set parent
-				name += "_" + to_string(i + 1); // set name
+				file->Write((unsigned int)texture.type);
+				file->Write(texture.pathOriginal);
 			}
+		}
+
+		return true;
+	}
+	//============================================================================================
 
-			// Set actor name
-			actor.lock()->SetName(name);
+	//= PROCESSING ===============================================================================
+	void ModelImporter::ReadNodeHierarchy(const aiScene* assimpScene, aiNode* assimpNode, int parent, vector<_ModelImporter::Node>* nodes)
+	{
+		// Note: In case this is the root node, aiNode.mName will be "RootNode". 
+		// To get a more descriptive name we instead get the name from the file path.
+		string name	= assimpNode->mParent ? assimpNode->mName.C_Str() : FileSystem::GetFileNameNoExtensionFromFilePath(m_modelPath);
+		int index			= (int)nodes->size();
+		Matrix transform	= AssimpHelper::aiMatrix4x4ToMatrix(assimpNode->mTransformation);
+		nodes->push_back({ name, parent, -1, true, transform.GetTranslation(), transform.GetRotation(), transform.GetScale() });
 
-			// Process mesh
-			LoadMesh(model, mesh, assimpScene, actor);
+		// A single mesh goes on the node itself, if this node has many meshes, then each one of them gets its own child
+		if (assimpNode->mNumMeshes == 1)
+		{
+			(*nodes)[index].mesh = (int)assimpNode->mMeshes[0];
+		}
+		else
+		{
+			for (unsigned int i = 0; i < assimpNode->mNumMeshes; i++)
+			{
+				nodes->push_back({ string(assimpNode->mName.C_Str()) + "_" + to_string(i + 1), index, (int)assimpNode->mMeshes[i], false });
+			}
 		}
 
 		// Process children
 		for (unsigned int i = 0; i < assimpNode->mNumChildren; i++)
 		{
-			weak_ptr<Actor> child = scene->Actor_CreateAdd();
-			ReadNodeHierarchy(model, assimpScene, assimpNode->mChildren[i], newNode, child);
+			ReadNodeHierarchy(assimpScene, assimpNode->mChildren[i], index, nodes);
 		}
+	}
+
+	bool ModelImporter::Commit(Model* model, const vector<_ModelImporter::Node>& nodes, const vector<_ModelImporter::MeshData>& meshes, const vector<weak_ptr<Material>>& materials)
+	{
+		auto world = m_context->GetSubsystem<World>();
+		return world->MainThread_Run([world, model, &nodes, &meshes, &materials]()
+		{
+			vector<shared_ptr<Actor>> actors;
+			actors.reserve(nodes.size());
+			for (const auto& node : nodes)
+			{
+				auto actor = world->Actor_CreateAdd().lock();
+				actor->SetName(node.name);
+				if (node.parent == -1)
+				{
+					model->SetRootactor(actor);
+				}
+
+				// Set the transform of the parent as the parent of this actor's transform
+				Transform* parentTrans = node.parent != -1 ? actors[node.parent]->GetTransform_PtrRaw() : nullptr;
+				actor->GetTransform_PtrRaw()->SetParent(parentTrans);
+
+				// Set the transformation of the Assimp node to the new actor
+				if (node.hasTransform)
+				{
+					actor->GetTransform_PtrRaw()->SetPositionLocal(node.position);
+					actor->GetTransform_PtrRaw()->SetRotationLocal(node.rotation);
+					actor->GetTransform_PtrRaw()->SetScaleLocal(node.scale);
+				}
+
+				if (node.mesh != -1)
+				{
+					const auto& mesh	= meshes[node.mesh];
+					auto renderable		= actor->AddComponent<Renderable>().lock();
+					renderable->Geometry_Set(node.name, mesh.indexOffset, mesh.indexCount, mesh.vertexOffset, mesh.vertexCount, mesh.boundingBox, model);
+					if (mesh.material != -1 && !materials[mesh.material].expired())
+					{
+						renderable->Material_Set(materials[mesh.material], false);
+					}
+				}
 
-		ProgressReport::Get().IncrementJobsDone(g_progress_ModelImporter);
+				actors.emplace_back(actor);
+				ProgressReport::Get().IncrementJobsDone(g_progress_ModelImporter);
+			}
+		});
 	}
 
 	void ModelImporter::ReadAnimations(Model* model, const aiScene* scene)
@@ -283,49 +782,35 @@ namespace Directus
 		}
 	}
 
-	void ModelImporter::LoadMesh(Model* model, aiMesh* assimpMesh, const aiScene* assimpScene, const weak_ptr<Actor>& parentActor)
+	void ModelImporter::LoadMesh(Model* model, aiMesh* assimpMesh, _ModelImporter::MeshData* mesh)
 	{
-		if (!model || !assimpMesh || !assimpScene || parentActor.expired())
+		if (!model || !assimpMesh || !mesh)
 			return;
 
-		//= MESH ======================================================================
-		vector<RHI_Vertex_PosUVTBN> vertices;
-		AssimpMesh_ExtractVertices(assimpMesh, &vertices);
-
-		vector<unsigned int> indices;
-		AssimpMesh_ExtractIndices(assimpMesh, &indices);
-
-		// Add the mesh to the model
-		unsigned int indexOffset;
-		unsigned int vertexOffset;
-		model->Geometry_Append(indices, vertices, &indexOffset, &vertexOffset);
-
-		// Add a renderable component to this Actor
-		auto actorShared	= parentActor.lock();
-		auto renderable			= actorShared->AddComponent<Renderable>().lock();
-
-		// Set the geometry
-		renderable->Geometry_Set(
-			actorShared->GetName(),
-			indexOffset,
-			(unsigned int)indices.size(),
-			vertexOffset,
-			(unsigned int)vertices.size(),
-			BoundingBox(vertices),
-			model
-		);
-		//=============================================================================
-
-		//= MATERIAL ========================================================================
-		auto material = shared_ptr<Material>();
-		if (assimpScene->HasMaterials())
-		{
-			// Get aiMaterial
-			aiMaterial* assimpMaterial = assimpScene->mMaterials[assimpMesh->mMaterialIndex];
-			// Convert it and add it to the model
-			model->AddMaterial(AiMaterialToMaterial(model, assimpMaterial), parentActor);
-		}
-		//===================================================================================
+		AssimpMesh_ExtractVertices(assimpMesh, &mesh->vertices);
+		AssimpMesh_ExtractIndices(assimpMesh, &mesh->indices);
+		mesh->boundingBox = BoundingBox(mesh->vertices);
+
+		// Reorder for the vertex cache, overdraw and vertex fetch
+		MeshOptimizer::Optimize(&mesh->vertices, &mesh->indices);
+		mesh->meshlets = _ModelImporter::BuildMeshlets(mesh->vertices, &mesh->indices);
+
+		// Simplify every level from the previous one, their errors add up
+		const vector<unsigned int>* lodIndices	= &mesh->indices;
+		float lodError							= 0.0f;
+		for (unsigned int lod = 1; lod < model->GetLodCount(); lod++)
+		{
+			unsigned int target = (unsigned int)(lodIndices->size() * model->GetLodReduction()) / 3 * 3;
+			vector<unsigned int> simplified;
+			lodError += MeshSimplifier::Simplify(mesh->vertices, *lodIndices, target, _ModelImporter::g_lodMaxError - lodError, &simplified);
+			if (simplified.size() > lodIndices->size() * _ModelImporter::g_lodMinReduction)
+				break;
+
+			MeshOptimizer::Indices_OptimizeCache(&simplified, (unsigned int)mesh->vertices.size(), 16);
+			vector<Meshlet> meshlets = _ModelImporter::BuildMeshlets(mesh->vertices, &simplified);
+			mesh->lods.push_back({ move(simplified), move(meshlets), lodError });
+			lodIndices = &mesh->lods.back().indices;
+		}
 
 		//= BONES ======================================================================
 		for (unsigned int boneIndex = 0; boneIndex < assimpMesh->mNumBones; boneIndex++)
@@ -387,10 +872,12 @@ namespace Directus
 
 	void ModelImporter::AssimpMesh_ExtractIndices(aiMesh* assimpMesh, vector<unsigned int>* indices)
 	{
+		indices->reserve(assimpMesh->mNumFaces * 3);
+
 		// Get indices by iterating through each face of the mesh.
 		for (unsigned int faceIndex = 0; faceIndex < assimpMesh->mNumFaces; faceIndex++)
 		{
-			aiFace face = assimpMesh->mFaces[faceIndex];
+			const aiFace& face = assimpMesh->mFaces[faceIndex];
 
 			if (face.mNumIndices < 3)
 				continue;
@@ -402,31 +889,43 @@ namespace Directus
 		}
 	}
 
-	shared_ptr<Material> ModelImporter::AiMaterialToMaterial(Model* model, aiMaterial* assimpMaterial)
+	void ModelImporter::AiMaterial_ExtractTextures(aiMaterial* assimpMaterial, vector<_ModelImporter::MaterialTexture>* textures)
 	{
-		if (!model || !assimpMaterial)
+		auto ExtractTexture = [this, &assimpMaterial, &textures](aiTextureType assimpTex, TextureType engineTex)
 		{
-			LOG_WARNING("ModelImporter::AiMaterialToMaterial(): One of the provided materials is null, can't execute function");
-			return nullptr;
-		}
+			aiString texturePath;
+			if (assimpMaterial->GetTextureCount(assimpTex) > 0)
+			{
+				if (assimpMaterial->GetTexture(assimpTex, 0, &texturePath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
+				{
+					textures->push_back({ engineTex, texturePath.data, ValidateTexturePath(texturePath.data) });
+				}
+			}
+		};
 
-		auto material = make_shared<Material>(m_context);
+		ExtractTexture(aiTextureType_DIFFUSE,	TextureType_Albedo);
+		ExtractTexture(aiTextureType_SHININESS,	TextureType_Roughness); // Specular as roughness
+		ExtractTexture(aiTextureType_AMBIENT,	TextureType_Metallic);	// Ambient as metallic
+		ExtractTexture(aiTextureType_NORMALS,	TextureType_Normal);
+		ExtractTexture(aiTextureType_LIGHTMAP,	TextureType_Occlusion);
+		ExtractTexture(aiTextureType_EMISSIVE,	TextureType_Emission);
+		ExtractTexture(aiTextureType_HEIGHT,	TextureType_Height);
+		ExtractTexture(aiTextureType_OPACITY,	TextureType_Mask);
+	}
 
+	void ModelImporter::ReadMaterial(aiMaterial* assimpMaterial, _ModelImporter::MaterialData* material)
+	{
 		// NAME
 		aiString name;
 		aiGetMaterialString(assimpMaterial, AI_MATKEY_NAME, &name);
-		material->SetResourceName(name.C_Str());
-		material->SetModelID(GUIDGenerator::ToUnsignedInt(model->GetResourceName()));
+		material->name = name.C_Str();
 
 		// CULL MODE
 		// Specifies whether meshes using this material must be rendered 
 		// without back face CullMode. 0 for false, !0 for true.
 		bool isTwoSided = false;
 		int result = assimpMaterial->Get(AI_MATKEY_TWOSIDED, isTwoSided);
-		if (result == aiReturn_SUCCESS && isTwoSided)
-		{
-			material->SetCullMode(Cull_None);
-		}
+		material->twoSided = result == aiReturn_SUCCESS && isTwoSided;
 
 		// DIFFUSE COLOR
 		aiColor4D colorDiffuse(1.0f, 1.0f, 1.0f, 1.0f);
@@ -436,40 +935,43 @@ namespace Directus
 		aiColor4D opacity(1.0f, 1.0f, 1.0f, 1.0f);
 		aiGetMaterialColor(assimpMaterial, AI_MATKEY_OPACITY, &opacity);
 
-		material->SetColorAlbedo(Vector4(colorDiffuse.r, colorDiffuse.g, colorDiffuse.b, opacity.r));
+		material->color = Vector4(colorDiffuse.r, colorDiffuse.g, colorDiffuse.b, opacity.r);
 
 		// TEXTURES
-		auto LoadMatTex = [this, &model, &assimpMaterial, &material](aiTextureType assimpTex, TextureType engineTex)
+		AiMaterial_ExtractTextures(assimpMaterial, &material->textures);
+	}
+
+	shared_ptr<Material> ModelImporter::CreateMaterial(Model* model, const _ModelImporter::MaterialData& materialData)
+	{
+		if (!model)
 		{
-			aiString texturePath;
-			if (assimpMaterial->GetTextureCount(assimpTex) > 0)
-			{
-				if (assimpMaterial->GetTexture(assimpTex, 0, &texturePath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
-				{
-					auto deducedPath = ValidateTexturePath(texturePath.data);
-					if (FileSystem::IsSupportedImageFile(deducedPath))
-					{
-						model->AddTexture(material, engineTex, ValidateTexturePath(texturePath.data));
-					}
+			LOG_WARNING("ModelImporter::CreateMaterial: The provided model is null, can't execute function");
+			return nullptr;
+		}
 
-					if (assimpTex == aiTextureType_DIFFUSE)
-					{
-						// FIX: materials that have a diffuse texture should not be tinted black/grey
-						material->SetColorAlbedo(Vector4::One);
-					}
-				}
+		auto material = make_shared<Material>(m_context);
+		material->SetResourceName(materialData.name);
+		material->SetModelID(GUIDGenerator::ToUnsignedInt(model->GetResourceName()));
+		if (materialData.twoSided)
+		{
+			material->SetCullMode(Cull_None);
+		}
+		material->SetColorAlbedo(materialData.color);
+
+		// TEXTURES (already imported)
+		for (const auto& texture : materialData.textures)
+		{
+			if (!texture.texture.expired())
+			{
+				material->SetTextureSlot(texture.type, texture.texture, false);
 			}
-		};
 
-		LoadMatTex(aiTextureType_DIFFUSE,	TextureType_Albedo);
-		LoadMatTex(aiTextureType_SHININESS,	TextureType_Roughness); // Specular as roughness
-		LoadMatTex(aiTextureType_AMBIENT,	TextureType_Metallic);	// Ambient as metallic
-		LoadMatTex(aiTextureType_NORMALS,	TextureType_Normal);
-		LoadMatTex(aiTextureType_LIGHTMAP,	TextureType_Occlusion);
-		LoadMatTex(aiTextureType_EMISSIVE,	TextureType_Emission);
-		LoadMatTex(aiTextureType_LIGHTMAP,	TextureType_Occlusion);
-		LoadMatTex(aiTextureType_HEIGHT,	TextureType_Height);
-		LoadMatTex(aiTextureType_OPACITY,	TextureType_Mask);
+			if (texture.type == TextureType_Albedo)
+			{
+				// FIX: materials that have a diffuse texture should not be tinted black/grey
+				material->SetColorAlbedo(Vector4::One);
+			}
+		}
 
 		return material;
 	}
@@ -536,18 +1038,4 @@ namespace Directus
 
 		return filePath;
 	}
-
-	void ModelImporter::ComputeNodeCount(aiNode* node, int* count)
-	{
-		if (!node)
-			return;
-
-		(*count)++;
-
-		// Process children
-		for (unsigned int i = 0; i < node->mNumChildren; i++)
-		{
-			ComputeNodeCount(node->mChildren[i], count);
-		}
-	}
 }
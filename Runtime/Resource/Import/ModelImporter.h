@@ -21,13 +21,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ========================
+//= INCLUDES =============================
 #include "../../Core/EngineDefs.h"
 #include "../../RHI/RHI_Definition.h"
+#include "../../Rendering/VertexPacking.h"
 #include <memory>
 #include <string>
+#include <atomic>
 #include <vector>
-//===================================
+//========================================
 
 struct aiNode;
 struct aiScene;
@@ -42,7 +44,20 @@ namespace Directus
 	class Actor;
 	class Model;
 	class Transform;
+	class FileStream;
 
+	namespace _ModelImporter
+	{
+		struct Node;
+		struct MeshData;
+		struct MaterialTexture;
+		struct MaterialData;
+	}
+
+	// Imports a model in stages: the node tree is staged (detached from the world), the meshes, textures and
+	// materials are processed in parallel jobs, the geometry is appended to the model in mesh order and
+	// finally the actors are created in one go on the main thread. The staged nodes, processed meshes and
+	// materials of unchanged models come from the import cache, which skips Assimp and the mesh processing.
 	class ENGINE_CLASS ModelImporter
 	{
 	public:
@@ -51,28 +66,34 @@ namespace Directus
 
 		bool Load(Model* model, const std::string& filePath);
 
+		// How the vertices of the models imported from now on are kept in memory and in their model file
+		void SetVertexPacking(Vertex_Packing packing)	{ m_vertexPacking = packing; }
+		Vertex_Packing GetVertexPacking()				{ return m_vertexPacking; }
+
 	private:
 		// PROCESSING
-		void ReadNodeHierarchy(
-			Model* model, 
-			const aiScene* assimpScene, 
-			aiNode* assimpNode,
-			std::weak_ptr<Actor> parentNode = std::weak_ptr<Actor>(), 
-			std::weak_ptr<Actor> newNode = std::weak_ptr<Actor>()
-		);
+		void ReadNodeHierarchy(const aiScene* assimpScene, aiNode* assimpNode, int parent, std::vector<_ModelImporter::Node>* nodes);
 		void ReadAnimations(Model* model, const aiScene* scene);
-		void LoadMesh(Model* model, aiMesh* assimpMesh, const aiScene* assimpScene, const std::weak_ptr<Actor>& parentActor);
+		void LoadMesh(Model* model, aiMesh* assimpMesh, _ModelImporter::MeshData* mesh);
 		void AssimpMesh_ExtractVertices(aiMesh* assimpMesh, std::vector<RHI_Vertex_PosUVTBN>* vertices);
 		void AssimpMesh_ExtractIndices(aiMesh* assimpMesh, std::vector<unsigned int>* indices);
-		std::shared_ptr<Material> AiMaterialToMaterial(Model* model, aiMaterial* assimpMaterial);
+		void AiMaterial_ExtractTextures(aiMaterial* assimpMaterial, std::vector<_ModelImporter::MaterialTexture>* textures);
+		void ReadMaterial(aiMaterial* assimpMaterial, _ModelImporter::MaterialData* material);
+		std::shared_ptr<Material> CreateMaterial(Model* model, const _ModelImporter::MaterialData& materialData);
+		bool Commit(Model* model, const std::vector<_ModelImporter::Node>& nodes, const std::vector<_ModelImporter::MeshData>& meshes, const std::vector<std::weak_ptr<Material>>& materials);
+
+		// IMPORT CACHE
+		uint64_t ComputeSettingsHash(Model* model);
+		bool ReadCached(FileStream* file, std::vector<_ModelImporter::Node>* nodes, std::vector<_ModelImporter::MeshData>* meshes, std::vector<_ModelImporter::MaterialData>* materials);
+		bool WriteCached(FileStream* file, const std::vector<std::string>& dependencies, const std::vector<_ModelImporter::Node>& nodes, const std::vector<_ModelImporter::MeshData>& meshes, const std::vector<_ModelImporter::MaterialData>& materials);
 
 		// HELPER FUNCTIONS
 		std::string ValidateTexturePath(const std::string& texturePath);
 		std::string TryPathWithMultipleExtensions(const std::string& fullpath);
-		void ComputeNodeCount(aiNode* node, int* count);
 	
 		Model* m_model;
 		std::string m_modelPath;
+		std::atomic<Vertex_Packing> m_vertexPacking = Vertex_Packing_None;
 
 		Context* m_context;
 	};
@@ -0,0 +1,304 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========================
+#include "PixelConverter.h"
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include "../../Threading/Threading.h"
+#include "../../Logging/Log.h"
+//====================================
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PIXEL_CONVERTER_SSE
+	#include <emmintrin.h>
+#endif
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _PixelConverter
+	{
+		// Destination texels per job
+		static const unsigned int bandTexels = 256 * 1024;
+
+		// Same rounding as FreeImage's own conversions
+		inline uint8_t Expand5(unsigned int value) { return uint8_t(value * 255 / 31); }
+		inline uint8_t Expand6(unsigned int value) { return uint8_t(value * 255 / 63); }
+
+		inline uint8_t FloatToUnorm8(float value)
+		{
+			// Written so that NaN ends up as 0
+			value = !(value > 0.0f) ? 0.0f : value < 1.0f ? value : 1.0f;
+			return uint8_t(value * 255.0f + 0.5f);
+		}
+
+		inline void Store(uint8_t* dst, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+		{
+			dst[0] = r;
+			dst[1] = g;
+			dst[2] = b;
+			dst[3] = a;
+		}
+
+		#if defined(PIXEL_CONVERTER_SSE)
+		// The smallest of the bytes that hold alpha (the last of every pixel)
+		inline uint8_t MinAlpha(__m128i minimum)
+		{
+			alignas(16) uint8_t bytes[16];
+			_mm_store_si128(reinterpret_cast<__m128i*>(bytes), minimum);
+			return min(min(bytes[3], bytes[7]), min(bytes[11], bytes[15]));
+		}
+		#endif
+
+		// Every row converter returns the smallest alpha it wrote
+		inline uint8_t ConvertPalette(const uint8_t* src, unsigned int width, unsigned int bits, const uint32_t* palette, uint8_t* dst)
+		{
+			unsigned int perByte	= 8 / bits;
+			unsigned int mask		= (1u << bits) - 1;
+			uint8_t alpha			= 255;
+			for (unsigned int x = 0; x < width; x++, dst += 4)
+			{
+				unsigned int shift	= (perByte - 1 - x % perByte) * bits;
+				unsigned int index	= (src[x / perByte] >> shift) & mask;
+				memcpy(dst, &palette[index], 4);
+				alpha = min(alpha, dst[3]);
+			}
+			return alpha;
+		}
+
+		inline uint8_t Convert16(const uint8_t* src, unsigned int width, bool is565, uint8_t* dst)
+		{
+			const uint16_t* pixels = reinterpret_cast<const uint16_t*>(src);
+			for (unsigned int x = 0; x < width; x++, dst += 4)
+			{
+				unsigned int pixel = pixels[x];
+				if (is565)
+				{
+					Store(dst, Expand5((pixel >> 11) & 0x1F), Expand6((pixel >> 5) & 0x3F), Expand5(pixel & 0x1F), 255);
+				}
+				else
+				{
+					Store(dst, Expand5((pixel >> 10) & 0x1F), Expand5((pixel >> 5) & 0x1F), Expand5(pixel & 0x1F), 255);
+				}
+			}
+			return 255;
+		}
+
+		inline uint8_t ConvertRGB8(const uint8_t* src, unsigned int width, bool bgr, uint8_t* dst)
+		{
+			unsigned int r = bgr ? 2 : 0;
+			unsigned int b = bgr ? 0 : 2;
+			for (unsigned int x = 0; x < width; x++, src += 3, dst += 4)
+			{
+				Store(dst, src[r], src[1], src[b], 255);
+			}
+			return 255;
+		}
+
+		inline uint8_t ConvertRGBA8(const uint8_t* src, unsigned int width, bool bgra, uint8_t* dst)
+		{
+			unsigned int x = 0;
+			uint8_t alpha = 255;
+			#if defined(PIXEL_CONVERTER_SSE)
+			// 4 pixels at a time, red and blue trade places with two shifts
+			const __m128i maskRB	= _mm_set1_epi32(0x00FF00FF);
+			__m128i minimum			= _mm_set1_epi8(-1);
+			for (; x + 4 <= width; x += 4)
+			{
+				__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+				if (bgra)
+				{
+					__m128i rb	= _mm_and_si128(pixels, maskRB);
+					__m128i ga	= _mm_andnot_si128(maskRB, pixels);
+					rb			= _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), _mm_or_si128(rb, ga));
+				}
+				else
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), pixels);
+				}
+				minimum = _mm_min_epu8(minimum, pixels);
+			}
+			alpha = MinAlpha(minimum);
+			#endif
+
+			unsigned int r = bgra ? 2 : 0;
+			unsigned int b = bgra ? 0 : 2;
+			for (; x < width; x++)
+			{
+				const uint8_t* pixel = src + x * 4;
+				Store(dst + x * 4, pixel[r], pixel[1], pixel[b], pixel[3]);
+				alpha = min(alpha, pixel[3]);
+			}
+			return alpha;
+		}
+
+		inline uint8_t ConvertUNorm16(const uint8_t* src, unsigned int width, unsigned int channels, uint8_t* dst)
+		{
+			const uint16_t* pixels	= reinterpret_cast<const uint16_t*>(src);
+			uint8_t alpha			= 255;
+			for (unsigned int x = 0; x < width; x++, pixels += channels, dst += 4)
+			{
+				if (channels == 1)
+				{
+					uint8_t value = uint8_t(pixels[0] >> 8);
+					Store(dst, value, value, value, 255);
+				}
+				else
+				{
+					Store(dst, uint8_t(pixels[0] >> 8), uint8_t(pixels[1] >> 8), uint8_t(pixels[2] >> 8), channels == 4 ? uint8_t(pixels[3] >> 8) : 255);
+					alpha = min(alpha, dst[3]);
+				}
+			}
+			return alpha;
+		}
+
+		inline uint8_t ConvertFloat(const uint8_t* src, unsigned int width, unsigned int channels, uint8_t* dst)
+		{
+			const float* pixels	= reinterpret_cast<const float*>(src);
+			unsigned int x		= 0;
+			uint8_t alpha		= 255;
+			#if defined(PIXEL_CONVERTER_SSE)
+			// 4 pixels at a time, every register holds one and the conversions pack them into 16 bytes
+			if (channels == 4)
+			{
+				const __m128 zero	= _mm_setzero_ps();
+				const __m128 scale	= _mm_set1_ps(255.0f);
+				const __m128 half	= _mm_set1_ps(0.5f);
+				__m128i minimum		= _mm_set1_epi8(-1);
+				auto convert = [&](const float* pixel)
+				{
+					// max() returns its second operand for NaN
+					__m128 value = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(pixel), scale), zero), scale);
+					return _mm_cvttps_epi32(_mm_add_ps(value, half));
+				};
+				for (; x + 4 <= width; x += 4, pixels += 16)
+				{
+					__m128i lo		= _mm_packs_epi32(convert(pixels + 0), convert(pixels + 4));
+					__m128i hi		= _mm_packs_epi32(convert(pixels + 8), convert(pixels + 12));
+					__m128i bytes	= _mm_packus_epi16(lo, hi);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), bytes);
+					minimum = _mm_min_epu8(minimum, bytes);
+				}
+				alpha = MinAlpha(minimum);
+			}
+			#endif
+
+			for (; x < width; x++, pixels += channels)
+			{
+				uint8_t* pixel = dst + x * 4;
+				if (channels == 1)
+				{
+					uint8_t value = FloatToUnorm8(pixels[0]);
+					Store(pixel, value, value, value, 255);
+				}
+				else
+				{
+					Store(pixel, FloatToUnorm8(pixels[0]), FloatToUnorm8(pixels[1]), FloatToUnorm8(pixels[2]), channels == 4 ? FloatToUnorm8(pixels[3]) : 255);
+					alpha = min(alpha, pixel[3]);
+				}
+			}
+			return alpha;
+		}
+
+		inline uint8_t ConvertRow(const PixelSource& source, const uint8_t* src, uint8_t* dst)
+		{
+			switch (source.format)
+			{
+				case PixelFormat_Palette1:	return ConvertPalette(src, source.width, 1, source.palette, dst);
+				case PixelFormat_Palette4:	return ConvertPalette(src, source.width, 4, source.palette, dst);
+				case PixelFormat_Palette8:	return ConvertPalette(src, source.width, 8, source.palette, dst);
+				case PixelFormat_BGR565:	return Convert16(src, source.width, true, dst);
+				case PixelFormat_BGR555:	return Convert16(src, source.width, false, dst);
+				case PixelFormat_RGB8:		return ConvertRGB8(src, source.width, false, dst);
+				case PixelFormat_BGR8:		return ConvertRGB8(src, source.width, true, dst);
+				case PixelFormat_RGBA8:		return ConvertRGBA8(src, source.width, false, dst);
+				case PixelFormat_BGRA8:		return ConvertRGBA8(src, source.width, true, dst);
+				case PixelFormat_R16:		return ConvertUNorm16(src, source.width, 1, dst);
+				case PixelFormat_RGB16:		return ConvertUNorm16(src, source.width, 3, dst);
+				case PixelFormat_RGBA16:	return ConvertUNorm16(src, source.width, 4, dst);
+				case PixelFormat_R32F:		return ConvertFloat(src, source.width, 1, dst);
+				case PixelFormat_RGB32F:	return ConvertFloat(src, source.width, 3, dst);
+				case PixelFormat_RGBA32F:	return ConvertFloat(src, source.width, 4, dst);
+				default:					return 255;
+			}
+		}
+	}
+
+	bool PixelConverter::Convert(const PixelSource& source, std::byte* rgba, bool* transparent, Threading* threading)
+	{
+		if (!source.data || !rgba || source.width == 0 || source.height == 0 || source.format >= PixelFormat_Unknown)
+			return false;
+
+		bool palettized = source.format == PixelFormat_Palette1 || source.format == PixelFormat_Palette4 || source.format == PixelFormat_Palette8;
+		if (palettized && !source.palette)
+		{
+			LOG_ERROR("PixelConverter::Convert: A palette is required.");
+			return false;
+		}
+
+		unsigned int rowsPerJob	= max(1u, _PixelConverter::bandTexels / source.width);
+		unsigned int jobCount	= (source.height + rowsPerJob - 1) / rowsPerJob;
+		atomic<bool> anyTransparent(false);
+
+		auto band = [&](unsigned int job)
+		{
+			unsigned int rowBegin	= job * rowsPerJob;
+			unsigned int rowEnd		= min(rowBegin + rowsPerJob, source.height);
+			uint8_t alpha			= 255;
+			for (unsigned int y = rowBegin; y < rowEnd; y++)
+			{
+				const uint8_t* src	= reinterpret_cast<const uint8_t*>(source.data + (ptrdiff_t)y * source.pitch);
+				uint8_t* dst		= reinterpret_cast<uint8_t*>(rgba) + (size_t)y * source.width * 4;
+				alpha				= min(alpha, _PixelConverter::ConvertRow(source, src, dst));
+			}
+
+			if (alpha != 255)
+			{
+				anyTransparent = true;
+			}
+		};
+
+		if (threading && jobCount > 1)
+		{
+			threading->ParallelFor(0, jobCount, band, 1);
+		}
+		else
+		{
+			for (unsigned int i = 0; i < jobCount; i++)
+			{
+				band(i);
+			}
+		}
+
+		if (transparent)
+		{
+			*transparent = anyTransparent;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,76 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <cstddef>
+#include <cstdint>
+#include "../../Core/EngineDefs.h"
+//================================
+
+namespace Directus
+{
+	class Threading;
+
+	// Memory layouts of source pixels, the names list the channels in the order they are stored
+	enum PixelFormat
+	{
+		PixelFormat_Palette1,	// 8 pixels per byte, most significant bit first
+		PixelFormat_Palette4,	// 2 pixels per byte, high nibble first
+		PixelFormat_Palette8,
+		PixelFormat_BGR565,		// 16-bit words, blue in the low bits
+		PixelFormat_BGR555,
+		PixelFormat_RGB8,
+		PixelFormat_BGR8,
+		PixelFormat_RGBA8,
+		PixelFormat_BGRA8,
+		PixelFormat_R16,		// Grayscale
+		PixelFormat_RGB16,
+		PixelFormat_RGBA16,
+		PixelFormat_R32F,		// Grayscale
+		PixelFormat_RGB32F,
+		PixelFormat_RGBA32F,
+		PixelFormat_Unknown
+	};
+
+	// Rows of pixels somewhere in memory
+	struct PixelSource
+	{
+		const std::byte* data	= nullptr;	// The row that ends up at the top of the destination
+		ptrdiff_t pitch			= 0;		// Bytes from one row to the next, negative flips the image vertically
+		unsigned int width		= 0;
+		unsigned int height		= 0;
+		PixelFormat format		= PixelFormat_Unknown;
+		const uint32_t* palette	= nullptr;	// RGBA8 colors (as stored in memory), required by the palette formats
+	};
+
+	// Converts images to tightly packed RGBA8 in a single pass, writing straight into a preallocated buffer.
+	// 16-bit channels keep their high byte, float channels are clamped to [0, 1] (no tone mapping).
+	// Rows are converted in parallel bands when a Threading subsystem is provided.
+	class ENGINE_CLASS PixelConverter
+	{
+	public:
+		// rgba has to hold width * height * 4 bytes, returns false for an unknown format.
+		// transparent (optional) is set to whether any pixel has an alpha below 255.
+		static bool Convert(const PixelSource& source, std::byte* rgba, bool* transparent = nullptr, Threading* threading = nullptr);
+	};
+}
@@ -0,0 +1,766 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ====================
+#include "TextureCompressor.h"
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include "../../RHI/RHI_Texture.h"
+#include "../../Threading/Threading.h"
+#include "../../Logging/Log.h"
+//===============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _TextureCompressor
+	{
+		// Blocks per job, an 8x8 block row of a 2048 texture
+		static const unsigned int blocksPerJob = 512;
+
+		// Interpolation weights of BC7 4-bit indices, in 1/64ths
+		static const int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		// The texels of a 4x4 block, up to 4 channels in 0-255
+		struct Block
+		{
+			float texels[16][4];
+			unsigned int channels;
+		};
+
+		// Reads channels [first, first + count) of a block, texels past the edge of the mip repeat the last row/column
+		inline void Load(const std::byte* rgba, unsigned int width, unsigned int height, unsigned int blockX, unsigned int blockY, unsigned int first, unsigned int count, Block* block)
+		{
+			block->channels = count;
+			for (unsigned int y = 0; y < 4; y++)
+			{
+				unsigned int texelY = min(blockY * 4 + y, height - 1);
+				for (unsigned int x = 0; x < 4; x++)
+				{
+					unsigned int texelX		= min(blockX * 4 + x, width - 1);
+					const std::byte* texel	= rgba + ((size_t)texelY * width + texelX) * 4 + first;
+					for (unsigned int c = 0; c < count; c++)
+					{
+						block->texels[y * 4 + x][c] = (float)texel[c];
+					}
+				}
+			}
+		}
+
+		inline int Round(float value, int maximum)
+		{
+			return max(0, min((int)(value + 0.5f), maximum));
+		}
+
+		// An encoding describes the levels of a line between two endpoints, in logical order (from the first endpoint to the second),
+		// how endpoints are quantized and the distance between neighbouring quantized values. Endpoints are kept decoded (0-255),
+		// the encoded bits can be derived from them.
+		struct Encoding_BC1
+		{
+			static const unsigned int levels = 4;
+			static float Weight(unsigned int level) { return level / 3.0f; }
+			static int Interpolate(int a, int b, unsigned int level) { return ((3 - level) * a + level * b + 1) / 3; }
+			static float Step(unsigned int channel) { return channel == 1 ? 4.0f : 8.0f; }
+			static void Quantize(const float* endpoint, int* decoded, unsigned int)
+			{
+				static const int bits[3] = { 5, 6, 5 };
+				for (unsigned int c = 0; c < 3; c++)
+				{
+					int max		= (1 << bits[c]) - 1;
+					int value	= Round(endpoint[c] * max / 255.0f, max);
+					decoded[c]	= (value << (8 - bits[c])) | (value >> (2 * bits[c] - 8));
+				}
+			}
+		};
+
+		struct Encoding_BC4
+		{
+			static const unsigned int levels = 8;
+			static float Weight(unsigned int level) { return level / 7.0f; }
+			static int Interpolate(int a, int b, unsigned int level) { return ((7 - level) * a + level * b + 3) / 7; }
+			static float Step(unsigned int) { return 1.0f; }
+			static void Quantize(const float* endpoint, int* decoded, unsigned int) { decoded[0] = Round(endpoint[0], 255); }
+		};
+
+		struct Encoding_BC7Mode6
+		{
+			static const unsigned int levels = 16;
+			static float Weight(unsigned int level) { return bc7Weights[level] / 64.0f; }
+			static int Interpolate(int a, int b, unsigned int level) { return ((64 - bc7Weights[level]) * a + bc7Weights[level] * b + 32) >> 6; }
+			static float Step(unsigned int) { return 2.0f; }
+			// 7 bits per channel and a p-bit (the lowest bit) shared by the channels of an endpoint
+			static void Quantize(const float* endpoint, int* decoded, unsigned int channels)
+			{
+				float bestError = FLT_MAX;
+				for (int p = 0; p < 2; p++)
+				{
+					int candidate[4];
+					float error = 0.0f;
+					for (unsigned int c = 0; c < channels; c++)
+					{
+						candidate[c]	= Round((endpoint[c] - p) * 0.5f, 127) * 2 + p;
+						error			+= (candidate[c] - endpoint[c]) * (candidate[c] - endpoint[c]);
+					}
+
+					if (error < bestError)
+					{
+						bestError = error;
+						memcpy(decoded, candidate, sizeof(int) * channels);
+					}
+				}
+			}
+		};
+
+		// Picks the nearest level for every texel, returns the squared error
+		template <class Encoding>
+		inline float AssignIndices(const Block& block, const int endpoints[2][4], unsigned char* indices)
+		{
+			int palette[Encoding::levels][4];
+			for (unsigned int level = 0; level < Encoding::levels; level++)
+			{
+				for (unsigned int c = 0; c < block.channels; c++)
+				{
+					palette[level][c] = Encoding::Interpolate(endpoints[0][c], endpoints[1][c], level);
+				}
+			}
+
+			float error = 0.0f;
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				float bestDistance = FLT_MAX;
+				for (unsigned int level = 0; level < Encoding::levels; level++)
+				{
+					float distance = 0.0f;
+					for (unsigned int c = 0; c < block.channels; c++)
+					{
+						float delta = block.texels[i][c] - palette[level][c];
+						distance += delta * delta;
+					}
+
+					if (distance < bestDistance)
+					{
+						bestDistance	= distance;
+						indices[i]		= level;
+					}
+				}
+				error += bestDistance;
+			}
+
+			return error;
+		}
+
+		// Fits a line through the texels of a block and quantizes it, endpoints and indices are in the encoding's logical order
+		template <class Encoding>
+		float EncodeLine(const Block& block, TextureCompression quality, int endpoints[2][4], unsigned char* indices)
+		{
+			unsigned int channels = block.channels;
+
+			float low[4], high[4], mean[4];
+			for (unsigned int c = 0; c < channels; c++)
+			{
+				low[c]	= FLT_MAX;
+				high[c]	= -FLT_MAX;
+				mean[c]	= 0.0f;
+				for (unsigned int i = 0; i < 16; i++)
+				{
+					low[c]	= min(low[c], block.texels[i][c]);
+					high[c]	= max(high[c], block.texels[i][c]);
+					mean[c]	+= block.texels[i][c] / 16.0f;
+				}
+			}
+
+			float covariance[4][4] = {};
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				for (unsigned int a = 0; a < channels; a++)
+				{
+					for (unsigned int b = a; b < channels; b++)
+					{
+						covariance[a][b] += (block.texels[i][a] - mean[a]) * (block.texels[i][b] - mean[b]);
+					}
+				}
+			}
+
+			float start[4], end[4];
+			if (quality == TextureCompression_Fast || channels == 1)
+			{
+				// The bounding box, its diagonal follows the sign of each channel's covariance with the widest one
+				unsigned int widest = 0;
+				for (unsigned int c = 1; c < channels; c++)
+				{
+					widest = (high[c] - low[c]) > (high[widest] - low[widest]) ? c : widest;
+				}
+
+				for (unsigned int c = 0; c < channels; c++)
+				{
+					float inset	= channels == 1 ? 0.0f : (high[c] - low[c]) / 16.0f;
+					bool flip	= (c < widest ? covariance[c][widest] : covariance[widest][c]) < 0.0f;
+					start[c]	= flip ? high[c] - inset : low[c] + inset;
+					end[c]		= flip ? low[c] + inset : high[c] - inset;
+				}
+			}
+			else
+			{
+				// The principal axis (power iteration from the bounding box diagonal), endpoints are the extreme projections on it
+				float axis[4];
+				for (unsigned int c = 0; c < channels; c++)
+				{
+					axis[c] = high[c] - low[c];
+				}
+
+				for (unsigned int iteration = 0; iteration < 8; iteration++)
+				{
+					float next[4]	= {};
+					float length	= 0.0f;
+					for (unsigned int a = 0; a < channels; a++)
+					{
+						for (unsigned int b = 0; b < channels; b++)
+						{
+							next[a] += (a <= b ? covariance[a][b] : covariance[b][a]) * axis[b];
+						}
+						length = max(length, fabs(next[a]));
+					}
+
+					if (length < 1e-6f)
+						break;
+
+					for (unsigned int c = 0; c < channels; c++)
+					{
+						axis[c] = next[c] / length;
+					}
+				}
+
+				float minT = FLT_MAX, maxT = -FLT_MAX, lengthSquared = 0.0f;
+				for (unsigned int c = 0; c < channels; c++)
+				{
+					lengthSquared += axis[c] * axis[c];
+				}
+				for (unsigned int i = 0; i < 16; i++)
+				{
+					float t = 0.0f;
+					for (unsigned int c = 0; c < channels; c++)
+					{
+						t += (block.texels[i][c] - mean[c]) * axis[c];
+					}
+					minT = min(minT, t);
+					maxT = max(maxT, t);
+				}
+
+				for (unsigned int c = 0; c < channels; c++)
+				{
+					float scale = lengthSquared > 1e-6f ? axis[c] / lengthSquared : 0.0f;
+					start[c]	= mean[c] + minT * scale;
+					end[c]		= mean[c] + maxT * scale;
+				}
+			}
+
+			// Quantize, then refit the endpoints to the chosen indices with least squares (keeping the best result)
+			unsigned int refinements	= quality == TextureCompression_High ? 4 : quality == TextureCompression_Normal ? 1 : 0;
+			float bestError				= FLT_MAX;
+			for (unsigned int iteration = 0; iteration <= refinements; iteration++)
+			{
+				int candidate[2][4] = {};
+				unsigned char candidateIndices[16];
+				Encoding::Quantize(start, candidate[0], channels);
+				Encoding::Quantize(end, candidate[1], channels);
+				float error = AssignIndices<Encoding>(block, candidate, candidateIndices);
+				if (error < bestError)
+				{
+					bestError = error;
+					memcpy(endpoints, candidate, sizeof(candidate));
+					memcpy(indices, candidateIndices, sizeof(candidateIndices));
+				}
+
+				if (iteration == refinements || error == 0.0f)
+					break;
+
+				float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[4] = {}, bx[4] = {};
+				for (unsigned int i = 0; i < 16; i++)
+				{
+					float b = Encoding::Weight(candidateIndices[i]);
+					float a = 1.0f - b;
+					aa += a * a;
+					ab += a * b;
+					bb += b * b;
+					for (unsigned int c = 0; c < channels; c++)
+					{
+						ax[c] += a * block.texels[i][c];
+						bx[c] += b * block.texels[i][c];
+					}
+				}
+
+				float determinant = aa * bb - ab * ab;
+				if (fabs(determinant) < 1e-6f)
+					break;
+
+				for (unsigned int c = 0; c < channels; c++)
+				{
+					start[c]	= max(0.0f, min((bb * ax[c] - ab * bx[c]) / determinant, 255.0f));
+					end[c]		= max(0.0f, min((aa * bx[c] - ab * ax[c]) / determinant, 255.0f));
+				}
+			}
+
+			// Least squares ignores quantization, so try moving each endpoint channel to its neighbouring values
+			for (unsigned int pass = 0; pass < 2 && quality == TextureCompression_High && bestError > 0.0f; pass++)
+			{
+				for (unsigned int endpoint = 0; endpoint < 2; endpoint++)
+				{
+					for (unsigned int c = 0; c < channels; c++)
+					{
+						for (float direction : { -1.0f, 1.0f })
+						{
+							float trial[2][4];
+							for (unsigned int i = 0; i < channels; i++)
+							{
+								trial[0][i] = (float)endpoints[0][i];
+								trial[1][i] = (float)endpoints[1][i];
+							}
+							trial[endpoint][c] = max(0.0f, min(trial[endpoint][c] + direction * Encoding::Step(c), 255.0f));
+
+							int candidate[2][4] = {};
+							unsigned char candidateIndices[16];
+							Encoding::Quantize(trial[0], candidate[0], channels);
+							Encoding::Quantize(trial[1], candidate[1], channels);
+							float error = AssignIndices<Encoding>(block, candidate, candidateIndices);
+							if (error < bestError)
+							{
+								bestError = error;
+								memcpy(endpoints, candidate, sizeof(candidate));
+								memcpy(indices, candidateIndices, sizeof(candidateIndices));
+							}
+						}
+					}
+				}
+			}
+
+			return bestError;
+		}
+
+		inline void WriteBits(uint8_t* block, unsigned int& position, unsigned int value, unsigned int count)
+		{
+			for (unsigned int i = 0; i < count; i++, position++)
+			{
+				block[position >> 3] |= ((value >> i) & 1) << (position & 7);
+			}
+		}
+
+		inline unsigned int ReadBits(const uint8_t* block, unsigned int& position, unsigned int count)
+		{
+			unsigned int value = 0;
+			for (unsigned int i = 0; i < count; i++, position++)
+			{
+				value |= ((block[position >> 3] >> (position & 7)) & 1) << i;
+			}
+			return value;
+		}
+
+		inline uint16_t ToRGB565(const int* color) { return (uint16_t)(((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3)); }
+
+		inline void FromRGB565(uint16_t value, int* color)
+		{
+			int r = (value >> 11) & 31, g = (value >> 5) & 63, b = value & 31;
+			color[0] = (r << 3) | (r >> 2);
+			color[1] = (g << 2) | (g >> 4);
+			color[2] = (b << 3) | (b >> 2);
+		}
+
+		// Color of BC1 and BC3, always in the 4 color mode (the first endpoint greater than the second)
+		void EncodeBC1(const Block& block, TextureCompression quality, uint8_t* output)
+		{
+			static const unsigned char physical[4] = { 0, 2, 3, 1 };
+
+			int endpoints[2][4];
+			unsigned char indices[16];
+			EncodeLine<Encoding_BC1>(block, quality, endpoints, indices);
+
+			uint16_t color0 = ToRGB565(endpoints[0]);
+			uint16_t color1 = ToRGB565(endpoints[1]);
+			bool swap		= color0 < color1;
+			if (swap)
+			{
+				std::swap(color0, color1);
+			}
+
+			uint32_t bits = 0;
+			for (unsigned int i = 0; i < 16 && color0 != color1; i++)
+			{
+				bits |= (uint32_t)physical[swap ? 3 - indices[i] : indices[i]] << (i * 2);
+			}
+
+			memcpy(output, &color0, 2);
+			memcpy(output + 2, &color1, 2);
+			memcpy(output + 4, &bits, 4);
+		}
+
+		// Single channel of BC3 (alpha), BC4 and BC5, always in the 8 value mode (the first endpoint greater than the second)
+		void EncodeBC4(const Block& block, TextureCompression quality, uint8_t* output)
+		{
+			static const unsigned char physical[8] = { 0, 2, 3, 4, 5, 6, 7, 1 };
+
+			int endpoints[2][4];
+			unsigned char indices[16];
+			EncodeLine<Encoding_BC4>(block, quality, endpoints, indices);
+
+			bool swap = endpoints[0][0] < endpoints[1][0];
+			output[0] = (uint8_t)endpoints[swap ? 1 : 0][0];
+			output[1] = (uint8_t)endpoints[swap ? 0 : 1][0];
+
+			uint64_t bits = 0;
+			for (unsigned int i = 0; i < 16 && output[0] != output[1]; i++)
+			{
+				bits |= (uint64_t)physical[swap ? 7 - indices[i] : indices[i]] << (i * 3);
+			}
+
+			for (unsigned int i = 0; i < 6; i++)
+			{
+				output[2 + i] = (uint8_t)(bits >> (i * 8));
+			}
+		}
+
+		void EncodeBC7(const Block& block, TextureCompression quality, uint8_t* output)
+		{
+			int endpoints[2][4];
+			unsigned char indices[16];
+			EncodeLine<Encoding_BC7Mode6>(block, quality, endpoints, indices);
+
+			// The first index has an implicit high bit of 0
+			if (indices[0] >= 8)
+			{
+				swap(endpoints[0], endpoints[1]);
+				for (unsigned char& index : indices)
+				{
+					index = 15 - index;
+				}
+			}
+
+			memset(output, 0, 16);
+			unsigned int position = 0;
+			WriteBits(output, position, 1 << 6, 7);
+			for (unsigned int c = 0; c < 4; c++)
+			{
+				WriteBits(output, position, endpoints[0][c] >> 1, 7);
+				WriteBits(output, position, endpoints[1][c] >> 1, 7);
+			}
+			WriteBits(output, position, endpoints[0][0] & 1, 1);
+			WriteBits(output, position, endpoints[1][0] & 1, 1);
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				WriteBits(output, position, indices[i], i == 0 ? 3 : 4);
+			}
+		}
+
+		void EncodeBlock(const std::byte* rgba, unsigned int width, unsigned int height, unsigned int blockX, unsigned int blockY, Texture_Format format, TextureCompression quality, uint8_t* output)
+		{
+			Block block;
+			switch (format)
+			{
+			case Texture_Format_BC1_UNORM:
+				Load(rgba, width, height, blockX, blockY, 0, 3, &block);
+				EncodeBC1(block, quality, output);
+				break;
+			case Texture_Format_BC3_UNORM:
+				Load(rgba, width, height, blockX, blockY, 3, 1, &block);
+				EncodeBC4(block, quality, output);
+				Load(rgba, width, height, blockX, blockY, 0, 3, &block);
+				EncodeBC1(block, quality, output + 8);
+				break;
+			case Texture_Format_BC4_UNORM:
+				Load(rgba, width, height, blockX, blockY, 0, 1, &block);
+				EncodeBC4(block, quality, output);
+				break;
+			case Texture_Format_BC5_UNORM:
+				Load(rgba, width, height, blockX, blockY, 0, 1, &block);
+				EncodeBC4(block, quality, output);
+				Load(rgba, width, height, blockX, blockY, 1, 1, &block);
+				EncodeBC4(block, quality, output + 8);
+				break;
+			case Texture_Format_BC7_UNORM:
+				Load(rgba, width, height, blockX, blockY, 0, 4, &block);
+				EncodeBC7(block, quality, output);
+				break;
+			default:
+				break;
+			}
+		}
+
+		// Decodes the colors of a BC1 block (both modes) into RGBA texels, stride apart
+		void DecodeBC1(const uint8_t* input, std::byte* texels, size_t stride, bool alpha)
+		{
+			uint16_t color0, color1;
+			uint32_t bits;
+			memcpy(&color0, input, 2);
+			memcpy(&color1, input + 2, 2);
+			memcpy(&bits, input + 4, 4);
+
+			int palette[4][4];
+			FromRGB565(color0, palette[0]);
+			FromRGB565(color1, palette[1]);
+			for (unsigned int c = 0; c < 3; c++)
+			{
+				int a = palette[0][c], b = palette[1][c];
+				palette[2][c] = color0 > color1 ? (2 * a + b + 1) / 3 : (a + b + 1) / 2;
+				palette[3][c] = color0 > color1 ? (a + 2 * b + 1) / 3 : 0;
+			}
+			palette[0][3] = palette[1][3] = palette[2][3] = 255;
+			palette[3][3] = color0 > color1 ? 255 : 0;
+
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				const int* color	= palette[(bits >> (i * 2)) & 3];
+				std::byte* texel	= texels + (i / 4) * stride + (i % 4) * 4;
+				for (unsigned int c = 0; c < (alpha ? 4u : 3u); c++)
+				{
+					texel[c] = (std::byte)color[c];
+				}
+			}
+		}
+
+		// Decodes a BC4 block (both modes) into one channel of RGBA texels, stride apart
+		void DecodeBC4(const uint8_t* input, std::byte* texels, size_t stride)
+		{
+			int a = input[0], b = input[1];
+			int palette[8] = { a, b };
+			for (int i = 2; i < 8; i++)
+			{
+				palette[i] = a > b ? ((8 - i) * a + (i - 1) * b + 3) / 7 : i < 6 ? ((6 - i) * a + (i - 1) * b + 2) / 5 : i == 6 ? 0 : 255;
+			}
+
+			uint64_t bits = 0;
+			for (unsigned int i = 0; i < 6; i++)
+			{
+				bits |= (uint64_t)input[2 + i] << (i * 8);
+			}
+
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				texels[(i / 4) * stride + (i % 4) * 4] = (std::byte)palette[(bits >> (i * 3)) & 7];
+			}
+		}
+
+		bool DecodeBC7(const uint8_t* input, std::byte* texels, size_t stride)
+		{
+			// Mode 6 only
+			if ((input[0] & 0x7F) != 0x40)
+				return false;
+
+			unsigned int position = 7;
+			int endpoints[2][4];
+			for (unsigned int c = 0; c < 4; c++)
+			{
+				endpoints[0][c] = ReadBits(input, position, 7) << 1;
+				endpoints[1][c] = ReadBits(input, position, 7) << 1;
+			}
+			int p0 = ReadBits(input, position, 1);
+			int p1 = ReadBits(input, position, 1);
+			for (unsigned int c = 0; c < 4; c++)
+			{
+				endpoints[0][c] |= p0;
+				endpoints[1][c] |= p1;
+			}
+
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				unsigned int index	= ReadBits(input, position, i == 0 ? 3 : 4);
+				std::byte* texel	= texels + (i / 4) * stride + (i % 4) * 4;
+				for (unsigned int c = 0; c < 4; c++)
+				{
+					texel[c] = (std::byte)Encoding_BC7Mode6::Interpolate(endpoints[0][c], endpoints[1][c], index);
+				}
+			}
+
+			return true;
+		}
+	}
+
+	Texture_Format TextureCompressor::ChooseFormat(TextureType type, bool grayscale, bool opaque, TextureCompression quality)
+	{
+		if (quality == TextureCompression_None)
+			return Texture_Format_R8G8B8A8_UNORM;
+
+		Texture_Format color = quality == TextureCompression_Fast ? (opaque ? Texture_Format_BC1_UNORM : Texture_Format_BC3_UNORM) : Texture_Format_BC7_UNORM;
+		switch (type)
+		{
+		case TextureType_Albedo:
+			return color;
+		// The shaders only read the first channel of these
+		case TextureType_Roughness:
+		case TextureType_Metallic:
+		case TextureType_Occlusion:
+		case TextureType_Emission:
+		case TextureType_Height:
+			return Texture_Format_BC4_UNORM;
+		// X and Y, the shaders reconstruct Z
+		case TextureType_Normal:
+			return Texture_Format_BC5_UNORM;
+		case TextureType_Mask:
+			return grayscale ? Texture_Format_BC4_UNORM : color;
+		// Unknown textures and cube-maps are read as RGBA8 elsewhere
+		default:
+			return Texture_Format_R8G8B8A8_UNORM;
+		}
+	}
+
+	bool TextureCompressor::Compress(const vector<vector<std::byte>>& mips, unsigned int width, unsigned int height, Texture_Format format, TextureCompression quality, vector<vector<std::byte>>* blocks, Threading* threading)
+	{
+		unsigned int blockSize = RHI_Texture::GetBlockSize(format);
+		if (!blocks || mips.empty() || blockSize == 0)
+		{
+			LOG_ERROR("TextureCompressor::Compress: Invalid parameters.");
+			return false;
+		}
+
+		if (width % 4 != 0 || height % 4 != 0)
+		{
+			LOGF_ERROR("TextureCompressor::Compress: %dx%d is not a multiple of the block size.", width, height);
+			return false;
+		}
+
+		blocks->resize(mips.size());
+		unsigned int mipWidth	= width;
+		unsigned int mipHeight	= height;
+		for (unsigned int i = 0; i < (unsigned int)mips.size(); i++)
+		{
+			if (mips[i].size() != (size_t)mipWidth * mipHeight * 4)
+			{
+				LOGF_ERROR("TextureCompressor::Compress: Mip %d has the wrong size.", i);
+				blocks->clear();
+				return false;
+			}
+
+			unsigned int blocksX	= (mipWidth + 3) / 4;
+			unsigned int blocksY	= (mipHeight + 3) / 4;
+			auto& output			= (*blocks)[i];
+			output.resize(GetMipSize(mipWidth, mipHeight, format));
+
+			const std::byte* rgba = mips[i].data();
+			auto row = [&](unsigned int blockY)
+			{
+				uint8_t* block = reinterpret_cast<uint8_t*>(output.data()) + (size_t)blockY * blocksX * blockSize;
+				for (unsigned int blockX = 0; blockX < blocksX; blockX++, block += blockSize)
+				{
+					_TextureCompressor::EncodeBlock(rgba, mipWidth, mipHeight, blockX, blockY, format, quality, block);
+				}
+			};
+
+			if (threading && (size_t)blocksX * blocksY > _TextureCompressor::blocksPerJob)
+			{
+				threading->ParallelFor(0, blocksY, row, max(1u, _TextureCompressor::blocksPerJob / blocksX));
+			}
+			else
+			{
+				for (unsigned int blockY = 0; blockY < blocksY; blockY++)
+				{
+					row(blockY);
+				}
+			}
+
+			mipWidth	= max(mipWidth / 2, 1u);
+			mipHeight	= max(mipHeight / 2, 1u);
+		}
+
+		return true;
+	}
+
+	bool TextureCompressor::Decompress(const std::byte* blocks, unsigned int width, unsigned int height, Texture_Format format, std::byte* rgba)
+	{
+		unsigned int blockSize = RHI_Texture::GetBlockSize(format);
+		if (!blocks || !rgba || blockSize == 0)
+			return false;
+
+		// Decoded into whole blocks, then cropped
+		unsigned int blocksX = (width + 3) / 4;
+		unsigned int blocksY = (height + 3) / 4;
+		size_t stride = (size_t)blocksX * 16;
+		vector<std::byte> texels(stride * blocksY * 4);
+		for (size_t i = 0; i < texels.size(); i += 4)
+		{
+			texels[i + 0] = texels[i + 1] = texels[i + 2] = (std::byte)0;
+			texels[i + 3] = (std::byte)255;
+		}
+
+		bool result = true;
+		const uint8_t* block = reinterpret_cast<const uint8_t*>(blocks);
+		for (unsigned int blockY = 0; blockY < blocksY; blockY++)
+		{
+			for (unsigned int blockX = 0; blockX < blocksX; blockX++, block += blockSize)
+			{
+				std::byte* output = texels.data() + blockY * 4 * stride + blockX * 16;
+				switch (format)
+				{
+				case Texture_Format_BC1_UNORM:
+					_TextureCompressor::DecodeBC1(block, output, stride, true);
+					break;
+				case Texture_Format_BC3_UNORM:
+					_TextureCompressor::DecodeBC4(block, output + 3, stride);
+					_TextureCompressor::DecodeBC1(block + 8, output, stride, false);
+					break;
+				case Texture_Format_BC4_UNORM:
+					_TextureCompressor::DecodeBC4(block, output, stride);
+					break;
+				case Texture_Format_BC5_UNORM:
+					_TextureCompressor::DecodeBC4(block, output, stride);
+					_TextureCompressor::DecodeBC4(block + 8, output + 1, stride);
+					break;
+				case Texture_Format_BC7_UNORM:
+					result = _TextureCompressor::DecodeBC7(block, output, stride) && result;
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		for (unsigned int y = 0; y < height; y++)
+		{
+			memcpy(rgba + (size_t)y * width * 4, texels.data() + y * stride, (size_t)width * 4);
+		}
+
+		if (!result)
+		{
+			LOG_WARNING("TextureCompressor::Decompress: Only mode 6 BC7 blocks can be decoded.");
+		}
+
+		return result;
+	}
+
+	size_t TextureCompressor::GetMipSize(unsigned int width, unsigned int height, Texture_Format format)
+	{
+		return (size_t)max((width + 3) / 4, 1u) * max((height + 3) / 4, 1u) * RHI_Texture::GetBlockSize(format);
+	}
+
+	bool TextureCompressor::IsOpaque(const vector<std::byte>& rgba)
+	{
+		for (size_t i = 3; i < rgba.size(); i += 4)
+		{
+			if (rgba[i] != (std::byte)255)
+				return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,63 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <cstddef>
+#include "../../Core/EngineDefs.h"
+#include "../../RHI/RHI_Definition.h"
+//================================
+
+namespace Directus
+{
+	class Threading;
+
+	enum TextureCompression
+	{
+		TextureCompression_None,	// RGBA8
+		TextureCompression_Fast,	// Color as BC1 (BC3 with alpha), endpoints from the bounding box of the block
+		TextureCompression_Normal,	// Color as BC7, endpoints along the principal axis of the block, refined once with least squares
+		TextureCompression_High		// As above, with more refinement passes
+	};
+
+	// Encodes RGBA8 mips into block compressed formats (BC1, BC3, BC4, BC5 and BC7), rows of blocks run in parallel.
+	// BC7 is encoded with mode 6 only (a single RGBA line with 16 levels), which is good for anything but sharp multi-colored blocks.
+	class ENGINE_CLASS TextureCompressor
+	{
+	public:
+		// The format a texture should be stored in, given its role (R8G8B8A8 when it shouldn't be compressed)
+		static Texture_Format ChooseFormat(TextureType type, bool grayscale, bool opaque, TextureCompression quality);
+
+		// The first mip has to be a multiple of 4 wide and high (a D3D requirement), smaller mips pad their blocks
+		static bool Compress(const std::vector<std::vector<std::byte>>& mips, unsigned int width, unsigned int height, Texture_Format format, TextureCompression quality, std::vector<std::vector<std::byte>>* blocks, Threading* threading = nullptr);
+
+		// Decodes one mip back to RGBA8 (channels a format doesn't have decode to 0, alpha to 255)
+		static bool Decompress(const std::byte* blocks, unsigned int width, unsigned int height, Texture_Format format, std::byte* rgba);
+
+		// Size of a mip in a block compressed format
+		static size_t GetMipSize(unsigned int width, unsigned int height, Texture_Format format);
+
+		static bool IsOpaque(const std::vector<std::byte>& rgba);
+	};
+}
@@ -0,0 +1,474 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ========================
+#include "ResourceCache.h"
+#include <algorithm>
+#include "../FileSystem/FileSystem.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace _ResourceCache
+	{
+		template <typename T>
+		inline void Erase(unordered_multimap<string_view, T*>& index, const string_view& key, T* value)
+		{
+			auto range = index.equal_range(key);
+			for (auto it = range.first; it != range.second; it++)
+			{
+				if (it->second == value)
+				{
+					index.erase(it);
+					return;
+				}
+			}
+		}
+	}
+
+	void ResourceCache::Add(const shared_ptr<IResource>& resource)
+	{
+		if (!resource)
+			return;
+
+		lock_guard<mutex> guard(m_mutex);
+
+		auto result = m_entries.try_emplace(resource->Resource_GetID());
+		if (!result.second)
+		{
+			LOGF_WARNING("ResourceCache::Add: Resource \"%s\" is already cached", resource->GetResourceName().c_str());
+			return;
+		}
+
+		auto& group		= m_resourceGroups[resource->GetResourceType()];
+		Entry& entry	= result.first->second;
+		entry.resource	= resource;
+		entry.type		= resource->GetResourceType();
+		entry.index		= (unsigned int)group.resources.size();
+		entry.name		= resource->GetResourceName();
+		entry.path		= FileSystem::NormalizePath(resource->GetResourceFilePath());
+		entry.memory	= 0;
+		group.resources.emplace_back(resource);
+		Index(entry);
+		SetMemory(entry, resource->GetMemoryUsage());
+
+		resource->m_resourceCache	= this;
+		resource->m_lastUsedFrame	= m_frame.load();
+	}
+
+	void ResourceCache::Remove(const shared_ptr<IResource>& resource)
+	{
+		if (!resource)
+			return;
+
+		lock_guard<mutex> guard(m_mutex);
+
+		auto it = m_entries.find(resource->Resource_GetID());
+		if (it == m_entries.end() || it->second.resource != resource)
+			return;
+
+		Erase(it->second);
+		m_entries.erase(it);
+	}
+
+	void ResourceCache::Reindex(IResource* resource)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		auto it = m_entries.find(resource->Resource_GetID());
+		if (it == m_entries.end())
+			return;
+
+		Entry& entry = it->second;
+		Unindex(entry);
+		entry.name = resource->GetResourceName();
+		entry.path = FileSystem::NormalizePath(resource->GetResourceFilePath());
+		Index(entry);
+	}
+
+	void ResourceCache::GetResourceFilePaths(vector<string>& filePaths)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		for (const auto& resourceGroup : m_resourceGroups)
+		{
+			for (const auto& resource : resourceGroup.second.resources)
+			{
+				filePaths.push_back(resource->GetResourceFilePath());
+			}
+		}
+	}
+
+	void ResourceCache::SaveResourcesToFiles()
+	{
+		// Saving can rename a resource (which re-indexes it), so don't hold the lock while doing so
+		for (const auto& resource : GetAll())
+		{
+			if (!resource->HasFilePath())
+				continue;
+
+			resource->SaveToFile(resource->GetResourceFilePath());
+		}
+	}
+
+	vector<shared_ptr<IResource>> ResourceCache::GetAll()
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		vector<shared_ptr<IResource>> resources;
+		resources.reserve(m_entries.size());
+		for (const auto& resourceGroup : m_resourceGroups)
+		{
+			resources.insert(resources.end(), resourceGroup.second.resources.begin(), resourceGroup.second.resources.end());
+		}
+
+		return resources;
+	}
+
+	vector<shared_ptr<IResource>> ResourceCache::GetByType(Resource_Type type)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		auto group = m_resourceGroups.find(type);
+		return group != m_resourceGroups.end() ? group->second.resources : vector<shared_ptr<IResource>>();
+	}
+
+	unsigned int ResourceCache::GetCountByType(Resource_Type type)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		auto group = m_resourceGroups.find(type);
+		return group != m_resourceGroups.end() ? (unsigned int)group->second.resources.size() : 0;
+	}
+
+	shared_ptr<IResource> ResourceCache::GetByName(const string& name, Resource_Type type)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		auto& index	= m_resourceGroups[type].byName;
+		auto it		= index.find(name);
+		if (it == index.end())
+			return nullptr;
+
+		it->second->resource->m_lastUsedFrame = m_frame.load();
+		return it->second->resource;
+	}
+
+	shared_ptr<IResource> ResourceCache::GetByPath(const string& path, Resource_Type type)
+	{
+		string pathNormalized = FileSystem::NormalizePath(path);
+
+		lock_guard<mutex> guard(m_mutex);
+
+		auto& index	= m_resourceGroups[type].byPath;
+		auto it		= index.find(pathNormalized);
+		if (it == index.end())
+			return nullptr;
+
+		it->second->resource->m_lastUsedFrame = m_frame.load();
+		return it->second->resource;
+	}
+
+	shared_ptr<IResource> ResourceCache::GetByID(unsigned int id)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		auto it = m_entries.find(id);
+		if (it == m_entries.end())
+			return nullptr;
+
+		it->second.resource->m_lastUsedFrame = m_frame.load();
+		return it->second.resource;
+	}
+
+	bool ResourceCache::IsCached(const string& resourceName, Resource_Type resourceType)
+	{
+		if (resourceName == NOT_ASSIGNED)
+		{
+			LOG_WARNING("ResourceCache:IsCached: Can't check if resource \"" + resourceName + "\" is cached as it has no name assigned to it.");
+			return false;
+		}
+
+		lock_guard<mutex> guard(m_mutex);
+		auto& index = m_resourceGroups[resourceType].byName;
+		return index.find(resourceName) != index.end();
+	}
+
+	uint64_t ResourceCache::GetMemoryUsage()
+	{
+		lock_guard<mutex> guard(m_mutex);
+		return m_memoryUsage;
+	}
+
+	uint64_t ResourceCache::GetMemoryUsage(Resource_Type type)
+	{
+		lock_guard<mutex> guard(m_mutex);
+		return m_resourceGroups[type].memoryUsage;
+	}
+
+	void ResourceCache::UpdateMemoryUsage(IResource* resource)
+	{
+		if (!resource)
+			return;
+
+		lock_guard<mutex> guard(m_mutex);
+
+		auto it = m_entries.find(resource->Resource_GetID());
+		if (it == m_entries.end())
+			return;
+
+		SetMemory(it->second, resource->GetMemoryUsage());
+	}
+
+	void ResourceCache::SetMemoryBudget(uint64_t budget)
+	{
+		lock_guard<mutex> guard(m_mutex);
+		m_memoryBudget = budget;
+	}
+
+	void ResourceCache::SetMemoryBudget(Resource_Type type, uint64_t budget)
+	{
+		lock_guard<mutex> guard(m_mutex);
+		m_resourceGroups[type].memoryBudget = budget;
+	}
+
+	ResourceCacheStats ResourceCache::GetStats()
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		ResourceCacheStats stats;
+		stats.memoryUsage	= m_memoryUsage;
+		stats.memoryBudget	= m_memoryBudget;
+		stats.resourceCount	= (unsigned int)m_entries.size();
+		for (const auto& group : m_resourceGroups)
+		{
+			stats.memoryEvicted	+= group.second.memoryEvicted;
+			stats.evictionCount	+= group.second.evictions;
+			stats.reloadCount	+= group.second.reloads;
+		}
+
+		return stats;
+	}
+
+	ResourceCacheStats ResourceCache::GetStats(Resource_Type type)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		const auto& group = m_resourceGroups[type];
+		ResourceCacheStats stats;
+		stats.memoryUsage	= group.memoryUsage;
+		stats.memoryBudget	= group.memoryBudget;
+		stats.memoryEvicted	= group.memoryEvicted;
+		stats.resourceCount	= (unsigned int)group.resources.size();
+		stats.evictionCount	= group.evictions;
+		stats.reloadCount	= group.reloads;
+
+		return stats;
+	}
+
+	void ResourceCache::Tick()
+	{
+		Evict();
+		m_frame++;
+	}
+
+	uint64_t ResourceCache::Evict()
+	{
+		// Released once unlocked, destroying a resource can release others (e.g. a material its textures)
+		vector<shared_ptr<IResource>> evicted;
+		uint64_t memoryFreed = 0;
+		{
+			lock_guard<mutex> guard(m_mutex);
+
+			bool overBudget = IsOverBudget();
+			vector<Entry*> candidates;
+			for (auto& group : m_resourceGroups)
+			{
+				if (!overBudget && !IsOverBudget(group.second))
+					continue;
+
+				for (const auto& resource : group.second.resources)
+				{
+					Entry& entry = m_entries[resource->Resource_GetID()];
+					if (IsEvictable(entry))
+					{
+						candidates.emplace_back(&entry);
+					}
+				}
+			}
+
+			if (candidates.empty())
+				return 0;
+
+			// Least recently used first, the largest first among equally old ones
+			sort(candidates.begin(), candidates.end(), [](const Entry* a, const Entry* b)
+			{
+				uint64_t frameA = a->resource->m_lastUsedFrame;
+				uint64_t frameB = b->resource->m_lastUsedFrame;
+				return frameA != frameB ? frameA < frameB : a->memory > b->memory;
+			});
+
+			for (Entry* entry : candidates)
+			{
+				auto& group = m_resourceGroups[entry->type];
+				if (!IsOverBudget() && !IsOverBudget(group))
+					continue;
+
+				// Remember where it came from, so it can be reloaded
+				group.evictedByName[entry->name] = entry->path;
+				group.evictedByPath[entry->path] = entry->name;
+				group.memoryEvicted += entry->memory;
+				group.evictions++;
+				memoryFreed += entry->memory;
+
+				unsigned int id = entry->resource->Resource_GetID();
+				evicted.emplace_back(entry->resource);
+				Erase(*entry);
+				m_entries.erase(id);
+			}
+		}
+
+		if (!evicted.empty())
+		{
+			LOGF_INFO("ResourceCache::Evict: Evicted %d resources, %.2f MB", (int)evicted.size(), memoryFreed / 1000.0f / 1000.0f);
+		}
+
+		return memoryFreed;
+	}
+
+	bool ResourceCache::GetEvictedPathByName(const string& name, Resource_Type type, string& filePath)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		auto& evicted	= m_resourceGroups[type].evictedByName;
+		auto it			= evicted.find(name);
+		if (it == evicted.end())
+			return false;
+
+		filePath = it->second;
+		return true;
+	}
+
+	bool ResourceCache::GetEvictedPathByPath(const string& path, Resource_Type type, string& filePath)
+	{
+		string pathNormalized = FileSystem::NormalizePath(path);
+
+		lock_guard<mutex> guard(m_mutex);
+
+		auto& evicted = m_resourceGroups[type].evictedByPath;
+		if (evicted.find(pathNormalized) == evicted.end())
+			return false;
+
+		filePath = pathNormalized;
+		return true;
+	}
+
+	void ResourceCache::Clear()
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		// Resources can outlive the cache, they must no longer report changes to it
+		for (auto& entry : m_entries)
+		{
+			entry.second.resource->m_resourceCache = nullptr;
+		}
+
+		m_resourceGroups.clear();
+		m_entries.clear();
+		m_memoryUsage = 0;
+	}
+
+	void ResourceCache::Index(Entry& entry)
+	{
+		auto& group = m_resourceGroups[entry.type];
+		group.byName.emplace(entry.name, &entry);
+		group.byPath.emplace(entry.path, &entry);
+
+		// A resource that was evicted is back
+		bool reloaded = false;
+		auto itName = group.evictedByName.find(entry.name);
+		if (itName != group.evictedByName.end())
+		{
+			group.evictedByPath.erase(itName->second);
+			group.evictedByName.erase(itName);
+			reloaded = true;
+		}
+		auto itPath = group.evictedByPath.find(entry.path);
+		if (itPath != group.evictedByPath.end())
+		{
+			group.evictedByName.erase(itPath->second);
+			group.evictedByPath.erase(itPath);
+			reloaded = true;
+		}
+		group.reloads += reloaded ? 1 : 0;
+	}
+
+	void ResourceCache::Unindex(Entry& entry)
+	{
+		auto& group = m_resourceGroups[entry.type];
+		_ResourceCache::Erase(group.byName, entry.name, &entry);
+		_ResourceCache::Erase(group.byPath, entry.path, &entry);
+	}
+
+	void ResourceCache::Erase(Entry& entry)
+	{
+		auto& resources = m_resourceGroups[entry.type].resources;
+		Unindex(entry);
+		SetMemory(entry, 0);
+
+		// Swap with the last resource of the group so the list stays contiguous
+		if (entry.index != resources.size() - 1)
+		{
+			resources[entry.index] = resources.back();
+			m_entries[resources[entry.index]->Resource_GetID()].index = entry.index;
+		}
+		resources.pop_back();
+
+		entry.resource->m_resourceCache = nullptr;
+	}
+
+	void ResourceCache::SetMemory(Entry& entry, uint64_t memory)
+	{
+		auto& group			= m_resourceGroups[entry.type];
+		group.memoryUsage	= group.memoryUsage - entry.memory + memory;
+		m_memoryUsage		= m_memoryUsage - entry.memory + memory;
+		entry.memory		= memory;
+	}
+
+	bool ResourceCache::IsEvictable(const Entry& entry)
+	{
+		const auto& resource = entry.resource;
+
+		// The entry and the group list are the cache's own references.
+		// Only resources that were loaded from a file can be reloaded.
+		return
+			resource.use_count() == 2							&&
+			resource->m_useCount == 0							&&
+			resource->m_lastUsedFrame < m_frame					&&
+			resource->GetLoadState() == LoadState_Completed		&&
+			resource->HasFilePath();
+	}
+}
@@ -19,18 +19,37 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+
 #pragma once
 
 //= INCLUDES ==============
 #include <vector>
 #include <memory>
+#include <map>
+#include <unordered_map>
+#include <string_view>
+#include <mutex>
+#include <atomic>
 #include "IResource.h"
 #include "../Logging/Log.h"
-#include <mutex>
 //========================
 
 namespace Directus
 {
+	struct ResourceCacheStats
+	{
+		uint64_t memoryUsage		= 0;
+		uint64_t memoryBudget		= 0; // 0 means unlimited
+		uint64_t memoryEvicted		= 0; // Total since the cache was created
+		unsigned int resourceCount	= 0;
+		unsigned int evictionCount	= 0; // Total since the cache was created
+		unsigned int reloadCount	= 0; // Evicted resources that were loaded again
+	};
+
+	// Resources grouped by type, with hash indices by ID, name and (normalized) path.
+	// Every lookup is O(1), the group lists are contiguous so enumeration by type is cheap.
+	// When a memory budget is exceeded, the least recently used resources that nothing else references
+	// are evicted. Their name and path are remembered so the ResourceManager can reload them on access.
 	class ENGINE_CLASS ResourceCache
 	{
 	public:
@@ -38,92 +57,52 @@ namespace Directus
 		~ResourceCache() { Clear(); }
 
 		// Adds a resource
-		void Add(const std::shared_ptr<IResource>& resource)
-		{
-			if (!resource)
-				return;
+		void Add(const std::shared_ptr<IResource>& resource);
 
-			std::lock_guard<std::mutex> guard(m_mutex);
-			m_resourceGroups[resource->GetResourceType()].push_back(resource);
-		}
+		// Removes a resource
+		void Remove(const std::shared_ptr<IResource>& resource);
+
+		// Called by a cached resource when its name or file path changes
+		void Reindex(IResource* resource);
 
 		// Returns the file paths of all the resources
-		void GetResourceFilePaths(std::vector<std::string>& filePaths)
-		{
-			for (const auto& resourceGroup : m_resourceGroups)
-			{
-				for (const auto& resource : resourceGroup.second)
-				{
-					filePaths.push_back(resource->GetResourceFilePath());
-				}
-			}
-		}
+		void GetResourceFilePaths(std::vector<std::string>& filePaths);
 
 		// Makes the resources save their metadata
-		void SaveResourcesToFiles()
-		{
-			for (const auto& resourceGroup : m_resourceGroups)
-			{
-				for (const auto& resource : resourceGroup.second)
-				{
-					if (!resource->HasFilePath())
-						continue;
-
-					resource->SaveToFile(resource->GetResourceFilePath());
-				}
-			}
-		}
+		void SaveResourcesToFiles();
 
 		// Returns all the resources
-		std::vector<std::shared_ptr<IResource>> GetAll()
-		{
-			std::vector<std::shared_ptr<IResource>> resources;
-			for (const auto& resourceGroup : m_resourceGroups)
-			{
-				resources.insert(resources.end(), resourceGroup.second.begin(), resourceGroup.second.end());
-			}
+		std::vector<std::shared_ptr<IResource>> GetAll();
 
-			return resources;
-		}
+		// Returns all resources of a given type, copied so that loads on other threads can't invalidate them
+		std::vector<std::shared_ptr<IResource>> GetByType(Resource_Type type);
+
+		// Returns the number of resources of a given type
+		unsigned int GetCountByType(Resource_Type type);
 
 		// Returns a resource by name
 		template <class T>
 		std::shared_ptr<IResource> GetByName(const std::string& name)
 		{
-			for (const auto& resource : m_resourceGroups[IResource::DeduceResourceType<T>()])
-			{
-				if (name == resource->GetResourceName())
-					return resource;
-			}
-
-			return std::shared_ptr<IResource>();
+			return GetByName(name, IResource::DeduceResourceType<T>());
 		}
 
 		// Returns a resource by name
-		std::shared_ptr<IResource> GetByName(const std::string& name, Resource_Type type)
-		{
-			for (const auto& resource : m_resourceGroups[type])
-			{
-				if (name == resource->GetResourceName())
-					return resource;
-			}
-
-			return std::shared_ptr<IResource>();
-		}
+		std::shared_ptr<IResource> GetByName(const std::string& name, Resource_Type type);
 
 		// Returns a resource by path
 		template <class T>
 		std::shared_ptr<IResource> GetByPath(const std::string& path)
 		{
-			for (const auto& resource : m_resourceGroups[IResource::DeduceResourceType<T>()])
-			{
-				if (path == resource->GetResourceFilePath())
-					return resource;
-			}
-
-			return std::shared_ptr<IResource>();
+			return GetByPath(path, IResource::DeduceResourceType<T>());
 		}
 
+		// Returns a resource by path
+		std::shared_ptr<IResource> GetByPath(const std::string& path, Resource_Type type);
+
+		// Returns a resource by ID
+		std::shared_ptr<IResource> GetByID(unsigned int id);
+
 		// Checks whether a resource is already cached
 		bool IsCached(const std::shared_ptr<IResource>& resourceIn)
 		{
@@ -131,59 +110,75 @@ namespace Directus
 		}
 
 		// Checks whether a resource is already cached
-		bool IsCached(const std::string& resourceName, Resource_Type resourceType)
-		{
-			if (resourceName == NOT_ASSIGNED)
-			{
-				LOG_WARNING("ResourceCache:IsCached: Can't check if resource \"" + resourceName + "\" is cached as it has no name assigned to it.");
-				return false;
-			}
-
-			for (const auto& resource : m_resourceGroups[resourceType])
-			{
-				if (resourceName == resource->GetResourceName())
-					return true;
-			}
-
-			return false;
-		}
-
-		unsigned int GetMemoryUsage()
-		{
-			unsigned int size = 0;
-			for (const auto& group : m_resourceGroups)
-			{
-				for (const auto& resource : group.second)
-				{
-					if (!resource)
-						continue;
-
-					size += resource->GetMemoryUsage();
-				}
-			}
-
-			return size;
-		}
-
-		unsigned int GetMemoryUsage(Resource_Type type)
-		{
-			unsigned int size = 0;
-			for (const auto& resource : m_resourceGroups[type])
-			{
-				size += resource->GetMemoryUsage();
-			}
-
-			return size;
-		}
-
-		// Returns all resources of a given type
-		const std::vector<std::shared_ptr<IResource>>& GetByType(Resource_Type type) { return m_resourceGroups[type]; }
+		bool IsCached(const std::string& resourceName, Resource_Type resourceType);
+
+		//= MEMORY ==============================================================================
+		uint64_t GetMemoryUsage();
+		uint64_t GetMemoryUsage(Resource_Type type);
+		// Re-queries the memory usage of a resource, needed when it changes after being cached
+		void UpdateMemoryUsage(IResource* resource);
+		// A budget of 0 means unlimited
+		void SetMemoryBudget(uint64_t budget);
+		void SetMemoryBudget(Resource_Type type, uint64_t budget);
+		ResourceCacheStats GetStats();
+		ResourceCacheStats GetStats(Resource_Type type);
+		//=======================================================================================
+
+		//= EVICTION ============================================================================
+		// Evicts until all budgets are met, then advances the frame resources are aged by
+		void Tick();
+		uint64_t GetFrame() { return m_frame; }
+		// Evicts the least recently used resources (that weren't used this frame) until all budgets are met, returns the bytes freed
+		uint64_t Evict();
+		// Returns the file path an evicted resource can be reloaded from
+		bool GetEvictedPathByName(const std::string& name, Resource_Type type, std::string& filePath);
+		bool GetEvictedPathByPath(const std::string& path, Resource_Type type, std::string& filePath);
+		//=======================================================================================
 
 		// Unloads all resources
-		void Clear() { m_resourceGroups.clear(); }
+		void Clear();
 
 	private:
-		std::map<Resource_Type, std::vector<std::shared_ptr<IResource>>> m_resourceGroups;
+		struct Entry
+		{
+			std::shared_ptr<IResource> resource;
+			Resource_Type type;
+			unsigned int index; // Into the group's resource list
+			// The keys this entry is indexed under, the group indices view these strings instead of copying them
+			std::string name;
+			std::string path;
+			uint64_t memory;
+		};
+
+		struct ResourceGroup
+		{
+			std::vector<std::shared_ptr<IResource>> resources;
+			// Several resources can share a name (or path), lookups return any of them
+			std::unordered_multimap<std::string_view, Entry*> byName;
+			std::unordered_multimap<std::string_view, Entry*> byPath;
+			// Evicted resources that can be reloaded, name -> path and path -> name
+			std::unordered_map<std::string, std::string> evictedByName;
+			std::unordered_map<std::string, std::string> evictedByPath;
+			uint64_t memoryUsage	= 0;
+			uint64_t memoryBudget	= 0;
+			uint64_t memoryEvicted	= 0;
+			unsigned int evictions	= 0;
+			unsigned int reloads	= 0;
+		};
+
+		void Index(Entry& entry);
+		void Unindex(Entry& entry);
+		void Erase(Entry& entry);
+		void SetMemory(Entry& entry, uint64_t memory);
+		bool IsOverBudget(const ResourceGroup& group) { return group.memoryBudget != 0 && group.memoryUsage > group.memoryBudget; }
+		bool IsOverBudget()	{ return m_memoryBudget != 0 && m_memoryUsage > m_memoryBudget; }
+		bool IsEvictable(const Entry& entry);
+
+		std::map<Resource_Type, ResourceGroup> m_resourceGroups;
+		std::unordered_map<unsigned int, Entry> m_entries; // By resource ID, nodes are stable so views into them stay valid
+		uint64_t m_memoryUsage	= 0;
+		uint64_t m_memoryBudget	= 0;
+		std::atomic<uint64_t> m_frame	= 0;
 		std::mutex m_mutex;
 	};
-}
\ No newline at end of file
+}
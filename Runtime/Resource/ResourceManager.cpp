@@ -19,11 +19,13 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ===================
+//= INCLUDES ===============================
 #include "ResourceManager.h"
 #include "../World/Actor.h"
 #include "../Core/EventSystem.h"
-//==============================
+#include "../Threading/Threading.h"
+#include "../FileSystem/VirtualFileSystem.h"
+//==========================================
 
 //= NAMESPACES ================
 using namespace std;
@@ -32,10 +34,46 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	// Default size of the import cache on disk
+	static const uint64_t g_importCacheBudget = 4ull * 1024 * 1024 * 1024;
+
+	// Heap order, higher priority first and FIFO within the same priority
+	static bool LoadRequest_Compare(const shared_ptr<LoadRequest>& a, const shared_ptr<LoadRequest>& b)
+	{
+		return a->priority != b->priority ? a->priority < b->priority : a->sequence > b->sequence;
+	}
+
 	ResourceManager::ResourceManager(Context* context) : Subsystem(context)
 	{
 		m_resourceCache = nullptr;
 		SUBSCRIBE_TO_EVENT(EVENT_SCENE_UNLOAD, EVENT_HANDLER(Clear));
+		SUBSCRIBE_TO_EVENT(EVENT_FRAME_START, EVENT_HANDLER(LoadAsync_Dispatch));
+		SUBSCRIBE_TO_EVENT(EVENT_FRAME_END, EVENT_HANDLER(Evict));
+	}
+
+	ResourceManager::~ResourceManager()
+	{
+		Clear();
+
+		// The workers reference the manager, so they have to be done before it goes away
+		{
+			unique_lock<mutex> lock(m_loadMutex);
+			m_loadWorkersDone.wait(lock, [this] { return m_loadWorkers == 0; });
+		}
+
+		VirtualFileSystem::UnmountAll();
+	}
+
+	void ResourceManager::Clear()
+	{
+		// Doesn't wait for the loads in progress, they can depend on the main thread (e.g. a model committing
+		// its actors through World::MainThread_Run) which is the one clearing. Their results are discarded instead.
+		LoadAsync_CancelAll();
+
+		if (m_resourceCache)
+		{
+			m_resourceCache->Clear();
+		}
 	}
 
 	bool ResourceManager::Initialize()
@@ -43,6 +81,9 @@ namespace Directus
 		// Cache
 		m_resourceCache = make_unique<ResourceCache>();
 
+		// Packed assets, anything that ships in a pack next to the executable resolves through them
+		VirtualFileSystem::MountDirectory(FileSystem::GetWorkingDirectory());
+
 		// Importers
 		m_imageImporter = make_shared<ImageImporter>(m_context);
 		m_modelImporter = make_shared<ModelImporter>(m_context);
@@ -61,6 +102,9 @@ namespace Directus
 		// Add project directory
 		SetProjectDirectory("Project//");
 
+		// Leave some threads free for everything else that runs on the workers
+		LoadAsync_SetMaxConcurrency(Math::Helper::Max(m_context->GetSubsystem<Threading>()->GetThreadCount() / 2, (unsigned int)1));
+
 		return true;
 	}
 
@@ -88,10 +132,205 @@ namespace Directus
 		}
 
 		m_projectDirectory = directory;
+
+		// Every project keeps its own imports
+		uint64_t budget	= m_importCache ? m_importCache->GetStats().budget : g_importCacheBudget;
+		m_importCache	= make_unique<ImportCache>(m_projectDirectory + "Import_Cache//", budget);
 	}
 
 	string ResourceManager::GetProjectDirectoryAbsolute()
 	{
 		return FileSystem::GetWorkingDirectory() + m_projectDirectory;
 	}
+
+	unsigned int ResourceManager::LoadAsync_GetPendingCount()
+	{
+		lock_guard<mutex> lock(m_loadMutex);
+		return (unsigned int)m_loadRequests.size();
+	}
+
+	void ResourceManager::LoadAsync_SortQueue()
+	{
+		make_heap(m_loadQueue.begin(), m_loadQueue.end(), LoadRequest_Compare);
+	}
+
+	void ResourceManager::LoadAsync_StartWorker()
+	{
+		// Expects m_loadMutex to be locked
+		if (m_loadWorkers >= m_loadWorkersMax || m_loadWorkers >= m_loadQueue.size())
+			return;
+
+		m_loadWorkers++;
+		m_context->GetSubsystem<Threading>()->AddTask([this]() { LoadAsync_Work(); });
+	}
+
+	shared_ptr<LoadRequest> ResourceManager::LoadAsync_Find(const string& filePath)
+	{
+		auto it = m_loadRequests.find(filePath);
+		if (it == m_loadRequests.end())
+			return nullptr;
+
+		// A cancelled request that hasn't started yet is dead, nothing may merge into it
+		auto request = it->second;
+		if (request->cancelled && !request->started)
+		{
+			LoadAsync_Drop(request);
+			return nullptr;
+		}
+
+		return request;
+	}
+
+	void ResourceManager::LoadAsync_Claim(const shared_ptr<LoadRequest>& request)
+	{
+		auto it = find(m_loadQueue.begin(), m_loadQueue.end(), request);
+		if (it != m_loadQueue.end())
+		{
+			m_loadQueue.erase(it);
+			LoadAsync_SortQueue();
+		}
+		request->started = true;
+	}
+
+	void ResourceManager::LoadAsync_Drop(const shared_ptr<LoadRequest>& request)
+	{
+		LoadAsync_Claim(request);
+
+		auto it = m_loadRequests.find(request->filePath);
+		if (it != m_loadRequests.end() && it->second == request)
+		{
+			m_loadRequests.erase(it);
+		}
+		m_resourceCache->Remove(request->resource);
+		request->resource->SetLoadState(LoadState_Cancelled);
+		m_loadCompleted.emplace_back(request);
+	}
+
+	void ResourceManager::LoadAsync_Run(const shared_ptr<LoadRequest>& request)
+	{
+		auto& resource = request->resource;
+		resource->SetLoadState(LoadState_Started);
+		bool loaded = resource->LoadFromFile(request->filePath);
+		resource->SetLoadState(loaded ? LoadState_Completed : LoadState_Failed);
+		m_resourceCache->UpdateMemoryUsage(resource.get());
+		if (!loaded)
+		{
+			LOGF_WARNING("ResourceManager::LoadAsync_Run: Resource \"%s\" failed to load", request->filePath.c_str());
+		}
+
+		lock_guard<mutex> lock(m_loadMutex);
+		// Cancelled by LoadAsync_CancelAll() while loading, nobody is waiting for it anymore
+		if (request->generation != m_loadGeneration)
+		{
+			resource->SetLoadState(LoadState_Cancelled);
+			return;
+		}
+
+		// A request for the same file can only have replaced this one if it was cancelled
+		auto it = m_loadRequests.find(request->filePath);
+		if (it != m_loadRequests.end() && it->second == request)
+		{
+			m_loadRequests.erase(it);
+		}
+		m_loadCompleted.emplace_back(request);
+	}
+
+	void ResourceManager::LoadAsync_Work()
+	{
+		// Keep pulling the most important request until the queue is empty
+		while (true)
+		{
+			shared_ptr<LoadRequest> request;
+			{
+				lock_guard<mutex> lock(m_loadMutex);
+				if (m_loadQueue.empty())
+				{
+					m_loadWorkers--;
+					m_loadWorkersDone.notify_all();
+					return;
+				}
+
+				pop_heap(m_loadQueue.begin(), m_loadQueue.end(), LoadRequest_Compare);
+				request = m_loadQueue.back();
+				m_loadQueue.pop_back();
+
+				// Cancellation is only looked at here, once started a request runs to completion
+				if (request->cancelled)
+				{
+					LoadAsync_Drop(request);
+					continue;
+				}
+				request->started = true;
+			}
+
+			LoadAsync_Run(request);
+		}
+	}
+
+	void ResourceManager::LoadAsync_Dispatch()
+	{
+		vector<shared_ptr<LoadRequest>> completed;
+		{
+			lock_guard<mutex> lock(m_loadMutex);
+			if (m_loadCompleted.empty())
+				return;
+
+			completed.swap(m_loadCompleted);
+		}
+
+		// Callbacks run without the lock, so they are free to issue new loads
+		for (const auto& request : completed)
+		{
+			for (const auto& callback : request->callbacks)
+			{
+				callback(request->resource->GetLoadState());
+			}
+		}
+	}
+
+	void ResourceManager::LoadAsync_CancelAll()
+	{
+		lock_guard<mutex> lock(m_loadMutex);
+
+		for (const auto& request : m_loadQueue)
+		{
+			request->resource->SetLoadState(LoadState_Cancelled);
+		}
+		m_loadQueue.clear();
+		m_loadRequests.clear();
+		m_loadCompleted.clear();
+
+		// Loads in progress run to completion, the workers drop them once they see the generation has moved on
+		m_loadGeneration++;
+	}
+
+	void ResourceManager::Evict()
+	{
+		// Runs at the end of the frame, so whatever this frame used is spared
+		if (m_resourceCache)
+		{
+			m_resourceCache->Tick();
+		}
+	}
+
+	//= IRESOURCE ================================================================================
+	// Defined with the manager, a resource only depends on it once it gets cached (or asked whether it is)
+	weak_ptr<IResource> IResource::_Cache()
+	{
+		auto resourceManager	= m_context->GetSubsystem<ResourceManager>();
+		auto resource			= resourceManager->GetResourceByName(GetResourceName(), m_resourceType);
+		if (resource.expired())
+		{
+			resourceManager->Add(GetSharedPtr());
+			resource = resourceManager->GetResourceByName(GetResourceName(), m_resourceType);
+		}
+
+		return resource;
+	}
+
+	bool IResource::_IsCached()
+	{
+		return m_context->GetSubsystem<ResourceManager>()->ExistsByName(GetResourceName(), m_resourceType);
+	}
+	//============================================================================================
 }
@@ -24,10 +24,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <memory>
 #include <map>
+#include <unordered_map>
+#include <functional>
+#include <condition_variable>
 #include "ResourceCache.h"
 #include "Import/ModelImporter.h"
 #include "Import/ImageImporter.h"
 #include "Import/FontImporter.h"
+#include "Import/ImportCache.h"
 #include "../Core/SubSystem.h"
 #include "../Audio/AudioClip.h"
 #include "../RHI/RHI_Texture.h"
@@ -37,20 +41,61 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace Directus
 {
+	// A pending or in-flight LoadAsync() request, shared by every handle to the same file
+	struct LoadRequest
+	{
+		std::shared_ptr<IResource> resource;
+		std::string filePath;
+		int priority		= 0;
+		uint64_t sequence	= 0;
+		// The ResourceManager's load generation at the time of the request, LoadAsync_CancelAll() moves on to the next one
+		uint64_t generation	= 0;
+		std::atomic<bool> cancelled = false;
+		// Taken off the queue by a worker or by Load(), from then on the request runs to completion
+		bool started		= false;
+		// Invoked on the main thread once the request is done, guarded by ResourceManager's load mutex
+		std::vector<std::function<void(LoadState)>> callbacks;
+	};
+
+	// Returned by LoadAsync(), the resource can be referenced right away and gets filled in once its load completes
+	template <class T>
+	class ResourceHandle
+	{
+	public:
+		ResourceHandle() = default;
+		ResourceHandle(const std::shared_ptr<T>& resource, const std::shared_ptr<LoadRequest>& request)
+		{
+			m_resource	= resource;
+			m_request	= request;
+		}
+
+		std::weak_ptr<T> Get() const	{ return m_resource; }
+		LoadState GetLoadState() const	{ auto resource = m_resource.lock(); return resource ? resource->GetLoadState() : LoadState_Failed; }
+		bool IsReady() const			{ return GetLoadState() == LoadState_Completed; }
+		// Drops the request if it hasn't started yet (for all handles to it), a load in progress always runs to completion
+		void Cancel()					{ if (m_request) m_request->cancelled = true; }
+
+	private:
+		std::weak_ptr<T> m_resource;
+		std::shared_ptr<LoadRequest> m_request;
+	};
+
 	class ENGINE_CLASS ResourceManager : public Subsystem
 	{
 	public:
 		ResourceManager(Context* context);
-		~ResourceManager() { Clear(); }
+		~ResourceManager();
 
 		//= Subsystem =============
 		bool Initialize() override;
 		//=========================
 
 		// Unloads all resources
-		void Clear() { m_resourceCache->Clear(); }
+		void Clear();
 
-		// Loads a resource and adds it to the resource cache
+		// Loads a resource and adds it to the resource cache. A file that LoadAsync() queued is loaded right away on the
+		// calling thread instead. One that a worker is already loading isn't waited for (the worker can be waiting on
+		// the main thread, see World::MainThread_Run), the returned resource may not be ready until its state says so.
 		template <class T>
 		std::weak_ptr<T> Load(const std::string& filePath)
 		{
@@ -64,32 +109,135 @@ namespace Directus
 			std::string filePathRelative	= FileSystem::GetRelativeFilePath(filePath);
 			std::string name				= FileSystem::GetFileNameNoExtensionFromFilePath(filePathRelative);
 
-			// Check if the resource is already loaded
-			if (m_resourceCache->IsCached(name, IResource::DeduceResourceType<T>()))
+			std::shared_ptr<T> typed;
+			std::shared_ptr<LoadRequest> request;
 			{
-				return GetResourceByName<T>(name);
-			}
+				// Threads loading the same file at the same time would all miss the cache, so checking and adding is one step
+				std::lock_guard<std::mutex> lock(m_loadMutex);
+				request = LoadAsync_Find(filePathRelative);
+				if (request && !request->started)
+				{
+					LoadAsync_Claim(request);
+				}
+				else
+				{
+					request = nullptr;
+				}
 
-			// Create new resource
-			auto typed = std::make_shared<T>(m_context);
-			// Set a default name and a default filepath in case it's not overridden by LoadFromFile()
-			typed->SetResourceName(name);
-			typed->SetResourceFilePath(filePathRelative);
+				if (!m_resourceCache->IsCached(name, IResource::DeduceResourceType<T>()))
+				{
+					// Create new resource
+					typed = std::make_shared<T>(m_context);
+					// Set a default name and a default filepath in case it's not overridden by LoadFromFile()
+					typed->SetResourceName(name);
+					typed->SetResourceFilePath(filePathRelative);
+
+					// Cache it now so LoadFromFile() can safely pass around a reference to the resource from the ResourceManager
+					Add(typed);
+				}
+			}
 
-			// Cache it now so LoadFromFile() can safely pass around a reference to the resource from the ResourceManager
-			Add<T>(typed);
+			// Already loaded (or being loaded by another thread)
+			if (!typed)
+			{
+				if (request)
+				{
+					LoadAsync_Run(request);
+				}
+				return GetResourceByName<T>(name);
+			}
 
 			// Load
+			typed->SetLoadState(LoadState_Started);
 			if (!typed->LoadFromFile(filePathRelative))
 			{
 				LOGF_WARNING("ResourceManager::Load: Resource \"%s\" failed to load", filePathRelative.c_str());
+				typed->SetLoadState(LoadState_Failed);
 				return std::weak_ptr<T>();
 			}
+			typed->SetLoadState(LoadState_Completed);
+			m_resourceCache->UpdateMemoryUsage(typed.get());
 
 			// Cache it and cast it
 			return typed;
 		}
 
+		// Queues a resource to be loaded by the worker threads and returns immediately.
+		// Higher priorities are loaded first, requests for a file that is already queued or loading are merged.
+		// onComplete is invoked on the main thread (at the start of a frame) with the final load state.
+		template <class T>
+		ResourceHandle<T> LoadAsync(const std::string& filePath, int priority = 0, std::function<void(std::weak_ptr<T>, LoadState)> onComplete = nullptr)
+		{
+			if (filePath == NOT_ASSIGNED)
+			{
+				LOGF_WARNING("ResourceManager::LoadAsync: Can't load resource of type \"%s\", filepath \"%s\" is unassigned.", typeid(T).name(), filePath.c_str());
+				return ResourceHandle<T>();
+			}
+
+			std::string filePathRelative	= FileSystem::GetRelativeFilePath(filePath);
+			std::string name				= FileSystem::GetFileNameNoExtensionFromFilePath(filePathRelative);
+
+			std::lock_guard<std::mutex> lock(m_loadMutex);
+
+			// Merge with a request that is already queued or loading (cancelled ones are dropped, this is a new request)
+			if (auto request = LoadAsync_Find(filePathRelative))
+			{
+				auto typed = std::dynamic_pointer_cast<T>(request->resource);
+				if (typed)
+				{
+					LoadAsync_AddCallback<T>(request, typed, onComplete);
+					if (priority > request->priority)
+					{
+						request->priority = priority;
+						LoadAsync_SortQueue();
+					}
+					return ResourceHandle<T>(typed, request);
+				}
+			}
+
+			// Already loaded (or loaded synchronously), complete on the next frame
+			if (m_resourceCache->IsCached(name, IResource::DeduceResourceType<T>()))
+			{
+				auto typed		= std::dynamic_pointer_cast<T>(m_resourceCache->GetByName<T>(name));
+				auto request	= std::make_shared<LoadRequest>();
+				// Resources that were created in code were never "loaded", but they are ready
+				if (typed->GetLoadState() == LoadState_Idle)
+				{
+					typed->SetLoadState(LoadState_Completed);
+				}
+				request->resource = typed;
+				LoadAsync_AddCallback<T>(request, typed, onComplete);
+				m_loadCompleted.emplace_back(request);
+				return ResourceHandle<T>(typed, request);
+			}
+
+			// Create the resource now, so it can be referenced (and found in the cache) while it loads
+			auto typed = std::make_shared<T>(m_context);
+			typed->SetResourceName(name);
+			typed->SetResourceFilePath(filePathRelative);
+			typed->SetLoadState(LoadState_Idle);
+			m_resourceCache->Add(typed);
+
+			auto request		= std::make_shared<LoadRequest>();
+			request->resource	= typed;
+			request->filePath	= filePathRelative;
+			request->priority	= priority;
+			request->sequence	= m_loadSequence++;
+			request->generation	= m_loadGeneration;
+			LoadAsync_AddCallback<T>(request, typed, onComplete);
+			m_loadRequests[filePathRelative] = request;
+			m_loadQueue.emplace_back(request);
+			LoadAsync_SortQueue();
+			LoadAsync_StartWorker();
+
+			return ResourceHandle<T>(typed, request);
+		}
+
+		// Sets how many requests can load at the same time
+		void LoadAsync_SetMaxConcurrency(unsigned int count) { m_loadWorkersMax = count == 0 ? 1 : count; }
+		// Number of requests that are queued or loading
+		unsigned int LoadAsync_GetPendingCount();
+
 		// Adds a resource into the cache and returns the derived resource as a weak reference
 		template <class T>
 		std::weak_ptr<T> Add(std::shared_ptr<IResource> resource)
@@ -117,11 +265,18 @@ namespace Directus
 			m_resourceCache->Add(resource);
 		}
 
-		// Returns cached resource by name
+		// Returns cached resource by name, an evicted resource is reloaded
 		template <class T>
 		std::weak_ptr<T> GetResourceByName(const std::string& name)
 		{
-			return ToDerivedWeak<T>(m_resourceCache->GetByName<T>(name));
+			if (auto resource = m_resourceCache->GetByName<T>(name))
+				return ToDerivedWeak<T>(resource);
+
+			std::string filePath;
+			if (m_resourceCache->GetEvictedPathByName(name, IResource::DeduceResourceType<T>(), filePath))
+				return Load<T>(filePath);
+
+			return std::weak_ptr<T>();
 		}
 
 		// Returns cached resource by name
@@ -136,11 +291,24 @@ namespace Directus
 			return m_resourceCache->GetByName(name, type) != nullptr;
 		}
 
-		// Returns cached resource by path
+		// Returns cached resource by path, an evicted resource is reloaded
 		template <class T>
 		std::weak_ptr<T> GetResourceByPath(const std::string& path)
 		{
-			return ToDerivedWeak<T>(m_resourceCache->GetByPath<T>(path));
+			if (auto resource = m_resourceCache->GetByPath<T>(path))
+				return ToDerivedWeak<T>(resource);
+
+			std::string filePath;
+			if (m_resourceCache->GetEvictedPathByPath(path, IResource::DeduceResourceType<T>(), filePath))
+				return Load<T>(filePath);
+
+			return std::weak_ptr<T>();
+		}
+
+		// Returns cached resource by ID
+		std::weak_ptr<IResource> GetResourceByID(unsigned int id)
+		{
+			return m_resourceCache->GetByID(id);
 		}
 
 		// Returns cached resource by Type
@@ -148,6 +316,20 @@ namespace Directus
 		std::vector<std::weak_ptr<T>> GetResourcesByType()
 		{
 			std::vector<std::weak_ptr<T>> typedVec;
+
+			// Each resource type maps to a single class, so its group can be cast without RTTI
+			Resource_Type type = IResource::DeduceResourceType<T>();
+			if (type != Resource_Unknown)
+			{
+				auto resources = m_resourceCache->GetByType(type);
+				typedVec.reserve(resources.size());
+				for (const auto& resource : resources)
+				{
+					typedVec.emplace_back(std::static_pointer_cast<T>(resource));
+				}
+				return typedVec;
+			}
+
 			for (const auto& resource : m_resourceCache->GetAll())
 			{
 				std::weak_ptr<T> typed = ToDerivedWeak<T>(resource);
@@ -174,7 +356,7 @@ namespace Directus
 		// Returns all resources of a given type
 		unsigned int GetResourceCountByType(Resource_Type type)
 		{
-			return (unsigned int)m_resourceCache->GetByType(type).size();
+			return m_resourceCache->GetCountByType(type);
 		}
 
 		auto GetResourceAll() 
@@ -193,8 +375,13 @@ namespace Directus
 		}
 
 		// Memory
-		unsigned int GetMemoryUsage(Resource_Type type)	{ return m_resourceCache->GetMemoryUsage(type); }
-		unsigned int GetMemoryUsage()					{ return m_resourceCache->GetMemoryUsage(); }
+		uint64_t GetMemoryUsage(Resource_Type type)					{ return m_resourceCache->GetMemoryUsage(type); }
+		uint64_t GetMemoryUsage()									{ return m_resourceCache->GetMemoryUsage(); }
+		// Unreferenced resources are evicted (least recently used first) once a budget is exceeded, 0 means unlimited
+		void SetMemoryBudget(uint64_t budget)						{ m_resourceCache->SetMemoryBudget(budget); }
+		void SetMemoryBudget(Resource_Type type, uint64_t budget)	{ m_resourceCache->SetMemoryBudget(type, budget); }
+		ResourceCacheStats GetStats()								{ return m_resourceCache->GetStats(); }
+		ResourceCacheStats GetStats(Resource_Type type)				{ return m_resourceCache->GetStats(type); }
 
 		// Directories
 		void AddStandardResourceDirectory(Resource_Type type, const std::string& directory);
@@ -208,8 +395,32 @@ namespace Directus
 		std::weak_ptr<ModelImporter> GetModelImporter() { return m_modelImporter; }
 		std::weak_ptr<ImageImporter> GetImageImporter() { return m_imageImporter; }
 		std::weak_ptr<FontImporter> GetFontImporter() { return m_fontImporter; }
+		// Imported images and models, in the project directory. Null until a project directory is set.
+		ImportCache* GetImportCache() { return m_importCache.get(); }
 
 	private:
+		template <class T>
+		void LoadAsync_AddCallback(const std::shared_ptr<LoadRequest>& request, const std::shared_ptr<T>& typed, std::function<void(std::weak_ptr<T>, LoadState)>& onComplete)
+		{
+			if (!onComplete)
+				return;
+
+			std::weak_ptr<T> typedWeak = typed;
+			request->callbacks.emplace_back([typedWeak, onComplete](LoadState state) { onComplete(typedWeak, state); });
+		}
+		void LoadAsync_SortQueue();
+		void LoadAsync_StartWorker();
+		// Expect m_loadMutex to be locked
+		std::shared_ptr<LoadRequest> LoadAsync_Find(const std::string& filePath);
+		void LoadAsync_Claim(const std::shared_ptr<LoadRequest>& request);
+		void LoadAsync_Drop(const std::shared_ptr<LoadRequest>& request);
+		// Loads a claimed request and completes it
+		void LoadAsync_Run(const std::shared_ptr<LoadRequest>& request);
+		void LoadAsync_Work();
+		void LoadAsync_Dispatch();
+		void LoadAsync_CancelAll();
+		void Evict();
+
 		std::unique_ptr<ResourceCache> m_resourceCache;
 		std::map<Resource_Type, std::string> m_standardResourceDirectories;
 		std::string m_projectDirectory;
@@ -218,12 +429,24 @@ namespace Directus
 		std::shared_ptr<ModelImporter> m_modelImporter;
 		std::shared_ptr<ImageImporter> m_imageImporter;
 		std::shared_ptr<FontImporter> m_fontImporter;
+		std::unique_ptr<ImportCache> m_importCache;
+
+		// Async loading, everything below is guarded by m_loadMutex
+		std::mutex m_loadMutex;
+		std::condition_variable m_loadWorkersDone;
+		std::vector<std::shared_ptr<LoadRequest>> m_loadQueue; // Heap, highest priority (then oldest) on top
+		std::unordered_map<std::string, std::shared_ptr<LoadRequest>> m_loadRequests; // Queued or loading, by file path
+		std::vector<std::shared_ptr<LoadRequest>> m_loadCompleted; // Waiting for their callbacks
+		unsigned int m_loadWorkers		= 0;
+		unsigned int m_loadWorkersMax	= 1;
+		uint64_t m_loadSequence			= 0;
+		uint64_t m_loadGeneration		= 0;
 
 		// Derived -> Base (as a shared pointer)
 		template <class Type>
 		static std::shared_ptr<IResource> ToBaseShared(std::shared_ptr<Type> derived)
 		{
-			std::shared_ptr<IResource> base = dynamic_pointer_cast<IResource>(derived);
+			std::shared_ptr<IResource> base = std::dynamic_pointer_cast<IResource>(derived);
 
 			return base;
 		}
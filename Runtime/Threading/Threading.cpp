@@ -30,6 +30,10 @@ using namespace std;
 
 namespace Directus
 {
+	// Index of the queue owned by the calling thread, non-worker threads use the shared queue
+	static thread_local unsigned int g_queueIndex		= 0;
+	static thread_local Threading* g_queueOwner		= nullptr;
+
 	Threading::Threading(Context* context) : Subsystem(context)
 	{
 		m_stopping		= false;
@@ -38,14 +42,11 @@ namespace Directus
 
 	Threading::~Threading()
 	{
-		// Put unique lock on task mutex.
-		unique_lock<mutex> lock(m_tasksMutex);
-
 		// Set termination flag to true.
-		m_stopping = true;
-
-		// Unlock the mutex
-		lock.unlock();
+		{
+			lock_guard<mutex> lock(m_sleepMutex);
+			m_stopping = true;
+		}
 
 		// Wake up all threads.
 		m_conditionVar.notify_all();
@@ -58,45 +59,220 @@ namespace Directus
 
 		// Empty worker threads.
 		m_threads.clear();
+		m_queues.clear();
 	}
 
 	bool Threading::Initialize()
 	{
+		// Create the queues before any thread can touch them
+		for (unsigned int i = 0; i < m_threadCount + 1; i++)
+		{
+			m_queues.emplace_back(make_unique<WorkerQueue>());
+		}
+
 		for (unsigned int i = 0; i < m_threadCount; i++)
 		{
-			m_threads.emplace_back(thread(&Threading::Invoke, this));
+			m_threads.emplace_back(thread(&Threading::Invoke, this, i));
 		}
 		LOGF_INFO("Threading::Initialize: %d threads have been created", m_threadCount);
 
 		return true;
 	}
 
-	void Threading::Invoke()
+	void Threading::Invoke(unsigned int workerIndex)
 	{
-		shared_ptr<Task> task;
+		g_queueIndex = workerIndex;
+		g_queueOwner = this;
+
 		while (true)
 		{
-			// Lock tasks mutex
-			unique_lock<mutex> lock(m_tasksMutex);
+			if (ExecuteNext())
+				continue;
 
-			// Check condition on notification
-			m_conditionVar.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+			// Nothing to do, sleep until a job gets scheduled
+			unique_lock<mutex> lock(m_sleepMutex);
+			m_sleepingThreads.fetch_add(1);
+			m_conditionVar.wait(lock, [this] { return m_pendingJobs.load() != 0 || m_stopping; });
+			m_sleepingThreads.fetch_sub(1);
 
 			// If m_stopping is true, it's time to shut everything down
-			if (m_stopping && m_tasks.empty())
+			if (m_stopping && m_pendingJobs.load() == 0)
 				return;
+		}
+	}
+
+	void Threading::Wait(const JobHandle& job)
+	{
+		if (!job)
+			return;
+
+		// Workers help out instead of blocking, this prevents deadlocks when a job waits on other jobs from within a worker thread
+		if (g_queueOwner == this)
+		{
+			while (!job->IsComplete())
+			{
+				if (!ExecuteNext())
+				{
+					this_thread::yield();
+				}
+			}
+			return;
+		}
+
+		// Any other thread runs the job if it can, or sleeps until whoever runs it is done
+		if (job->IsReady() && Execute(job))
+			return;
+
+		unique_lock<mutex> lock(job->m_continuationsMutex);
+		job->m_completeCondition.wait(lock, [&job] { return job->IsComplete(); });
+	}
+
+	void Threading::Wait(const vector<JobHandle>& jobs)
+	{
+		// Run the part of the batch that is ready right away, instead of waiting on one job while the rest sits in the queues
+		if (g_queueOwner != this)
+		{
+			for (const auto& job : jobs)
+			{
+				if (job && job->IsReady())
+				{
+					Execute(job);
+				}
+			}
+		}
+
+		for (const auto& job : jobs)
+		{
+			Wait(job);
+		}
+	}
 
-			// Get next task in the queue.
-			task = m_tasks.front();
+	void Threading::Submit(const JobHandle& job, const vector<JobHandle>& dependencies)
+	{
+		// Register the job as a continuation of every dependency that is still running
+		for (const auto& dependency : dependencies)
+		{
+			if (!dependency)
+				continue;
 
-			// Remove it from the queue.
-			m_tasks.pop();
+			lock_guard<mutex> lock(dependency->m_continuationsMutex);
+			if (!dependency->IsComplete())
+			{
+				job->m_pendingDependencies.fetch_add(1, memory_order_relaxed);
+				dependency->m_continuations.emplace_back(job);
+			}
+		}
 
-			// Unlock the mutex
-			lock.unlock();
+		// Release the submission reference, if nothing else is pending the job is ready
+		if (job->m_pendingDependencies.fetch_sub(1, memory_order_acq_rel) == 1)
+		{
+			Schedule(job);
+		}
+	}
 
-			// Execute the task.
-			task->Execute();
+	void Threading::Schedule(const JobHandle& job)
+	{
+		if (m_threadCount == 0 || m_queues.empty())
+		{
+			Execute(job);
+			return;
 		}
+
+		// Counted before it's pushed, so that a thread that pops it right away can't take the count below zero
+		m_pendingJobs.fetch_add(1);
+
+		// Workers push to their own queue, everybody else to the shared one
+		unsigned int index	= (g_queueOwner == this) ? g_queueIndex : m_threadCount;
+		auto& queue			= m_queues[index];
+		{
+			lock_guard<mutex> lock(queue->mutex);
+			queue->jobs.emplace_back(job);
+		}
+
+		// Only pay for the wake up when somebody is actually sleeping. A worker registers as sleeping before
+		// it checks m_pendingJobs under the sleep mutex, so taking that mutex here means it can't miss the notification.
+		if (m_sleepingThreads.load() != 0)
+		{
+			{ lock_guard<mutex> lock(m_sleepMutex); }
+			m_conditionVar.notify_one();
+		}
+	}
+
+	bool Threading::Execute(const JobHandle& job)
+	{
+		// A job stays queued when a waiting thread runs it directly, whoever gets to it last skips it
+		if (job->m_claimed.exchange(true, memory_order_acq_rel))
+			return false;
+
+		job->m_function();
+		job->m_function = nullptr; // release anything the function captured
+
+		// Mark as complete and collect the jobs that were waiting on this one
+		vector<JobHandle> continuations;
+		{
+			lock_guard<mutex> lock(job->m_continuationsMutex);
+			job->m_complete.store(true, memory_order_release);
+			continuations.swap(job->m_continuations);
+		}
+		job->m_completeCondition.notify_all();
+
+		for (const auto& continuation : continuations)
+		{
+			if (continuation->m_pendingDependencies.fetch_sub(1, memory_order_acq_rel) == 1)
+			{
+				Schedule(continuation);
+			}
+		}
+
+		return true;
+	}
+
+	bool Threading::ExecuteNext()
+	{
+		while (JobHandle job = Pop())
+		{
+			if (Execute(job))
+				return true;
+		}
+
+		return false;
+	}
+
+	JobHandle Threading::Pop()
+	{
+		if (m_pendingJobs.load() == 0 || m_queues.empty())
+			return nullptr;
+
+		unsigned int queueCount	= (unsigned int)m_queues.size();
+		unsigned int ownIndex	= (g_queueOwner == this) ? g_queueIndex : m_threadCount;
+
+		// Own queue first, newest job (LIFO) as its data is most likely still in cache
+		{
+			auto& queue = m_queues[ownIndex];
+			lock_guard<mutex> lock(queue->mutex);
+			if (!queue->jobs.empty())
+			{
+				JobHandle job = move(queue->jobs.back());
+				queue->jobs.pop_back();
+				m_pendingJobs.fetch_sub(1);
+				return job;
+			}
+		}
+
+		// Steal the oldest job (FIFO) from the other queues
+		for (unsigned int i = 1; i < queueCount; i++)
+		{
+			auto& queue = m_queues[(ownIndex + i) % queueCount];
+			lock_guard<mutex> lock(queue->mutex);
+			if (!queue->jobs.empty())
+			{
+				JobHandle job = move(queue->jobs.front());
+				queue->jobs.pop_front();
+				m_pendingJobs.fetch_sub(1);
+				return job;
+			}
+		}
+
+		return nullptr;
 	}
-}
\ No newline at end of file
+}
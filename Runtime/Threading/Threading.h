@@ -23,30 +23,75 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =================
 #include <vector>
+#include <deque>
 #include <thread>
 #include <mutex>
-#include <queue>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
 #include "../Core/SubSystem.h"
 #include "../Logging/Log.h"
 //============================
 
 namespace Directus
 {
-	//= TASK ===============================================================================
-	class Task
+	class Threading;
+
+	//= JOB ==================================================================================
+	class Job
 	{
 	public:
 		typedef std::function<void()> functionType;
 
-		Task(functionType&& function) { m_function = std::forward<functionType>(function); }
-		void Execute() { m_function(); }
+		Job(functionType&& function) { m_function = std::forward<functionType>(function); }
+		bool IsComplete() const { return m_complete.load(std::memory_order_acquire); }
 
 	private:
+		friend class Threading;
+
+		bool IsReady() const { return m_pendingDependencies.load(std::memory_order_acquire) == 0; }
+
 		functionType m_function;
+		// Unfinished dependencies, plus one that is held while the job is being submitted
+		std::atomic<unsigned int> m_pendingDependencies = 1;
+		// Set by whichever thread runs the job, a waiting thread can run a job that is still sitting in a queue
+		std::atomic<bool> m_claimed						= false;
+		std::atomic<bool> m_complete					= false;
+		// Jobs that depend on this one, guarded by m_continuationsMutex
+		std::vector<std::shared_ptr<Job>> m_continuations;
+		std::mutex m_continuationsMutex;
+		// Signaled (with m_continuationsMutex) on completion, for non-worker threads that wait on a job they can't run
+		std::condition_variable m_completeCondition;
 	};
-	//======================================================================================
+	typedef std::shared_ptr<Job> JobHandle;
+	//========================================================================================
 
-	class Threading : public Subsystem
+	//= FUTURE ===============================================================================
+	template <typename T>
+	class Future
+	{
+	public:
+		Future() = default;
+		Future(Threading* threading, const JobHandle& job, const std::shared_ptr<T>& result)
+		{
+			m_threading = threading;
+			m_job		= job;
+			m_result	= result;
+		}
+
+		// Blocks (while helping the workers) until the result is available
+		T& Get();
+		bool IsReady() const				{ return m_job && m_job->IsComplete(); }
+		const JobHandle& GetHandle() const	{ return m_job; }
+
+	private:
+		Threading* m_threading = nullptr;
+		JobHandle m_job;
+		std::shared_ptr<T> m_result;
+	};
+	//========================================================================================
+
+	class ENGINE_CLASS Threading : public Subsystem
 	{
 	public:
 		Threading(Context* context);
@@ -57,38 +102,105 @@ namespace Directus
 		//========================
 
 		// This function is invoked by the threads
-		void Invoke();
+		void Invoke(unsigned int workerIndex);
+
+		// Add a task, it will only start once all of its dependencies have completed
+		template <typename Function>
+		JobHandle AddTask(Function&& function, const std::vector<JobHandle>& dependencies = {})
+		{
+			auto job = std::make_shared<Job>(std::forward<Function>(function));
+			Submit(job, dependencies);
+			return job;
+		}
+
+		// Add a task whose return value can be retrieved through the returned future
+		template <typename Function>
+		auto AddTaskWithResult(Function&& function, const std::vector<JobHandle>& dependencies = {})
+		{
+			typedef decltype(function()) resultType;
+			auto result	= std::make_shared<resultType>();
+			auto job	= AddTask([result, function = std::forward<Function>(function)]() mutable { *result = function(); }, dependencies);
+			return Future<resultType>(this, job, result);
+		}
 
-		// Add a task
+		// Invokes function(i) for every i in [begin, end), split into jobs of at most batchSize iterations.
+		// Blocks until all iterations have completed, the calling thread participates in the work.
 		template <typename Function>
-		void AddTask(Function&& function)
+		void ParallelFor(unsigned int begin, unsigned int end, Function&& function, unsigned int batchSize = 0)
 		{
-			if (m_threadCount == 0)
+			if (begin >= end)
+				return;
+
+			unsigned int count = end - begin;
+			if (batchSize == 0)
 			{
-				LOG_WARNING("Threading::AddTask: No available threads, function will execute in the same thread");
-				function();
+				// Aim for a few batches per thread so that stealing can balance uneven iterations
+				unsigned int batchCount = (m_threadCount + 1) * 4;
+				batchSize = (count + batchCount - 1) / batchCount;
+			}
+
+			if (m_threadCount == 0 || count <= batchSize)
+			{
+				for (unsigned int i = begin; i < end; i++)
+				{
+					function(i);
+				}
 				return;
 			}
 
-			// Lock tasks mutex
-			std::unique_lock<std::mutex> lock(m_tasksMutex);
+			std::vector<JobHandle> jobs;
+			jobs.reserve((count + batchSize - 1) / batchSize);
+			for (unsigned int batchBegin = begin; batchBegin < end; batchBegin += batchSize)
+			{
+				unsigned int batchEnd = batchBegin + batchSize < end ? batchBegin + batchSize : end;
+				jobs.emplace_back(AddTask([&function, batchBegin, batchEnd]()
+				{
+					for (unsigned int i = batchBegin; i < batchEnd; i++)
+					{
+						function(i);
+					}
+				}));
+			}
 
-			// Save the task
-			m_tasks.push(std::make_shared<Task>(std::bind(std::forward<Function>(function))));
+			Wait(jobs);
+		}
 
-			// Unlock the mutex
-			lock.unlock();
+		// Blocks until the job(s) complete. Meanwhile a worker executes any pending job, while any other thread (e.g. the main thread)
+		// only executes the jobs it waits for, so that an unrelated job (e.g. a scene load) never runs in the middle of its frame.
+		void Wait(const JobHandle& job);
+		void Wait(const std::vector<JobHandle>& jobs);
 
-			// Wake up a thread
-			m_conditionVar.notify_one();
-		}
+		unsigned int GetThreadCount() { return m_threadCount; }
 
 	private:
+		// A double-ended queue, the owning worker pushes and pops at the back while other threads steal from the front
+		struct WorkerQueue
+		{
+			std::deque<JobHandle> jobs;
+			std::mutex mutex;
+		};
+
+		void Submit(const JobHandle& job, const std::vector<JobHandle>& dependencies);
+		void Schedule(const JobHandle& job);
+		bool Execute(const JobHandle& job);
+		bool ExecuteNext();
+		JobHandle Pop();
+
 		unsigned int m_threadCount;
 		std::vector<std::thread> m_threads;
-		std::queue<std::shared_ptr<Task>> m_tasks;
-		std::mutex m_tasksMutex;
+		// One queue per worker, plus a last one shared by all non-worker threads
+		std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+		std::atomic<unsigned int> m_pendingJobs		= 0;
+		std::atomic<unsigned int> m_sleepingThreads	= 0;
+		std::mutex m_sleepMutex;
 		std::condition_variable m_conditionVar;
-		bool m_stopping;
+		std::atomic<bool> m_stopping;
 	};
-}
\ No newline at end of file
+
+	template <typename T>
+	T& Future<T>::Get()
+	{
+		m_threading->Wait(m_job);
+		return *m_result;
+	}
+}
@@ -265,11 +265,6 @@ namespace Directus
 		}
 		//=============================================
 
-		if (m_transform)
-		{
-			m_transform->AcquireChildren();
-		}
-
 		// Make the scene resolve
 		FIRE_EVENT(EVENT_SCENE_RESOLVE_START);
 	}
@@ -161,32 +161,15 @@ namespace Directus
 		// Compute ray given the origin and end
 		m_ray = Ray(GetTransform()->GetPosition(), ScreenToWorldPoint(mousePos));
 
-		// Hits <Distance, actor>
-		map<float, std::weak_ptr<Actor>> hits;
-
-		// Find all the actors that the ray hits
-		vector<std::weak_ptr<Actor>> actors = GetContext()->GetSubsystem<World>()->GetRenderables();
-		for (const auto& actor : actors)
+		// Find the closest renderable that the ray hits (excluding the SkyBox). Hits from within
+		// a bounding box (0.0f) or misses (INFINITY) are ignored by the bounding volume hierarchy.
+		auto bvh		= GetContext()->GetSubsystem<World>()->GetRenderablesBVH();
+		auto closest	= static_cast<Renderable*>(bvh->RayCast(m_ray, nullptr, [](void* userData)
 		{
-			// Make sure there actor has a mesh and exclude the SkyBox
-			if (!actor.lock()->HasComponent<Renderable>() || actor.lock()->HasComponent<Skybox>())
-				continue;
-
-			// Get bounding box
-			BoundingBox bb = actor.lock()->GetComponent<Renderable>().lock()->Geometry_BB();
-
-			// Compute hit distance
-			float hitDistance = m_ray.HitDistance(bb);
-
-			// Don't store hit data if we are inside the bounding box (0.0f) or there was no hit (INFINITY)
-			if (hitDistance == 0.0f || hitDistance == INFINITY)
-				continue;
-
-			hits[hitDistance] = actor;
-		}
+			return !static_cast<Renderable*>(userData)->GetActor_PtrRaw()->HasComponent<Skybox>();
+		}));
 
-		// Get closest hit
-		weak_ptr<Actor> hit = !hits.empty() ? hits.begin()->second : weak_ptr<Actor>();
+		weak_ptr<Actor> hit = closest ? closest->GetActor_PtrWeak() : weak_ptr<Actor>();
 
 		// Display transformation gizmo
 		m_transformGizmo->Pick(hit);
@@ -21,12 +21,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===============================
 #include "Renderable.h"
+#include <algorithm>
 #include "Transform.h"
 #include "../../IO/FileStream.h"
 #include "../../Resource/ResourceManager.h"
 #include "../../Rendering/GeometryUtility.h"
 #include "../../Rendering/Material.h"
 #include "../../Rendering/Model.h"
+#include "../../Math/Frustum.h"
+#include "../World.h"
 //==========================================
 
 //= NAMESPACES ================
@@ -36,6 +39,12 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace _Renderable
+	{
+		// Draws per renderable after meshlet culling
+		static const unsigned int maxRanges = 16;
+	}
+
 	namespace DefaultRenderables
 	{
 		inline void Build(GeometryType type, Renderable* renderable)
@@ -98,33 +107,47 @@ namespace Directus
 		m_geometryVertexCount	= 0;
 		m_materialDefault		= false;
 		m_materialRef			= nullptr;
+		m_model					= nullptr;
 		m_castShadows			= true;
 		m_receiveShadows		= true;
 
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_materialDefault, bool);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_materialRef, Material*);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_materialRefWeak, weak_ptr<Material>);
+		REGISTER_ATTRIBUTE_VALUE_SET(m_materialRefWeak, Material_SetRef, weak_ptr<Material>);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_castShadows, bool);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_receiveShadows, bool);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryIndexOffset, unsigned int);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryIndexCount, unsigned int);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryVertexOffset, unsigned int);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryVertexCount, unsigned int);
+		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryLod, unsigned int);
+		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryLodIndexOffset, unsigned int);
+		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryLodIndexCount, unsigned int);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryName, string);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_model, Model*);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryAABB, BoundingBox);
+		REGISTER_ATTRIBUTE_VALUE_SET(m_model, Geometry_SetModel, Model*);
+		REGISTER_ATTRIBUTE_VALUE_SET(m_geometryAABB, Geometry_SetAABB, BoundingBox);
 		REGISTER_ATTRIBUTE_GET_SET(Geometry_Type, Geometry_Set, GeometryType);
 	}
 
 	Renderable::~Renderable()
 	{
+		BVH_Remove();
+		Material_SetRef(weak_ptr<Material>());
+
+		Model* model = m_model;
+		Geometry_SetModel(nullptr);
 		if (m_geometryType != Geometry_Custom)
 		{
-			delete m_model;
+			delete model;
 		}
 	}
 
 	//= ICOMPONENT ===============================================================
+	void Renderable::OnRemove()
+	{
+		BVH_Remove();
+	}
+
 	void Renderable::Serialize(FileStream* stream)
 	{
 		// Mesh
@@ -154,10 +177,13 @@ namespace Directus
 		m_geometryIndexCount	= stream->ReadUInt();	
 		m_geometryVertexOffset	= stream->ReadUInt();
 		m_geometryVertexCount	= stream->ReadUInt();
-		stream->Read(&m_geometryAABB);
+		Geometry_SetLod(0);
+		BoundingBox AABB;
+		stream->Read(&AABB);
+		Geometry_SetAABB(AABB);
 		string modelName;
 		stream->Read(&modelName);
-		m_model = m_context->GetSubsystem<ResourceManager>()->GetResourceByName<Model>(modelName).lock().get();
+		Geometry_SetModel(m_context->GetSubsystem<ResourceManager>()->GetResourceByName<Model>(modelName).lock().get());
 
 		// If it was a default mesh, we have to reconstruct it
 		if (m_geometryType != Geometry_Custom) 
@@ -177,8 +203,7 @@ namespace Directus
 		{
 			string materialName;
 			stream->Read(&materialName);
-			m_materialRefWeak	= m_context->GetSubsystem<ResourceManager>()->GetResourceByName<Material>(materialName);
-			m_materialRef		= m_materialRefWeak.lock().get();
+			Material_SetRef(m_context->GetSubsystem<ResourceManager>()->GetResourceByName<Material>(materialName));
 		}
 	}
 	//==============================================================================
@@ -191,8 +216,9 @@ namespace Directus
 		m_geometryIndexCount	= indexCount;
 		m_geometryVertexOffset	= vertexOffset;
 		m_geometryVertexCount	= vertexCount;
-		m_geometryAABB			= AABB;
-		m_model					= model;
+		Geometry_SetModel(model);
+		Geometry_SetAABB(AABB);
+		Geometry_SetLod(0);
 	}
 
 	void Renderable::Geometry_Set(GeometryType type)
@@ -216,9 +242,179 @@ namespace Directus
 		m_model->Geometry_Get(m_geometryIndexOffset, m_geometryIndexCount, m_geometryVertexOffset, m_geometryVertexCount, indices, vertices);
 	}
 
-	BoundingBox Renderable::Geometry_BB()
+	const BoundingBox& Renderable::Geometry_BB()
+	{
+		unsigned int version = GetTransform()->GetWorldVersion();
+		if (m_geometryAABBWorldDirty || m_geometryAABBWorldVersion != version)
+		{
+			m_geometryAABBWorld			= m_geometryAABB.Transformed(GetTransform()->GetWorldTransform());
+			m_geometryAABBWorldVersion	= version;
+			m_geometryAABBWorldDirty	= false;
+		}
+
+		return m_geometryAABBWorld;
+	}
+
+	void Renderable::Geometry_SetAABB(const BoundingBox& AABB)
+	{
+		m_geometryAABB				= AABB;
+		m_geometryAABBWorldDirty	= true;
+
+		// Geometry can arrive after the renderable was indexed (async loads, imports, model swaps)
+		BVH_Update();
+	}
+
+	void Renderable::Geometry_SelectLod(float radiusPixels, float maxPixelError)
+	{
+		auto lods = m_model ? m_model->Geometry_GetLods(m_geometryIndexOffset) : nullptr;
+		if (!lods)
+			return;
+
+		// The errors grow with the level, take the last one that is still small enough on screen
+		unsigned int lod = 0;
+		while (lod < (unsigned int)lods->size() && (*lods)[lod].error * radiusPixels <= maxPixelError)
+		{
+			lod++;
+		}
+
+		if (lod != m_geometryLod)
+		{
+			Geometry_SetLod(lod);
+		}
+	}
+
+	void Renderable::Geometry_SetLod(unsigned int lod)
+	{
+		auto lods = m_model ? m_model->Geometry_GetLods(m_geometryIndexOffset) : nullptr;
+		if (lod == 0 || !lods || lod > (unsigned int)lods->size())
+		{
+			m_geometryLod				= 0;
+			m_geometryLodIndexOffset	= m_geometryIndexOffset;
+			m_geometryLodIndexCount		= m_geometryIndexCount;
+			return;
+		}
+
+		m_geometryLod				= lod;
+		m_geometryLodIndexOffset	= (*lods)[lod - 1].indexOffset;
+		m_geometryLodIndexCount		= (*lods)[lod - 1].indexCount;
+	}
+
+	bool Renderable::Geometry_CullMeshlets(const Frustum& frustum, const Vector3& cameraPosition)
+	{
+		m_geometryRanges.clear();
+		auto geometry = m_model ? m_model->Geometry_GetMeshlets(m_geometryLodIndexOffset) : nullptr;
+		if (!geometry)
+		{
+			m_geometryRanges.push_back({ m_geometryLodIndexOffset, m_geometryLodIndexCount });
+			return true;
+		}
+
+		// Spheres go to world space for the frustum, the camera goes to the mesh's space for the cones (facing survives any affine transform)
+		const Matrix& world		= GetTransform()->GetWorldTransform();
+		Vector3 scale			= GetTransform()->GetScale();
+		float radiusScale		= Helper::Max(Helper::Max(Helper::Abs(scale.x), Helper::Abs(scale.y)), Helper::Abs(scale.z));
+		bool cullBackFaces		= m_materialRef && m_materialRef->GetCullMode() == Cull_Back;
+		Vector3 cameraLocal		= cullBackFaces ? world.Inverted() * cameraPosition : Vector3::Zero;
+
+		for (const auto& group : geometry->groups)
+		{
+			// Groups entirely inside the frustum spare their meshlets the test
+			Intersection intersection = frustum.CheckSphere(world * group.center, group.radius * radiusScale);
+			if (intersection == Outside)
+				continue;
+
+			for (unsigned int i = group.first; i < group.first + group.count; i++)
+			{
+				const Meshlet& meshlet = geometry->meshlets[i];
+				if (intersection == Intersects && frustum.CheckSphere(world * meshlet.center, meshlet.radius * radiusScale) == Outside)
+					continue;
+
+				if (cullBackFaces && MeshletBuilder::IsBackFacing(meshlet, cameraLocal))
+					continue;
+
+				unsigned int indexOffset = m_geometryLodIndexOffset + meshlet.indexOffset;
+				if (!m_geometryRanges.empty() && m_geometryRanges.back().indexOffset + m_geometryRanges.back().indexCount == indexOffset)
+				{
+					m_geometryRanges.back().indexCount += meshlet.indexCount;
+				}
+				else
+				{
+					m_geometryRanges.push_back({ indexOffset, meshlet.indexCount });
+				}
+			}
+		}
+
+		// Past a few draws, culled meshlets are cheaper to draw than to skip. Keep only the widest gaps between the ranges.
+		if (m_geometryRanges.size() > _Renderable::maxRanges)
+		{
+			vector<unsigned int> gaps;
+			gaps.reserve(m_geometryRanges.size() - 1);
+			for (unsigned int i = 1; i < (unsigned int)m_geometryRanges.size(); i++)
+			{
+				gaps.emplace_back(m_geometryRanges[i].indexOffset - (m_geometryRanges[i - 1].indexOffset + m_geometryRanges[i - 1].indexCount));
+			}
+			vector<unsigned int> widest = gaps;
+			nth_element(widest.begin(), widest.begin() + (_Renderable::maxRanges - 1), widest.end(), greater<unsigned int>());
+			unsigned int minGap = widest[_Renderable::maxRanges - 1];
+
+			unsigned int count = 1;
+			for (unsigned int i = 1; i < (unsigned int)m_geometryRanges.size(); i++)
+			{
+				if (gaps[i - 1] > minGap)
+				{
+					m_geometryRanges[count++] = m_geometryRanges[i];
+				}
+				else
+				{
+					GeometryRange& last	= m_geometryRanges[count - 1];
+					last.indexCount		= m_geometryRanges[i].indexOffset + m_geometryRanges[i].indexCount - last.indexOffset;
+				}
+			}
+			m_geometryRanges.resize(count);
+		}
+
+		return !m_geometryRanges.empty();
+	}
+
+	unsigned int Renderable::Geometry_LodCount()
 	{
-		return m_geometryAABB.Transformed(GetTransform()->GetWorldTransform());
+		auto lods = m_model ? m_model->Geometry_GetLods(m_geometryIndexOffset) : nullptr;
+		return lods ? (unsigned int)lods->size() + 1 : 1;
+	}
+
+	void Renderable::Geometry_SetModel(Model* model)
+	{
+		if (model == m_model)
+			return;
+
+		if (m_model) m_model->UseCount_Decrement();
+		if (model) model->UseCount_Increment();
+		m_model = model;
+	}
+	//==============================================================================
+
+	//= SPATIAL ====================================================================
+	void Renderable::BVH_Update()
+	{
+		if (m_bvhProxy == BVH_PROXY_NONE)
+			return;
+
+		if (World* world = m_context->GetSubsystem<World>())
+		{
+			world->GetRenderablesBVH()->Update(m_bvhProxy, Geometry_BB());
+		}
+	}
+
+	void Renderable::BVH_Remove()
+	{
+		if (m_bvhProxy == BVH_PROXY_NONE)
+			return;
+
+		if (World* world = m_context->GetSubsystem<World>())
+		{
+			world->GetRenderablesBVH()->Remove(m_bvhProxy);
+		}
+		m_bvhProxy = BVH_PROXY_NONE;
 	}
 	//==============================================================================
 
@@ -238,8 +434,7 @@ namespace Directus
 		{
 			if (auto cachedMat = material->Cache<Material>().lock())
 			{
-				m_materialRefWeak = cachedMat;
-				m_materialRef = m_materialRefWeak.lock().get();
+				Material_SetRef(cachedMat);
 				if (cachedMat->HasFilePath())
 				{
 					m_materialRef->SaveToFile(material->GetResourceFilePath());
@@ -249,8 +444,7 @@ namespace Directus
 		}
 		else
 		{
-			m_materialRefWeak = material;
-			m_materialRef = m_materialRefWeak.lock().get();
+			Material_SetRef(material);
 		}
 	}
 
@@ -285,6 +479,19 @@ namespace Directus
 		Material_Set(materialStandard->Cache<Material>(), false);
 	}
 
+	void Renderable::Material_SetRef(const weak_ptr<Material>& material)
+	{
+		auto materialNew = material.lock();
+		auto materialOld = m_materialRefWeak.lock();
+		if (materialNew == materialOld)
+			return;
+
+		if (materialOld) materialOld->UseCount_Decrement();
+		if (materialNew) materialNew->UseCount_Increment();
+		m_materialRefWeak	= materialNew;
+		m_materialRef		= materialNew.get();
+	}
+
 	string Renderable::Material_Name()
 	{
 		return !Material_RefWeak().expired() ? Material_RefWeak().lock()->GetResourceName() : NOT_ASSIGNED;
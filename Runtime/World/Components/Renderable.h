@@ -31,13 +31,17 @@ namespace Directus
 {
 	class Model;
 	class Mesh;
+	struct Meshlet;
 	class Light;
 	class Material;
 	namespace Math
 	{
 		class Vector3;
+		class Frustum;
 	}
 
+	static const unsigned int BVH_PROXY_NONE = 0xFFFFFFFF;
+
 	enum GeometryType
 	{
 		Geometry_Custom,
@@ -48,6 +52,12 @@ namespace Directus
 		Geometry_Default_Cone
 	};
 
+	struct GeometryRange
+	{
+		unsigned int indexOffset;
+		unsigned int indexCount;
+	};
+
 	class ENGINE_CLASS Renderable : public IComponent
 	{
 	public:
@@ -55,6 +65,7 @@ namespace Directus
 		~Renderable();
 
 		//= ICOMPONENT ===============================
+		void OnRemove() override;
 		void Serialize(FileStream* stream) override;
 		void Deserialize(FileStream* stream) override;
 		//============================================
@@ -71,17 +82,37 @@ namespace Directus
 		);
 		void Geometry_Get(std::vector<unsigned int>* indices, std::vector<RHI_Vertex_PosUVTBN>* vertices);
 		void Geometry_Set(GeometryType type);
-		unsigned int Geometry_IndexOffset()				{ return m_geometryIndexOffset; }
-		unsigned int Geometry_IndexCount()				{ return m_geometryIndexCount; }		
+		// Of the selected level of detail
+		unsigned int Geometry_IndexOffset()				{ return m_geometryLodIndexOffset; }
+		unsigned int Geometry_IndexCount()				{ return m_geometryLodIndexCount; }		
 		unsigned int Geometry_VertexOffset()			{ return m_geometryVertexOffset; }
 		unsigned int Geometry_VertexCount()				{ return m_geometryVertexCount; }
 		GeometryType Geometry_Type()					{ return m_geometryType; }
 		const std::string& Geometry_Name()				{ return m_geometryName; }
 		Model* Geometry_Model()							{ return m_model; }
 		const Math::BoundingBox& Geometry_AABB() const	{ return m_geometryAABB; }
-		Math::BoundingBox Geometry_BB();
+		void Geometry_SetAABB(const Math::BoundingBox& AABB);
+		// World space AABB, cached until the transform or the geometry changes
+		const Math::BoundingBox& Geometry_BB();
 		//===============================================================================================
 
+		//= LEVEL OF DETAIL ===========================================================================================
+		// Selects the coarsest level whose error stays under maxPixelError, given the radius of the world space AABB in pixels
+		void Geometry_SelectLod(float radiusPixels, float maxPixelError = 1.0f);
+		void Geometry_SetLod(unsigned int lod);
+		unsigned int Geometry_Lod()						{ return m_geometryLod; }
+		// Including the full detail level
+		unsigned int Geometry_LodCount();
+		//=============================================================================================================
+
+		//= MESHLETS ==================================================================================================
+		// Culls the meshlets of the selected level against the frustum and, for materials that cull back faces, against
+		// the camera position. Returns false if none survived, the rest is drawn as Geometry_Ranges (adjacent meshlets merged).
+		bool Geometry_CullMeshlets(const Math::Frustum& frustum, const Math::Vector3& cameraPosition);
+		// The index ranges to draw, the whole selected level when there are no meshlets
+		const std::vector<GeometryRange>& Geometry_Ranges() { return m_geometryRanges; }
+		//=============================================================================================================
+
 		//= MATERIAL =========================================================================
 		// Sets a material from memory (adds it to the resource cache by default)
 		void Material_Set(const std::weak_ptr<Material>& materialWeak, bool autoCache = true);
@@ -103,7 +134,23 @@ namespace Directus
 		bool GetReceiveShadows()					{ return m_receiveShadows; }
 		//================================================================================
 
+		//= SPATIAL =======================================================================
+		// Id of this renderable in the world's bounding volume hierarchy
+		void SetBVHProxy(unsigned int proxy)		{ m_bvhProxy = proxy; }
+		unsigned int GetBVHProxy()					{ return m_bvhProxy; }
+		// Refit or drop the proxy, the hierarchy keeps a raw pointer to this renderable
+		void BVH_Update();
+		void BVH_Remove();
+		// Set by the renderer for every frame in which the renderable passes frustum culling
+		void SetVisibleFrame(uint64_t frame)		{ m_visibleFrame = frame; }
+		bool IsVisible(uint64_t frame)				{ return m_visibleFrame == frame; }
+		//================================================================================
+
 	private:
+		// Assign the references and count this renderable as a user of them, so they are never evicted
+		void Geometry_SetModel(Model* model);
+		void Material_SetRef(const std::weak_ptr<Material>& material);
+
 		//= GEOMETRY =======================
 		std::string m_geometryName;
 		unsigned int m_geometryIndexOffset;
@@ -111,6 +158,13 @@ namespace Directus
 		unsigned int m_geometryVertexOffset;
 		unsigned int m_geometryVertexCount;
 		Math::BoundingBox m_geometryAABB;
+		Math::BoundingBox m_geometryAABBWorld;
+		unsigned int m_geometryAABBWorldVersion	= 0;
+		bool m_geometryAABBWorldDirty			= true;
+		unsigned int m_geometryLod				= 0;
+		unsigned int m_geometryLodIndexOffset	= 0;
+		unsigned int m_geometryLodIndexCount	= 0;
+		std::vector<GeometryRange> m_geometryRanges;
 		Model* m_model;
 		GeometryType m_geometryType;
 		//==================================
@@ -124,5 +178,7 @@ namespace Directus
 		bool m_castShadows;
 		bool m_receiveShadows;
 		bool m_materialDefault;
+		unsigned int m_bvhProxy	= BVH_PROXY_NONE;
+		uint64_t m_visibleFrame	= 0;
 	};
 }
@@ -36,85 +36,80 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace _Transform
+	{
+		// Shared by the transforms that are created without a world (tools, tests), which nothing updates in batches so
+		// their matrices are always computed on demand. Never destroyed, as transforms can outlive any static.
+		TransformHierarchy* GetDetachedHierarchy()
+		{
+			static TransformHierarchy* hierarchy = new TransformHierarchy(nullptr);
+			return hierarchy;
+		}
+	}
+
 	Transform::Transform(Context* context, Actor* actor, Transform* transform) : IComponent(context, actor, transform)
 	{
-		m_positionLocal		= Vector3::Zero;
-		m_rotationLocal		= Quaternion(0, 0, 0, 1);
-		m_scaleLocal		= Vector3::One;
-		m_worldTransform	= Matrix::Identity;
-		m_localTransform	= Matrix::Identity;
-		m_parent			= nullptr;
-
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_positionLocal,	Vector3);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotationLocal,	Quaternion);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_scaleLocal, Vector3);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_worldTransform, Matrix);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_localTransform, Matrix);
+		m_parent = nullptr;
+
+		World* world = context->GetSubsystem<World>();
+		if (!world)
+		{
+			LOG_WARNING("Transform::Transform: There is no world, the transform won't be part of one");
+		}
+		m_hierarchy = world ? world->GetTransformHierarchy() : _Transform::GetDetachedHierarchy();
+		m_hierarchy->Register(this);
+
+		REGISTER_ATTRIBUTE_GET_SET(GetPositionLocal, SetPositionLocal, Vector3);
+		REGISTER_ATTRIBUTE_GET_SET(GetRotationLocal, SetRotationLocal, Quaternion);
+		REGISTER_ATTRIBUTE_GET_SET(GetScaleLocal, SetScaleLocal, Vector3);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_lookAt, Vector3);
 	}
 
 	Transform::~Transform()
 	{
+		// Make sure nobody is left pointing to this transform
+		if (m_parent)
+		{
+			m_parent->DetachChild(this);
+		}
+		for (const auto& child : GetChildren())
+		{
+			child->m_parent = nullptr;
+			m_hierarchy->SetParent(child->m_hierarchyIndex, -1);
+		}
 
+		m_hierarchy->Unregister(this);
 	}
 
 	//= ICOMPONENT ==================================================================================
 	void Transform::OnInitialize()
 	{
-		UpdateTransform();
+		MarkDirty();
 	}
 
 	void Transform::Serialize(FileStream* stream)
 	{
-		stream->Write(m_positionLocal);
-		stream->Write(m_rotationLocal);
-		stream->Write(m_scaleLocal);
+		stream->Write(GetPositionLocal());
+		stream->Write(GetRotationLocal());
+		stream->Write(GetScaleLocal());
 		stream->Write(m_lookAt);
 		stream->Write(m_parent ? m_parent->GetActor_PtrRaw()->GetID() : NOT_ASSIGNED_HASH);
 	}
 
 	void Transform::Deserialize(FileStream* stream)
 	{
-		stream->Read(&m_positionLocal);
-		stream->Read(&m_rotationLocal);
-		stream->Read(&m_scaleLocal);
+		stream->Read(&m_hierarchy->m_positions[m_hierarchyIndex]);
+		stream->Read(&m_hierarchy->m_rotations[m_hierarchyIndex]);
+		stream->Read(&m_hierarchy->m_scales[m_hierarchyIndex]);
 		stream->Read(&m_lookAt);
+		// The parent's ID is only kept for compatibility, the
+		// owning actor sets the parent while it deserializes.
 		unsigned int parentActorID = 0;
 		stream->Read(&parentActorID);
 
-		if (parentActorID != NOT_ASSIGNED_HASH)
-		{
-			auto parent = GetContext()->GetSubsystem<World>()->GetActorByID(parentActorID);
-			if (!parent.expired())
-			{
-				parent.lock()->GetTransform_PtrRaw()->AddChild(this);
-			}
-		}
-
-		UpdateTransform();
+		MarkDirty();
 	}
 	//===============================================================================================
-	void Transform::UpdateTransform()
-	{
-		// Compute local transform
-		m_localTransform = Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal);
-
-		// Compute world transform
-		if (!HasParent())
-		{
-			m_worldTransform = m_localTransform;
-		}
-		else
-		{
-			m_worldTransform = m_localTransform * GetParentTransformMatrix();
-		}
-		
-		// Update children
-		for (const auto& child : m_children)
-		{
-			child->UpdateTransform();
-		}
-	}
 
 	//= TRANSLATION ==================================================================================
 	void Transform::SetPosition(const Vector3& position)
@@ -127,11 +122,12 @@ namespace Directus
 
 	void Transform::SetPositionLocal(const Vector3& position)
 	{
-		if (m_positionLocal == position)
+		Vector3& positionLocal = m_hierarchy->m_positions[m_hierarchyIndex];
+		if (positionLocal == position)
 			return;
 
-		m_positionLocal = position;
-		UpdateTransform();
+		positionLocal = position;
+		MarkDirty();
 	}
 	//================================================================================================
 
@@ -146,11 +142,12 @@ namespace Directus
 
 	void Transform::SetRotationLocal(const Quaternion& rotation)
 	{
-		if (m_rotationLocal == rotation)
+		Quaternion& rotationLocal = m_hierarchy->m_rotations[m_hierarchyIndex];
+		if (rotationLocal == rotation)
 			return;
 
-		m_rotationLocal = rotation;
-		UpdateTransform();
+		rotationLocal = rotation;
+		MarkDirty();
 	}
 	//================================================================================================
 
@@ -165,18 +162,19 @@ namespace Directus
 
 	void Transform::SetScaleLocal(const Vector3& scale)
 	{
-		if (m_scaleLocal == scale)
+		Vector3& scaleLocal = m_hierarchy->m_scales[m_hierarchyIndex];
+		if (scaleLocal == scale)
 			return;
 
-		m_scaleLocal = scale;
+		scaleLocal = scale;
 
 		// A scale of 0 will cause a division by zero when 
 		// decomposing the world transform matrix.
-		m_scaleLocal.x = (m_scaleLocal.x == 0.0f) ? M_EPSILON : m_scaleLocal.x;
-		m_scaleLocal.y = (m_scaleLocal.y == 0.0f) ? M_EPSILON : m_scaleLocal.y;
-		m_scaleLocal.z = (m_scaleLocal.z == 0.0f) ? M_EPSILON : m_scaleLocal.z;
+		scaleLocal.x = (scaleLocal.x == 0.0f) ? M_EPSILON : scaleLocal.x;
+		scaleLocal.y = (scaleLocal.y == 0.0f) ? M_EPSILON : scaleLocal.y;
+		scaleLocal.z = (scaleLocal.z == 0.0f) ? M_EPSILON : scaleLocal.z;
 
-		UpdateTransform();
+		MarkDirty();
 	}
 	//================================================================================================
 
@@ -185,11 +183,11 @@ namespace Directus
 	{
 		if (!HasParent())
 		{
-			SetPositionLocal(m_positionLocal + delta);
+			SetPositionLocal(GetPositionLocal() + delta);
 		}
 		else
 		{
-			SetPositionLocal(m_positionLocal + GetParent()->GetWorldTransform().Inverted() * delta);
+			SetPositionLocal(GetPositionLocal() + GetParent()->GetWorldTransform().Inverted() * delta);
 		}
 	}
 
@@ -197,11 +195,11 @@ namespace Directus
 	{
 		if (!HasParent())
 		{
-			SetRotationLocal((m_rotationLocal * delta).Normalized());
+			SetRotationLocal((GetRotationLocal() * delta).Normalized());
 		}
 		else
 		{
-			SetRotationLocal(m_rotationLocal * GetRotation().Inverse() * delta * GetRotation());
+			SetRotationLocal(GetRotationLocal() * GetRotation().Inverse() * delta * GetRotation());
 		}	
 	}
 
@@ -239,6 +237,13 @@ namespace Directus
 		if (GetID() == newParent->GetID())
 			return;
 
+		// Parent and child index into the same arrays, transforms without a world can't join one
+		if (newParent->m_hierarchy != m_hierarchy)
+		{
+			LOG_WARNING("Transform::SetParent: The new parent belongs to another world");
+			return;
+		}
+
 		// make sure the new parent is different from the existing parent
 		if (HasParent())
 		{
@@ -249,11 +254,14 @@ namespace Directus
 		// if the new parent is a descendant of this transform
 		if (newParent->IsDescendantOf(this))
 		{
+			// copy the children as they will detach from this transform while iterating
+			vector<Transform*> children = GetChildren();
+
 			// if this transform already has a parent
 			if (this->HasParent())
 			{
 				// assign the parent of this transform to the children
-				for (const auto& child : m_children)
+				for (const auto& child : children)
 				{
 					child->SetParent(GetParent());
 				}
@@ -261,25 +269,21 @@ namespace Directus
 			else // if this transform doesn't have a parent
 			{
 				// make the children orphans
-				for (const auto& child : m_children)
+				for (const auto& child : children)
 				{
 					child->BecomeOrphan();
 				}
 			}
 		}
 
-		// Switch parent but keep a pointer to the old one
-		auto parentOld = m_parent;
-		m_parent = newParent;
-		if (parentOld) parentOld->AcquireChildren(); // update the old parent (so it removes this child)
-
-		// make the new parent "aware" of this transform/child
+		// Leave the old parent (if any) and join the new one
 		if (m_parent)
 		{
-			m_parent->AcquireChildren();
+			m_parent->DetachChild(this);
 		}
-
-		UpdateTransform();
+		m_parent = newParent;
+		m_parent->AttachChild(this);
+		m_hierarchy->SetParent(m_hierarchyIndex, m_parent->m_hierarchyIndex);
 	}
 
 	void Transform::AddChild(Transform* child)
@@ -309,12 +313,12 @@ namespace Directus
 			return nullptr;
 		}
 
-		return m_children[index];
+		return GetChildren()[index];
 	}
 
 	Transform* Transform::GetChildByName(const string& name)
 	{
-		for (const auto& child : m_children)
+		for (const auto& child : GetChildren())
 		{
 			if (child->GetActorName() == name)
 				return child;
@@ -323,47 +327,15 @@ namespace Directus
 		return nullptr;
 	}
 
-	// Searches the entire hierarchy, finds any children and saves them in m_children.
-	// This is a recursive function, the children will also find their own children and so on...
-	void Transform::AcquireChildren()
-	{
-		m_children.clear();
-		m_children.shrink_to_fit();
-
-		auto actors = GetContext()->GetSubsystem<World>()->GetAllActors();
-		for (const auto& actor : actors)
-		{
-			if (!actor)
-				continue;
-
-			// get the possible child
-			Transform* possibleChild = actor->GetTransform_PtrRaw();
-
-			// if it doesn't have a parent, forget about it.
-			if (!possibleChild->HasParent())
-				continue;
-
-			// if it's parent matches this transform
-			if (possibleChild->GetParent()->GetID() == m_ID)
-			{
-				// welcome home son
-				m_children.emplace_back(possibleChild);
-
-				// make the child do the same thing all over, essentialy
-				// resolving the entire hierarchy.
-				possibleChild->AcquireChildren();
-			}
-		}
-	}
-
 	bool Transform::IsDescendantOf(Transform* transform)
 	{
-		vector<Transform*> descendants;
-		transform->GetDescendants(&descendants);
+		if (!transform)
+			return false;
 
-		for (const auto& descendant : descendants)
+		// Walk up the chain of ancestors
+		for (Transform* ancestor = m_parent; ancestor; ancestor = ancestor->m_parent)
 		{
-			if (descendant->GetID() == m_ID)
+			if (ancestor == transform)
 				return true;
 		}
 
@@ -373,18 +345,13 @@ namespace Directus
 	void Transform::GetDescendants(vector<Transform*>* descendants)
 	{
 		// Depth first acquisition of descendants
-		for (const auto& child : m_children)
+		for (const auto& child : GetChildren())
 		{
 			descendants->push_back(child);
 			child->GetDescendants(descendants);
 		}
 	}
 
-	Matrix Transform::GetParentTransformMatrix()
-	{
-		return HasParent() ? GetParent()->GetWorldTransform() : Matrix::Identity;
-	}
-
 	// Makes this transform have no parent
 	void Transform::BecomeOrphan()
 	{
@@ -392,21 +359,28 @@ namespace Directus
 		if (!m_parent)
 			return;
 
-		// create a temporary reference to the parent
-		Transform* tempRef = m_parent;
-
-		// delete the original reference
+		// make the parent forget about this child
+		m_parent->DetachChild(this);
 		m_parent = nullptr;
+		m_hierarchy->SetParent(m_hierarchyIndex, -1);
+	}
 
-		// Update the transform without the parent now
-		UpdateTransform();
+	void Transform::AttachChild(Transform* child)
+	{
+		child->m_childIndex = (unsigned int)m_children.size();
+		m_children.emplace_back(child);
+	}
+
+	void Transform::DetachChild(Transform* child)
+	{
+		if (child->m_childIndex >= m_children.size() || m_children[child->m_childIndex] != child)
+			return;
 
-		// make the parent search for children,
-		// that's indirect way of making tha parent "forget"
-		// about this child, since it won't be able to find it
-		if (tempRef)
+		// The order of the remaining children is preserved, only the ones after this child move
+		m_children.erase(m_children.begin() + child->m_childIndex);
+		for (unsigned int i = child->m_childIndex; i < (unsigned int)m_children.size(); i++)
 		{
-			tempRef->AcquireChildren();
+			m_children[i]->m_childIndex = i;
 		}
 	}
 }
\ No newline at end of file
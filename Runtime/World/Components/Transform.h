@@ -28,6 +28,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Math/Quaternion.h"
 #include "../../Math/Matrix.h"
 #include "../World.h"
+#include "../TransformHierarchy.h"
 //================================
 
 namespace Directus
@@ -44,28 +45,30 @@ namespace Directus
 		void Deserialize(FileStream* stream) override;
 		//============================================
 
-		void UpdateTransform();
+		// Schedules this transform (and its descendants) for the next batched update of the world's hierarchy
+		void MarkDirty() { m_hierarchy->SetDirty(m_hierarchyIndex); }
+		bool IsDirty() { return m_hierarchy->m_dirty[m_hierarchyIndex]; }
 
-		//= POSITION ============================================================
-		Math::Vector3 GetPosition() { return m_worldTransform.GetTranslation(); }
-		const Math::Vector3& GetPositionLocal() { return m_positionLocal; }
+		//= POSITION ===============================================================================================
+		Math::Vector3 GetPosition() { return GetWorldTransform().GetTranslation(); }
+		Math::Vector3 GetPositionLocal() { return m_hierarchy->m_positions[m_hierarchyIndex]; }
 		void SetPosition(const Math::Vector3& position);
 		void SetPositionLocal(const Math::Vector3& position);
-		//=======================================================================
+		//==========================================================================================================
 
-		//= ROTATION ============================================================
-		Math::Quaternion GetRotation() { return m_worldTransform.GetRotation(); }
-		const Math::Quaternion& GetRotationLocal() { return m_rotationLocal; }
+		//= ROTATION ===============================================================================================
+		Math::Quaternion GetRotation() { return GetWorldTransform().GetRotation(); }
+		Math::Quaternion GetRotationLocal() { return m_hierarchy->m_rotations[m_hierarchyIndex]; }
 		void SetRotation(const Math::Quaternion& rotation);
 		void SetRotationLocal(const Math::Quaternion& rotation);
-		//=======================================================================
+		//==========================================================================================================
 
-		//= SCALE ======================================================
-		Math::Vector3 GetScale() { return m_worldTransform.GetScale(); }
-		const Math::Vector3& GetScaleLocal() { return m_scaleLocal; }
+		//= SCALE ==================================================================================================
+		Math::Vector3 GetScale() { return GetWorldTransform().GetScale(); }
+		Math::Vector3 GetScaleLocal() { return m_hierarchy->m_scales[m_hierarchyIndex]; }
 		void SetScale(const Math::Vector3& scale);
 		void SetScaleLocal(const Math::Vector3& scale);
-		//==============================================================
+		//==========================================================================================================
 
 		//= TRANSLATION/ROTATION ==================
 		void Translate(const Math::Vector3& delta);
@@ -89,31 +92,36 @@ namespace Directus
 		Transform* GetParent()	{ return m_parent; }
 		Transform* GetChildByIndex(int index);
 		Transform* GetChildByName(const std::string& name);
-		const std::vector<Transform*>& GetChildren() { return m_children; }
-		int GetChildrenCount() { return (int)m_children.size(); }
-		void AcquireChildren();
+		const std::vector<Transform*>& GetChildren() const	{ return m_children; }
+		int GetChildrenCount() const						{ return (int)m_children.size(); }
 		bool IsDescendantOf(Transform* transform);
 		void GetDescendants(std::vector<Transform*>* descendants);
 		//=============================================================================
 
 		void LookAt(const Math::Vector3& v) { m_lookAt = v; }
-		Math::Matrix& GetWorldTransform()	{ return m_worldTransform; }
-		Math::Matrix& GetLocalTransform()	 { return m_localTransform; }
+		// Up to date even before the hierarchy's batched update, the chain of dirty ancestors is recomputed on demand.
+		// Copies, the hierarchy's arrays grow and get reordered as transforms come and go.
+		Math::Matrix GetWorldTransform()	{ return m_hierarchy->GetWorld(m_hierarchyIndex); }
+		Math::Matrix GetLocalTransform()	{ m_hierarchy->GetWorld(m_hierarchyIndex); return m_hierarchy->m_locals[m_hierarchyIndex]; }
+		// Increments every time the hierarchy's batched update recomputes the world matrix, allows dependent data to be cached
+		unsigned int GetWorldVersion()		{ return m_hierarchy->m_versions[m_hierarchyIndex]; }
 
 	private:
-		// local
-		Math::Vector3 m_positionLocal;
-		Math::Quaternion m_rotationLocal;
-		Math::Vector3 m_scaleLocal;
+		friend class TransformHierarchy;
 
-		Math::Matrix m_worldTransform;
-		Math::Matrix m_localTransform;
 		Math::Vector3 m_lookAt;
 
 		Transform* m_parent; // the parent of this transform
 		std::vector<Transform*> m_children; // the children of this transform
+		unsigned int m_childIndex = 0; // index of this transform in the parent's children
 
-		//= HELPER FUNCTIONS ================================================================
-		Math::Matrix GetParentTransformMatrix();
+		// The local transform, the parent index and the matrices live in the world's hierarchy
+		TransformHierarchy* m_hierarchy;
+		int m_hierarchyIndex = -1;
+
+		//= HELPER FUNCTIONS =======================
+		void AttachChild(Transform* child);
+		void DetachChild(Transform* child);
+		//==========================================
 	};
 }
\ No newline at end of file
@@ -0,0 +1,257 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======================
+#include "TransformHierarchy.h"
+#include <cassert>
+#include "Components/Transform.h"
+#include "../Core/Context.h"
+#include "../Threading/Threading.h"
+#include "../Profiling/Profiler.h"
+//=================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus::Math;
+//=============================
+
+namespace Directus
+{
+	// Below this amount of transforms, spreading the update over threads costs more than it saves
+	static const unsigned int g_parallelUpdateThreshold = 1024;
+
+	TransformHierarchy::TransformHierarchy(Context* context)
+	{
+		m_context	= context;
+		m_threadID	= this_thread::get_id();
+	}
+
+	void TransformHierarchy::Register(Transform* transform)
+	{
+		if (!transform)
+			return;
+
+		// The arrays reallocate, any other thread could be reading them
+		assert(this_thread::get_id() == m_threadID && "Transforms have to be created on the main thread");
+
+		transform->m_hierarchyIndex = (int)m_transforms.size();
+		m_transforms.emplace_back(transform);
+		m_positions.emplace_back(Vector3::Zero);
+		m_rotations.emplace_back(Quaternion(0, 0, 0, 1));
+		m_scales.emplace_back(Vector3::One);
+		m_parents.emplace_back(-1);
+		m_dirty.emplace_back(1);
+		m_locals.emplace_back(Matrix::Identity);
+		m_worlds.emplace_back(Matrix::Identity);
+		m_versions.emplace_back(0);
+		m_orderDirty		= true;
+		m_pendingUpdates	= true;
+	}
+
+	void TransformHierarchy::Unregister(Transform* transform)
+	{
+		if (!transform || transform->m_hierarchyIndex < 0)
+			return;
+
+		assert(this_thread::get_id() == m_threadID && "Transforms have to be destroyed on the main thread");
+
+		// Move the last transform into the freed index and pop, O(1). Its children follow it.
+		int index	= transform->m_hierarchyIndex;
+		int last	= (int)m_transforms.size() - 1;
+		if (index != last)
+		{
+			ForEachArray([index](auto& array) { array[index] = array.back(); });
+			m_transforms[index]->m_hierarchyIndex = index;
+			for (const auto& child : m_transforms[index]->GetChildren())
+			{
+				m_parents[child->m_hierarchyIndex] = index;
+			}
+		}
+		ForEachArray([](auto& array) { array.pop_back(); });
+
+		transform->m_hierarchyIndex	= -1;
+		m_orderDirty				= true;
+	}
+
+	void TransformHierarchy::SetParent(int index, int parent)
+	{
+		m_parents[index]	= parent;
+		m_orderDirty		= true;
+		SetDirty(index);
+	}
+
+	Matrix& TransformHierarchy::ComputeChain(int index)
+	{
+		// Find the top most dirty transform in the chain of ancestors
+		int topmostDirty = -1;
+		for (int i = index; i != -1; i = m_parents[i])
+		{
+			if (m_dirty[i])
+			{
+				topmostDirty = i;
+			}
+		}
+
+		// Recompute from there down to this transform. Dirty flags are left intact as
+		// the batched update still has to propagate the change to the rest of the subtree.
+		if (topmostDirty != -1)
+		{
+			ComputeFrom(index, topmostDirty);
+		}
+
+		return m_worlds[index];
+	}
+
+	void TransformHierarchy::ComputeFrom(int index, int ancestor)
+	{
+		int parent = m_parents[index];
+		if (index != ancestor && parent != -1)
+		{
+			ComputeFrom(parent, ancestor);
+		}
+
+		m_locals[index] = Matrix(m_positions[index], m_rotations[index], m_scales[index]);
+		m_worlds[index] = parent == -1 ? m_locals[index] : m_locals[index] * m_worlds[parent];
+	}
+
+	void TransformHierarchy::Update()
+	{
+		m_changedTransforms.clear();
+
+		if (!m_pendingUpdates)
+			return;
+
+		TIME_BLOCK_START_CPU();
+
+		if (m_orderDirty)
+		{
+			Sort();
+		}
+
+		// Subtrees don't share any data, so they can be updated in parallel
+		auto threading = m_context ? m_context->GetSubsystem<Threading>() : nullptr;
+		if (threading && m_transforms.size() >= g_parallelUpdateThreshold && m_subtrees.size() > 1)
+		{
+			threading->ParallelFor(0, (unsigned int)m_subtrees.size(), [this](unsigned int i)
+			{
+				UpdateRange(m_subtrees[i].begin, m_subtrees[i].end);
+			});
+		}
+		else
+		{
+			UpdateRange(0, (unsigned int)m_transforms.size());
+		}
+
+		for (unsigned int i = 0; i < (unsigned int)m_transforms.size(); i++)
+		{
+			if (m_changed[i])
+			{
+				m_changedTransforms.emplace_back(m_transforms[i]);
+			}
+		}
+
+		m_pendingUpdates = false;
+
+		TIME_BLOCK_END_CPU();
+	}
+
+	void TransformHierarchy::Sort()
+	{
+		// Depth first traversal from every root, parents always end up before their children
+		// and every root's subtree is a contiguous range
+		vector<int> order;
+		vector<int> stack;
+		order.reserve(m_transforms.size());
+		m_subtrees.clear();
+		for (int root = 0; root < (int)m_transforms.size(); root++)
+		{
+			if (m_parents[root] != -1)
+				continue;
+
+			SubtreeRange range;
+			range.begin = (unsigned int)order.size();
+
+			stack.emplace_back(root);
+			while (!stack.empty())
+			{
+				int index = stack.back();
+				stack.pop_back();
+				order.emplace_back(index);
+
+				const auto& children = m_transforms[index]->GetChildren();
+				for (auto it = children.rbegin(); it != children.rend(); ++it)
+				{
+					stack.emplace_back((*it)->m_hierarchyIndex);
+				}
+			}
+
+			range.end = (unsigned int)order.size();
+			m_subtrees.emplace_back(range);
+		}
+
+		// Move everything into that order
+		vector<int> sortedIndex(order.size());
+		for (unsigned int i = 0; i < (unsigned int)order.size(); i++)
+		{
+			sortedIndex[order[i]] = (int)i;
+		}
+		ForEachArray([&order](auto& array)
+		{
+			typename std::decay<decltype(array)>::type sorted;
+			sorted.reserve(order.size());
+			for (int index : order)
+			{
+				sorted.emplace_back(array[index]);
+			}
+			array.swap(sorted);
+		});
+		for (unsigned int i = 0; i < (unsigned int)m_transforms.size(); i++)
+		{
+			m_transforms[i]->m_hierarchyIndex = (int)i;
+			if (m_parents[i] != -1)
+			{
+				m_parents[i] = sortedIndex[m_parents[i]];
+			}
+		}
+
+		m_changed.assign(m_transforms.size(), 0);
+		m_orderDirty = false;
+	}
+
+	void TransformHierarchy::UpdateRange(unsigned int begin, unsigned int end)
+	{
+		for (unsigned int i = begin; i < end; i++)
+		{
+			int parent = m_parents[i];
+
+			// A transform has to be updated if it changed itself or if its parent's world matrix changed
+			bool changed	= m_dirty[i] || (parent != -1 && m_changed[parent]);
+			m_changed[i]	= changed;
+			if (!changed)
+				continue;
+
+			m_locals[i]	= Matrix(m_positions[i], m_rotations[i], m_scales[i]);
+			m_worlds[i]	= parent == -1 ? m_locals[i] : m_locals[i] * m_worlds[parent];
+			m_dirty[i]	= 0;
+			m_versions[i]++;
+		}
+	}
+}
@@ -0,0 +1,114 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <vector>
+#include <thread>
+#include "../Core/EngineDefs.h"
+#include "../Math/Vector3.h"
+#include "../Math/Quaternion.h"
+#include "../Math/Matrix.h"
+//=============================
+
+namespace Directus
+{
+	class Context;
+	class Transform;
+
+	// Keeps every transform of the world in flat arrays, the local position, rotation and scale, the parent index,
+	// the dirty flag and the matrices. Transforms only know their index. Setters flag a transform dirty, Update()
+	// sorts the arrays topologically (parents before children) if the hierarchy changed and then refreshes all the
+	// world matrices in a single linear pass, so moving a root several times per frame costs one subtree update.
+	// Nothing is locked, transforms are created, destroyed and modified on the thread that created the hierarchy (the
+	// main thread), anything else goes through World::MainThread_Run.
+	class ENGINE_CLASS TransformHierarchy
+	{
+	public:
+		TransformHierarchy(Context* context);
+		~TransformHierarchy() {}
+
+		// Adds the transform as a root, with an identity local transform. Asserts that it's called on the main thread.
+		void Register(Transform* transform);
+		void Unregister(Transform* transform);
+
+		// Refreshes the world matrices (and world versions) of all dirty transforms and their descendants
+		void Update();
+
+		bool HasPendingUpdates()			{ return m_pendingUpdates; }
+		unsigned int GetTransformCount()	{ return (unsigned int)m_transforms.size(); }
+		// Transforms whose world matrix changed during the last Update()
+		const std::vector<Transform*>& GetChangedTransforms() { return m_changedTransforms; }
+
+	private:
+		friend class Transform;
+
+		void SetParent(int index, int parent);
+		void SetDirty(int index) { m_dirty[index] = 1; m_pendingUpdates = true; }
+		// The world matrix ahead of Update(), recomputes the chain of dirty ancestors (without touching the versions)
+		Math::Matrix& GetWorld(int index) { return m_pendingUpdates ? ComputeChain(index) : m_worlds[index]; }
+		Math::Matrix& ComputeChain(int index);
+		void ComputeFrom(int index, int ancestor);
+		void Sort();
+		void UpdateRange(unsigned int begin, unsigned int end);
+
+		// Applies the function to every per transform array
+		template <typename Function>
+		void ForEachArray(Function&& function)
+		{
+			function(m_transforms);
+			function(m_positions);
+			function(m_rotations);
+			function(m_scales);
+			function(m_parents);
+			function(m_dirty);
+			function(m_locals);
+			function(m_worlds);
+			function(m_versions);
+		}
+
+		struct SubtreeRange
+		{
+			unsigned int begin;
+			unsigned int end;
+		};
+
+		Context* m_context;
+		std::thread::id m_threadID;
+		// Per transform, by index
+		std::vector<Transform*> m_transforms;
+		std::vector<Math::Vector3> m_positions;
+		std::vector<Math::Quaternion> m_rotations;
+		std::vector<Math::Vector3> m_scales;
+		std::vector<int> m_parents;
+		std::vector<unsigned char> m_dirty;
+		std::vector<Math::Matrix> m_locals;
+		std::vector<Math::Matrix> m_worlds;
+		std::vector<unsigned int> m_versions;
+		// Scratch of Update()
+		std::vector<unsigned char> m_changed;
+		std::vector<SubtreeRange> m_subtrees;
+		std::vector<Transform*> m_changedTransforms;
+		bool m_orderDirty		= true;
+		bool m_pendingUpdates	= false;
+	};
+}
@@ -24,7 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ====================
 #include "TransformationGizmo.h"
 #include "Actor.h"
-#include "Components\Transform.h"
+#include "Components/Transform.h"
 //===============================
 
 //=============================
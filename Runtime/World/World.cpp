@@ -21,6 +21,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===========================
 #include "World.h"
+#include <unordered_set>
 #include "Actor.h"
 #include "Components/Transform.h"
 #include "Components/Camera.h"
@@ -45,22 +46,54 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace _World
+	{
+		static const char* sectionActors		= "actors";
+		static const char* sectionComponents	= "components";		// Serialized one after the other, by files written before incremental saves
+		static const char* sectionComponentData	= "component_data";	// Serialized separately, so that deltas can replace them
+		static const char* sectionDelta			= "delta";
+		static const unsigned int deltaCountMax	= 16;
+		static const unsigned int snapshotBatch	= 1024; // Actors
+		static const unsigned int noParent		= (unsigned int)NOT_ASSIGNED_HASH;
+
+		inline uint64_t HashPaths(const vector<string>& paths)
+		{
+			Hash hash;
+			for (const auto& path : paths)
+			{
+				hash.Update(path.data(), path.size() + 1);
+			}
+			return hash.Digest();
+		}
+	}
+
 	World::World(Context* context) : Subsystem(context)
 	{
-		m_ambientLight	= Vector3::Zero;
-		m_state			= Scene_Idle;
+		m_ambientLight			= Vector3::Zero;
+		m_state					= Scene_Idle;
+		m_transformHierarchy	= make_unique<TransformHierarchy>(context);
+		m_renderablesBVH		= make_unique<BoundingVolumeHierarchy>();
 
 		SUBSCRIBE_TO_EVENT(EVENT_SCENE_RESOLVE_START, [this](Variant) { m_isDirty = true; });
+		SUBSCRIBE_TO_EVENT(EVENT_FRAME_START, EVENT_HANDLER(MainThread_Flush));
 		SUBSCRIBE_TO_EVENT(EVENT_TICK, EVENT_HANDLER(Tick));
 	}
 
 	World::~World()
 	{
+		// Release a loader that is waiting on the main thread, it will give up
+		{
+			lock_guard<mutex> lock(m_mainThreadMutex);
+			m_mainThreadStopping = true;
+		}
+		m_mainThreadCondition.notify_all();
+
 		Unload();
 	}
 
 	bool World::Initialize()
 	{
+		m_mainThreadID	= this_thread::get_id();
 		m_isDirty		= true;
 		m_mainCamera	= CreateCamera();
 		CreateSkybox();
@@ -110,6 +143,19 @@ namespace Directus
 			actor->Tick();
 		}
 
+		// Refresh the world matrices of everything that moved during this tick
+		m_transformHierarchy->Update();
+
+		// Keep the bounding volume hierarchy in sync with the renderables that moved
+		for (const auto& transform : m_transformHierarchy->GetChangedTransforms())
+		{
+			Renderable* renderable = transform->GetActor_PtrRaw()->GetRenderable_PtrRaw();
+			if (renderable && renderable->GetBVHProxy() != BVH_PROXY_NONE)
+			{
+				m_renderablesBVH->Update(renderable->GetBVHProxy(), renderable->Geometry_BB());
+			}
+		}
+
 		m_state = Scene_Idle;
 
 		TIME_BLOCK_END_CPU();
@@ -119,18 +165,28 @@ namespace Directus
 	{
 		FIRE_EVENT(EVENT_SCENE_UNLOAD);
 
+		// Actors can outlive the world's references to them, their proxies are about to be cleared
+		for (const auto& actor : m_actors)
+		{
+			if (Renderable* renderable = actor->GetRenderable_PtrRaw())
+			{
+				renderable->SetBVHProxy(BVH_PROXY_NONE);
+			}
+		}
+
 		m_actors.clear();
 		m_actors.shrink_to_fit();
 
 		m_renderables.clear();
 		m_renderables.shrink_to_fit();
+
+		m_renderablesBVH->Clear();
 	}
 	//=========================================================================================================
 
 	//= I/O ===================================================================================================
 	bool World::SaveToFile(const string& filePathIn)
 	{
-		m_state = Scene_Saving;
 		ProgressReport::Get().Reset(g_progress_Scene);
 		ProgressReport::Get().SetIsLoading(g_progress_Scene, true);
 		ProgressReport::Get().SetStatus(g_progress_Scene, "Saving scene...");
@@ -146,44 +202,54 @@ namespace Directus
 		// Save any in-memory changes done to resources while running.
 		m_context->GetSubsystem<ResourceManager>()->SaveResourcesToFiles();
 
-		// Create a prefab file
-		auto file = make_unique<FileStream>(filePath, FileStreamMode_Write);
-		if (!file->IsOpen())
+		// Only the snapshot holds up the main thread, it's hashed and written on this one
+		Snapshot snapshot;
+		if (!MainThread_Run([this, &snapshot]() { Save_Snapshot(&snapshot); }))
 		{
-			m_state = Scene_Idle;
+			ProgressReport::Get().SetIsLoading(g_progress_Scene, false);
 			return false;
 		}
 
-		// Save currently loaded resource paths
-		vector<string> filePaths;
-		m_context->GetSubsystem<ResourceManager>()->GetResourceFilePaths(filePaths);
-		file->Write(filePaths);
-
-		//= Save actors ============================
-		// Only save root actors as they will also save their descendants
-		vector<weak_ptr<Actor>> rootactors = GetRootActors();
-
-		// 1st - actor count
-		auto rootactorCount = (int)rootactors.size();
-		file->Write(rootactorCount);
-
-		// 2nd - actor IDs
-		for (const auto& root : rootactors)
+		auto threading = m_context->GetSubsystem<Threading>();
+		snapshot.componentHashes.resize(snapshot.components.size());
+		threading->ParallelFor(0, (unsigned int)snapshot.components.size(), [&snapshot](unsigned int i)
+		{
+			const auto& component		= snapshot.components[i];
+			snapshot.componentHashes[i]	= Hash::Compute(component.data, component.size);
+		});
+		snapshot.recordHashes.resize(snapshot.records.size());
+		for (unsigned int i = 0; i < (unsigned int)snapshot.records.size(); i++)
 		{
-			file->Write(root.lock()->GetID());
+			const ActorRecord& record	= snapshot.records[i];
+			snapshot.recordHashes[i]	= record.GetHash(record.parent >= 0 ? snapshot.records[record.parent].id : _World::noParent);
 		}
 
-		// 3rd - actors
-		for (const auto& root : rootactors)
+		bool saved = false;
 		{
-			root.lock()->Serialize(file.get());
+			lock_guard<mutex> lock(m_saveMutex);
+
+			// Changes can only be appended to the file the last save (or load) left behind, and only until they make up a good part of it
+			bool compact	= m_saved.deltaCount >= _World::deltaCountMax || m_saved.deltaSize > m_saved.baseSize / 2;
+			bool append		= !compact && m_saved.filePath == filePath && FileSystem::FileExists(filePath);
+			saved			= (append && Save_Delta(filePath, snapshot)) || Save_Full(filePath, snapshot);
+
+			// A failed full save may have left a partial file behind, nothing can be appended to it
+			if (!saved)
+			{
+				m_saved = SaveState();
+			}
+			else
+			{
+				m_saved.filePath	= filePath;
+				m_saved.resources	= _World::HashPaths(snapshot.resourcePaths);
+			}
 		}
-		//==============================================
 
-		m_state = Scene_Idle;
 		ProgressReport::Get().SetIsLoading(g_progress_Scene, false);
-		LOG_INFO("Scene: Saving took " + to_string((int)timer.GetElapsedTimeMs()) + " ms");	
+		if (!saved)
+			return false;
 
+		LOG_INFO("Scene: Saving took " + to_string((int)timer.GetElapsedTimeMs()) + " ms");	
 		FIRE_EVENT(EVENT_SCENE_SAVED);
 		return true;
 	}
@@ -196,51 +262,580 @@ namespace Directus
 			return false;
 		}
 
-		// Thread safety: Wait for scene and the renderer to stop the actors (could do double buffering in the future)
-		while (m_state == Scene_Ticking || Renderer::IsRendering()) { this_thread::sleep_for(chrono::milliseconds(16)); }
-		m_state = Scene_Loading;
-		 
 		ProgressReport::Get().Reset(g_progress_Scene);
 		ProgressReport::Get().SetIsLoading(g_progress_Scene, true);
 		ProgressReport::Get().SetStatus(g_progress_Scene, "Loading scene...");
+		Stopwatch timer;
 
-		Unload();
-
-		// Read all the resource file paths
 		auto file = make_unique<FileStream>(filePath, FileStreamMode_Read);
 		if (!file->IsOpen())
+		{
+			ProgressReport::Get().SetIsLoading(g_progress_Scene, false);
 			return false;
+		}
 
-		Stopwatch timer;
+		// The last save (or load) no longer describes the world, it is set again below for files that changes can be appended to
+		{
+			lock_guard<mutex> lock(m_saveMutex);
+			m_saved = SaveState();
+		}
 
+		// 1st - Structure, read into flat arrays without touching the world.
+		// Files that predate the actor section can only be read while the actors are created.
 		vector<string> resourcePaths;
+		vector<ActorRecord> actors;
+		ComponentData componentData;
 		file->Read(&resourcePaths);
+		bool legacy		= !file->Section_Seek(_World::sectionActors);
+		bool separate	= false;
+		if (!legacy)
+		{
+			Actors_Read(file.get(), &actors);
 
-		ProgressReport::Get().SetJobCount(g_progress_Scene, (int)resourcePaths.size());
+			// Files written by incremental saves keep each component apart, and may have changes appended
+			separate = file->Section_Seek(_World::sectionComponentData);
+			if (separate)
+			{
+				for (const auto& actor : actors)
+				{
+					for (const auto& component : actor.components)
+					{
+						componentData[component.second] = file->ReadSpan<std::byte>();
+					}
+				}
+				uint64_t baseSize = file->GetPosition();
+
+				Deltas_Read(file.get(), &resourcePaths, &actors, &componentData);
+
+				// What was just read is what the file contains, so the next save to it only has to append the changes
+				lock_guard<mutex> lock(m_saveMutex);
+				m_saved.filePath	= filePath;
+				m_saved.resources	= _World::HashPaths(resourcePaths);
+				m_saved.baseSize	= baseSize;
+				m_saved.deltaCount	= file->Section_Count(_World::sectionDelta);
+				m_saved.deltaSize	= m_saved.deltaCount != 0 ? file->GetPosition() - baseSize : 0;
+				for (const auto& actor : actors)
+				{
+					m_saved.actors[actor.id] = actor.GetHash(actor.parent >= 0 ? actors[actor.parent].id : _World::noParent);
+					for (const auto& component : actor.components)
+					{
+						const auto& data = componentData[component.second];
+						m_saved.components[component.second] = Hash::Compute(data.data, data.size);
+					}
+				}
+			}
+		}
+		ProgressReport::Get().SetJobCount(g_progress_Scene, (int)(resourcePaths.size() + actors.size()));
 
-		// Load all the resources
-		auto resourceMng = m_context->GetSubsystem<ResourceManager>();
-		for (const auto& resourcePath : resourcePaths)
+		// The current world (and its resources) goes away before the new resources are loaded
+		bool unloaded = MainThread_Run([this]()
+		{
+			m_state = Scene_Loading;
+			Unload();
+		});
+		if (!unloaded)
 		{
-			if (FileSystem::IsEngineModelFile(resourcePath))
+			ProgressReport::Get().SetIsLoading(g_progress_Scene, false);
+			return false;
+		}
+
+		// 2nd - Resources, in parallel
+		ProgressReport::Get().SetStatus(g_progress_Scene, "Loading resources...");
+		Resources_Load(resourcePaths);
+
+		// 3rd - Commit, the actors are created in one go on the main thread
+		ProgressReport::Get().SetStatus(g_progress_Scene, "Creating actors...");
+		MainThread_Run([this, &file, &actors, &componentData, legacy, separate]()
+		{
+			legacy ? Actors_CreateLegacy(file.get()) : Actors_Create(file.get(), actors, separate ? &componentData : nullptr);
+			m_isDirty	= true;
+			m_state		= Scene_Idle;
+		});
+
+		ProgressReport::Get().SetIsLoading(g_progress_Scene, false);	
+		LOG_INFO("Scene: Loading took " + to_string((int)timer.GetElapsedTimeMs()) + " ms");	
+
+		FIRE_EVENT(EVENT_SCENE_LOADED);
+		return true;
+	}
+	//===================================================================================================
+
+	//= SAVING ==========================================================================================
+	uint64_t World::ActorRecord::GetHash(unsigned int parentID) const
+	{
+		Hash hash;
+		hash.Update(&id, sizeof(id));
+		hash.Update(name.data(), name.size() + 1);
+		hash.Update(&isActive, sizeof(isActive));
+		hash.Update(&hierarchyVisibility, sizeof(hierarchyVisibility));
+		hash.Update(&parentID, sizeof(parentID));
+		hash.Update(components.data(), components.size() * sizeof(components[0]));
+		return hash.Digest();
+	}
+
+	void World::Save_Snapshot(Snapshot* snapshot)
+	{
+		m_context->GetSubsystem<ResourceManager>()->GetResourceFilePaths(snapshot->resourcePaths);
+
+		// Flattened depth first, so a loader can read the whole hierarchy before creating anything
+		vector<Actor*> actors;
+		vector<pair<Actor*, int>> stack;
+		vector<weak_ptr<Actor>> rootActors = GetRootActors();
+		for (auto it = rootActors.rbegin(); it != rootActors.rend(); ++it)
+		{
+			stack.emplace_back(it->lock().get(), -1);
+		}
+		while (!stack.empty())
+		{
+			auto [actor, parent] = stack.back();
+			stack.pop_back();
+
+			int index = (int)actors.size();
+			actors.emplace_back(actor);
+
+			ActorRecord record;
+			record.id					= actor->GetID();
+			record.name					= actor->GetName();
+			record.isActive				= actor->IsActive();
+			record.hierarchyVisibility	= actor->IsVisibleInHierarchy();
+			record.parent				= parent;
+			for (const auto& component : actor->GetAllComponents())
 			{
-				resourceMng->Load<Model>(resourcePath);
+				record.components.emplace_back((unsigned int)component.second->GetType(), component.second->GetID());
 			}
+			snapshot->records.emplace_back(move(record));
 
-			if (FileSystem::IsEngineMaterialFile(resourcePath))
+			const auto& children = actor->GetTransform_PtrRaw()->GetChildren();
+			for (auto it = children.rbegin(); it != children.rend(); ++it)
 			{
-				resourceMng->Load<Material>(resourcePath);
+				if ((*it)->GetActor_PtrRaw())
+				{
+					stack.emplace_back((*it)->GetActor_PtrRaw(), index);
+				}
 			}
+		}
 
-			if (FileSystem::IsEngineTextureFile(resourcePath))
+		// Serializing only reads the components, so batches of actors are serialized in parallel, each batch into its own buffer.
+		// Every component starts aligned, so that it can be read back on its own.
+		vector<unsigned int> offsets(actors.size() + 1, 0);
+		for (unsigned int i = 0; i < (unsigned int)actors.size(); i++)
+		{
+			offsets[i + 1] = offsets[i] + (unsigned int)snapshot->records[i].components.size();
+		}
+		vector<pair<uint64_t, uint64_t>> ranges(offsets.back());
+		unsigned int batchCount = ((unsigned int)actors.size() + _World::snapshotBatch - 1) / _World::snapshotBatch;
+		snapshot->data.resize(batchCount);
+		m_context->GetSubsystem<Threading>()->ParallelFor(0, batchCount, [&actors, &offsets, &ranges, snapshot](unsigned int batch)
+		{
+			FileStream stream(&snapshot->data[batch]);
+			unsigned int end = min((batch + 1) * _World::snapshotBatch, (unsigned int)actors.size());
+			for (unsigned int i = batch * _World::snapshotBatch; i < end; i++)
 			{
-				resourceMng->Load<RHI_Texture>(resourcePath);
+				unsigned int index = offsets[i];
+				for (const auto& component : actors[i]->GetAllComponents())
+				{
+					stream.Align();
+					ranges[index].first = stream.GetPosition();
+					component.second->Serialize(&stream);
+					ranges[index++].second = stream.GetPosition();
+				}
+			}
+		}, 1);
+
+		snapshot->components.resize(ranges.size());
+		for (unsigned int i = 0; i < (unsigned int)actors.size(); i++)
+		{
+			const std::byte* data = snapshot->data[i / _World::snapshotBatch].data();
+			for (unsigned int index = offsets[i]; index < offsets[i + 1]; index++)
+			{
+				snapshot->components[index].data = data + ranges[index].first;
+				snapshot->components[index].size = (unsigned int)(ranges[index].second - ranges[index].first);
+			}
+		}
+	}
+
+	bool World::Save_Full(const string& filePath, const Snapshot& snapshot)
+	{
+		auto file = make_unique<FileStream>(filePath, FileStreamMode_Write);
+		if (!file->IsOpen())
+			return false;
+
+		// Save currently loaded resource paths
+		file->Write(snapshot.resourcePaths);
+
+		// 1st - actors and the type and ID of their components
+		file->Section_Begin(_World::sectionActors);
+		file->Write((unsigned int)snapshot.records.size());
+		for (const auto& record : snapshot.records)
+		{
+			file->Write(record.id);
+			file->Write(record.name);
+			file->Write(record.isActive);
+			file->Write(record.hierarchyVisibility);
+			file->Write(record.parent);
+			file->Write((unsigned int)record.components.size());
+			for (const auto& component : record.components)
+			{
+				file->Write(component.first);
+				file->Write(component.second);
+			}
+		}
+
+		// 2nd - component data, in the same order
+		file->Section_Begin(_World::sectionComponentData);
+		for (const auto& component : snapshot.components)
+		{
+			file->Write(component);
+		}
+
+		uint64_t baseSize = file->GetPosition();
+		if (!file->Close())
+		{
+			LOGF_ERROR("World::Save_Full: Failed to write \"%s\"", filePath.c_str());
+			return false;
+		}
+
+		m_saved.baseSize	= baseSize;
+		m_saved.deltaSize	= 0;
+		m_saved.deltaCount	= 0;
+		m_saved.actors.clear();
+		m_saved.components.clear();
+		m_saved.actors.reserve(snapshot.records.size());
+		m_saved.components.reserve(snapshot.components.size());
+		unsigned int componentIndex = 0;
+		for (unsigned int i = 0; i < (unsigned int)snapshot.records.size(); i++)
+		{
+			m_saved.actors[snapshot.records[i].id] = snapshot.recordHashes[i];
+			for (const auto& component : snapshot.records[i].components)
+			{
+				m_saved.components[component.second] = snapshot.componentHashes[componentIndex++];
+			}
+		}
+		return true;
+	}
+
+	bool World::Save_Delta(const string& filePath, const Snapshot& snapshot)
+	{
+		// Actors that are gone, and actors that are new or changed (along with the data of their new or changed components)
+		vector<unsigned int> removed;
+		vector<unsigned int> changed;
+		vector<unsigned int> offsets;
+		unsigned int componentIndex	= 0;
+		size_t savedCount			= 0;
+		for (unsigned int i = 0; i < (unsigned int)snapshot.records.size(); i++)
+		{
+			const ActorRecord& record = snapshot.records[i];
+			offsets.emplace_back(componentIndex);
+
+			auto saved		= m_saved.actors.find(record.id);
+			bool isChanged	= saved == m_saved.actors.end() || saved->second != snapshot.recordHashes[i];
+			savedCount		+= saved != m_saved.actors.end() ? 1 : 0;
+			for (const auto& component : record.components)
+			{
+				auto savedComponent = m_saved.components.find(component.second);
+				isChanged |= savedComponent == m_saved.components.end() || savedComponent->second != snapshot.componentHashes[componentIndex];
+				componentIndex++;
+			}
+
+			if (isChanged)
+			{
+				changed.emplace_back(i);
+			}
+		}
+
+		// IDs are unique, so unless some of the saved actors weren't found above none are gone
+		if (savedCount != m_saved.actors.size())
+		{
+			unordered_set<unsigned int> current;
+			current.reserve(snapshot.records.size());
+			for (const auto& record : snapshot.records)
+			{
+				current.insert(record.id);
+			}
+			for (const auto& saved : m_saved.actors)
+			{
+				if (current.find(saved.first) == current.end())
+				{
+					removed.emplace_back(saved.first);
+				}
+			}
+		}
+
+		if (removed.empty() && changed.empty() && _World::HashPaths(snapshot.resourcePaths) == m_saved.resources)
+		{
+			LOG_INFO("World::Save_Delta: Nothing changed since the last save");
+			return true;
+		}
+
+		auto file = make_unique<FileStream>(filePath, FileStreamMode_Append);
+		if (!file->IsOpen())
+			return false;
+		uint64_t start = file->GetPosition();
+
+		file->Section_Begin(_World::sectionDelta);
+		file->Write(snapshot.resourcePaths);
+		file->Write(removed);
+		file->Write((unsigned int)changed.size());
+		for (unsigned int i : changed)
+		{
+			const ActorRecord& record = snapshot.records[i];
+			file->Write(record.id);
+			file->Write(record.name);
+			file->Write(record.isActive);
+			file->Write(record.hierarchyVisibility);
+			file->Write(record.parent >= 0 ? snapshot.records[record.parent].id : _World::noParent);
+			file->Write((unsigned int)record.components.size());
+			for (unsigned int j = 0; j < (unsigned int)record.components.size(); j++)
+			{
+				const auto& component	= record.components[j];
+				unsigned int index		= offsets[i] + j;
+				auto saved				= m_saved.components.find(component.second);
+				bool isChanged			= saved == m_saved.components.end() || saved->second != snapshot.componentHashes[index];
+
+				file->Write(component.first);
+				file->Write(component.second);
+				file->Write((unsigned int)isChanged);
+				if (isChanged)
+				{
+					file->Write(snapshot.components[index]);
+				}
+			}
+		}
+
+		uint64_t deltaSize = file->GetPosition() - start;
+		if (!file->Close())
+		{
+			LOGF_ERROR("World::Save_Delta: Failed to append to \"%s\"", filePath.c_str());
+			return false;
+		}
+
+		m_saved.deltaSize += deltaSize;
+		m_saved.deltaCount++;
+
+		// Only what was appended changes what the file holds. The components of removed actors are left
+		// behind, they are never looked up again and go with the next full save.
+		for (unsigned int id : removed)
+		{
+			m_saved.actors.erase(id);
+		}
+		for (unsigned int i : changed)
+		{
+			const ActorRecord& record	= snapshot.records[i];
+			m_saved.actors[record.id]	= snapshot.recordHashes[i];
+			for (unsigned int j = 0; j < (unsigned int)record.components.size(); j++)
+			{
+				m_saved.components[record.components[j].second] = snapshot.componentHashes[offsets[i] + j];
+			}
+		}
+		return true;
+	}
+	//===================================================================================================
+
+	//= LOADING =========================================================================================
+	void World::Actors_Read(FileStream* file, vector<ActorRecord>* records)
+	{
+		records->resize(file->ReadUInt());
+		for (auto& record : *records)
+		{
+			file->Read(&record.id);
+			file->Read(&record.name);
+			file->Read(&record.isActive);
+			file->Read(&record.hierarchyVisibility);
+			file->Read(&record.parent);
+			record.components.resize(file->ReadUInt());
+			for (auto& component : record.components)
+			{
+				file->Read(&component.first);
+				file->Read(&component.second);
 			}
+		}
+	}
+
+	void World::Deltas_Read(FileStream* file, vector<string>* resourcePaths, vector<ActorRecord>* records, ComponentData* componentData)
+	{
+		unsigned int deltaCount = file->Section_Count(_World::sectionDelta);
+		if (deltaCount == 0)
+			return;
+
+		// Parents are kept by ID while the deltas are applied, actors that change keep their place
+		vector<ActorRecord> actors;
+		vector<unsigned int> parents;
+		vector<bool> removed;
+		unordered_map<unsigned int, unsigned int> indices;
+		actors.reserve(records->size());
+		parents.reserve(records->size());
+		for (auto& record : *records)
+		{
+			indices[record.id] = (unsigned int)actors.size();
+			parents.emplace_back(record.parent >= 0 ? actors[record.parent].id : _World::noParent);
+			actors.emplace_back(move(record));
+		}
+		removed.resize(actors.size(), false);
+
+		for (unsigned int i = 0; i < deltaCount; i++)
+		{
+			file->Section_Seek(_World::sectionDelta, i);
+			file->Read(resourcePaths);
+
+			vector<unsigned int> removedIDs;
+			file->Read(&removedIDs);
+			for (unsigned int id : removedIDs)
+			{
+				auto it = indices.find(id);
+				if (it != indices.end())
+				{
+					removed[it->second] = true;
+					indices.erase(it);
+				}
+			}
+
+			unsigned int changedCount = file->ReadUInt();
+			for (unsigned int j = 0; j < changedCount; j++)
+			{
+				ActorRecord record;
+				unsigned int parentID = 0;
+				file->Read(&record.id);
+				file->Read(&record.name);
+				file->Read(&record.isActive);
+				file->Read(&record.hierarchyVisibility);
+				file->Read(&parentID);
+				record.parent = -1;
+				record.components.resize(file->ReadUInt());
+				for (auto& component : record.components)
+				{
+					file->Read(&component.first);
+					file->Read(&component.second);
+					if (file->ReadUInt() != 0)
+					{
+						(*componentData)[component.second] = file->ReadSpan<std::byte>();
+					}
+				}
+
+				auto it = indices.find(record.id);
+				if (it != indices.end())
+				{
+					actors[it->second]	= move(record);
+					parents[it->second]	= parentID;
+				}
+				else
+				{
+					indices[record.id] = (unsigned int)actors.size();
+					actors.emplace_back(move(record));
+					parents.emplace_back(parentID);
+					removed.emplace_back(false);
+				}
+			}
+		}
+
+		// Back to parents before their children, with the parents by index
+		vector<vector<unsigned int>> children(actors.size());
+		vector<unsigned int> roots;
+		for (unsigned int i = 0; i < (unsigned int)actors.size(); i++)
+		{
+			if (removed[i])
+				continue;
+
+			auto parent = indices.find(parents[i]);
+			if (parent != indices.end() && parent->second != i)
+			{
+				children[parent->second].emplace_back(i);
+			}
+			else
+			{
+				roots.emplace_back(i);
+			}
+		}
+
+		records->clear();
+		vector<bool> visited(actors.size(), false);
+		vector<pair<unsigned int, int>> stack;
+		auto Visit = [&](unsigned int root)
+		{
+			stack.emplace_back(root, -1);
+			while (!stack.empty())
+			{
+				auto [index, parent] = stack.back();
+				stack.pop_back();
+				if (visited[index])
+					continue;
+				visited[index] = true;
+
+				int recordIndex = (int)records->size();
+				records->emplace_back(move(actors[index]));
+				records->back().parent = parent;
+				for (auto it = children[index].rbegin(); it != children[index].rend(); ++it)
+				{
+					stack.emplace_back(*it, recordIndex);
+				}
+			}
+		};
+		for (unsigned int root : roots)
+		{
+			Visit(root);
+		}
+
+		// Whatever is left is part of a parent cycle, it's broken up rather than lost
+		for (unsigned int i = 0; i < (unsigned int)actors.size(); i++)
+		{
+			if (!removed[i] && !visited[i])
+			{
+				Visit(i);
+			}
+		}
+	}
+
+	void World::Actors_Create(FileStream* file, const vector<ActorRecord>& records, const ComponentData* componentData)
+	{
+		if (!componentData)
+		{
+			file->Section_Seek(_World::sectionComponents);
+		}
+
+		vector<Transform*> transforms(records.size(), nullptr);
+		m_actors.reserve(m_actors.size() + records.size());
+		for (unsigned int i = 0; i < (unsigned int)records.size(); i++)
+		{
+			const ActorRecord& record = records[i];
+			auto actor = Actor_CreateAdd().lock();
+			actor->SetID(record.id);
+			actor->SetName(record.name);
+			actor->SetActive(record.isActive);
+			actor->SetHierarchyVisibility(record.hierarchyVisibility);
+
+			// Create all the components before deserializing any, some depend on each other (e.g. a collider and a rigidbody)
+			for (const auto& component : record.components)
+			{
+				if (auto created = actor->AddComponent((ComponentType)component.first).lock())
+				{
+					created->SetID(component.second);
+				}
+			}
+			for (const auto& component : actor->GetAllComponents())
+			{
+				if (!componentData)
+				{
+					component.second->Deserialize(file);
+					continue;
+				}
+
+				auto data = componentData->find(component.second->GetID());
+				if (data != componentData->end())
+				{
+					FileStream stream(data->second.data, data->second.size);
+					component.second->Deserialize(&stream);
+				}
+			}
+
+			bool hasParent	= record.parent >= 0 && (unsigned int)record.parent < i;
+			transforms[i]	= actor->GetTransform_PtrRaw();
+			transforms[i]->SetParent(hasParent ? transforms[record.parent] : nullptr);
 
 			ProgressReport::Get().IncrementJobsDone(g_progress_Scene);
 		}
+	}
 
-		//= Load actors ============================	
+	void World::Actors_CreateLegacy(FileStream* file)
+	{
 		// 1st - Root actor count
 		int rootactorCount = file->ReadInt();
 
@@ -258,17 +853,96 @@ namespace Directus
 		// deserialize their descendants.
 		for (int i = 0; i < rootactorCount; i++)
 		{
-			m_actors[i]->Deserialize(file.get(), nullptr);
+			m_actors[i]->Deserialize(file, nullptr);
 		}
-		//==============================================
+	}
 
-		m_isDirty = true;
-		m_state = Scene_Idle;
-		ProgressReport::Get().SetIsLoading(g_progress_Scene, false);	
-		LOG_INFO("Scene: Loading took " + to_string((int)timer.GetElapsedTimeMs()) + " ms");	
+	void World::Resources_Load(const vector<string>& resourcePaths)
+	{
+		auto resourceMng	= m_context->GetSubsystem<ResourceManager>();
+		auto threading		= m_context->GetSubsystem<Threading>();
 
-		FIRE_EVENT(EVENT_SCENE_LOADED);
-		return true;
+		atomic<int> jobsDone = 0;
+		auto Load = [resourceMng, &jobsDone](const string& resourcePath)
+		{
+			if (FileSystem::IsEngineTextureFile(resourcePath))
+			{
+				resourceMng->Load<RHI_Texture>(resourcePath);
+			}
+			else if (FileSystem::IsEngineModelFile(resourcePath))
+			{
+				resourceMng->Load<Model>(resourcePath);
+			}
+			else if (FileSystem::IsEngineMaterialFile(resourcePath))
+			{
+				resourceMng->Load<Material>(resourcePath);
+			}
+
+			ProgressReport::Get().SetJobsDone(g_progress_Scene, ++jobsDone);
+		};
+
+		// Textures and models depend on nothing. Materials look their textures up by name, so they wait for the textures.
+		vector<JobHandle> textures;
+		for (const auto& resourcePath : resourcePaths)
+		{
+			if (FileSystem::IsEngineTextureFile(resourcePath))
+			{
+				textures.emplace_back(threading->AddTask([&Load, &resourcePath]() { Load(resourcePath); }));
+			}
+		}
+
+		vector<JobHandle> jobs = textures;
+		for (const auto& resourcePath : resourcePaths)
+		{
+			if (FileSystem::IsEngineTextureFile(resourcePath))
+				continue;
+
+			bool isMaterial = FileSystem::IsEngineMaterialFile(resourcePath);
+			jobs.emplace_back(threading->AddTask([&Load, &resourcePath]() { Load(resourcePath); }, isMaterial ? textures : vector<JobHandle>()));
+		}
+
+		threading->Wait(jobs);
+	}
+
+	bool World::MainThread_Run(function<void()>&& task)
+	{
+		if (this_thread::get_id() == m_mainThreadID)
+		{
+			task();
+			return true;
+		}
+
+		unique_lock<mutex> lock(m_mainThreadMutex);
+		if (m_mainThreadStopping)
+			return false;
+
+		m_mainThreadTasks.emplace_back(move(task));
+		uint64_t ticket = ++m_mainThreadTasksQueued;
+		m_mainThreadCondition.wait(lock, [this, ticket]() { return m_mainThreadTasksDone >= ticket || m_mainThreadStopping; });
+		return m_mainThreadTasksDone >= ticket;
+	}
+
+	void World::MainThread_Flush()
+	{
+		vector<function<void()>> tasks;
+		{
+			lock_guard<mutex> lock(m_mainThreadMutex);
+			if (m_mainThreadTasks.empty())
+				return;
+
+			tasks.swap(m_mainThreadTasks);
+		}
+
+		for (auto& task : tasks)
+		{
+			task();
+		}
+
+		{
+			lock_guard<mutex> lock(m_mainThreadMutex);
+			m_mainThreadTasksDone += tasks.size();
+		}
+		m_mainThreadCondition.notify_all();
 	}
 	//===================================================================================================
 
@@ -316,8 +990,14 @@ namespace Directus
 			Actor_Remove(child->GetActor_PtrWeak());
 		}
 
-		// Keep a reference to it's parent (in case it has one)
-		Transform* parent = actorPtr->GetTransform_PtrRaw()->GetParent();
+		// Detach from the parent (in case it has one)
+		actorPtr->GetTransform_PtrRaw()->BecomeOrphan();
+
+		// Stop culling and picking from reaching it
+		if (Renderable* renderable = actorPtr->GetRenderable_PtrRaw())
+		{
+			renderable->BVH_Remove();
+		}
 
 		// Remove this actor
 		for (auto it = m_actors.begin(); it < m_actors.end();)
@@ -331,12 +1011,6 @@ namespace Directus
 			++it;
 		}
 
-		// If there was a parent, update it
-		if (parent)
-		{
-			parent->AcquireChildren();
-		}
-
 		m_isDirty = true;
 	}
 
@@ -396,6 +1070,7 @@ namespace Directus
 
 		m_renderables.clear();
 		m_renderables.shrink_to_fit();
+		m_renderablesBVH->Clear();
 
 		for (const auto& actor : m_actors)
 		{
@@ -422,8 +1097,17 @@ namespace Directus
 			{
 				m_renderables.emplace_back(actor);
 			}
+
+			// Index renderables spatially
+			if (auto renderablePtr = renderable.lock())
+			{
+				renderablePtr->SetBVHProxy(m_renderablesBVH->Insert(renderablePtr->Geometry_BB(), renderablePtr.get()));
+			}
 		}
 
+		// Everything is known up front, so build an optimal tree instead of keeping the incremental one
+		m_renderablesBVH->Rebuild();
+
 		TIME_BLOCK_END_CPU();
 
 		// Submit to the Renderer
@@ -23,7 +23,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ======================
 #include <vector>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "TransformHierarchy.h"
 #include "../Math/Vector3.h"
+#include "../Math/BoundingVolumeHierarchy.h"
 #include "../Threading/Threading.h"
 //=================================
 
@@ -31,6 +39,8 @@ namespace Directus
 {
 	class Actor;
 	class Light;
+	class FileStream;
+	template <class T> struct FileStreamSpan;
 
 	enum Scene_State
 	{
@@ -53,10 +63,18 @@ namespace Directus
 		void Tick();
 		void Unload();
 
-		//= IO ========================================
+		//= IO ==========================================================================================
+		// Takes a snapshot at the start of a frame and writes it on the calling thread. Saving again to the
+		// same file only appends what changed since, the file is rewritten once the changes pile up.
 		bool SaveToFile(const std::string& filePath);
+		// Reads the file and loads its resources on the calling thread (resources in parallel on the workers),
+		// the world itself is only modified on the main thread, at the start of a frame
 		bool LoadFromFile(const std::string& filePath);
-		//=============================================
+		// Runs a task at the start of the next frame and waits for it, or right away when called from the main thread
+		// (which only ever executes jobs of its own while it waits, see Threading::Wait, so it can't be mid-frame on behalf of somebody else).
+		// Fails if the world goes away before the task gets to run.
+		bool MainThread_Run(std::function<void()>&& task);
+		//===============================================================================================
 
 		//= Actor HELPER FUNCTIONS ===================================================
 		std::weak_ptr<Actor> Actor_CreateAdd();
@@ -76,11 +94,58 @@ namespace Directus
 		std::weak_ptr<Actor> GetMainCamera()						{ return m_mainCamera; }
 		void SetAmbientLight(float x, float y, float z);
 		Math::Vector3 GetAmbientLight();
+		TransformHierarchy* GetTransformHierarchy()					{ return m_transformHierarchy.get(); }
+		// Spatial index over the world AABBs of all renderables, the user data is the Renderable*
+		Math::BoundingVolumeHierarchy* GetRenderablesBVH()			{ return m_renderablesBVH.get(); }
 		//===================================================================================
 
 	private:
 		void Resolve();
 
+		// An actor as it is stored in the file, parents come before their children
+		struct ActorRecord
+		{
+			unsigned int id;
+			std::string name;
+			bool isActive;
+			bool hierarchyVisibility;
+			int parent; // Index into the records, -1 for root actors
+			std::vector<std::pair<unsigned int, unsigned int>> components; // Type and ID
+
+			// Identifies the content of the record, the parent by ID since indices shift as actors come and go
+			uint64_t GetHash(unsigned int parentID) const;
+		};
+		// The serialized data of each component, by component ID
+		typedef std::unordered_map<unsigned int, FileStreamSpan<std::byte>> ComponentData;
+
+		//= SAVING =================================================================================================
+		// Everything a save needs, copied out of the world so that it can be written while the world keeps ticking
+		struct Snapshot
+		{
+			std::vector<std::string> resourcePaths;
+			std::vector<ActorRecord> records;
+			std::vector<std::vector<std::byte>> data;					// Serialized components, in a few large buffers
+			std::vector<FileStreamSpan<std::byte>> components;		// Into the above, in the order of the records
+			std::vector<uint64_t> recordHashes;
+			std::vector<uint64_t> componentHashes;
+		};
+		void Save_Snapshot(Snapshot* snapshot);
+		bool Save_Full(const std::string& filePath, const Snapshot& snapshot);
+		bool Save_Delta(const std::string& filePath, const Snapshot& snapshot);
+		//==========================================================================================================
+
+		//= LOADING ================================================================================================
+		void Actors_Read(FileStream* file, std::vector<ActorRecord>* records);
+		// Applies the changes appended by incremental saves to the records read from the start of the file
+		void Deltas_Read(FileStream* file, std::vector<std::string>* resourcePaths, std::vector<ActorRecord>* records, ComponentData* componentData);
+		// Without component data, the components are read in order from the file
+		void Actors_Create(FileStream* file, const std::vector<ActorRecord>& records, const ComponentData* componentData);
+		void Actors_CreateLegacy(FileStream* file);
+		void Resources_Load(const std::vector<std::string>& resourcePaths);
+
+		void MainThread_Flush();
+		//==========================================================================================================
+
 		//= COMMON ACTOR CREATION ====================
 		std::weak_ptr<Actor> CreateSkybox();
 		std::weak_ptr<Actor> CreateCamera();
@@ -89,6 +154,8 @@ namespace Directus
 
 		std::vector<std::shared_ptr<Actor>> m_actors;
 		std::vector<std::weak_ptr<Actor>> m_renderables;
+		std::unique_ptr<TransformHierarchy> m_transformHierarchy;
+		std::unique_ptr<Math::BoundingVolumeHierarchy> m_renderablesBVH;
 
 		std::weak_ptr<Actor> m_mainCamera;
 		std::weak_ptr<Actor> m_skybox;
@@ -96,5 +163,28 @@ namespace Directus
 		bool m_wasInEditorMode;
 		bool m_isDirty;
 		Scene_State m_state;
+
+		// Tasks that other threads need to run on the main thread
+		std::thread::id m_mainThreadID;
+		std::vector<std::function<void()>> m_mainThreadTasks;
+		uint64_t m_mainThreadTasksQueued	= 0;
+		uint64_t m_mainThreadTasksDone		= 0;
+		bool m_mainThreadStopping			= false;
+		std::mutex m_mainThreadMutex;
+		std::condition_variable m_mainThreadCondition;
+
+		// What the file that was last saved (or loaded) contains, so the next save can append just the changes
+		struct SaveState
+		{
+			std::string filePath;
+			std::unordered_map<unsigned int, uint64_t> actors;		// Actor ID -> hash of its record
+			std::unordered_map<unsigned int, uint64_t> components;	// Component ID -> hash of its data
+			uint64_t resources		= 0;
+			uint64_t baseSize		= 0;
+			uint64_t deltaSize		= 0;
+			unsigned int deltaCount	= 0;
+		};
+		SaveState m_saved;
+		std::mutex m_saveMutex;
 	};
 }
\ No newline at end of file
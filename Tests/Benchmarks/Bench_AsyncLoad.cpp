@@ -0,0 +1,257 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "Benchmark.h"
+#include <thread>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/Hash.h"
+#include "Core/Settings.h"
+#include "Core/EventSystem.h"
+#include "IO/FileStream.h"
+#include "IO/Compression.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "Resource/ResourceManager.h"
+//===================================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+//========================
+
+// ResourceManager.cpp is linked as it is, but the importers it creates need FreeImage, Assimp and FreeType.
+// The benchmark loads its own resource type, so these stand in for them.
+namespace Directus
+{
+	ImageImporter::ImageImporter(Context* context) { m_context = context; }
+	ImageImporter::~ImageImporter() {}
+	ModelImporter::ModelImporter(Context* context) { m_context = context; }
+	FontImporter::FontImporter(Context* context) { m_context = context; }
+	FontImporter::~FontImporter() {}
+	void FontImporter::Initialize() {}
+}
+
+namespace _Bench_AsyncLoad
+{
+	const char* g_assetDirectory = "Bench_AsyncLoad_Assets/";
+
+	// A texture sized asset, LZ4 compressed on disk. Loading it reads the file, decompresses it and hashes the result,
+	// which stands for the decoding and the validation a real importer does.
+	class Asset : public IResource
+	{
+	public:
+		Asset(Context* context) : IResource(context, Resource_Unknown) {}
+
+		bool LoadFromFile(const string& filePath) override
+		{
+			auto file = make_unique<FileStream>(filePath, FileStreamMode_Read);
+			if (!file->IsOpen())
+				return false;
+
+			unsigned int size = file->ReadUInt();
+			vector<std::byte> compressed;
+			file->Read(&compressed);
+
+			m_data.resize(size);
+			if (!Compression::LZ4_Decompress(compressed.data(), compressed.size(), m_data.data(), m_data.size()))
+				return false;
+
+			m_hash = Hash::Compute(m_data.data(), m_data.size());
+			return true;
+		}
+
+		unsigned int GetMemoryUsage() override { return (unsigned int)m_data.size(); }
+		uint64_t GetHash() { return m_hash; }
+
+	private:
+		vector<std::byte> m_data;
+		uint64_t m_hash = 0;
+	};
+}
+
+namespace Directus
+{
+	template<> Resource_Type IResource::DeduceResourceType<_Bench_AsyncLoad::Asset>() { return Resource_Unknown; }
+}
+
+namespace _Bench_AsyncLoad
+{
+	string AssetPath(unsigned int index) { return g_assetDirectory + to_string(index) + ".asset"; }
+
+	// Smooth gradients with some noise, compresses to about the same ratio as the textures of a typical project
+	void WriteAssets(unsigned int count, unsigned int size)
+	{
+		FileSystem::CreateDirectory_(g_assetDirectory);
+
+		vector<std::byte> data(size);
+		vector<std::byte> compressed(Compression::LZ4_CompressBound(size));
+		uint32_t random = 1;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			for (unsigned int j = 0; j < size; j++)
+			{
+				random	= random * 1664525u + 1013904223u;
+				data[j]	= (std::byte)(((j / 4 + i) & 0xFF) + ((random >> 29) & 3));
+			}
+			compressed.resize(Compression::LZ4_CompressBound(size));
+			compressed.resize(Compression::LZ4_Compress(data.data(), size, compressed.data(), compressed.size()));
+
+			auto file = make_unique<FileStream>(AssetPath(i), FileStreamMode_Write);
+			file->Write(size);
+			file->Write(compressed);
+		}
+	}
+
+	struct Result
+	{
+		double total		= 0.0;
+		// Time the main thread spent inside the resource manager, and the longest single call
+		double mainThread	= 0.0;
+		double longestStall	= 0.0;
+		uint64_t hash		= 0;
+	};
+
+	// A context with the subsystems the resource manager needs, with a number of worker threads
+	class Engine
+	{
+	public:
+		Engine(unsigned int workers)
+		{
+			Settings::Get().ThreadCountMax_Set(workers + 1);
+			m_context	= make_unique<Context>();
+			m_threading	= make_unique<Threading>(m_context.get());
+			// The context deletes its subsystems except for the first one (normally the engine)
+			m_context->RegisterSubsystem(m_threading.get());
+			m_threading->Initialize();
+
+			m_resourceManager = new ResourceManager(m_context.get());
+			m_context->RegisterSubsystem(m_resourceManager);
+			m_resourceManager->Initialize();
+			m_resourceManager->LoadAsync_SetMaxConcurrency(workers);
+		}
+
+		~Engine()
+		{
+			// The resource manager waits for its loads, so it goes before the threads
+			m_context.reset();
+			m_threading.reset();
+			// It also subscribed to the engine's events
+			EventSystem::Get().Clear();
+		}
+
+		ResourceManager* GetResourceManager() { return m_resourceManager; }
+
+	private:
+		unique_ptr<Context> m_context;
+		unique_ptr<Threading> m_threading;
+		ResourceManager* m_resourceManager;
+	};
+
+	Result LoadSync(unsigned int count)
+	{
+		Engine engine(1);
+		auto resourceManager = engine.GetResourceManager();
+
+		Result result;
+		result.total = Benchmark::Time([&]
+		{
+			for (unsigned int i = 0; i < count; i++)
+			{
+				auto asset	= resourceManager->Load<Asset>(AssetPath(i)).lock();
+				result.hash	^= asset ? asset->GetHash() : 0;
+			}
+		});
+		result.mainThread	= result.total;
+		result.longestStall	= result.total;
+		return result;
+	}
+
+	// Requests everything in one frame, then runs frames (a millisecond apart) until every completion callback came in
+	Result LoadAsync(unsigned int count, unsigned int workers)
+	{
+		Engine engine(workers);
+		auto resourceManager = engine.GetResourceManager();
+
+		Result result;
+		unsigned int completed = 0;
+		result.total = Benchmark::Time([&]
+		{
+			result.mainThread = Benchmark::Time([&]
+			{
+				for (unsigned int i = 0; i < count; i++)
+				{
+					resourceManager->LoadAsync<Asset>(AssetPath(i), 0, [&](weak_ptr<Asset> asset, LoadState state)
+					{
+						auto loaded	= asset.lock();
+						result.hash	^= (loaded && state == LoadState_Completed) ? loaded->GetHash() : 0;
+						completed++;
+					});
+				}
+			});
+			result.longestStall = result.mainThread;
+
+			while (completed != count)
+			{
+				this_thread::sleep_for(chrono::milliseconds(1));
+				double frame		= Benchmark::Time([] { FIRE_EVENT(EVENT_FRAME_START); });
+				result.mainThread	+= frame;
+				result.longestStall	= frame > result.longestStall ? frame : result.longestStall;
+			}
+		});
+		return result;
+	}
+}
+
+// Loads the same assets synchronously and through ResourceManager::LoadAsync() with 1 to 8 loading workers.
+// Synchronous loads block the main thread for as long as they take, asynchronous ones only for the requests
+// and for the completion callbacks, which run at the start of each frame.
+//
+//   Bench_AsyncLoad [assets = 2000] [asset size in KB = 256] [max workers = 8]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_AsyncLoad;
+
+	unsigned int count		= Benchmark::Argument(argc, argv, 1, 2000);
+	unsigned int size		= Benchmark::Argument(argc, argv, 2, 256) * 1024;
+	unsigned int maxWorkers	= Benchmark::Argument(argc, argv, 3, 8);
+
+	WriteAssets(count, size);
+	printf("%u assets of %u KB, %u hardware threads\n\n", count, size / 1024, thread::hardware_concurrency());
+	printf("mode  | workers | total ms | main thread ms | longest stall ms |\n");
+
+	Result sync = LoadSync(count);
+	printf("sync  | %7u | %8.1f | %14.1f | %16.1f |\n", 1, sync.total, sync.mainThread, sync.longestStall);
+
+	bool same = true;
+	for (unsigned int workers = 1; workers <= maxWorkers; workers *= 2)
+	{
+		Result async	= LoadAsync(count, workers);
+		same			= same && async.hash == sync.hash;
+		printf("async | %7u | %8.1f | %14.1f | %16.1f |\n", workers, async.total, async.mainThread, async.longestStall);
+	}
+	printf("\nAsynchronous loads returned the same data: %s\n", same ? "yes" : "no");
+
+	FileSystem::DeleteDirectory(g_assetDirectory);
+
+	return same ? 0 : 1;
+}
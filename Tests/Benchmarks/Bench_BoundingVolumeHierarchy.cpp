@@ -0,0 +1,198 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ============================
+#include "Benchmark.h"
+#include <random>
+#include <vector>
+#include "Math/BoundingVolumeHierarchy.h"
+#include "Math/Frustum.h"
+#include "Math/Ray.h"
+#include "Math/Matrix.h"
+//=======================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//=============================
+
+namespace _Bench_BoundingVolumeHierarchy
+{
+	// Boxes keep the same density at every count, so a view and a pick see a similar neighbourhood
+	struct Scene
+	{
+		Scene(unsigned int count, unsigned int seed)
+		{
+			size = 4.0f * cbrtf((float)count);
+			mt19937 random(seed);
+			uniform_real_distribution<float> position(-size, size);
+			uniform_real_distribution<float> extent(0.1f, 1.0f);
+			boxes.reserve(count);
+			for (unsigned int i = 0; i < count; i++)
+			{
+				Vector3 center(position(random), position(random), position(random));
+				Vector3 extents(extent(random), extent(random), extent(random));
+				boxes.emplace_back(center - extents, center + extents);
+			}
+		}
+
+		vector<BoundingBox> boxes;
+		float size;
+	};
+
+	// Cameras and rays from random points in the scene, looking a quarter of it deep
+	struct Views
+	{
+		Views(const Scene& scene, unsigned int count, unsigned int seed)
+		{
+			mt19937 random(seed);
+			uniform_real_distribution<float> position(-scene.size, scene.size);
+			float depth		= scene.size * 0.5f;
+			Matrix proj		= Matrix::CreatePerspectiveFieldOfViewLH(1.0f, 16.0f / 9.0f, 0.3f, depth);
+			for (unsigned int i = 0; i < count; i++)
+			{
+				Vector3 eye(position(random), position(random), position(random));
+				Vector3 target(position(random), position(random), position(random));
+				Frustum frustum;
+				frustum.Construct(Matrix::CreateLookAtLH(eye, target, Vector3::Up), proj, depth);
+				frustums.emplace_back(frustum);
+				rays.emplace_back(eye, target);
+			}
+		}
+
+		vector<Frustum> frustums;
+		vector<Ray> rays;
+	};
+
+	void* Pick_Linear(const vector<BoundingBox>& boxes, const Ray& ray)
+	{
+		float closest	= INFINITY;
+		void* hit		= nullptr;
+		for (unsigned int i = 0; i < (unsigned int)boxes.size(); i++)
+		{
+			float distance = ray.HitDistance(boxes[i]);
+			if (distance == 0.0f || distance == INFINITY || distance >= closest)
+				continue;
+
+			closest	= distance;
+			hit		= (void*)(uintptr_t)(i + 1);
+		}
+		return hit;
+	}
+
+	unsigned int Cull_Linear(const vector<BoundingBox>& boxes, const Frustum& frustum)
+	{
+		unsigned int visible = 0;
+		for (const auto& box : boxes)
+		{
+			visible += frustum.CheckCube(box.GetCenter(), box.GetExtents()) != Outside ? 1 : 0;
+		}
+		return visible;
+	}
+}
+
+// Picking (Camera::Pick) and frustum culling (Renderer::Renderables_Cull) through the world's bounding volume hierarchy,
+// against the linear pass over every renderable they replaced, from 1k to 1M boxes. Also reports the cost of building
+// the tree both ways and of moving 1% of the boxes per frame. Mismatches count queries whose result differs from the
+// linear pass, they should be 0.
+//
+//   Bench_BoundingVolumeHierarchy [max boxes = 1000000] [views = 64]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_BoundingVolumeHierarchy;
+
+	unsigned int maxBoxes	= Benchmark::Argument(argc, argv, 1, 1000000);
+	unsigned int viewCount	= Benchmark::Argument(argc, argv, 2, 64);
+
+	printf("%9s | %11s %11s %11s | %11s %11s | %11s %11s %9s | %10s\n", "boxes", "insert ms", "rebuild ms", "move 1% ms", "pick lin ms", "pick bvh ms", "cull lin ms", "cull bvh ms", "visible", "mismatches");
+	for (unsigned int count = 1000; count <= maxBoxes; count *= 10)
+	{
+		Scene scene(count, count);
+		Views views(scene, viewCount, count + 1);
+
+		BoundingVolumeHierarchy bvh;
+		vector<unsigned int> ids(count);
+		double insert = Benchmark::Time([&]
+		{
+			for (unsigned int i = 0; i < count; i++)
+			{
+				ids[i] = bvh.Insert(scene.boxes[i], (void*)(uintptr_t)(i + 1));
+			}
+		});
+		double rebuild = Benchmark::Time([&] { bvh.Rebuild(); });
+
+		// Picking
+		unsigned int mismatches = 0;
+		vector<void*> picksLinear(viewCount);
+		vector<void*> picksBVH(viewCount);
+		double pickLinear	= Benchmark::Time([&] { for (unsigned int i = 0; i < viewCount; i++) picksLinear[i] = Pick_Linear(scene.boxes, views.rays[i]); }) / viewCount;
+		double pickBVH		= Benchmark::Time([&] { for (unsigned int i = 0; i < viewCount; i++) picksBVH[i] = bvh.RayCast(views.rays[i]); }) / viewCount;
+		for (unsigned int i = 0; i < viewCount; i++)
+		{
+			// Equal distances can resolve to either box
+			if (picksLinear[i] != picksBVH[i] && (!picksLinear[i] || !picksBVH[i] ||
+				views.rays[i].HitDistance(scene.boxes[(uintptr_t)picksLinear[i] - 1]) != views.rays[i].HitDistance(scene.boxes[(uintptr_t)picksBVH[i] - 1])))
+			{
+				mismatches++;
+			}
+		}
+
+		// Culling
+		vector<unsigned int> visibleLinear(viewCount);
+		vector<unsigned int> visibleBVH(viewCount);
+		vector<void*> results;
+		double cullLinear	= Benchmark::Time([&] { for (unsigned int i = 0; i < viewCount; i++) visibleLinear[i] = Cull_Linear(scene.boxes, views.frustums[i]); }) / viewCount;
+		double cullBVH		= Benchmark::Time([&]
+		{
+			for (unsigned int i = 0; i < viewCount; i++)
+			{
+				results.clear();
+				bvh.Query(views.frustums[i], results);
+				visibleBVH[i] = (unsigned int)results.size();
+			}
+		}) / viewCount;
+		unsigned long long visible = 0;
+		for (unsigned int i = 0; i < viewCount; i++)
+		{
+			mismatches	+= visibleLinear[i] != visibleBVH[i] ? 1 : 0;
+			visible		+= visibleBVH[i];
+		}
+
+		// A frame in which 1% of the boxes move by up to a unit
+		mt19937 random(count + 2);
+		uniform_real_distribution<float> offset(-1.0f, 1.0f);
+		double move = Benchmark::Time([&]
+		{
+			for (unsigned int i = 0; i < count; i += 100)
+			{
+				Vector3 delta(offset(random), offset(random), offset(random));
+				scene.boxes[i] = BoundingBox(scene.boxes[i].GetMin() + delta, scene.boxes[i].GetMax() + delta);
+				bvh.Update(ids[i], scene.boxes[i]);
+			}
+		});
+
+		printf("%9u | %11.2f %11.2f %11.3f | %11.4f %11.4f | %11.4f %11.4f %9llu | %10u\n", count, insert, rebuild, move, pickLinear, pickBVH, cullLinear, cullBVH, visible / viewCount, mismatches);
+	}
+
+	return 0;
+}
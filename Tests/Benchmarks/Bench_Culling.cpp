@@ -0,0 +1,129 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ================
+#include "Benchmark.h"
+#include <vector>
+#include <random>
+#include "Math/Frustum.h"
+#include "Math/BoundingBox.h"
+//===========================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//========================
+
+namespace _Bench_Culling
+{
+	// Boxes scattered around a camera that sees a few percent of them
+	struct Boxes
+	{
+		vector<BoundingBox> local;
+		vector<Matrix> transforms;
+		vector<float> centerX, centerY, centerZ, extentX, extentY, extentZ;
+
+		explicit Boxes(unsigned int count)
+		{
+			mt19937 random(3);
+			uniform_real_distribution<float> position(-150.0f, 150.0f);
+			uniform_real_distribution<float> size(0.1f, 5.0f);
+			for (unsigned int i = 0; i < count; i++)
+			{
+				Vector3 extent(size(random), size(random), size(random));
+				local.emplace_back(extent * -1.0f, extent);
+				transforms.emplace_back(Matrix::CreateTranslation(Vector3(position(random), position(random), position(random))));
+
+				BoundingBox world = local.back().Transformed(transforms.back());
+				Vector3 center	= world.GetCenter();
+				Vector3 extents	= world.GetExtents();
+				centerX.emplace_back(center.x); centerY.emplace_back(center.y); centerZ.emplace_back(center.z);
+				extentX.emplace_back(extents.x); extentY.emplace_back(extents.y); extentZ.emplace_back(extents.z);
+			}
+		}
+	};
+}
+
+// Culling 1M boxes against a frustum once per frame. "transform + CheckCube" is what the renderer did before the world
+// boxes were cached (Geometry_BB transformed the local box on every call), "CheckCube" tests the cached boxes one at a
+// time and "CheckCubes" tests them in batches, 8 at a time in Bench_Culling_AVX and 4 at a time otherwise.
+// Visible counts have to match.
+//
+//   Bench_Culling [boxes = 1000000]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_Culling;
+
+	unsigned int count = Benchmark::Argument(argc, argv, 1, 1000000);
+	Boxes boxes(count);
+
+	Frustum frustum;
+	frustum.Construct(Matrix::CreateLookAtLH(Vector3(0, 0, -5), Vector3::Zero, Vector3::Up), Matrix::CreatePerspectiveFieldOfViewLH(1.0f, 16.0f / 9.0f, 0.3f, 100.0f), 100.0f);
+
+	unsigned int visible = 0;
+	auto Report = [&](const char* name, double ms)
+	{
+		printf("%22s | %10.2f %10.2f | %8u\n", name, ms, ms * 1000000.0 / count, visible);
+	};
+
+	printf("%u boxes\n", count);
+	printf("%22s | %10s %10s | %8s\n", "", "ms", "ns/box", "visible");
+
+	double time = Benchmark::Best(5, [&]
+	{
+		visible = 0;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			BoundingBox world = boxes.local[i].Transformed(boxes.transforms[i]);
+			visible += frustum.CheckCube(world.GetCenter(), world.GetExtents()) != Outside ? 1 : 0;
+		}
+	});
+	Report("transform + CheckCube", time);
+
+	time = Benchmark::Best(5, [&]
+	{
+		visible = 0;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			Vector3 center(boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i]);
+			Vector3 extent(boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i]);
+			visible += frustum.CheckCube(center, extent) != Outside ? 1 : 0;
+		}
+	});
+	Report("CheckCube", time);
+
+	vector<uint32_t> visibility((count + 31) / 32);
+	time = Benchmark::Best(5, [&]
+	{
+		frustum.CheckCubes(boxes.centerX.data(), boxes.centerY.data(), boxes.centerZ.data(), boxes.extentX.data(), boxes.extentY.data(), boxes.extentZ.data(), count, visibility.data());
+	});
+	visible = 0;
+	for (uint32_t word : visibility)
+	{
+		for (; word != 0; word &= word - 1)
+		{
+			visible++;
+		}
+	}
+	Report("CheckCubes", time);
+
+	return 0;
+}
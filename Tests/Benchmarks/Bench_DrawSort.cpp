@@ -0,0 +1,205 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==================
+#include "Benchmark.h"
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "Resource/IResource.h"
+#include "Math/Vector3.h"
+//=============================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//============================
+
+namespace _Bench_DrawSort
+{
+	class Asset : public IResource
+	{
+	public:
+		Asset(Resource_Type type) : IResource(nullptr, type) {}
+	};
+
+	// What the renderer reads from an actor to build its key
+	struct Item
+	{
+		Asset* shader;
+		Asset* material;
+		Asset* model;
+		Vector3 center;
+	};
+
+	struct DrawItem
+	{
+		uint64_t key;
+		const Item* item;
+	};
+
+	// | pass: 3 | culled: 1 | depth: 12 | shader: 16 | material: 16 | model: 16 |, as Renderer::Renderables_Sort() builds it
+	template <typename Index>
+	void Keys_Compute(const vector<Item>& items, vector<DrawItem>& drawItems, Index&& index)
+	{
+		drawItems.resize(items.size());
+		for (unsigned int i = 0; i < (unsigned int)items.size(); i++)
+		{
+			const Item& item	= items[i];
+			uint64_t depth		= (uint64_t)min(item.center.Length() * 4095.0f / 1000.0f, 4095.0f);
+			drawItems[i].item	= &item;
+			drawItems[i].key	= (depth << 48u) | (index(0, item.shader) << 32u) | (index(1, item.material) << 16u) | index(2, item.model);
+		}
+	}
+
+	// The renderer's sort, LSD radix, one byte per pass, skipping bytes that are the same for every key
+	void Keys_Sort(vector<DrawItem>& drawItems, vector<DrawItem>& scratch)
+	{
+		scratch.resize(drawItems.size());
+		DrawItem* src		= drawItems.data();
+		DrawItem* dst		= scratch.data();
+		unsigned int count	= (unsigned int)drawItems.size();
+		for (unsigned int shift = 0; shift < 64; shift += 8)
+		{
+			unsigned int offsets[256] = { 0 };
+			for (unsigned int i = 0; i < count; i++)
+			{
+				offsets[(src[i].key >> shift) & 0xFF]++;
+			}
+
+			if (offsets[(src[0].key >> shift) & 0xFF] == count)
+				continue;
+
+			unsigned int sum = 0;
+			for (auto& offset : offsets)
+			{
+				unsigned int bucketCount = offset;
+				offset = sum;
+				sum += bucketCount;
+			}
+
+			for (unsigned int i = 0; i < count; i++)
+			{
+				dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+			}
+			swap(src, dst);
+		}
+
+		if (src != drawItems.data())
+		{
+			drawItems.swap(scratch);
+		}
+	}
+
+	// Material changes between consecutive draws
+	unsigned int Switches_Count(const vector<DrawItem>& drawItems)
+	{
+		unsigned int switches = 0;
+		for (unsigned int i = 1; i < (unsigned int)drawItems.size(); i++)
+		{
+			switches += drawItems[i].item->material != drawItems[i - 1].item->material ? 1 : 0;
+		}
+		return switches;
+	}
+}
+
+// Sorting the draw list with the keys built from each resource's index (cached on the resource), from resource IDs
+// mapped to dense indices on every sort (a hash map lookup per field and item), and with the comparator the radix
+// sort replaced (keys from the IDs, rebuilt on every comparison).
+//
+//   Bench_DrawSort [max items = 500000] [runs = 5]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_DrawSort;
+
+	unsigned int maxItems	= Benchmark::Argument(argc, argv, 1, 500000);
+	unsigned int runs		= Benchmark::Argument(argc, argv, 2, 5);
+
+	printf("%9s | %9s %9s %9s | %12s %12s %12s | %10s %10s\n", "items", "shaders", "materials", "models", "index ms", "id map ms", "compare ms", "switches", "id map sw");
+	for (unsigned int count : { 10000u, 50000u, 100000u, 500000u })
+	{
+		if (count > maxItems)
+			break;
+
+		// A few shaders, a material per 8 items and a model per 16, placed at random within 1000 units of the camera
+		vector<unique_ptr<Asset>> shaders, materials, models;
+		for (unsigned int i = 0; i < 16; i++)			shaders.emplace_back(make_unique<Asset>(Resource_Shader));
+		for (unsigned int i = 0; i < count / 8; i++)	materials.emplace_back(make_unique<Asset>(Resource_Material));
+		for (unsigned int i = 0; i < count / 16; i++)	models.emplace_back(make_unique<Asset>(Resource_Model));
+
+		mt19937 random(count);
+		uniform_real_distribution<float> position(-577.0f, 577.0f);
+		vector<Item> items(count);
+		for (auto& item : items)
+		{
+			Asset* material	= materials[random() % materials.size()].get();
+			item.shader		= shaders[material->Resource_GetIndex() % shaders.size()].get();
+			item.material	= material;
+			item.model		= models[random() % models.size()].get();
+			item.center		= Vector3(position(random), position(random), position(random));
+		}
+
+		vector<DrawItem> drawItems, scratch;
+		double index = Benchmark::Best(runs, [&]
+		{
+			Keys_Compute(items, drawItems, [](int, Asset* resource) { return (uint64_t)min(resource->Resource_GetIndex(), 0xFFFFu); });
+			Keys_Sort(drawItems, scratch);
+		});
+		unsigned int switches = Switches_Count(drawItems);
+
+		unordered_map<unsigned int, uint64_t> indices[3];
+		double idMap = Benchmark::Best(runs, [&]
+		{
+			for (auto& map : indices)
+			{
+				map.clear();
+			}
+			Keys_Compute(items, drawItems, [&indices](int field, Asset* resource)
+			{
+				uint64_t dense = indices[field].emplace(resource->Resource_GetID(), (uint64_t)indices[field].size()).first->second;
+				return dense < 0xFFFF ? dense : 0xFFFF;
+			});
+			Keys_Sort(drawItems, scratch);
+		});
+		unsigned int idMapSwitches = Switches_Count(drawItems);
+
+		vector<const Item*> sorted(count);
+		double compare = Benchmark::Best(runs, [&]
+		{
+			for (unsigned int i = 0; i < count; i++)
+			{
+				sorted[i] = &items[i];
+			}
+			sort(sorted.begin(), sorted.end(), [](const Item* a, const Item* b)
+			{
+				uint64_t keyA = ((uint64_t)a->model->Resource_GetID() << 48u) | ((uint64_t)a->shader->Resource_GetID() << 32u) | ((uint64_t)a->material->Resource_GetID() << 16u);
+				uint64_t keyB = ((uint64_t)b->model->Resource_GetID() << 48u) | ((uint64_t)b->shader->Resource_GetID() << 32u) | ((uint64_t)b->material->Resource_GetID() << 16u);
+				return keyA < keyB;
+			});
+		});
+
+		printf("%9u | %9u %9u %9u | %12.2f %12.2f %12.2f | %10u %10u\n", count, (unsigned int)shaders.size(), (unsigned int)materials.size(), (unsigned int)models.size(), index, idMap, compare, switches, idMapSwitches);
+	}
+
+	return 0;
+}
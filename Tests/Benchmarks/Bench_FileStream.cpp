@@ -0,0 +1,262 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES =====================
+#include "Benchmark.h"
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include "Core/Hash.h"
+#include "IO/FileStream.h"
+#include "RHI/RHI_Vertex.h"
+#include "FileSystem/FileSystem.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace _Bench_FileStream
+{
+	const char* g_fileOld = "Bench_FileStream_Old.model";
+	const char* g_fileNew = "Bench_FileStream_New.model";
+
+	// The stream FileStream replaced, std::ifstream/std::ofstream value by value and vectors cleared, shrunk,
+	// reserved and resized before every read. Only what a model needs.
+	class OldFileStream
+	{
+	public:
+		OldFileStream(const string& path, FileStreamMode mode)
+		{
+			if (mode == FileStreamMode_Write)
+			{
+				out.open(path, ios::out | ios::binary);
+			}
+			else
+			{
+				in.open(path, ios::in | ios::binary);
+			}
+		}
+
+		void Write(unsigned int value)	{ out.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+		void Write(float value)			{ out.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+		void Write(const string& value)
+		{
+			Write((unsigned int)value.length());
+			out.write(value.c_str(), value.length());
+		}
+		template <class T>
+		void Write(const vector<T>& value)
+		{
+			Write((unsigned int)value.size());
+			out.write(reinterpret_cast<const char*>(value.data()), sizeof(T) * value.size());
+		}
+
+		void Read(unsigned int* value)	{ in.read(reinterpret_cast<char*>(value), sizeof(*value)); }
+		void Read(float* value)			{ in.read(reinterpret_cast<char*>(value), sizeof(*value)); }
+		void Read(string* value)
+		{
+			unsigned int length = 0;
+			Read(&length);
+			value->resize(length);
+			in.read(value->data(), length);
+		}
+		template <class T>
+		void Read(vector<T>* value)
+		{
+			value->clear();
+			value->shrink_to_fit();
+			unsigned int length = 0;
+			Read(&length);
+			value->reserve(length);
+			value->resize(length);
+			in.read(reinterpret_cast<char*>(value->data()), sizeof(T) * length);
+		}
+
+	private:
+		ifstream in;
+		ofstream out;
+	};
+
+	uint64_t Model_Hash(const string& name, const string& path, float scale, const unsigned int* indices, size_t indexCount, const RHI_Vertex_PosUVTBN* vertices, size_t vertexCount)
+	{
+		Hash hash;
+		hash.Update(name.data(), name.size());
+		hash.Update(path.data(), path.size());
+		hash.Update(&scale, sizeof(scale));
+		hash.Update(indices, indexCount * sizeof(unsigned int));
+		hash.Update(vertices, vertexCount * sizeof(RHI_Vertex_PosUVTBN));
+		return hash.Digest();
+	}
+
+	// What a model file holds, a name, a path, a scale and its geometry
+	struct Model
+	{
+		string name;
+		string path;
+		float scale = 0.0f;
+		vector<unsigned int> indices;
+		vector<RHI_Vertex_PosUVTBN> vertices;
+
+		// The written model is freed before loading, so that it doesn't count towards peak memory, its hash stays
+		uint64_t GetHash() const { return Model_Hash(name, path, scale, indices.data(), indices.size(), vertices.data(), vertices.size()); }
+	};
+
+	template <class Stream>
+	void Model_Write(Stream& stream, const Model& model)
+	{
+		stream.Write(model.name);
+		stream.Write(model.path);
+		stream.Write(model.scale);
+		stream.Write(model.indices);
+		stream.Write(model.vertices);
+	}
+
+	template <class Stream>
+	void Model_Read(Stream& stream, Model* model)
+	{
+		stream.Read(&model->name);
+		stream.Read(&model->path);
+		stream.Read(&model->scale);
+		stream.Read(&model->indices);
+		stream.Read(&model->vertices);
+	}
+
+	// Read system calls and the peak resident set size of this process, where the system reports them (Linux)
+	long Process_ReadCalls()
+	{
+		ifstream file("/proc/self/io");
+		string key;
+		long value = 0;
+		while (file >> key >> value)
+		{
+			if (key == "syscr:")
+				return value;
+		}
+		return -1;
+	}
+
+	long Process_PeakMemoryMB()
+	{
+		ifstream file("/proc/self/status");
+		string key;
+		while (file >> key)
+		{
+			long value = 0;
+			if (key == "VmHWM:" && file >> value)
+				return value / 1024;
+		}
+		return -1;
+	}
+
+	void Process_PeakMemoryReset()
+	{
+		ofstream("/proc/self/clear_refs") << "5";
+	}
+}
+
+// Loading a 500 MB .model (a fifth of it indices, the rest vertices) with the old std::ifstream stream and with the
+// memory mapped FileStream, which also reads files written by the old one (unverified, they have no hashes). ReadSpan
+// points into the mapping instead of copying. The page cache is warm, each file was just written. Every run hashes what
+// it loaded (in its time) to compare it with what was written. Read calls and peak memory are only reported on Linux
+// (-1 elsewhere), the peak is reset before each run.
+//
+//   Bench_FileStream [MB = 500]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_FileStream;
+
+	size_t bytes = (size_t)Benchmark::Argument(argc, argv, 1, 500) * 1024 * 1024;
+
+	Model model;
+	model.name	= "Sponza";
+	model.path	= "Assets/Sponza.model";
+	model.scale	= 1.0f;
+	model.indices.resize(bytes / 5 / sizeof(unsigned int));
+	model.vertices.resize((bytes - bytes / 5) / sizeof(RHI_Vertex_PosUVTBN));
+	for (size_t i = 0; i < model.indices.size(); i++)
+	{
+		model.indices[i] = (unsigned int)(i * 7 % model.vertices.size());
+	}
+	for (size_t i = 0; i < model.vertices.size(); i++)
+	{
+		float* values = &model.vertices[i].pos[0];
+		for (size_t j = 0; j < sizeof(RHI_Vertex_PosUVTBN) / sizeof(float); j++)
+		{
+			values[j] = (float)(i + j);
+		}
+	}
+
+	double writeOld = Benchmark::Time([&] { OldFileStream stream(g_fileOld, FileStreamMode_Write); Model_Write(stream, model); });
+	double writeNew = Benchmark::Time([&] { FileStream stream(g_fileNew, FileStreamMode_Write); Model_Write(stream, model); });
+	uint64_t hash = model.GetHash();
+	model = Model();
+
+	printf("%.0f MB model, written in %.0f ms (old) and %.0f ms (FileStream)\n", bytes / (1024.0 * 1024.0), writeOld, writeNew);
+	printf("%22s | %10s %10s %10s | %6s\n", "", "ms", "reads", "peak MB", "equal");
+	auto Run = [&](const char* name, auto&& load)
+	{
+		Process_PeakMemoryReset();
+		long reads		= Process_ReadCalls();
+		uint64_t loaded	= 0;
+		double time		= Benchmark::Time([&] { loaded = load(); });
+		reads			= reads < 0 ? -1 : Process_ReadCalls() - reads;
+		printf("%22s | %10.0f %10ld %10ld | %6s\n", name, time, reads, Process_PeakMemoryMB(), loaded == hash ? "yes" : "no");
+	};
+
+	Run("old, old file", [&]
+	{
+		Model loaded;
+		OldFileStream stream(g_fileOld, FileStreamMode_Read);
+		Model_Read(stream, &loaded);
+		return loaded.GetHash();
+	});
+	Run("FileStream, old file", [&]
+	{
+		Model loaded;
+		FileStream stream(g_fileOld, FileStreamMode_Read);
+		Model_Read(stream, &loaded);
+		return loaded.GetHash();
+	});
+	Run("FileStream, verified", [&]
+	{
+		Model loaded;
+		FileStream stream(g_fileNew, FileStreamMode_Read);
+		Model_Read(stream, &loaded);
+		return loaded.GetHash();
+	});
+	Run("ReadSpan, verified", [&]
+	{
+		Model loaded;
+		FileStream stream(g_fileNew, FileStreamMode_Read);
+		stream.Read(&loaded.name);
+		stream.Read(&loaded.path);
+		stream.Read(&loaded.scale);
+		auto indices	= stream.ReadSpan<unsigned int>();
+		auto vertices	= stream.ReadSpan<RHI_Vertex_PosUVTBN>();
+		return Model_Hash(loaded.name, loaded.path, loaded.scale, indices.data, indices.size, vertices.data, vertices.size);
+	});
+
+	FileSystem::DeleteFile_(g_fileOld);
+	FileSystem::DeleteFile_(g_fileNew);
+
+	return 0;
+}
@@ -0,0 +1,240 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES =================================
+#include "Benchmark.h"
+#include <thread>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/Hash.h"
+#include "Core/Settings.h"
+#include "Threading/Threading.h"
+#include "IO/FileStream.h"
+#include "IO/MappedFile.h"
+#include "FileSystem/FileSystem.h"
+#include "RHI/RHI_Texture.h"
+#include "Resource/Import/ImportCache.h"
+#include "Resource/Import/MipmapGenerator.h"
+#include "Resource/Import/PixelConverter.h"
+#include "Resource/Import/TextureCompressor.h"
+//============================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace _Bench_ImportCache
+{
+	const string g_sourceDirectory	= "Bench_ImportCache_Sources/";
+	const string g_cacheDirectory	= "Bench_ImportCache_Entries/";
+	const unsigned int g_version	= 1;
+
+	string Source_Path(unsigned int index) { return g_sourceDirectory + to_string(index) + ".bgr"; }
+
+	// Decoded images as FreeImage hands them over: BGR8, bottom row first, after a width and a height
+	void Sources_Write(unsigned int count, unsigned int size)
+	{
+		FileSystem::CreateDirectory_(g_sourceDirectory);
+
+		vector<std::byte> pixels((size_t)size * size * 3);
+		uint32_t random = 1;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			for (size_t j = 0; j < pixels.size(); j++)
+			{
+				random		= random * 1664525u + 1013904223u;
+				size_t x	= (j / 3) % size;
+				size_t y	= (j / 3) / size;
+				pixels[j]	= (std::byte)(((x + y * (j % 3 + 1) + i * 7) & 0xFF) ^ ((random >> 29) & 3));
+			}
+
+			FILE* file = fopen(Source_Path(i).c_str(), "wb");
+			fwrite(&size, sizeof(size), 1, file);
+			fwrite(&size, sizeof(size), 1, file);
+			fwrite(pixels.data(), 1, pixels.size(), file);
+			fclose(file);
+		}
+	}
+
+	struct Texture
+	{
+		unsigned int width		= 0;
+		unsigned int height		= 0;
+		bool transparent		= false;
+		Texture_Format format	= Texture_Format_R8G8B8A8_UNORM;
+		vector<vector<std::byte>> mips;
+	};
+
+	// What ImageImporter::Load() does for an albedo texture with mipmaps, from the source bytes to the cache
+	bool Import(const string& path, ImportCache* cache, Threading* threading, Texture* texture)
+	{
+		MappedFile file;
+		if (!file.Open(path))
+			return false;
+
+		unsigned int settings[]	= { g_version, (unsigned int)TextureType_Albedo, 1, 0, 0, (unsigned int)TextureCompression_Normal };
+		uint64_t key			= cache ? ImportCache::ComputeKey(file.GetData(), file.GetSize(), Hash::Compute(settings, sizeof(settings))) : 0;
+		if (cache && cache->Load(key, [texture](FileStream* stream)
+		{
+			texture->width			= stream->ReadUInt();
+			texture->height			= stream->ReadUInt();
+			texture->transparent	= stream->ReadUInt() != 0;
+			texture->format			= (Texture_Format)stream->ReadUInt();
+			texture->mips.resize(stream->ReadUInt());
+			for (auto& mip : texture->mips)
+			{
+				stream->Read(&mip);
+			}
+			return !texture->mips.empty() && !texture->mips[0].empty();
+		}))
+			return true;
+
+		const unsigned int* header	= reinterpret_cast<const unsigned int*>(file.GetData());
+		texture->width				= header[0];
+		texture->height				= header[1];
+
+		PixelSource source;
+		source.width	= texture->width;
+		source.height	= texture->height;
+		source.format	= PixelFormat_BGR8;
+		source.pitch	= -(ptrdiff_t)texture->width * 3;
+		source.data		= file.GetData() + sizeof(unsigned int) * 2 + (size_t)(texture->height - 1) * texture->width * 3;
+		texture->mips.assign(1, vector<std::byte>((size_t)texture->width * texture->height * 4));
+		if (!PixelConverter::Convert(source, texture->mips[0].data(), &texture->transparent, threading))
+			return false;
+
+		MipmapSettings mipmapSettings;
+		mipmapSettings.srgb = true;
+		MipmapGenerator::Generate(&texture->mips, texture->width, texture->height, mipmapSettings, threading);
+
+		texture->format = TextureCompressor::ChooseFormat(TextureType_Albedo, false, !texture->transparent, TextureCompression_Normal);
+		vector<vector<std::byte>> blocks;
+		if (TextureCompressor::Compress(texture->mips, texture->width, texture->height, texture->format, TextureCompression_Normal, &blocks, threading))
+		{
+			texture->mips.swap(blocks);
+		}
+
+		if (cache)
+		{
+			cache->Store(key, [texture](FileStream* stream)
+			{
+				stream->Write(texture->width);
+				stream->Write(texture->height);
+				stream->Write((unsigned int)texture->transparent);
+				stream->Write((unsigned int)texture->format);
+				stream->Write((unsigned int)texture->mips.size());
+				for (const auto& mip : texture->mips)
+				{
+					stream->Write(mip);
+				}
+				return true;
+			});
+		}
+
+		return true;
+	}
+
+	// Imports every texture of the project, returns a hash of the results
+	uint64_t Project_Import(unsigned int count, ImportCache* cache, Threading* threading)
+	{
+		Hash hash;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			Texture texture;
+			if (!Import(Source_Path(i), cache, threading, &texture))
+				return 0;
+
+			for (const auto& mip : texture.mips)
+			{
+				hash.Update(mip.data(), mip.size());
+			}
+		}
+		return hash.Digest();
+	}
+}
+
+// Importing a project of 5,000 albedo textures (converted, mipmapped and compressed to BC7 the way ImageImporter does
+// it) without the import cache, with an empty one (every texture misses and is stored) and with a warm one (every
+// texture hits). The warm session rows reopen the cache first, as the editor does on startup. FreeImage isn't part of
+// the headless build, so sources are stored decoded and the decoding the cache also saves isn't timed.
+//
+//   Bench_ImportCache [textures = 5000] [size = 128]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_ImportCache;
+
+	unsigned int count	= Benchmark::Argument(argc, argv, 1, 5000);
+	unsigned int size	= Benchmark::Argument(argc, argv, 2, 128);
+
+	FileSystem::DeleteDirectory(g_sourceDirectory);
+	FileSystem::DeleteDirectory(g_cacheDirectory);
+	Sources_Write(count, size);
+
+	Context context;
+	Settings::Get().ThreadCountMax_Set(thread::hardware_concurrency());
+	Threading threading(&context);
+	threading.Initialize();
+
+	printf("%u textures of %ux%u, %u hardware threads\n\n", count, size, size, thread::hardware_concurrency());
+	printf("%20s | %10s | %6s | %6s | %9s\n", "", "import ms", "hits", "misses", "cache MB");
+
+	uint64_t uncachedHash	= 0;
+	double uncached			= Benchmark::Time([&] { uncachedHash = Project_Import(count, nullptr, &threading); });
+	printf("%20s | %10.1f | %6s | %6s | %9s\n", "no cache", uncached, "-", "-", "-");
+
+	bool identical = true;
+	{
+		ImportCache cache(g_cacheDirectory, 0);
+		uint64_t hash			= 0;
+		double cold				= Benchmark::Time([&] { hash = Project_Import(count, &cache, &threading); });
+		ImportCacheStats stats	= cache.GetStats();
+		identical				= identical && hash == uncachedHash;
+		printf("%20s | %10.1f | %6u | %6u | %9.1f\n", "cold", cold, stats.hits, stats.misses, stats.size / 1e6);
+
+		// The counts are since the cache was created
+		double warm					= Benchmark::Time([&] { hash = Project_Import(count, &cache, &threading); });
+		ImportCacheStats warmStats	= cache.GetStats();
+		identical					= identical && hash == uncachedHash;
+		printf("%20s | %10.1f | %6u | %6u | %9.1f\n", "warm", warm, warmStats.hits - stats.hits, warmStats.misses - stats.misses, warmStats.size / 1e6);
+	}
+
+	{
+		unique_ptr<ImportCache> cache;
+		uint64_t hash			= 0;
+		double open				= Benchmark::Time([&] { cache = make_unique<ImportCache>(g_cacheDirectory, 0); });
+		double warm				= Benchmark::Time([&] { hash = Project_Import(count, cache.get(), &threading); });
+		ImportCacheStats stats	= cache->GetStats();
+		identical				= identical && hash == uncachedHash;
+		printf("%20s | %10.1f | %6s | %6s | %9s\n", "open (new session)", open, "-", "-", "-");
+		printf("%20s | %10.1f | %6u | %6u | %9.1f\n", "warm (new session)", warm, stats.hits, stats.misses, stats.size / 1e6);
+	}
+
+	FileSystem::DeleteDirectory(g_sourceDirectory);
+	FileSystem::DeleteDirectory(g_cacheDirectory);
+
+	if (!identical)
+	{
+		printf("The cached imports differ from the uncached ones\n");
+		return 1;
+	}
+
+	return 0;
+}
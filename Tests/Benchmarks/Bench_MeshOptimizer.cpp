@@ -0,0 +1,122 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =======================
+#include "Benchmark.h"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "RHI/RHI_Vertex.h"
+#include "Rendering/MeshOptimizer.h"
+//==================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus;
+//=============================
+
+namespace _Bench_MeshOptimizer
+{
+	// An n by n grid of quads over a bumpy height field, as an importer without vertex welding hands it over:
+	// every triangle has its own three vertices and the triangles come in random order.
+	void Grid_Create(unsigned int size, vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices)
+	{
+		struct Triangle { unsigned int x[3], y[3]; };
+		vector<Triangle> triangles;
+		triangles.reserve((size_t)size * size * 2);
+		for (unsigned int y = 0; y < size; y++)
+		{
+			for (unsigned int x = 0; x < size; x++)
+			{
+				triangles.push_back({ { x, x + 1, x }, { y, y, y + 1 } });
+				triangles.push_back({ { x + 1, x + 1, x }, { y, y + 1, y + 1 } });
+			}
+		}
+		shuffle(triangles.begin(), triangles.end(), mt19937(1));
+
+		vertices->clear();
+		indices->clear();
+		for (const auto& triangle : triangles)
+		{
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				RHI_Vertex_PosUVTBN vertex = {};
+				vertex.pos[0]		= (float)triangle.x[i];
+				vertex.pos[1]		= sinf(triangle.x[i] * 0.05f) * cosf(triangle.y[i] * 0.05f) * 10.0f;
+				vertex.pos[2]		= (float)triangle.y[i];
+				vertex.uv[0]		= triangle.x[i] / (float)size;
+				vertex.uv[1]		= triangle.y[i] / (float)size;
+				vertex.normal[1]	= 1.0f;
+				indices->emplace_back((unsigned int)vertices->size());
+				vertices->emplace_back(vertex);
+			}
+		}
+	}
+
+	void Stats_Print(const char* stage, double time, const vector<RHI_Vertex_PosUVTBN>& vertices, const vector<unsigned int>& indices)
+	{
+		auto stats = MeshOptimizer::Analyze(indices, (unsigned int)vertices.size(), sizeof(RHI_Vertex_PosUVTBN));
+		char timeText[16] = "-";
+		if (time >= 0.0)
+		{
+			snprintf(timeText, sizeof(timeText), "%.1f", time);
+		}
+		printf("%-19s | %9s | %9zu | %6.3f | %6.3f | %9.3f |\n", stage, timeText, vertices.size(), stats.acmr, stats.atvr, stats.overfetch);
+	}
+}
+
+// Each pass of MeshOptimizer::Optimize() on a shuffled, unwelded grid, with the post transform cache (ACMR, ATVR) and
+// vertex fetch (overfetch) statistics after it, then the whole of Optimize() on a fresh copy.
+//
+//   Bench_MeshOptimizer [grid size = 1000] (2 triangles per cell)
+int main(int argc, char** argv)
+{
+	using namespace _Bench_MeshOptimizer;
+
+	unsigned int size = Benchmark::Argument(argc, argv, 1, 1000);
+	vector<RHI_Vertex_PosUVTBN> vertices;
+	vector<unsigned int> indices;
+	Grid_Create(size, &vertices, &indices);
+
+	printf("%zu triangles, 16 entry vertex cache, %zu byte vertices\n\n", indices.size() / 3, sizeof(RHI_Vertex_PosUVTBN));
+	printf("stage               | time ms   | vertices  | ACMR   | ATVR   | overfetch |\n");
+	Stats_Print("input", -1.0, vertices, indices);
+
+	double time = Benchmark::Time([&] { MeshOptimizer::Vertices_Deduplicate(&vertices, &indices); });
+	Stats_Print("deduplicate", time, vertices, indices);
+
+	vector<unsigned int> clusters;
+	time = Benchmark::Time([&] { MeshOptimizer::Indices_OptimizeCache(&indices, (unsigned int)vertices.size(), 16, &clusters); });
+	Stats_Print("vertex cache", time, vertices, indices);
+
+	time = Benchmark::Time([&] { MeshOptimizer::Indices_OptimizeOverdraw(&indices, vertices, clusters, 16); });
+	Stats_Print("overdraw", time, vertices, indices);
+
+	time = Benchmark::Time([&] { MeshOptimizer::Vertices_OptimizeFetch(&vertices, &indices); });
+	Stats_Print("vertex fetch", time, vertices, indices);
+
+	Grid_Create(size, &vertices, &indices);
+	time = Benchmark::Time([&] { MeshOptimizer::Optimize(&vertices, &indices); });
+	Stats_Print("Optimize()", time, vertices, indices);
+
+	return 0;
+}
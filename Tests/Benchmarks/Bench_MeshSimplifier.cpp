@@ -0,0 +1,127 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ========================
+#include "Benchmark.h"
+#include <cmath>
+#include <vector>
+#include "RHI/RHI_Vertex.h"
+#include "Rendering/MeshSimplifier.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace _Bench_MeshSimplifier
+{
+	// What the importer does, see ModelImporter::LoadMesh() and Model
+	const unsigned int g_lodCount	= 4;
+	const float g_lodReduction		= 0.5f;
+	const float g_lodMaxError		= 0.05f;
+
+	// A welded n by n grid of quads over a height field with detail at several scales, so that the cheap collapses
+	// run out well before the expensive ones
+	void Grid_Create(unsigned int size, vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices)
+	{
+		vertices->clear();
+		indices->clear();
+		vertices->reserve((size_t)(size + 1) * (size + 1));
+		indices->reserve((size_t)size * size * 6);
+		for (unsigned int y = 0; y <= size; y++)
+		{
+			for (unsigned int x = 0; x <= size; x++)
+			{
+				RHI_Vertex_PosUVTBN vertex = {};
+				vertex.pos[0]		= (float)x;
+				vertex.pos[1]		= sinf(x * 0.01f) * cosf(y * 0.013f) * 40.0f + sinf(x * 0.21f + y * 0.17f) * 2.0f + sinf(x * 1.3f) * cosf(y * 1.1f) * 0.2f;
+				vertex.pos[2]		= (float)y;
+				vertex.uv[0]		= x / (float)size;
+				vertex.uv[1]		= y / (float)size;
+				vertex.normal[1]	= 1.0f;
+				vertices->emplace_back(vertex);
+			}
+		}
+		for (unsigned int y = 0; y < size; y++)
+		{
+			for (unsigned int x = 0; x < size; x++)
+			{
+				unsigned int i00 = y * (size + 1) + x, i10 = i00 + 1, i01 = i00 + size + 1, i11 = i01 + 1;
+				indices->insert(indices->end(), { i00, i01, i10, i10, i01, i11 });
+			}
+		}
+	}
+}
+
+// MeshSimplifier::Simplify() on grids of 1M to 10M triangles: one level at half the triangles, then the whole chain the
+// importer builds (each level half of the previous one, the errors adding up to at most 5% of the radius).
+//
+//   Bench_MeshSimplifier [max triangles in millions = 10]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_MeshSimplifier;
+
+	unsigned int maxTriangles = Benchmark::Argument(argc, argv, 1, 10) * 1000000;
+
+	printf("%10s | %10s %8s %10s | %10s %30s\n", "triangles", "half ms", "Mtri/s", "error", "chain ms", "levels (triangles)");
+	for (unsigned int triangles : { 1000000u, 2500000u, 5000000u, 10000000u })
+	{
+		if (triangles > maxTriangles)
+			break;
+
+		vector<RHI_Vertex_PosUVTBN> vertices;
+		vector<unsigned int> indices;
+		Grid_Create((unsigned int)sqrt(triangles / 2.0), &vertices, &indices);
+		unsigned int count = (unsigned int)(indices.size() / 3);
+
+		vector<unsigned int> half;
+		float error		= 0.0f;
+		double halfTime	= Benchmark::Time([&]
+		{
+			error = MeshSimplifier::Simplify(vertices, indices, (unsigned int)(indices.size() * g_lodReduction) / 3 * 3, g_lodMaxError, &half);
+		});
+
+		// Every level from the previous one, like the importer
+		vector<vector<unsigned int>> lods;
+		double chainTime = Benchmark::Time([&]
+		{
+			const vector<unsigned int>* previous	= &indices;
+			float chainError						= 0.0f;
+			for (unsigned int lod = 1; lod < g_lodCount; lod++)
+			{
+				vector<unsigned int> simplified;
+				unsigned int target	= (unsigned int)(previous->size() * g_lodReduction) / 3 * 3;
+				chainError			+= MeshSimplifier::Simplify(vertices, *previous, target, g_lodMaxError - chainError, &simplified);
+				lods.emplace_back(move(simplified));
+				previous = &lods.back();
+			}
+		});
+
+		string levels;
+		for (const auto& lod : lods)
+		{
+			levels += (levels.empty() ? "" : " ") + to_string(lod.size() / 3);
+		}
+		printf("%10u | %10.0f %8.2f %10.4f | %10.0f %30s\n", count, halfTime, count / halfTime / 1000.0, error, chainTime, levels.c_str());
+	}
+
+	return 0;
+}
@@ -0,0 +1,263 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ===========================
+#include "Benchmark.h"
+#include <cmath>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/EventSystem.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "Math/Frustum.h"
+#include "Resource/ResourceManager.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/Model.h"
+#include "Rendering/Meshlet.h"
+#include "Rendering/GeometryUtility.h"
+#include "World/World.h"
+#include "World/Actor.h"
+#include "World/Components/Renderable.h"
+#include "World/Components/Transform.h"
+//======================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//============================
+
+namespace _Bench_Meshlet
+{
+	const float g_chunkSize = 100.0f;
+
+	// Geometry of the model, split into meshlets the way the importer does it
+	struct Geometry
+	{
+		unsigned int indexOffset	= 0;
+		unsigned int indexCount		= 0;
+		unsigned int vertexOffset	= 0;
+		unsigned int vertexCount	= 0;
+		BoundingBox aabb;
+	};
+
+	Geometry Geometry_Add(Model* model, vector<RHI_Vertex_PosUVTBN>& vertices, vector<unsigned int>& indices)
+	{
+		vector<Meshlet> meshlets;
+		MeshletBuilder::Build(vertices, &indices, &meshlets);
+
+		Geometry geometry;
+		geometry.indexCount		= (unsigned int)indices.size();
+		geometry.vertexCount	= (unsigned int)vertices.size();
+		geometry.aabb			= BoundingBox(vertices);
+		model->Geometry_Append(indices, vertices, &geometry.indexOffset, &geometry.vertexOffset);
+		model->Geometry_SetMeshlets(geometry.indexOffset, move(meshlets));
+		return geometry;
+	}
+
+	// A chunk of rolling terrain, size by size quads
+	Geometry Terrain_Add(Model* model, unsigned int size)
+	{
+		vector<RHI_Vertex_PosUVTBN> vertices;
+		vector<unsigned int> indices;
+		float step = g_chunkSize / size;
+		for (unsigned int z = 0; z <= size; z++)
+		{
+			for (unsigned int x = 0; x <= size; x++)
+			{
+				RHI_Vertex_PosUVTBN vertex = {};
+				vertex.pos[0]		= x * step;
+				vertex.pos[1]		= sinf(x * step * 0.05f) * cosf(z * step * 0.07f) * 4.0f;
+				vertex.pos[2]		= z * step;
+				vertex.normal[1]	= 1.0f;
+				vertices.emplace_back(vertex);
+			}
+		}
+		for (unsigned int z = 0; z < size; z++)
+		{
+			for (unsigned int x = 0; x < size; x++)
+			{
+				unsigned int i00 = z * (size + 1) + x, i10 = i00 + 1, i01 = i00 + size + 1, i11 = i01 + 1;
+				indices.insert(indices.end(), { i00, i01, i10, i10, i01, i11 });
+			}
+		}
+		return Geometry_Add(model, vertices, indices);
+	}
+
+	Geometry Sphere_Add(Model* model, unsigned int slices)
+	{
+		vector<RHI_Vertex_PosUVTBN> vertices;
+		vector<unsigned int> indices;
+		GeometryUtility::CreateSphere(&vertices, &indices, 5.0f, slices, slices);
+		return Geometry_Add(model, vertices, indices);
+	}
+
+	void Renderable_Add(World* world, Model* model, const Geometry& geometry, const Vector3& position)
+	{
+		auto actor = world->Actor_CreateAdd().lock();
+		actor->GetTransform_PtrRaw()->SetPosition(position);
+		auto renderable = actor->AddComponent<Renderable>().lock();
+		renderable->Geometry_Set("geometry", geometry.indexOffset, geometry.indexCount, geometry.vertexOffset, geometry.vertexCount, geometry.aabb, model);
+		renderable->Material_UseDefault();
+	}
+
+	struct Submission
+	{
+		uint64_t triangles	= 0;
+		unsigned int draws	= 0;
+	};
+}
+
+// Culling a scene of large meshes as wholes and by meshlet: 64 terrain chunks (8 by 8, about 1M triangles each) with
+// 64 spheres (about 260k triangles each) above them, from a camera inside the scene looking across it. Meshlet culling
+// is what Renderer::Renderables_Cull() does for what survived the whole mesh test (Renderable::Geometry_CullMeshlets,
+// with its cap on draws), the uncapped row draws every run of adjacent meshlets that survived.
+//
+//   Bench_Meshlet [terrain quads per side = 700] [sphere slices = 360]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_Meshlet;
+
+	unsigned int terrainSize	= Benchmark::Argument(argc, argv, 1, 700);
+	unsigned int sphereSlices	= Benchmark::Argument(argc, argv, 2, 360);
+
+	FileSystem::Initialize();
+
+	// The context deletes its subsystems except for the first one (normally the engine)
+	auto context	= make_unique<Context>();
+	auto threading	= make_unique<Threading>(context.get());
+	context->RegisterSubsystem(threading.get());
+	threading->Initialize();
+	auto resourceManager = new ResourceManager(context.get());
+	context->RegisterSubsystem(resourceManager);
+	resourceManager->Initialize();
+	auto renderer = new Renderer(context.get(), nullptr);
+	context->RegisterSubsystem(renderer);
+	renderer->Initialize();
+	auto world = new World(context.get());
+	context->RegisterSubsystem(world);
+	world->Initialize();
+	world->Unload();
+
+	{
+		auto model			= make_shared<Model>(context.get());
+		Geometry terrain	= Terrain_Add(model.get(), terrainSize);
+		Geometry sphere		= Sphere_Add(model.get(), sphereSlices);
+		for (unsigned int i = 0; i < 64; i++)
+		{
+			float x = (float)(i % 8) * g_chunkSize - 4.0f * g_chunkSize;
+			float z = (float)(i / 8) * g_chunkSize - 4.0f * g_chunkSize;
+			Renderable_Add(world, model.get(), terrain, Vector3(x, 0.0f, z));
+			Renderable_Add(world, model.get(), sphere, Vector3(x + g_chunkSize * 0.5f, 15.0f, z + g_chunkSize * 0.5f));
+		}
+		FIRE_EVENT(EVENT_SCENE_RESOLVE_START);
+		FIRE_EVENT(EVENT_TICK);
+
+		vector<Renderable*> renderables;
+		uint64_t total = 0;
+		for (const auto& actor : world->GetAllActors())
+		{
+			if (Renderable* renderable = actor->GetRenderable_PtrRaw())
+			{
+				renderables.emplace_back(renderable);
+				total += renderable->Geometry_IndexCount() / 3;
+			}
+		}
+
+		Vector3 cameraPosition(-150.0f, 20.0f, -150.0f);
+		Frustum frustum;
+		frustum.Construct(
+			Matrix::CreateLookAtLH(cameraPosition, Vector3(100.0f, 0.0f, 100.0f), Vector3::Up),
+			Matrix::CreatePerspectiveFieldOfViewLH(1.0f, 16.0f / 9.0f, 0.3f, 1000.0f),
+			1000.0f
+		);
+
+		// Whole meshes, what the bounding volume hierarchy query hands over
+		vector<Renderable*> visible;
+		Submission whole;
+		double wholeTime = Benchmark::Best(20, [&]
+		{
+			visible.clear();
+			whole = Submission();
+			for (Renderable* renderable : renderables)
+			{
+				const BoundingBox& box = renderable->Geometry_BB();
+				if (frustum.CheckCube(box.GetCenter(), box.GetExtents()) != Outside)
+				{
+					visible.emplace_back(renderable);
+					whole.triangles += renderable->Geometry_IndexCount() / 3;
+					whole.draws++;
+				}
+			}
+		});
+
+		Submission capped;
+		double cappedTime = Benchmark::Best(20, [&]
+		{
+			capped = Submission();
+			for (Renderable* renderable : visible)
+			{
+				if (!renderable->Geometry_CullMeshlets(frustum, cameraPosition))
+					continue;
+
+				for (const auto& range : renderable->Geometry_Ranges())
+				{
+					capped.triangles += range.indexCount / 3;
+				}
+				capped.draws += (unsigned int)renderable->Geometry_Ranges().size();
+			}
+		});
+
+		// The same tests, without groups and without merging ranges across gaps
+		Submission uncapped;
+		double uncappedTime = Benchmark::Best(20, [&]
+		{
+			uncapped = Submission();
+			for (Renderable* renderable : visible)
+			{
+				const Matrix& transform			= renderable->GetTransform()->GetWorldTransform();
+				Vector3 cameraLocal				= transform.Inverted() * cameraPosition;
+				const GeometryMeshlets* meshlets	= renderable->Geometry_Model()->Geometry_GetMeshlets(renderable->Geometry_IndexOffset());
+				unsigned int end				= 0;
+				for (const auto& meshlet : meshlets->meshlets)
+				{
+					if (frustum.CheckSphere(transform * meshlet.center, meshlet.radius) == Outside || MeshletBuilder::IsBackFacing(meshlet, cameraLocal))
+						continue;
+
+					uncapped.triangles	+= meshlet.indexCount / 3;
+					uncapped.draws		+= meshlet.indexOffset != end ? 1 : 0;
+					end					= meshlet.indexOffset + meshlet.indexCount;
+				}
+			}
+		});
+
+		printf("%u renderables, %.1fM triangles\n", (unsigned int)renderables.size(), total / 1e6);
+		printf("%22s | %12s %8s | %8s\n", "", "triangles M", "draws", "cull ms");
+		printf("%22s | %12.2f %8u | %8.3f\n", "whole meshes", whole.triangles / 1e6, whole.draws, wholeTime);
+		printf("%22s | %12.2f %8u | %8.3f\n", "meshlets", capped.triangles / 1e6, capped.draws, wholeTime + cappedTime);
+		printf("%22s | %12.2f %8u | %8.3f\n", "meshlets, uncapped", uncapped.triangles / 1e6, uncapped.draws, wholeTime + uncappedTime);
+	}
+
+	context.reset();
+	threading.reset();
+	EventSystem::Get().Clear();
+
+	return 0;
+}
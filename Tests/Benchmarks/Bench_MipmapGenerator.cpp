@@ -0,0 +1,221 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===============================
+#include "Benchmark.h"
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/Settings.h"
+#include "Threading/Threading.h"
+#include "Resource/Import/MipmapGenerator.h"
+//==========================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus;
+//=============================
+
+namespace _Bench_MipmapGenerator
+{
+	typedef vector<vector<std::byte>> MipChain;
+
+	// Value noise, fine high contrast stripes and a checker board in the color channels, and a cutout mask in alpha
+	vector<std::byte> Image_Create(unsigned int size)
+	{
+		const unsigned int noiseSize = 257;
+		vector<float> noise(noiseSize * noiseSize);
+		uint32_t random = 1;
+		for (float& value : noise)
+		{
+			random	= random * 1664525u + 1013904223u;
+			value	= (random >> 8) / 16777216.0f;
+		}
+
+		vector<std::byte> image((size_t)size * size * 4);
+		for (unsigned int y = 0; y < size; y++)
+		{
+			for (unsigned int x = 0; x < size; x++)
+			{
+				float u		= x / (float)size;
+				float v		= y / (float)size;
+				float fx	= u * 256.0f;
+				float fy	= v * 256.0f;
+				unsigned int ix	= (unsigned int)fx;
+				unsigned int iy	= (unsigned int)fy;
+				float tx	= fx - ix;
+				float ty	= fy - iy;
+				float top		= noise[iy * noiseSize + ix] * (1.0f - tx) + noise[iy * noiseSize + ix + 1] * tx;
+				float bottom	= noise[(iy + 1) * noiseSize + ix] * (1.0f - tx) + noise[(iy + 1) * noiseSize + ix + 1] * tx;
+				float value		= top * (1.0f - ty) + bottom * ty;
+				float stripes	= ((x / 3 + y / 5) % 2) ? 1.0f : 0.05f;
+				float checker	= (((x >> 6) + (y >> 6)) & 1) ? 0.9f : 0.2f;
+
+				std::byte* texel = &image[((size_t)y * size + x) * 4];
+				texel[0] = (std::byte)(unsigned char)((u < 0.5f ? stripes : value) * 255.0f + 0.5f);
+				texel[1] = (std::byte)(unsigned char)((v < 0.5f ? checker : value * stripes) * 255.0f + 0.5f);
+				texel[2] = (std::byte)(unsigned char)(0.5f * (value + checker) * 255.0f + 0.5f);
+				texel[3] = (std::byte)(unsigned char)(value > 0.55f ? 255 : 0);
+			}
+		}
+		return image;
+	}
+
+	// Of the color channels
+	double PSNR(const vector<std::byte>& a, const vector<std::byte>& b)
+	{
+		double error = 0.0;
+		for (size_t i = 0; i < a.size(); i++)
+		{
+			if (i % 4 == 3)
+				continue;
+
+			double difference = (double)(unsigned char)a[i] - (double)(unsigned char)b[i];
+			error += difference * difference;
+		}
+		error /= (double)(a.size() / 4 * 3);
+		return error == 0.0 ? 99.0 : 10.0 * log10(255.0 * 255.0 / error);
+	}
+
+	// Average over levels 1 to 6, where the filters differ the most
+	double PSNR(const MipChain& mips, const MipChain& reference)
+	{
+		double sum = 0.0;
+		for (unsigned int level = 1; level <= 6; level++)
+		{
+			sum += PSNR(mips[level], reference[level]);
+		}
+		return sum / 6.0;
+	}
+
+	// Every level resampled straight from the first one, unchained. With linear light filtering this is the reference
+	// the chained levels are compared against, with gamma space Lanczos3 it's what the importer did with FreeImage.
+	MipChain Chain_Direct(const vector<std::byte>& image, unsigned int size, const MipmapSettings& settings, unsigned int lastSize)
+	{
+		MipChain mips = { image };
+		for (unsigned int levelSize = size / 2; levelSize >= lastSize && levelSize > 0; levelSize /= 2)
+		{
+			mips.emplace_back((size_t)levelSize * levelSize * 4);
+			MipmapGenerator::Resample(image.data(), size, size, mips.back().data(), levelSize, levelSize, settings);
+		}
+		return mips;
+	}
+
+	// The fastest of a few runs, in milliseconds. mips ends up with the chain.
+	double Generate_Best(const vector<std::byte>& image, unsigned int size, const MipmapSettings& settings, Threading* threading, MipChain* mips)
+	{
+		double best = 0.0;
+		for (unsigned int run = 0; run < 3; run++)
+		{
+			*mips		= { image };
+			double time	= Benchmark::Time([&] { MipmapGenerator::Generate(mips, size, size, settings, threading); });
+			best		= (run == 0 || time < best) ? time : best;
+		}
+		return best;
+	}
+
+	double Coverage(const vector<std::byte>& mip)
+	{
+		size_t passing = 0;
+		for (size_t i = 3; i < mip.size(); i += 4)
+		{
+			passing += (unsigned char)mip[i] > 127 ? 1 : 0;
+		}
+		return (double)passing / (double)(mip.size() / 4);
+	}
+}
+
+// Mip chain generation of sRGB textures, the old path against MipmapGenerator::Generate() with each filter, with the
+// PSNR of levels 1 to 6 against an unchained linear light resample with the same filter. The old path (FreeImage's
+// Lanczos3 rescale from the first level, in gamma space) is emulated with MipmapGenerator::Resample() as FreeImage is
+// a Windows only dependency here. Then the alpha coverage of a cutout, with and without coverage preservation.
+//
+//   Bench_MipmapGenerator [smallest size = 4096] [largest size = 8192]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_MipmapGenerator;
+
+	unsigned int sizeMin = Benchmark::Argument(argc, argv, 1, 4096);
+	unsigned int sizeMax = Benchmark::Argument(argc, argv, 2, 8192);
+
+	Context context;
+	Settings::Get().ThreadCountMax_Set(thread::hardware_concurrency());
+	Threading threading(&context);
+	threading.Initialize();
+	printf("%u hardware threads\n", thread::hardware_concurrency());
+
+	const char* filterNames[] = { "box", "Kaiser", "Lanczos3" };
+	for (unsigned int size = sizeMin; size <= sizeMax; size *= 2)
+	{
+		auto image = Image_Create(size);
+		printf("\n%ux%u\n", size, size);
+		printf("path                              | ms single thread | ms threaded | PSNR dB |\n");
+
+		// The references, unchained and in linear light
+		MipChain references[3];
+		for (unsigned int filter = 0; filter < 3; filter++)
+		{
+			MipmapSettings settings;
+			settings.filter		= (MipmapFilter)filter;
+			settings.srgb		= true;
+			references[filter]	= Chain_Direct(image, size, settings, size / 64);
+		}
+
+		// Old
+		{
+			MipmapSettings settings;
+			settings.filter = MipmapFilter_Lanczos;
+			MipChain mips;
+			double time = Benchmark::Time([&] { mips = Chain_Direct(image, size, settings, 1); });
+			printf("old, Lanczos3 from level 0, gamma | %16.0f | %11s | %7.2f |\n", time, "-", PSNR(mips, references[MipmapFilter_Lanczos]));
+		}
+
+		// New
+		for (unsigned int filter = 0; filter < 3; filter++)
+		{
+			MipmapSettings settings;
+			settings.filter	= (MipmapFilter)filter;
+			settings.srgb	= true;
+
+			MipChain mips;
+			double timeThreaded	= Generate_Best(image, size, settings, &threading, &mips);
+			double time			= Generate_Best(image, size, settings, nullptr, &mips);
+
+			char name[64];
+			snprintf(name, sizeof(name), "new, %s chained, linear", filterNames[filter]);
+			printf("%-33s | %16.0f | %11.0f | %7.2f |\n", name, time, timeThreaded, PSNR(mips, references[filter]));
+		}
+
+		// Cutouts
+		for (unsigned int preserve = 0; preserve < 2; preserve++)
+		{
+			MipmapSettings settings;
+			settings.preserveCoverage = preserve == 1;
+			MipChain mips = { image };
+			MipmapGenerator::Generate(&mips, size, size, settings, &threading);
+			printf("alpha coverage, %s: level 0 %.2f, level 4 %.2f, level 7 %.2f, level 9 %.2f\n", preserve ? "preserved" : "plain    ",
+				Coverage(mips[0]), Coverage(mips[4]), Coverage(mips[7]), Coverage(mips[9]));
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,201 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES =========================
+#include "Benchmark.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/Settings.h"
+#include "Threading/Threading.h"
+#include "Math/BoundingBox.h"
+#include "RHI/RHI_Vertex.h"
+#include "Rendering/GeometryUtility.h"
+#include "Rendering/MeshOptimizer.h"
+#include "Rendering/MeshSimplifier.h"
+#include "Rendering/Meshlet.h"
+//====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//============================
+
+namespace _Bench_ModelImport
+{
+	// What the importer does, see ModelImporter::LoadMesh() and Model
+	const unsigned int g_lodCount			= 4;
+	const float g_lodReduction				= 0.5f;
+	const float g_lodMaxError				= 0.05f;
+	const float g_lodMinReduction			= 0.9f;
+	const unsigned int g_meshletMinTriangles	= 4096;
+
+	// A mesh as Assimp hands it over
+	struct SourceMesh
+	{
+		vector<RHI_Vertex_PosUVTBN> vertices;
+		vector<unsigned int> indices;
+	};
+
+	struct MeshData
+	{
+		vector<RHI_Vertex_PosUVTBN> vertices;
+		vector<unsigned int> indices;
+		vector<Meshlet> meshlets;
+		vector<vector<unsigned int>> lods;
+		BoundingBox boundingBox;
+	};
+
+	// The model's geometry, appended to in mesh order
+	struct ModelData
+	{
+		vector<RHI_Vertex_PosUVTBN> vertices;
+		vector<unsigned int> indices;
+		unsigned int meshletCount = 0;
+	};
+
+	// ModelImporter::LoadMesh(), with the extraction being a copy
+	void Mesh_Load(const SourceMesh& source, MeshData* mesh)
+	{
+		mesh->vertices		= source.vertices;
+		mesh->indices		= source.indices;
+		mesh->boundingBox	= BoundingBox(mesh->vertices);
+
+		MeshOptimizer::Optimize(&mesh->vertices, &mesh->indices);
+		if (mesh->indices.size() / 3 >= g_meshletMinTriangles)
+		{
+			MeshletBuilder::Build(mesh->vertices, &mesh->indices, &mesh->meshlets);
+		}
+
+		const vector<unsigned int>* lodIndices	= &mesh->indices;
+		float lodError							= 0.0f;
+		for (unsigned int lod = 1; lod < g_lodCount; lod++)
+		{
+			unsigned int target = (unsigned int)(lodIndices->size() * g_lodReduction) / 3 * 3;
+			vector<unsigned int> simplified;
+			lodError += MeshSimplifier::Simplify(mesh->vertices, *lodIndices, target, g_lodMaxError - lodError, &simplified);
+			if (simplified.size() > lodIndices->size() * g_lodMinReduction)
+				break;
+
+			MeshOptimizer::Indices_OptimizeCache(&simplified, (unsigned int)mesh->vertices.size(), 16);
+			mesh->lods.emplace_back(move(simplified));
+			lodIndices = &mesh->lods.back();
+		}
+	}
+
+	// Model::Geometry_Append() and Model::Geometry_AppendLod(), serially and in mesh order
+	void Model_Append(vector<MeshData>& meshes, ModelData* model)
+	{
+		for (const auto& mesh : meshes)
+		{
+			model->vertices.insert(model->vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+			model->indices.insert(model->indices.end(), mesh.indices.begin(), mesh.indices.end());
+			for (const auto& lod : mesh.lods)
+			{
+				model->indices.insert(model->indices.end(), lod.begin(), lod.end());
+			}
+			model->meshletCount += (unsigned int)mesh.meshlets.size();
+		}
+	}
+}
+
+// Importing a scene of many meshes of different sizes (spheres of 8 to 128 slices, with one in twenty a large one of
+// 256 slices), the per mesh work being what ModelImporter::LoadMesh() does. Assimp isn't part of the headless build,
+// so the extraction is a copy and the FBX/OBJ parsing (serial in Assimp either way) isn't timed. The serial row is
+// the old importer, one mesh after another, the others are the importer's jobs (largest mesh first) at 1 to 32
+// worker threads, followed by the serial append to the model.
+//
+//   Bench_ModelImport [meshes = 300] [max threads = 32]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_ModelImport;
+
+	unsigned int meshCount	= Benchmark::Argument(argc, argv, 1, 300);
+	unsigned int maxThreads	= Benchmark::Argument(argc, argv, 2, 32);
+
+	vector<SourceMesh> sources(meshCount);
+	uint64_t triangles = 0;
+	for (unsigned int i = 0; i < meshCount; i++)
+	{
+		int slices = (i % 20 == 0) ? 256 : 8 + (int)((i * 37) % 121);
+		GeometryUtility::CreateSphere(&sources[i].vertices, &sources[i].indices, 1.0f + i * 0.01f, slices, slices);
+		triangles += sources[i].indices.size() / 3;
+	}
+
+	vector<unsigned int> order(meshCount);
+	for (unsigned int i = 0; i < meshCount; i++)
+	{
+		order[i] = i;
+	}
+	stable_sort(order.begin(), order.end(), [&sources](unsigned int a, unsigned int b) { return sources[a].indices.size() > sources[b].indices.size(); });
+
+	printf("%u meshes, %.2fM triangles, %u hardware threads\n\n", meshCount, triangles / 1e6, thread::hardware_concurrency());
+	printf("%8s | %10s | %10s | %8s\n", "threads", "meshes ms", "append ms", "speedup");
+
+	ModelData model;
+	double serial = 0.0;
+	{
+		vector<MeshData> meshes(meshCount);
+		double load = Benchmark::Time([&]
+		{
+			for (unsigned int i = 0; i < meshCount; i++)
+			{
+				Mesh_Load(sources[i], &meshes[i]);
+			}
+		});
+		double append	= Benchmark::Time([&] { Model_Append(meshes, &model); });
+		serial			= load + append;
+		printf("%8s | %10.1f | %10.1f | %8.2f\n", "serial", load, append, 1.0);
+	}
+
+	Context context;
+	for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		// The calling thread only waits, like the thread that loads the model
+		Settings::Get().ThreadCountMax_Set(threads + 1);
+		Threading threading(&context);
+		threading.Initialize();
+
+		vector<MeshData> meshes(meshCount);
+		double load = Benchmark::Time([&]
+		{
+			vector<JobHandle> jobs;
+			jobs.reserve(meshCount);
+			for (unsigned int i : order)
+			{
+				jobs.emplace_back(threading.AddTask([&sources, &meshes, i]() { Mesh_Load(sources[i], &meshes[i]); }));
+			}
+			threading.Wait(jobs);
+		});
+
+		ModelData parallel;
+		double append = Benchmark::Time([&] { Model_Append(meshes, &parallel); });
+		if (parallel.indices != model.indices || parallel.meshletCount != model.meshletCount)
+		{
+			printf("%u threads: the model differs from the serial import\n", threads);
+			return 1;
+		}
+		printf("%8u | %10.1f | %10.1f | %8.2f\n", threads, load, append, serial / (load + append));
+	}
+
+	return 0;
+}
@@ -0,0 +1,182 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ============================
+#include "Benchmark.h"
+#include <vector>
+#include <cstring>
+#include <filesystem>
+#include "IO/FileStream.h"
+#include "FileSystem/FileSystem.h"
+#include "FileSystem/PackFile.h"
+#include "FileSystem/VirtualFileSystem.h"
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+//=======================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace _Bench_PackFile
+{
+	const char* g_directory		= "Bench_PackFile_Assets";
+	const char* g_packRaw		= "Bench_PackFile_Raw.pak";
+	const char* g_packLZ4		= "Bench_PackFile_LZ4.pak";
+	const unsigned int g_perDirectory	= 200;
+
+	string Asset_Path(unsigned int i)
+	{
+		return string(g_directory) + "/d" + to_string(i / g_perDirectory) + "/a" + to_string(i) + EXTENSION_MODEL;
+	}
+
+	// Vertex-like floats, 1 to 49 KB each, compressible the way meshes are
+	uint64_t Assets_Write(unsigned int count)
+	{
+		uint64_t bytes	= 0;
+		uint32_t random	= 7;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (i % g_perDirectory == 0)
+			{
+				FileSystem::CreateDirectory_(FileSystem::GetDirectoryFromFilePath(Asset_Path(i)));
+			}
+
+			random				= random * 1664525u + 1013904223u;
+			unsigned int floats	= (1024 + (random >> 8) % (48 * 1024)) / 4;
+			float base			= (float)((random >> 16) % 100);
+			vector<std::byte> data(floats * sizeof(float));
+			for (unsigned int j = 0; j < floats; j++)
+			{
+				random		= random * 1664525u + 1013904223u;
+				float value	= base + (float)(j % 64) * 0.25f + ((random >> 28) == 0 ? 1.0f : 0.0f);
+				memcpy(&data[j * sizeof(float)], &value, sizeof(float));
+			}
+
+			auto file = make_unique<FileStream>(Asset_Path(i), FileStreamMode_Write);
+			file->Write("asset" + to_string(i));
+			file->Write(data);
+			bytes += data.size();
+		}
+		return bytes;
+	}
+
+	// Evicts a file from the page cache, so that the next read comes from the disk. Only Linux can be asked to,
+	// elsewhere cold and warm runs are the same.
+	bool Cache_Drop(const string& path)
+	{
+	#if defined(__linux__)
+		int file = open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		fdatasync(file);
+		bool dropped = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+		close(file);
+		return dropped;
+	#else
+		return false;
+	#endif
+	}
+
+	// What a cold start does, every asset opened through FileStream (which resolves it through the mounted packs)
+	unsigned int Assets_Load(unsigned int count)
+	{
+		unsigned int loaded = 0;
+		string name;
+		vector<std::byte> data;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			auto file = make_unique<FileStream>(Asset_Path(i), FileStreamMode_Read);
+			if (!file->IsOpen())
+				continue;
+
+			file->Read(&name);
+			file->Read(&data);
+			loaded += (name == "asset" + to_string(i) && !data.empty()) ? 1 : 0;
+		}
+		return loaded;
+	}
+}
+
+// Loading 10k small assets at startup from loose files and from a pack (stored as is and LZ4 compressed). Cold runs
+// drop the files from the page cache first, warm ones read them again right after. Loaded should match the asset count.
+//
+//   Bench_PackFile [assets = 10000]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_PackFile;
+
+	unsigned int count = Benchmark::Argument(argc, argv, 1, 10000);
+
+	FileSystem::DeleteDirectory(g_directory);
+	uint64_t bytes = Assets_Write(count);
+	PackFile::Create(g_directory, g_packRaw, false);
+	PackFile::Create(g_directory, g_packLZ4, true);
+
+	vector<string> loose;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		loose.emplace_back(Asset_Path(i));
+	}
+
+	printf("%u assets, %.1f MB\n", count, bytes / 1e6);
+	printf("%10s | %10s %10s | %10s %8s\n", "source", "cold ms", "warm ms", "size MB", "loaded");
+	auto Run = [&](const char* source, const char* pack)
+	{
+		bool dropped = true;
+		uint64_t size = 0;
+		if (pack)
+		{
+			dropped	= Cache_Drop(pack);
+			size	= filesystem::file_size(pack);
+			VirtualFileSystem::Mount(pack);
+			VirtualFileSystem::SetLooseFilesOverride(false);
+		}
+		else
+		{
+			for (const auto& path : loose)
+			{
+				dropped	= Cache_Drop(path) && dropped;
+				size	+= filesystem::file_size(path);
+			}
+		}
+
+		unsigned int loaded = 0;
+		double cold = Benchmark::Time([&] { loaded = Assets_Load(count); });
+		double warm = Benchmark::Best(3, [&] { Assets_Load(count); });
+		printf("%10s | %10.0f %10.0f | %10.1f %8u%s\n", source, cold, warm, size / 1e6, loaded, dropped ? "" : " (not dropped from the cache)");
+
+		VirtualFileSystem::UnmountAll();
+		VirtualFileSystem::SetLooseFilesOverride(true);
+	};
+	Run("loose", nullptr);
+	Run("pack", g_packRaw);
+	Run("pack lz4", g_packLZ4);
+
+	FileSystem::DeleteDirectory(g_directory);
+	FileSystem::DeleteFile_(g_packRaw);
+	FileSystem::DeleteFile_(g_packLZ4);
+
+	return 0;
+}
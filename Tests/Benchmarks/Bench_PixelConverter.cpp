@@ -0,0 +1,263 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ==============================
+#include "Benchmark.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/Settings.h"
+#include "Threading/Threading.h"
+#include "Resource/Import/PixelConverter.h"
+//=========================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace _Bench_PixelConverter
+{
+	// FreeImage's channel offsets in a 32-bit pixel (little endian)
+	const unsigned int g_red	= 2;
+	const unsigned int g_green	= 1;
+	const unsigned int g_blue	= 0;
+	const unsigned int g_alpha	= 3;
+
+	unsigned int BytesPerPixel(PixelFormat format)
+	{
+		switch (format)
+		{
+		case PixelFormat_Palette8:	return 1;
+		case PixelFormat_BGR8:		return 3;
+		case PixelFormat_BGRA8:		return 4;
+		case PixelFormat_RGB16:		return 6;
+		case PixelFormat_RGBA16:	return 8;
+		case PixelFormat_RGBA32F:	return 16;
+		default:					return 0;
+		}
+	}
+
+	const char* Name(PixelFormat format)
+	{
+		switch (format)
+		{
+		case PixelFormat_Palette8:	return "palette 8";
+		case PixelFormat_BGR8:		return "BGR8";
+		case PixelFormat_BGRA8:		return "BGRA8";
+		case PixelFormat_RGB16:		return "RGB16";
+		case PixelFormat_RGBA16:	return "RGBA16";
+		case PixelFormat_RGBA32F:	return "RGBA32F (HDR)";
+		default:					return "";
+		}
+	}
+
+	// A decoded image the way FreeImage keeps it, bottom row first
+	struct Image
+	{
+		unsigned int width	= 0;
+		unsigned int height	= 0;
+		PixelFormat format	= PixelFormat_Unknown;
+		vector<std::byte> pixels;
+		uint32_t palette[256];		// FreeImage's (BGRA in memory)
+		uint32_t paletteRGBA[256];	// The same colors for PixelConverter
+	};
+
+	void Image_Create(unsigned int size, PixelFormat format, Image* image)
+	{
+		image->width	= size;
+		image->height	= size;
+		image->format	= format;
+		image->pixels.resize((size_t)size * size * BytesPerPixel(format));
+
+		uint32_t random = 1;
+		if (format == PixelFormat_RGBA32F)
+		{
+			float* values = reinterpret_cast<float*>(image->pixels.data());
+			for (size_t i = 0; i < image->pixels.size() / sizeof(float); i++)
+			{
+				random		= random * 1664525u + 1013904223u;
+				values[i]	= (random >> 8) / 8388608.0f; // [0, 2), half of it gets clamped
+			}
+			return;
+		}
+
+		for (auto& value : image->pixels)
+		{
+			random	= random * 1664525u + 1013904223u;
+			value	= (std::byte)(random >> 24);
+		}
+		for (unsigned int i = 0; i < 256; i++)
+		{
+			uint8_t bgra[4]	= { (uint8_t)(i * 3), (uint8_t)(i * 5), (uint8_t)(i * 7), (uint8_t)(255 - i) };
+			uint8_t rgba[4]	= { bgra[2], bgra[1], bgra[0], bgra[3] };
+			memcpy(&image->palette[i], bgra, 4);
+			memcpy(&image->paletteRGBA[i], rgba, 4);
+		}
+	}
+
+	// The old ImageImporter: FreeImage_FlipVertical(), FreeImage_ConvertTo32Bits() (a copy, pixel by pixel) unless the
+	// image already is 32-bit, then GetBitsFromFIBITMAP() which emplace_back()s every channel. Float images failed to convert.
+	bool Convert_Old(Image& image, vector<std::byte>* data)
+	{
+		if (image.format == PixelFormat_RGBA32F)
+			return false;
+
+		unsigned int width	= image.width;
+		unsigned int height	= image.height;
+		size_t pitch		= (size_t)width * BytesPerPixel(image.format);
+
+		// Flip, in place a line at a time
+		vector<std::byte> line(pitch);
+		for (unsigned int y = 0; y < height / 2; y++)
+		{
+			std::byte* top		= image.pixels.data() + y * pitch;
+			std::byte* bottom	= image.pixels.data() + (height - 1 - y) * pitch;
+			memcpy(line.data(), top, pitch);
+			memcpy(top, bottom, pitch);
+			memcpy(bottom, line.data(), pitch);
+		}
+
+		// To 32-bit
+		vector<std::byte> converted;
+		const std::byte* bits = image.pixels.data();
+		if (image.format != PixelFormat_BGRA8)
+		{
+			converted.resize((size_t)width * height * 4);
+			for (size_t i = 0; i < (size_t)width * height; i++)
+			{
+				const std::byte* source		= image.pixels.data() + i * BytesPerPixel(image.format);
+				const uint16_t* source16	= reinterpret_cast<const uint16_t*>(source);
+				std::byte* target			= converted.data() + i * 4;
+				switch (image.format)
+				{
+				case PixelFormat_Palette8:
+					memcpy(target, &image.palette[(uint8_t)source[0]], 4);
+					break;
+				case PixelFormat_BGR8:
+					target[g_blue] = source[0]; target[g_green] = source[1]; target[g_red] = source[2]; target[g_alpha] = (std::byte)255;
+					break;
+				case PixelFormat_RGB16:
+				case PixelFormat_RGBA16:
+					target[g_red]	= (std::byte)(source16[0] >> 8);
+					target[g_green]	= (std::byte)(source16[1] >> 8);
+					target[g_blue]	= (std::byte)(source16[2] >> 8);
+					target[g_alpha]	= (std::byte)(image.format == PixelFormat_RGBA16 ? source16[3] >> 8 : 255);
+					break;
+				default:
+					break;
+				}
+			}
+			bits = converted.data();
+		}
+
+		// To RGBA
+		data->clear();
+		data->reserve((size_t)width * height * 4);
+		for (unsigned int y = 0; y < height; y++)
+		{
+			const std::byte* bytes = bits + (size_t)y * width * 4;
+			for (unsigned int x = 0; x < width; x++)
+			{
+				data->emplace_back(bytes[g_red]);
+				data->emplace_back(bytes[g_green]);
+				data->emplace_back(bytes[g_blue]);
+				data->emplace_back(bytes[g_alpha]);
+				bytes += 4;
+			}
+		}
+
+		return true;
+	}
+
+	// ImageImporter::GetBitsFromFIBITMAP(): the rows straight from the bitmap, bottom up, into a preallocated buffer
+	bool Convert_New(const Image& image, vector<std::byte>* data, Threading* threading)
+	{
+		ptrdiff_t pitch = (ptrdiff_t)image.width * BytesPerPixel(image.format);
+
+		PixelSource source;
+		source.width	= image.width;
+		source.height	= image.height;
+		source.format	= image.format;
+		source.pitch	= -pitch;
+		source.data		= image.pixels.data() + (image.height - 1) * pitch;
+		source.palette	= image.paletteRGBA;
+
+		data->resize((size_t)image.width * image.height * 4);
+		bool transparent = false;
+		return PixelConverter::Convert(source, data->data(), &transparent, threading);
+	}
+}
+
+// Converting decoded 8K images to the RGBA8 the importer keeps, the old way (flip, convert to 32-bit, then a channel
+// at a time through emplace_back, see Convert_Old) against PixelConverter, on one thread and on the worker threads.
+// Every format the old path handled gives identical results.
+//
+//   Bench_PixelConverter [size = 8192]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_PixelConverter;
+
+	unsigned int size = Benchmark::Argument(argc, argv, 1, 8192);
+
+	Context context;
+	Settings::Get().ThreadCountMax_Set(thread::hardware_concurrency());
+	Threading threading(&context);
+	threading.Initialize();
+
+	printf("%ux%u, %u hardware threads\n\n", size, size, thread::hardware_concurrency());
+	printf("%14s | %8s | %8s | %8s | %8s | %10s\n", "", "old ms", "new ms", "jobs ms", "speedup", "new MPix/s");
+
+	bool identical = true;
+	for (PixelFormat format : { PixelFormat_Palette8, PixelFormat_BGR8, PixelFormat_BGRA8, PixelFormat_RGB16, PixelFormat_RGBA16, PixelFormat_RGBA32F })
+	{
+		Image image;
+		Image_Create(size, format, &image);
+
+		// The new paths first, the old one flips the image in place
+		vector<std::byte> converted;
+		double timeNew	= Benchmark::Best(3, [&] { Convert_New(image, &converted, nullptr); });
+		double timeJobs	= Benchmark::Best(3, [&] { Convert_New(image, &converted, &threading); });
+
+		vector<std::byte> convertedOld;
+		bool old		= false;
+		double timeOld	= Benchmark::Time([&] { old = Convert_Old(image, &convertedOld); });
+		identical		= identical && (!old || convertedOld == converted);
+
+		double megapixels = (double)size * size / 1e6;
+		if (old)
+		{
+			printf("%14s | %8.1f | %8.1f | %8.1f | %8.1f | %10.0f\n", Name(format), timeOld, timeNew, timeJobs, timeOld / timeJobs, megapixels / timeNew * 1000.0);
+		}
+		else
+		{
+			printf("%14s | %8s | %8.1f | %8.1f | %8s | %10.0f\n", Name(format), "-", timeNew, timeJobs, "-", megapixels / timeNew * 1000.0);
+		}
+	}
+
+	if (!identical)
+	{
+		printf("The conversions differ from the old ones\n");
+		return 1;
+	}
+
+	return 0;
+}
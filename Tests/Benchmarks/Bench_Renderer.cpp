@@ -0,0 +1,143 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================
+#include "Benchmark.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include "Core/Context.h"
+#include "Core/EventSystem.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "Profiling/Profiler.h"
+#include "Resource/ResourceManager.h"
+#include "Rendering/Renderer.h"
+#include "World/World.h"
+#include "World/Actor.h"
+#include "World/Components/Renderable.h"
+#include "World/Components/Transform.h"
+//======================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//============================
+
+namespace _Bench_Renderer
+{
+	// The engine's subsystems that take part in a frame, on the Null RHI
+	class Engine
+	{
+	public:
+		Engine()
+		{
+			FileSystem::Initialize();
+
+			// The context deletes its subsystems except for the first one (normally the engine)
+			m_context	= make_unique<Context>();
+			m_threading	= make_unique<Threading>(m_context.get());
+			m_context->RegisterSubsystem(m_threading.get());
+			m_threading->Initialize();
+			auto resourceManager = new ResourceManager(m_context.get());
+			m_context->RegisterSubsystem(resourceManager);
+			resourceManager->Initialize();
+			m_renderer = new Renderer(m_context.get(), nullptr);
+			m_context->RegisterSubsystem(m_renderer);
+			m_renderer->Initialize();
+			m_world = new World(m_context.get());
+			m_context->RegisterSubsystem(m_world);
+			m_world->Initialize();
+		}
+
+		~Engine()
+		{
+			m_context.reset();
+			m_threading.reset();
+			EventSystem::Get().Clear();
+		}
+
+		Renderer* GetRenderer()	{ return m_renderer; }
+		World* GetWorld()		{ return m_world; }
+
+	private:
+		unique_ptr<Context> m_context;
+		unique_ptr<Threading> m_threading;
+		Renderer* m_renderer	= nullptr;
+		World* m_world			= nullptr;
+	};
+
+	// Cubes on a square grid centred on the camera, the ones behind it still cast shadows
+	void Cubes_Add(World* world, unsigned int count)
+	{
+		unsigned int side = (unsigned int)ceil(sqrt((double)count));
+		for (unsigned int i = 0; i < count; i++)
+		{
+			auto actor = world->Actor_CreateAdd().lock();
+			actor->GetTransform_PtrRaw()->SetPosition(Vector3(((float)(i % side) - side * 0.5f) * 3.0f, 0.0f, ((float)(i / side) - side * 0.5f) * 3.0f));
+			auto renderable = actor->AddComponent<Renderable>().lock();
+			renderable->Geometry_Set(Geometry_Default_Cube);
+			renderable->Material_UseDefault();
+		}
+	}
+}
+
+// CPU time of a frame, from culling to the last (recorded, never executed) draw call, as the scene grows.
+//   Bench_Renderer [max objects = 50000] [frames = 20]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_Renderer;
+
+	unsigned int maxObjects = Benchmark::Argument(argc, argv, 1, 50000);
+	unsigned int frames		= Benchmark::Argument(argc, argv, 2, 20);
+
+	printf("%9s | %11s | %9s | %11s %11s\n", "objects", "resolve ms", "draws", "frame ms", "best ms");
+	for (unsigned int count : { 1000u, 10000u, 50000u, 100000u })
+	{
+		if (count > maxObjects)
+			break;
+
+		Engine engine;
+		Cubes_Add(engine.GetWorld(), count);
+		double resolve = Benchmark::Time([&]
+		{
+			FIRE_EVENT(EVENT_SCENE_RESOLVE_START);
+			FIRE_EVENT(EVENT_TICK);
+		});
+
+		// Shaders compile on the worker threads and a pass is skipped until its shader is built
+		unsigned int draws = 0;
+		for (unsigned int i = 0, same = 0; i < 3000 && same < 10; i++)
+		{
+			this_thread::sleep_for(chrono::milliseconds(10));
+			engine.GetRenderer()->Render();
+			same	= Profiler::Get().m_rhiDrawCalls == draws ? same + 1 : 0;
+			draws	= Profiler::Get().m_rhiDrawCalls;
+		}
+
+		double total	= Benchmark::Time([&] { for (unsigned int i = 0; i < frames; i++) engine.GetRenderer()->Render(); });
+		double best		= Benchmark::Best(frames, [&] { engine.GetRenderer()->Render(); });
+		printf("%9u | %11.2f | %9u | %11.3f %11.3f\n", count, resolve, draws, total / frames, best);
+	}
+
+	return 0;
+}
@@ -0,0 +1,182 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ======================
+#include "Benchmark.h"
+#include <map>
+#include <thread>
+#include <atomic>
+#include "Core/Context.h"
+#include "Resource/ResourceCache.h"
+//=================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace _Bench_ResourceCache
+{
+	class Asset : public IResource
+	{
+	public:
+		Asset(Context* context, Resource_Type type, const string& name) : IResource(context, type)
+		{
+			SetResourceName(name);
+			SetResourceFilePath("Project/Assets/" + name + ".asset");
+		}
+	};
+
+	// The cache the hashed one replaced: a list per type, every lookup walks it
+	class OldCache
+	{
+	public:
+		void Add(const shared_ptr<IResource>& resource) { m_resourceGroups[resource->GetResourceType()].push_back(resource); }
+
+		shared_ptr<IResource> GetByName(const string& name, Resource_Type type)
+		{
+			for (const auto& resource : m_resourceGroups[type])
+			{
+				if (name == resource->GetResourceName())
+					return resource;
+			}
+			return nullptr;
+		}
+
+		shared_ptr<IResource> GetByPath(const string& path, Resource_Type type)
+		{
+			for (const auto& resource : m_resourceGroups[type])
+			{
+				if (path == resource->GetResourceFilePath())
+					return resource;
+			}
+			return nullptr;
+		}
+
+		shared_ptr<IResource> GetByID(unsigned int id)
+		{
+			for (const auto& group : m_resourceGroups)
+			{
+				for (const auto& resource : group.second)
+				{
+					if (resource->Resource_GetID() == id)
+						return resource;
+				}
+			}
+			return nullptr;
+		}
+
+	private:
+		map<Resource_Type, vector<shared_ptr<IResource>>> m_resourceGroups;
+	};
+
+	const Resource_Type types[] = { Resource_Texture, Resource_Material, Resource_Model, Resource_Audio };
+}
+
+// Lookups by name, path and ID in a cache of 100k resources (spread over 4 types), the old per-type lists against the
+// hashed indices. The old cache only gets a sample of the lookups, each of them walks a list. Misses count lookups that
+// didn't return the resource they asked for, they should be 0. The last table enumerates a type with GetByType while
+// another thread keeps adding resources, which used to hand out a vector that the adding thread reallocated.
+//
+//   Bench_ResourceCache [resources = 100000] [old lookups = 2000]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_ResourceCache;
+
+	unsigned int count		= Benchmark::Argument(argc, argv, 1, 100000);
+	unsigned int oldCount	= Benchmark::Argument(argc, argv, 2, 2000);
+
+	Context context;
+	vector<shared_ptr<IResource>> assets;
+	assets.reserve(count);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		assets.emplace_back(make_shared<Asset>(&context, types[i % 4], "asset_" + to_string(i)));
+	}
+
+	OldCache oldCache;
+	ResourceCache cache;
+	double addOld = Benchmark::Time([&] { for (const auto& asset : assets) oldCache.Add(asset); });
+	double addNew = Benchmark::Time([&] { for (const auto& asset : assets) cache.Add(asset); });
+
+	// The same keys in the same (scattered) order for both
+	vector<unsigned int> order(count);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		order[i] = (unsigned int)((i * 2654435761ull) % count);
+	}
+	oldCount = oldCount < count ? oldCount : count;
+
+	unsigned int misses = 0;
+	auto measure = [&](unsigned int lookups, auto&& lookup)
+	{
+		return Benchmark::Time([&]
+		{
+			for (unsigned int i = 0; i < lookups; i++)
+			{
+				const auto& asset = assets[order[i]];
+				misses += lookup(asset) != asset ? 1 : 0;
+			}
+		}) * 1000000.0 / lookups;
+	};
+
+	printf("%9s | %12s %12s | %8s\n", "lookup", "old ns", "new ns", "speedup");
+	double oldTime = measure(oldCount, [&](const shared_ptr<IResource>& asset) { return oldCache.GetByName(asset->GetResourceName(), asset->GetResourceType()); });
+	double newTime = measure(count, [&](const shared_ptr<IResource>& asset) { return cache.GetByName(asset->GetResourceName(), asset->GetResourceType()); });
+	printf("%9s | %12.1f %12.1f | %7.0fx\n", "name", oldTime, newTime, oldTime / newTime);
+	oldTime = measure(oldCount, [&](const shared_ptr<IResource>& asset) { return oldCache.GetByPath(asset->GetResourceFilePath(), asset->GetResourceType()); });
+	newTime = measure(count, [&](const shared_ptr<IResource>& asset) { return cache.GetByPath(asset->GetResourceFilePath(), asset->GetResourceType()); });
+	printf("%9s | %12.1f %12.1f | %7.0fx\n", "path", oldTime, newTime, oldTime / newTime);
+	oldTime = measure(oldCount, [&](const shared_ptr<IResource>& asset) { return oldCache.GetByID(asset->Resource_GetID()); });
+	newTime = measure(count, [&](const shared_ptr<IResource>& asset) { return cache.GetByID(asset->Resource_GetID()); });
+	printf("%9s | %12.1f %12.1f | %7.0fx\n", "id", oldTime, newTime, oldTime / newTime);
+	printf("%9s | %12.1f %12.1f |\n", "add (ms)", addOld, addNew);
+	printf("misses: %u\n\n", misses);
+
+	// Enumeration while a loader thread adds resources of the same type
+	atomic<bool> loading = true;
+	thread loader([&]
+	{
+		for (unsigned int i = 0; loading; i++)
+		{
+			cache.Add(make_shared<Asset>(&context, Resource_Texture, "loaded_" + to_string(i)));
+		}
+	});
+	unsigned int enumerations	= 100;
+	uint64_t enumerated			= 0;
+	double enumerate = Benchmark::Time([&]
+	{
+		for (unsigned int i = 0; i < enumerations; i++)
+		{
+			for (const auto& resource : cache.GetByType(Resource_Texture))
+			{
+				enumerated += resource->GetResourceType() == Resource_Texture ? 1 : 0;
+			}
+		}
+	});
+	loading = false;
+	loader.join();
+	printf("%12s | %12s %12s\n", "GetByType", "ms", "resources");
+	printf("%12s | %12.3f %12llu\n", "textures", enumerate / enumerations, (unsigned long long)(enumerated / enumerations));
+
+	return 0;
+}
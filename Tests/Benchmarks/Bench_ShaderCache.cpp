@@ -0,0 +1,132 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ==========================================
+#include "Benchmark.h"
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/EventSystem.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "Resource/ResourceManager.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/Deferred/ShaderVariation.h"
+#include "Rendering/Deferred/ShaderVariationRegistry.h"
+#include "RHI/RHI_Device.h"
+#include "RHI/RHI_ShaderCache.h"
+//=====================================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace _Bench_ShaderCache
+{
+	struct Session
+	{
+		double startup			= 0.0;
+		double shutdown			= 0.0;
+		RHI_ShaderCacheStats stats;
+	};
+
+	// Starts the engine, requests a G-Buffer variation per material permutation (as the materials of a loaded scene do)
+	// and waits for all of them to be built, then shuts down (which saves the cache)
+	Session Session_Run(unsigned int permutations)
+	{
+		Session session;
+		unique_ptr<Context> context;
+		unique_ptr<Threading> threading;
+		Renderer* renderer = nullptr;
+
+		session.startup = Benchmark::Time([&]
+		{
+			// The context deletes its subsystems except for the first one (normally the engine)
+			context		= make_unique<Context>();
+			threading	= make_unique<Threading>(context.get());
+			context->RegisterSubsystem(threading.get());
+			threading->Initialize();
+			auto resourceManager = new ResourceManager(context.get());
+			context->RegisterSubsystem(resourceManager);
+			resourceManager->Initialize();
+			renderer = new Renderer(context.get(), nullptr);
+			context->RegisterSubsystem(renderer);
+			renderer->Initialize();
+
+			// Every permutation of the 9 shader flags is distinct (263 is odd, so this walks all 512 of them)
+			vector<shared_ptr<ShaderVariation>> variations;
+			for (unsigned int i = 0; i < permutations; i++)
+			{
+				variations.emplace_back(renderer->GetShaderVariations()->Acquire((i * 263) % 512));
+			}
+			for (const auto& variation : variations)
+			{
+				while (variation->GetState() != Shader_Built && variation->GetState() != Shader_Failed)
+				{
+					this_thread::sleep_for(chrono::microseconds(100));
+				}
+			}
+		});
+		session.stats = renderer->GetRHIDevice()->GetShaderCache()->GetStats();
+
+		session.shutdown = Benchmark::Time([&]
+		{
+			context.reset();
+			threading.reset();
+		});
+		EventSystem::Get().Clear();
+
+		return session;
+	}
+}
+
+// Engine startup with the shader cache cold (no cache file) and warm (the file of the previous session), for a scene
+// with 200 material permutations. The Null backend has no compiler, so a miss costs nothing here but the lookup and
+// the store: the times are what the cache itself costs (hashing the sources and what they include, loading and saving
+// the file), while the misses are the shaders a D3D11 startup compiles, each a D3DCompileFromFile() call.
+//
+//   Bench_ShaderCache [permutations = 200]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_ShaderCache;
+
+	unsigned int permutations = Benchmark::Argument(argc, argv, 1, 200);
+
+	FileSystem::Initialize();
+	FileSystem::DeleteFile_("Project/Shader_Cache.bin");
+
+	printf("%u material permutations\n\n", permutations);
+	printf("%8s | %10s | %11s | %6s | %6s | %8s | %8s\n", "cache", "startup ms", "shutdown ms", "hits", "misses", "entries", "file KB");
+	for (const char* name : { "cold", "warm", "warm" })
+	{
+		Session session	= Session_Run(permutations);
+		error_code error;
+		uintmax_t fileSize = filesystem::file_size("Project/Shader_Cache.bin", error);
+		fileSize = error ? 0 : fileSize;
+		printf("%8s | %10.1f | %11.1f | %6u | %6u | %8u | %8.1f\n", name, session.startup, session.shutdown, session.stats.hits, session.stats.misses, session.stats.entryCount, fileSize / 1000.0);
+	}
+
+	FileSystem::DeleteFile_("Project/Shader_Cache.bin");
+
+	return 0;
+}
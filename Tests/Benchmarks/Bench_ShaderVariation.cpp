@@ -0,0 +1,193 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ==========================================
+#include "Benchmark.h"
+#include <vector>
+#include "Core/Context.h"
+#include "Core/EventSystem.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "Resource/ResourceManager.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/Material.h"
+#include "Rendering/Deferred/ShaderVariation.h"
+#include "Rendering/Deferred/ShaderVariationRegistry.h"
+#include "RHI/RHI_Texture.h"
+//=====================================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace _Bench_ShaderVariation
+{
+	// The flags of the first six texture types (albedo to occlusion), in the order of their bits
+	const unsigned int g_slotCount = 6;
+
+	// The flags a material asks for as it's constructed and then given its textures, one slot at a time
+	vector<unsigned long> Material_Requests(unsigned int permutation)
+	{
+		vector<unsigned long> requests = { 0 };
+		unsigned long flags = 0;
+		for (unsigned int slot = 0; slot < g_slotCount; slot++)
+		{
+			if (permutation & (1 << slot))
+			{
+				flags |= 1UL << slot;
+				requests.emplace_back(flags);
+			}
+		}
+		return requests;
+	}
+
+	// Material::GetOrCreateShader() before the registry: the variations were resources, found by comparing their flags
+	shared_ptr<ShaderVariation> Acquire_Old(Context* context, ResourceManager* resourceManager, unsigned long flags)
+	{
+		for (const auto& shader : resourceManager->GetResourcesByType<ShaderVariation>())
+		{
+			if (shader.lock()->GetShaderFlags() == flags)
+				return shader.lock();
+		}
+
+		auto shader = make_shared<ShaderVariation>(context->GetSubsystem<Renderer>()->GetRHIDevice(), context);
+		shader->Compile(resourceManager->GetStandardResourceDirectory(Resource_Shader) + "GBuffer.hlsl", flags);
+		shader->SetResourceName("ShaderVariation_" + to_string(shader->Resource_GetID()));
+		return shader->Cache<ShaderVariation>().lock();
+	}
+}
+
+// Loading 10k materials spread over 64 permutations (every combination of the first six texture slots). A material
+// requests its variation when it's constructed and again whenever a texture slot is set, the first request for
+// each combination compiles it (on the Null backend, which only goes through the shader cache). The old rows look the
+// variations up the way Material did before ShaderVariationRegistry, the materials row creates actual materials.
+//
+//   Bench_ShaderVariation [materials = 10000]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_ShaderVariation;
+
+	unsigned int materialCount = Benchmark::Argument(argc, argv, 1, 10000);
+
+	FileSystem::Initialize();
+
+	// The context deletes its subsystems except for the first one (normally the engine)
+	auto context	= make_unique<Context>();
+	auto threading	= make_unique<Threading>(context.get());
+	context->RegisterSubsystem(threading.get());
+	threading->Initialize();
+	auto resourceManager = new ResourceManager(context.get());
+	context->RegisterSubsystem(resourceManager);
+	resourceManager->Initialize();
+	auto renderer = new Renderer(context.get(), nullptr);
+	context->RegisterSubsystem(renderer);
+	renderer->Initialize();
+
+	{
+		vector<vector<unsigned long>> requests;
+		unsigned int requestCount = 0;
+		for (unsigned int i = 0; i < materialCount; i++)
+		{
+			requests.emplace_back(Material_Requests(i % 64));
+			requestCount += (unsigned int)requests.back().size();
+		}
+
+		ShaderVariationRegistry registry(context.get(), renderer->GetRHIDevice());
+		double loadOld = Benchmark::Time([&]
+		{
+			for (const auto& material : requests)
+			{
+				for (unsigned long flags : material)
+				{
+					Acquire_Old(context.get(), resourceManager, flags);
+				}
+			}
+		});
+		double loadNew = Benchmark::Time([&]
+		{
+			for (const auto& material : requests)
+			{
+				for (unsigned long flags : material)
+				{
+					registry.Acquire(flags);
+				}
+			}
+		});
+
+		// Every variation exists
+		double lookupOld = Benchmark::Best(5, [&]
+		{
+			for (const auto& material : requests)
+			{
+				Acquire_Old(context.get(), resourceManager, material.back());
+			}
+		});
+		double lookupNew = Benchmark::Best(5, [&]
+		{
+			for (const auto& material : requests)
+			{
+				registry.Acquire(material.back());
+			}
+		});
+
+		// Actual materials, through the renderer's registry
+		vector<shared_ptr<RHI_Texture>> textures;
+		for (unsigned int slot = 0; slot < g_slotCount; slot++)
+		{
+			textures.emplace_back(make_shared<RHI_Texture>(context.get()));
+		}
+		vector<shared_ptr<Material>> materials;
+		materials.reserve(materialCount);
+		double loadMaterials = Benchmark::Time([&]
+		{
+			for (unsigned int i = 0; i < materialCount; i++)
+			{
+				auto material = make_shared<Material>(context.get());
+				for (unsigned int slot = 0; slot < g_slotCount; slot++)
+				{
+					if ((i % 64) & (1 << slot))
+					{
+						material->SetTextureSlot((TextureType)(TextureType_Albedo + slot), textures[slot], false);
+					}
+				}
+				materials.emplace_back(material);
+			}
+		});
+
+		ShaderVariationStats stats		= registry.GetStats();
+		ShaderVariationStats statsLive	= renderer->GetShaderVariations()->GetStats();
+		unsigned int resources			= (unsigned int)resourceManager->GetResourcesByType<ShaderVariation>().size();
+		printf("%u materials, %u variation requests\n\n", materialCount, requestCount);
+		printf("%24s | %9s | %12s | %10s\n", "", "total ms", "ns / lookup", "variations");
+		printf("%24s | %9.2f | %12.0f | %10u\n", "load, old", loadOld, loadOld * 1e6 / requestCount, resources);
+		printf("%24s | %9.2f | %12.0f | %10u\n", "load, registry", loadNew, loadNew * 1e6 / requestCount, stats.permutationCount);
+		printf("%24s | %9.2f | %12.0f | %10s\n", "lookup, old", lookupOld, lookupOld * 1e6 / materialCount, "-");
+		printf("%24s | %9.2f | %12.0f | %10s\n", "lookup, registry", lookupNew, lookupNew * 1e6 / materialCount, "-");
+		printf("%24s | %9.2f | %12s | %10u\n", "materials (registry)", loadMaterials, "-", statsLive.permutationCount);
+		printf("\nRegistry memory: %.1f KB for %u permutations\n", stats.memoryUsage / 1000.0, stats.permutationCount);
+	}
+
+	context.reset();
+	threading.reset();
+	EventSystem::Get().Clear();
+
+	return 0;
+}
@@ -0,0 +1,203 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================================
+#include "Benchmark.h"
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/Settings.h"
+#include "Threading/Threading.h"
+#include "Resource/Import/TextureCompressor.h"
+//============================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus;
+//=============================
+
+namespace _Bench_TextureCompressor
+{
+	enum Content
+	{
+		Content_Color,
+		Content_Alpha,
+		Content_Gray,
+		Content_Normal
+	};
+
+	class Noise
+	{
+	public:
+		Noise()
+		{
+			uint32_t random = 1;
+			for (float& value : m_values)
+			{
+				random	= random * 1664525u + 1013904223u;
+				value	= (random >> 8) / 16777216.0f;
+			}
+		}
+
+		// Smoothly interpolated value noise at a frequency
+		float Value(float u, float v, float frequency) const
+		{
+			float fx = u * frequency, fy = v * frequency;
+			unsigned int ix	= (unsigned int)fx % 256;
+			unsigned int iy	= (unsigned int)fy % 256;
+			float tx = fx - floorf(fx), ty = fy - floorf(fy);
+			tx = tx * tx * (3.0f - 2.0f * tx);
+			ty = ty * ty * (3.0f - 2.0f * ty);
+			float top		= m_values[iy * 257 + ix] * (1.0f - tx) + m_values[iy * 257 + ix + 1] * tx;
+			float bottom	= m_values[(iy + 1) * 257 + ix] * (1.0f - tx) + m_values[(iy + 1) * 257 + ix + 1] * tx;
+			return top * (1.0f - ty) + bottom * ty;
+		}
+
+		// A few octaves, detail down to the texel
+		float Fractal(float u, float v) const
+		{
+			return 0.5f * Value(u, v, 8.0f) + 0.25f * Value(u, v, 32.0f) + 0.125f * Value(u, v, 128.0f) + 0.125f * Value(u, v, 255.0f);
+		}
+
+	private:
+		float m_values[257 * 257];
+	};
+
+	// Albedo like color (with sharp inverted patches), the same with a cutout alpha, a height map and its normal map
+	vector<std::byte> Image_Create(const Noise& noise, unsigned int size, Content content)
+	{
+		vector<std::byte> image((size_t)size * size * 4);
+		for (unsigned int y = 0; y < size; y++)
+		{
+			for (unsigned int x = 0; x < size; x++)
+			{
+				float u			= x / (float)size;
+				float v			= y / (float)size;
+				float height	= noise.Fractal(u, v);
+				float color[4]	= { height, height, height, 1.0f };
+				if (content == Content_Normal)
+				{
+					float step	= 1.0f / size;
+					float dx	= (noise.Fractal(u + step, v) - height) * size * 0.05f;
+					float dy	= (noise.Fractal(u, v + step) - height) * size * 0.05f;
+					float length = sqrtf(dx * dx + dy * dy + 1.0f);
+					color[0] = -dx / length * 0.5f + 0.5f;
+					color[1] = -dy / length * 0.5f + 0.5f;
+					color[2] = 1.0f / length * 0.5f + 0.5f;
+				}
+				else if (content != Content_Gray)
+				{
+					color[1] = 0.6f * noise.Value(u, v, 16.0f) + 0.4f * height;
+					color[2] = 0.3f + 0.4f * noise.Value(u + 0.3f, v, 64.0f);
+					color[0] = ((x / 8 + y / 8) % 9) == 0 ? 1.0f - height : height;
+					color[3] = (content == Content_Alpha && height <= 0.5f) ? 0.2f : 1.0f;
+				}
+
+				std::byte* texel = &image[((size_t)y * size + x) * 4];
+				for (unsigned int i = 0; i < 4; i++)
+				{
+					texel[i] = (std::byte)(unsigned char)(color[i] * 255.0f + 0.5f);
+				}
+			}
+		}
+		return image;
+	}
+
+	// Of the channels [first, last)
+	double PSNR(const vector<std::byte>& a, const vector<std::byte>& b, unsigned int first, unsigned int last)
+	{
+		double error	= 0.0;
+		size_t count	= 0;
+		for (size_t i = 0; i < a.size(); i += 4)
+		{
+			for (unsigned int channel = first; channel < last; channel++)
+			{
+				double difference = (double)(unsigned char)a[i + channel] - (double)(unsigned char)b[i + channel];
+				error += difference * difference;
+				count++;
+			}
+		}
+		error /= (double)count;
+		return error == 0.0 ? 99.0 : 10.0 * log10(255.0 * 255.0 / error);
+	}
+}
+
+// Encoding speed and the PSNR of the decoded result for every format and quality, on the content each format is
+// chosen for. The threaded column runs the rows of blocks through the threading subsystem.
+//
+//   Bench_TextureCompressor [size = 1024]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_TextureCompressor;
+
+	unsigned int size = Benchmark::Argument(argc, argv, 1, 1024);
+	size = size < 4 ? 4 : size - size % 4;
+
+	Context context;
+	Settings::Get().ThreadCountMax_Set(thread::hardware_concurrency());
+	Threading threading(&context);
+	threading.Initialize();
+
+	struct Case
+	{
+		const char* name;
+		Content content;
+		Texture_Format format;
+		unsigned int firstChannel;
+		unsigned int lastChannel;
+	};
+	const Case cases[] =
+	{
+		{ "BC1 color",	Content_Color,	Texture_Format_BC1_UNORM, 0, 3 },
+		{ "BC3 color",	Content_Alpha,	Texture_Format_BC3_UNORM, 0, 3 },
+		{ "BC3 alpha",	Content_Alpha,	Texture_Format_BC3_UNORM, 3, 4 },
+		{ "BC4 gray",	Content_Gray,	Texture_Format_BC4_UNORM, 0, 1 },
+		{ "BC5 normal",	Content_Normal,	Texture_Format_BC5_UNORM, 0, 2 },
+		{ "BC7 color",	Content_Color,	Texture_Format_BC7_UNORM, 0, 3 },
+		{ "BC7 rgba",	Content_Alpha,	Texture_Format_BC7_UNORM, 0, 4 },
+	};
+	const char* qualities[] = { "none", "fast", "normal", "high" };
+
+	Noise noise;
+	printf("%ux%u, %u hardware threads\n\n", size, size, thread::hardware_concurrency());
+	printf("format     | quality | PSNR dB | MP/s   | MP/s threaded |\n");
+	for (const auto& test : cases)
+	{
+		auto image = Image_Create(noise, size, test.content);
+		for (unsigned int quality = TextureCompression_Fast; quality <= TextureCompression_High; quality++)
+		{
+			vector<vector<std::byte>> mips = { image };
+			vector<vector<std::byte>> blocks;
+			double time			= Benchmark::Time([&] { TextureCompressor::Compress(mips, size, size, test.format, (TextureCompression)quality, &blocks); });
+			double timeThreaded	= Benchmark::Time([&] { TextureCompressor::Compress(mips, size, size, test.format, (TextureCompression)quality, &blocks, &threading); });
+
+			vector<std::byte> decoded(image.size());
+			TextureCompressor::Decompress(blocks[0].data(), size, size, test.format, decoded.data());
+
+			double megapixels = (double)size * size / 1000000.0;
+			printf("%-10s | %-7s | %7.2f | %6.1f | %13.1f |\n", test.name, qualities[quality],
+				PSNR(image, decoded, test.firstChannel, test.lastChannel), megapixels / (time / 1000.0), megapixels / (timeThreaded / 1000.0));
+		}
+	}
+
+	return 0;
+}
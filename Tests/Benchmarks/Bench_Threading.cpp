@@ -0,0 +1,196 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==================
+#include "Benchmark.h"
+#include <queue>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include "Core/Context.h"
+#include "Core/Settings.h"
+#include "Threading/Threading.h"
+//=============================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+//========================
+
+namespace _Bench_Threading
+{
+	// The task queue the job system replaced: one queue behind one mutex, a heap allocated std::function per task and no
+	// way to wait on a task, callers count completions themselves.
+	class TaskQueue
+	{
+	public:
+		TaskQueue(unsigned int threadCount)
+		{
+			for (unsigned int i = 0; i < threadCount; i++)
+			{
+				m_threads.emplace_back([this]
+				{
+					while (true)
+					{
+						unique_lock<mutex> lock(m_mutex);
+						m_conditionVar.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+						if (m_stopping && m_tasks.empty())
+							return;
+
+						auto task = m_tasks.front();
+						m_tasks.pop();
+						lock.unlock();
+						(*task)();
+					}
+				});
+			}
+		}
+
+		~TaskQueue()
+		{
+			{
+				lock_guard<mutex> lock(m_mutex);
+				m_stopping = true;
+			}
+			m_conditionVar.notify_all();
+			for (auto& thread : m_threads)
+			{
+				thread.join();
+			}
+		}
+
+		template <typename Function>
+		void AddTask(Function&& task)
+		{
+			unique_lock<mutex> lock(m_mutex);
+			m_tasks.push(make_shared<function<void()>>(bind(forward<Function>(task))));
+			lock.unlock();
+			m_conditionVar.notify_one();
+		}
+
+	private:
+		vector<thread> m_threads;
+		queue<shared_ptr<function<void()>>> m_tasks;
+		mutex m_mutex;
+		condition_variable m_conditionVar;
+		bool m_stopping = false;
+	};
+
+	// About a microsecond of work
+	inline void SmallJob(atomic<uint64_t>& sink, unsigned int seed)
+	{
+		uint64_t value = seed;
+		for (unsigned int i = 0; i < 200; i++)
+		{
+			value = value * 6364136223846793005ull + 1442695040888963407ull;
+		}
+		sink.fetch_add(value & 1, memory_order_relaxed);
+	}
+}
+
+// Throughput of empty and small jobs, the old task queue against the job system, at 1 to 64 worker threads.
+// The job system's submitting thread also runs jobs while it waits, the old queue's spins until its tasks are counted.
+//
+//   Bench_Threading [jobs = 1000000] [max threads = 64]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_Threading;
+
+	unsigned int jobCount	= Benchmark::Argument(argc, argv, 1, 1000000);
+	unsigned int maxThreads	= Benchmark::Argument(argc, argv, 2, 64);
+	printf("%u jobs, %u hardware threads\n\n", jobCount, thread::hardware_concurrency());
+	printf("threads | old empty  | new empty  | old small  | new small  | (million jobs per second)\n");
+
+	Context context;
+	for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		double rates[4];
+		for (unsigned int small = 0; small < 2; small++)
+		{
+			atomic<uint64_t> sink = 0;
+
+			// Old
+			{
+				TaskQueue queue(threads);
+				atomic<unsigned int> done = 0;
+				double time = Benchmark::Time([&]
+				{
+					for (unsigned int i = 0; i < jobCount; i++)
+					{
+						queue.AddTask([&, i] { if (small) SmallJob(sink, i); done.fetch_add(1, memory_order_release); });
+					}
+					while (done.load(memory_order_acquire) != jobCount)
+					{
+						this_thread::yield();
+					}
+				});
+				rates[small * 2] = jobCount / time / 1000.0;
+			}
+
+			// New
+			{
+				Settings::Get().ThreadCountMax_Set(threads + 1);
+				Threading threading(&context);
+				threading.Initialize();
+
+				vector<JobHandle> jobs;
+				jobs.reserve(jobCount);
+				double time = Benchmark::Time([&]
+				{
+					for (unsigned int i = 0; i < jobCount; i++)
+					{
+						jobs.emplace_back(threading.AddTask([&, i] { if (small) SmallJob(sink, i); }));
+					}
+					threading.Wait(jobs);
+				});
+				rates[small * 2 + 1] = jobCount / time / 1000.0;
+			}
+		}
+		printf("%7u | %10.2f | %10.2f | %10.2f | %10.2f |\n", threads, rates[0], rates[1], rates[2], rates[3]);
+	}
+
+	// Waiting on results and dependencies, which the old queue couldn't express
+	{
+		Settings::Get().ThreadCountMax_Set(thread::hardware_concurrency());
+		Threading threading(&context);
+		threading.Initialize();
+
+		atomic<uint64_t> sum = 0;
+		double time = Benchmark::Time([&]
+		{
+			threading.ParallelFor(0, jobCount, [&](unsigned int i) { sum.fetch_add(i, memory_order_relaxed); });
+		});
+		printf("\nParallelFor over %u iterations: %.2f ms\n", jobCount, time);
+
+		time = Benchmark::Time([&]
+		{
+			JobHandle previous;
+			for (unsigned int i = 0; i < jobCount / 10; i++)
+			{
+				previous = previous ? threading.AddTask([] {}, { previous }) : threading.AddTask([] {});
+			}
+			threading.Wait(previous);
+		});
+		printf("A chain of %u dependent jobs: %.2f ms\n", jobCount / 10, time);
+	}
+
+	return 0;
+}
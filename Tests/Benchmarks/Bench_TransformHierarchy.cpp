@@ -0,0 +1,264 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "Benchmark.h"
+#include <memory>
+#include <random>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/GUIDGenerator.h"
+#include "FileSystem/FileSystem.h"
+#include "Threading/Threading.h"
+#include "Profiling/Profiler.h"
+#include "World/World.h"
+#include "World/TransformHierarchy.h"
+#include "World/Components/Transform.h"
+//=====================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//=============================
+
+// Transform.cpp and TransformHierarchy.cpp are linked as they are, but the world, the component base and the profiler
+// pull in the rest of the engine (and its third party libraries). These stand in for the parts the two use.
+namespace Directus
+{
+	World::World(Context* context) : Subsystem(context) { m_transformHierarchy = make_unique<TransformHierarchy>(context); }
+	World::~World() {}
+	bool World::Initialize() { return true; }
+
+	IComponent::IComponent(Context* context, Actor* actor, Transform* transform)
+	{
+		m_context	= context;
+		m_actor		= actor;
+		m_transform	= transform;
+		m_enabled	= true;
+		m_ID		= GENERATE_GUID;
+	}
+	const string& IComponent::GetActorName() { return NOT_ASSIGNED; }
+
+	Profiler::Profiler() {}
+	void Profiler::TimeBlockStart_CPU(const char* funcName) {}
+	void Profiler::TimeBlockEnd_CPU(const char* funcName) {}
+}
+
+namespace _Bench_TransformHierarchy
+{
+	// The transform before the flat hierarchy: every setter recomputes the world matrix of the transform
+	// and of its whole subtree right away, recursively.
+	class OldTransform
+	{
+	public:
+		void SetPositionLocal(const Vector3& position)		{ if (m_position == position) return; m_position = position; UpdateTransform(); }
+		void SetRotationLocal(const Quaternion& rotation)	{ if (m_rotation == rotation) return; m_rotation = rotation; UpdateTransform(); }
+		void SetScaleLocal(const Vector3& scale)			{ if (m_scale == scale) return; m_scale = scale; UpdateTransform(); }
+
+		void SetParent(OldTransform* parent)
+		{
+			m_parent = parent;
+			m_parent->m_children.emplace_back(this);
+			UpdateTransform();
+		}
+
+		const Matrix& GetWorldTransform() { return m_world; }
+
+	private:
+		void UpdateTransform()
+		{
+			m_local = Matrix(m_position, m_rotation, m_scale);
+			m_world = m_parent ? m_local * m_parent->m_world : m_local;
+			for (const auto& child : m_children)
+			{
+				child->UpdateTransform();
+			}
+		}
+
+		Vector3 m_position		= Vector3::Zero;
+		Quaternion m_rotation	= Quaternion(0, 0, 0, 1);
+		Vector3 m_scale			= Vector3::One;
+		Matrix m_local			= Matrix::Identity;
+		Matrix m_world			= Matrix::Identity;
+		OldTransform* m_parent	= nullptr;
+		vector<OldTransform*> m_children;
+	};
+
+	struct Change
+	{
+		unsigned int index;
+		Vector3 position;
+		Quaternion rotation;
+		Vector3 scale;
+	};
+
+	// Applies a frame of changes to either kind of transform, only the components that differ from the current ones
+	// call their setter, so the frames where only positions move don't touch the rotations and the scales.
+	template <typename TransformType>
+	void Apply(vector<TransformType*>& transforms, const vector<Change>& changes, bool rotateAndScale)
+	{
+		for (const auto& change : changes)
+		{
+			transforms[change.index]->SetPositionLocal(change.position);
+			if (rotateAndScale)
+			{
+				transforms[change.index]->SetRotationLocal(change.rotation);
+				transforms[change.index]->SetScaleLocal(change.scale);
+			}
+		}
+	}
+}
+
+// Per frame cost of the transform update on a mixed depth scene, the old recursive update against the flat hierarchy.
+// A hundredth of the transforms are roots, the rest hang under a root (props), under a random transform or under
+// the previous one (chains, like skeletons). Each case runs a number of frames, the old transforms update as the
+// setters are called, the new ones mark themselves dirty and TransformHierarchy::Update() runs once per frame.
+//
+//   Bench_TransformHierarchy [transforms = 100000] [frames = 100]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_TransformHierarchy;
+
+	unsigned int count	= Benchmark::Argument(argc, argv, 1, 100000);
+	unsigned int frames	= Benchmark::Argument(argc, argv, 2, 100);
+
+	// The context deletes its subsystems except for the first one (normally the engine), which lives on the stack
+	Context context;
+	Threading threading(&context);
+	context.RegisterSubsystem(&threading);
+	context.RegisterSubsystem(new World(&context));
+	threading.Initialize();
+	auto hierarchy = context.GetSubsystem<World>()->GetTransformHierarchy();
+
+	// The same scene twice
+	mt19937 random(1);
+	unsigned int rootCount = count / 100 > 0 ? count / 100 : 1;
+	vector<unsigned int> roots;
+	vector<unique_ptr<OldTransform>> oldOwned;
+	vector<unique_ptr<Transform>> newOwned;
+	vector<OldTransform*> oldTransforms;
+	vector<Transform*> newTransforms;
+	vector<unsigned int> depths(count, 0);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		oldOwned.emplace_back(make_unique<OldTransform>());
+		newOwned.emplace_back(make_unique<Transform>(&context, nullptr, nullptr));
+		oldTransforms.emplace_back(oldOwned.back().get());
+		newTransforms.emplace_back(newOwned.back().get());
+
+		if (i < rootCount)
+		{
+			roots.emplace_back(i);
+			continue;
+		}
+
+		unsigned int kind	= random() % 10;
+		unsigned int parent	= kind < 5 ? roots[random() % rootCount] : (kind < 8 ? (unsigned int)(random() % i) : i - 1);
+		oldTransforms[i]->SetParent(oldTransforms[parent]);
+		newTransforms[i]->SetParent(newTransforms[parent]);
+		depths[i] = depths[parent] + 1;
+	}
+	unsigned int depthMax = 0;
+	double depthSum = 0.0;
+	for (unsigned int depth : depths)
+	{
+		depthMax = depth > depthMax ? depth : depthMax;
+		depthSum += depth;
+	}
+	double sortTime = Benchmark::Time([&] { hierarchy->Update(); });
+	printf("%u transforms, %u roots, average depth %.1f, maximum depth %u, %u threads\n", count, rootCount, depthSum / count, depthMax, thread::hardware_concurrency());
+	printf("First update (sorts the hierarchy): %.2f ms\n\n", sortTime);
+	printf("case                            | old ms/frame | new ms/frame |\n");
+
+	struct Case
+	{
+		const char* name;
+		unsigned int changesPerFrame;
+		bool rootsOnly;
+		bool rotateAndScale;
+	};
+	const Case cases[] =
+	{
+		{ "1% of the transforms move",		count / 100,	false,	false },
+		{ "10% of the transforms move",		count / 10,		false,	false },
+		{ "every root moves",				rootCount,		true,	false },
+		{ "every root moves, turns, scales",rootCount,		true,	true },
+	};
+
+	for (const auto& test : cases)
+	{
+		// The changes of every frame, generated up front
+		vector<vector<Change>> changes(frames);
+		for (unsigned int frame = 0; frame < frames; frame++)
+		{
+			for (unsigned int i = 0; i < test.changesPerFrame; i++)
+			{
+				Change change;
+				change.index	= test.rootsOnly ? i : (unsigned int)(random() % count);
+				float t			= (float)(frame + 1);
+				change.position	= Vector3(t, (float)(change.index % 7), -t * 0.5f);
+				change.rotation	= Quaternion::FromEulerAngles(t, t * 2.0f, 0.0f);
+				change.scale	= Vector3(1.0f + t * 0.01f);
+				changes[frame].emplace_back(change);
+			}
+		}
+
+		double oldTime = Benchmark::Time([&]
+		{
+			for (const auto& frame : changes)
+			{
+				Apply(oldTransforms, frame, test.rotateAndScale);
+			}
+		});
+
+		double newTime = Benchmark::Time([&]
+		{
+			for (const auto& frame : changes)
+			{
+				Apply(newTransforms, frame, test.rotateAndScale);
+				hierarchy->Update();
+			}
+		});
+
+		printf("%-31s | %12.3f | %12.3f |\n", test.name, oldTime / frames, newTime / frames);
+	}
+
+	// Both have to end up with the same world matrices
+	float difference = 0.0f;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		Matrix newWorld	= newTransforms[i]->GetWorldTransform();
+		const float* a	= &oldTransforms[i]->GetWorldTransform().m00;
+		const float* b	= &newWorld.m00;
+		for (unsigned int j = 0; j < 16; j++)
+		{
+			float delta = a[j] > b[j] ? a[j] - b[j] : b[j] - a[j];
+			difference	= delta > difference ? delta : difference;
+		}
+	}
+	printf("\nLargest difference between the old and the new world matrices: %g\n", difference);
+
+	// The transforms unregister from the hierarchy, which belongs to the world
+	newOwned.clear();
+
+	return 0;
+}
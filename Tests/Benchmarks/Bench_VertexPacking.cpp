@@ -0,0 +1,179 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========================
+#include "Benchmark.h"
+#include <cmath>
+#include <random>
+#include <vector>
+#include "RHI/RHI_Vertex.h"
+#include "Math/BoundingBox.h"
+#include "Rendering/VertexPacking.h"
+#include "Rendering/GeometryUtility.h"
+//====================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//=============================
+
+namespace _Bench_VertexPacking
+{
+	void Normalize(float* vector)
+	{
+		float length = sqrtf(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			vector[i] /= length;
+		}
+	}
+
+	// In degrees, from the cross and the dot product (in double) as acos can't resolve small angles
+	double Angle(const float* a, const float* b)
+	{
+		double cross[3] =
+		{
+			(double)a[1] * b[2] - (double)a[2] * b[1],
+			(double)a[2] * b[0] - (double)a[0] * b[2],
+			(double)a[0] * b[1] - (double)a[1] * b[0]
+		};
+		double dot = (double)a[0] * b[0] + (double)a[1] * b[1] + (double)a[2] * b[2];
+		return atan2(sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot) * 57.29577951308232;
+	}
+
+	// Random positions within a 100 unit cube, uvs within [-4, 4] and orthonormal tangent frames of either handedness
+	vector<RHI_Vertex_PosUVTBN> Vertices_Random(unsigned int count)
+	{
+		mt19937 random(1);
+		uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		uniform_real_distribution<float> position(-50.0f, 50.0f);
+		uniform_real_distribution<float> uv(-4.0f, 4.0f);
+
+		vector<RHI_Vertex_PosUVTBN> vertices(count);
+		for (auto& vertex : vertices)
+		{
+			float normal[3]		= { unit(random), unit(random), unit(random) };
+			float tangent[3]	= { unit(random), unit(random), unit(random) };
+			Normalize(normal);
+			float dot = normal[0] * tangent[0] + normal[1] * tangent[1] + normal[2] * tangent[2];
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				tangent[i] -= normal[i] * dot;
+			}
+			Normalize(tangent);
+			float handedness = random() % 2 ? 1.0f : -1.0f;
+
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				vertex.pos[i]		= position(random);
+				vertex.normal[i]	= normal[i];
+				vertex.tangent[i]	= tangent[i];
+			}
+			vertex.uv[0]		= uv(random);
+			vertex.uv[1]		= uv(random);
+			vertex.bitangent[0]	= (normal[1] * tangent[2] - normal[2] * tangent[1]) * handedness;
+			vertex.bitangent[1]	= (normal[2] * tangent[0] - normal[0] * tangent[2]) * handedness;
+			vertex.bitangent[2]	= (normal[0] * tangent[1] - normal[1] * tangent[0]) * handedness;
+		}
+		return vertices;
+	}
+}
+
+// Pack and unpack throughput of the packed vertex layouts with their largest round trip errors, then the vertex
+// bytes of the built in geometry (Standard Assets has no models, these are the meshes the engine ships) per layout.
+//
+//   Bench_VertexPacking [vertices = 1000000]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_VertexPacking;
+
+	unsigned int count	= Benchmark::Argument(argc, argv, 1, 1000000);
+	auto vertices		= Vertices_Random(count);
+	BoundingBox bounds(vertices);
+
+	printf("%u random vertices, extent 100\n\n", count);
+	printf("layout  | bytes | pack Mverts/s | unpack Mverts/s | position | uv      | normal deg | tangent deg | bitangent deg |\n");
+	for (auto packing : { Vertex_Packing_Compact, Vertex_Packing_Small })
+	{
+		unsigned int stride = VertexPacking::GetStride(packing);
+		vector<std::byte> packed((size_t)count * stride);
+		vector<RHI_Vertex_PosUVTBN> unpacked(count);
+
+		double packTime		= Benchmark::Best(3, [&] { VertexPacking::Pack(vertices.data(), count, packing, bounds, packed.data()); });
+		double unpackTime	= Benchmark::Best(3, [&] { VertexPacking::Unpack(packed.data(), count, packing, bounds, unpacked.data()); });
+
+		float errorPosition = 0.0f, errorUV = 0.0f;
+		double errorNormal = 0.0, errorTangent = 0.0, errorBitangent = 0.0;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			for (unsigned int j = 0; j < 3; j++)
+			{
+				errorPosition = fmaxf(errorPosition, fabsf(unpacked[i].pos[j] - vertices[i].pos[j]));
+			}
+			for (unsigned int j = 0; j < 2; j++)
+			{
+				errorUV = fmaxf(errorUV, fabsf(unpacked[i].uv[j] - vertices[i].uv[j]));
+			}
+			errorNormal		= fmax(errorNormal, Angle(unpacked[i].normal, vertices[i].normal));
+			errorTangent	= fmax(errorTangent, Angle(unpacked[i].tangent, vertices[i].tangent));
+			errorBitangent	= fmax(errorBitangent, Angle(unpacked[i].bitangent, vertices[i].bitangent));
+		}
+
+		printf("%-7s | %5u | %13.1f | %15.1f | %8.5f | %7.5f | %10.4f | %11.4f | %13.4f |\n",
+			packing == Vertex_Packing_Compact ? "compact" : "small", stride,
+			count / packTime / 1000.0, count / unpackTime / 1000.0,
+			errorPosition, errorUV, errorNormal, errorTangent, errorBitangent
+		);
+	}
+
+	struct Geometry
+	{
+		const char* name;
+		void (*create)(vector<RHI_Vertex_PosUVTBN>*, vector<unsigned int>*);
+	};
+	const Geometry geometries[] =
+	{
+		{ "cube",		[](vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices) { GeometryUtility::CreateCube(vertices, indices); } },
+		{ "quad",		[](vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices) { GeometryUtility::CreateQuad(vertices, indices); } },
+		{ "sphere",		[](vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices) { GeometryUtility::CreateSphere(vertices, indices); } },
+		{ "cylinder",	[](vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices) { GeometryUtility::CreateCylinder(vertices, indices); } },
+		{ "cone",		[](vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices) { GeometryUtility::CreateCone(vertices, indices); } },
+	};
+
+	printf("\ngeometry | vertices | none bytes | compact bytes | small bytes | index bytes |\n");
+	for (const auto& geometry : geometries)
+	{
+		vector<RHI_Vertex_PosUVTBN> geometryVertices;
+		vector<unsigned int> geometryIndices;
+		geometry.create(&geometryVertices, &geometryIndices);
+
+		size_t vertexCount = geometryVertices.size();
+		printf("%-8s | %8zu | %10zu | %13zu | %11zu | %11zu |\n", geometry.name, vertexCount,
+			vertexCount * VertexPacking::GetStride(Vertex_Packing_None),
+			vertexCount * VertexPacking::GetStride(Vertex_Packing_Compact),
+			vertexCount * VertexPacking::GetStride(Vertex_Packing_Small),
+			geometryIndices.size() * sizeof(unsigned int)
+		);
+	}
+
+	return 0;
+}
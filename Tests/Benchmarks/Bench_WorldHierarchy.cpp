@@ -0,0 +1,162 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "Benchmark.h"
+#include <random>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/EventSystem.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "Resource/ResourceManager.h"
+#include "Rendering/Renderer.h"
+#include "World/World.h"
+#include "World/Actor.h"
+#include "World/Components/Transform.h"
+//=====================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace _Bench_WorldHierarchy
+{
+	const char* g_filePath = "Bench_WorldHierarchy.world";
+
+	// An empty world (initialized on this thread, which becomes its main thread) and the subsystems it needs
+	class Engine
+	{
+	public:
+		Engine()
+		{
+			FileSystem::Initialize();
+
+			// The context deletes its subsystems except for the first one (normally the engine)
+			m_context	= make_unique<Context>();
+			m_threading	= make_unique<Threading>(m_context.get());
+			m_context->RegisterSubsystem(m_threading.get());
+			m_threading->Initialize();
+			auto resourceManager = new ResourceManager(m_context.get());
+			m_context->RegisterSubsystem(resourceManager);
+			resourceManager->Initialize();
+			auto renderer = new Renderer(m_context.get(), nullptr);
+			m_context->RegisterSubsystem(renderer);
+			renderer->Initialize();
+			m_world = new World(m_context.get());
+			m_context->RegisterSubsystem(m_world);
+			m_world->Initialize();
+			m_world->Unload();
+		}
+
+		~Engine()
+		{
+			m_context.reset();
+			m_threading.reset();
+			EventSystem::Get().Clear();
+		}
+
+		World* GetWorld() { return m_world; }
+
+	private:
+		unique_ptr<Context> m_context;
+		unique_ptr<Threading> m_threading;
+		World* m_world = nullptr;
+	};
+
+	// 1% of the actors are roots, the rest pick a random parent among the ones before them (a tree of logarithmic depth)
+	vector<Transform*> Actors_Create(World* world, unsigned int count, mt19937& random)
+	{
+		vector<Transform*> transforms;
+		transforms.reserve(count);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			Transform* transform = world->Actor_CreateAdd().lock()->GetTransform_PtrRaw();
+			if (i % 100 != 0)
+			{
+				transform->SetParent(transforms[uniform_int_distribution<unsigned int>(0, i - 1)(random)]);
+			}
+			transforms.emplace_back(transform);
+		}
+		return transforms;
+	}
+}
+
+// Building, loading and reparenting a hierarchy. A child knows its slot in its parent's list and nothing scans
+// the world's actors any more, so the time per actor should stay flat as the world grows.
+//
+//   Bench_WorldHierarchy [max actors = 200000]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_WorldHierarchy;
+
+	unsigned int maxActors = Benchmark::Argument(argc, argv, 1, 200000);
+
+	printf("%9s | %10s %10s %10s %10s %10s %10s | %12s %12s\n", "actors", "build ms", "save ms", "load ms", "move 1% ms", "walk ms", "unload ms", "load ns/act", "move ns/act");
+	for (unsigned int count : { 10000u, 50000u, 200000u })
+	{
+		if (count > maxActors)
+			break;
+
+		Engine engine;
+		World* world = engine.GetWorld();
+		mt19937 random(count);
+
+		vector<Transform*> transforms;
+		double build	= Benchmark::Time([&] { transforms = Actors_Create(world, count, random); });
+		double save		= Benchmark::Time([&] { world->SaveToFile(g_filePath); });
+		double load		= Benchmark::Time([&] { world->LoadFromFile(g_filePath); });
+
+		// Reparenting 1% of the (loaded) actors, onto random actors, descendants included
+		transforms.clear();
+		for (const auto& actor : world->GetAllActors())
+		{
+			transforms.emplace_back(actor->GetTransform_PtrRaw());
+		}
+		unsigned int moves = count / 100;
+		uniform_int_distribution<unsigned int> pick(0, count - 1);
+		double move = Benchmark::Time([&]
+		{
+			for (unsigned int i = 0; i < moves; i++)
+			{
+				transforms[pick(random)]->SetParent(transforms[pick(random)]);
+			}
+		});
+
+		// Every root's descendants, depth first
+		vector<Transform*> descendants;
+		double walk = Benchmark::Time([&]
+		{
+			for (const auto& root : world->GetRootActors())
+			{
+				root.lock()->GetTransform_PtrRaw()->GetDescendants(&descendants);
+			}
+		});
+
+		double unload = Benchmark::Time([&] { world->Unload(); });
+		FileSystem::DeleteFile_(g_filePath);
+
+		printf("%9u | %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f | %12.0f %12.0f\n", count, build, save, load, move, walk, unload, load * 1e6 / count, move * 1e6 / moves);
+	}
+
+	return 0;
+}
@@ -0,0 +1,545 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "Benchmark.h"
+#include <functional>
+#include <thread>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/Hash.h"
+#include "Core/Settings.h"
+#include "Core/EventSystem.h"
+#include "IO/FileStream.h"
+#include "IO/Compression.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "Resource/ResourceManager.h"
+//===================================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+//========================
+
+// ResourceManager.cpp is linked as it is, but the importers it creates need FreeImage, Assimp and FreeType.
+// The benchmark loads its own resource type, so these stand in for them.
+namespace Directus
+{
+	ImageImporter::ImageImporter(Context* context) { m_context = context; }
+	ImageImporter::~ImageImporter() {}
+	ModelImporter::ModelImporter(Context* context) { m_context = context; }
+	FontImporter::FontImporter(Context* context) { m_context = context; }
+	FontImporter::~FontImporter() {}
+	void FontImporter::Initialize() {}
+}
+
+namespace _Bench_WorldLoad
+{
+	const char* g_directory			= "Bench_WorldLoad_Assets/";
+	const char* g_sectionActors		= "actors";
+	const char* g_sectionComponents	= "components";
+	const unsigned int g_childCount	= 49;
+
+	// Textures and models are LZ4 compressed blobs, loading one decompresses and hashes it. A material is a list of
+	// texture names, loading one binds them by looking them up in the resource manager, like Material does.
+	class Asset : public IResource
+	{
+	public:
+		Asset(Context* context) : IResource(context, Resource_Unknown) {}
+
+		bool LoadFromFile(const string& filePath) override
+		{
+			auto file = make_unique<FileStream>(filePath, FileStreamMode_Read);
+			if (!file->IsOpen())
+				return false;
+
+			if (FileSystem::IsEngineMaterialFile(filePath))
+			{
+				vector<string> textures;
+				file->Read(&textures);
+				auto resourceManager = m_context->GetSubsystem<ResourceManager>();
+				for (const auto& texture : textures)
+				{
+					m_unbound += resourceManager->GetResourceByName<Asset>(texture).expired() ? 1 : 0;
+				}
+				return true;
+			}
+
+			unsigned int size = file->ReadUInt();
+			vector<std::byte> compressed;
+			file->Read(&compressed);
+			m_data.resize(size);
+			if (!Compression::LZ4_Decompress(compressed.data(), compressed.size(), m_data.data(), m_data.size()))
+				return false;
+
+			m_hash = Hash::Compute(m_data.data(), m_data.size());
+			return true;
+		}
+
+		unsigned int GetMemoryUsage() override { return (unsigned int)m_data.size(); }
+		unsigned int GetUnboundTextures() { return m_unbound; }
+
+	private:
+		vector<std::byte> m_data;
+		uint64_t m_hash			= 0;
+		unsigned int m_unbound	= 0;
+	};
+}
+
+namespace Directus
+{
+	template<> Resource_Type IResource::DeduceResourceType<_Bench_WorldLoad::Asset>() { return Resource_Unknown; }
+}
+
+namespace _Bench_WorldLoad
+{
+	// What the actors are loaded into, a transform and a renderable worth of data per actor
+	struct Component
+	{
+		unsigned int type	= 0;
+		unsigned int id		= 0;
+		float values[10]	= {};
+		string material;
+		string model;
+	};
+
+	struct Actor
+	{
+		unsigned int id		= 0;
+		string name;
+		bool isActive		= true;
+		bool isVisible		= true;
+		Actor* parent		= nullptr;
+		vector<Actor*> children;
+		vector<unique_ptr<Component>> components;
+	};
+
+	struct World
+	{
+		vector<unique_ptr<Actor>> actors;
+
+		Actor* Add()
+		{
+			actors.emplace_back(make_unique<Actor>());
+			return actors.back().get();
+		}
+	};
+
+	// Two components per actor
+	void Components_Write(FileStream* file, unsigned int actorID, unsigned int materialCount, unsigned int modelCount)
+	{
+		for (unsigned int i = 0; i < 2; i++)
+		{
+			for (unsigned int j = 0; j < 10; j++)
+			{
+				file->Write((float)(actorID + j));
+			}
+			file->Write(string(g_directory) + "m" + to_string(actorID % materialCount) + EXTENSION_MATERIAL);
+			file->Write("mo" + to_string(actorID % modelCount));
+		}
+	}
+
+	void Component_Read(FileStream* file, Component* component)
+	{
+		for (float& value : component->values)
+		{
+			file->Read(&value);
+		}
+		file->Read(&component->material);
+		file->Read(&component->model);
+	}
+
+	void Blob_Write(const string& filePath, unsigned int size, unsigned int seed)
+	{
+		vector<std::byte> data(size);
+		uint32_t random = seed + 1;
+		for (unsigned int i = 0; i < size; i++)
+		{
+			random	= random * 1664525u + 1013904223u;
+			data[i]	= (std::byte)(((i / 4 + seed) & 0xFF) + ((random >> 29) & 3));
+		}
+		vector<std::byte> compressed(Compression::LZ4_CompressBound(size));
+		compressed.resize(Compression::LZ4_Compress(data.data(), size, compressed.data(), compressed.size()));
+
+		auto file = make_unique<FileStream>(filePath, FileStreamMode_Write);
+		file->Write(size);
+		file->Write(compressed);
+	}
+
+	// The resources, then the same world in the layout the old loader reads (actors nested in their parents) and in
+	// the flat one World::SaveToFile() writes now (an actor section and a component section, parents by index)
+	void World_Write(unsigned int actorCount, unsigned int textureCount)
+	{
+		FileSystem::CreateDirectory_(g_directory);
+
+		unsigned int modelCount		= textureCount / 6 > 0 ? textureCount / 6 : 1;
+		unsigned int materialCount	= textureCount / 2 > 0 ? textureCount / 2 : 1;
+		vector<string> paths;
+		for (unsigned int i = 0; i < textureCount; i++)
+		{
+			paths.emplace_back(g_directory + ("t" + to_string(i)) + EXTENSION_TEXTURE);
+			Blob_Write(paths.back(), 256 * 1024, i);
+		}
+		for (unsigned int i = 0; i < modelCount; i++)
+		{
+			paths.emplace_back(g_directory + ("mo" + to_string(i)) + EXTENSION_MODEL);
+			Blob_Write(paths.back(), 1024 * 1024, textureCount + i);
+		}
+		for (unsigned int i = 0; i < materialCount; i++)
+		{
+			paths.emplace_back(g_directory + ("m" + to_string(i)) + EXTENSION_MATERIAL);
+			auto file = make_unique<FileStream>(paths.back(), FileStreamMode_Write);
+			file->Write(vector<string>{ "t" + to_string(i), "t" + to_string((i * 7 + 1) % textureCount) });
+		}
+
+		unsigned int rootCount = actorCount / (g_childCount + 1) > 0 ? actorCount / (g_childCount + 1) : 1;
+
+		// Old, see Actor::Deserialize()
+		{
+			auto file = make_unique<FileStream>(string(g_directory) + "old" + EXTENSION_WORLD, FileStreamMode_Write);
+			file->Write(paths);
+			file->Write(rootCount);
+			for (unsigned int i = 0; i < rootCount; i++)
+			{
+				file->Write(i);
+			}
+
+			auto Actor_Write = [&](unsigned int id, unsigned int childCount)
+			{
+				file->Write(true);
+				file->Write(true);
+				file->Write(id);
+				file->Write("actor" + to_string(id));
+				file->Write(2);
+				for (unsigned int i = 0; i < 2; i++)
+				{
+					file->Write(i);
+					file->Write(id * 2 + i);
+				}
+				Components_Write(file.get(), id, materialCount, modelCount);
+				file->Write(childCount);
+			};
+
+			unsigned int id = rootCount;
+			for (unsigned int root = 0; root < rootCount; root++)
+			{
+				Actor_Write(root, g_childCount);
+				for (unsigned int i = 0; i < g_childCount; i++)
+				{
+					file->Write(id + i);
+				}
+				for (unsigned int i = 0; i < g_childCount; i++)
+				{
+					Actor_Write(id + i, 0);
+				}
+				id += g_childCount;
+			}
+		}
+
+		// New, see World::Actors_Read() and World::Actors_Create()
+		{
+			auto file = make_unique<FileStream>(string(g_directory) + "new" + EXTENSION_WORLD, FileStreamMode_Write);
+			file->Write(paths);
+
+			vector<unsigned int> order;
+			file->Section_Begin(g_sectionActors);
+			file->Write(rootCount * (g_childCount + 1));
+			auto Record_Write = [&](unsigned int id, int parent)
+			{
+				file->Write(id);
+				file->Write("actor" + to_string(id));
+				file->Write(true);
+				file->Write(true);
+				file->Write(parent);
+				file->Write(2u);
+				for (unsigned int i = 0; i < 2; i++)
+				{
+					file->Write(i);
+					file->Write(id * 2 + i);
+				}
+				order.emplace_back(id);
+			};
+			unsigned int id = rootCount;
+			for (unsigned int root = 0; root < rootCount; root++)
+			{
+				int rootIndex = (int)order.size();
+				Record_Write(root, -1);
+				for (unsigned int i = 0; i < g_childCount; i++)
+				{
+					Record_Write(id++, rootIndex);
+				}
+			}
+
+			file->Section_Begin(g_sectionComponents);
+			for (unsigned int actorID : order)
+			{
+				Components_Write(file.get(), actorID, materialCount, modelCount);
+			}
+		}
+	}
+
+	// A context with the subsystems the resource manager needs
+	class Engine
+	{
+	public:
+		Engine()
+		{
+			Settings::Get().ThreadCountMax_Set(thread::hardware_concurrency());
+			m_context	= make_unique<Context>();
+			m_threading	= make_unique<Threading>(m_context.get());
+			// The context deletes its subsystems except for the first one (normally the engine)
+			m_context->RegisterSubsystem(m_threading.get());
+			m_threading->Initialize();
+
+			m_resourceManager = new ResourceManager(m_context.get());
+			m_context->RegisterSubsystem(m_resourceManager);
+			m_resourceManager->Initialize();
+		}
+
+		~Engine()
+		{
+			// The resource manager waits for its loads, so it goes before the threads
+			m_context.reset();
+			m_threading.reset();
+			// It also subscribed to the engine's events
+			EventSystem::Get().Clear();
+		}
+
+		Threading* GetThreading()				{ return m_threading.get(); }
+		ResourceManager* GetResourceManager()	{ return m_resourceManager; }
+
+	private:
+		unique_ptr<Context> m_context;
+		unique_ptr<Threading> m_threading;
+		ResourceManager* m_resourceManager;
+	};
+
+	unsigned int UnboundTextures(ResourceManager* resourceManager)
+	{
+		unsigned int unbound = 0;
+		for (const auto& asset : resourceManager->GetResourcesByType<Asset>())
+		{
+			unbound += asset.lock()->GetUnboundTextures();
+		}
+		return unbound;
+	}
+
+	// The loader before the phases: every resource one after the other, then the actors recursively
+	void Load_Old(Engine* engine, World* world)
+	{
+		auto file = make_unique<FileStream>(string(g_directory) + "old" + EXTENSION_WORLD, FileStreamMode_Read);
+
+		vector<string> paths;
+		file->Read(&paths);
+		double resources = Benchmark::Time([&]
+		{
+			for (const auto& path : paths)
+			{
+				engine->GetResourceManager()->Load<Asset>(path);
+			}
+		});
+
+		double actors = Benchmark::Time([&]
+		{
+			function<void(Actor*, Actor*)> Actor_Read = [&](Actor* actor, Actor* parent)
+			{
+				file->Read(&actor->isActive);
+				file->Read(&actor->isVisible);
+				file->Read(&actor->id);
+				file->Read(&actor->name);
+				actor->components.resize(file->ReadInt());
+				for (auto& component : actor->components)
+				{
+					component = make_unique<Component>();
+					file->Read(&component->type);
+					file->Read(&component->id);
+				}
+				for (auto& component : actor->components)
+				{
+					Component_Read(file.get(), component.get());
+				}
+				actor->parent = parent;
+				if (parent)
+				{
+					parent->children.emplace_back(actor);
+				}
+
+				vector<Actor*> children(file->ReadInt());
+				for (auto& child : children)
+				{
+					child		= world->Add();
+					child->id	= file->ReadUInt();
+				}
+				for (auto& child : children)
+				{
+					Actor_Read(child, actor);
+				}
+			};
+
+			int rootCount = file->ReadInt();
+			for (int i = 0; i < rootCount; i++)
+			{
+				world->Add()->id = file->ReadInt();
+			}
+			for (int i = 0; i < rootCount; i++)
+			{
+				Actor_Read(world->actors[i].get(), nullptr);
+			}
+		});
+
+		printf("  resources %.0f ms, actors %.0f ms\n", resources, actors);
+	}
+
+	// The phases of World::LoadFromFile(): the structure into flat records, the resources as jobs (materials after
+	// the textures they bind) and the actors in one pass
+	void Load_New(Engine* engine, World* world)
+	{
+		struct Record
+		{
+			unsigned int id;
+			string name;
+			bool isActive;
+			bool isVisible;
+			int parent;
+			vector<pair<unsigned int, unsigned int>> components;
+		};
+
+		auto file = make_unique<FileStream>(string(g_directory) + "new" + EXTENSION_WORLD, FileStreamMode_Read);
+
+		vector<string> paths;
+		vector<Record> records;
+		double structure = Benchmark::Time([&]
+		{
+			file->Read(&paths);
+			file->Section_Seek(g_sectionActors);
+			records.resize(file->ReadUInt());
+			for (auto& record : records)
+			{
+				file->Read(&record.id);
+				file->Read(&record.name);
+				file->Read(&record.isActive);
+				file->Read(&record.isVisible);
+				file->Read(&record.parent);
+				record.components.resize(file->ReadUInt());
+				for (auto& component : record.components)
+				{
+					file->Read(&component.first);
+					file->Read(&component.second);
+				}
+			}
+		});
+
+		double resources = Benchmark::Time([&]
+		{
+			auto threading			= engine->GetThreading();
+			auto resourceManager	= engine->GetResourceManager();
+
+			vector<JobHandle> textures;
+			for (const auto& path : paths)
+			{
+				if (FileSystem::IsEngineTextureFile(path))
+				{
+					textures.emplace_back(threading->AddTask([resourceManager, &path]() { resourceManager->Load<Asset>(path); }));
+				}
+			}
+
+			vector<JobHandle> jobs = textures;
+			for (const auto& path : paths)
+			{
+				if (FileSystem::IsEngineTextureFile(path))
+					continue;
+
+				bool isMaterial = FileSystem::IsEngineMaterialFile(path);
+				jobs.emplace_back(threading->AddTask([resourceManager, &path]() { resourceManager->Load<Asset>(path); }, isMaterial ? textures : vector<JobHandle>()));
+			}
+
+			threading->Wait(jobs);
+		});
+
+		double commit = Benchmark::Time([&]
+		{
+			file->Section_Seek(g_sectionComponents);
+			world->actors.reserve(records.size());
+			for (unsigned int i = 0; i < (unsigned int)records.size(); i++)
+			{
+				const Record& record	= records[i];
+				Actor* actor			= world->Add();
+				actor->id				= record.id;
+				actor->name				= record.name;
+				actor->isActive			= record.isActive;
+				actor->isVisible		= record.isVisible;
+				for (const auto& created : record.components)
+				{
+					actor->components.emplace_back(make_unique<Component>());
+					actor->components.back()->type	= created.first;
+					actor->components.back()->id	= created.second;
+				}
+				for (auto& component : actor->components)
+				{
+					Component_Read(file.get(), component.get());
+				}
+				if (record.parent >= 0 && (unsigned int)record.parent < i)
+				{
+					actor->parent = world->actors[record.parent].get();
+					actor->parent->children.emplace_back(actor);
+				}
+			}
+		});
+
+		printf("  structure %.0f ms, resources %.0f ms, actors %.0f ms\n", structure, resources, commit);
+	}
+}
+
+// Loads the same world with the old loader and with the phased one. The resources go through ResourceManager::Load()
+// either way, the actors are plain structures as the engine's actors and components need the whole engine.
+//
+//   Bench_WorldLoad [actors = 50000] [textures = 600] (plus a model for every 6 textures and a material for every 2)
+int main(int argc, char** argv)
+{
+	using namespace _Bench_WorldLoad;
+
+	unsigned int actorCount		= Benchmark::Argument(argc, argv, 1, 50000);
+	unsigned int textureCount	= Benchmark::Argument(argc, argv, 2, 600);
+
+	World_Write(actorCount, textureCount);
+	printf("%u hardware threads\n", thread::hardware_concurrency());
+
+	for (unsigned int loader = 0; loader < 2; loader++)
+	{
+		Engine engine;
+		World world;
+		printf("%s loader\n", loader == 0 ? "Old" : "New");
+		double time = Benchmark::Time([&] { loader == 0 ? Load_Old(&engine, &world) : Load_New(&engine, &world); });
+
+		size_t componentCount = 0;
+		for (const auto& actor : world.actors)
+		{
+			componentCount += actor->components.size();
+		}
+		auto resourceCount = engine.GetResourceManager()->GetResourcesByType<Asset>().size();
+		printf("  %.0f ms in total, %zu actors, %zu components, %zu resources, %u unbound textures\n", time, world.actors.size(), componentCount, resourceCount, UnboundTextures(engine.GetResourceManager()));
+	}
+
+	FileSystem::DeleteDirectory(g_directory);
+
+	return 0;
+}
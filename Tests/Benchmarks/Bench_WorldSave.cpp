@@ -0,0 +1,131 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ==========================
+#include "Benchmark.h"
+#include <random>
+#include <vector>
+#include <filesystem>
+#include "Core/Context.h"
+#include "Core/EventSystem.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "Resource/ResourceManager.h"
+#include "Rendering/Renderer.h"
+#include "World/World.h"
+#include "World/Actor.h"
+#include "World/Components/Transform.h"
+//=====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//============================
+
+namespace _Bench_WorldSave
+{
+	const char* g_fileDelta	= "Bench_WorldSave_Delta.world";
+	const char* g_fileFull	= "Bench_WorldSave_Full.world";
+
+	uint64_t File_Size(const char* filePath)
+	{
+		return FileSystem::FileExists(filePath) ? (uint64_t)filesystem::file_size(filePath) : 0;
+	}
+}
+
+// Autosaving a 100k actor world (1% roots, the rest under a random earlier actor) after each of a few rounds of moving 1%
+// of its actors. Each save appends a delta to the file the last one wrote, until the deltas make up half of the file and
+// it is compacted (written in full). The last row writes the same world in full, what every save used to do.
+//
+//   Bench_WorldSave [actors = 100000] [rounds = 5]
+int main(int argc, char** argv)
+{
+	using namespace _Bench_WorldSave;
+
+	unsigned int count	= Benchmark::Argument(argc, argv, 1, 100000);
+	unsigned int rounds	= Benchmark::Argument(argc, argv, 2, 5);
+
+	FileSystem::Initialize();
+
+	// The context deletes its subsystems except for the first one (normally the engine)
+	auto context	= make_unique<Context>();
+	auto threading	= make_unique<Threading>(context.get());
+	context->RegisterSubsystem(threading.get());
+	threading->Initialize();
+	auto resourceManager = new ResourceManager(context.get());
+	context->RegisterSubsystem(resourceManager);
+	resourceManager->Initialize();
+	auto renderer = new Renderer(context.get(), nullptr);
+	context->RegisterSubsystem(renderer);
+	renderer->Initialize();
+	auto world = new World(context.get());
+	context->RegisterSubsystem(world);
+	world->Initialize();
+	world->Unload();
+
+	mt19937 random(1);
+	vector<Transform*> transforms;
+	transforms.reserve(count);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		Transform* transform = world->Actor_CreateAdd().lock()->GetTransform_PtrRaw();
+		if (i % 100 != 0)
+		{
+			transform->SetParent(transforms[uniform_int_distribution<unsigned int>(0, i - 1)(random)]);
+		}
+		transforms.emplace_back(transform);
+	}
+
+	double first = Benchmark::Time([&] { world->SaveToFile(g_fileDelta); });
+	printf("%u actors, first save %.0f ms, %.1f MB\n", count, first, File_Size(g_fileDelta) / 1e6);
+	printf("%8s | %10s %12s %12s\n", "save", "ms", "written KB", "file KB");
+
+	uniform_int_distribution<unsigned int> pick(0, count - 1);
+	uniform_real_distribution<float> offset(-1.0f, 1.0f);
+	for (unsigned int round = 0; round < rounds; round++)
+	{
+		for (unsigned int i = 0; i < count / 100; i++)
+		{
+			Transform* transform = transforms[pick(random)];
+			transform->SetPositionLocal(transform->GetPositionLocal() + Vector3(offset(random), offset(random), offset(random)));
+		}
+
+		// A compaction writes the whole file
+		uint64_t before	= File_Size(g_fileDelta);
+		double time		= Benchmark::Time([&] { world->SaveToFile(g_fileDelta); });
+		uint64_t after	= File_Size(g_fileDelta);
+		uint64_t written	= after > before ? after - before : after;
+		printf("%8s | %10.1f %12.1f %12.1f\n", ("delta " + to_string(round)).c_str(), time, written / 1e3, after / 1e3);
+	}
+
+	// The last world again, to a file it wasn't saved to (so in full)
+	double time = Benchmark::Time([&] { world->SaveToFile(g_fileFull); });
+	printf("%8s | %10.1f %12.1f %12.1f\n", "full", time, File_Size(g_fileFull) / 1e3, File_Size(g_fileFull) / 1e3);
+
+	FileSystem::DeleteFile_(g_fileDelta);
+	FileSystem::DeleteFile_(g_fileFull);
+
+	context.reset();
+	threading.reset();
+	EventSystem::Get().Clear();
+
+	return 0;
+}
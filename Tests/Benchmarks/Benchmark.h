@@ -0,0 +1,61 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+//================
+
+// The benchmarks are plain executables that print a table, they take their sizes from the command line so that
+// the defaults (the sizes the requests asked for) can be scaled down on small machines.
+namespace Directus::Benchmark
+{
+	// Milliseconds taken by function
+	template <typename Function>
+	double Time(Function&& function)
+	{
+		auto start = std::chrono::steady_clock::now();
+		function();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// The fastest of a few runs, in milliseconds
+	template <typename Function>
+	double Best(unsigned int runs, Function&& function)
+	{
+		double best = 0.0;
+		for (unsigned int i = 0; i < runs; i++)
+		{
+			double time = Time(function);
+			best		= (i == 0 || time < best) ? time : best;
+		}
+		return best;
+	}
+
+	// The index-th command line argument as a number, or value when it's missing
+	inline unsigned int Argument(int argc, char** argv, int index, unsigned int value)
+	{
+		return index < argc ? (unsigned int)std::strtoul(argv[index], nullptr, 10) : value;
+	}
+}
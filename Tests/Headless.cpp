@@ -0,0 +1,121 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================================================
+#include <string>
+#include "Core/Engine.h"
+#include "Audio/Audio.h"
+#include "Scripting/Scripting.h"
+#include "Scripting/ScriptInstance.h"
+#include "World/Components/AudioSource.h"
+#include "World/Components/Collider.h"
+#include "World/Components/Constraint.h"
+#include "World/Components/RigidBody.h"
+#include "Resource/Import/ImageImporter.h"
+#include "Resource/Import/ModelImporter.h"
+#include "Resource/Import/FontImporter.h"
+#include "RHI/RHI_Texture.h"
+#include <BulletDynamics/ConstraintSolver/btTypedConstraint.h>
+//============================================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+// The renderer and the world are linked as they are, but the importers, audio, physics and scripting they reach
+// need FreeImage, Assimp, FreeType, FMOD, Bullet and AngelScript. These stand in for them: images load as a small white
+// texture, models and fonts fail to load, audio, physics and scripts do nothing. There is no engine either, only its flags.
+namespace Directus
+{
+	unsigned long Engine::m_flags = 0;
+
+	ImageImporter::ImageImporter(Context* context) { m_context = context; }
+	ImageImporter::~ImageImporter() {}
+	bool ImageImporter::Load(const string& filePath, RHI_Texture* texInfo)
+	{
+		texInfo->SetWidth(4);
+		texInfo->SetHeight(4);
+		texInfo->SetChannels(4);
+		texInfo->SetBPP(32);
+		texInfo->GetData().emplace_back(vector<std::byte>(4 * 4 * 4, std::byte{255}));
+		return true;
+	}
+
+	ModelImporter::ModelImporter(Context* context) { m_context = context; }
+	bool ModelImporter::Load(Model* model, const string& filePath) { return false; }
+
+	FontImporter::FontImporter(Context* context) { m_context = context; }
+	FontImporter::~FontImporter() {}
+	void FontImporter::Initialize() {}
+	bool FontImporter::LoadFromFile(const string& filePath, int fontSize, vector<std::byte>& atlasBuffer, unsigned int& atlasWidth, unsigned int& atlasHeight, map<unsigned int, Glyph>& characterInfo) { return false; }
+
+	Audio::Audio(Context* context) : Subsystem(context) {}
+	Audio::~Audio() {}
+	bool Audio::Initialize() { return true; }
+	void Audio::SetListenerTransform(Transform* transform) {}
+
+	Scripting::Scripting(Context* context) : Subsystem(context) {}
+	Scripting::~Scripting() {}
+	bool Scripting::Initialize() { return true; }
+
+	ScriptInstance::ScriptInstance() {}
+	ScriptInstance::~ScriptInstance() {}
+	bool ScriptInstance::Instantiate(const string& path, weak_ptr<Actor> actor, Scripting* scriptEngine) { return false; }
+	void ScriptInstance::ExecuteStart() {}
+	void ScriptInstance::ExecuteUpdate() {}
+
+	AudioSource::AudioSource(Context* context, Actor* actor, Transform* transform) : IComponent(context, actor, transform) {}
+	AudioSource::~AudioSource() {}
+	void AudioSource::OnInitialize() {}
+	void AudioSource::OnStart() {}
+	void AudioSource::OnStop() {}
+	void AudioSource::OnRemove() {}
+	void AudioSource::OnTick() {}
+	void AudioSource::Serialize(FileStream* stream) {}
+	void AudioSource::Deserialize(FileStream* stream) {}
+
+	Collider::Collider(Context* context, Actor* actor, Transform* transform) : IComponent(context, actor, transform) {}
+	Collider::~Collider() {}
+	void Collider::OnInitialize() {}
+	void Collider::OnRemove() {}
+	void Collider::OnTick() {}
+	void Collider::Serialize(FileStream* stream) {}
+	void Collider::Deserialize(FileStream* stream) {}
+
+	Constraint::Constraint(Context* context, Actor* actor, Transform* transform) : IComponent(context, actor, transform) {}
+	Constraint::~Constraint() {}
+	void Constraint::OnInitialize() {}
+	void Constraint::OnStart() {}
+	void Constraint::OnStop() {}
+	void Constraint::OnRemove() {}
+	void Constraint::OnTick() {}
+	void Constraint::Serialize(FileStream* stream) {}
+	void Constraint::Deserialize(FileStream* stream) {}
+
+	RigidBody::RigidBody(Context* context, Actor* actor, Transform* transform) : IComponent(context, actor, transform) {}
+	RigidBody::~RigidBody() {}
+	void RigidBody::OnInitialize() {}
+	void RigidBody::OnRemove() {}
+	void RigidBody::OnStart() {}
+	void RigidBody::OnTick() {}
+	void RigidBody::Serialize(FileStream* stream) {}
+	void RigidBody::Deserialize(FileStream* stream) {}
+}
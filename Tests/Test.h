@@ -0,0 +1,48 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==
+#include <cstdio>
+//=============
+
+// The tests are plain executables, a failed check is reported and counted and main returns non zero if there were any
+namespace Directus::Test
+{
+	inline int& Failures()
+	{
+		static int failures = 0;
+		return failures;
+	}
+}
+
+#define TEST_CHECK(condition)																	\
+	do																							\
+	{																							\
+		if (!(condition))																		\
+		{																						\
+			std::printf("%s(%d): Check failed: %s\n", __FILE__, __LINE__, #condition);		\
+			Directus::Test::Failures()++;														\
+		}																						\
+	} while (false)
+
+#define TEST_RESULT() (Directus::Test::Failures() == 0 ? 0 : 1)
@@ -0,0 +1,197 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES =====================
+#include "Test.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "IO/Compression.h"
+#include "FileSystem/FileSystem.h"
+#include "FileSystem/PackFile.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace
+{
+	uint32_t g_random = 1;
+
+	uint32_t Random()
+	{
+		g_random = g_random * 1664525u + 1013904223u;
+		return g_random >> 8;
+	}
+
+	// Noise, short repeats (overlapping matches), a few symbols and long runs, the cases the codec treats differently
+	vector<uint8_t> Data(size_t size, unsigned int kind)
+	{
+		vector<uint8_t> data(size);
+		for (size_t i = 0; i < size; i++)
+		{
+			switch (kind % 4)
+			{
+				case 0: data[i] = (uint8_t)Random(); break;
+				case 1: data[i] = (uint8_t)(i % 7); break;
+				case 2: data[i] = (uint8_t)(Random() % 3); break;
+				case 3: data[i] = (uint8_t)((i / 300) % 5 + (Random() % 50 == 0 ? 1 : 0)); break;
+			}
+		}
+		return data;
+	}
+
+	vector<uint8_t> Compress(const vector<uint8_t>& data)
+	{
+		vector<uint8_t> compressed(Compression::LZ4_CompressBound(data.size()));
+		compressed.resize(Compression::LZ4_Compress(data.data(), data.size(), compressed.data(), compressed.size()));
+		return compressed;
+	}
+
+	bool RoundTrips(const vector<uint8_t>& data)
+	{
+		vector<uint8_t> compressed = Compress(data);
+		vector<uint8_t> decompressed(data.size());
+		return !compressed.empty() && Compression::LZ4_Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()) && decompressed == data;
+	}
+}
+
+int main()
+{
+	// Round trip, from nothing to more than the 64 KB a match can reach back
+	{
+		// Nothing compresses to a single token
+		uint8_t none[1]		= {};
+		uint8_t token[16]	= {};
+		TEST_CHECK(Compression::LZ4_Compress(none, 0, token, sizeof(token)) == 1);
+		TEST_CHECK(Compression::LZ4_Decompress(token, 1, none, 0));
+		for (size_t size : { 1, 5, 12, 13, 100, 4096, 65535, 65536, 300000 })
+		{
+			for (unsigned int kind = 0; kind < 4; kind++)
+			{
+				TEST_CHECK(RoundTrips(Data(size, kind)));
+			}
+		}
+
+		// Repetitive data compresses, noise doesn't grow past the bound
+		vector<uint8_t> runs = Data(65536, 1);
+		TEST_CHECK(Compress(runs).size() < runs.size() / 10);
+		vector<uint8_t> noise = Data(65536, 0);
+		TEST_CHECK(Compress(noise).size() <= Compression::LZ4_CompressBound(noise.size()));
+
+		// A destination smaller than the bound is refused
+		vector<uint8_t> small(noise.size());
+		TEST_CHECK(Compression::LZ4_Compress(noise.data(), noise.size(), small.data(), small.size()) == 0);
+	}
+
+	// Corrupted input fails (or decodes to something else) without writing past the destination
+	{
+		vector<uint8_t> data		= Data(20000, 3);
+		vector<uint8_t> compressed	= Compress(data);
+
+		// The destination has to be exactly the decompressed size, a guard after it catches overruns
+		const uint8_t guard = 0xCD;
+		vector<uint8_t> decompressed(data.size() + 64, guard);
+		auto Decompress = [&](const vector<uint8_t>& source, size_t size)
+		{
+			return Compression::LZ4_Decompress(source.data(), source.size(), decompressed.data(), size);
+		};
+		auto Guarded = [&]()
+		{
+			for (size_t i = data.size(); i < decompressed.size(); i++)
+			{
+				if (decompressed[i] != guard)
+					return false;
+			}
+			return true;
+		};
+
+		TEST_CHECK(Decompress(compressed, data.size()));
+		TEST_CHECK(!Decompress(compressed, data.size() - 1));
+		TEST_CHECK(Guarded());
+
+		// Truncated anywhere
+		for (size_t size : { (size_t)1, (size_t)2, compressed.size() / 2, compressed.size() - 1 })
+		{
+			TEST_CHECK(!Decompress(vector<uint8_t>(compressed.begin(), compressed.begin() + size), data.size()));
+			TEST_CHECK(Guarded());
+		}
+
+		// A match that reaches back before the start of the output
+		const uint8_t badOffset[] = { 0x14, 'a', 0xFF, 0x00, 0x10, 'b' };
+		TEST_CHECK(!Compression::LZ4_Decompress(badOffset, sizeof(badOffset), decompressed.data(), 10));
+		const uint8_t zeroOffset[] = { 0x14, 'a', 0x00, 0x00, 0x10, 'b' };
+		TEST_CHECK(!Compression::LZ4_Decompress(zeroOffset, sizeof(zeroOffset), decompressed.data(), 10));
+
+		// A length that runs off the end of the input
+		const uint8_t badLength[] = { 0xF0, 0xFF, 0xFF };
+		TEST_CHECK(!Compression::LZ4_Decompress(badLength, sizeof(badLength), decompressed.data(), 1000));
+
+		// Flipped bits, the result doesn't matter as long as it stays in bounds
+		for (unsigned int i = 0; i < 2000; i++)
+		{
+			vector<uint8_t> flipped = compressed;
+			flipped[Random() % flipped.size()] ^= (uint8_t)(1 << (Random() % 8));
+			Decompress(flipped, data.size());
+			TEST_CHECK(Guarded());
+		}
+
+		TEST_CHECK(!Compression::LZ4_Decompress(nullptr, 10, decompressed.data(), 10));
+	}
+
+	// A pack with a corrupted entry opens, but the entry doesn't read
+	{
+		const string directory	= "Test_Compression_Assets";
+		const string pack		= "Test_Compression.pak";
+		FileSystem::CreateDirectory_(directory);
+
+		vector<uint8_t> data = Data(50000, 3);
+		ofstream(directory + "/data.bin", ios::binary).write(reinterpret_cast<const char*>(data.data()), data.size());
+		TEST_CHECK(PackFile::Create(directory, pack, true));
+
+		auto Read = [&]()
+		{
+			PackFile file;
+			const std::byte* read	= nullptr;
+			size_t size				= 0;
+			vector<std::byte> storage;
+			return file.Open(pack) && file.Read(directory + "/data.bin", &read, &size, &storage) && size == data.size() && memcmp(read, data.data(), size) == 0;
+		};
+		TEST_CHECK(Read());
+
+		// The first entry's data follows the header
+		{
+			fstream file(pack, ios::in | ios::out | ios::binary);
+			file.seekg(100);
+			char byte = (char)(file.get() ^ 0x10);
+			file.seekp(100);
+			file.put(byte);
+		}
+		TEST_CHECK(!Read());
+
+		FileSystem::DeleteFile_(pack);
+		FileSystem::DeleteDirectory(directory);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,96 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========
+#include "Test.h"
+#include <vector>
+#include <random>
+#include "Math/Frustum.h"
+//======================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//========================
+
+// Frustum::CheckCubes (SIMD, 4 or 8 boxes at a time) has to agree with Frustum::CheckCube box by box,
+// for counts that leave a partial batch and for boxes inside, outside and across every plane. Frustum::CheckSphere
+// has to find spheres outside whichever plane they are outside of.
+int main()
+{
+	mt19937 random(5);
+	uniform_real_distribution<float> position(-120.0f, 120.0f);
+	uniform_real_distribution<float> size(0.0f, 20.0f);
+
+	for (unsigned int camera = 0; camera < 8; camera++)
+	{
+		Vector3 eye		= Vector3(position(random), position(random), position(random)) * 0.25f;
+		Vector3 target	= Vector3(position(random), position(random), position(random));
+		Frustum frustum;
+		frustum.Construct(Matrix::CreateLookAtLH(eye, target, Vector3::Up), Matrix::CreatePerspectiveFieldOfViewLH(1.0f, 16.0f / 9.0f, 0.3f, 100.0f), 100.0f);
+
+		for (unsigned int count : { 0u, 1u, 3u, 4u, 7u, 8u, 9u, 31u, 32u, 33u, 1000u })
+		{
+			vector<float> centerX(count), centerY(count), centerZ(count), extentX(count), extentY(count), extentZ(count);
+			for (unsigned int i = 0; i < count; i++)
+			{
+				centerX[i] = position(random); centerY[i] = position(random); centerZ[i] = position(random);
+				extentX[i] = size(random); extentY[i] = size(random); extentZ[i] = size(random);
+			}
+
+			// Words past the last box have to be left alone
+			vector<uint32_t> visibility((count + 31) / 32 + 1, 0xDEADBEEF);
+			frustum.CheckCubes(centerX.data(), centerY.data(), centerZ.data(), extentX.data(), extentY.data(), extentZ.data(), count, visibility.data());
+
+			unsigned int mismatches = 0;
+			for (unsigned int i = 0; i < count; i++)
+			{
+				bool expected	= frustum.CheckCube(Vector3(centerX[i], centerY[i], centerZ[i]), Vector3(extentX[i], extentY[i], extentZ[i])) != Outside;
+				bool visible	= (visibility[i / 32] >> (i % 32)) & 1;
+				mismatches		+= expected != visible ? 1 : 0;
+			}
+			TEST_CHECK(mismatches == 0);
+			TEST_CHECK(visibility.back() == 0xDEADBEEF);
+
+			// Bits past the count (in the last word) are clear
+			if (count % 32 != 0)
+			{
+				TEST_CHECK((visibility[count / 32] >> (count % 32)) == 0);
+			}
+		}
+	}
+
+	// Frustum::CheckSphere: a sphere across one plane (here the near or the far one) but outside another is outside,
+	// no matter which of the two planes is tested first
+	{
+		Frustum frustum;
+		frustum.Construct(Matrix::CreateLookAtLH(Vector3::Zero, Vector3::Forward, Vector3::Up), Matrix::CreatePerspectiveFieldOfViewLH(1.0f, 16.0f / 9.0f, 0.3f, 100.0f), 100.0f);
+
+		TEST_CHECK(frustum.CheckSphere(Vector3(-50.0f, 0.0f, 0.3f), 1.0f) == Outside);
+		TEST_CHECK(frustum.CheckSphere(Vector3(0.0f, 500.0f, 100.0f), 1.0f) == Outside);
+		TEST_CHECK(frustum.CheckSphere(Vector3(0.0f, 0.0f, 0.3f), 1.0f) == Intersects);
+		TEST_CHECK(frustum.CheckSphere(Vector3(0.0f, 0.0f, 50.0f), 1.0f) == Inside);
+		TEST_CHECK(frustum.CheckSphere(Vector3(0.0f, 0.0f, -5.0f), 1.0f) == Outside);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,218 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ===========================
+#include "Test.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "Core/Hash.h"
+#include "IO/FileStream.h"
+#include "FileSystem/FileSystem.h"
+#include "Resource/Import/ImportCache.h"
+//======================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace
+{
+	const string g_directory = "Test_ImportCache_Entries/";
+
+	// The settings an importer hashes, see ImageImporter::ComputeSettingsHash()
+	uint64_t Settings_Hash(unsigned int version, unsigned int type)
+	{
+		unsigned int settings[] = { version, type };
+		return Hash::Compute(settings, sizeof(settings));
+	}
+
+	vector<std::byte> Source_Create(unsigned int seed, size_t size)
+	{
+		vector<std::byte> source(size);
+		for (size_t i = 0; i < size; i++)
+		{
+			source[i] = (std::byte)((i * 31 + seed * 17 + (i >> 8)) & 0xFF);
+		}
+		return source;
+	}
+
+	bool Store(ImportCache& cache, uint64_t key, const vector<std::byte>& data)
+	{
+		return cache.Store(key, [&data](FileStream* file) { file->Write(data); return true; });
+	}
+
+	bool Load(ImportCache& cache, uint64_t key, vector<std::byte>* data = nullptr)
+	{
+		vector<std::byte> read;
+		bool loaded = cache.Load(key, [&read](FileStream* file) { file->Read(&read); return true; });
+		if (data)
+		{
+			*data = read;
+		}
+		return loaded;
+	}
+}
+
+// ImportCache: entries are served only for the same source bytes and settings (bumping an importer's version
+// invalidates them), least recently used entries are evicted to meet the budget (within and across sessions)
+// and rejected or damaged entries are deleted.
+int main()
+{
+	FileSystem::DeleteDirectory(g_directory);
+
+	vector<vector<std::byte>> sources;
+	for (unsigned int i = 0; i < 10; i++)
+	{
+		sources.emplace_back(Source_Create(i, 4000));
+	}
+	vector<uint64_t> keys;
+	for (const auto& source : sources)
+	{
+		keys.emplace_back(ImportCache::ComputeKey(source.data(), source.size(), Settings_Hash(1, 0)));
+	}
+
+	// Keys
+	{
+		const auto& source = sources[0];
+		TEST_CHECK(keys[0] != 0);
+		TEST_CHECK(ImportCache::ComputeKey(source.data(), source.size(), Settings_Hash(1, 0)) == keys[0]);
+		TEST_CHECK(ImportCache::ComputeKey(source.data(), source.size(), Settings_Hash(2, 0)) != keys[0]);
+		TEST_CHECK(ImportCache::ComputeKey(source.data(), source.size(), Settings_Hash(1, 1)) != keys[0]);
+		TEST_CHECK(ImportCache::ComputeKey(source.data(), source.size() - 1, Settings_Hash(1, 0)) != keys[0]);
+		TEST_CHECK(ImportCache::ComputeKey(nullptr, 0, Settings_Hash(1, 0)) == 0);
+		TEST_CHECK(ImportCache::ComputeKey("Test_ImportCache_Missing.png", Settings_Hash(1, 0)) == 0);
+	}
+
+	// Hits, misses and invalidation by importer version
+	{
+		ImportCache cache(g_directory, 0);
+		const auto& source	= sources[0];
+		uint64_t keyVersion2 = ImportCache::ComputeKey(source.data(), source.size(), Settings_Hash(2, 0));
+
+		TEST_CHECK(!Load(cache, keys[0]));
+		TEST_CHECK(!Load(cache, 0));
+		TEST_CHECK(!Store(cache, 0, source));
+		TEST_CHECK(Store(cache, keys[0], source));
+
+		vector<std::byte> read;
+		TEST_CHECK(Load(cache, keys[0], &read));
+		TEST_CHECK(read == source);
+
+		// The importer was changed, what it produced before isn't served
+		TEST_CHECK(!Load(cache, keyVersion2));
+		TEST_CHECK(Store(cache, keyVersion2, Source_Create(100, 4000)));
+		TEST_CHECK(Load(cache, keyVersion2, &read));
+		TEST_CHECK(read == Source_Create(100, 4000));
+
+		ImportCacheStats stats = cache.GetStats();
+		TEST_CHECK(stats.entryCount == 2);
+		TEST_CHECK(stats.hits == 2);
+		TEST_CHECK(stats.misses == 2);
+		TEST_CHECK(stats.stores == 2);
+		TEST_CHECK(stats.evictions == 0);
+
+		cache.Clear();
+		TEST_CHECK(cache.GetStats().entryCount == 0);
+		TEST_CHECK(cache.GetStats().size == 0);
+		TEST_CHECK(!Load(cache, keys[0]));
+	}
+
+	// Budget eviction, least recently used first
+	uint64_t entrySize = 0;
+	{
+		ImportCache cache(g_directory, 0);
+		for (unsigned int i = 0; i < 10; i++)
+		{
+			TEST_CHECK(Store(cache, keys[i], sources[i]));
+		}
+		entrySize = cache.GetStats().size / 10;
+		TEST_CHECK(cache.GetStats().size == entrySize * 10);
+
+		// 0 and 1 become the most recently used, then 5 entries fit (collecting stops at 90% of the budget)
+		TEST_CHECK(Load(cache, keys[0]));
+		TEST_CHECK(Load(cache, keys[1]));
+		cache.SetBudget(entrySize * 6);
+
+		ImportCacheStats stats = cache.GetStats();
+		TEST_CHECK(stats.entryCount == 5);
+		TEST_CHECK(stats.evictions == 5);
+		TEST_CHECK(stats.size <= stats.budget);
+		for (unsigned int i : { 0, 1, 7, 8, 9 })
+		{
+			TEST_CHECK(Load(cache, keys[i]));
+		}
+		for (unsigned int i : { 2, 3, 4, 5, 6 })
+		{
+			TEST_CHECK(!Load(cache, keys[i]));
+		}
+
+		// Storing past the budget collects again
+		TEST_CHECK(Store(cache, keys[2], sources[2]));
+		TEST_CHECK(Store(cache, keys[3], sources[3]));
+		TEST_CHECK(cache.GetStats().size <= cache.GetStats().budget);
+		TEST_CHECK(Load(cache, keys[3]));
+		TEST_CHECK(!Load(cache, keys[0]));
+	}
+
+	// Across sessions the order of use comes from the files, unfinished writes are deleted
+	{
+		ofstream(g_directory + "0000000000000001.import.0.writing") << "partial";
+		{
+			// Used last: 1, 7, 8, 9 (in the loads above), 2, 3
+			ImportCache cache(g_directory, entrySize * 3);
+			TEST_CHECK(cache.GetStats().entryCount == 2);
+			TEST_CHECK(Load(cache, keys[2]));
+			TEST_CHECK(Load(cache, keys[3]));
+			TEST_CHECK(!Load(cache, keys[9]));
+		}
+		TEST_CHECK(!FileSystem::FileExists(g_directory + "0000000000000001.import.0.writing"));
+	}
+
+	// Rejected and damaged entries are deleted
+	{
+		ImportCache cache(g_directory, 0);
+		cache.Clear();
+		TEST_CHECK(Store(cache, keys[4], sources[4]));
+		TEST_CHECK(!cache.Load(keys[4], [](FileStream*) { return false; }));
+		TEST_CHECK(cache.GetStats().entryCount == 0);
+		TEST_CHECK(!Load(cache, keys[4]));
+
+		TEST_CHECK(Store(cache, keys[5], sources[5]));
+		string path;
+		for (const auto& entry : filesystem::directory_iterator(g_directory))
+		{
+			path = entry.path().string();
+		}
+		{
+			fstream file(path, ios::in | ios::out | ios::binary);
+			file.seekp(filesystem::file_size(path) / 2);
+			file.put('\x5A' ^ (char)sources[5][sources[5].size() / 2]);
+		}
+		TEST_CHECK(!Load(cache, keys[5]));
+		TEST_CHECK(cache.GetStats().entryCount == 0);
+		TEST_CHECK(!FileSystem::FileExists(path));
+	}
+
+	FileSystem::DeleteDirectory(g_directory);
+
+	return TEST_RESULT();
+}
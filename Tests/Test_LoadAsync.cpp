@@ -0,0 +1,134 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ========================
+#include "Test.h"
+#include <thread>
+#include <atomic>
+#include "Core/Context.h"
+#include "Core/Settings.h"
+#include "Core/EventSystem.h"
+#include "Threading/Threading.h"
+#include "Resource/ResourceManager.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+// ResourceManager.cpp is linked as it is, but the importers it creates need FreeImage, Assimp and FreeType.
+// The test loads its own resource type, so these stand in for them.
+namespace Directus
+{
+	ImageImporter::ImageImporter(Context* context) { m_context = context; }
+	ImageImporter::~ImageImporter() {}
+	ModelImporter::ModelImporter(Context* context) { m_context = context; }
+	FontImporter::FontImporter(Context* context) { m_context = context; }
+	FontImporter::~FontImporter() {}
+	void FontImporter::Initialize() {}
+}
+
+namespace
+{
+	atomic<bool> g_gateOpen	= false;
+	atomic<int> g_loads		= 0;
+
+	// Loading "gate" blocks until the test opens it, which keeps the (single) worker busy and everything else queued
+	class Asset : public IResource
+	{
+	public:
+		Asset(Context* context) : IResource(context, Resource_Unknown) {}
+
+		bool LoadFromFile(const string& filePath) override
+		{
+			while (filePath.find("gate") != string::npos && !g_gateOpen)
+			{
+				this_thread::yield();
+			}
+			g_loads++;
+			return true;
+		}
+	};
+}
+
+namespace Directus
+{
+	template<> Resource_Type IResource::DeduceResourceType<Asset>() { return Resource_Unknown; }
+}
+
+int main()
+{
+	Settings::Get().ThreadCountMax_Set(2);
+	auto context	= make_unique<Context>();
+	auto threading	= make_unique<Threading>(context.get());
+	// The context deletes its subsystems except for the first one (normally the engine)
+	context->RegisterSubsystem(threading.get());
+	threading->Initialize();
+	auto resourceManager = new ResourceManager(context.get());
+	context->RegisterSubsystem(resourceManager);
+	resourceManager->Initialize();
+	resourceManager->LoadAsync_SetMaxConcurrency(1);
+
+	auto gate = resourceManager->LoadAsync<Asset>("gate.asset");
+	while (gate.GetLoadState() != LoadState_Started)
+	{
+		this_thread::yield();
+	}
+
+	// Requesting a file again after cancelling it starts over instead of merging into the dropped request
+	LoadState cancelledState	= LoadState_Idle;
+	LoadState requeuedState		= LoadState_Idle;
+	auto cancelled = resourceManager->LoadAsync<Asset>("a.asset", 0, [&](weak_ptr<Asset>, LoadState state) { cancelledState = state; });
+	cancelled.Cancel();
+	auto requeued = resourceManager->LoadAsync<Asset>("a.asset", 0, [&](weak_ptr<Asset>, LoadState state) { requeuedState = state; });
+	TEST_CHECK(requeued.Get().lock() != cancelled.Get().lock());
+	TEST_CHECK(cancelled.GetLoadState() == LoadState_Cancelled);
+	TEST_CHECK(resourceManager->GetResourceByName<Asset>("a").lock() == requeued.Get().lock());
+
+	// A synchronous load of a queued file loads it right away, on this thread
+	auto queued = resourceManager->LoadAsync<Asset>("b.asset");
+	TEST_CHECK(queued.GetLoadState() == LoadState_Idle);
+	auto loaded = resourceManager->Load<Asset>("b.asset").lock();
+	TEST_CHECK(loaded == queued.Get().lock());
+	TEST_CHECK(loaded && loaded->GetLoadState() == LoadState_Completed);
+	TEST_CHECK(gate.GetLoadState() == LoadState_Started);
+
+	// The worker only loads what is left, once
+	g_gateOpen = true;
+	while (resourceManager->LoadAsync_GetPendingCount() != 0)
+	{
+		this_thread::yield();
+	}
+	FIRE_EVENT(EVENT_FRAME_START);
+	TEST_CHECK(cancelledState == LoadState_Cancelled);
+	TEST_CHECK(requeuedState == LoadState_Completed);
+	TEST_CHECK(requeued.IsReady());
+	TEST_CHECK(g_loads == 3);
+
+	// The resource manager waits for its loads, so it goes before the threads
+	context.reset();
+	threading.reset();
+	EventSystem::Get().Clear();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,250 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================
+#include "Test.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include "Rendering/MeshSimplifier.h"
+#include "Rendering/GeometryUtility.h"
+#include "RHI/RHI_Vertex.h"
+//======================================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+//========================
+
+namespace _Test_MeshSimplifier
+{
+	const unsigned int gridSize	= 48;
+	const unsigned int seam		= gridSize / 2;
+
+	inline void Sub(const float* a, const float* b, float* out)		{ out[0] = a[0] - b[0]; out[1] = a[1] - b[1]; out[2] = a[2] - b[2]; }
+	inline float Dot(const float* a, const float* b)				{ return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+	inline void Cross(const float* a, const float* b, float* out)	{ out[0] = a[1] * b[2] - a[2] * b[1]; out[1] = a[2] * b[0] - a[0] * b[2]; out[2] = a[0] * b[1] - a[1] * b[0]; }
+
+	// Closest point on a triangle (Ericson, Real-Time Collision Detection 5.1.5), squared distance to it
+	float DistanceSquared(const float* p, const float* a, const float* b, const float* c)
+	{
+		float ab[3], ac[3], ap[3], bp[3], cp[3];
+		Sub(b, a, ab); Sub(c, a, ac); Sub(p, a, ap); Sub(p, b, bp); Sub(p, c, cp);
+		float d1 = Dot(ab, ap), d2 = Dot(ac, ap), d3 = Dot(ab, bp), d4 = Dot(ac, bp), d5 = Dot(ab, cp), d6 = Dot(ac, cp);
+
+		float v, w;
+		float va = d3 * d6 - d5 * d4, vb = d5 * d2 - d1 * d6, vc = d1 * d4 - d3 * d2;
+		if (d1 <= 0.0f && d2 <= 0.0f)						{ v = 0.0f; w = 0.0f; }
+		else if (d3 >= 0.0f && d4 <= d3)					{ v = 1.0f; w = 0.0f; }
+		else if (d6 >= 0.0f && d5 <= d6)					{ v = 0.0f; w = 1.0f; }
+		else if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)	{ v = d1 / (d1 - d3); w = 0.0f; }
+		else if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)	{ v = 0.0f; w = d2 / (d2 - d6); }
+		else if (va <= 0.0f && d4 >= d3 && d5 >= d6)		{ w = (d4 - d3) / ((d4 - d3) + (d5 - d6)); v = 1.0f - w; }
+		else												{ float d = 1.0f / (va + vb + vc); v = vb * d; w = vc * d; }
+
+		float q[3] = { a[0] + ab[0] * v + ac[0] * w, a[1] + ab[1] * v + ac[1] * w, a[2] + ab[2] * v + ac[2] * w };
+		float pq[3];
+		Sub(p, q, pq);
+		return Dot(pq, pq);
+	}
+
+	// Distances from the vertices of the original mesh to the simplified one
+	struct Deviation { float max; float rms; };
+	Deviation Measure(const vector<RHI_Vertex_PosUVTBN>& vertices, const vector<unsigned int>& original, const vector<unsigned int>& simplified)
+	{
+		Deviation deviation	= { 0.0f, 0.0f };
+		double sum			= 0.0;
+		for (unsigned int index : original)
+		{
+			float closest = FLT_MAX;
+			for (size_t i = 0; i < simplified.size(); i += 3)
+			{
+				closest = min(closest, DistanceSquared(vertices[index].pos, vertices[simplified[i]].pos, vertices[simplified[i + 1]].pos, vertices[simplified[i + 2]].pos));
+			}
+			deviation.max	= max(deviation.max, sqrtf(closest));
+			sum				+= closest;
+		}
+		deviation.rms = (float)sqrt(sum / original.size());
+		return deviation;
+	}
+
+	// Twice the signed area of the triangles projected on the xz plane
+	float ProjectedArea(const vector<RHI_Vertex_PosUVTBN>& vertices, const vector<unsigned int>& indices)
+	{
+		double area = 0.0;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const float* a = vertices[indices[i]].pos;
+			const float* b = vertices[indices[i + 1]].pos;
+			const float* c = vertices[indices[i + 2]].pos;
+			area += (double)(b[2] - a[2]) * (c[0] - a[0]) - (double)(b[0] - a[0]) * (c[2] - a[2]);
+		}
+		return (float)area;
+	}
+
+	// A rolling height field, with a uv seam down the middle (the vertices at x = seam are duplicated with different uvs)
+	void CreateTerrain(vector<RHI_Vertex_PosUVTBN>* vertices, vector<unsigned int>* indices)
+	{
+		const unsigned int row = gridSize + 1;
+		auto vertex = [](unsigned int x, unsigned int z, float u)
+		{
+			RHI_Vertex_PosUVTBN vertex = {};
+			vertex.pos[0]		= (float)x;
+			vertex.pos[1]		= 2.0f * sinf(x * 0.2f) * cosf(z * 0.15f);
+			vertex.pos[2]		= (float)z;
+			vertex.uv[0]		= u;
+			vertex.uv[1]		= z / (float)gridSize;
+			vertex.normal[1]	= 1.0f;
+			vertex.tangent[0]	= 1.0f;
+			vertex.bitangent[2]	= 1.0f;
+			return vertex;
+		};
+
+		for (unsigned int z = 0; z <= gridSize; z++)
+		{
+			for (unsigned int x = 0; x <= gridSize; x++)
+			{
+				vertices->emplace_back(vertex(x, z, x / (float)seam));
+			}
+		}
+		// The right half of the seam, at the start of the second uv island
+		unsigned int seamStart = (unsigned int)vertices->size();
+		for (unsigned int z = 0; z <= gridSize; z++)
+		{
+			vertices->emplace_back(vertex(seam, z, 0.0f));
+		}
+
+		auto index = [&](unsigned int x, unsigned int z, bool right) { return right && x == seam ? seamStart + z : z * row + x; };
+		for (unsigned int z = 0; z < gridSize; z++)
+		{
+			for (unsigned int x = 0; x < gridSize; x++)
+			{
+				bool right = x >= seam;
+				unsigned int i00 = index(x, z, right), i10 = index(x + 1, z, right), i01 = index(x, z + 1, right), i11 = index(x + 1, z + 1, right);
+				indices->insert(indices->end(), { i00, i01, i10, i10, i01, i11 });
+			}
+		}
+	}
+
+	bool IsSeam(const RHI_Vertex_PosUVTBN& vertex) { return vertex.pos[0] == (float)seam; }
+	bool IsCorner(const RHI_Vertex_PosUVTBN& vertex) { return (vertex.pos[0] == 0.0f || vertex.pos[0] == gridSize) && (vertex.pos[2] == 0.0f || vertex.pos[2] == gridSize); }
+}
+
+// MeshSimplifier::Simplify has to stay within the error it's given, measured as the distance from the original surface
+// to the simplified one, keep the borders and the attribute seams, and only index vertices it was given.
+int main()
+{
+	using namespace _Test_MeshSimplifier;
+
+	vector<RHI_Vertex_PosUVTBN> vertices;
+	vector<unsigned int> indices;
+	CreateTerrain(&vertices, &indices);
+	float radius	= sqrtf(gridSize * gridSize * 0.5f + 2.0f * 2.0f);
+	float area		= ProjectedArea(vertices, indices);
+
+	size_t previousCount = indices.size();
+	for (float targetError : { 0.001f, 0.005f, 0.01f, 0.02f, 0.05f })
+	{
+		vector<unsigned int> simplified;
+		float error = MeshSimplifier::Simplify(vertices, indices, 0, targetError, &simplified);
+
+		TEST_CHECK(error <= targetError);
+		TEST_CHECK(simplified.size() % 3 == 0);
+		TEST_CHECK(simplified.size() <= previousCount);
+		TEST_CHECK(simplified.size() < indices.size());
+		previousCount = simplified.size();
+
+		// Valid, non degenerate triangles
+		unsigned int invalid = 0;
+		for (size_t i = 0; i < simplified.size(); i += 3)
+		{
+			unsigned int a = simplified[i], b = simplified[i + 1], c = simplified[i + 2];
+			invalid += (a >= vertices.size() || b >= vertices.size() || c >= vertices.size() || a == b || b == c || a == c) ? 1 : 0;
+		}
+		TEST_CHECK(invalid == 0);
+		if (invalid != 0)
+			continue;
+
+		// The quadric error is an area weighted average, so it bounds the rms distance, the largest one adds up over
+		// successive collapses and ends up at about 4 times the error
+		Deviation deviation = Measure(vertices, indices, simplified);
+		TEST_CHECK(deviation.rms <= 1.25f * targetError * radius);
+		TEST_CHECK(deviation.max <= 5.0f * targetError * radius);
+
+		// The borders are straight, so keeping them (and not folding) keeps the projected area
+		TEST_CHECK(fabsf(ProjectedArea(vertices, simplified) - area) < area * 1e-4f);
+
+		// The corners and both sides of the seam are kept
+		vector<bool> used(vertices.size(), false);
+		for (unsigned int index : simplified)
+		{
+			used[index] = true;
+		}
+		unsigned int missing = 0;
+		for (unsigned int i = 0; i < (unsigned int)vertices.size(); i++)
+		{
+			missing += (IsCorner(vertices[i]) || IsSeam(vertices[i])) && !used[i] ? 1 : 0;
+		}
+		TEST_CHECK(missing == 0);
+	}
+
+	// A flat plane collapses down to its border and seam for free
+	{
+		vector<RHI_Vertex_PosUVTBN> flat = vertices;
+		for (auto& vertex : flat)
+		{
+			vertex.pos[1] = 0.0f;
+		}
+		vector<unsigned int> simplified;
+		float error = MeshSimplifier::Simplify(flat, indices, 0, 1e-4f, &simplified);
+		TEST_CHECK(error < 1e-4f);
+		TEST_CHECK(simplified.size() < indices.size() / 10);
+	}
+
+	// The target index count stops it early, and nothing happens when it's already met
+	{
+		vector<unsigned int> simplified;
+		MeshSimplifier::Simplify(vertices, indices, (unsigned int)indices.size() / 2, 1.0f, &simplified);
+		TEST_CHECK(simplified.size() <= indices.size() / 2);
+		TEST_CHECK(simplified.size() > indices.size() / 4);
+
+		TEST_CHECK(MeshSimplifier::Simplify(vertices, indices, (unsigned int)indices.size(), 1.0f, &simplified) == 0.0f);
+		TEST_CHECK(simplified == indices);
+	}
+
+	// A closed mesh
+	{
+		vector<RHI_Vertex_PosUVTBN> sphere;
+		vector<unsigned int> sphereIndices;
+		GeometryUtility::CreateSphere(&sphere, &sphereIndices, 1.0f, 40, 40);
+
+		vector<unsigned int> simplified;
+		float error = MeshSimplifier::Simplify(sphere, sphereIndices, 0, 0.02f, &simplified);
+		TEST_CHECK(error <= 0.02f);
+		TEST_CHECK(simplified.size() < sphereIndices.size());
+		Deviation deviation = Measure(sphere, sphereIndices, simplified);
+		TEST_CHECK(deviation.rms <= 1.25f * 0.02f * sqrtf(3.0f));
+		TEST_CHECK(deviation.max <= 5.0f * 0.02f * sqrtf(3.0f));
+	}
+
+	return TEST_RESULT();
+}
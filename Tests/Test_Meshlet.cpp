@@ -0,0 +1,148 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES =========================
+#include "Test.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <array>
+#include "Rendering/Meshlet.h"
+#include "Rendering/GeometryUtility.h"
+#include "RHI/RHI_Vertex.h"
+//====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//============================
+
+namespace
+{
+	Vector3 Position(const RHI_Vertex_PosUVTBN& vertex) { return Vector3(vertex.pos[0], vertex.pos[1], vertex.pos[2]); }
+
+	// Triangles as sorted tuples, each rotated to start at its smallest index (which keeps the winding)
+	vector<array<unsigned int, 3>> Triangles(const vector<unsigned int>& indices)
+	{
+		vector<array<unsigned int, 3>> triangles;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			array<unsigned int, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+			rotate(triangle.begin(), min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.emplace_back(triangle);
+		}
+		sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+}
+
+// MeshletBuilder::Build has to keep every triangle (as it was wound), stay within its vertex and triangle limits and
+// bound each meshlet. IsBackFacing may only cull a meshlet when all of its triangles face away from the camera.
+int main()
+{
+	const unsigned int maxVertices	= 64;
+	const unsigned int maxTriangles	= 124;
+
+	vector<RHI_Vertex_PosUVTBN> vertices;
+	vector<unsigned int> indices;
+	GeometryUtility::CreateSphere(&vertices, &indices, 2.0f, 120, 120);
+	vector<unsigned int> original = indices;
+
+	vector<Meshlet> meshlets;
+	MeshletBuilder::Build(vertices, &indices, &meshlets, maxVertices, maxTriangles);
+	TEST_CHECK(!meshlets.empty());
+	TEST_CHECK(Triangles(indices) == Triangles(original));
+
+	// Contiguous, within the limits and bounded
+	unsigned int offset		= 0;
+	unsigned int oversized	= 0;
+	unsigned int unbounded	= 0;
+	for (const auto& meshlet : meshlets)
+	{
+		TEST_CHECK(meshlet.indexOffset == offset);
+		TEST_CHECK(meshlet.indexCount % 3 == 0 && meshlet.indexCount > 0);
+		offset += meshlet.indexCount;
+
+		vector<unsigned int> used(indices.begin() + meshlet.indexOffset, indices.begin() + meshlet.indexOffset + meshlet.indexCount);
+		sort(used.begin(), used.end());
+		used.erase(unique(used.begin(), used.end()), used.end());
+		oversized += (used.size() > maxVertices || meshlet.indexCount > maxTriangles * 3) ? 1 : 0;
+
+		for (unsigned int index : used)
+		{
+			unbounded += Vector3::Length(meshlet.center, Position(vertices[index])) > meshlet.radius * 1.0001f + 1e-5f ? 1 : 0;
+		}
+	}
+	TEST_CHECK(offset == indices.size());
+	TEST_CHECK(oversized == 0);
+	TEST_CHECK(unbounded == 0);
+
+	// Groups cover the meshlets in order and bound them
+	vector<MeshletGroup> groups;
+	MeshletBuilder::BuildGroups(meshlets, &groups, 32);
+	unsigned int first = 0;
+	for (const auto& group : groups)
+	{
+		TEST_CHECK(group.first == first && group.count > 0 && group.count <= 32);
+		for (unsigned int i = group.first; i < group.first + group.count; i++)
+		{
+			TEST_CHECK(Vector3::Length(group.center, meshlets[i].center) + meshlets[i].radius <= group.radius * 1.0001f + 1e-5f);
+		}
+		first += group.count;
+	}
+	TEST_CHECK(first == meshlets.size());
+
+	// Cameras all around (and inside) the sphere, culled meshlets only have triangles that face away
+	mt19937 random(7);
+	uniform_real_distribution<float> position(-10.0f, 10.0f);
+	unsigned int culled		= 0;
+	unsigned int facing		= 0;
+	for (unsigned int camera = 0; camera < 64; camera++)
+	{
+		Vector3 cameraPosition(position(random), position(random), position(random));
+		for (const auto& meshlet : meshlets)
+		{
+			if (!MeshletBuilder::IsBackFacing(meshlet, cameraPosition))
+				continue;
+
+			culled++;
+			for (unsigned int i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.indexCount; i += 3)
+			{
+				Vector3 p0		= Position(vertices[indices[i]]);
+				Vector3 normal	= Vector3::Cross(Position(vertices[indices[i + 1]]) - p0, Position(vertices[indices[i + 2]]) - p0);
+				facing			+= Vector3::Dot(normal, p0 - cameraPosition) < -1e-6f ? 1 : 0;
+			}
+		}
+	}
+	TEST_CHECK(facing == 0);
+	// From outside, most of the far side of a sphere goes
+	TEST_CHECK(culled > meshlets.size() * 64 / 8);
+
+	// Too little to split and nothing at all
+	vector<unsigned int> triangle = { 0, 1, 2 };
+	MeshletBuilder::Build(vertices, &triangle, &meshlets, maxVertices, maxTriangles);
+	TEST_CHECK(meshlets.size() == 1 && meshlets[0].indexCount == 3);
+	vector<unsigned int> none;
+	MeshletBuilder::Build(vertices, &none, &meshlets, maxVertices, maxTriangles);
+	TEST_CHECK(meshlets.empty());
+
+	return TEST_RESULT();
+}
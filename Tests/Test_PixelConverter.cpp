@@ -0,0 +1,198 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========================
+#include "Test.h"
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include "Resource/Import/PixelConverter.h"
+#include "Threading/Threading.h"
+#include "Core/Context.h"
+//====================================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+//========================
+
+namespace _Test_PixelConverter
+{
+	unsigned int BitsPerPixel(PixelFormat format)
+	{
+		static const unsigned int bits[] = { 1, 4, 8, 16, 16, 24, 24, 32, 32, 16, 48, 64, 32, 96, 128 };
+		return bits[format];
+	}
+
+	uint8_t ToUNorm8(float value)
+	{
+		value = value > 0.0f ? value : 0.0f; // NaN too
+		value = value < 1.0f ? value : 1.0f;
+		return (uint8_t)(value * 255.0f + 0.5f);
+	}
+
+	// Pixel by pixel, the way the formats are documented
+	vector<uint8_t> Reference(const PixelSource& source)
+	{
+		vector<uint8_t> rgba((size_t)source.width * source.height * 4);
+		for (unsigned int y = 0; y < source.height; y++)
+		{
+			const uint8_t* row		= reinterpret_cast<const uint8_t*>(source.data + (ptrdiff_t)y * source.pitch);
+			const uint16_t* row16	= reinterpret_cast<const uint16_t*>(row);
+			const float* row32		= reinterpret_cast<const float*>(row);
+			for (unsigned int x = 0; x < source.width; x++)
+			{
+				uint8_t c[4] = { 0, 0, 0, 255 };
+				switch (source.format)
+				{
+				case PixelFormat_Palette1:	memcpy(c, &source.palette[(row[x / 8] >> (7 - x % 8)) & 1], 4); break;
+				case PixelFormat_Palette4:	memcpy(c, &source.palette[x % 2 ? row[x / 2] & 15 : row[x / 2] >> 4], 4); break;
+				case PixelFormat_Palette8:	memcpy(c, &source.palette[row[x]], 4); break;
+				case PixelFormat_BGR565:	c[0] = ((row16[x] >> 11) & 31) * 255 / 31; c[1] = ((row16[x] >> 5) & 63) * 255 / 63; c[2] = (row16[x] & 31) * 255 / 31; break;
+				case PixelFormat_BGR555:	c[0] = ((row16[x] >> 10) & 31) * 255 / 31; c[1] = ((row16[x] >> 5) & 31) * 255 / 31; c[2] = (row16[x] & 31) * 255 / 31; break;
+				case PixelFormat_RGB8:		c[0] = row[x * 3]; c[1] = row[x * 3 + 1]; c[2] = row[x * 3 + 2]; break;
+				case PixelFormat_BGR8:		c[2] = row[x * 3]; c[1] = row[x * 3 + 1]; c[0] = row[x * 3 + 2]; break;
+				case PixelFormat_RGBA8:		memcpy(c, row + x * 4, 4); break;
+				case PixelFormat_BGRA8:		c[2] = row[x * 4]; c[1] = row[x * 4 + 1]; c[0] = row[x * 4 + 2]; c[3] = row[x * 4 + 3]; break;
+				case PixelFormat_R16:		c[0] = c[1] = c[2] = row16[x] >> 8; break;
+				case PixelFormat_RGB16:		for (unsigned int i = 0; i < 3; i++) c[i] = row16[x * 3 + i] >> 8; break;
+				case PixelFormat_RGBA16:	for (unsigned int i = 0; i < 4; i++) c[i] = row16[x * 4 + i] >> 8; break;
+				case PixelFormat_R32F:		c[0] = c[1] = c[2] = ToUNorm8(row32[x]); break;
+				case PixelFormat_RGB32F:	for (unsigned int i = 0; i < 3; i++) c[i] = ToUNorm8(row32[x * 3 + i]); break;
+				case PixelFormat_RGBA32F:	for (unsigned int i = 0; i < 4; i++) c[i] = ToUNorm8(row32[x * 4 + i]); break;
+				default: break;
+				}
+				memcpy(&rgba[((size_t)y * source.width + x) * 4], c, 4);
+			}
+		}
+		return rgba;
+	}
+
+	// Random rows, padded to 32 bits like a bitmap, floats are a mix of in range values, out of range values and NaN
+	vector<uint8_t> CreatePixels(PixelFormat format, unsigned int width, unsigned int height, size_t* pitch, mt19937& random)
+	{
+		*pitch = ((width * BitsPerPixel(format) + 31) / 32) * 4;
+		vector<uint8_t> pixels(*pitch * height);
+		for (auto& byte : pixels)
+		{
+			byte = (uint8_t)random();
+		}
+
+		if (format == PixelFormat_R32F || format == PixelFormat_RGB32F || format == PixelFormat_RGBA32F)
+		{
+			float* floats = reinterpret_cast<float*>(pixels.data());
+			for (size_t i = 0; i < pixels.size() / sizeof(float); i++)
+			{
+				unsigned int kind = random() % 10;
+				floats[i] = kind == 0 ? NAN : (kind == 1 ? 7.0f : (kind == 2 ? -1.0f : (random() % 1000) / 999.0f));
+			}
+		}
+		return pixels;
+	}
+}
+
+// PixelConverter::Convert has to match a pixel by pixel reference for every format, at widths that leave partial
+// SIMD batches and partial palette bytes, for either row order, and with or without threading.
+int main()
+{
+	using namespace _Test_PixelConverter;
+
+	mt19937 random(1);
+	uint32_t palette[256];
+	for (auto& color : palette)
+	{
+		color = (uint32_t)random();
+	}
+
+	Context context;
+	Threading threading(&context);
+	threading.Initialize();
+
+	for (unsigned int format = 0; format < PixelFormat_Unknown; format++)
+	{
+		for (unsigned int width : { 1u, 3u, 7u, 17u, 64u })
+		{
+			for (bool flip : { false, true })
+			{
+				const unsigned int height = 5;
+				size_t pitch;
+				auto pixels = CreatePixels((PixelFormat)format, width, height, &pitch, random);
+
+				PixelSource source;
+				source.width	= width;
+				source.height	= height;
+				source.format	= (PixelFormat)format;
+				source.palette	= palette;
+				source.data		= reinterpret_cast<const std::byte*>(pixels.data()) + (flip ? (height - 1) * pitch : 0);
+				source.pitch	= flip ? -(ptrdiff_t)pitch : (ptrdiff_t)pitch;
+
+				auto expected = Reference(source);
+				bool expectedTransparent = false;
+				for (size_t i = 3; i < expected.size(); i += 4)
+				{
+					expectedTransparent = expectedTransparent || expected[i] != 255;
+				}
+
+				vector<uint8_t> rgba(expected.size());
+				bool transparent = !expectedTransparent;
+				TEST_CHECK(PixelConverter::Convert(source, reinterpret_cast<std::byte*>(rgba.data()), &transparent));
+				TEST_CHECK(rgba == expected);
+				TEST_CHECK(transparent == expectedTransparent);
+			}
+		}
+	}
+
+	// Big enough to be split into bands, the bands can't change the result
+	for (PixelFormat format : { PixelFormat_BGR8, PixelFormat_BGRA8, PixelFormat_RGBA16, PixelFormat_RGB32F })
+	{
+		const unsigned int width = 509, height = 263;
+		size_t pitch;
+		auto pixels = CreatePixels(format, width, height, &pitch, random);
+
+		PixelSource source;
+		source.width	= width;
+		source.height	= height;
+		source.format	= format;
+		source.data		= reinterpret_cast<const std::byte*>(pixels.data()) + (height - 1) * pitch;
+		source.pitch	= -(ptrdiff_t)pitch;
+
+		vector<uint8_t> rgba((size_t)width * height * 4);
+		bool transparent = false;
+		TEST_CHECK(PixelConverter::Convert(source, reinterpret_cast<std::byte*>(rgba.data()), &transparent, &threading));
+		TEST_CHECK(rgba == Reference(source));
+	}
+
+	// Nothing is written for an unknown format
+	{
+		uint8_t pixel[4] = { 1, 2, 3, 4 };
+		PixelSource source;
+		source.data		= reinterpret_cast<const std::byte*>(pixel);
+		source.pitch	= 4;
+		source.width	= 1;
+		source.height	= 1;
+		uint8_t rgba[4] = { 9, 9, 9, 9 };
+		TEST_CHECK(!PixelConverter::Convert(source, reinterpret_cast<std::byte*>(rgba)));
+		TEST_CHECK(rgba[0] == 9 && rgba[3] == 9);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,147 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================
+#include "Test.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Core/Context.h"
+#include "Core/EventSystem.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "Profiling/Profiler.h"
+#include "Resource/ResourceManager.h"
+#include "Rendering/Renderer.h"
+#include "World/World.h"
+#include "World/Actor.h"
+#include "World/Components/Light.h"
+#include "World/Components/Renderable.h"
+#include "World/Components/Transform.h"
+//======================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//============================
+
+namespace
+{
+	vector<weak_ptr<Actor>> g_cubes;
+
+	// Cubes in rows of ten, the default camera is at (0, 1, -5) looking down +Z
+	void Cubes_Add(World* world, unsigned int count, float z)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			auto actor = world->Actor_CreateAdd().lock();
+			actor->GetTransform_PtrRaw()->SetPosition(Vector3((float)(i % 10) * 2.0f - 9.0f, 0.0f, z + (float)(i / 10) * 2.0f));
+			auto renderable = actor->AddComponent<Renderable>().lock();
+			renderable->Geometry_Set(Geometry_Default_Cube);
+			renderable->Material_UseDefault();
+			g_cubes.emplace_back(actor);
+		}
+		FIRE_EVENT(EVENT_SCENE_RESOLVE_START);
+		FIRE_EVENT(EVENT_TICK);
+	}
+
+	void Cubes_Clear(World* world)
+	{
+		for (const auto& cube : g_cubes)
+		{
+			world->Actor_Remove(cube);
+		}
+		g_cubes.clear();
+		FIRE_EVENT(EVENT_TICK);
+	}
+
+	unsigned int Render(Renderer* renderer)
+	{
+		renderer->Render();
+		return Profiler::Get().m_rhiDrawCalls;
+	}
+
+	// Shaders compile on the worker threads and a pass is skipped until its shader is built, so
+	// render until the draw calls stop changing before counting them
+	unsigned int Render_Settled(Renderer* renderer)
+	{
+		unsigned int draws	= Render(renderer);
+		unsigned int same	= 0;
+		for (unsigned int i = 0; i < 3000 && same < 10; i++)
+		{
+			this_thread::sleep_for(chrono::milliseconds(10));
+			unsigned int frame = Render(renderer);
+			same	= frame == draws ? same + 1 : 0;
+			draws	= frame;
+		}
+		return draws;
+	}
+}
+
+int main()
+{
+	FileSystem::Initialize();
+
+	// The context deletes its subsystems except for the first one (normally the engine)
+	auto context	= make_unique<Context>();
+	auto threading	= make_unique<Threading>(context.get());
+	context->RegisterSubsystem(threading.get());
+	threading->Initialize();
+	auto resourceManager = new ResourceManager(context.get());
+	context->RegisterSubsystem(resourceManager);
+	resourceManager->Initialize();
+	auto renderer = new Renderer(context.get(), nullptr);
+	context->RegisterSubsystem(renderer);
+	renderer->Initialize();
+	auto world = new World(context.get());
+	context->RegisterSubsystem(world);
+	world->Initialize();
+	FIRE_EVENT(EVENT_TICK);
+
+	// A camera, a light and a skybox, the full screen passes still draw
+	unsigned int empty = Render_Settled(renderer);
+	TEST_CHECK(empty > 0);
+	TEST_CHECK(Render(renderer) == empty);
+
+	// Every cube in view is drawn into the G-buffer at least
+	Cubes_Add(world, 100, 20.0f);
+	unsigned int front = Render_Settled(renderer);
+	TEST_CHECK(front >= empty + 100);
+	TEST_CHECK(Render(renderer) == front);
+
+	// Without shadows a cube is one G-buffer draw if it's in view and none if it isn't
+	world->GetActorByName("DirectionalLight").lock()->GetComponent<Light>().lock()->SetCastShadows(false);
+	unsigned int unshadowed = Render(renderer);
+	Cubes_Clear(world);
+	unsigned int unshadowedEmpty = Render(renderer);
+	TEST_CHECK(unshadowedEmpty <= empty);
+	TEST_CHECK(unshadowed == unshadowedEmpty + 100);
+	Cubes_Add(world, 100, -60.0f);
+	TEST_CHECK(Render(renderer) == unshadowedEmpty);
+	Cubes_Clear(world);
+
+	context.reset();
+	threading.reset();
+	EventSystem::Get().Clear();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,167 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===================
+#include "Test.h"
+#include "Core/Context.h"
+#include "Resource/ResourceCache.h"
+//==============================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Directus;
+//==================
+
+namespace
+{
+	// A resource that was "loaded" from a file and reports a fixed size
+	class TestResource : public IResource
+	{
+	public:
+		TestResource(Context* context, Resource_Type type, const string& name, unsigned int memory) : IResource(context, type)
+		{
+			m_memory = memory;
+			SetResourceName(name);
+			SetResourceFilePath("Project/" + name + ".resource");
+			SetLoadState(LoadState_Completed);
+		}
+
+		unsigned int GetMemoryUsage() override { return m_memory; }
+
+	private:
+		unsigned int m_memory;
+	};
+
+	shared_ptr<IResource> Add(ResourceCache& cache, Context* context, const string& name, unsigned int memory, Resource_Type type = Resource_Texture)
+	{
+		auto resource = make_shared<TestResource>(context, type, name, memory);
+		cache.Add(resource);
+		return resource;
+	}
+}
+
+int main()
+{
+	Context context;
+
+	// Least recently used go first, until the budget is met
+	{
+		ResourceCache cache;
+		for (const char* name : { "a", "b", "c", "d" })
+		{
+			Add(cache, &context, name, 100);
+		}
+
+		// "a" was last used in frame 0, "b" in 1, "c" in 2 and "d" in 3
+		for (const char* name : { "b", "c", "d" })
+		{
+			cache.Tick();
+			cache.GetByName(name, Resource_Texture)->MarkUsed();
+		}
+		cache.Tick();
+
+		// Without a budget nothing goes
+		TEST_CHECK(cache.Evict() == 0);
+
+		cache.SetMemoryBudget(250);
+		TEST_CHECK(cache.Evict() == 200);
+		TEST_CHECK(!cache.GetByName("a", Resource_Texture));
+		TEST_CHECK(!cache.GetByName("b", Resource_Texture));
+		TEST_CHECK(cache.GetByName("c", Resource_Texture));
+		TEST_CHECK(cache.GetByName("d", Resource_Texture));
+		TEST_CHECK(cache.GetMemoryUsage() == 200);
+
+		ResourceCacheStats stats = cache.GetStats();
+		TEST_CHECK(stats.evictionCount == 2);
+		TEST_CHECK(stats.memoryEvicted == 200);
+		TEST_CHECK(stats.resourceCount == 2);
+
+		// What was evicted can be found again, by name or by path
+		string path;
+		TEST_CHECK(cache.GetEvictedPathByName("a", Resource_Texture, path) && path == FileSystem::NormalizePath("Project/a.resource"));
+		TEST_CHECK(cache.GetEvictedPathByPath("Project/b.resource", Resource_Texture, path));
+		TEST_CHECK(!cache.GetEvictedPathByName("c", Resource_Texture, path));
+
+		// Reloading it (what the ResourceManager does on access) brings it back and forgets the eviction
+		Add(cache, &context, "a", 100);
+		stats = cache.GetStats();
+		TEST_CHECK(stats.reloadCount == 1);
+		TEST_CHECK(stats.resourceCount == 3);
+		TEST_CHECK(!cache.GetEvictedPathByName("a", Resource_Texture, path));
+		TEST_CHECK(!cache.GetEvictedPathByPath("Project/a.resource", Resource_Texture, path));
+		TEST_CHECK(cache.GetEvictedPathByName("b", Resource_Texture, path));
+	}
+
+	// Resources that are in use, referenced, used this frame, still loading or not loaded from a file stay
+	{
+		ResourceCache cache;
+		auto used		= Add(cache, &context, "used", 100);
+		auto referenced	= Add(cache, &context, "referenced", 100);
+		auto recent		= Add(cache, &context, "recent", 100);
+		auto loading	= Add(cache, &context, "loading", 100);
+		auto unsaved	= Add(cache, &context, "unsaved", 100);
+		Add(cache, &context, "idle", 100);
+
+		used->UseCount_Increment();
+		loading->SetLoadState(LoadState_Started);
+		unsaved->SetResourceFilePath(NOT_ASSIGNED);
+		cache.Tick();
+		recent->MarkUsed();
+
+		used.reset();
+		recent.reset();
+		loading.reset();
+		unsaved.reset();
+
+		cache.SetMemoryBudget(1);
+		TEST_CHECK(cache.Evict() == 100);
+		TEST_CHECK(!cache.GetByName("idle", Resource_Texture));
+		TEST_CHECK(cache.GetStats().resourceCount == 5);
+
+		// Once released (and a frame later), they can go too
+		cache.GetByName("used", Resource_Texture)->UseCount_Decrement();
+		referenced.reset();
+		cache.Tick();
+		cache.Tick();
+		TEST_CHECK(cache.GetByName("used", Resource_Texture) == nullptr);
+		TEST_CHECK(cache.GetByName("referenced", Resource_Texture) == nullptr);
+		TEST_CHECK(cache.GetByName("recent", Resource_Texture) == nullptr);
+		TEST_CHECK(cache.GetStats().resourceCount == 2);
+	}
+
+	// A type's own budget only evicts that type, the largest first among equally old ones
+	{
+		ResourceCache cache;
+		Add(cache, &context, "small", 100, Resource_Material);
+		Add(cache, &context, "large", 300, Resource_Material);
+		Add(cache, &context, "texture", 1000, Resource_Texture);
+		cache.Tick();
+
+		cache.SetMemoryBudget(Resource_Material, 200);
+		TEST_CHECK(cache.Evict() == 300);
+		TEST_CHECK(cache.GetByName("small", Resource_Material));
+		TEST_CHECK(cache.GetByName("texture", Resource_Texture));
+		TEST_CHECK(cache.GetStats(Resource_Material).memoryUsage == 100);
+		TEST_CHECK(cache.GetStats(Resource_Texture).evictionCount == 0);
+	}
+
+	return TEST_RESULT();
+}
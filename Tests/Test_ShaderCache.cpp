@@ -0,0 +1,183 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===================
+#include "Test.h"
+#include <memory>
+#include <thread>
+#include <fstream>
+#include <filesystem>
+#include "RHI/RHI_Device.h"
+#include "RHI/RHI_Shader.h"
+#include "RHI/RHI_ShaderCache.h"
+//==============================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+//========================
+
+namespace _Test_ShaderCache
+{
+	const string cachePath	= "Test_ShaderCache.bin";
+	const string shader		= string(ASSETS_DIR) + "Standard Assets/Shaders/Texture.hlsl";
+
+	// Compiles the vertex and the pixel shader, like the renderer does
+	bool Compile(const shared_ptr<RHI_Device>& device, const string& filePath, const char* define = nullptr)
+	{
+		RHI_Shader shader(device);
+		if (define)
+		{
+			shader.AddDefine(define);
+		}
+		return shader.Compile_Vertex(filePath, Input_PositionTexture) && shader.Compile_Pixel(filePath);
+	}
+
+	void WriteFile(const string& filePath, const string& text)
+	{
+		ofstream file(filePath, ios::binary | ios::trunc);
+		file << text;
+	}
+}
+
+// The Null backend looks shaders up in the cache (and stores them) like a real backend would. Hits and misses have to follow
+// the source, the defines, what the source includes and the compiler version, and the binaries have to survive a restart.
+int main()
+{
+	using namespace _Test_ShaderCache;
+
+	Context context;
+	auto device = make_shared<RHI_Device>(nullptr);
+	filesystem::remove(cachePath);
+
+	// First session, everything is compiled, then the same shaders hit
+	{
+		auto cache = make_shared<RHI_ShaderCache>(cachePath, 0);
+		device->SetShaderCache(cache);
+
+		TEST_CHECK(Compile(device, shader));
+		auto stats = cache->GetStats();
+		TEST_CHECK(stats.misses == 2 && stats.hits == 0 && stats.stores == 2 && stats.entryCount == 2);
+
+		TEST_CHECK(Compile(device, shader));
+		stats = cache->GetStats();
+		TEST_CHECK(stats.misses == 2 && stats.hits == 2 && stats.entryCount == 2);
+
+		// Another variation
+		TEST_CHECK(Compile(device, shader, "ALPHA_TEST"));
+		stats = cache->GetStats();
+		TEST_CHECK(stats.misses == 4 && stats.hits == 2 && stats.entryCount == 4);
+
+		// A missing shader fails before it gets to the cache
+		TEST_CHECK(!Compile(device, string(ASSETS_DIR) + "Standard Assets/Shaders/Missing.hlsl"));
+		TEST_CHECK(cache->GetStats().misses == 4);
+
+		TEST_CHECK(cache->Save());
+		device->SetShaderCache(nullptr);
+	}
+
+	// Second session, loaded from the file
+	{
+		auto cache = make_shared<RHI_ShaderCache>(cachePath, 0);
+		device->SetShaderCache(cache);
+		TEST_CHECK(cache->GetStats().entryCount == 4);
+
+		TEST_CHECK(Compile(device, shader, "ALPHA_TEST"));
+		TEST_CHECK(Compile(device, shader));
+		auto stats = cache->GetStats();
+		TEST_CHECK(stats.hits == 4 && stats.misses == 0 && stats.stores == 0);
+
+		// A binary the driver rejects is removed, and compiled again next time
+		map<string, string> defines = { { "COMPILE_VS", "1" }, { "COMPILE_PS", "0" } };
+		uint64_t key = cache->ComputeKey(shader, defines, VERTEX_SHADER_ENTRYPOINT, VERTEX_SHADER_MODEL, 0, 0);
+		TEST_CHECK(cache->Load(key) != nullptr);
+		cache->Remove(key);
+		TEST_CHECK(cache->GetStats().evictions == 1 && cache->GetStats().entryCount == 3);
+		TEST_CHECK(Compile(device, shader));
+		stats = cache->GetStats();
+		TEST_CHECK(stats.misses == 1 && stats.stores == 1 && stats.entryCount == 4);
+
+		// Anything the compiler sees changes the key
+		TEST_CHECK(key != cache->ComputeKey(shader, defines, VERTEX_SHADER_ENTRYPOINT, VERTEX_SHADER_MODEL, 0, 47));
+		TEST_CHECK(key != cache->ComputeKey(shader, defines, VERTEX_SHADER_ENTRYPOINT, VERTEX_SHADER_MODEL, 1, 0));
+		TEST_CHECK(key != cache->ComputeKey(shader, defines, "main", VERTEX_SHADER_MODEL, 0, 0));
+		TEST_CHECK(key != cache->ComputeKey(shader, { { "COMPILE_VS", "0" }, { "COMPILE_PS", "1" } }, VERTEX_SHADER_ENTRYPOINT, VERTEX_SHADER_MODEL, 0, 0));
+		TEST_CHECK(cache->ComputeKey(string(ASSETS_DIR) + "Standard Assets/Shaders/Missing.hlsl", defines, VERTEX_SHADER_ENTRYPOINT, VERTEX_SHADER_MODEL, 0, 0) == 0);
+
+		device->SetShaderCache(nullptr);
+	}
+
+	// Editing an included file invalidates what was compiled from the files that include it (in the next session)
+	{
+		filesystem::create_directories("Test_ShaderCache_Sources");
+		WriteFile("Test_ShaderCache_Sources/Common.hlsl", "float4 Color() { return 1; }\n");
+		WriteFile("Test_ShaderCache_Sources/Shader.hlsl", "#include \"Common.hlsl\"\nfloat4 mainPS() : SV_TARGET { return Color(); }\n");
+		const string source = "Test_ShaderCache_Sources/Shader.hlsl";
+
+		uint64_t before = RHI_ShaderCache(cachePath, 0).ComputeKey(source, {}, "mainPS", "ps_5_0", 0, 0);
+		uint64_t same	= RHI_ShaderCache(cachePath, 0).ComputeKey(source, {}, "mainPS", "ps_5_0", 0, 0);
+		WriteFile("Test_ShaderCache_Sources/Common.hlsl", "float4 Color() { return 0.5; }\n");
+		uint64_t after	= RHI_ShaderCache(cachePath, 0).ComputeKey(source, {}, "mainPS", "ps_5_0", 0, 0);
+		TEST_CHECK(before != 0 && before == same);
+		TEST_CHECK(before != after);
+
+		filesystem::remove_all("Test_ShaderCache_Sources");
+	}
+
+	// Saved once nothing was stored for a while
+	{
+		filesystem::remove(cachePath);
+		RHI_ShaderCache cache(cachePath, 0);
+		uint64_t key = cache.ComputeKey(shader, {}, "mainPS", "ps_5_0", 0, 0);
+		cache.Store(key, &key, sizeof(key));
+		TEST_CHECK(cache.Save_Idle(0.2));
+		TEST_CHECK(!filesystem::exists(cachePath));
+		this_thread::sleep_for(chrono::milliseconds(300));
+		TEST_CHECK(cache.Save_Idle(0.2));
+		TEST_CHECK(filesystem::exists(cachePath));
+	}
+
+	// Over budget, the binaries that went unused for the most sessions go first
+	{
+		uint64_t keyOld, keyNew;
+		{
+			filesystem::remove(cachePath);
+			RHI_ShaderCache cache(cachePath, 0);
+			keyOld = cache.ComputeKey(shader, {}, "old", "ps_5_0", 0, 0);
+			keyNew = cache.ComputeKey(shader, {}, "new", "ps_5_0", 0, 0);
+			vector<char> binary(1000, 'x');
+			cache.Store(keyOld, binary.data(), binary.size());
+			cache.Store(keyNew, binary.data(), binary.size());
+		}
+		{
+			RHI_ShaderCache cache(cachePath, 0);
+			cache.Load(keyNew);
+		}
+		RHI_ShaderCache cache(cachePath, 1500);
+		TEST_CHECK(cache.Save());
+		TEST_CHECK(cache.GetStats().size <= 1500);
+		TEST_CHECK(cache.Load(keyOld) == nullptr);
+		TEST_CHECK(cache.Load(keyNew) != nullptr);
+	}
+
+	filesystem::remove(cachePath);
+	return TEST_RESULT();
+}
@@ -0,0 +1,233 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================================
+#include "Test.h"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include "Resource/Import/TextureCompressor.h"
+#include "RHI/RHI_Texture.h"
+#include "Threading/Threading.h"
+//======================================================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+//========================
+
+namespace _Test_TextureCompressor
+{
+	enum Content { Content_Color, Content_Alpha, Content_Gray, Content_Normal };
+
+	// Smooth value noise, in [0, 1]
+	class Noise
+	{
+	public:
+		Noise()
+		{
+			uint32_t seed = 1;
+			for (float& value : m_values)
+			{
+				seed	= seed * 1664525 + 1013904223;
+				value	= (seed >> 8) / 16777216.0f;
+			}
+		}
+
+		float Sample(float u, float v, float frequency) const
+		{
+			float x = u * frequency, y = v * frequency;
+			unsigned int ix = (unsigned int)x % 256, iy = (unsigned int)y % 256;
+			float tx = x - floorf(x), ty = y - floorf(y);
+			tx = tx * tx * (3.0f - 2.0f * tx);
+			ty = ty * ty * (3.0f - 2.0f * ty);
+			float a = m_values[iy * 257 + ix], b = m_values[iy * 257 + ix + 1], c = m_values[(iy + 1) * 257 + ix], d = m_values[(iy + 1) * 257 + ix + 1];
+			return (a * (1.0f - tx) + b * tx) * (1.0f - ty) + (c * (1.0f - tx) + d * tx) * ty;
+		}
+
+		// A few octaves, like a photographed surface
+		float Fractal(float u, float v) const { return 0.5f * Sample(u, v, 8) + 0.25f * Sample(u, v, 32) + 0.125f * Sample(u, v, 128) + 0.125f * Sample(u, v, 255); }
+
+	private:
+		float m_values[257 * 257];
+	};
+
+	vector<std::byte> CreateImage(const Noise& noise, unsigned int size, Content content)
+	{
+		vector<std::byte> rgba((size_t)size * size * 4);
+		for (unsigned int y = 0; y < size; y++)
+		{
+			for (unsigned int x = 0; x < size; x++)
+			{
+				float u = x / (float)size, v = y / (float)size;
+				float height = noise.Fractal(u, v);
+				float color[4] = { height, height, height, 1.0f };
+				if (content == Content_Normal)
+				{
+					float step		= 1.0f / size;
+					float dx		= (noise.Fractal(u + step, v) - height) * size * 0.05f;
+					float dy		= (noise.Fractal(u, v + step) - height) * size * 0.05f;
+					float length	= sqrtf(dx * dx + dy * dy + 1.0f);
+					color[0] = -dx / length * 0.5f + 0.5f;
+					color[1] = -dy / length * 0.5f + 0.5f;
+					color[2] = 1.0f / length * 0.5f + 0.5f;
+				}
+				else if (content != Content_Gray)
+				{
+					color[1] = 0.6f * noise.Sample(u, v, 16) + 0.4f * height;
+					color[2] = 0.3f + 0.4f * noise.Sample(u + 0.3f, v, 64);
+					// Some sharp edges
+					color[0] = ((x / 8 + y / 8) % 9) == 0 ? 1.0f - color[0] : color[0];
+					color[3] = content == Content_Alpha && height <= 0.5f ? 0.2f : 1.0f;
+				}
+
+				for (unsigned int c = 0; c < 4; c++)
+				{
+					rgba[((size_t)y * size + x) * 4 + c] = (std::byte)(uint8_t)(color[c] * 255.0f + 0.5f);
+				}
+			}
+		}
+		return rgba;
+	}
+
+	// Over the channels [first, last)
+	double PSNR(const vector<std::byte>& a, const vector<std::byte>& b, unsigned int first, unsigned int last)
+	{
+		double error	= 0.0;
+		size_t count	= 0;
+		for (size_t i = 0; i < a.size(); i += 4)
+		{
+			for (unsigned int c = first; c < last; c++)
+			{
+				double difference = (double)(uint8_t)a[i + c] - (double)(uint8_t)b[i + c];
+				error += difference * difference;
+				count++;
+			}
+		}
+		error /= count;
+		return error == 0.0 ? 99.0 : 10.0 * log10(255.0 * 255.0 / error);
+	}
+}
+
+// TextureCompressor::Compress followed by TextureCompressor::Decompress has to reach a minimum PSNR for each format and quality,
+// better qualities can't do worse, threading can't change the output, and the small mips pad their blocks.
+int main()
+{
+	using namespace _Test_TextureCompressor;
+
+	Noise noise;
+	const unsigned int size = 256;
+
+	// The minimums are about 2 dB below what the encoders reach on these images, the alpha of BC3 only has two levels so it's exact
+	struct Case { Content content; Texture_Format format; unsigned int first; unsigned int last; double minimum[3]; };
+	const Case cases[] =
+	{
+		{ Content_Color,	Texture_Format_BC1_UNORM, 0, 3, { 28.5, 30.0, 30.0 } },
+		{ Content_Alpha,	Texture_Format_BC3_UNORM, 0, 3, { 28.5, 30.0, 30.0 } },
+		{ Content_Alpha,	Texture_Format_BC3_UNORM, 3, 4, { 99.0, 99.0, 99.0 } },
+		{ Content_Gray,		Texture_Format_BC4_UNORM, 0, 1, { 43.0, 43.5, 44.0 } },
+		{ Content_Normal,	Texture_Format_BC5_UNORM, 0, 2, { 30.5, 31.5, 32.0 } },
+		{ Content_Color,	Texture_Format_BC7_UNORM, 0, 3, { 30.0, 31.5, 31.5 } },
+		{ Content_Alpha,	Texture_Format_BC7_UNORM, 0, 4, { 25.0, 29.5, 29.5 } }
+	};
+
+	Context context;
+	Threading threading(&context);
+	threading.Initialize();
+
+	for (const Case& test : cases)
+	{
+		auto image				= CreateImage(noise, size, test.content);
+		double previousPSNR		= 0.0;
+		for (unsigned int quality = TextureCompression_Fast; quality <= TextureCompression_High; quality++)
+		{
+			vector<vector<std::byte>> blocks, blocksThreaded;
+			TEST_CHECK(TextureCompressor::Compress({ image }, size, size, test.format, (TextureCompression)quality, &blocks));
+			TEST_CHECK(TextureCompressor::Compress({ image }, size, size, test.format, (TextureCompression)quality, &blocksThreaded, &threading));
+			TEST_CHECK(blocks == blocksThreaded);
+			TEST_CHECK(blocks.size() == 1 && blocks[0].size() == TextureCompressor::GetMipSize(size, size, test.format));
+			if (blocks.size() != 1 || blocks[0].size() != TextureCompressor::GetMipSize(size, size, test.format))
+				continue;
+
+			vector<std::byte> decoded(image.size());
+			TEST_CHECK(TextureCompressor::Decompress(blocks[0].data(), size, size, test.format, decoded.data()));
+			double psnr = PSNR(image, decoded, test.first, test.last);
+			TEST_CHECK(psnr >= test.minimum[quality - TextureCompression_Fast]);
+			TEST_CHECK(psnr >= previousPSNR - 0.1);
+			previousPSNR = psnr;
+		}
+	}
+
+	// A mip chain down to 1x1, the mips below 4x4 pad their block
+	{
+		vector<vector<std::byte>> mips = { CreateImage(noise, 8, Content_Color) };
+		for (unsigned int mip = 4; mip >= 1; mip /= 2)
+		{
+			mips.emplace_back((size_t)mip * mip * 4, (std::byte)200);
+		}
+
+		vector<vector<std::byte>> blocks;
+		TEST_CHECK(TextureCompressor::Compress(mips, 8, 8, Texture_Format_BC7_UNORM, TextureCompression_Normal, &blocks));
+		TEST_CHECK(blocks.size() == 4);
+		if (blocks.size() == 4)
+		{
+			TEST_CHECK(blocks[0].size() == 4 * 16 && blocks[1].size() == 16 && blocks[2].size() == 16 && blocks[3].size() == 16);
+			for (unsigned int mip = 1; mip < 4; mip++)
+			{
+				unsigned int mipSize = 4 >> (mip - 1);
+				vector<std::byte> decoded((size_t)mipSize * mipSize * 4);
+				TextureCompressor::Decompress(blocks[mip].data(), mipSize, mipSize, Texture_Format_BC7_UNORM, decoded.data());
+				TEST_CHECK(PSNR(mips[mip], decoded, 0, 4) > 40.0);
+			}
+		}
+	}
+
+	// Channels a format doesn't have decode to 0 (alpha to 255)
+	{
+		auto image = CreateImage(noise, 4, Content_Color);
+		vector<vector<std::byte>> blocks;
+		TextureCompressor::Compress({ image }, 4, 4, Texture_Format_BC4_UNORM, TextureCompression_Normal, &blocks);
+		vector<std::byte> decoded(image.size());
+		TextureCompressor::Decompress(blocks[0].data(), 4, 4, Texture_Format_BC4_UNORM, decoded.data());
+		bool defaults = true;
+		for (size_t i = 0; i < decoded.size(); i += 4)
+		{
+			defaults = defaults && decoded[i + 1] == (std::byte)0 && decoded[i + 2] == (std::byte)0 && decoded[i + 3] == (std::byte)255;
+		}
+		TEST_CHECK(defaults);
+	}
+
+	// Invalid input
+	{
+		vector<vector<std::byte>> blocks;
+		TEST_CHECK(!TextureCompressor::Compress({ vector<std::byte>(6 * 6 * 4) }, 6, 6, Texture_Format_BC1_UNORM, TextureCompression_Fast, &blocks));
+		TEST_CHECK(!TextureCompressor::Compress({ vector<std::byte>(4 * 4 * 3) }, 4, 4, Texture_Format_BC1_UNORM, TextureCompression_Fast, &blocks));
+	}
+
+	TEST_CHECK(TextureCompressor::ChooseFormat(TextureType_Albedo, false, true, TextureCompression_Fast)		== Texture_Format_BC1_UNORM);
+	TEST_CHECK(TextureCompressor::ChooseFormat(TextureType_Albedo, false, false, TextureCompression_Fast)		== Texture_Format_BC3_UNORM);
+	TEST_CHECK(TextureCompressor::ChooseFormat(TextureType_Albedo, false, false, TextureCompression_Normal)		== Texture_Format_BC7_UNORM);
+	TEST_CHECK(TextureCompressor::ChooseFormat(TextureType_Normal, false, true, TextureCompression_High)		== Texture_Format_BC5_UNORM);
+	TEST_CHECK(TextureCompressor::ChooseFormat(TextureType_Roughness, true, true, TextureCompression_Normal)	== Texture_Format_BC4_UNORM);
+	TEST_CHECK(TextureCompressor::ChooseFormat(TextureType_Albedo, false, true, TextureCompression_None)		== Texture_Format_R8G8B8A8_UNORM);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,205 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "Test.h"
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include "Rendering/VertexPacking.h"
+#include "RHI/RHI_Vertex.h"
+#include "Math/BoundingBox.h"
+//===================================
+
+//= NAMESPACES ===========
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//========================
+
+namespace _Test_VertexPacking
+{
+	inline float Dot(const float* a, const float* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+	inline void Normalize(float* v)
+	{
+		float length = sqrtf(Dot(v, v));
+		v[0] /= length; v[1] /= length; v[2] /= length;
+	}
+
+	// In degrees, from the cross and the dot product since acos can't resolve small angles
+	inline float Angle(const float* a, const float* b)
+	{
+		double cross[3] =
+		{
+			(double)a[1] * b[2] - (double)a[2] * b[1],
+			(double)a[2] * b[0] - (double)a[0] * b[2],
+			(double)a[0] * b[1] - (double)a[1] * b[0]
+		};
+		double dot = (double)a[0] * b[0] + (double)a[1] * b[1] + (double)a[2] * b[2];
+		return (float)(atan2(sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot) * 57.29577951);
+	}
+
+	// Random positions and uvs, and a random orthonormal tangent frame of either handedness
+	vector<RHI_Vertex_PosUVTBN> CreateVertices(unsigned int count, unsigned int seed)
+	{
+		mt19937 random(seed);
+		uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		uniform_real_distribution<float> position(-50.0f, 50.0f);
+		uniform_real_distribution<float> uv(-4.0f, 4.0f);
+
+		vector<RHI_Vertex_PosUVTBN> vertices(count);
+		for (auto& vertex : vertices)
+		{
+			for (float& c : vertex.pos)	c = position(random);
+			for (float& c : vertex.uv)	c = uv(random);
+
+			float* n = vertex.normal;
+			float* t = vertex.tangent;
+			float* b = vertex.bitangent;
+			n[0] = unit(random); n[1] = unit(random); n[2] = unit(random);
+			Normalize(n);
+			t[0] = unit(random); t[1] = unit(random); t[2] = unit(random);
+			float d = Dot(n, t);
+			t[0] -= n[0] * d; t[1] -= n[1] * d; t[2] -= n[2] * d;
+			Normalize(t);
+
+			float sign = random() % 2 ? 1.0f : -1.0f;
+			b[0] = (n[1] * t[2] - n[2] * t[1]) * sign;
+			b[1] = (n[2] * t[0] - n[0] * t[2]) * sign;
+			b[2] = (n[0] * t[1] - n[1] * t[0]) * sign;
+		}
+
+		return vertices;
+	}
+}
+
+// VertexPacking::Pack followed by VertexPacking::Unpack has to stay within the precision of each layout:
+// positions within half a step of the 16-bit grid over the bounds, uvs within half float rounding and
+// the tangent frame within a fraction of a degree, with the handedness of the bitangent kept.
+int main()
+{
+	using namespace _Test_VertexPacking;
+
+	TEST_CHECK(VertexPacking::GetStride(Vertex_Packing_None)	== sizeof(RHI_Vertex_PosUVTBN));
+	TEST_CHECK(VertexPacking::GetStride(Vertex_Packing_Compact)	== 20);
+	TEST_CHECK(VertexPacking::GetStride(Vertex_Packing_Small)	== 16);
+
+	const unsigned int count	= 20000;
+	auto vertices				= CreateVertices(count, 3);
+	BoundingBox bounds(vertices);
+	Vector3 extent				= bounds.GetMax() - bounds.GetMin();
+	float positionTolerance[3]	= { extent.x / 65535.0f * 0.5f + 1e-4f, extent.y / 65535.0f * 0.5f + 1e-4f, extent.z / 65535.0f * 0.5f + 1e-4f };
+
+	struct Expected { Vertex_Packing packing; float maxAngle; };
+	for (const Expected& expected : { Expected{ Vertex_Packing_None, 0.0f }, Expected{ Vertex_Packing_Compact, 0.02f }, Expected{ Vertex_Packing_Small, 0.25f } })
+	{
+		vector<std::byte> packed((size_t)count * VertexPacking::GetStride(expected.packing));
+		vector<RHI_Vertex_PosUVTBN> unpacked(count);
+		VertexPacking::Pack(vertices.data(), count, expected.packing, bounds, packed.data());
+		VertexPacking::Unpack(packed.data(), count, expected.packing, bounds, unpacked.data());
+
+		if (expected.packing == Vertex_Packing_None)
+		{
+			TEST_CHECK(memcmp(vertices.data(), unpacked.data(), sizeof(RHI_Vertex_PosUVTBN) * count) == 0);
+			continue;
+		}
+
+		unsigned int positionErrors = 0, uvErrors = 0, frameErrors = 0, handednessErrors = 0;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			const auto& in	= vertices[i];
+			const auto& out	= unpacked[i];
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				positionErrors += fabsf(out.pos[k] - in.pos[k]) > positionTolerance[k] ? 1 : 0;
+			}
+			for (unsigned int k = 0; k < 2; k++)
+			{
+				// 11 bits of mantissa, the uvs are within [-4, 4]
+				uvErrors += fabsf(out.uv[k] - in.uv[k]) > 4.0f / 2048.0f ? 1 : 0;
+			}
+			frameErrors			+= Angle(out.normal, in.normal)			> expected.maxAngle ? 1 : 0;
+			frameErrors			+= Angle(out.tangent, in.tangent)		> expected.maxAngle ? 1 : 0;
+			frameErrors			+= Angle(out.bitangent, in.bitangent)	> expected.maxAngle * 2.0f ? 1 : 0;
+			handednessErrors	+= Dot(out.bitangent, in.bitangent) <= 0.0f ? 1 : 0;
+		}
+		TEST_CHECK(positionErrors	== 0);
+		TEST_CHECK(uvErrors			== 0);
+		TEST_CHECK(frameErrors		== 0);
+		TEST_CHECK(handednessErrors	== 0);
+	}
+
+	// A flat mesh (all z equal) and a degenerate tangent frame still unpack to valid vertices
+	{
+		RHI_Vertex_PosUVTBN flat[2] = {};
+		flat[0].pos[0] = -1.0f; flat[0].pos[2] = 5.0f; flat[0].normal[2] = 1.0f;
+		flat[1].pos[0] = 1.0f;	flat[1].pos[2] = 5.0f; flat[1].tangent[0] = 1.0f; flat[1].normal[0] = 1.0f;
+		BoundingBox flatBounds(Vector3(-1.0f, 0.0f, 5.0f), Vector3(1.0f, 0.0f, 5.0f));
+
+		for (Vertex_Packing packing : { Vertex_Packing_Compact, Vertex_Packing_Small })
+		{
+			vector<std::byte> packed(2 * VertexPacking::GetStride(packing));
+			RHI_Vertex_PosUVTBN unpacked[2];
+			VertexPacking::Pack(flat, 2, packing, flatBounds, packed.data());
+			VertexPacking::Unpack(packed.data(), 2, packing, flatBounds, unpacked);
+
+			for (const auto& vertex : unpacked)
+			{
+				TEST_CHECK(vertex.pos[2] == 5.0f);
+				TEST_CHECK(fabsf(Dot(vertex.normal, vertex.normal) - 1.0f) < 1e-3f);
+				TEST_CHECK(fabsf(Dot(vertex.tangent, vertex.tangent) - 1.0f) < 1e-3f);
+				TEST_CHECK(fabsf(Dot(vertex.normal, vertex.tangent)) < 1e-2f);
+			}
+		}
+	}
+
+	// Half floats: exact values, rounding, overflow, denormals and NaN
+	{
+		auto roundTrip = [](float value) { return VertexPacking::HalfToFloat(VertexPacking::FloatToHalf(value)); };
+		TEST_CHECK(roundTrip(0.0f) == 0.0f);
+		TEST_CHECK(signbit(roundTrip(-0.0f)));
+		TEST_CHECK(roundTrip(1.0f) == 1.0f);
+		TEST_CHECK(roundTrip(-2.5f) == -2.5f);
+		TEST_CHECK(roundTrip(65504.0f) == 65504.0f);
+		TEST_CHECK(isinf(roundTrip(70000.0f)));
+		TEST_CHECK(roundTrip(1.0f + 1.0f / 2048.0f) == 1.0f);						// Ties to even
+		TEST_CHECK(roundTrip(1.0f + 3.0f / 2048.0f) == 1.0f + 2.0f / 1024.0f);
+		TEST_CHECK(fabsf(roundTrip(6e-8f) - 5.9604645e-8f) < 1e-12f);				// Smallest denormal
+		TEST_CHECK(isnan(roundTrip(NAN)));
+	}
+
+	// Octahedral encoding of the axes and the diagonals is exact enough to be used as is
+	{
+		const float directions[][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0.57735f, -0.57735f, -0.57735f } };
+		for (const auto& direction : directions)
+		{
+			int16_t encoded[2];
+			float decoded[3];
+			VertexPacking::OctahedralEncode(direction, encoded);
+			VertexPacking::OctahedralDecode(encoded, decoded);
+			TEST_CHECK(Angle(direction, decoded) < 0.01f);
+		}
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,209 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+//= INCLUDES ==========================
+#include "Test.h"
+#include <map>
+#include <vector>
+#include <filesystem>
+#include "Core/Context.h"
+#include "Core/EventSystem.h"
+#include "Threading/Threading.h"
+#include "FileSystem/FileSystem.h"
+#include "IO/FileStream.h"
+#include "Resource/ResourceManager.h"
+#include "Rendering/Renderer.h"
+#include "World/World.h"
+#include "World/Actor.h"
+#include "World/Components/Transform.h"
+//=====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Directus;
+using namespace Directus::Math;
+//============================
+
+namespace
+{
+	const char* g_fileDelta	= "Test_WorldSave_Delta.world";
+	const char* g_fileFull	= "Test_WorldSave_Full.world";
+	const char* g_fileCycle	= "Test_WorldSave_Cycle.world";
+
+	// What is compared between the saved and the loaded world, by actor name: the parent's name and the local position
+	typedef map<string, pair<string, Vector3>> Hierarchy;
+
+	Hierarchy Hierarchy_Get(World* world)
+	{
+		Hierarchy hierarchy;
+		for (const auto& actor : world->GetAllActors())
+		{
+			Transform* transform	= actor->GetTransform_PtrRaw();
+			Transform* parent		= transform->GetParent();
+			hierarchy[actor->GetName()] = { parent ? parent->GetActor_PtrRaw()->GetName() : "", transform->GetPositionLocal() };
+		}
+		return hierarchy;
+	}
+
+	Transform* Actor_Add(World* world, const string& name, Transform* parent, const Vector3& position)
+	{
+		auto actor = world->Actor_CreateAdd().lock();
+		actor->SetName(name);
+		Transform* transform = actor->GetTransform_PtrRaw();
+		transform->SetParent(parent);
+		transform->SetPositionLocal(position);
+		return transform;
+	}
+
+	// An actor record as World::Save_Full() writes it, without components
+	void Record_Write(FileStream* file, unsigned int id, const string& name, int parent)
+	{
+		file->Write(id);
+		file->Write(name);
+		file->Write(true);
+		file->Write(true);
+		file->Write(parent);
+		file->Write(0u);
+	}
+
+	// And as World::Save_Delta() writes it, the parent by ID
+	void Record_WriteDelta(FileStream* file, unsigned int id, const string& name, unsigned int parentID)
+	{
+		file->Write(id);
+		file->Write(name);
+		file->Write(true);
+		file->Write(true);
+		file->Write(parentID);
+		file->Write(0u);
+	}
+}
+
+int main()
+{
+	FileSystem::Initialize();
+
+	// The context deletes its subsystems except for the first one (normally the engine)
+	auto context	= make_unique<Context>();
+	auto threading	= make_unique<Threading>(context.get());
+	context->RegisterSubsystem(threading.get());
+	threading->Initialize();
+	auto resourceManager = new ResourceManager(context.get());
+	context->RegisterSubsystem(resourceManager);
+	resourceManager->Initialize();
+	auto renderer = new Renderer(context.get(), nullptr);
+	context->RegisterSubsystem(renderer);
+	renderer->Initialize();
+	auto world = new World(context.get());
+	context->RegisterSubsystem(world);
+	world->Initialize();
+	world->Unload();
+
+	// Saved in full, edited, saved again as a delta and loaded, the world comes back as it was saved
+	{
+		Transform* a0 = Actor_Add(world, "a0", nullptr, Vector3(0, 0, 0));
+		Transform* a1 = Actor_Add(world, "a1", a0, Vector3(1, 0, 0));
+		Transform* a2 = Actor_Add(world, "a2", a0, Vector3(2, 0, 0));
+		Transform* a3 = Actor_Add(world, "a3", a1, Vector3(3, 0, 0));
+		Transform* a4 = Actor_Add(world, "a4", nullptr, Vector3(4, 0, 0));
+		Actor_Add(world, "a5", a4, Vector3(5, 0, 0));
+		for (unsigned int i = 0; i < 100; i++)
+		{
+			Actor_Add(world, "b" + to_string(i), i % 2 == 0 ? a4 : nullptr, Vector3((float)i, 1, 0));
+		}
+
+		TEST_CHECK(world->SaveToFile(g_fileDelta));
+		uintmax_t sizeFull = filesystem::file_size(g_fileDelta);
+
+		// A moved actor, a reparented one (under an actor that moved), a removed subtree (and what was under it)
+		// and a new actor under the reparented one
+		a3->SetPositionLocal(Vector3(3, 3, 3));
+		a2->SetParent(a3);
+		world->Actor_Remove(a4->GetActor_PtrWeak());
+		Actor_Add(world, "a6", a2, Vector3(6, 0, 0));
+		Hierarchy saved = Hierarchy_Get(world);
+		TEST_CHECK(saved.size() == 5 + 50);
+
+		TEST_CHECK(world->SaveToFile(g_fileDelta));
+		uintmax_t sizeDelta = filesystem::file_size(g_fileDelta) - sizeFull;
+		TEST_CHECK(sizeDelta > 0 && sizeDelta < sizeFull / 4);
+
+		// Nothing changed, nothing is appended
+		TEST_CHECK(world->SaveToFile(g_fileDelta));
+		TEST_CHECK(filesystem::file_size(g_fileDelta) == sizeFull + sizeDelta);
+
+		// The same world in full
+		TEST_CHECK(world->SaveToFile(g_fileFull));
+
+		TEST_CHECK(world->LoadFromFile(g_fileDelta));
+		TEST_CHECK(Hierarchy_Get(world) == saved);
+		TEST_CHECK(world->LoadFromFile(g_fileFull));
+		TEST_CHECK(Hierarchy_Get(world) == saved);
+
+		// Loading picks up where the file left off, the next change is appended to it
+		world->LoadFromFile(g_fileDelta);
+		world->GetActorByName("a6").lock()->GetTransform_PtrRaw()->SetParent(nullptr);
+		saved = Hierarchy_Get(world);
+		TEST_CHECK(world->SaveToFile(g_fileDelta));
+		TEST_CHECK(filesystem::file_size(g_fileDelta) > sizeFull + sizeDelta);
+		TEST_CHECK(world->LoadFromFile(g_fileDelta));
+		TEST_CHECK(Hierarchy_Get(world) == saved);
+	}
+
+	// Deltas that leave a child with a parent that is gone or a parent cycle (which saves don't write, but a file can
+	// hold) load every actor, a cycle is broken up rather than lost
+	{
+		{
+			auto file = make_unique<FileStream>(g_fileCycle, FileStreamMode_Write);
+			file->Write(vector<string>());
+			file->Section_Begin("actors");
+			file->Write(4u);
+			Record_Write(file.get(), 1, "x", -1);
+			Record_Write(file.get(), 2, "y", 0);
+			Record_Write(file.get(), 3, "z", -1);
+			Record_Write(file.get(), 4, "w", 2);
+			file->Section_Begin("component_data");
+
+			// x goes under y (which is under x), z is removed but w (under it) stays
+			file->Section_Begin("delta");
+			file->Write(vector<string>());
+			file->Write(vector<unsigned int>{ 3 });
+			file->Write(1u);
+			Record_WriteDelta(file.get(), 1, "x", 2);
+			TEST_CHECK(file->Close());
+		}
+
+		TEST_CHECK(world->LoadFromFile(g_fileCycle));
+		Hierarchy loaded = Hierarchy_Get(world);
+		TEST_CHECK(loaded.size() == 3);
+		TEST_CHECK(loaded.count("x") && loaded.count("y") && loaded.count("w"));
+		TEST_CHECK(loaded["w"].first.empty());
+		TEST_CHECK((loaded["x"].first == "y") != (loaded["y"].first == "x"));
+	}
+
+	FileSystem::DeleteFile_(g_fileDelta);
+	FileSystem::DeleteFile_(g_fileFull);
+	FileSystem::DeleteFile_(g_fileCycle);
+
+	context.reset();
+	threading.reset();
+	EventSystem::Get().Clear();
+
+	return TEST_RESULT();
+}
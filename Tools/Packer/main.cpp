@@ -0,0 +1,62 @@
+/*
+Copyright(c) 2016-2018 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======================
+#include <memory>
+#include <string>
+#include <iostream>
+#include "Logging/Log.h"
+#include "Logging/ILogger.h"
+#include "FileSystem/PackFile.h"
+//=================================
+
+//= NAMESPACES ==========
+using namespace std;
+using namespace Directus;
+//=======================
+
+// Packs a directory into a single archive the engine mounts at startup.
+// Run it from the directory the engine runs from, entries are named by their path relative to it.
+// Usage: Packer <directory> <output.pak> [-compress]
+
+class ConsoleLogger : public ILogger
+{
+public:
+	void Log(const string& log, int type) override
+	{
+		(type == Log_Error ? cerr : cout) << log << endl;
+	}
+};
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		cout << "Usage: Packer <directory> <output.pak> [-compress]" << endl;
+		return 1;
+	}
+
+	auto logger = make_shared<ConsoleLogger>();
+	Log::SetLogger(logger);
+
+	bool compress = argc > 3 && string(argv[3]) == "-compress";
+	return PackFile::Create(argv[1], argv[2], compress) ? 0 : 1;
+}